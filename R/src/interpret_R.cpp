@@ -361,6 +361,115 @@ SEXP Discretize_R(SEXP featureVals, SEXP cutsLowerBoundInclusive, SEXP binIndexe
    return R_NilValue;
 }
 
+SEXP PredictProba_R(SEXP cuts, SEXP termScores, SEXP X) {
+   EBM_ASSERT(nullptr != cuts);
+   EBM_ASSERT(nullptr != termScores);
+   EBM_ASSERT(nullptr != X);
+
+   // X can either be a numeric matrix (column major) or a list of numeric columns like a data.frame.  Either way
+   // we discretize and accumulate one column at a time so that the only full length allocation visible to R is
+   // the vector that we return, and the only scratch space is a single reused bin index buffer
+
+   if(VECSXP != TYPEOF(cuts)) {
+      Rf_error("PredictProba_R VECSXP != TYPEOF(cuts)");
+   }
+   if(VECSXP != TYPEOF(termScores)) {
+      Rf_error("PredictProba_R VECSXP != TYPEOF(termScores)");
+   }
+   const R_xlen_t cFeatures = Rf_xlength(cuts);
+   if(cFeatures != Rf_xlength(termScores)) {
+      Rf_error("PredictProba_R cFeatures != Rf_xlength(termScores)");
+   }
+
+   const bool bMatrix = REALSXP == TYPEOF(X);
+   R_xlen_t cSamples = 0;
+   if(bMatrix) {
+      if(!Rf_isMatrix(X)) {
+         Rf_error("PredictProba_R !Rf_isMatrix(X)");
+      }
+      if(static_cast<R_xlen_t>(Rf_ncols(X)) != cFeatures) {
+         Rf_error("PredictProba_R Rf_ncols(X) != cFeatures");
+      }
+      cSamples = static_cast<R_xlen_t>(Rf_nrows(X));
+   } else if(VECSXP == TYPEOF(X)) {
+      if(Rf_xlength(X) != cFeatures) {
+         Rf_error("PredictProba_R Rf_xlength(X) != cFeatures");
+      }
+      if(0 != cFeatures) {
+         cSamples = static_cast<R_xlen_t>(CountDoubles(VECTOR_ELT(X, 0)));
+      }
+   } else {
+      Rf_error("PredictProba_R X must be a numeric matrix or a list of numeric columns");
+   }
+   if(IsConvertError<size_t>(cSamples) || IsConvertError<IntEbm>(cSamples)) {
+      Rf_error("PredictProba_R IsConvertError<size_t>(cSamples) || IsConvertError<IntEbm>(cSamples)");
+   }
+
+   const SEXP ret = PROTECT(Rf_allocVector(REALSXP, cSamples));
+
+   if(0 != cSamples) {
+      double * const aScores = REAL(ret);
+      double * const pScoresEnd = aScores + static_cast<size_t>(cSamples);
+
+      double * pScore = aScores;
+      do {
+         *pScore = 0.0;
+         ++pScore;
+      } while(pScoresEnd != pScore);
+
+      IntEbm * const aiBins =
+         reinterpret_cast<IntEbm *>(R_alloc(static_cast<size_t>(cSamples), static_cast<int>(sizeof(IntEbm))));
+      EBM_ASSERT(nullptr != aiBins); // this can't be nullptr since R_alloc uses R error handling
+
+      for(R_xlen_t iFeature = 0; iFeature < cFeatures; ++iFeature) {
+         const double * aFeatureVals;
+         if(bMatrix) {
+            aFeatureVals = REAL(X) + static_cast<size_t>(iFeature) * static_cast<size_t>(cSamples);
+         } else {
+            const SEXP col = VECTOR_ELT(X, iFeature);
+            if(static_cast<IntEbm>(cSamples) != CountDoubles(col)) {
+               Rf_error("PredictProba_R all columns of X must have the same length");
+            }
+            aFeatureVals = REAL(col);
+         }
+
+         const SEXP featureCuts = VECTOR_ELT(cuts, iFeature);
+         const IntEbm cCuts = CountDoubles(featureCuts);
+
+         const SEXP featureScores = VECTOR_ELT(termScores, iFeature);
+         const IntEbm cScores = CountDoubles(featureScores);
+         // Discretize returns 0 for missing and 1 through cCuts + 1 for the regular bins, so all of these need scores
+         if(cScores < cCuts + IntEbm { 2 }) {
+            Rf_error("PredictProba_R cScores < cCuts + 2");
+         }
+
+         const ErrorEbm err = Discretize(static_cast<IntEbm>(cSamples), aFeatureVals, cCuts, REAL(featureCuts), aiBins);
+         if(Error_None != err) {
+            Rf_error("Discretize returned error code: %" ErrorEbmPrintf, err);
+         }
+
+         const double * const aTermScores = REAL(featureScores);
+         const IntEbm * piBin = aiBins;
+         pScore = aScores;
+         do {
+            *pScore += aTermScores[static_cast<size_t>(*piBin)];
+            ++piBin;
+            ++pScore;
+         } while(pScoresEnd != pScore);
+      }
+
+      pScore = aScores;
+      do {
+         // 1 / (1 + exp(-logit)) instead of odds / (1 + odds) so that large logits do not overflow into NaN
+         *pScore = 1.0 / (1.0 + std::exp(-*pScore));
+         ++pScore;
+      } while(pScoresEnd != pScore);
+   }
+
+   UNPROTECT(1);
+   return ret;
+}
+
 SEXP MeasureDataSetHeader_R(SEXP countFeatures, SEXP countWeights, SEXP countTargets) {
    EBM_ASSERT(nullptr != countFeatures);
    EBM_ASSERT(nullptr != countWeights);
@@ -839,6 +948,7 @@ SEXP GenerateTermUpdate_R(
       10.0,
       9223372036854775807,
       1.0,
+      1,
       aLeavesMax,
       nullptr,
       &avgGain
@@ -1119,6 +1229,7 @@ static const R_CallMethodDef g_exposedFunctions[] = {
    { "CreateRNG_R", (DL_FUNC)&CreateRNG_R, 1 },
    { "CutQuantile_R", (DL_FUNC)&CutQuantile_R, 4 },
    { "Discretize_R", (DL_FUNC)&Discretize_R, 3 },
+   { "PredictProba_R", (DL_FUNC)&PredictProba_R, 3 },
    { "MeasureDataSetHeader_R", (DL_FUNC)&MeasureDataSetHeader_R, 3 },
    { "MeasureFeature_R", (DL_FUNC)&MeasureFeature_R, 5 },
    { "MeasureClassificationTarget_R", (DL_FUNC)&MeasureClassificationTarget_R, 2 },
@@ -318,6 +318,7 @@ if [ $is_conda -eq 1 ]; then
    printf "%s\n" "LOADLIBES=${LOADLIBES}"
    printf "%s\n" "LDLIBS=${LDLIBS}"
 
+   ${CXX} -c ${CPPFLAGS} ${CXXFLAGS} ${extras} "$code_path/api_recording.cpp" -o "$tmp_path/api_recording.o"
    ${CXX} -c ${CPPFLAGS} ${CXXFLAGS} ${extras} "$code_path/ApplyTermUpdate.cpp" -o "$tmp_path/ApplyTermUpdate.o"
    ${CXX} -c ${CPPFLAGS} ${CXXFLAGS} ${extras} "$code_path/BoosterCore.cpp" -o "$tmp_path/BoosterCore.o"
    ${CXX} -c ${CPPFLAGS} ${CXXFLAGS} ${extras} "$code_path/BoosterShell.cpp" -o "$tmp_path/BoosterShell.o"
@@ -346,6 +347,7 @@ if [ $is_conda -eq 1 ]; then
    ${CXX} -c ${CPPFLAGS} ${CXXFLAGS} ${extras} "$code_path/PartitionMultiDimensionalFull.cpp" -o "$tmp_path/PartitionMultiDimensionalFull.o"
    ${CXX} -c ${CPPFLAGS} ${CXXFLAGS} ${extras} "$code_path/PartitionMultiDimensionalTree.cpp" -o "$tmp_path/PartitionMultiDimensionalTree.o"
    ${CXX} -c ${CPPFLAGS} ${CXXFLAGS} ${extras} "$code_path/PartitionMultiDimensionalStraight.cpp" -o "$tmp_path/PartitionMultiDimensionalStraight.o"
+   ${CXX} -c ${CPPFLAGS} ${CXXFLAGS} ${extras} "$code_path/PartitionMultiDimensionalDeep.cpp" -o "$tmp_path/PartitionMultiDimensionalDeep.o"
    ${CXX} -c ${CPPFLAGS} ${CXXFLAGS} ${extras} "$code_path/Purify.cpp" -o "$tmp_path/Purify.o"
    ${CXX} -c ${CPPFLAGS} ${CXXFLAGS} ${extras} "$code_path/RandomDeterministic.cpp" -o "$tmp_path/RandomDeterministic.o"
    ${CXX} -c ${CPPFLAGS} ${CXXFLAGS} ${extras} "$code_path/random.cpp" -o "$tmp_path/random.o"
@@ -359,6 +361,7 @@ if [ $is_conda -eq 1 ]; then
    ${CXX} -c ${CPPFLAGS} ${CXXFLAGS} ${extras} "$code_path/compute/cpu_ebm/cpu_64.cpp" -o "$tmp_path/cpu_64.o"
 
    ${CXX} ${LDFLAGS} -shared \
+   "$tmp_path/api_recording.o" \
    "$tmp_path/ApplyTermUpdate.o" \
    "$tmp_path/BoosterCore.o" \
    "$tmp_path/BoosterShell.o" \
@@ -387,6 +390,7 @@ if [ $is_conda -eq 1 ]; then
    "$tmp_path/PartitionMultiDimensionalFull.o" \
    "$tmp_path/PartitionMultiDimensionalTree.o" \
    "$tmp_path/PartitionMultiDimensionalStraight.o" \
+   "$tmp_path/PartitionMultiDimensionalDeep.o" \
    "$tmp_path/Purify.o" \
    "$tmp_path/RandomDeterministic.o" \
    "$tmp_path/random.o" \
@@ -21,12 +21,19 @@ _develop_options = {
     "cat_include": 1.0,
     "full_interaction": False,
     "boost_corners": False,
+    "boost_straight": False,  # boost pairs with the straight cuts used to detect them.
+    "deep_pair_leaves": None,  # None, or the per-feature leaf budget of best-first pair trees.
+    "random_retries": 1,  # random cut sets scored per random split step. Rejected for DP.
+    "random_min_leaf": None,  # None, "hard" or "soft" min_samples_leaf rule for random splits.
     "purify_boosting": False,
     "purify_result": False,
     "randomize_initial_feature_order": True,
     "randomize_greedy_feature_order": True,  # Randomize feature order if greedy.
     "randomize_feature_order": False,  # Randomize feature order. No cost to results.
     "acceleration": Native.AccelerationFlags_ALL,
+    "interaction_threads": 1,  # native threads per interaction detector. 0 means one per core.
+    "native_inv_link": False,  # apply logit/vlogit/mlogit/log inverse links natively.
+    "pack_by_feature": False,  # store one packed column per feature instead of per term.
 }
 
 
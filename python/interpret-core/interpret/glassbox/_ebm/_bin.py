@@ -140,6 +140,29 @@ def ebm_predict_scores(
     return sample_scores
 
 
+def ebm_predict_scores_binned(
+    dataset,
+    bag,
+    init_score,
+    intercept,
+    term_scores,
+    term_features,
+):
+    # like ebm_predict_scores, but reads the already binned data from a dataset made by
+    # bin_native_by_dimension or bin_native_levels.  term_features index the dataset's
+    # columns.  Only samples with a non-zero bag are returned.
+    n_scores = (
+        1 if isinstance(intercept, float) or len(intercept) == 1 else len(intercept)
+    )
+    sample_scores = Native.get_native_singleton().score_dataset(
+        dataset, bag, n_scores, term_scores, term_features
+    )
+    if init_score is not None:
+        sample_scores += init_score if bag is None else init_score[bag != 0]
+    sample_scores += intercept
+    return sample_scores
+
+
 def ebm_eval_terms(
     X,
     n_samples,
@@ -209,3 +232,11 @@ def make_bin_weights(
         bin_weights[term_idx] = term_bin_weights
 
     return bin_weights
+
+
+def make_bin_weights_binned(dataset, sample_weight, term_features):
+    # like make_bin_weights, but reads the already binned data from a dataset made by
+    # bin_native_by_dimension or bin_native_levels, so X is not discretized again
+    return Native.get_native_singleton().extract_term_bin_weights(
+        dataset, sample_weight, term_features
+    )
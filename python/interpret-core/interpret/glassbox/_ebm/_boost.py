@@ -49,7 +49,15 @@ def boost(
     acceleration,
     experimental_params,
     develop_options,
+    checkpoint_steps=0,
+    checkpoint_callback=None,
+    checkpoint=None,
 ):
+    # Every checkpoint_steps boosting steps, checkpoint_callback receives a dict holding
+    # the serialized native booster and rng along with the loop state below that decides
+    # early stopping and the order of terms. Passing that dict back as checkpoint, with
+    # every other argument identical to the interrupted call, resumes boosting so that
+    # the results are bit for bit those of an uninterrupted call.
     try:
         develop._develop_options = develop_options  # restore these in this process
         step_idx = 0
@@ -70,6 +78,12 @@ def boost(
             acceleration,
             experimental_params,
         ) as booster:
+            if checkpoint is not None:
+                # the intercept rounds were already applied before the checkpoint
+                booster.deserialize(checkpoint["booster"], rng)
+                intercept[...] = checkpoint["intercept"]
+                intercept_rounds = 0
+
             for _ in range(intercept_rounds):
                 booster.generate_term_update(
                     rng,
@@ -85,6 +99,7 @@ def boost(
                     cat_smooth=cat_smooth,
                     max_cat_threshold=develop.get_option("max_cat_threshold"),
                     cat_include=develop.get_option("cat_include"),
+                    random_retries=1,
                     max_leaves=1,
                     monotone_constraints=None,
                 )
@@ -113,6 +128,24 @@ def boost(
             nominals = native.extract_nominals(dataset)
             random_cyclic_ordering = np.arange(len(term_features), dtype=np.int64)
 
+            bestkey = None
+            heap = []
+            cached_update = None
+
+            if checkpoint is not None:
+                step_idx = checkpoint["step_idx"]
+                state_idx = checkpoint["state_idx"]
+                cyclic_state = checkpoint["cyclic_state"]
+                smoothing_rounds = checkpoint["smoothing_rounds"]
+                min_metric = checkpoint["min_metric"]
+                min_prev_metric = checkpoint["min_prev_metric"]
+                circular = checkpoint["circular"].copy()
+                circular_idx = checkpoint["circular_idx"]
+                random_cyclic_ordering = checkpoint["random_cyclic_ordering"].copy()
+                bestkey = checkpoint["bestkey"]
+                heap = list(checkpoint["heap"])
+                cached_update = checkpoint["cached_update"]
+
             while step_idx < max_steps:
                 if state_idx >= 0:
                     # cyclic
@@ -171,6 +204,35 @@ def boost(
                     # modify some of our parameters temporarily
                     term_boost_flags_local |= Native.TermBoostFlags_RandomSplits
 
+                if term_boost_flags_local & Native.TermBoostFlags_RandomSplits:
+                    random_min_leaf = develop.get_option("random_min_leaf")
+                    if random_min_leaf == "hard":
+                        term_boost_flags_local |= (
+                            Native.TermBoostFlags_RandomMinLeafHard
+                        )
+                    elif random_min_leaf == "soft":
+                        term_boost_flags_local |= (
+                            Native.TermBoostFlags_RandomMinLeafSoft
+                        )
+                    elif random_min_leaf is not None:
+                        msg = f"Unrecognized random_min_leaf option {random_min_leaf}."
+                        raise Exception(msg)
+
+                max_leaves_local = max_leaves
+                deep_pair_leaves = develop.get_option("deep_pair_leaves")
+                if (
+                    deep_pair_leaves is not None
+                    and len(term_features[term_idx]) >= 2
+                    and not term_boost_flags_local
+                    & (
+                        Native.TermBoostFlags_RandomSplits
+                        | Native.TermBoostFlags_Corners
+                        | Native.TermBoostFlags_Straight
+                    )
+                ):
+                    term_boost_flags_local |= Native.TermBoostFlags_DeepTree
+                    max_leaves_local = deep_pair_leaves
+
                 if bestkey is None or state_idx >= 0:
                     term_monotone = None
                     if monotone_constraints is not None:
@@ -197,7 +259,8 @@ def boost(
                         cat_smooth=cat_smooth,
                         max_cat_threshold=develop.get_option("max_cat_threshold"),
                         cat_include=develop.get_option("cat_include"),
-                        max_leaves=max_leaves,
+                        random_retries=develop.get_option("random_retries"),
+                        max_leaves=max_leaves_local,
                         monotone_constraints=term_monotone,
                     )
 
@@ -301,6 +364,33 @@ def boost(
                         if cyclic_state >= 1.0:
                             cyclic_state -= 1.0
                         cyclic_state += cyclic_progress
+
+                if (
+                    make_progress
+                    and checkpoint_callback is not None
+                    and checkpoint_steps > 0
+                    and step_idx % checkpoint_steps == 0
+                ):
+                    checkpoint_callback(
+                        {
+                            "booster": booster.serialize(rng),
+                            "intercept": intercept.copy(),
+                            "step_idx": step_idx,
+                            "state_idx": state_idx,
+                            "cyclic_state": cyclic_state,
+                            "smoothing_rounds": smoothing_rounds,
+                            "min_metric": min_metric,
+                            "min_prev_metric": min_prev_metric,
+                            "circular": circular.copy(),
+                            "circular_idx": circular_idx,
+                            "random_cyclic_ordering": random_cyclic_ordering.copy(),
+                            "bestkey": bestkey,
+                            "heap": list(heap),
+                            "cached_update": None
+                            if cached_update is None
+                            else cached_update.copy(),
+                        }
+                    )
             if len(circular) > 0:
                 model_update = booster.get_best_model()
             else:
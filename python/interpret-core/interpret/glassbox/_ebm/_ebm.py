@@ -21,7 +21,7 @@ from sklearn.base import (
     is_classifier,
     is_regressor,
 )
-from sklearn.isotonic import IsotonicRegression
+from sklearn.isotonic import check_increasing
 from sklearn.utils.validation import check_is_fitted
 
 from ... import develop
@@ -34,7 +34,12 @@ from ...utils._clean_simple import (
     typify_classification,
 )
 from ...utils._clean_x import preclean_X
-from ...utils._compressed_dataset import bin_native_by_dimension
+from ...utils._compressed_dataset import (
+    bin_native_levels,
+    is_dataset_binning,
+    map_term_features,
+    select_native_level,
+)
 from ...utils._explanation import (
     gen_global_selector,
     gen_local_selector,
@@ -57,7 +62,8 @@ from ...utils._unify_data import unify_data
 from ._bin import (
     ebm_eval_terms,
     ebm_predict_scores,
-    make_bin_weights,
+    ebm_predict_scores_binned,
+    make_bin_weights_binned,
 )
 from ._boost import boost
 from ._json import UNTESTED_from_jsonable, to_jsonable
@@ -65,10 +71,11 @@ from ._tensor import remove_last, trim_tensor
 from ._utils import (
     generate_term_names,
     generate_term_types,
-    make_bag,
+    make_bags,
     order_terms,
     process_terms,
     remove_extra_bins,
+    unpack_bag,
 )
 
 _log = logging.getLogger(__name__)
@@ -836,8 +843,7 @@ class EBMModel(ExplainerMixin, BaseEstimator):
         rng = native.branch_rng(native.create_rng(seed))
         used_seeds = set()
         rngs = []
-        internal_bags = []
-        for idx in range(self.outer_bags):
+        for _ in range(self.outer_bags):
             while True:
                 bagged_rng = native.branch_rng(rng)
                 check_seed = native.generate_seed(bagged_rng)
@@ -847,17 +853,24 @@ class EBMModel(ExplainerMixin, BaseEstimator):
                 if check_seed not in used_seeds:
                     break
             used_seeds.add(check_seed)
+            rngs.append(bagged_rng)
 
-            if bags is None:
-                bag = make_bag(
-                    y,
-                    n_classes,
-                    self.validation_size,
-                    bagged_rng,
-                    n_classes >= Native.Task_GeneralClassification
-                    and not is_differential_privacy,
-                )
-            else:
+        if bags is None:
+            # every outer bag comes from a single native plan, and each bag's rng is
+            # advanced there exactly as it would be by sampling that bag on its own.
+            # The bags stay packed in the plan and are only unpacked briefly below
+            # where python needs the per-sample values.
+            internal_bags = make_bags(
+                y,
+                n_classes,
+                self.validation_size,
+                rngs,
+                n_classes >= Native.Task_GeneralClassification
+                and not is_differential_privacy,
+            )
+        else:
+            internal_bags = []
+            for idx in range(self.outer_bags):
                 bag = bags[idx]
                 if not isinstance(bag, np.ndarray):
                     bag = np.array(bag)
@@ -873,25 +886,27 @@ class EBMModel(ExplainerMixin, BaseEstimator):
                     msg = "A value in bags is outside the valid range -128 to 127"
                     _log.error(msg)
                     raise ValueError(msg)
-                bag = bag.astype(np.int8, "C", copy=False)
-
-            rngs.append(bagged_rng)
-            internal_bags.append(bag)
+                internal_bags.append(bag.astype(np.int8, "C", copy=False))
 
         bag_weights = []
+        bag_has_validation = []
         for bag in internal_bags:
             if bag is None:
                 if sample_weight is None:
                     bag_weights.append(n_samples)
                 else:
                     bag_weights.append(sample_weight.sum())
+                bag_has_validation.append(False)
             else:
+                bag = unpack_bag(bag, n_samples)
                 keep = bag > 0
                 if sample_weight is None:
                     bag_weights.append(bag[keep].sum())
                 else:
                     bag_weights.append((bag[keep] * sample_weight[keep]).sum())
                 del keep
+                bag_has_validation.append(bool((bag < 0).any()))
+            del bag
         bag_weights = np.array(bag_weights, np.float64)
 
         if is_differential_privacy:
@@ -959,6 +974,8 @@ class EBMModel(ExplainerMixin, BaseEstimator):
                 term_boost_flags |= Native.TermBoostFlags_PurifyUpdate
             if develop.get_option("boost_corners"):
                 term_boost_flags |= Native.TermBoostFlags_Corners
+            elif develop.get_option("boost_straight"):
+                term_boost_flags |= Native.TermBoostFlags_Straight
             inner_bags = self.inner_bags
             greedy_ratio = self.greedy_ratio
             smoothing_rounds = self.smoothing_rounds
@@ -988,8 +1005,6 @@ class EBMModel(ExplainerMixin, BaseEstimator):
                 _log.error(msg)
                 raise ValueError(msg)
 
-            exclude_features = {i for i, v in enumerate(monotone_constraints) if v != 0}
-
         provider = JobLibProvider(n_jobs=self.n_jobs)
 
         bagged_intercept = np.zeros((self.outer_bags, n_scores), np.float64)
@@ -1002,7 +1017,7 @@ class EBMModel(ExplainerMixin, BaseEstimator):
                 n_intercept_rounds = 0
 
                 for idx in range(self.outer_bags):
-                    bag = internal_bags[idx]
+                    bag = unpack_bag(internal_bags[idx], n_samples)
                     sample_weight_local = sample_weight
                     y_local = y_shifted
                     if bag is not None:
@@ -1029,7 +1044,7 @@ class EBMModel(ExplainerMixin, BaseEstimator):
                 ):
                     n_intercept_rounds = 0
                     for idx in range(self.outer_bags):
-                        bag = internal_bags[idx]
+                        bag = unpack_bag(internal_bags[idx], n_samples)
                         sample_weight_local = sample_weight
                         y_local = y
                         if bag is not None:
@@ -1049,9 +1064,9 @@ class EBMModel(ExplainerMixin, BaseEstimator):
                         probs /= total
                         bagged_intercept[idx, :] = link_func(probs, link, link_param)
 
-        dataset = bin_native_by_dimension(
+        # X is only discretized here. Every later stage reads the cached bins instead.
+        dataset_cache, level_columns = bin_native_levels(
             n_classes,
-            1,
             bins,
             X,
             y,
@@ -1060,24 +1075,27 @@ class EBMModel(ExplainerMixin, BaseEstimator):
             feature_types_in,
         )
 
+        dataset_n_dimensions = 1
+        dataset = select_native_level(
+            dataset_cache, level_columns, dataset_n_dimensions
+        )
+
         parallel_args = []
         for idx in range(self.outer_bags):
             early_stopping_rounds_local = early_stopping_rounds
-            bag = internal_bags[idx]
-            if bag is None or (bag >= 0).all():
+            if not bag_has_validation[idx]:
                 # if there are no validation samples, turn off early stopping
                 # because the validation metric cannot improve each round
                 early_stopping_rounds_local = 0
 
             init_score_local = init_score
-            if (
-                init_score_local is not None
-                and bag is not None
-                and np.count_nonzero(bag) != len(bag)
-            ):
-                # TODO: instead of making these copies we should
-                # put init_score into the native shared dataframe
-                init_score_local = init_score_local[bag != 0]
+            if init_score_local is not None and internal_bags[idx] is not None:
+                bag = unpack_bag(internal_bags[idx], n_samples)
+                if np.count_nonzero(bag) != len(bag):
+                    # TODO: instead of making these copies we should
+                    # put init_score into the native shared dataframe
+                    init_score_local = init_score_local[bag != 0]
+                del bag
 
             parallel_args.append(
                 (
@@ -1085,7 +1103,7 @@ class EBMModel(ExplainerMixin, BaseEstimator):
                     n_intercept_rounds,
                     develop.get_option("intercept_learning_rate"),
                     bagged_intercept[idx],
-                    bag,
+                    internal_bags[idx],
                     init_score_local,
                     term_features,
                     inner_bags,
@@ -1186,41 +1204,41 @@ class EBMModel(ExplainerMixin, BaseEstimator):
             elif len(interactions) == 0:
                 break
 
-            # at this point we know we will be making a new one, so delete it now
-            del dataset
-
             # we pass the bagged intercept into the rank_interactions and boost functions below, so do not include twice
             initial_intercept = np.zeros(n_scores, np.float64)
+            if is_dataset_binning(bins, dataset_n_dimensions, term_features):
+                scores_dataset = dataset
+                scores_term_features = term_features
+            else:
+                scores_dataset = dataset_cache
+                scores_term_features = map_term_features(level_columns, term_features)
             scores_bags = []
             for model, bag in zip(models, internal_bags):
-                # TODO: instead of going back to the original data in X, we
-                # could use the compressed and already binned data in dataset
-                scores = ebm_predict_scores(
-                    X,
-                    n_samples,
+                scores = ebm_predict_scores_binned(
+                    scores_dataset,
+                    unpack_bag(bag, n_samples),
                     init_score,
-                    feature_names_in,
-                    feature_types_in,
-                    bins,
                     initial_intercept,
                     model,
-                    term_features,
+                    scores_term_features,
                 )
-                if bag is not None and np.count_nonzero(bag) != len(bag):
-                    scores = scores[bag != 0]
                 scores_bags.append(scores)
+            del scores_dataset
 
-            dataset = bin_native_by_dimension(
-                n_classes,
-                2,
-                bins,
-                X,
-                y,
-                sample_weight,
-                feature_names_in,
-                feature_types_in,
+            # at this point we know we will be making a new one, so delete it now
+            del dataset
+
+            dataset_n_dimensions = 2
+            dataset = select_native_level(
+                dataset_cache, level_columns, dataset_n_dimensions
             )
 
+            if is_dataset_binning(bins, dataset_n_dimensions, term_features):
+                # pairs always match the pair dataset, so if the mains do too then
+                # nothing reads the cache again and python can reclaim it before the
+                # pairs are ranked and boosted
+                dataset_cache = None
+
             if isinstance(interactions, int):
                 _log.info("Estimating with FAST")
 
@@ -1350,7 +1368,7 @@ class EBMModel(ExplainerMixin, BaseEstimator):
             parallel_args = []
             for idx in range(self.outer_bags):
                 early_stopping_rounds_local = early_stopping_rounds
-                if internal_bags[idx] is None or (internal_bags[idx] >= 0).all():
+                if not bag_has_validation[idx]:
                     # if there are no validation samples, turn off early stopping
                     # because the validation metric cannot improve each round
                     early_stopping_rounds_local = 0
@@ -1428,6 +1446,14 @@ class EBMModel(ExplainerMixin, BaseEstimator):
 
         best_iteration = np.array(best_iteration, np.int64)
 
+        # remove_extra_bins drops bin levels, so check the dataset's resolution first
+        is_dataset_binned = is_dataset_binning(
+            bins, dataset_n_dimensions, term_features
+        )
+        if is_dataset_binned:
+            # the last boosting dataset holds every term, so release the cache now
+            dataset_cache = None
+
         remove_extra_bins(term_features, bins)
 
         bagged_scores = (
@@ -1437,6 +1463,15 @@ class EBMModel(ExplainerMixin, BaseEstimator):
 
         term_features, bagged_scores = order_terms(term_features, bagged_scores)
 
+        if is_dataset_binned:
+            final_dataset = dataset
+            final_term_features = term_features
+        else:
+            final_dataset = dataset_cache
+            # level_columns was made from the bins before remove_extra_bins dropped
+            # levels
+            final_term_features = map_term_features(level_columns, term_features)
+
         if is_differential_privacy:
             # for now we only support mains for DP models
             bin_weights = [
@@ -1446,14 +1481,8 @@ class EBMModel(ExplainerMixin, BaseEstimator):
             histogram_edges = make_all_histogram_edges(
                 feature_bounds, histogram_weights
             )
-            bin_weights = make_bin_weights(
-                X,
-                n_samples,
-                sample_weight,
-                feature_names_in,
-                feature_types_in,
-                bins,
-                term_features,
+            bin_weights = make_bin_weights_binned(
+                final_dataset, sample_weight, final_term_features
             )
 
         if bagged_intercept.shape[1] == 1:
@@ -1464,16 +1493,13 @@ class EBMModel(ExplainerMixin, BaseEstimator):
         )
 
         if not is_differential_privacy:
-            scores = ebm_predict_scores(
-                X,
-                n_samples,
+            scores = ebm_predict_scores_binned(
+                final_dataset,
+                None,
                 init_score,
-                feature_names_in,
-                feature_types_in,
-                bins,
                 intercept,
                 term_scores,
-                term_features,
+                final_term_features,
             )
 
             if objective_code == Native.Objective_MonoClassification:
@@ -1539,7 +1565,9 @@ class EBMModel(ExplainerMixin, BaseEstimator):
                     bagged_intercept -= np.expand_dims(
                         bagged_intercept[..., zero_index], -1
                     )
+        del final_dataset
         del dataset
+        del dataset_cache
 
         if n_classes < Native.Task_GeneralClassification:
             # scikit-learn requires intercept to be float for RegressorMixin, not numpy
@@ -2207,6 +2235,9 @@ class EBMModel(ExplainerMixin, BaseEstimator):
     def monotonize(self, term, increasing="auto", passthrough=0.0):
         r"""Adjust a term to be monotone using isotonic regression.
 
+        Each outer bag in bagged_scores\_ is monotonized with isotonic regression weighted by
+        bin_weights\_, and term_scores\_ and standard_deviations\_ are recomputed from the bags.
+
         An important consideration is that this function only adjusts a single term and will not modify pairwise terms.
         When a feature needs to be globally monotonic, any pairwise terms that include the feature
         should be excluded from the model.
@@ -2266,38 +2297,49 @@ class EBMModel(ExplainerMixin, BaseEstimator):
             _log.error(msg)
             raise ValueError(msg)
 
-        # the missing and unseen bins are not part of the continuous range
-        y = self.term_scores_[term][1:-1]
-        x = np.arange(len(y), dtype=np.int64)
-
-        all_weights = self.bin_weights_[term]
-        weights = all_weights[1:-1]
-
-        # this should normally be zero, except if there are missing or unseen values
-        original_mean = np.average(y, weights=weights)
+        if increasing == "auto":
+            # the missing and unseen bins are not part of the continuous range
+            y = self.term_scores_[term][1:-1]
+            increasing = check_increasing(np.arange(len(y), dtype=np.int64), y)
 
-        # Fit isotonic regression weighted by training data bin counts
-        ir = IsotonicRegression(increasing=increasing)
-        y = ir.fit_transform(x, y, sample_weight=weights)
-
-        result_mean = np.average(y, weights=weights)
-        change = (original_mean - result_mean) * (1.0 - passthrough)
-        y += change
-
-        self.term_scores_[term][1:-1] = y
-
-        if passthrough > 0.0:
-            mean = np.average(self.term_scores_[term], weights=all_weights)
-            self.term_scores_[term] -= mean
-            self.intercept_ += mean
-
-        # TODO: in the future we can apply monotonize to the individual outer bags in bagged_scores_
-        #       and then re-compute standard_deviations_ and term_scores_ from the monotonized bagged scores.
-        #       but first we need to do some testing to figure out if this gives a worse result than applying
-        #       IsotonicRegression to the final model which should be more regularized
-        self.bagged_intercept_ = None
-        self.bagged_scores_[term] = None
-        self.standard_deviations_[term] = None
+        # every outer bag is monotonized in the same direction, so the averaged term is
+        # monotone too, and the spread between the bags still gives us error bars
+        native = Native.get_native_singleton()
+        bin_weights = self.bin_weights_[term]
+        bagged_scores = self.bagged_scores_[term]
+        if self.bagged_intercept_ is None or bagged_scores is None:
+            # the bags were discarded by an earlier edit, so the averaged term is all we
+            # have and it is monotonized as a single bag without error bars
+            bagged_intercept = np.zeros(1, np.float64)
+            term_scores, _ = native.monotonize_bagged_term(
+                bagged_intercept,
+                self.term_scores_[term][np.newaxis],
+                bin_weights,
+                None,
+                increasing,
+                passthrough,
+            )
+            self.term_scores_[term] = term_scores
+            self.standard_deviations_[term] = None
+            self.intercept_ += bagged_intercept[0]
+        else:
+            bag_weights = getattr(self, "bag_weights_", None)
+            original_intercept = self.bagged_intercept_.copy()
+            term_scores, standard_deviations = native.monotonize_bagged_term(
+                self.bagged_intercept_,
+                bagged_scores,
+                bin_weights,
+                bag_weights,
+                increasing,
+                passthrough,
+            )
+            self.term_scores_[term] = term_scores
+            self.standard_deviations_[term] = standard_deviations
+            if passthrough > 0.0:
+                change = native.safe_mean(
+                    self.bagged_intercept_ - original_intercept, bag_weights
+                )
+                self.intercept_ += change[0]
 
         return self
 
@@ -2834,6 +2876,9 @@ class ExplainableBoostingClassifier(ClassifierMixin, EBMModel):
             - 0: No monotonic constraint is imposed on the corresponding feature's partial response.
             - +1: The partial response of the corresponding feature should be monotonically increasing with respect to the target.
             - -1: The partial response of the corresponding feature should be monotonically decreasing with respect to the target.
+
+        Pairs that include a constrained feature are boosted under the same
+        constraint along that feature, so they can still be selected as interactions.
     objective : str, default="log_loss"
         The objective to optimize.
     n_jobs : int, default=-2
@@ -3334,6 +3379,9 @@ class ExplainableBoostingRegressor(RegressorMixin, EBMModel):
             - 0: No monotonic constraint is imposed on the corresponding feature's partial response.
             - +1: The partial response of the corresponding feature should be monotonically increasing with respect to the target.
             - -1: The partial response of the corresponding feature should be monotonically decreasing with respect to the target.
+
+        Pairs that include a constrained feature are boosted under the same
+        constraint along that feature, so they can still be selected as interactions.
     objective : str, default="rmse"
         The objective to optimize. Options include: "rmse",
         "poisson_deviance", "tweedie_deviance:variance_power=1.5", "gamma_deviance",
@@ -10,7 +10,7 @@ from math import floor, exp, isfinite, isinf, log
 import numpy as np
 
 from ... import develop
-from ...utils._native import Native
+from ...utils._native import BagPlanRow, Native
 from ...utils._purify import purify
 from ._tensor import restore_missing_value_zeros
 
@@ -200,23 +200,33 @@ def process_bag_terms(intercept, term_scores, bin_weights):
 def process_terms(bagged_intercept, bagged_scores, bin_weights, bag_weights):
     native = Native.get_native_singleton()
 
-    n_bags = len(bag_weights)
-    n_terms = len(bin_weights)
-    for bag_idx in range(n_bags):
-        term_scores = [bagged_tensor[bag_idx] for bagged_tensor in bagged_scores]
-        intercept = np.atleast_1d(bagged_intercept[bag_idx])
-        process_bag_terms(intercept, term_scores, bin_weights)
-        bagged_intercept[bag_idx] = intercept[0] if len(intercept) == 1 else intercept
-        for term_idx in range(n_terms):
-            bagged_scores[term_idx][bag_idx] = term_scores[term_idx]
-
-    term_scores = []
-    standard_deviations = []
-    for scores in bagged_scores:
-        averaged = native.safe_mean(scores, bag_weights)
-        term_scores.append(averaged)
-        stddevs = native.safe_stddev(scores, bag_weights)
-        standard_deviations.append(stddevs)
+    if develop.get_option("purify_result"):
+        n_bags = len(bag_weights)
+        n_terms = len(bin_weights)
+        for bag_idx in range(n_bags):
+            term_scores = [bagged_tensor[bag_idx] for bagged_tensor in bagged_scores]
+            intercept = np.atleast_1d(bagged_intercept[bag_idx])
+            process_bag_terms(intercept, term_scores, bin_weights)
+            bagged_intercept[bag_idx] = (
+                intercept[0] if len(intercept) == 1 else intercept
+            )
+            for term_idx in range(n_terms):
+                bagged_scores[term_idx][bag_idx] = term_scores[term_idx]
+
+        term_scores = []
+        standard_deviations = []
+        for scores in bagged_scores:
+            averaged = native.safe_mean(scores, bag_weights)
+            term_scores.append(averaged)
+            stddevs = native.safe_stddev(scores, bag_weights)
+            standard_deviations.append(stddevs)
+    else:
+        # the centering, intercept transfer, missing/unseen cleanup and averaging across
+        # bags that process_bag_terms does one bag at a time are done natively for all
+        # bags and terms in one call
+        term_scores, standard_deviations = native.finalize_bagged_terms(
+            bagged_intercept, bagged_scores, bin_weights, bag_weights
+        )
 
     intercept = native.safe_mean(bagged_intercept, bag_weights)
 
@@ -349,15 +359,10 @@ def convert_to_cuts(intervals):  # pragma: no cover
     return cuts
 
 
-def make_bag(y, n_classes, test_size, rng, is_stratified):
-    # all test/train splits should be done with this function to ensure that
-    # if we re-generate the train/test splits that they are generated exactly
-    # the same as before
-
+def _count_validation_samples(n_samples, test_size):
     if test_size < 0:  # pragma: no cover
         msg = "test_size must be a positive numeric value."
         raise Exception(msg)
-    n_samples = len(y)
 
     if 1 <= test_size:
         if test_size % 1:
@@ -368,13 +373,23 @@ def make_bag(y, n_classes, test_size, rng, is_stratified):
         # prefer training samples
         test_size = floor(n_samples * test_size)
 
-    if test_size == 0:
-        return None
-
-    if n_samples <= test_size:
+    if test_size != 0 and n_samples <= test_size:
         msg = "The entire dataset cannot exclusively be validation. There must be some training data."
         raise Exception(msg)
 
+    return test_size
+
+
+def make_bag(y, n_classes, test_size, rng, is_stratified):
+    # all test/train splits should be done with this function to ensure that
+    # if we re-generate the train/test splits that they are generated exactly
+    # the same as before
+
+    n_samples = len(y)
+    test_size = _count_validation_samples(n_samples, test_size)
+    if test_size == 0:
+        return None
+
     n_train_samples = n_samples - test_size
     native = Native.get_native_singleton()
 
@@ -386,3 +401,35 @@ def make_bag(y, n_classes, test_size, rng, is_stratified):
         bag = native.sample_without_replacement(rng, n_train_samples, test_size)
 
     return bag
+
+
+def make_bags(y, n_classes, test_size, rngs, is_stratified):
+    # generates the bags for all the rngs in one native call. Each bag is identical
+    # to what make_bag generates with the same rng, and each rng is advanced the same.
+    # The bags stay packed in the plan, and each returned BagPlanRow is passed as-is
+    # to the native booster and interaction detector. Use unpack_bag where python
+    # needs the per-sample values.
+
+    n_samples = len(y)
+    test_size = _count_validation_samples(n_samples, test_size)
+    if test_size == 0:
+        return [None] * len(rngs)
+
+    n_train_samples = n_samples - test_size
+    native = Native.get_native_singleton()
+
+    plan = native.generate_bag_plan(
+        rngs,
+        n_train_samples,
+        test_size,
+        n_classes if is_stratified else 0,
+        y if is_stratified else None,
+    )
+    return [BagPlanRow(plan, idx) for idx in range(len(rngs))]
+
+
+def unpack_bag(bag, n_samples):
+    # returns the int8 form of a bag, which can be None, an int8 array, or a BagPlanRow
+    if isinstance(bag, BagPlanRow):
+        return bag.unpack(n_samples)
+    return bag
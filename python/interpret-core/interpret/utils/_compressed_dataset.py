@@ -185,3 +185,189 @@ def bin_native_by_dimension(
         feature_names_in,
         feature_types_in,
     )
+
+
+def is_dataset_binning(bins, n_dimensions, term_features):
+    # a dataset made by bin_native_by_dimension or select_native_level with n_dimensions
+    # uses the same bins as our terms if every feature would be discretized at the same
+    # resolution
+    for feature_idxs in term_features:
+        for feature_idx in feature_idxs:
+            n_levels = len(bins[feature_idx])
+            if min(n_levels, len(feature_idxs)) != min(n_levels, n_dimensions):
+                return False
+    return True
+
+
+def _is_same_bins(feature_bins, other_bins):
+    if isinstance(feature_bins, dict):
+        return isinstance(other_bins, dict) and feature_bins == other_bins
+    return not isinstance(other_bins, dict) and np.array_equal(feature_bins, other_bins)
+
+
+def bin_native_levels(
+    n_classes,
+    bins,
+    X,
+    y,
+    sample_weight,
+    feature_names_in,
+    feature_types_in,
+):
+    # called under: fit
+
+    # Builds a native dataset that caches every feature at each of its bin resolutions,
+    # so X is cleaned and discretized only once per fit. Resolutions with the same bins
+    # as an earlier level share its column. level_columns[level][feature_idx] is the
+    # column holding feature_idx binned for terms with (level + 1) dimensions. Use
+    # select_native_level to make the dataset for a boosting stage, and
+    # map_term_features to score or weigh terms directly from the cache.
+
+    _log.info("Creating native dataset cache")
+
+    n_samples = len(y)
+
+    native = Native.get_native_singleton()
+
+    n_weights = 0
+    if sample_weight is not None:
+        n_weights = 1
+        if not sample_weight.flags.c_contiguous:
+            # sample_weight could be a slice that has a stride.  We need contiguous for caling into C
+            sample_weight = sample_weight.copy()
+
+    if not y.flags.c_contiguous:
+        # y could be a slice that has a stride.  We need contiguous for caling into C
+        y = y.copy()
+
+    n_levels = max((len(bin_levels) for bin_levels in bins), default=1)
+    level_columns = [[] for _ in range(n_levels)]
+
+    # the bin indexes are held in the smallest integer type that fits until the dataset is filled
+    columns = []
+    n_bytes = 0
+    get_col = unify_columns(
+        X, n_samples, feature_names_in, feature_types_in, None, False, False
+    )
+    for feature_idx, bin_levels in enumerate(bins):
+        feature_type = feature_types_in[feature_idx]
+        if feature_type == "ignore":
+            # TODO: exclude ignored features from the compressed dataset
+            raise Exception("ignored features not supported yet")
+
+        _, nonmissings, uniques, X_col_raw, bad_raw = get_col(feature_idx)
+
+        feature_columns = []
+        for level_idx, columns_at_level in enumerate(level_columns):
+            feature_bins = bin_levels[min(len(bin_levels), level_idx + 1) - 1]
+
+            column_idx = None
+            for other_bins, other_idx in feature_columns:
+                if _is_same_bins(feature_bins, other_bins):
+                    column_idx = other_idx
+                    break
+
+            if column_idx is None:
+                bad = bad_raw
+                if isinstance(feature_bins, dict):
+                    # categorical feature
+
+                    X_col = categorical_encode(
+                        uniques, X_col_raw, nonmissings, feature_bins
+                    )
+                    bad = X_col == -1
+                    if not bad.any():
+                        bad = None
+                    n_bins = (
+                        2
+                        if len(feature_bins) == 0
+                        else (max(feature_bins.values()) + 2)
+                    )
+                else:
+                    # continuous feature
+
+                    X_col = native.discretize(X_col_raw, feature_bins)
+                    n_bins = len(feature_bins) + 3
+
+                if bad is not None:
+                    X_col[bad] = n_bins - 1
+
+                is_missing = np.count_nonzero(X_col) != len(X_col)
+                is_unseen = bad is not None
+                is_nominal = feature_type == "nominal"
+                n_bytes += native.measure_feature(
+                    n_bins, is_missing, is_unseen, is_nominal, X_col
+                )
+
+                column_idx = len(columns)
+                columns.append(
+                    (
+                        n_bins,
+                        is_missing,
+                        is_unseen,
+                        is_nominal,
+                        X_col.astype(np.min_scalar_type(n_bins - 1)),
+                    )
+                )
+                feature_columns.append((feature_bins, column_idx))
+
+            columns_at_level.append(column_idx)
+
+    n_bytes += native.measure_dataset_header(len(columns), n_weights, 1)
+
+    if sample_weight is not None:
+        n_bytes += native.measure_weight(sample_weight)
+
+    if y.dtype == np.float64:
+        n_bytes += native.measure_regression_target(y)
+    elif y.dtype == np.int64:
+        n_bytes += native.measure_classification_target(n_classes, y)
+    else:
+        msg = "y must be either float64 or int64"
+        _log.error(msg)
+        raise ValueError(msg)
+
+    dataset = np.empty(n_bytes, np.ubyte)  # joblib loky doesn't support RawArray
+
+    native.fill_dataset_header(len(columns), n_weights, 1, dataset)
+
+    for n_bins, is_missing, is_unseen, is_nominal, X_col in columns:
+        native.fill_feature(
+            n_bins,
+            is_missing,
+            is_unseen,
+            is_nominal,
+            X_col.astype(np.int64),
+            dataset,
+        )
+
+    if sample_weight is not None:
+        native.fill_weight(sample_weight, dataset)
+
+    if y.dtype == np.float64:
+        native.fill_regression_target(y, dataset)
+    else:
+        native.fill_classification_target(n_classes, y, dataset)
+
+    return dataset, level_columns
+
+
+def select_native_level(dataset, level_columns, n_dimensions):
+    # makes the same dataset that bin_native_by_dimension would, but copies the already
+    # binned columns out of a dataset made by bin_native_levels instead of using X
+
+    columns = level_columns[min(len(level_columns), n_dimensions) - 1]
+    return Native.get_native_singleton().select_dataset_features(dataset, columns)
+
+
+def map_term_features(level_columns, term_features):
+    # converts term feature indexes into the columns of a dataset made by
+    # bin_native_levels that hold each term's features at the resolution the term uses
+
+    return [
+        tuple(
+            level_columns[min(len(level_columns), len(feature_idxs)) - 1][feature_idx]
+            for feature_idx in feature_idxs
+        )
+        for feature_idxs in term_features
+    ]
@@ -127,6 +127,35 @@ def link_func(predictions, link, link_param=np.nan):
     raise ValueError(msg)
 
 
+_native_inv_links = {"logit", "vlogit", "mlogit", "log"}
+
+
+def _native_inv_link(scores, link, link_param):
+    # deferred imports since develop imports the utils package
+    from .. import develop
+    from ._native import Native
+
+    if not develop.get_option("native_inv_link"):
+        return None
+
+    # leave the shapes that need special handling or error messages to numpy
+    if scores.ndim == 0:
+        return None
+    if link == "logit" and scores.ndim != 1:
+        return None
+    if link in ("vlogit", "mlogit") and (scores.ndim != 2 or scores.shape[-1] <= 1):
+        return None
+
+    # native works in place, so this is our only allocation for all but logit
+    val = np.array(scores, np.float64, order="C")
+    Native.get_native_singleton().inverse_link(
+        val, link, link_param, develop.get_option("acceleration")
+    )
+    if link == "logit":
+        return np.c_[1.0 - val, val]
+    return val
+
+
 def inv_link(scores, link, link_param=np.nan):
     """Applies the inverse link function to scores to generate predictions.
 
@@ -140,6 +169,10 @@ def inv_link(scores, link, link_param=np.nan):
     """
 
     scores = np.asarray(scores, np.float64)
+    if link in _native_inv_links:
+        val = _native_inv_link(scores, link, link_param)
+        if val is not None:
+            return val
     if link == "identity":
         return scores.copy()
     if link == "logit":
@@ -28,6 +28,7 @@ class Native:
     CreateBoosterFlags_Default = 0x00000000
     CreateBoosterFlags_DifferentialPrivacy = 0x00000001
     CreateBoosterFlags_UseApprox = 0x00000002
+    CreateBoosterFlags_PackByFeature = 0x00000008
 
     # TermBoostFlags
     TermBoostFlags_Default = 0x00000000
@@ -42,6 +43,10 @@ class Native:
     TermBoostFlags_MissingHigh = 0x00000100
     TermBoostFlags_MissingSeparate = 0x00000200
     TermBoostFlags_Corners = 0x00000400
+    TermBoostFlags_RandomMinLeafHard = 0x00000800
+    TermBoostFlags_RandomMinLeafSoft = 0x00001000
+    TermBoostFlags_Straight = 0x00002000
+    TermBoostFlags_DeepTree = 0x00004000
 
     # CreateInteractionFlags
     CreateInteractionFlags_Default = 0x00000000
@@ -231,6 +236,18 @@ class Native:
 
         self._unsafe.SetTraceLevel(trace_level)
 
+    def start_recording(self, filename):
+        # records the booster and interaction calls made until stop_recording into
+        # filename so that the native replay tool can re-execute them without python
+        return_code = self._unsafe.StartRecording(os.fsencode(filename))
+        if return_code:  # pragma: no cover
+            raise Native._get_native_exception(return_code, "StartRecording")
+
+    def stop_recording(self):
+        return_code = self._unsafe.StopRecording()
+        if return_code:  # pragma: no cover
+            raise Native._get_native_exception(return_code, "StopRecording")
+
     def clean_float(self, val):
         # the EBM spec does not allow subnormal floats to be in the model definition, so flush them to zero
         val_array = np.array([val], np.float64)
@@ -321,6 +338,120 @@ class Native:
 
         return stddev_result
 
+    def finalize_bagged_terms(
+        self, bagged_intercept, bagged_scores, bin_weights, bag_weights, n_threads=0
+    ):
+        """Centers every bag's term tensors, moves the means into that bag's intercept,
+        zeros missing/unseen slices that have no weight, and averages across bags.
+
+        bagged_intercept and bagged_scores are updated in place. The terms are pulled
+        from a native work queue by n_threads threads. 0 means one thread per core.
+        Returns the averaged term scores and their standard deviations across bags.
+        """
+        if len(bagged_scores) == 0:
+            return [], []
+
+        n_bags = bagged_intercept.shape[0]
+        n_scores = 1 if bagged_intercept.ndim == 1 else bagged_intercept.shape[1]
+
+        dimension_counts = np.array([w.ndim for w in bin_weights], np.int64)
+        bin_counts = np.array([n for w in bin_weights for n in w.shape], np.int64)
+        flat_weights = np.concatenate([w.ravel() for w in bin_weights]).astype(
+            np.float64, copy=False
+        )
+        if bag_weights is not None:
+            bag_weights = bag_weights.astype(np.float64, copy=False)
+
+        intercepts = np.array(bagged_intercept, np.float64)
+        flat_scores = np.concatenate([s.ravel() for s in bagged_scores]).astype(
+            np.float64, copy=False
+        )
+        n_cells = len(flat_weights) * n_scores
+        flat_term_scores = np.empty(n_cells, np.float64)
+        flat_stddevs = np.empty(n_cells, np.float64)
+
+        return_code = self._unsafe.FinalizeBaggedTerms(
+            n_bags,
+            n_scores,
+            len(dimension_counts),
+            Native._make_pointer(dimension_counts, np.int64),
+            Native._make_pointer(bin_counts, np.int64, is_null_allowed=True),
+            Native._make_pointer(flat_weights, np.float64),
+            Native._make_pointer(bag_weights, np.float64, is_null_allowed=True),
+            n_threads,
+            Native._make_pointer(intercepts, np.float64, None),
+            Native._make_pointer(flat_scores, np.float64),
+            Native._make_pointer(flat_term_scores, np.float64),
+            Native._make_pointer(flat_stddevs, np.float64),
+        )
+        if return_code:  # pragma: no cover
+            raise Native._get_native_exception(return_code, "FinalizeBaggedTerms")
+
+        bagged_intercept[...] = intercepts
+
+        term_scores = []
+        standard_deviations = []
+        bag_start = 0
+        term_start = 0
+        for scores in bagged_scores:
+            shape = scores.shape[1:]
+            n_term_cells = math.prod(shape)
+            bag_end = bag_start + n_bags * n_term_cells
+            scores[...] = flat_scores[bag_start:bag_end].reshape(scores.shape)
+            term_end = term_start + n_term_cells
+            term_scores.append(flat_term_scores[term_start:term_end].reshape(shape))
+            standard_deviations.append(flat_stddevs[term_start:term_end].reshape(shape))
+            bag_start = bag_end
+            term_start = term_end
+
+        return term_scores, standard_deviations
+
+    def monotonize_bagged_term(
+        self,
+        bagged_intercept,
+        bagged_scores,
+        bin_weights,
+        bag_weights,
+        increasing,
+        passthrough,
+    ):
+        """Applies weighted isotonic regression to every bag of a univariate term.
+
+        The first (missing) and last (unseen) bins are not part of the ordered range.
+        bagged_intercept and bagged_scores are updated in place, with the passthrough
+        fraction of the change to the mean moved into bagged_intercept.
+        Returns the averaged term scores and their standard deviations across bags.
+        """
+        n_bags, n_bins = bagged_scores.shape
+
+        intercepts = np.array(bagged_intercept, np.float64)
+        scores = np.array(bagged_scores, np.float64)
+        weights = bin_weights.astype(np.float64, copy=False)
+        if bag_weights is not None:
+            bag_weights = bag_weights.astype(np.float64, copy=False)
+        term_scores = np.empty(n_bins, np.float64)
+        standard_deviations = np.empty(n_bins, np.float64)
+
+        return_code = self._unsafe.MonotonizeBaggedTerm(
+            n_bags,
+            n_bins,
+            1 if increasing else 0,
+            passthrough,
+            Native._make_pointer(weights, np.float64),
+            Native._make_pointer(bag_weights, np.float64, is_null_allowed=True),
+            Native._make_pointer(intercepts, np.float64),
+            Native._make_pointer(scores, np.float64, 2),
+            Native._make_pointer(term_scores, np.float64),
+            Native._make_pointer(standard_deviations, np.float64),
+        )
+        if return_code:  # pragma: no cover
+            raise Native._get_native_exception(return_code, "MonotonizeBaggedTerm")
+
+        bagged_intercept[...] = intercepts
+        bagged_scores[...] = scores
+
+        return term_scores, standard_deviations
+
     def create_rng(self, random_state):
         if random_state is None:
             return None  # non-deterministic
@@ -616,6 +747,23 @@ class Native:
 
         return bin_indexes
 
+    def discretize_cached(self, X_col, cuts):
+        # same bins as discretize, plus the number of samples resolved without a search
+        bin_indexes = np.empty(X_col.shape[0], dtype=np.int64, order="C")
+        n_hits = ct.c_int64(0)
+        return_code = self._unsafe.DiscretizeCached(
+            X_col.shape[0],
+            Native._make_pointer(X_col, np.float64),
+            cuts.shape[0],
+            Native._make_pointer(cuts, np.float64),
+            Native._make_pointer(bin_indexes, np.int64),
+            ct.byref(n_hits),
+        )
+        if return_code:  # pragma: no cover
+            raise Native._get_native_exception(return_code, "DiscretizeCached")
+
+        return bin_indexes, n_hits.value
+
     def measure_dataset_header(self, n_features, n_weights, n_targets):
         n_bytes = self._unsafe.MeasureDataSetHeader(n_features, n_weights, n_targets)
         if n_bytes < 0:  # pragma: no cover
@@ -788,6 +936,118 @@ class Native:
 
         return class_counts
 
+    def score_dataset(self, dataset, bag, n_scores, term_scores, term_features):
+        # sums the term scores for each sample in the binned dataset. Samples with a
+        # zero bag entry are excluded from the result.
+        n_samples, n_features, _, _ = self.extract_dataset_header(dataset)
+        bin_counts = self.extract_bin_counts(dataset, n_features)
+
+        for feature_idxs, scores in zip(term_features, term_scores):
+            shape = tuple(int(bin_counts[i]) for i in feature_idxs)
+            if n_scores != 1:
+                shape += (n_scores,)
+            if scores.shape != shape:  # pragma: no cover
+                msg = f"term scores shape {scores.shape} does not match the dataset bins {shape}"
+                raise ValueError(msg)
+
+        if bag is not None:
+            if len(bag) != n_samples:  # pragma: no cover
+                msg = "bag should have the same number of samples as the dataset"
+                raise ValueError(msg)
+            n_samples = np.count_nonzero(bag)
+
+        dimension_counts = np.array([len(f) for f in term_features], np.int64)
+        feature_indexes = np.array([i for f in term_features for i in f], np.int64)
+        tensors = (
+            np.concatenate([np.ravel(s) for s in term_scores]).astype(
+                np.float64, copy=False
+            )
+            if len(term_scores) != 0
+            else None
+        )
+
+        scores = np.empty(
+            n_samples if n_scores == 1 else (n_samples, n_scores), np.float64, "C"
+        )
+
+        return_code = self._unsafe.ScoreDataSet(
+            Native._make_pointer(dataset, np.ubyte),
+            Native._make_pointer(bag, np.int8, is_null_allowed=True),
+            len(dimension_counts),
+            Native._make_pointer(dimension_counts, np.int64, is_null_allowed=True),
+            Native._make_pointer(feature_indexes, np.int64, is_null_allowed=True),
+            n_scores,
+            Native._make_pointer(tensors, np.float64, is_null_allowed=True),
+            Native._make_pointer(scores, np.float64, None),
+        )
+        if return_code:  # pragma: no cover
+            raise Native._get_native_exception(return_code, "ScoreDataSet")
+
+        return scores
+
+    def extract_term_bin_weights(self, dataset, sample_weight, term_features):
+        # computes the weight of each bin in every term tensor from the binned dataset.
+        # With no sample_weight each sample has a weight of 1.
+        n_samples, n_features, _, _ = self.extract_dataset_header(dataset)
+        bin_counts = self.extract_bin_counts(dataset, n_features)
+
+        if sample_weight is not None:
+            if len(sample_weight) != n_samples:  # pragma: no cover
+                msg = "sample_weight should have the same number of samples as the dataset"
+                raise ValueError(msg)
+            sample_weight = sample_weight.astype(np.float64, copy=False)
+
+        shapes = [tuple(int(bin_counts[i]) for i in f) for f in term_features]
+        dimension_counts = np.array([len(f) for f in term_features], np.int64)
+        feature_indexes = np.array([i for f in term_features for i in f], np.int64)
+        bin_weights = np.empty(sum(int(np.prod(s)) for s in shapes), np.float64)
+
+        return_code = self._unsafe.ExtractTermBinWeights(
+            Native._make_pointer(dataset, np.ubyte),
+            Native._make_pointer(sample_weight, np.float64, is_null_allowed=True),
+            len(dimension_counts),
+            Native._make_pointer(dimension_counts, np.int64, is_null_allowed=True),
+            Native._make_pointer(feature_indexes, np.int64, is_null_allowed=True),
+            Native._make_pointer(bin_weights, np.float64, is_null_allowed=True),
+        )
+        if return_code:  # pragma: no cover
+            raise Native._get_native_exception(return_code, "ExtractTermBinWeights")
+
+        tensors = []
+        start = 0
+        for shape in shapes:
+            end = start + int(np.prod(shape))
+            tensors.append(bin_weights[start:end].reshape(shape))
+            start = end
+        return tensors
+
+    def select_dataset_features(self, dataset, feature_indexes):
+        # copies the already binned features at feature_indexes, along with the weights
+        # and targets, into a new dataset without going back to the raw data
+        feature_indexes = np.array(feature_indexes, np.int64)
+
+        n_bytes = self._unsafe.MeasureDataSetSubset(
+            Native._make_pointer(dataset, np.ubyte),
+            len(feature_indexes),
+            Native._make_pointer(feature_indexes, np.int64, is_null_allowed=True),
+        )
+        if n_bytes < 0:  # pragma: no cover
+            raise Native._get_native_exception(n_bytes, "MeasureDataSetSubset")
+
+        subset = np.empty(n_bytes, np.ubyte)  # joblib loky doesn't support RawArray
+
+        return_code = self._unsafe.FillDataSetSubset(
+            Native._make_pointer(dataset, np.ubyte),
+            len(feature_indexes),
+            Native._make_pointer(feature_indexes, np.int64, is_null_allowed=True),
+            subset.nbytes,
+            Native._make_pointer(subset, np.ubyte),
+        )
+        if return_code:  # pragma: no cover
+            raise Native._get_native_exception(return_code, "FillDataSetSubset")
+
+        return subset
+
     def sample_without_replacement(
         self, rng, count_training_samples, count_validation_samples
     ):
@@ -838,6 +1098,73 @@ class Native:
 
         return bag
 
+    def generate_bag_plan(
+        self,
+        rngs,
+        count_training_samples,
+        count_validation_samples,
+        n_classes=0,
+        targets=None,
+        n_groups=0,
+        groups=None,
+    ):
+        """Generates every outer bag in one call into a plan packed at 2 bits per sample.
+
+        rngs holds one rng per bag, or is None for non-deterministic bags. Each rng is
+        advanced exactly as the single bag sampling functions would advance it.
+        """
+        n_bags = len(rngs)
+        count_samples = count_training_samples + count_validation_samples
+
+        if targets is not None and not targets.flags.c_contiguous:
+            # targets could be a slice with a stride. We need contiguous for C
+            targets = targets.copy()
+        if groups is not None:
+            groups = groups.astype(np.int64, "C", copy=False)
+
+        is_deterministic = all(rng is not None for rng in rngs)
+        joined_rngs = np.concatenate(rngs) if is_deterministic and n_bags else None
+
+        n_bytes = self._unsafe.MeasureBagPlan(n_bags, count_samples)
+        if n_bytes < 0:  # pragma: no cover
+            raise Native._get_native_exception(n_bytes, "MeasureBagPlan")
+        plan = np.empty(n_bytes, np.ubyte)
+
+        return_code = self._unsafe.GenerateBagPlan(
+            Native._make_pointer(joined_rngs, np.ubyte, is_null_allowed=True),
+            n_bags,
+            count_training_samples,
+            count_validation_samples,
+            n_classes,
+            Native._make_pointer(targets, np.int64, is_null_allowed=True),
+            n_groups,
+            Native._make_pointer(groups, np.int64, is_null_allowed=True),
+            n_bytes,
+            Native._make_pointer(plan, np.ubyte),
+        )
+        if return_code:  # pragma: no cover
+            raise Native._get_native_exception(return_code, "GenerateBagPlan")
+
+        if joined_rngs is not None:
+            # the rngs continue on into boosting, so hand back their advanced state
+            for rng, advanced in zip(rngs, np.split(joined_rngs, n_bags)):
+                rng[...] = advanced
+
+        return plan
+
+    def extract_bag(self, plan, bag_index, n_samples):
+        bag = np.empty(n_samples, dtype=np.int8, order="C")
+
+        return_code = self._unsafe.ExtractBag(
+            Native._make_pointer(plan, np.ubyte),
+            bag_index,
+            Native._make_pointer(bag, np.int8, is_null_allowed=True),
+        )
+        if return_code:  # pragma: no cover
+            raise Native._get_native_exception(return_code, "ExtractBag")
+
+        return bag
+
     def determine_task(self, objective):
         task = ct.c_int64(Native.Task_Unknown)
 
@@ -880,6 +1207,21 @@ class Native:
 
         return (objective_code.value, link.decode("ascii"), link_param.value)
 
+    def inverse_link(self, scores, link, link_param, acceleration):
+        # converts C ordered float64 scores to predictions in place
+        link_code = self._unsafe.GetLinkFunctionInt(link.encode("ascii"))
+        n_scores = 1 if scores.ndim <= 1 else scores.shape[-1]
+        return_code = self._unsafe.InverseLink(
+            acceleration,
+            link_code,
+            link_param,
+            scores.size // n_scores,
+            n_scores,
+            Native._make_pointer(scores, np.float64, None),
+        )
+        if return_code:  # pragma: no cover
+            raise Native._get_native_exception(return_code, "InverseLink")
+
     @staticmethod
     def _get_ebm_lib_path(debug=False):
         """Returns filepath of core EBM library.
@@ -1026,6 +1368,15 @@ class Native:
         ]
         self._unsafe.SetTraceLevel.restype = None
 
+        self._unsafe.StartRecording.argtypes = [
+            # char * filename
+            ct.c_char_p
+        ]
+        self._unsafe.StartRecording.restype = ct.c_int32
+
+        self._unsafe.StopRecording.argtypes = []
+        self._unsafe.StopRecording.restype = ct.c_int32
+
         self._unsafe.CleanFloats.argtypes = [
             # int64_t count
             ct.c_int64,
@@ -1062,6 +1413,58 @@ class Native:
         ]
         self._unsafe.SafeStandardDeviation.restype = ct.c_int32
 
+        self._unsafe.FinalizeBaggedTerms.argtypes = [
+            # int64_t countBags
+            ct.c_int64,
+            # int64_t countScores
+            ct.c_int64,
+            # int64_t countTerms
+            ct.c_int64,
+            # int64_t * dimensionCounts
+            ct.c_void_p,
+            # int64_t * binCounts
+            ct.c_void_p,
+            # double * binWeights
+            ct.c_void_p,
+            # double * bagWeights
+            ct.c_void_p,
+            # int64_t countThreads
+            ct.c_int64,
+            # double * bagInterceptsInOut
+            ct.c_void_p,
+            # double * bagScoresInOut
+            ct.c_void_p,
+            # double * termScoresOut
+            ct.c_void_p,
+            # double * standardDeviationsOut
+            ct.c_void_p,
+        ]
+        self._unsafe.FinalizeBaggedTerms.restype = ct.c_int32
+
+        self._unsafe.MonotonizeBaggedTerm.argtypes = [
+            # int64_t countBags
+            ct.c_int64,
+            # int64_t countBins
+            ct.c_int64,
+            # int32_t isIncreasing
+            ct.c_int32,
+            # double passthrough
+            ct.c_double,
+            # double * binWeights
+            ct.c_void_p,
+            # double * bagWeights
+            ct.c_void_p,
+            # double * bagInterceptsInOut
+            ct.c_void_p,
+            # double * bagScoresInOut
+            ct.c_void_p,
+            # double * termScoresOut
+            ct.c_void_p,
+            # double * standardDeviationsOut
+            ct.c_void_p,
+        ]
+        self._unsafe.MonotonizeBaggedTerm.restype = ct.c_int32
+
         self._unsafe.MeasureRNG.argtypes = []
         self._unsafe.MeasureRNG.restype = ct.c_int64
 
@@ -1239,6 +1642,22 @@ class Native:
         ]
         self._unsafe.Discretize.restype = ct.c_int32
 
+        self._unsafe.DiscretizeCached.argtypes = [
+            # int64_t countSamples
+            ct.c_int64,
+            # double * featureVals
+            ct.c_void_p,
+            # int64_t countCuts
+            ct.c_int64,
+            # double * cutsLowerBoundInclusive
+            ct.c_void_p,
+            # int64_t * binIndexesOut
+            ct.c_void_p,
+            # int64_t * countCacheHitsOut
+            ct.POINTER(ct.c_int64),
+        ]
+        self._unsafe.DiscretizeCached.restype = ct.c_int32
+
         self._unsafe.MeasureDataSetHeader.argtypes = [
             # int64_t countFeatures
             ct.c_int64,
@@ -1415,6 +1834,66 @@ class Native:
         ]
         self._unsafe.ExtractTargetClasses.restype = ct.c_int32
 
+        self._unsafe.ScoreDataSet.argtypes = [
+            # void * dataSet
+            ct.c_void_p,
+            # int8_t * bag
+            ct.c_void_p,
+            # int64_t countTerms
+            ct.c_int64,
+            # int64_t * dimensionCounts
+            ct.c_void_p,
+            # int64_t * featureIndexes
+            ct.c_void_p,
+            # int64_t countScores
+            ct.c_int64,
+            # double * termScores
+            ct.c_void_p,
+            # double * scoresOut
+            ct.c_void_p,
+        ]
+        self._unsafe.ScoreDataSet.restype = ct.c_int32
+
+        self._unsafe.ExtractTermBinWeights.argtypes = [
+            # void * dataSet
+            ct.c_void_p,
+            # double * weights
+            ct.c_void_p,
+            # int64_t countTerms
+            ct.c_int64,
+            # int64_t * dimensionCounts
+            ct.c_void_p,
+            # int64_t * featureIndexes
+            ct.c_void_p,
+            # double * binWeightsOut
+            ct.c_void_p,
+        ]
+        self._unsafe.ExtractTermBinWeights.restype = ct.c_int32
+
+        self._unsafe.MeasureDataSetSubset.argtypes = [
+            # void * dataSet
+            ct.c_void_p,
+            # int64_t countFeatures
+            ct.c_int64,
+            # int64_t * featureIndexes
+            ct.c_void_p,
+        ]
+        self._unsafe.MeasureDataSetSubset.restype = ct.c_int64
+
+        self._unsafe.FillDataSetSubset.argtypes = [
+            # void * dataSet
+            ct.c_void_p,
+            # int64_t countFeatures
+            ct.c_int64,
+            # int64_t * featureIndexes
+            ct.c_void_p,
+            # int64_t countBytesAllocated
+            ct.c_int64,
+            # void * fillMem
+            ct.c_void_p,
+        ]
+        self._unsafe.FillDataSetSubset.restype = ct.c_int32
+
         self._unsafe.SampleWithoutReplacement.argtypes = [
             # void * rng
             ct.c_void_p,
@@ -1443,6 +1922,48 @@ class Native:
         ]
         self._unsafe.SampleWithoutReplacementStratified.restype = ct.c_int32
 
+        self._unsafe.MeasureBagPlan.argtypes = [
+            # int64_t countBags
+            ct.c_int64,
+            # int64_t countSamples
+            ct.c_int64,
+        ]
+        self._unsafe.MeasureBagPlan.restype = ct.c_int64
+
+        self._unsafe.GenerateBagPlan.argtypes = [
+            # void * rngs
+            ct.c_void_p,
+            # int64_t countBags
+            ct.c_int64,
+            # int64_t countTrainingSamples
+            ct.c_int64,
+            # int64_t countValidationSamples
+            ct.c_int64,
+            # int64_t countClasses
+            ct.c_int64,
+            # int64_t * targets
+            ct.c_void_p,
+            # int64_t countGroups
+            ct.c_int64,
+            # int64_t * groups
+            ct.c_void_p,
+            # int64_t countBytesAllocated
+            ct.c_int64,
+            # void * bagPlanOut
+            ct.c_void_p,
+        ]
+        self._unsafe.GenerateBagPlan.restype = ct.c_int32
+
+        self._unsafe.ExtractBag.argtypes = [
+            # void * bagPlan
+            ct.c_void_p,
+            # int64_t indexBag
+            ct.c_int64,
+            # int8_t * bagOut
+            ct.c_void_p,
+        ]
+        self._unsafe.ExtractBag.restype = ct.c_int32
+
         self._unsafe.DetermineTask.argtypes = [
             # char * objective
             ct.c_char_p,
@@ -1479,6 +2000,28 @@ class Native:
         ]
         self._unsafe.GetLinkFunctionStr.restype = ct.c_char_p
 
+        self._unsafe.GetLinkFunctionInt.argtypes = [
+            # char * link
+            ct.c_char_p,
+        ]
+        self._unsafe.GetLinkFunctionInt.restype = ct.c_int32
+
+        self._unsafe.InverseLink.argtypes = [
+            # int32_t acceleration
+            ct.c_int32,
+            # int32_t link
+            ct.c_int32,
+            # double linkParam
+            ct.c_double,
+            # int64_t countSamples
+            ct.c_int64,
+            # int64_t countScores
+            ct.c_int64,
+            # double * scoresInOut
+            ct.c_void_p,
+        ]
+        self._unsafe.InverseLink.restype = ct.c_int32
+
         self._unsafe.CreateBooster.argtypes = [
             # void * rng
             ct.c_void_p,
@@ -1511,6 +2054,40 @@ class Native:
         ]
         self._unsafe.CreateBooster.restype = ct.c_int32
 
+        self._unsafe.CreateBoosterFromBagPlan.argtypes = [
+            # void * rng
+            ct.c_void_p,
+            # void * dataSet
+            ct.c_void_p,
+            # double * intercept
+            ct.c_void_p,
+            # void * bagPlan
+            ct.c_void_p,
+            # int64_t indexBag
+            ct.c_int64,
+            # double * initScores
+            ct.c_void_p,
+            # int64_t countTerms
+            ct.c_int64,
+            # int64_t * dimensionCounts
+            ct.c_void_p,
+            # int64_t * featureIndexes
+            ct.c_void_p,
+            # int64_t countInnerBags
+            ct.c_int64,
+            # CreateBoosterFlags flags
+            ct.c_int32,
+            # AccelerationFlags acceleration
+            ct.c_int32,
+            # char * objective
+            ct.c_char_p,
+            # double * experimentalParams
+            ct.c_void_p,
+            # BoosterHandle * boosterHandleOut
+            ct.POINTER(ct.c_void_p),
+        ]
+        self._unsafe.CreateBoosterFromBagPlan.restype = ct.c_int32
+
         self._unsafe.FreeBooster.argtypes = [
             # void * boosterHandle
             ct.c_void_p
@@ -1546,6 +2123,8 @@ class Native:
             ct.c_int64,
             # double categoricalInclusionPercent
             ct.c_double,
+            # int64_t randomRetries
+            ct.c_int64,
             # int64_t * leavesMax
             ct.c_void_p,
             # MonotoneDirection * direction
@@ -1613,6 +2192,36 @@ class Native:
         ]
         self._unsafe.GetCurrentTermScores.restype = ct.c_int32
 
+        self._unsafe.MeasureSerializedBooster.argtypes = [
+            # void * boosterHandle
+            ct.c_void_p,
+        ]
+        self._unsafe.MeasureSerializedBooster.restype = ct.c_int64
+
+        self._unsafe.SerializeBooster.argtypes = [
+            # void * boosterHandle
+            ct.c_void_p,
+            # void * rng
+            ct.c_void_p,
+            # int64_t countBytesAllocated
+            ct.c_int64,
+            # void * stateOut
+            ct.c_void_p,
+        ]
+        self._unsafe.SerializeBooster.restype = ct.c_int32
+
+        self._unsafe.DeserializeBooster.argtypes = [
+            # void * boosterHandle
+            ct.c_void_p,
+            # int64_t countBytes
+            ct.c_int64,
+            # void * state
+            ct.c_void_p,
+            # void * rngOut
+            ct.c_void_p,
+        ]
+        self._unsafe.DeserializeBooster.restype = ct.c_int32
+
         self._unsafe.CreateInteractionDetector.argtypes = [
             # void * dataSet
             ct.c_void_p,
@@ -1635,6 +2244,30 @@ class Native:
         ]
         self._unsafe.CreateInteractionDetector.restype = ct.c_int32
 
+        self._unsafe.CreateInteractionDetectorFromBagPlan.argtypes = [
+            # void * dataSet
+            ct.c_void_p,
+            # double * intercept
+            ct.c_void_p,
+            # void * bagPlan
+            ct.c_void_p,
+            # int64_t indexBag
+            ct.c_int64,
+            # double * initScores
+            ct.c_void_p,
+            # CreateInteractionFlags flags
+            ct.c_int32,
+            # AccelerationFlags acceleration
+            ct.c_int32,
+            # char * objective
+            ct.c_char_p,
+            # double * experimentalParams
+            ct.c_void_p,
+            # InteractionHandle * interactionHandleOut
+            ct.POINTER(ct.c_void_p),
+        ]
+        self._unsafe.CreateInteractionDetectorFromBagPlan.restype = ct.c_int32
+
         self._unsafe.FreeInteractionDetector.argtypes = [
             # void * interactionHandle
             ct.c_void_p
@@ -1667,6 +2300,54 @@ class Native:
         ]
         self._unsafe.CalcInteractionStrength.restype = ct.c_int32
 
+        self._unsafe.CalcInteractionStrengths.argtypes = [
+            # void * interactionHandle
+            ct.c_void_p,
+            # int64_t countTerms
+            ct.c_int64,
+            # int64_t * dimensionCounts
+            ct.c_void_p,
+            # int64_t * featureIndexes
+            ct.c_void_p,
+            # CalcInteractionFlags flags
+            ct.c_int32,
+            # int64_t maxCardinality
+            ct.c_int64,
+            # int64_t minSamplesLeaf
+            ct.c_int64,
+            # double minHessian
+            ct.c_double,
+            # double regAlpha
+            ct.c_double,
+            # double regLambda
+            ct.c_double,
+            # double maxDeltaStep
+            ct.c_double,
+            # int64_t countThreads
+            ct.c_int64,
+            # double * avgInteractionStrengthsOut
+            ct.c_void_p,
+        ]
+        self._unsafe.CalcInteractionStrengths.restype = ct.c_int32
+
+
+class BagPlanRow:
+    """One bag of a plan made by generate_bag_plan.
+
+    Booster and InteractionDetector accept this in place of an int8 bag, and the
+    native layer reads the bag directly from the plan, so the bag is never
+    unpacked in python unless unpack is called.
+    """
+
+    def __init__(self, plan, index):
+        self.plan = plan
+        self.index = index
+
+    def unpack(self, n_samples):
+        return Native.get_native_singleton().extract_bag(
+            self.plan, self.index, n_samples
+        )
+
 
 class Booster(AbstractContextManager):
     """Lightweight wrapper for EBM C boosting code."""
@@ -1690,7 +2371,8 @@ class Booster(AbstractContextManager):
         Args:
             dataset: binned data in a compressed native form
             intercept: initial intercept
-            bag: definition of what data is included. 1 = training, -1 = validation, 0 = not included
+            bag: definition of what data is included. 1 = training, -1 = validation, 0 = not included.
+                Either an int8 array, a BagPlanRow, or None to include every sample for training
             init_scores: predictions from a prior predictor
                 that this class will boost on top of.  For regression
                 there is 1 score per sample.  For binary classification
@@ -1763,7 +2445,11 @@ class Booster(AbstractContextManager):
             self._term_shapes.append(tuple(dimensions))
 
         n_bagged_samples = n_samples
-        if self.bag is not None:
+        if isinstance(self.bag, BagPlanRow):
+            # the native layer checks the plan against the dataset, and counting the
+            # bagged samples here would require unpacking the bag
+            n_bagged_samples = None
+        elif self.bag is not None:
             if self.bag.shape[0] != n_samples:  # pragma: no cover
                 msg = "bag should be len(n_samples)"
                 raise ValueError(msg)
@@ -1775,7 +2461,10 @@ class Booster(AbstractContextManager):
                 # init_scores could be a slice that has a stride.  We need contiguous for caling into C
                 init_scores = init_scores.copy()
 
-            if init_scores.shape[0] != n_bagged_samples:  # pragma: no cover
+            if (
+                n_bagged_samples is not None
+                and init_scores.shape[0] != n_bagged_samples
+            ):  # pragma: no cover
                 msg = "init_scores should have the same length as the number of non-zero bag entries"
                 raise ValueError(msg)
 
@@ -1805,30 +2494,62 @@ class Booster(AbstractContextManager):
         if native.approximates:
             flags |= Native.CreateBoosterFlags_UseApprox
 
+        from .. import develop
+
+        if develop.get_option("pack_by_feature"):
+            flags |= Native.CreateBoosterFlags_PackByFeature
+
         # Allocate external resources
         booster_handle = ct.c_void_p(0)
-        return_code = native._unsafe.CreateBooster(
-            Native._make_pointer(self.rng, np.ubyte, is_null_allowed=True),
-            Native._make_pointer(self.dataset, np.ubyte),
-            Native._make_pointer(intercept, np.float64, 1, True),
-            Native._make_pointer(self.bag, np.int8, is_null_allowed=True),
-            Native._make_pointer(
-                init_scores, np.float64, 1 if n_class_scores == 1 else 2, True
-            ),
-            len(dimension_counts),
-            Native._make_pointer(dimension_counts, np.int64),
-            Native._make_pointer(feature_indexes, np.int64),
-            self.n_inner_bags,
-            flags,
-            self.acceleration,
-            self.objective.encode("ascii"),
-            Native._make_pointer(
-                self.experimental_params, np.float64, is_null_allowed=True
-            ),
-            ct.byref(booster_handle),
-        )
-        if return_code:  # pragma: no cover
-            raise Native._get_native_exception(return_code, "CreateBooster")
+        if isinstance(self.bag, BagPlanRow):
+            return_code = native._unsafe.CreateBoosterFromBagPlan(
+                Native._make_pointer(self.rng, np.ubyte, is_null_allowed=True),
+                Native._make_pointer(self.dataset, np.ubyte),
+                Native._make_pointer(intercept, np.float64, 1, True),
+                Native._make_pointer(self.bag.plan, np.ubyte),
+                self.bag.index,
+                Native._make_pointer(
+                    init_scores, np.float64, 1 if n_class_scores == 1 else 2, True
+                ),
+                len(dimension_counts),
+                Native._make_pointer(dimension_counts, np.int64),
+                Native._make_pointer(feature_indexes, np.int64),
+                self.n_inner_bags,
+                flags,
+                self.acceleration,
+                self.objective.encode("ascii"),
+                Native._make_pointer(
+                    self.experimental_params, np.float64, is_null_allowed=True
+                ),
+                ct.byref(booster_handle),
+            )
+            if return_code:  # pragma: no cover
+                raise Native._get_native_exception(
+                    return_code, "CreateBoosterFromBagPlan"
+                )
+        else:
+            return_code = native._unsafe.CreateBooster(
+                Native._make_pointer(self.rng, np.ubyte, is_null_allowed=True),
+                Native._make_pointer(self.dataset, np.ubyte),
+                Native._make_pointer(intercept, np.float64, 1, True),
+                Native._make_pointer(self.bag, np.int8, is_null_allowed=True),
+                Native._make_pointer(
+                    init_scores, np.float64, 1 if n_class_scores == 1 else 2, True
+                ),
+                len(dimension_counts),
+                Native._make_pointer(dimension_counts, np.int64),
+                Native._make_pointer(feature_indexes, np.int64),
+                self.n_inner_bags,
+                flags,
+                self.acceleration,
+                self.objective.encode("ascii"),
+                Native._make_pointer(
+                    self.experimental_params, np.float64, is_null_allowed=True
+                ),
+                ct.byref(booster_handle),
+            )
+            if return_code:  # pragma: no cover
+                raise Native._get_native_exception(return_code, "CreateBooster")
 
         self._booster_handle = booster_handle.value
 
@@ -1865,6 +2586,7 @@ class Booster(AbstractContextManager):
         cat_smooth,
         max_cat_threshold,
         cat_include,
+        random_retries,
         max_leaves,
         monotone_constraints,
     ):
@@ -1884,6 +2606,7 @@ class Booster(AbstractContextManager):
             cat_smooth: Parameter used to determine which categories are included each boosting round and ordering.
             max_cat_threshold: max number of categories to include each boosting round
             cat_include: percentage of categories to include in each boosting round
+            random_retries: random cut sets to score with TermBoostFlags_RandomSplits.
             max_leaves: Max leaf nodes on feature step.
             monotone_constraints: monotone constraints (1=increasing, 0=none, -1=decreasing)
 
@@ -1932,6 +2655,7 @@ class Booster(AbstractContextManager):
             cat_smooth,
             max_cat_threshold,
             cat_include,
+            random_retries,
             Native._make_pointer(max_leaves_arr, np.int64, is_null_allowed=True),
             Native._make_pointer(monotone_constraints, np.int32, is_null_allowed=True),
             ct.byref(avg_gain),
@@ -2056,6 +2780,57 @@ class Booster(AbstractContextManager):
 
         return term_scores
 
+    def serialize(self, rng):
+        """Saves the boosting progress so that a Booster created
+            with the same arguments can resume from it. This holds only the
+            native state. The boost function saves it together with its own
+            early stopping and term ordering state in each checkpoint.
+
+        Args:
+            rng: The random number generator to save, or None.
+
+        Returns:
+            bytes that hold the state.
+        """
+
+        native = Native.get_native_singleton()
+
+        n_bytes = native._unsafe.MeasureSerializedBooster(self._booster_handle)
+        if n_bytes < 0:  # pragma: no cover
+            raise Native._get_native_exception(n_bytes, "MeasureSerializedBooster")
+
+        state = np.empty(n_bytes, np.ubyte)
+        return_code = native._unsafe.SerializeBooster(
+            self._booster_handle,
+            Native._make_pointer(rng, np.ubyte, is_null_allowed=True),
+            n_bytes,
+            Native._make_pointer(state, np.ubyte),
+        )
+        if return_code:  # pragma: no cover
+            raise Native._get_native_exception(return_code, "SerializeBooster")
+
+        return state.tobytes()
+
+    def deserialize(self, state, rng):
+        """Resumes boosting from the bytes returned by serialize.
+
+        Args:
+            state: bytes from serialize.
+            rng: The random number generator to restore, or None.
+        """
+
+        native = Native.get_native_singleton()
+
+        state = np.frombuffer(state, np.ubyte)
+        return_code = native._unsafe.DeserializeBooster(
+            self._booster_handle,
+            len(state),
+            Native._make_pointer(state, np.ubyte),
+            Native._make_pointer(rng, np.ubyte, is_null_allowed=True),
+        )
+        if return_code:  # pragma: no cover
+            raise Native._get_native_exception(return_code, "DeserializeBooster")
+
     def _get_term_update_splits_dimension(self, dimension_index):
         native = Native.get_native_singleton()
 
@@ -2139,7 +2914,8 @@ class InteractionDetector(AbstractContextManager):
         Args:
             dataset: binned data in a compressed native form
             intercept: prediction shift
-            bag: definition of what data is included. 1 = training, -1 = validation, 0 = not included
+            bag: definition of what data is included. 1 = training, -1 = validation, 0 = not included.
+                Either an int8 array, a BagPlanRow, or None to include every sample for training
             init_scores: predictions from a prior predictor
                 that this class will boost on top of.  For regression
                 there is 1 score per sample.  For binary classification
@@ -2185,7 +2961,11 @@ class InteractionDetector(AbstractContextManager):
         )
 
         n_bagged_samples = n_samples
-        if self.bag is not None:
+        if isinstance(self.bag, BagPlanRow):
+            # the native layer checks the plan against the dataset, and counting the
+            # bagged samples here would require unpacking the bag
+            n_bagged_samples = None
+        elif self.bag is not None:
             if self.bag.shape[0] != n_samples:  # pragma: no cover
                 msg = "bag should be len(n_samples)"
                 raise ValueError(msg)
@@ -2197,7 +2977,10 @@ class InteractionDetector(AbstractContextManager):
                 # init_scores could be a slice that has a stride.  We need contiguous for caling into C
                 init_scores = init_scores.copy()
 
-            if init_scores.shape[0] != n_bagged_samples:  # pragma: no cover
+            if (
+                n_bagged_samples is not None
+                and init_scores.shape[0] != n_bagged_samples
+            ):  # pragma: no cover
                 msg = "init_scores should have the same length as the number of non-zero bag entries"
                 raise ValueError(msg)
 
@@ -2230,21 +3013,43 @@ class InteractionDetector(AbstractContextManager):
         # Allocate external resources
         interaction_handle = ct.c_void_p(0)
 
-        return_code = native._unsafe.CreateInteractionDetector(
-            Native._make_pointer(self.dataset, np.ubyte),
-            Native._make_pointer(intercept, np.float64, 1, True),
-            Native._make_pointer(self.bag, np.int8, 1, True),
-            Native._make_pointer(
-                init_scores, np.float64, 1 if n_class_scores == 1 else 2, True
-            ),
-            flags,
-            self.acceleration,
-            self.objective.encode("ascii"),
-            Native._make_pointer(self.experimental_params, np.float64, 1, True),
-            ct.byref(interaction_handle),
-        )
-        if return_code:  # pragma: no cover
-            raise Native._get_native_exception(return_code, "CreateInteractionDetector")
+        if isinstance(self.bag, BagPlanRow):
+            return_code = native._unsafe.CreateInteractionDetectorFromBagPlan(
+                Native._make_pointer(self.dataset, np.ubyte),
+                Native._make_pointer(intercept, np.float64, 1, True),
+                Native._make_pointer(self.bag.plan, np.ubyte),
+                self.bag.index,
+                Native._make_pointer(
+                    init_scores, np.float64, 1 if n_class_scores == 1 else 2, True
+                ),
+                flags,
+                self.acceleration,
+                self.objective.encode("ascii"),
+                Native._make_pointer(self.experimental_params, np.float64, 1, True),
+                ct.byref(interaction_handle),
+            )
+            if return_code:  # pragma: no cover
+                raise Native._get_native_exception(
+                    return_code, "CreateInteractionDetectorFromBagPlan"
+                )
+        else:
+            return_code = native._unsafe.CreateInteractionDetector(
+                Native._make_pointer(self.dataset, np.ubyte),
+                Native._make_pointer(intercept, np.float64, 1, True),
+                Native._make_pointer(self.bag, np.int8, 1, True),
+                Native._make_pointer(
+                    init_scores, np.float64, 1 if n_class_scores == 1 else 2, True
+                ),
+                flags,
+                self.acceleration,
+                self.objective.encode("ascii"),
+                Native._make_pointer(self.experimental_params, np.float64, 1, True),
+                ct.byref(interaction_handle),
+            )
+            if return_code:  # pragma: no cover
+                raise Native._get_native_exception(
+                    return_code, "CreateInteractionDetector"
+                )
 
         self._interaction_handle = interaction_handle.value
 
@@ -2303,3 +3108,54 @@ class InteractionDetector(AbstractContextManager):
 
         _log.info("Fast interaction strength end")
         return strength.value
+
+    def calc_interaction_strengths(
+        self,
+        terms,
+        calc_interaction_flags,
+        max_cardinality,
+        min_samples_leaf,
+        min_hessian,
+        reg_alpha,
+        reg_lambda,
+        max_delta_step,
+        n_threads=0,
+    ):
+        """Measures the strengths of many feature interactions in one native call.
+
+        The terms are pulled from a native work queue by n_threads threads that share
+        this detector's data, so slow terms do not hold up the rest. 0 means one thread
+        per core. The strengths are returned in the same order as terms.
+        """
+        _log.info("Fast interaction strengths start")
+
+        native = Native.get_native_singleton()
+
+        dimension_counts = np.array(
+            [len(feature_idxs) for feature_idxs in terms], np.int64
+        )
+        feature_idxs = np.array(
+            [i for feature_idxs in terms for i in feature_idxs], np.int64
+        )
+        strengths = np.empty(len(terms), np.float64)
+
+        return_code = native._unsafe.CalcInteractionStrengths(
+            self._interaction_handle,
+            len(terms),
+            Native._make_pointer(dimension_counts, np.int64),
+            Native._make_pointer(feature_idxs, np.int64, 1, True),
+            calc_interaction_flags,
+            max_cardinality,
+            min_samples_leaf,
+            min_hessian,
+            reg_alpha,
+            reg_lambda,
+            max_delta_step,
+            n_threads,
+            Native._make_pointer(strengths, np.float64),
+        )
+        if return_code:  # pragma: no cover
+            raise Native._get_native_exception(return_code, "CalcInteractionStrengths")
+
+        _log.info("Fast interaction strengths end")
+        return strengths
@@ -50,23 +50,28 @@ def rank_interactions(
             acceleration,
             experimental_params,
         ) as interaction_detector:
-            for feature_idxs in iter_term_features:
-                if tuple(sorted(feature_idxs)) in exclude:
-                    continue
-                if any(i in exclude_features for i in feature_idxs):
-                    continue
+            terms = [
+                feature_idxs
+                for feature_idxs in iter_term_features
+                if tuple(sorted(feature_idxs)) not in exclude
+                and not any(i in exclude_features for i in feature_idxs)
+            ]
 
-                strength = interaction_detector.calc_interaction_strength(
-                    feature_idxs,
-                    calc_interaction_flags,
-                    max_cardinality,
-                    min_samples_leaf,
-                    min_hessian,
-                    reg_alpha,
-                    reg_lambda,
-                    max_delta_step,
-                )
-                item = (strength, feature_idxs)
+            # all terms go to the native work queue in one call so that threads can balance slow terms dynamically
+            strengths = interaction_detector.calc_interaction_strengths(
+                terms,
+                calc_interaction_flags,
+                max_cardinality,
+                min_samples_leaf,
+                min_hessian,
+                reg_alpha,
+                reg_lambda,
+                max_delta_step,
+                develop.get_option("interaction_threads"),
+            )
+
+            for strength, feature_idxs in zip(strengths, terms):
+                item = (float(strength), feature_idxs)
                 if n_output_interactions <= 0:
                     interaction_strengths.append(item)
                 elif len(interaction_strengths) == n_output_interactions:
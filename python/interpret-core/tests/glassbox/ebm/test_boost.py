@@ -0,0 +1,115 @@
+# Copyright (c) 2023 The InterpretML Contributors
+# Distributed under the MIT software license
+
+import pickle
+
+import numpy as np
+from interpret import develop
+from interpret.glassbox._ebm._boost import boost
+from interpret.utils._clean_x import preclean_X
+from interpret.utils._compressed_dataset import bin_native_by_dimension
+from interpret.utils._native import Native
+from interpret.utils._preprocessor import construct_bins
+
+
+def _make_dataset():
+    rng = np.random.default_rng(0)
+    n_samples = 300
+    X = np.empty((n_samples, 3), dtype=np.object_)
+    X[:, 0] = rng.normal(size=n_samples)
+    X[:, 1] = rng.choice(["a", "b", "c", "d"], size=n_samples)
+    X[:, 2] = rng.integers(0, 20, size=n_samples).astype(np.float64)
+    feature_types_given = ["continuous", "nominal", "continuous"]
+    y = (X[:, 0].astype(np.float64) + rng.normal(size=n_samples) > 0).astype(np.int64)
+
+    X, n_samples = preclean_X(X, None, feature_types_given)
+    feature_names_in, feature_types_in, bins, *_ = construct_bins(
+        X, y, None, None, feature_types_given, [32, 8]
+    )
+    dataset = bin_native_by_dimension(
+        2, 1, bins, X, y, None, feature_names_in, feature_types_in
+    )
+
+    # every fifth sample is held out so that early stopping has a metric to track
+    bag = np.ones(n_samples, np.int8)
+    bag[::5] = -1
+    return dataset, bag
+
+
+def _boost(dataset, bag, rng, **kwargs):
+    return boost(
+        dataset,
+        0,
+        0.0,
+        np.zeros(1, np.float64),
+        bag,
+        None,
+        [(0,), (1,), (2,), (0, 2)],
+        0,
+        Native.TermBoostFlags_Default,
+        0.05,
+        2,
+        1e-4,
+        0.0,
+        0.0,
+        0.0,
+        1.0,
+        10,
+        10.0,
+        "gain",
+        3,
+        None,
+        1.5,
+        0.5,
+        2,
+        False,
+        40,
+        5,
+        0.0,
+        None,
+        None,
+        rng,
+        Native.CreateBoosterFlags_Default,
+        "log_loss",
+        Native.AccelerationFlags_NONE,
+        None,
+        develop._develop_options,
+        **kwargs,
+    )
+
+
+def test_boost_resume_from_checkpoint():
+    native = Native.get_native_singleton()
+    dataset, bag = _make_dataset()
+
+    expected = _boost(dataset, bag, native.create_rng(7))
+    assert expected[0] is None
+
+    # pickling stands in for writing the checkpoint to disk before a preemption
+    checkpoints = []
+    interrupted = _boost(
+        dataset,
+        bag,
+        native.create_rng(7),
+        checkpoint_steps=3,
+        checkpoint_callback=lambda state: checkpoints.append(pickle.dumps(state)),
+    )
+    assert interrupted[0] is None
+    assert len(checkpoints) >= 2
+
+    # resume from a checkpoint taken during the smoothing rounds, and from the last
+    # one, which carries the greedy heap and the early stopping window
+    for saved in [checkpoints[0], checkpoints[-1]]:
+        resumed = _boost(
+            dataset,
+            bag,
+            native.create_rng(7),
+            checkpoint=pickle.loads(saved),
+        )
+        assert resumed[0] is None
+        assert np.array_equal(resumed[1], expected[1])
+        assert len(resumed[2]) == len(expected[2])
+        for scores, expected_scores in zip(resumed[2], expected[2]):
+            assert np.array_equal(scores, expected_scores)
+        assert resumed[3] == expected[3]
+        assert np.array_equal(resumed[4], expected[4])
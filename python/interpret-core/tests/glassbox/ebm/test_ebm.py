@@ -174,6 +174,11 @@ def test_monotonize():
     assert np.all(diff >= 0) or np.all(diff <= 0)
     assert intercept == clf.intercept_
 
+    # every bag is monotonized, so the error bars survive
+    assert clf.standard_deviations_[0] is not None
+    assert np.all(np.diff(clf.bagged_scores_[0][:, 1:-1], axis=1) >= -1e-9)
+    assert np.all(np.diff(clf.bagged_scores_[1][:, 1:-1], axis=1) <= 1e-9)
+
 
 def test_ebm_remove_features():
     data = synthetic_regression()
@@ -5,9 +5,17 @@ from itertools import chain, count, repeat
 
 import numpy as np
 import pytest
+from interpret.glassbox._ebm._bin import make_bin_weights, make_bin_weights_binned
 from interpret.utils._clean_simple import clean_dimensions, typify_classification
 from interpret.utils._clean_x import preclean_X
-from interpret.utils._compressed_dataset import bin_native, bin_native_by_dimension
+from interpret.utils._compressed_dataset import (
+    bin_native,
+    bin_native_by_dimension,
+    bin_native_levels,
+    is_dataset_binning,
+    map_term_features,
+    select_native_level,
+)
 from interpret.utils._preprocessor import construct_bins
 
 
@@ -95,3 +103,66 @@ def test_bin_native():
         n_classes, 1, bins, X, y, sample_weight, feature_names_in, feature_types_in
     )
     assert shared_dataset is not None
+
+
+def test_bin_native_levels():
+    rng = np.random.default_rng(0)
+    n_samples = 200
+    X = np.empty((n_samples, 3), dtype=np.object_)
+    X[:, 0] = rng.normal(size=n_samples)
+    X[:, 1] = rng.choice(["a", "b", "c", "d"], size=n_samples)
+    X[:, 2] = rng.integers(0, 50, size=n_samples).astype(np.float64)
+    feature_types_given = ["continuous", "nominal", "continuous"]
+    y = rng.integers(0, 2, size=n_samples).astype(np.int64)
+    sample_weight = rng.uniform(0.5, 2.0, size=n_samples)
+
+    X, n_samples = preclean_X(X, None, feature_types_given)
+
+    feature_names_in, feature_types_in, bins, *_ = construct_bins(
+        X, y, sample_weight, None, feature_types_given, [32, 8]
+    )
+
+    dataset_cache, level_columns = bin_native_levels(
+        2, bins, X, y, sample_weight, feature_names_in, feature_types_in
+    )
+
+    # each level copied out of the cache matches binning X again at that level
+    for n_dimensions in [1, 2, 3]:
+        dataset = select_native_level(dataset_cache, level_columns, n_dimensions)
+        expected = bin_native_by_dimension(
+            2,
+            n_dimensions,
+            bins,
+            X,
+            y,
+            sample_weight,
+            feature_names_in,
+            feature_types_in,
+        )
+        assert np.array_equal(dataset, expected)
+
+    # the nominal feature has the same bins at both levels, so it shares a column
+    assert level_columns[0][1] == level_columns[1][1]
+
+    term_features = [(0,), (1,), (2,), (0, 1), (2, 0)]
+    bin_weights = make_bin_weights_binned(
+        dataset_cache, sample_weight, map_term_features(level_columns, term_features)
+    )
+    expected_weights = make_bin_weights(
+        X,
+        n_samples,
+        sample_weight,
+        feature_names_in,
+        feature_types_in,
+        bins,
+        term_features,
+    )
+    for weights, expected in zip(bin_weights, expected_weights):
+        assert np.allclose(weights, expected)
+
+    # every feature has two levels, so mains only match the first level and pairs
+    # only match the second
+    assert is_dataset_binning(bins, 1, [(0,), (1,), (2,)])
+    assert not is_dataset_binning(bins, 2, [(0,), (1,), (2,)])
+    assert is_dataset_binning(bins, 2, [(0, 1), (2, 0)])
+    assert not is_dataset_binning(bins, 1, term_features)
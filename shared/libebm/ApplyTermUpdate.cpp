@@ -19,6 +19,7 @@
 #include "Tensor.hpp"
 #include "BoosterCore.hpp"
 #include "BoosterShell.hpp"
+#include "api_recording.hpp"
 
 namespace DEFINED_ZONE_NAME {
 #ifndef DEFINED_ZONE_NAME
@@ -56,6 +57,10 @@ EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION ApplyTermUpdate(
       return Error_IllegalParamVal;
    }
 
+   if(IsRecording()) {
+      RecordApplyTermUpdate(boosterHandle);
+   }
+
    const size_t iTerm = pBoosterShell->GetTermIndex();
    if(BoosterShell::k_illegalTermIndex == iTerm) {
       LOG_0(Trace_Error, "ERROR ApplyTermUpdate bad internal state.  No Term index set");
@@ -169,6 +174,7 @@ EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION ApplyTermUpdate(
          DataSubsetBoosting* pSubset = pBoosterCore->GetTrainingSet()->GetSubsets();
          EBM_ASSERT(nullptr != pSubset);
          const DataSubsetBoosting* const pSubsetsEnd = pSubset + pBoosterCore->GetTrainingSet()->GetCountSubsets();
+         size_t iSubset = 0;
          do {
             if(pSubset->GetObjectiveWrapper()->m_cFloatBytes != cFloatSize) {
                bIgnored = true;
@@ -178,7 +184,7 @@ EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION ApplyTermUpdate(
                data.m_cPack = k_cItemsPerBitPackUndefined;
                data.m_aPacked = nullptr;
                if(BoosterShell::k_interceptTermIndex != iTerm) {
-                  data.m_aPacked = pSubset->GetTermData(iTerm);
+                  data.m_aPacked = pSubset->GetTermData(iTerm, pTerm, pBoosterShell->GetTermDataScratch(iSubset));
                   if(0 != pTerm->GetBitsRequiredMin()) {
                      data.m_cPack = GetCountItemsBitPacked(
                            pTerm->GetBitsRequiredMin(), pSubset->GetObjectiveWrapper()->m_cUIntBytes);
@@ -203,6 +209,7 @@ EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION ApplyTermUpdate(
                }
             }
             ++pSubset;
+            ++iSubset;
          } while(pSubsetsEnd != pSubset);
       }
 
@@ -212,6 +219,10 @@ EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION ApplyTermUpdate(
          DataSubsetBoosting* pSubset = pBoosterCore->GetValidationSet()->GetSubsets();
          EBM_ASSERT(nullptr != pSubset);
          const DataSubsetBoosting* const pSubsetsEnd = pSubset + pBoosterCore->GetValidationSet()->GetCountSubsets();
+         // the shell's scratch for the validation subsets comes after the training subsets
+         size_t iSubset = 0 != pBoosterCore->GetTrainingSet()->GetCountSamples() ?
+               pBoosterCore->GetTrainingSet()->GetCountSubsets() :
+               0;
          do {
             if(pSubset->GetObjectiveWrapper()->m_cFloatBytes != cFloatSize) {
                bIgnored = true;
@@ -234,7 +245,7 @@ EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION ApplyTermUpdate(
                data.m_cPack = k_cItemsPerBitPackUndefined;
                data.m_aPacked = nullptr;
                if(BoosterShell::k_interceptTermIndex != iTerm) {
-                  data.m_aPacked = pSubset->GetTermData(iTerm);
+                  data.m_aPacked = pSubset->GetTermData(iTerm, pTerm, pBoosterShell->GetTermDataScratch(iSubset));
                   if(0 != pTerm->GetBitsRequiredMin()) {
                      data.m_cPack = GetCountItemsBitPacked(
                            pTerm->GetBitsRequiredMin(), pSubset->GetObjectiveWrapper()->m_cUIntBytes);
@@ -262,6 +273,7 @@ EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION ApplyTermUpdate(
                validationMetricAvg += data.m_metricOut;
             }
             ++pSubset;
+            ++iSubset;
          } while(pSubsetsEnd != pSubset);
       }
       if(!bIgnored) {
@@ -604,6 +616,10 @@ EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION SetTermUpdate(
       return Error_IllegalParamVal;
    }
 
+   if(IsRecording()) {
+      RecordSetTermUpdate(pBoosterShell, indexTerm, updateScoresTensor);
+   }
+
    BoosterCore* const pBoosterCore = pBoosterShell->GetBoosterCore();
    EBM_ASSERT(nullptr != pBoosterCore);
 
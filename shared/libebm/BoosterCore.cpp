@@ -325,6 +325,7 @@ ErrorEbm BoosterCore::Create(void* const rng,
    *ppBoosterCoreOut = pBoosterCore;
 
    pBoosterCore->m_bUseApprox = CreateBoosterFlags_UseApprox & flags ? EBM_TRUE : EBM_FALSE;
+   pBoosterCore->m_bDifferentialPrivacy = CreateBoosterFlags_DifferentialPrivacy & flags ? EBM_TRUE : EBM_FALSE;
 
    UIntShared countSamples;
    size_t cFeatures;
@@ -664,6 +665,14 @@ ErrorEbm BoosterCore::Create(void* const rng,
 
          const bool bHessian = pBoosterCore->IsHessian();
 
+         // Packing by feature stores one column per feature instead of one per term, which bounds our memory by the
+         // number of features when there are many pairs, at the cost of composing each pair's tensor indexes when we
+         // boost it.
+         const FeatureBoosting* const aFeaturesPacked =
+               0 != (CreateBoosterFlags_PackByFeature & flags) && 0 != pBoosterCore->m_cFeatures ?
+               pBoosterCore->m_aFeatures :
+               nullptr;
+
          pBoosterCore->m_cInnerBags = cInnerBags; // this is used to destruct m_trainingSet, so store it first
          error = pBoosterCore->m_trainingSet.InitDataSetBoosting(true,
                bHessian,
@@ -686,7 +695,9 @@ ErrorEbm BoosterCore::Create(void* const rng,
                cWeights,
                cTerms,
                pBoosterCore->m_apTerms,
-               aiTermFeatures);
+               aiTermFeatures,
+               pBoosterCore->m_cFeatures,
+               aFeaturesPacked);
          if(Error_None != error) {
             return error;
          }
@@ -712,7 +723,9 @@ ErrorEbm BoosterCore::Create(void* const rng,
                cWeights,
                cTerms,
                pBoosterCore->m_apTerms,
-               aiTermFeatures);
+               aiTermFeatures,
+               pBoosterCore->m_cFeatures,
+               aFeaturesPacked);
          if(Error_None != error) {
             return error;
          }
@@ -830,18 +843,28 @@ ErrorEbm BoosterCore::Create(void* const rng,
          size_t cBytesMainBins = cBytesPerMainBin * cMainBinsMax;
 
          if(0 != cSingleDimensionBinsMax) {
-            if(IsAddError(cBytesPerMainBin, sizeof(void*))) {
-               LOG_0(Trace_Warning, "WARNING BoosterCore::Create IsAddError(cBytesPerMainBin, sizeof(void*))");
+            if(IsAddError(cBytesPerMainBin, sizeof(void*), sizeof(CategoricalSortKey))) {
+               LOG_0(Trace_Warning,
+                     "WARNING BoosterCore::Create IsAddError(cBytesPerMainBin, sizeof(void*), "
+                     "sizeof(CategoricalSortKey))");
                return Error_OutOfMemory;
             }
-            const size_t cBytesMainBinPlusPointer = cBytesPerMainBin + sizeof(void*);
+            // each single dimension bin also needs a pointer and a sort key for ordering nominal categories
+            const size_t cBytesMainBinPlusPointer = cBytesPerMainBin + sizeof(void*) + sizeof(CategoricalSortKey);
             if(IsMultiplyError(cBytesMainBinPlusPointer, cSingleDimensionBinsMax)) {
                LOG_0(Trace_Warning,
                      "WARNING BoosterCore::Create IsMultiplyError(cBytesMainBinPlusPointer, cSingleDimensionBinsMax)");
                return Error_OutOfMemory;
             }
-            // we also allocate enough space to create an additional array of pointers
-            cBytesMainBins = EbmMax(cBytesMainBins, cBytesMainBinPlusPointer * cSingleDimensionBinsMax);
+            // we also allocate enough space to create the additional arrays of pointers and sort keys, plus the
+            // padding that aligns the sort keys after the pointers
+            const size_t cBytesMainBinsAndKeys = cBytesMainBinPlusPointer * cSingleDimensionBinsMax;
+            if(IsAddError(cBytesMainBinsAndKeys, alignof(CategoricalSortKey))) {
+               LOG_0(Trace_Warning,
+                     "WARNING BoosterCore::Create IsAddError(cBytesMainBinsAndKeys, alignof(CategoricalSortKey))");
+               return Error_OutOfMemory;
+            }
+            cBytesMainBins = EbmMax(cBytesMainBins, cBytesMainBinsAndKeys + alignof(CategoricalSortKey) - size_t{1});
 
             if(IsOverflowTreeNodeSize(bHessian, cScores) || IsOverflowSplitPositionSize(bHessian, cScores)) {
                LOG_0(Trace_Warning, "WARNING BoosterCore::Create bin tracking size overflow");
@@ -38,6 +38,7 @@ class BoosterCore final {
 
    size_t m_cScores;
    BoolEbm m_bUseApprox;
+   BoolEbm m_bDifferentialPrivacy;
 
    size_t m_cFeatures;
    FeatureBoosting* m_aFeatures;
@@ -75,6 +76,7 @@ class BoosterCore final {
          m_REFERENCE_COUNT(1), // we're not visible on any other thread yet, so no synchronization required
          m_cScores(0),
          m_bUseApprox(EBM_FALSE),
+         m_bDifferentialPrivacy(EBM_FALSE),
          m_cFeatures(0),
          m_aFeatures(nullptr),
          m_cTerms(0),
@@ -171,6 +173,8 @@ class BoosterCore final {
 
    inline BoolEbm IsUseApprox() const { return m_bUseApprox; }
 
+   inline BoolEbm IsDifferentialPrivacy() const { return m_bDifferentialPrivacy; }
+
    inline double LearningRateAdjustmentDifferentialPrivacy() const noexcept {
       EBM_ASSERT(nullptr != m_objectiveCpu.m_pObjective);
       return m_objectiveCpu.m_learningRateAdjustmentDifferentialPrivacy;
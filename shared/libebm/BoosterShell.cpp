@@ -6,7 +6,7 @@
 
 #include <stdlib.h> // free
 #include <stddef.h> // size_t, ptrdiff_t
-#include <string.h> // memcpy
+#include <string.h> // memcpy, memset
 
 #define ZONE_main
 #include "zones.h"
@@ -20,6 +20,7 @@
 
 #include "BoosterCore.hpp" // BoosterCore
 #include "BoosterShell.hpp"
+#include "api_recording.hpp"
 
 namespace DEFINED_ZONE_NAME {
 #ifndef DEFINED_ZONE_NAME
@@ -35,6 +36,9 @@ extern void InitializeRmseGradientsAndHessiansBoosting(const unsigned char* cons
       const double* const aInitScores,
       DataSetBoosting* const pDataSet);
 
+extern ErrorEbm AllocateBagFromPlan(
+      const void* const dataSet, const void* const bagPlan, const IntEbm indexBag, BagEbm** const paBagOut);
+
 void BoosterShell::Free(BoosterShell* const pBoosterShell) {
    LOG_0(Trace_Info, "Entered BoosterShell::Free");
 
@@ -47,6 +51,13 @@ void BoosterShell::Free(BoosterShell* const pBoosterShell) {
       AlignedFree(pBoosterShell->m_aSplitPositionsTemp);
       AlignedFree(pBoosterShell->m_aTreeNodesTemp);
       AlignedFree(pBoosterShell->m_aTemp1);
+      TermDataScratch* const aTermDataScratch = pBoosterShell->m_aTermDataScratch;
+      if(nullptr != aTermDataScratch) {
+         for(size_t iSubset = 0; iSubset < pBoosterShell->m_cTermDataScratch; ++iSubset) {
+            AlignedFree(aTermDataScratch[iSubset].m_aData);
+         }
+         free(aTermDataScratch);
+      }
       BoosterCore::Free(pBoosterShell->m_pBoosterCore);
 
       // before we free our memory, indicate it was freed so if our higher level language attempts to use it we have
@@ -170,6 +181,51 @@ ErrorEbm BoosterShell::FillAllocations() {
          }
          m_cTreeNodesTempBytes = m_pBoosterCore->GetCountBytesTreeNodes();
       }
+
+      DataSetBoosting* const pTrainingSet = m_pBoosterCore->GetTrainingSet();
+      DataSetBoosting* const pValidationSet = m_pBoosterCore->GetValidationSet();
+      const size_t cTrainingSubsets = 0 != pTrainingSet->GetCountSamples() ? pTrainingSet->GetCountSubsets() : 0;
+      const size_t cValidationSubsets =
+            0 != pValidationSet->GetCountSamples() ? pValidationSet->GetCountSubsets() : 0;
+      const size_t cSubsets = cTrainingSubsets + cValidationSubsets;
+
+      bool bTermDataScratch = false;
+      for(size_t iSubset = 0; iSubset < cSubsets; ++iSubset) {
+         const DataSubsetBoosting* const pSubset = iSubset < cTrainingSubsets ?
+               &pTrainingSet->GetSubsets()[iSubset] :
+               &pValidationSet->GetSubsets()[iSubset - cTrainingSubsets];
+         if(0 != pSubset->GetCountBytesTermDataScratch()) {
+            bTermDataScratch = true;
+         }
+      }
+
+      if(bTermDataScratch) {
+         if(IsMultiplyError(sizeof(TermDataScratch), cSubsets)) {
+            goto failed_allocation;
+         }
+         m_aTermDataScratch = static_cast<TermDataScratch*>(malloc(sizeof(TermDataScratch) * cSubsets));
+         if(nullptr == m_aTermDataScratch) {
+            goto failed_allocation;
+         }
+         for(size_t iSubset = 0; iSubset < cSubsets; ++iSubset) {
+            m_aTermDataScratch[iSubset].m_aData = nullptr;
+            m_aTermDataScratch[iSubset].m_iTerm = SIZE_MAX;
+         }
+         m_cTermDataScratch = cSubsets;
+
+         for(size_t iSubset = 0; iSubset < cSubsets; ++iSubset) {
+            const DataSubsetBoosting* const pSubset = iSubset < cTrainingSubsets ?
+                  &pTrainingSet->GetSubsets()[iSubset] :
+                  &pValidationSet->GetSubsets()[iSubset - cTrainingSubsets];
+            const size_t cBytes = pSubset->GetCountBytesTermDataScratch();
+            if(0 != cBytes) {
+               m_aTermDataScratch[iSubset].m_aData = AlignedAlloc(cBytes);
+               if(nullptr == m_aTermDataScratch[iSubset].m_aData) {
+                  goto failed_allocation;
+               }
+            }
+         }
+      }
    }
 
    LOG_0(Trace_Info, "Exited BoosterShell::FillAllocations");
@@ -235,7 +291,7 @@ EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION CreateBooster(void* rng,
 
    if(flags &
          ~(CreateBoosterFlags_DifferentialPrivacy | CreateBoosterFlags_UseApprox |
-               CreateBoosterFlags_BinaryAsMulticlass)) {
+               CreateBoosterFlags_BinaryAsMulticlass | CreateBoosterFlags_PackByFeature)) {
       LOG_0(Trace_Error, "ERROR CreateBooster flags contains unknown flags. Ignoring extras.");
    }
 
@@ -266,6 +322,13 @@ EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION CreateBooster(void* rng,
    }
    const size_t cInnerBags = static_cast<size_t>(countInnerBags);
 
+   // BoosterCore::Create advances the RNG, so the recording needs the state it had on entry
+   alignas(RandomDeterministic) unsigned char aRngBefore[k_cBytesRecordedRng];
+   const bool bRecording = IsRecording();
+   if(bRecording) {
+      SaveRecordedRng(rng, aRngBefore);
+   }
+
    // TODO: since BoosterCore is a non-POD C++ class, we should probably move the call to new from inside
    //       BoosterCore::Create to here and wrap it with a try catch at this level and rely on standard C++ behavior
    BoosterCore* pBoosterCore = nullptr;
@@ -328,12 +391,86 @@ EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION CreateBooster(void* rng,
 
    const BoosterHandle handle = pBoosterShell->GetHandle();
 
+   if(bRecording) {
+      RecordCreateBooster(nullptr == rng ? nullptr : aRngBefore,
+            dataSet,
+            intercept,
+            bag,
+            initScores,
+            countTerms,
+            dimensionCounts,
+            featureIndexes,
+            countInnerBags,
+            flags,
+            acceleration,
+            objective,
+            pBoosterCore->GetCountScores(),
+            handle);
+   }
+
    LOG_N(Trace_Info, "Exited CreateBooster: *boosterHandleOut=%p", static_cast<void*>(handle));
 
    *boosterHandleOut = handle;
    return Error_None;
 }
 
+EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION CreateBoosterFromBagPlan(void* rng,
+      const void* dataSet,
+      const double* intercept,
+      const void* bagPlan,
+      IntEbm indexBag,
+      const double* initScores,
+      IntEbm countTerms,
+      const IntEbm* dimensionCounts,
+      const IntEbm* featureIndexes,
+      IntEbm countInnerBags,
+      CreateBoosterFlags flags,
+      AccelerationFlags acceleration,
+      const char* objective,
+      const double* experimentalParams,
+      BoosterHandle* boosterHandleOut) {
+   LOG_N(Trace_Info,
+         "Entered CreateBoosterFromBagPlan: "
+         "bagPlan=%p, "
+         "indexBag=%" IntEbmPrintf,
+         bagPlan,
+         indexBag);
+
+   if(nullptr == boosterHandleOut) {
+      LOG_0(Trace_Error, "ERROR CreateBoosterFromBagPlan nullptr == boosterHandleOut");
+      return Error_IllegalParamVal;
+   }
+   *boosterHandleOut = nullptr; // set this to nullptr as soon as possible so the caller doesn't attempt to free it
+
+   BagEbm* aBag;
+   ErrorEbm error = AllocateBagFromPlan(dataSet, bagPlan, indexBag, &aBag);
+   if(Error_None != error) {
+      // already logged
+      return error;
+   }
+
+   // CreateBooster does not hold onto the bag after it returns, and it records the unpacked bag
+   error = CreateBooster(rng,
+         dataSet,
+         intercept,
+         aBag,
+         initScores,
+         countTerms,
+         dimensionCounts,
+         featureIndexes,
+         countInnerBags,
+         flags,
+         acceleration,
+         objective,
+         experimentalParams,
+         boosterHandleOut);
+
+   free(aBag);
+
+   LOG_0(Trace_Info, "Exited CreateBoosterFromBagPlan");
+   return error;
+}
+
 EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION CreateBoosterView(
       BoosterHandle boosterHandle, BoosterHandle* boosterHandleViewOut) {
    LOG_N(Trace_Info,
@@ -372,6 +509,10 @@ EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION CreateBoosterView(
       return error;
    }
 
+   if(IsRecording()) {
+      RecordCreateBoosterView(boosterHandle, pBoosterShellNew->GetHandle());
+   }
+
    LOG_0(Trace_Info, "Exited CreateBoosterView");
 
    *boosterHandleViewOut = pBoosterShellNew->GetHandle();
@@ -526,6 +667,284 @@ EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION GetCurrentTermScores(
    return Error_None;
 }
 
+// A serialized booster holds everything that boosting changes after CreateBooster: the current and best term
+// tensors, the best validation metric, and the sample scores and gradients of the training and validation sets.
+// Things that CreateBooster derives from its inputs, like the bags and the packed data, are not stored, so a state
+// can only be loaded into a booster created with the same arguments.  The shape of the booster is stored next to the
+// data so that loading it into a different booster fails instead of silently mixing models.  The caller's rng is
+// stored too since it moves forward with every random split.  Everything is in native byte order.
+static constexpr char k_boosterStateMagic[8] = {'E', 'B', 'M', 'B', 'S', 'T', '0', '1'};
+
+enum class BoosterStateMode { Measure, Serialize, Verify, Deserialize };
+
+struct BoosterStateCursor {
+   BoosterStateMode m_mode;
+   unsigned char* m_pState;
+   size_t m_cBytesState;
+   size_t m_iByte;
+   bool m_bMismatch;
+};
+
+static void TransferBytes(BoosterStateCursor* const pCursor, void* const p, const size_t cBytes) {
+   if(pCursor->m_bMismatch) {
+      return;
+   }
+   if(BoosterStateMode::Measure != pCursor->m_mode) {
+      if(pCursor->m_cBytesState - pCursor->m_iByte < cBytes) {
+         pCursor->m_bMismatch = true;
+         return;
+      }
+      if(BoosterStateMode::Serialize == pCursor->m_mode) {
+         memcpy(pCursor->m_pState + pCursor->m_iByte, p, cBytes);
+      } else if(BoosterStateMode::Deserialize == pCursor->m_mode) {
+         memcpy(p, pCursor->m_pState + pCursor->m_iByte, cBytes);
+      }
+   }
+   pCursor->m_iByte += cBytes;
+}
+
+static void TransferShape(BoosterStateCursor* const pCursor, const uint64_t val) {
+   // shape values are written when serializing and must match the booster when loading
+   if(pCursor->m_bMismatch) {
+      return;
+   }
+   uint64_t valState = val;
+   if(BoosterStateMode::Serialize == pCursor->m_mode || BoosterStateMode::Measure == pCursor->m_mode) {
+      TransferBytes(pCursor, &valState, sizeof(valState));
+   } else {
+      if(pCursor->m_cBytesState - pCursor->m_iByte < sizeof(valState)) {
+         pCursor->m_bMismatch = true;
+         return;
+      }
+      memcpy(&valState, pCursor->m_pState + pCursor->m_iByte, sizeof(valState));
+      pCursor->m_iByte += sizeof(valState);
+      if(val != valState) {
+         pCursor->m_bMismatch = true;
+      }
+   }
+}
+
+static void TransferDataSet(BoosterStateCursor* const pCursor,
+      DataSetBoosting* const pDataSet,
+      const size_t cScores,
+      const size_t cGradHessMultiple) {
+   const size_t cSubsets = pDataSet->GetCountSubsets();
+   TransferShape(pCursor, static_cast<uint64_t>(cSubsets));
+   if(pCursor->m_bMismatch || size_t{0} == cSubsets) {
+      return;
+   }
+   DataSubsetBoosting* pSubset = pDataSet->GetSubsets();
+   const DataSubsetBoosting* const pSubsetsEnd = pSubset + cSubsets;
+   do {
+      const size_t cSamples = pSubset->GetCountSamples();
+      TransferShape(pCursor, static_cast<uint64_t>(cSamples));
+
+      // these were allocated, so the multiplications cannot overflow
+      const size_t cBytesPerSample = pSubset->GetObjectiveWrapper()->m_cFloatBytes * cScores;
+      const size_t cBytesGradHess =
+            nullptr == pSubset->GetGradHess() ? size_t{0} : cBytesPerSample * cGradHessMultiple * cSamples;
+      TransferShape(pCursor, static_cast<uint64_t>(cBytesGradHess));
+      TransferBytes(pCursor, pSubset->GetGradHess(), cBytesGradHess);
+
+      const size_t cBytesSampleScores = nullptr == pSubset->GetSampleScores() ? size_t{0} : cBytesPerSample * cSamples;
+      TransferShape(pCursor, static_cast<uint64_t>(cBytesSampleScores));
+      TransferBytes(pCursor, pSubset->GetSampleScores(), cBytesSampleScores);
+
+      ++pSubset;
+   } while(pSubsetsEnd != pSubset);
+}
+
+static void TransferBoosterState(BoosterStateCursor* const pCursor, BoosterCore* const pBoosterCore, void* const rng) {
+   uint64_t magic;
+   static_assert(sizeof(magic) == sizeof(k_boosterStateMagic), "the magic number must fill a uint64_t");
+   memcpy(&magic, k_boosterStateMagic, sizeof(magic));
+   TransferShape(pCursor, magic);
+
+   const size_t cScores = pBoosterCore->GetCountScores();
+   const size_t cTerms = pBoosterCore->GetCountTerms();
+   TransferShape(pCursor, static_cast<uint64_t>(cScores));
+   TransferShape(pCursor, static_cast<uint64_t>(cTerms));
+   TransferShape(pCursor, static_cast<uint64_t>(pBoosterCore->GetCountInnerBags()));
+   TransferShape(pCursor, static_cast<uint64_t>(pBoosterCore->GetTrainingSet()->GetCountSamples()));
+   TransferShape(pCursor, static_cast<uint64_t>(pBoosterCore->GetValidationSet()->GetCountSamples()));
+
+   // the rng slot is always present so that the size of the state does not depend on whether an rng was given
+   alignas(RandomDeterministic) unsigned char aRng[sizeof(RandomDeterministic)];
+   uint64_t bRng = 0;
+   if(BoosterStateMode::Serialize == pCursor->m_mode) {
+      memset(aRng, 0, sizeof(aRng));
+      if(nullptr != rng) {
+         bRng = 1;
+         memcpy(aRng, rng, sizeof(aRng));
+      }
+   }
+   TransferBytes(pCursor, &bRng, sizeof(bRng));
+   TransferBytes(pCursor, aRng, sizeof(aRng));
+   if(BoosterStateMode::Deserialize == pCursor->m_mode && !pCursor->m_bMismatch && nullptr != rng && 0 != bRng) {
+      memcpy(rng, aRng, sizeof(aRng));
+   }
+
+   double bestModelMetric = pBoosterCore->GetBestModelMetric();
+   TransferBytes(pCursor, &bestModelMetric, sizeof(bestModelMetric));
+   if(BoosterStateMode::Deserialize == pCursor->m_mode && !pCursor->m_bMismatch) {
+      pBoosterCore->SetBestModelMetric(bestModelMetric);
+   }
+
+   if(size_t{0} == cScores) {
+      // there are no tensors, sample scores or gradients when the target has only one class
+      return;
+   }
+
+   for(size_t iTerm = 0; iTerm < cTerms; ++iTerm) {
+      // the tensors were expanded at startup, so their scores cover every tensor bin
+      const size_t cTensorScores = cScores * pBoosterCore->GetTerms()[iTerm]->GetCountTensorBins();
+      TransferShape(pCursor, static_cast<uint64_t>(cTensorScores));
+      if(size_t{0} != cTensorScores) {
+         Tensor* const pCurrent = pBoosterCore->GetCurrentModel()[iTerm];
+         Tensor* const pBest = pBoosterCore->GetBestModel()[iTerm];
+         EBM_ASSERT(pCurrent->GetExpanded());
+         EBM_ASSERT(pBest->GetExpanded());
+         TransferBytes(pCursor, pCurrent->GetTensorScoresPointer(), sizeof(FloatScore) * cTensorScores);
+         TransferBytes(pCursor, pBest->GetTensorScoresPointer(), sizeof(FloatScore) * cTensorScores);
+      }
+   }
+
+   TransferDataSet(pCursor, pBoosterCore->GetTrainingSet(), cScores, pBoosterCore->IsHessian() ? 2 : 1);
+   TransferDataSet(pCursor, pBoosterCore->GetValidationSet(), cScores, 1);
+}
+
+EBM_API_BODY IntEbm EBM_CALLING_CONVENTION MeasureSerializedBooster(BoosterHandle boosterHandle) {
+   LOG_N(Trace_Info, "Entered MeasureSerializedBooster: boosterHandle=%p", static_cast<void*>(boosterHandle));
+
+   BoosterShell* const pBoosterShell = BoosterShell::GetBoosterShellFromHandle(boosterHandle);
+   if(nullptr == pBoosterShell) {
+      // already logged
+      return Error_IllegalParamVal;
+   }
+
+   BoosterStateCursor cursor;
+   cursor.m_mode = BoosterStateMode::Measure;
+   cursor.m_pState = nullptr;
+   cursor.m_cBytesState = 0;
+   cursor.m_iByte = 0;
+   cursor.m_bMismatch = false;
+   TransferBoosterState(&cursor, pBoosterShell->GetBoosterCore(), nullptr);
+   EBM_ASSERT(!cursor.m_bMismatch);
+
+   if(IsConvertError<IntEbm>(cursor.m_iByte)) {
+      LOG_0(Trace_Error, "ERROR MeasureSerializedBooster IsConvertError<IntEbm>(cursor.m_iByte)");
+      return Error_OutOfMemory;
+   }
+
+   LOG_0(Trace_Info, "Exited MeasureSerializedBooster");
+   return static_cast<IntEbm>(cursor.m_iByte);
+}
+
+EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION SerializeBooster(
+      BoosterHandle boosterHandle, void* rng, IntEbm countBytesAllocated, void* stateOut) {
+   LOG_N(Trace_Info,
+         "Entered SerializeBooster: "
+         "boosterHandle=%p, "
+         "rng=%p, "
+         "countBytesAllocated=%" IntEbmPrintf ", "
+         "stateOut=%p",
+         static_cast<void*>(boosterHandle),
+         rng,
+         countBytesAllocated,
+         stateOut);
+
+   BoosterShell* const pBoosterShell = BoosterShell::GetBoosterShellFromHandle(boosterHandle);
+   if(nullptr == pBoosterShell) {
+      // already logged
+      return Error_IllegalParamVal;
+   }
+
+   if(nullptr == stateOut) {
+      LOG_0(Trace_Error, "ERROR SerializeBooster nullptr == stateOut");
+      return Error_IllegalParamVal;
+   }
+
+   if(IsConvertError<size_t>(countBytesAllocated)) {
+      LOG_0(Trace_Error, "ERROR SerializeBooster countBytesAllocated is outside the range of a valid size");
+      return Error_IllegalParamVal;
+   }
+
+   BoosterStateCursor cursor;
+   cursor.m_mode = BoosterStateMode::Serialize;
+   cursor.m_pState = static_cast<unsigned char*>(stateOut);
+   cursor.m_cBytesState = static_cast<size_t>(countBytesAllocated);
+   cursor.m_iByte = 0;
+   cursor.m_bMismatch = false;
+   TransferBoosterState(&cursor, pBoosterShell->GetBoosterCore(), rng);
+   if(cursor.m_bMismatch) {
+      LOG_0(Trace_Error, "ERROR SerializeBooster countBytesAllocated is smaller than MeasureSerializedBooster");
+      return Error_IllegalParamVal;
+   }
+
+   LOG_0(Trace_Info, "Exited SerializeBooster");
+   return Error_None;
+}
+
+EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION DeserializeBooster(
+      BoosterHandle boosterHandle, IntEbm countBytes, const void* state, void* rngOut) {
+   LOG_N(Trace_Info,
+         "Entered DeserializeBooster: "
+         "boosterHandle=%p, "
+         "countBytes=%" IntEbmPrintf ", "
+         "state=%p, "
+         "rngOut=%p",
+         static_cast<void*>(boosterHandle),
+         countBytes,
+         state,
+         rngOut);
+
+   BoosterShell* const pBoosterShell = BoosterShell::GetBoosterShellFromHandle(boosterHandle);
+   if(nullptr == pBoosterShell) {
+      // already logged
+      return Error_IllegalParamVal;
+   }
+
+   if(nullptr == state) {
+      LOG_0(Trace_Error, "ERROR DeserializeBooster nullptr == state");
+      return Error_IllegalParamVal;
+   }
+
+   if(IsConvertError<size_t>(countBytes)) {
+      LOG_0(Trace_Error, "ERROR DeserializeBooster countBytes is outside the range of a valid size");
+      return Error_IllegalParamVal;
+   }
+
+   if(IsRecording()) {
+      RecordDeserializeBooster(boosterHandle, countBytes, state, rngOut);
+   }
+
+   BoosterCore* const pBoosterCore = pBoosterShell->GetBoosterCore();
+
+   // check the whole state before changing anything so that a bad state leaves the booster as it was
+   BoosterStateCursor cursor;
+   cursor.m_mode = BoosterStateMode::Verify;
+   cursor.m_pState = static_cast<unsigned char*>(const_cast<void*>(state));
+   cursor.m_cBytesState = static_cast<size_t>(countBytes);
+   cursor.m_iByte = 0;
+   cursor.m_bMismatch = false;
+   TransferBoosterState(&cursor, pBoosterCore, nullptr);
+   if(cursor.m_bMismatch || cursor.m_cBytesState != cursor.m_iByte) {
+      LOG_0(Trace_Error, "ERROR DeserializeBooster state was not serialized from a booster with the same shape");
+      return Error_IllegalParamVal;
+   }
+
+   cursor.m_mode = BoosterStateMode::Deserialize;
+   cursor.m_iByte = 0;
+   TransferBoosterState(&cursor, pBoosterCore, rngOut);
+   EBM_ASSERT(!cursor.m_bMismatch);
+
+   // any update generated before loading belongs to the old state
+   pBoosterShell->SetTermIndex(BoosterShell::k_illegalTermIndex);
+
+   LOG_0(Trace_Info, "Exited DeserializeBooster");
+   return Error_None;
+}
+
 EBM_API_BODY void EBM_CALLING_CONVENTION FreeBooster(BoosterHandle boosterHandle) {
    LOG_N(Trace_Info, "Entered FreeBooster: boosterHandle=%p", static_cast<void*>(boosterHandle));
 
@@ -533,6 +952,10 @@ EBM_API_BODY void EBM_CALLING_CONVENTION FreeBooster(BoosterHandle boosterHandle
    // if the conversion above doesn't work, it'll return null, and our free will not in fact free any memory,
    // but it will not crash. We'll leak memory, but at least we'll log that.
 
+   if(nullptr != pBoosterShell && IsRecording()) {
+      RecordFreeBooster(boosterHandle);
+   }
+
    // it's legal to call free on nullptr, just like for free().  This is checked inside BoosterCore::Free()
    BoosterShell::Free(pBoosterShell);
 
@@ -12,6 +12,8 @@
 #include "logging.h" // EBM_ASSERT
 #include "unzoned.h"
 
+#include "DataSetBoosting.hpp" // TermDataScratch
+
 namespace DEFINED_ZONE_NAME {
 #ifndef DEFINED_ZONE_NAME
 #error DEFINED_ZONE_NAME must be defined
@@ -54,6 +56,11 @@ class BoosterShell final {
 
    void* m_aSplitPositionsTemp;
 
+   // one per training subset followed by one per validation subset.  These live here instead of in the subsets
+   // because the subsets are shared by all the views of a booster
+   size_t m_cTermDataScratch;
+   TermDataScratch* m_aTermDataScratch;
+
 #ifndef NDEBUG
    const BinBase* m_pDebugMainBinsEnd;
 #endif // NDEBUG
@@ -83,6 +90,9 @@ class BoosterShell final {
       m_cTreeNodesTempBytes = 0;
       m_aTreeNodesTemp = nullptr;
       m_aSplitPositionsTemp = nullptr;
+
+      m_cTermDataScratch = 0;
+      m_aTermDataScratch = nullptr;
    }
 
    static void Free(BoosterShell* const pBoosterShell);
@@ -148,6 +158,15 @@ class BoosterShell final {
       return AlignedGrow(static_cast<void**>(&m_aTemp1), &m_cTemp1Bytes, cBytes, EBM_FALSE);
    }
 
+   INLINE_ALWAYS TermDataScratch* GetTermDataScratch(const size_t iSubset) {
+      // nullptr when packing by term, or when packing by feature without any multi-dimensional terms
+      if(nullptr == m_aTermDataScratch) {
+         return nullptr;
+      }
+      EBM_ASSERT(iSubset < m_cTermDataScratch);
+      return &m_aTermDataScratch[iSubset];
+   }
+
    template<bool bHessian, size_t cCompilerScores = 1>
    INLINE_ALWAYS SplitPosition<bHessian, cCompilerScores>* GetSplitPositionsTemp() {
       return static_cast<SplitPosition<bHessian, cCompilerScores>*>(m_aSplitPositionsTemp);
@@ -7,6 +7,9 @@
 #include <stddef.h> // size_t, ptrdiff_t
 #include <limits> // numeric_limits
 #include <string.h> // memcpy
+#include <atomic>
+#include <thread>
+#include <vector>
 
 #include "libebm.h" // ErrorEbm
 #include "logging.h" // EBM_ASSERT
@@ -21,9 +24,11 @@
 #include "Feature.hpp"
 #include "DataSetInteraction.hpp"
 #include "Tensor.hpp"
+#include "TensorTotalsSum.hpp" // MonotoneDimension
 #include "TreeNodeMulti.hpp"
 #include "InteractionCore.hpp"
 #include "InteractionShell.hpp"
+#include "api_recording.hpp"
 
 namespace DEFINED_ZONE_NAME {
 #ifndef DEFINED_ZONE_NAME
@@ -90,6 +95,8 @@ extern ErrorEbm PartitionMultiDimensionalTree(const bool bHessian,
       Tensor* const pInnerTermUpdate,
       void* const pRootTreeNodeBase,
       const size_t* const acBins,
+      const MonotoneDimension* const aMonotoneDimensions,
+      FloatCalc* const aGainBounds,
       double* const aTensorWeights,
       double* const aTensorGrad,
       double* const aTensorHess,
@@ -115,18 +122,21 @@ extern double PartitionMultiDimensionalFull(InteractionCore* const pInteractionC
 // there is a race condition for decrementing this variable, but if a thread loses the
 // race then it just doesn't get decremented as quickly, which we can live with
 static int g_cLogCalcInteractionStrength = 10;
+static int g_cLogCalcInteractionStrengths = 10;
 
-EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION CalcInteractionStrength(InteractionHandle interactionHandle,
-      IntEbm countDimensions,
-      const IntEbm* featureIndexes,
-      CalcInteractionFlags flags,
-      IntEbm maxCardinality,
-      IntEbm minSamplesLeaf,
+// CalcInteractionStrengths calls this directly from its workers so that the recording holds the batch call once instead
+// of once per term
+static ErrorEbm CalcInteractionStrengthUnrecorded(const InteractionHandle interactionHandle,
+      const IntEbm countDimensions,
+      const IntEbm* const featureIndexes,
+      const CalcInteractionFlags flags,
+      const IntEbm maxCardinality,
+      const IntEbm minSamplesLeaf,
       double minHessian,
       double regAlpha,
       double regLambda,
       double maxDeltaStep,
-      double* avgInteractionStrengthOut) {
+      double* const avgInteractionStrengthOut) {
    LOG_COUNTED_N(&g_cLogCalcInteractionStrength,
          Trace_Info,
          Trace_Verbose,
@@ -656,6 +666,8 @@ EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION CalcInteractionStrength(Interaction
                pInnerTermUpdate,
                pTreeNodesTemp,
                binSums.m_acBins,
+               nullptr,
+               nullptr,
                aWeights,
                pGradient,
                pHessian,
@@ -744,4 +756,309 @@ EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION CalcInteractionStrength(Interaction
    return Error_None;
 }
 
+EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION CalcInteractionStrength(InteractionHandle interactionHandle,
+      IntEbm countDimensions,
+      const IntEbm* featureIndexes,
+      CalcInteractionFlags flags,
+      IntEbm maxCardinality,
+      IntEbm minSamplesLeaf,
+      double minHessian,
+      double regAlpha,
+      double regLambda,
+      double maxDeltaStep,
+      double* avgInteractionStrengthOut) {
+   if(IsRecording()) {
+      RecordCalcInteractionStrength(interactionHandle,
+            countDimensions,
+            featureIndexes,
+            flags,
+            maxCardinality,
+            minSamplesLeaf,
+            minHessian,
+            regAlpha,
+            regLambda,
+            maxDeltaStep);
+   }
+   return CalcInteractionStrengthUnrecorded(interactionHandle,
+         countDimensions,
+         featureIndexes,
+         flags,
+         maxCardinality,
+         minSamplesLeaf,
+         minHessian,
+         regAlpha,
+         regLambda,
+         maxDeltaStep,
+         avgInteractionStrengthOut);
+}
+
+struct InteractionWorkQueue final {
+   // every worker, including the calling thread, pulls the next term index from m_iTermNext, so a worker that
+   // draws a cheap pair simply moves on to the next one instead of idling while a slow partition finishes
+
+   InteractionWorkQueue() = default;
+
+   size_t m_cTerms;
+   const IntEbm* m_aDimensionCounts;
+   const IntEbm* m_aFeatureIndexes;
+   const size_t* m_aiFeatureIndexStarts;
+   CalcInteractionFlags m_flags;
+   IntEbm m_maxCardinality;
+   IntEbm m_minSamplesLeaf;
+   double m_minHessian;
+   double m_regAlpha;
+   double m_regLambda;
+   double m_maxDeltaStep;
+   double* m_aAvgInteractionStrengthsOut;
+
+   std::atomic_size_t m_iTermNext;
+   std::atomic<ErrorEbm> m_error;
+};
+
+static void CalcInteractionStrengthsWorker(
+      InteractionWorkQueue* const pQueue, const InteractionHandle interactionHandle) noexcept {
+   EBM_ASSERT(nullptr != pQueue);
+   EBM_ASSERT(nullptr != interactionHandle);
+
+   const size_t cTerms = pQueue->m_cTerms;
+   while(true) {
+      // relaxed ordering is sufficient since each index is claimed by exactly one worker and the results are
+      // published to the caller by joining the threads
+      const size_t iTerm = pQueue->m_iTermNext.fetch_add(1, std::memory_order_relaxed);
+      if(cTerms <= iTerm) {
+         break;
+      }
+      const ErrorEbm error = CalcInteractionStrengthUnrecorded(interactionHandle,
+            pQueue->m_aDimensionCounts[iTerm],
+            pQueue->m_aFeatureIndexes + pQueue->m_aiFeatureIndexStarts[iTerm],
+            pQueue->m_flags,
+            pQueue->m_maxCardinality,
+            pQueue->m_minSamplesLeaf,
+            pQueue->m_minHessian,
+            pQueue->m_regAlpha,
+            pQueue->m_regLambda,
+            pQueue->m_maxDeltaStep,
+            &pQueue->m_aAvgInteractionStrengthsOut[iTerm]);
+      if(Error_None != error) {
+         ErrorEbm errorExpected = Error_None;
+         pQueue->m_error.compare_exchange_strong(errorExpected, error, std::memory_order_relaxed);
+         // drain the queue so that the other workers stop at their next pull
+         pQueue->m_iTermNext.store(cTerms, std::memory_order_relaxed);
+         break;
+      }
+   }
+}
+
+EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION CalcInteractionStrengths(InteractionHandle interactionHandle,
+      IntEbm countTerms,
+      const IntEbm* dimensionCounts,
+      const IntEbm* featureIndexes,
+      CalcInteractionFlags flags,
+      IntEbm maxCardinality,
+      IntEbm minSamplesLeaf,
+      double minHessian,
+      double regAlpha,
+      double regLambda,
+      double maxDeltaStep,
+      IntEbm countThreads,
+      double* avgInteractionStrengthsOut) {
+   LOG_COUNTED_N(&g_cLogCalcInteractionStrengths,
+         Trace_Info,
+         Trace_Verbose,
+         "CalcInteractionStrengths: "
+         "interactionHandle=%p, "
+         "countTerms=%" IntEbmPrintf ", "
+         "dimensionCounts=%p, "
+         "featureIndexes=%p, "
+         "flags=0x%" UCalcInteractionFlagsPrintf ", "
+         "maxCardinality=%" IntEbmPrintf ", "
+         "minSamplesLeaf=%" IntEbmPrintf ", "
+         "minHessian=%le, "
+         "regAlpha=%le, "
+         "regLambda=%le, "
+         "maxDeltaStep=%le, "
+         "countThreads=%" IntEbmPrintf ", "
+         "avgInteractionStrengthsOut=%p",
+         static_cast<void*>(interactionHandle),
+         countTerms,
+         static_cast<const void*>(dimensionCounts),
+         static_cast<const void*>(featureIndexes),
+         static_cast<UCalcInteractionFlags>(flags), // signed to unsigned conversion is defined behavior in C++
+         maxCardinality,
+         minSamplesLeaf,
+         minHessian,
+         regAlpha,
+         regLambda,
+         maxDeltaStep,
+         countThreads,
+         static_cast<void*>(avgInteractionStrengthsOut));
+
+   InteractionShell* const pInteractionShell = InteractionShell::GetInteractionShellFromHandle(interactionHandle);
+   if(nullptr == pInteractionShell) {
+      // already logged
+      return Error_IllegalParamVal;
+   }
+
+   if(IsRecording()) {
+      RecordCalcInteractionStrengths(interactionHandle,
+            countTerms,
+            dimensionCounts,
+            featureIndexes,
+            flags,
+            maxCardinality,
+            minSamplesLeaf,
+            minHessian,
+            regAlpha,
+            regLambda,
+            maxDeltaStep,
+            countThreads);
+   }
+
+   if(countTerms <= IntEbm{0}) {
+      if(IntEbm{0} == countTerms) {
+         LOG_0(Trace_Info, "INFO CalcInteractionStrengths empty term list");
+         return Error_None;
+      }
+      LOG_0(Trace_Error, "ERROR CalcInteractionStrengths countTerms must be positive");
+      return Error_IllegalParamVal;
+   }
+   if(IsConvertError<size_t>(countTerms) || IsMultiplyError(sizeof(size_t), static_cast<size_t>(countTerms))) {
+      LOG_0(Trace_Warning, "WARNING CalcInteractionStrengths countTerms too large");
+      return Error_OutOfMemory;
+   }
+   const size_t cTerms = static_cast<size_t>(countTerms);
+
+   if(nullptr == dimensionCounts) {
+      LOG_0(Trace_Error, "ERROR CalcInteractionStrengths dimensionCounts cannot be nullptr");
+      return Error_IllegalParamVal;
+   }
+   if(nullptr == avgInteractionStrengthsOut) {
+      LOG_0(Trace_Error, "ERROR CalcInteractionStrengths avgInteractionStrengthsOut cannot be nullptr");
+      return Error_IllegalParamVal;
+   }
+
+   size_t* const aiFeatureIndexStarts = static_cast<size_t*>(malloc(sizeof(size_t) * cTerms));
+   if(nullptr == aiFeatureIndexStarts) {
+      LOG_0(Trace_Warning, "WARNING CalcInteractionStrengths nullptr == aiFeatureIndexStarts");
+      return Error_OutOfMemory;
+   }
+
+   // validate the dimension counts up front so that the workers only see in-range offsets into featureIndexes
+   size_t iFeatureIndexStart = 0;
+   for(size_t iTerm = 0; iTerm < cTerms; ++iTerm) {
+      const IntEbm countDimensions = dimensionCounts[iTerm];
+      if(countDimensions < IntEbm{0} || IntEbm{k_cDimensionsMax} < countDimensions) {
+         LOG_0(Trace_Error, "ERROR CalcInteractionStrengths dimensionCounts value out of range");
+         free(aiFeatureIndexStarts);
+         return Error_IllegalParamVal;
+      }
+      aiFeatureIndexStarts[iTerm] = iFeatureIndexStart;
+      iFeatureIndexStart += static_cast<size_t>(countDimensions);
+   }
+   if(size_t{0} != iFeatureIndexStart && nullptr == featureIndexes) {
+      LOG_0(Trace_Error, "ERROR CalcInteractionStrengths featureIndexes cannot be nullptr if there are dimensions");
+      free(aiFeatureIndexStarts);
+      return Error_IllegalParamVal;
+   }
+
+   size_t cThreads = size_t{1};
+   if(IntEbm{0} < countThreads) {
+      if(!IsConvertError<size_t>(countThreads)) {
+         cThreads = static_cast<size_t>(countThreads);
+      }
+   } else {
+      // hardware_concurrency is allowed to return 0 if it cannot determine the number of cores
+      cThreads = EbmMax(size_t{1}, static_cast<size_t>(std::thread::hardware_concurrency()));
+   }
+   cThreads = EbmMin(cThreads, cTerms);
+
+   InteractionWorkQueue queue;
+   queue.m_cTerms = cTerms;
+   queue.m_aDimensionCounts = dimensionCounts;
+   queue.m_aFeatureIndexes = featureIndexes;
+   queue.m_aiFeatureIndexStarts = aiFeatureIndexStarts;
+   queue.m_flags = flags;
+   queue.m_maxCardinality = maxCardinality;
+   queue.m_minSamplesLeaf = minSamplesLeaf;
+   queue.m_minHessian = minHessian;
+   queue.m_regAlpha = regAlpha;
+   queue.m_regLambda = regLambda;
+   queue.m_maxDeltaStep = maxDeltaStep;
+   queue.m_aAvgInteractionStrengthsOut = avgInteractionStrengthsOut;
+   queue.m_iTermNext.store(0, std::memory_order_relaxed);
+   queue.m_error.store(Error_None, std::memory_order_relaxed);
+
+   // Each extra worker gets its own InteractionShell which holds the per-call scratch bins, while the
+   // InteractionCore holding the dataset, gradients and hessians is shared read-only via reference counting.
+   InteractionCore* const pInteractionCore = pInteractionShell->GetInteractionCore();
+   size_t cWorkerShells = 0;
+   InteractionShell** apWorkerShells = nullptr;
+   if(size_t{1} < cThreads) {
+      apWorkerShells = static_cast<InteractionShell**>(malloc(sizeof(InteractionShell*) * (cThreads - 1)));
+      if(nullptr == apWorkerShells) {
+         LOG_0(Trace_Warning, "WARNING CalcInteractionStrengths nullptr == apWorkerShells");
+         free(aiFeatureIndexStarts);
+         return Error_OutOfMemory;
+      }
+      while(cWorkerShells < cThreads - 1) {
+         pInteractionCore->AddReferenceCount();
+         InteractionShell* const pWorkerShell = InteractionShell::Create(pInteractionCore);
+         if(nullptr == pWorkerShell) {
+            // we can still make progress with the workers we have, so release the reference and continue
+            InteractionCore::Free(pInteractionCore);
+            break;
+         }
+         apWorkerShells[cWorkerShells] = pWorkerShell;
+         ++cWorkerShells;
+      }
+   }
+
+   size_t cThreadsStarted = 0;
+   try {
+      std::vector<std::thread> threads;
+      threads.reserve(cWorkerShells);
+      try {
+         while(cThreadsStarted < cWorkerShells) {
+            threads.emplace_back(
+                  CalcInteractionStrengthsWorker, &queue, apWorkerShells[cThreadsStarted]->GetHandle());
+            ++cThreadsStarted;
+         }
+      } catch(...) {
+         // the calling thread always participates, so failing to start extra threads only reduces parallelism
+         LOG_0(Trace_Warning, "WARNING CalcInteractionStrengths could not start all threads");
+      }
+
+      CalcInteractionStrengthsWorker(&queue, interactionHandle);
+
+      for(std::thread& thread : threads) {
+         thread.join();
+      }
+   } catch(const std::bad_alloc&) {
+      LOG_0(Trace_Warning, "WARNING CalcInteractionStrengths out of memory");
+      queue.m_error.store(Error_OutOfMemory, std::memory_order_relaxed);
+   } catch(...) {
+      LOG_0(Trace_Warning, "WARNING CalcInteractionStrengths thread exception");
+      queue.m_error.store(Error_ThreadStartFailed, std::memory_order_relaxed);
+   }
+
+   for(size_t iWorkerShell = 0; iWorkerShell < cWorkerShells; ++iWorkerShell) {
+      InteractionShell::Free(apWorkerShells[iWorkerShell]);
+   }
+   free(apWorkerShells);
+   free(aiFeatureIndexStarts);
+
+   const ErrorEbm error = queue.m_error.load(std::memory_order_relaxed);
+
+   LOG_COUNTED_N(pInteractionShell->GetPointerCountLogExitMessages(),
+         Trace_Info,
+         Trace_Verbose,
+         "Exited CalcInteractionStrengths: "
+         "cThreadsStarted=%zu, "
+         "error=%" ErrorEbmPrintf,
+         cThreadsStarted + size_t{1},
+         error);
+
+   return error;
+}
+
 } // namespace DEFINED_ZONE_NAME
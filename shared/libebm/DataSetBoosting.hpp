@@ -22,9 +22,28 @@ namespace DEFINED_ZONE_NAME {
 #error DEFINED_ZONE_NAME must be defined
 #endif // DEFINED_ZONE_NAME
 
+class FeatureBoosting;
 class Term;
+struct FeatureDimension;
 struct DataSetBoosting;
 
+// When the booster packs by feature, terms with more than one real dimension have their tensor indexes composed
+// on demand into one of these.  Each BoosterShell owns its own, one per subset, so that views of the same booster
+// can compose different terms at the same time.
+struct TermDataScratch final {
+   TermDataScratch() = default; // preserve our POD status
+   ~TermDataScratch() = default; // preserve our POD status
+   void* operator new(std::size_t) = delete; // we only use malloc/free in this library
+   void operator delete(void*) = delete; // we only use malloc/free in this library
+
+   void* m_aData;
+   size_t m_iTerm; // the term currently composed into m_aData, or SIZE_MAX if none
+};
+static_assert(std::is_standard_layout<TermDataScratch>::value,
+      "We use the struct hack in several places, so disallow non-standard_layout types in general");
+static_assert(std::is_trivial<TermDataScratch>::value,
+      "We use memcpy in several places, so disallow non-trivial types in general");
+
 struct DataSubsetBoosting final {
    friend DataSetBoosting;
 
@@ -41,9 +60,12 @@ struct DataSubsetBoosting final {
       m_aTargetData = nullptr;
       m_aaTermData = nullptr;
       m_aSubsetInnerBags = nullptr;
+      m_aFeatures = nullptr;
+      m_aaFeatureData = nullptr;
+      m_cBytesTermDataScratch = 0;
    }
 
-   void DestructDataSubsetBoosting(const size_t cTerms, const size_t cInnerBags);
+   void DestructDataSubsetBoosting(const size_t cTerms, const size_t cInnerBags, const size_t cFeatures);
 
    inline size_t GetCountSamples() const { return m_cSamples; }
 
@@ -74,11 +96,18 @@ struct DataSubsetBoosting final {
 
    inline const void* GetTargetData() const { return m_aTargetData; }
 
-   inline const void* GetTermData(const size_t iTerm) const {
+   inline const void* GetTermData(const size_t iTerm, const Term* const pTerm, TermDataScratch* const pScratch) const {
       EBM_ASSERT(nullptr != m_aaTermData);
-      return m_aaTermData[iTerm];
+      const void* const aTermData = m_aaTermData[iTerm];
+      if(nullptr != aTermData || nullptr == m_aaFeatureData) {
+         return aTermData;
+      }
+      return ComposeTermData(iTerm, pTerm, pScratch);
    }
 
+   // zero unless the booster packs by feature and has terms with more than one real dimension
+   inline size_t GetCountBytesTermDataScratch() const { return m_cBytesTermDataScratch; }
+
    inline const SubsetInnerBag* GetSubsetInnerBag(const size_t iBag) const {
       EBM_ASSERT(nullptr != m_aSubsetInnerBags);
       return &m_aSubsetInnerBags[iBag];
@@ -92,6 +121,16 @@ struct DataSubsetBoosting final {
    void* m_aTargetData;
    void** m_aaTermData;
    SubsetInnerBag* m_aSubsetInnerBags;
+
+   // When the booster packs by feature we only store one packed column per feature in m_aaFeatureData.  Terms with
+   // a single real dimension borrow their feature's column in m_aaTermData, and terms with more dimensions have a
+   // nullptr there and get their tensor indexes composed into the caller's TermDataScratch when they are boosted.
+   // The subsets are shared by every view of a booster, so nothing here is written after construction.
+   const void* ComposeTermData(const size_t iTerm, const Term* const pTerm, TermDataScratch* const pScratch) const;
+
+   const FeatureBoosting* m_aFeatures;
+   void** m_aaFeatureData;
+   size_t m_cBytesTermDataScratch;
 };
 static_assert(std::is_standard_layout<DataSubsetBoosting>::value,
       "We use the struct hack in several places, so disallow non-standard_layout types in general");
@@ -110,6 +149,7 @@ struct DataSetBoosting final {
       m_aSubsets = nullptr;
       m_aDataSetInnerBags = nullptr;
       m_aOriginalWeights = nullptr;
+      m_cFeatures = 0;
    }
 
    ErrorEbm InitDataSetBoosting(const bool bAllocateGradients,
@@ -133,7 +173,9 @@ struct DataSetBoosting final {
          const size_t cWeights,
          const size_t cTerms,
          const Term* const* const apTerms,
-         const IntEbm* const aiTermFeatures);
+         const IntEbm* const aiTermFeatures,
+         const size_t cFeatures,
+         const FeatureBoosting* const aFeaturesPacked);
 
    void DestructDataSetBoosting(const size_t cTerms, const size_t cInnerBags);
 
@@ -167,6 +209,14 @@ struct DataSetBoosting final {
 
    ErrorEbm InitTargetData(const unsigned char* const pDataSetShared, const BagEbm direction, const BagEbm* const aBag);
 
+   ErrorEbm InitPackedColumn(const BagEbm direction,
+         const BagEbm* const aBag,
+         const int cBitsRequiredMin,
+         const size_t cRealDimensions,
+         FeatureDimension* const aDimensionInfo,
+         const bool bFeature,
+         const size_t iDestination);
+
    ErrorEbm InitTermData(const unsigned char* const pDataSetShared,
          const BagEbm direction,
          const size_t cSharedSamples,
@@ -175,6 +225,14 @@ struct DataSetBoosting final {
          const Term* const* const apTerms,
          const IntEbm* const aiTermFeatures);
 
+   ErrorEbm InitFeaturePackedTermData(const unsigned char* const pDataSetShared,
+         const BagEbm direction,
+         const size_t cSharedSamples,
+         const BagEbm* const aBag,
+         const size_t cTerms,
+         const Term* const* const apTerms,
+         const IntEbm* const aiTermFeatures);
+
    ErrorEbm CopyWeights(const unsigned char* const pDataSetShared, const BagEbm direction, const BagEbm* const aBag);
 
    ErrorEbm InitBags(const bool bAllocateCachedTensors,
@@ -188,6 +246,7 @@ struct DataSetBoosting final {
    DataSubsetBoosting* m_aSubsets;
    DataSetInnerBag* m_aDataSetInnerBags;
    FloatShared* m_aOriginalWeights;
+   size_t m_cFeatures;
 };
 static_assert(std::is_standard_layout<DataSetBoosting>::value,
       "We use the struct hack in several places, so disallow non-standard_layout types in general");
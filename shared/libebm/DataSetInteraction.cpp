@@ -84,14 +84,175 @@ ErrorEbm DataSetInteraction::InitGradHess(const bool bAllocateHessians, const si
    return Error_None;
 }
 
+// FeatureStream tracks one feature while InitSamples walks the samples.  The read side is the position of the
+// current sample in the bit packed shared dataset, and the write side is the position in the bit packed data of the
+// subset being filled.  Features with only 1 bin are stored nowhere and have no stream.
+struct FeatureStream final {
+   FeatureStream() = default; // preserve our POD status
+   ~FeatureStream() = default; // preserve our POD status
+   void* operator new(std::size_t) = delete; // we only use malloc/free in this library
+   void operator delete(void*) = delete; // we only use malloc/free in this library
+
+   size_t m_iFeature;
+   size_t m_cBins;
+   int m_cBitsRequiredMin;
+
+   const UIntShared* m_pFrom;
+   UIntShared m_maskBitsFrom;
+   int m_cItemsPerBitPackFrom;
+   int m_cBitsPerItemMaxFrom;
+   int m_iShiftFrom;
+   UIntShared m_iBin;
+
+   void* m_pTo;
+   int m_cBitsPerItemMaxTo;
+   int m_cShiftTo;
+   int m_cShiftResetTo;
+};
+static_assert(std::is_standard_layout<FeatureStream>::value,
+      "We use the struct hack in several places, so disallow non-standard_layout types in general");
+static_assert(std::is_trivial<FeatureStream>::value,
+      "We use memcpy in several places, so disallow non-trivial types in general");
+
+static void ReadFeatureStreams(
+      FeatureStream* const aStreams, const FeatureStream* const pStreamsEnd, const size_t cSkippedSamples) {
+   FeatureStream* pStream = aStreams;
+   while(pStreamsEnd != pStream) {
+      const int cItemsPerBitPackFrom = pStream->m_cItemsPerBitPackFrom;
+      int iShiftFrom = pStream->m_iShiftFrom;
+      const UIntShared* pFrom = pStream->m_pFrom;
+      if(size_t{0} != cSkippedSamples) {
+         size_t cCompleteAdvanced = cSkippedSamples / static_cast<size_t>(cItemsPerBitPackFrom);
+         iShiftFrom -= static_cast<int>(cSkippedSamples % static_cast<size_t>(cItemsPerBitPackFrom));
+         if(iShiftFrom < 0) {
+            iShiftFrom += cItemsPerBitPackFrom;
+            EBM_ASSERT(0 <= iShiftFrom);
+            ++cCompleteAdvanced;
+         }
+         pFrom += cCompleteAdvanced;
+      }
+
+      EBM_ASSERT(0 <= iShiftFrom);
+      EBM_ASSERT(iShiftFrom * pStream->m_cBitsPerItemMaxFrom < COUNT_BITS(UIntShared));
+      const UIntShared iBin = (*pFrom >> (iShiftFrom * pStream->m_cBitsPerItemMaxFrom)) & pStream->m_maskBitsFrom;
+
+      EBM_ASSERT(!IsConvertError<size_t>(iBin));
+      EBM_ASSERT(static_cast<size_t>(iBin) < pStream->m_cBins);
+      pStream->m_iBin = iBin;
+
+      --iShiftFrom;
+      if(iShiftFrom < 0) {
+         EBM_ASSERT(-1 == iShiftFrom);
+         iShiftFrom += cItemsPerBitPackFrom;
+         ++pFrom;
+      }
+      pStream->m_iShiftFrom = iShiftFrom;
+      pStream->m_pFrom = pFrom;
+
+      ++pStream;
+   }
+}
+
+static void WriteFeatureStreams(const FeatureStream* const aStreams,
+      const FeatureStream* const pStreamsEnd,
+      const size_t cUIntBytes,
+      const size_t iPartition) {
+   const FeatureStream* pStream = aStreams;
+   if(sizeof(UIntBig) == cUIntBytes) {
+      while(pStreamsEnd != pStream) {
+         EBM_ASSERT(0 <= pStream->m_cShiftTo);
+         *(reinterpret_cast<UIntBig*>(pStream->m_pTo) + iPartition) |= static_cast<UIntBig>(pStream->m_iBin)
+               << pStream->m_cShiftTo;
+         ++pStream;
+      }
+   } else {
+      EBM_ASSERT(sizeof(UIntSmall) == cUIntBytes);
+      while(pStreamsEnd != pStream) {
+         EBM_ASSERT(0 <= pStream->m_cShiftTo);
+         *(reinterpret_cast<UIntSmall*>(pStream->m_pTo) + iPartition) |= static_cast<UIntSmall>(pStream->m_iBin)
+               << pStream->m_cShiftTo;
+         ++pStream;
+      }
+   }
+}
+
+static void AdvanceFeatureStreams(
+      FeatureStream* const aStreams, const FeatureStream* const pStreamsEnd, const size_t cBytesPerPack) {
+   FeatureStream* pStream = aStreams;
+   while(pStreamsEnd != pStream) {
+      pStream->m_cShiftTo -= pStream->m_cBitsPerItemMaxTo;
+      if(pStream->m_cShiftTo < 0) {
+         pStream->m_cShiftTo = pStream->m_cShiftResetTo;
+         pStream->m_pTo = IndexByte(pStream->m_pTo, cBytesPerPack);
+      }
+      ++pStream;
+   }
+}
+
+static void MultiplyGradHessByWeights(const size_t cTotalScores, DataSubsetInteraction* const pSubset) {
+   // The gradients and hessians are constants after initialization and we just bin the non-changing values
+   // after this. By multiplying here we avoid doing the multiplication each time we bin them.
+
+   const void* pWeight = pSubset->GetWeights();
+   if(nullptr == pWeight) {
+      return;
+   }
+
+   const size_t cSIMDPack = pSubset->GetObjectiveWrapper()->m_cSIMDPack;
+   const size_t cFloatBytes = pSubset->GetObjectiveWrapper()->m_cFloatBytes;
+
+   EBM_ASSERT(1 <= cTotalScores);
+   EBM_ASSERT(1 <= pSubset->GetCountSamples());
+   EBM_ASSERT(0 == pSubset->GetCountSamples() % cSIMDPack);
+
+   void* pGradHess = pSubset->GetGradHess();
+   const void* const pGradHessEnd = IndexByte(pGradHess, cFloatBytes * cTotalScores * pSubset->GetCountSamples());
+   do {
+      size_t iPartition = 0;
+      do {
+         size_t iScore = 0;
+         if(sizeof(FloatBig) == cFloatBytes) {
+            const FloatBig weight = reinterpret_cast<const FloatBig*>(pWeight)[iPartition];
+            do {
+               reinterpret_cast<FloatBig*>(pGradHess)[iScore * cSIMDPack + iPartition] *= weight;
+               ++iScore;
+            } while(cTotalScores != iScore);
+         } else {
+            EBM_ASSERT(sizeof(FloatSmall) == cFloatBytes);
+            const FloatSmall weight = reinterpret_cast<const FloatSmall*>(pWeight)[iPartition];
+            do {
+               reinterpret_cast<FloatSmall*>(pGradHess)[iScore * cSIMDPack + iPartition] *= weight;
+               ++iScore;
+            } while(cTotalScores != iScore);
+         }
+         ++iPartition;
+      } while(cSIMDPack != iPartition);
+      pWeight = IndexByte(pWeight, cFloatBytes * cSIMDPack);
+      pGradHess = IndexByte(pGradHess, cFloatBytes * cTotalScores * cSIMDPack);
+   } while(pGradHessEnd != pGradHess);
+}
+
 WARNING_PUSH
 WARNING_DISABLE_UNINITIALIZED_LOCAL_VARIABLE
-ErrorEbm DataSetInteraction::InitFeatureData(const unsigned char* const pDataSetShared,
+ErrorEbm DataSetInteraction::InitSamples(const bool bHessian,
+      const bool bRmse,
+      const BoolEbm bUseApprox,
+      const size_t cScores,
+      const unsigned char* const pDataSetShared,
       const size_t cSharedSamples,
       const BagEbm* const aBag,
+      const double* const aIntercept,
+      const double* const aInitScores,
+      const size_t cWeights,
       const size_t cFeatures) {
-   LOG_0(Trace_Info, "Entered DataSetInteraction::InitFeatureData");
+   // We make a single pass over the samples that are kept by the bag.  Each kept sample has its target, weight,
+   // init score, and the bins of every feature read once from the shared dataset, and they are written into the
+   // subset where we then compute the gradients and hessians while the subset is still in the cache.  RMSE does not
+   // need the objective since its gradient is just the residual, so we compute that directly in the same loop.
 
+   LOG_0(Trace_Info, "Entered DataSetInteraction::InitSamples");
+
+   EBM_ASSERT(1 <= cScores);
    EBM_ASSERT(nullptr != pDataSetShared);
    EBM_ASSERT(1 <= cSharedSamples);
    EBM_ASSERT(1 <= cFeatures);
@@ -100,282 +261,457 @@ ErrorEbm DataSetInteraction::InitFeatureData(const unsigned char* const pDataSet
    EBM_ASSERT(1 <= m_cSubsets);
    const DataSubsetInteraction* const pSubsetsEnd = m_aSubsets + m_cSubsets;
 
-   size_t iFeature = 0;
+   ErrorEbm error = Error_None;
+
+   ptrdiff_t cClasses;
+   const void* const aTargetsFrom = GetDataSetSharedTarget(pDataSetShared, 0, &cClasses);
+   EBM_ASSERT(nullptr != aTargetsFrom); // we previously called GetDataSetSharedTarget and got back a non-null result
+   EBM_ASSERT(0 != cClasses); // no gradients if 0 == cClasses
+   EBM_ASSERT(1 != cClasses); // no gradients if 1 == cClasses
+   const bool bClassification = ptrdiff_t{Task_GeneralClassification} <= cClasses;
+   EBM_ASSERT(bClassification || size_t{1} == cScores);
+   EBM_ASSERT(!bRmse || !bClassification && !bHessian);
+
+   size_t cBytesScoresMax = 0;
+   size_t cBytesAllScoresMax = 0;
+   size_t cBytesTempMax = 0;
+   size_t cBytesTargetMax = 0;
+   const DataSubsetInteraction* pSubsetInit = m_aSubsets;
    do {
-      bool bMissing;
-      bool bUnseen;
-      bool bNominal;
-      bool bSparse;
-      UIntShared countBins;
-      UIntShared defaultValSparse;
-      size_t cNonDefaultsSparse;
-      const void* aFeatureDataFrom = GetDataSetSharedFeature(pDataSetShared,
-            iFeature,
-            &bMissing,
-            &bUnseen,
-            &bNominal,
-            &bSparse,
-            &countBins,
-            &defaultValSparse,
-            &cNonDefaultsSparse);
-      EBM_ASSERT(nullptr != aFeatureDataFrom);
-      EBM_ASSERT(!bSparse); // we don't support sparse yet
-
-      EBM_ASSERT(!IsConvertError<size_t>(countBins)); // checked in a previous call to GetDataSetSharedFeature
-      const size_t cBins = static_cast<size_t>(countBins);
-
-      if(size_t{1} < cBins) {
-         // we don't need any bits to store 1 bin since it's always going to be the only bin available, and also
-         // we return 0.0 on interactions whenever we find a feature with 1 bin before further processing
-
-         const int cBitsRequiredMin = CountBitsRequired(cBins - size_t{1});
-         EBM_ASSERT(1 <= cBitsRequiredMin);
-         EBM_ASSERT(cBitsRequiredMin <= COUNT_BITS(UIntShared)); // comes from shared data set
-         EBM_ASSERT(cBitsRequiredMin <=
-               COUNT_BITS(size_t)); // since cBins fits into size_t (previous call to GetDataSetSharedFeature)
-
-         const int cItemsPerBitPackFrom = GetCountItemsBitPacked<UIntShared>(cBitsRequiredMin);
-         EBM_ASSERT(1 <= cItemsPerBitPackFrom);
-         EBM_ASSERT(cItemsPerBitPackFrom <= COUNT_BITS(UIntShared));
-
-         const int cBitsPerItemMaxFrom = GetCountBits<UIntShared>(cItemsPerBitPackFrom);
-         EBM_ASSERT(1 <= cBitsPerItemMaxFrom);
-         EBM_ASSERT(cBitsPerItemMaxFrom <= COUNT_BITS(UIntShared));
-
-         // we can only guarantee that cBitsPerItemMaxFrom is less than or equal to COUNT_BITS(UIntShared)
-         // so we need to construct our mask in that type, but afterwards we can convert it to the
-         // zone type since we know the ultimate answer must fit into that. If in theory
-         // UIntShared were allowed to be a billion, then the mask could be 65 bits while the end
-         // result would be forced to be 64 bits or less since we use the maximum number of bits per item possible
-         const UIntShared maskBitsFrom = MakeLowMask<UIntShared>(cBitsPerItemMaxFrom);
-
-         int iShiftFrom = static_cast<int>((cSharedSamples - size_t{1}) % static_cast<size_t>(cItemsPerBitPackFrom));
-
-         const UIntShared* pFeatureDataFrom = static_cast<const UIntShared*>(aFeatureDataFrom);
-         const BagEbm* pSampleReplication = aBag;
-         BagEbm replication = 0;
-         UIntShared iFeatureBin;
-
-         DataSubsetInteraction* pSubset = m_aSubsets;
-         do {
-            const int cItemsPerBitPackTo =
-                  GetCountItemsBitPacked(cBitsRequiredMin, pSubset->GetObjectiveWrapper()->m_cUIntBytes);
-            EBM_ASSERT(1 <= cItemsPerBitPackTo);
+      const size_t cSubsetSamples = pSubsetInit->m_cSamples;
+      EBM_ASSERT(1 <= cSubsetSamples);
+      EBM_ASSERT(0 == cSubsetSamples % pSubsetInit->m_pObjective->m_cSIMDPack);
 
-            const int cBitsPerItemMaxTo =
-                  GetCountBits(cItemsPerBitPackTo, pSubset->GetObjectiveWrapper()->m_cUIntBytes);
-            EBM_ASSERT(1 <= cBitsPerItemMaxTo);
+      const size_t cFloatBytes = pSubsetInit->m_pObjective->m_cFloatBytes;
+      if(IsMultiplyError(cFloatBytes, cScores, cSubsetSamples)) {
+         LOG_0(Trace_Warning,
+               "WARNING DataSetInteraction::InitSamples IsMultiplyError(cFloatBytes, cScores, cSubsetSamples)");
+         return Error_OutOfMemory;
+      }
+      const size_t cBytesScores = cFloatBytes * cScores;
+      cBytesScoresMax = EbmMax(cBytesScoresMax, cBytesScores);
+      cBytesAllScoresMax = EbmMax(cBytesAllScoresMax, cBytesScores * cSubsetSamples);
+      cBytesTempMax = EbmMax(cBytesTempMax, cBytesScores * pSubsetInit->m_pObjective->m_cSIMDPack);
+
+      const size_t cBytesTargetItem = bClassification ? pSubsetInit->m_pObjective->m_cUIntBytes : cFloatBytes;
+      if(IsMultiplyError(cBytesTargetItem, cSubsetSamples)) {
+         LOG_0(Trace_Warning,
+               "WARNING DataSetInteraction::InitSamples IsMultiplyError(cBytesTargetItem, cSubsetSamples)");
+         return Error_OutOfMemory;
+      }
+      cBytesTargetMax = EbmMax(cBytesTargetMax, cBytesTargetItem * cSubsetSamples);
+
+      ++pSubsetInit;
+   } while(pSubsetsEnd != pSubsetInit);
+
+   if(IsMultiplyError(sizeof(FeatureStream), cFeatures)) {
+      LOG_0(Trace_Warning, "WARNING DataSetInteraction::InitSamples IsMultiplyError(sizeof(FeatureStream), cFeatures)");
+      return Error_OutOfMemory;
+   }
+   FeatureStream* const aStreams = static_cast<FeatureStream*>(malloc(sizeof(FeatureStream) * cFeatures));
+   if(nullptr == aStreams) {
+      LOG_0(Trace_Warning, "WARNING DataSetInteraction::InitSamples nullptr == aStreams");
+      return Error_OutOfMemory;
+   }
+   FeatureStream* pStreamsEnd = aStreams;
+
+   ApplyUpdateBridge data;
+   data.m_aSampleScores = nullptr;
+   data.m_aUpdateTensorScores = nullptr;
+   data.m_aTargets = nullptr;
+   data.m_aMulticlassMidwayTemp = nullptr;
+
+   if(!bRmse) {
+      data.m_aSampleScores = AlignedAlloc(cBytesAllScoresMax);
+      if(nullptr == data.m_aSampleScores) {
+         LOG_0(Trace_Warning, "WARNING DataSetInteraction::InitSamples nullptr == data.m_aSampleScores");
+         error = Error_OutOfMemory;
+         goto free_all;
+      }
 
-            const size_t cSIMDPack = pSubset->GetObjectiveWrapper()->m_cSIMDPack;
-            EBM_ASSERT(1 <= cSIMDPack);
+      data.m_aUpdateTensorScores = AlignedAlloc(cBytesScoresMax);
+      if(nullptr == data.m_aUpdateTensorScores) {
+         LOG_0(Trace_Warning, "WARNING DataSetInteraction::InitSamples nullptr == data.m_aUpdateTensorScores");
+         error = Error_OutOfMemory;
+         goto free_all;
+      }
+      // we send in an update of all zeros in order to reuse the code that we use for boosting to generate our
+      // gradients and hessians
+      memset(const_cast<void*>(data.m_aUpdateTensorScores), 0, cBytesScoresMax);
+
+      data.m_aTargets = AlignedAlloc(cBytesTargetMax);
+      if(nullptr == data.m_aTargets) {
+         LOG_0(Trace_Warning, "WARNING DataSetInteraction::InitSamples nullptr == data.m_aTargets");
+         error = Error_OutOfMemory;
+         goto free_all;
+      }
 
-            const size_t cSubsetSamples = pSubset->GetCountSamples();
-            EBM_ASSERT(1 <= cSubsetSamples);
-            EBM_ASSERT(0 == cSubsetSamples % cSIMDPack);
+      if(size_t{1} != cScores) {
+         data.m_aMulticlassMidwayTemp = AlignedAlloc(cBytesTempMax);
+         if(nullptr == data.m_aMulticlassMidwayTemp) {
+            LOG_0(Trace_Warning, "WARNING DataSetInteraction::InitSamples nullptr == data.m_aMulticlassMidwayTemp");
+            error = Error_OutOfMemory;
+            goto free_all;
+         }
+      }
 
-            const size_t cParallelSamples = cSubsetSamples / cSIMDPack;
-            EBM_ASSERT(1 <= cParallelSamples);
+      data.m_cScores = cScores;
+      data.m_cPack = k_cItemsPerBitPackUndefined;
+      data.m_bHessianNeeded = bHessian ? EBM_TRUE : EBM_FALSE;
+      data.m_bUseApprox = bUseApprox;
+      data.m_bValidation = EBM_FALSE;
+      data.m_aPacked = nullptr;
+      data.m_aWeights = nullptr;
+   }
+
+   {
+      size_t iFeature = 0;
+      do {
+         bool bMissing;
+         bool bUnseen;
+         bool bNominal;
+         bool bSparse;
+         UIntShared countBins;
+         UIntShared defaultValSparse;
+         size_t cNonDefaultsSparse;
+         const void* aFeatureDataFrom = GetDataSetSharedFeature(pDataSetShared,
+               iFeature,
+               &bMissing,
+               &bUnseen,
+               &bNominal,
+               &bSparse,
+               &countBins,
+               &defaultValSparse,
+               &cNonDefaultsSparse);
+         EBM_ASSERT(nullptr != aFeatureDataFrom);
+         EBM_ASSERT(!bSparse); // we don't support sparse yet
+
+         EBM_ASSERT(!IsConvertError<size_t>(countBins)); // checked in a previous call to GetDataSetSharedFeature
+         const size_t cBins = static_cast<size_t>(countBins);
+
+         if(size_t{1} < cBins) {
+            // we don't need any bits to store 1 bin since it's always going to be the only bin available, and also
+            // we return 0.0 on interactions whenever we find a feature with 1 bin before further processing
+
+            const int cBitsRequiredMin = CountBitsRequired(cBins - size_t{1});
+            EBM_ASSERT(1 <= cBitsRequiredMin);
+            EBM_ASSERT(cBitsRequiredMin <= COUNT_BITS(UIntShared)); // comes from shared data set
+            EBM_ASSERT(cBitsRequiredMin <=
+                  COUNT_BITS(size_t)); // since cBins fits into size_t (previous call to GetDataSetSharedFeature)
+
+            const int cItemsPerBitPackFrom = GetCountItemsBitPacked<UIntShared>(cBitsRequiredMin);
+            EBM_ASSERT(1 <= cItemsPerBitPackFrom);
+            EBM_ASSERT(cItemsPerBitPackFrom <= COUNT_BITS(UIntShared));
+
+            const int cBitsPerItemMaxFrom = GetCountBits<UIntShared>(cItemsPerBitPackFrom);
+            EBM_ASSERT(1 <= cBitsPerItemMaxFrom);
+            EBM_ASSERT(cBitsPerItemMaxFrom <= COUNT_BITS(UIntShared));
+
+            pStreamsEnd->m_iFeature = iFeature;
+            pStreamsEnd->m_cBins = cBins;
+            pStreamsEnd->m_cBitsRequiredMin = cBitsRequiredMin;
+            pStreamsEnd->m_pFrom = static_cast<const UIntShared*>(aFeatureDataFrom);
+            // we can only guarantee that cBitsPerItemMaxFrom is less than or equal to COUNT_BITS(UIntShared)
+            // so we need to construct our mask in that type, but afterwards we can convert it to the
+            // zone type since we know the ultimate answer must fit into that.
+            pStreamsEnd->m_maskBitsFrom = MakeLowMask<UIntShared>(cBitsPerItemMaxFrom);
+            pStreamsEnd->m_cItemsPerBitPackFrom = cItemsPerBitPackFrom;
+            pStreamsEnd->m_cBitsPerItemMaxFrom = cBitsPerItemMaxFrom;
+            pStreamsEnd->m_iShiftFrom =
+                  static_cast<int>((cSharedSamples - size_t{1}) % static_cast<size_t>(cItemsPerBitPackFrom));
+            ++pStreamsEnd;
+         }
+         ++iFeature;
+      } while(cFeatures != iFeature);
+
+      const UIntShared* pTargetClassFrom = static_cast<const UIntShared*>(aTargetsFrom);
+      const FloatShared* pTargetValueFrom = static_cast<const FloatShared*>(aTargetsFrom);
+      const FloatShared* pWeightFrom = nullptr;
+      if(size_t{0} != cWeights) {
+         pWeightFrom = GetDataSetSharedWeight(pDataSetShared, 0);
+         EBM_ASSERT(nullptr != pWeightFrom);
+      }
+      const BagEbm* pSampleReplication = aBag;
+      const double* pInitScoreFrom = aInitScores;
+      const double* pInitScoreFromOld = nullptr;
+
+      BagEbm replication = 0;
+      UIntShared targetClass;
+      double targetValue;
+      double weight;
+
+      double totalWeight = 0.0;
+
+      DataSubsetInteraction* pSubset = m_aSubsets;
+      do {
+         const size_t cSubsetSamples = pSubset->m_cSamples;
+         const size_t cSIMDPack = pSubset->m_pObjective->m_cSIMDPack;
+         const size_t cFloatBytes = pSubset->m_pObjective->m_cFloatBytes;
+         const size_t cUIntBytes = pSubset->m_pObjective->m_cUIntBytes;
+         EBM_ASSERT(1 <= cSIMDPack);
+
+         const size_t cParallelSamples = cSubsetSamples / cSIMDPack;
+         EBM_ASSERT(1 <= cParallelSamples);
+
+         void* pWeightTo = nullptr;
+         if(nullptr != pWeightFrom) {
+            // cFloatBytes * cSubsetSamples was checked above since cScores is at least 1
+            const size_t cBytesWeights = cFloatBytes * cSubsetSamples;
+            pWeightTo = AlignedAlloc(cBytesWeights);
+            if(nullptr == pWeightTo) {
+               LOG_0(Trace_Warning, "WARNING DataSetInteraction::InitSamples nullptr == pWeightTo");
+               error = Error_OutOfMemory;
+               goto free_all;
+            }
+            pSubset->m_aWeights = pWeightTo;
+         }
+
+         FeatureStream* pStream = aStreams;
+         while(pStreamsEnd != pStream) {
+            const int cItemsPerBitPackTo = GetCountItemsBitPacked(pStream->m_cBitsRequiredMin, cUIntBytes);
+            EBM_ASSERT(1 <= cItemsPerBitPackTo);
+
+            const int cBitsPerItemMaxTo = GetCountBits(cItemsPerBitPackTo, cUIntBytes);
+            EBM_ASSERT(1 <= cBitsPerItemMaxTo);
 
             // this can't overflow or underflow
             const size_t cParallelDataUnitsTo =
                   (cParallelSamples - size_t{1}) / static_cast<size_t>(cItemsPerBitPackTo) + size_t{1};
             const size_t cDataUnitsTo = cParallelDataUnitsTo * cSIMDPack;
 
-            if(IsMultiplyError(pSubset->GetObjectiveWrapper()->m_cUIntBytes, cDataUnitsTo)) {
+            if(IsMultiplyError(cUIntBytes, cDataUnitsTo)) {
                LOG_0(Trace_Warning,
-                     "WARNING DataSetInteraction::InitFeatureData "
-                     "IsMultiplyError(pSubset->GetObjectiveWrapper()->m_cUIntBytes, cDataUnitsTo)");
-               return Error_OutOfMemory;
+                     "WARNING DataSetInteraction::InitSamples IsMultiplyError(cUIntBytes, cDataUnitsTo)");
+               error = Error_OutOfMemory;
+               goto free_all;
             }
-            const size_t cBytes = pSubset->GetObjectiveWrapper()->m_cUIntBytes * cDataUnitsTo;
-            void* pFeatureDataTo = AlignedAlloc(cBytes);
+            const size_t cBytes = cUIntBytes * cDataUnitsTo;
+            void* const pFeatureDataTo = AlignedAlloc(cBytes);
             if(nullptr == pFeatureDataTo) {
-               LOG_0(Trace_Warning, "WARNING DataSetInteraction::InitFeatureData nullptr == pFeatureDataTo");
-               return Error_OutOfMemory;
+               LOG_0(Trace_Warning, "WARNING DataSetInteraction::InitSamples nullptr == pFeatureDataTo");
+               error = Error_OutOfMemory;
+               goto free_all;
             }
-            pSubset->m_aaFeatureData[iFeature] = pFeatureDataTo;
-            const void* const pFeatureDataToEnd = IndexByte(pFeatureDataTo, cBytes);
+            pSubset->m_aaFeatureData[pStream->m_iFeature] = pFeatureDataTo;
 
             memset(pFeatureDataTo, 0, cBytes);
 
             ANALYSIS_ASSERT(0 != cItemsPerBitPackTo);
-            int cShiftTo = static_cast<int>((cParallelSamples - size_t{1}) % static_cast<size_t>(cItemsPerBitPackTo)) *
+            pStream->m_pTo = pFeatureDataTo;
+            pStream->m_cBitsPerItemMaxTo = cBitsPerItemMaxTo;
+            pStream->m_cShiftTo =
+                  static_cast<int>((cParallelSamples - size_t{1}) % static_cast<size_t>(cItemsPerBitPackTo)) *
                   cBitsPerItemMaxTo;
-            const int cShiftResetTo = (cItemsPerBitPackTo - 1) * cBitsPerItemMaxTo;
-            do {
-               do {
-                  size_t iPartition = 0;
-                  do {
-                     if(BagEbm{0} == replication) {
-                        replication = 1;
-                        if(nullptr != pSampleReplication) {
-                           const BagEbm* pSampleReplicationOriginal = pSampleReplication;
-                           do {
-                              replication = *pSampleReplication;
-                              ++pSampleReplication;
-                           } while(replication <= BagEbm{0});
-                           const size_t cAdvances = pSampleReplication - pSampleReplicationOriginal - 1;
-
-                           size_t cCompleteAdvanced = cAdvances / static_cast<size_t>(cItemsPerBitPackFrom);
-                           iShiftFrom -= static_cast<int>(cAdvances % static_cast<size_t>(cItemsPerBitPackFrom));
-                           if(iShiftFrom < 0) {
-                              iShiftFrom += cItemsPerBitPackFrom;
-                              EBM_ASSERT(0 <= iShiftFrom);
-                              ++cCompleteAdvanced;
-                           }
-                           pFeatureDataFrom += cCompleteAdvanced;
-                        }
-
-                        const UIntShared bitsFrom = *pFeatureDataFrom;
-
-                        EBM_ASSERT(0 <= iShiftFrom);
-                        EBM_ASSERT(iShiftFrom * cBitsPerItemMaxFrom < COUNT_BITS(UIntShared));
-                        iFeatureBin = (bitsFrom >> (iShiftFrom * cBitsPerItemMaxFrom)) & maskBitsFrom;
-
-                        EBM_ASSERT(!IsConvertError<size_t>(iFeatureBin));
-                        EBM_ASSERT(static_cast<size_t>(iFeatureBin) < cBins);
-
-                        --iShiftFrom;
-                        if(iShiftFrom < 0) {
-                           EBM_ASSERT(-1 == iShiftFrom);
-                           iShiftFrom += cItemsPerBitPackFrom;
-                           ++pFeatureDataFrom;
-                        }
-                     }
-
-                     EBM_ASSERT(1 <= replication);
-                     --replication;
-
-                     EBM_ASSERT(0 <= cShiftTo);
-                     if(sizeof(UIntBig) == pSubset->m_pObjective->m_cUIntBytes) {
-                        *(reinterpret_cast<UIntBig*>(pFeatureDataTo) + iPartition) |= static_cast<UIntBig>(iFeatureBin)
-                              << cShiftTo;
-                     } else {
-                        EBM_ASSERT(sizeof(UIntSmall) == pSubset->m_pObjective->m_cUIntBytes);
-                        *(reinterpret_cast<UIntSmall*>(pFeatureDataTo) + iPartition) |=
-                              static_cast<UIntSmall>(iFeatureBin) << cShiftTo;
-                     }
-
-                     ++iPartition;
-                  } while(cSIMDPack != iPartition);
-                  cShiftTo -= cBitsPerItemMaxTo;
-               } while(0 <= cShiftTo);
-               cShiftTo = cShiftResetTo;
-
-               pFeatureDataTo = IndexByte(pFeatureDataTo, pSubset->m_pObjective->m_cUIntBytes * cSIMDPack);
-            } while(pFeatureDataToEnd != pFeatureDataTo);
-
-            ++pSubset;
-         } while(pSubsetsEnd != pSubset);
-         EBM_ASSERT(0 == replication);
-      }
-      ++iFeature;
-   } while(cFeatures != iFeature);
-
-   LOG_0(Trace_Info, "Exited DataSetInteraction::InitFeatureData");
-   return Error_None;
-}
-WARNING_POP
+            pStream->m_cShiftResetTo = (cItemsPerBitPackTo - 1) * cBitsPerItemMaxTo;
 
-WARNING_PUSH
-WARNING_DISABLE_UNINITIALIZED_LOCAL_VARIABLE
-ErrorEbm DataSetInteraction::InitWeights(const unsigned char* const pDataSetShared, const BagEbm* const aBag) {
-   LOG_0(Trace_Info, "Entered DataSetInteraction::InitWeights");
+            ++pStream;
+         }
 
-   EBM_ASSERT(nullptr != pDataSetShared);
+         void* pGradHess = pSubset->m_aGradHess;
+         void* pTargetTo = const_cast<void*>(data.m_aTargets);
+         void* pSampleScoreTo = data.m_aSampleScores;
 
-   const FloatShared* pWeightFrom = GetDataSetSharedWeight(pDataSetShared, 0);
-   EBM_ASSERT(nullptr != pWeightFrom);
+         // add the weights in 2 stages to preserve precision
+         double subsetWeight = 0.0;
 
-   EBM_ASSERT(nullptr != m_aSubsets);
-   EBM_ASSERT(1 <= m_cSubsets);
-   DataSubsetInteraction* pSubset = m_aSubsets;
-   const DataSubsetInteraction* const pSubsetsEnd = pSubset + m_cSubsets;
+         size_t iParallel = 0;
+         do {
+            size_t iPartition = 0;
+            do {
+               if(BagEbm{0} == replication) {
+                  replication = 1;
+                  size_t cSharedAdvances = 1;
+                  size_t cInitAdvances = 1;
+                  if(nullptr != pSampleReplication) {
+                     // the targets, weights, and features include every sample, but the init scores only include the
+                     // samples with non-zero bag entries
+                     cSharedAdvances = 0;
+                     cInitAdvances = 0;
+                     do {
+                        do {
+                           replication = pSampleReplication[cSharedAdvances];
+                           ++cSharedAdvances;
+                        } while(BagEbm{0} == replication);
+                        ++cInitAdvances;
+                     } while(replication < BagEbm{0});
+                     pSampleReplication += cSharedAdvances;
+                  }
+
+                  if(bClassification) {
+                     pTargetClassFrom += cSharedAdvances;
+                     targetClass = pTargetClassFrom[-1];
+                     // the shared data storage structure ensures that all target values are less than the number of
+                     // classes
+                     EBM_ASSERT(targetClass < static_cast<UIntShared>(cClasses));
+                  } else {
+                     pTargetValueFrom += cSharedAdvances;
+                     // if the target is NaN, we pass this along and NaN propagation will ensure that we stop boosting
+                     // immediately. There is no need to check it here since we already have graceful detection later
+                     targetValue = static_cast<double>(pTargetValueFrom[-1]);
+                  }
+
+                  if(nullptr != pWeightFrom) {
+                     pWeightFrom += cSharedAdvances;
+                     weight = static_cast<double>(pWeightFrom[-1]);
+
+                     // these were checked when creating the shared dataset
+                     EBM_ASSERT(!std::isnan(weight));
+                     EBM_ASSERT(!std::isinf(weight));
+                     EBM_ASSERT(static_cast<double>(std::numeric_limits<float>::min()) <= weight);
+                     EBM_ASSERT(weight <= static_cast<double>(std::numeric_limits<float>::max()));
+                  }
+
+                  if(nullptr != pInitScoreFrom) {
+                     pInitScoreFrom += cInitAdvances * cScores;
+                     pInitScoreFromOld = pInitScoreFrom - cScores;
+                  }
+
+                  ReadFeatureStreams(aStreams, pStreamsEnd, cSharedAdvances - size_t{1});
+               }
+               EBM_ASSERT(1 <= replication);
+               --replication;
+
+               WriteFeatureStreams(aStreams, pStreamsEnd, cUIntBytes, iPartition);
+
+               if(nullptr != pWeightTo) {
+                  subsetWeight += weight;
+                  if(sizeof(FloatBig) == cFloatBytes) {
+                     *reinterpret_cast<FloatBig*>(pWeightTo) = static_cast<FloatBig>(weight);
+                  } else {
+                     EBM_ASSERT(sizeof(FloatSmall) == cFloatBytes);
+                     *reinterpret_cast<FloatSmall*>(pWeightTo) = static_cast<FloatSmall>(weight);
+                  }
+               }
+
+               if(bRmse) {
+                  // for RMSE regression, the gradient is the residual, and we can calculate it once at init and we
+                  // don't need to keep the original scores when computing the gradient updates.
+                  double initScore = nullptr == aIntercept ? 0.0 : *aIntercept;
+                  if(nullptr != pInitScoreFromOld) {
+                     initScore += *pInitScoreFromOld;
+                  }
+                  const double gradient = initScore - targetValue;
+
+                  // This is only used during the initialization of interaction detection. For boosting
+                  // we currently multiply by the weight during bin summation instead since we use the weight
+                  // there to include the inner bagging counts of occurences.
+                  if(sizeof(FloatBig) == cFloatBytes) {
+                     FloatBig gradientConverted = static_cast<FloatBig>(gradient);
+                     if(nullptr != pWeightTo) {
+                        gradientConverted *= *reinterpret_cast<const FloatBig*>(pWeightTo);
+                     }
+                     *reinterpret_cast<FloatBig*>(pGradHess) = gradientConverted;
+                  } else {
+                     EBM_ASSERT(sizeof(FloatSmall) == cFloatBytes);
+                     FloatSmall gradientConverted = static_cast<FloatSmall>(gradient);
+                     if(nullptr != pWeightTo) {
+                        gradientConverted *= *reinterpret_cast<const FloatSmall*>(pWeightTo);
+                     }
+                     *reinterpret_cast<FloatSmall*>(pGradHess) = gradientConverted;
+                  }
+                  pGradHess = IndexByte(pGradHess, cFloatBytes);
+               } else {
+                  if(bClassification) {
+                     if(sizeof(UIntBig) == cUIntBytes) {
+                        *reinterpret_cast<UIntBig*>(pTargetTo) = static_cast<UIntBig>(targetClass);
+                     } else {
+                        EBM_ASSERT(sizeof(UIntSmall) == cUIntBytes);
+                        *reinterpret_cast<UIntSmall*>(pTargetTo) = static_cast<UIntSmall>(targetClass);
+                     }
+                     pTargetTo = IndexByte(pTargetTo, cUIntBytes);
+                  } else {
+                     if(sizeof(FloatBig) == cFloatBytes) {
+                        *reinterpret_cast<FloatBig*>(pTargetTo) = static_cast<FloatBig>(targetValue);
+                     } else {
+                        EBM_ASSERT(sizeof(FloatSmall) == cFloatBytes);
+                        *reinterpret_cast<FloatSmall*>(pTargetTo) = static_cast<FloatSmall>(targetValue);
+                     }
+                     pTargetTo = IndexByte(pTargetTo, cFloatBytes);
+                  }
 
-   const BagEbm* pSampleReplication = aBag;
+                  size_t iScore = 0;
+                  do {
+                     double initScore = 0.0;
+                     if(nullptr != aIntercept) {
+                        initScore = aIntercept[iScore];
+                     }
+                     if(nullptr != pInitScoreFromOld) {
+                        initScore += pInitScoreFromOld[iScore];
+                     }
 
-   double totalWeight = 0.0;
+                     if(sizeof(FloatBig) == cFloatBytes) {
+                        reinterpret_cast<FloatBig*>(pSampleScoreTo)[iScore * cSIMDPack + iPartition] =
+                              static_cast<FloatBig>(initScore);
+                     } else {
+                        EBM_ASSERT(sizeof(FloatSmall) == cFloatBytes);
+                        reinterpret_cast<FloatSmall*>(pSampleScoreTo)[iScore * cSIMDPack + iPartition] =
+                              static_cast<FloatSmall>(initScore);
+                     }
+                     ++iScore;
+                  } while(cScores != iScore);
+               }
 
-   BagEbm replication = 0;
-   double weight;
-   do {
-      const size_t cSubsetSamples = pSubset->m_cSamples;
-      EBM_ASSERT(1 <= cSubsetSamples);
+               if(nullptr != pWeightTo) {
+                  pWeightTo = IndexByte(pWeightTo, cFloatBytes);
+               }
 
-      if(IsMultiplyError(pSubset->m_pObjective->m_cFloatBytes, cSubsetSamples)) {
-         LOG_0(Trace_Warning,
-               "WARNING DataSetInteraction::InitWeights IsMultiplyError(pSubset->m_pObjective->m_cFloatBytes, "
-               "cSubsetSamples)");
-         return Error_OutOfMemory;
-      }
-      const size_t cBytes = pSubset->m_pObjective->m_cFloatBytes * cSubsetSamples;
-      void* pWeightTo = AlignedAlloc(cBytes);
-      if(nullptr == pWeightTo) {
-         LOG_0(Trace_Warning, "WARNING DataSetInteraction::InitWeights nullptr == pWeightTo");
-         return Error_OutOfMemory;
-      }
-      pSubset->m_aWeights = pWeightTo;
+               ++iPartition;
+            } while(cSIMDPack != iPartition);
 
-      const void* const pWeightsToEnd = IndexByte(pWeightTo, cBytes);
-      // add the weights in 2 stages to preserve precision
-      double subsetWeight = 0.0;
-      do {
-         if(BagEbm{0} == replication) {
-            replication = 1;
-            if(nullptr != pSampleReplication) {
-               do {
-                  replication = *pSampleReplication;
-                  ++pSampleReplication;
-                  ++pWeightFrom;
-               } while(replication <= BagEbm{0});
-               --pWeightFrom;
+            AdvanceFeatureStreams(aStreams, pStreamsEnd, cUIntBytes * cSIMDPack);
+            if(!bRmse) {
+               pSampleScoreTo = IndexByte(pSampleScoreTo, cScores * cFloatBytes * cSIMDPack);
             }
 
-            weight = static_cast<double>(*pWeightFrom);
-            ++pWeightFrom;
-
-            // these were checked when creating the shared dataset
-            EBM_ASSERT(!std::isnan(weight));
-            EBM_ASSERT(!std::isinf(weight));
-            EBM_ASSERT(static_cast<double>(std::numeric_limits<float>::min()) <= weight);
-            EBM_ASSERT(weight <= static_cast<double>(std::numeric_limits<float>::max()));
-         }
+            ++iParallel;
+         } while(cParallelSamples != iParallel);
 
-         subsetWeight += weight;
+         totalWeight += subsetWeight;
 
-         if(sizeof(FloatBig) == pSubset->m_pObjective->m_cFloatBytes) {
-            *reinterpret_cast<FloatBig*>(pWeightTo) = static_cast<FloatBig>(weight);
-         } else {
-            EBM_ASSERT(sizeof(FloatSmall) == pSubset->m_pObjective->m_cFloatBytes);
-            *reinterpret_cast<FloatSmall*>(pWeightTo) = static_cast<FloatSmall>(weight);
+         if(!bRmse) {
+            data.m_cSamples = cSubsetSamples;
+            data.m_aGradientsAndHessians = pSubset->m_aGradHess;
+            data.m_metricOut = 0.0;
+            error = pSubset->ObjectiveApplyUpdate(&data);
+            if(Error_None != error) {
+               goto free_all;
+            }
+            MultiplyGradHessByWeights(bHessian ? cScores << 1 : cScores, pSubset);
          }
-         pWeightTo = IndexByte(pWeightTo, pSubset->m_pObjective->m_cFloatBytes);
 
-         --replication;
-      } while(pWeightsToEnd != pWeightTo);
-
-      totalWeight += subsetWeight;
+         ++pSubset;
+      } while(pSubsetsEnd != pSubset);
+      EBM_ASSERT(0 == replication);
 
-      ++pSubset;
-   } while(pSubsetsEnd != pSubset);
-   EBM_ASSERT(0 == replication);
+      if(nullptr != pWeightFrom) {
+         EBM_ASSERT(!std::isnan(totalWeight));
+         EBM_ASSERT(std::numeric_limits<double>::min() <= totalWeight);
 
-   EBM_ASSERT(!std::isnan(totalWeight));
-   EBM_ASSERT(std::numeric_limits<double>::min() <= totalWeight);
+         if(std::isinf(totalWeight)) {
+            LOG_0(Trace_Warning, "WARNING DataSetInteraction::InitSamples std::isinf(totalWeight)");
+            error = Error_UserParamVal;
+            goto free_all;
+         }
 
-   if(std::isinf(totalWeight)) {
-      LOG_0(Trace_Warning, "WARNING DataSetInteraction::InitWeights std::isinf(totalWeight)");
-      return Error_UserParamVal;
+         m_weightTotal = totalWeight;
+      }
    }
 
-   m_weightTotal = totalWeight;
+free_all:
+   AlignedFree(data.m_aMulticlassMidwayTemp); // nullptr ok
+   AlignedFree(const_cast<void*>(data.m_aTargets)); // nullptr ok
+   AlignedFree(const_cast<void*>(data.m_aUpdateTensorScores)); // nullptr ok
+   AlignedFree(data.m_aSampleScores); // nullptr ok
+   free(aStreams);
 
-   LOG_0(Trace_Info, "Exited DataSetInteraction::InitWeights");
-   return Error_None;
+   LOG_0(Trace_Info, "Exited DataSetInteraction::InitSamples");
+   return error;
 }
 WARNING_POP
 
 ErrorEbm DataSetInteraction::InitDataSetInteraction(const bool bAllocateHessians,
+      const bool bRmse,
+      const BoolEbm bUseApprox,
       const size_t cScores,
       const size_t cSubsetItemsMax,
       const ObjectiveWrapper* const pObjectiveCpu,
@@ -383,6 +719,8 @@ ErrorEbm DataSetInteraction::InitDataSetInteraction(const bool bAllocateHessians
       const unsigned char* const pDataSetShared,
       const size_t cSharedSamples,
       const BagEbm* const aBag,
+      const double* const aIntercept,
+      const double* const aInitScores,
       const size_t cIncludedSamples,
       const size_t cWeights,
       const size_t cFeatures) {
@@ -504,19 +842,20 @@ ErrorEbm DataSetInteraction::InitDataSetInteraction(const bool bAllocateHessians
          return error;
       }
 
-      if(0 != cFeatures) {
-         error = InitFeatureData(pDataSetShared, cSharedSamples, aBag, cFeatures);
-         if(Error_None != error) {
-            return error;
-         }
-      }
-
       m_weightTotal = static_cast<double>(cIncludedSamples); // this is the default if there are no weights
-      if(0 != cWeights) {
-         error = InitWeights(pDataSetShared, aBag);
-         if(Error_None != error) {
-            return error;
-         }
+      error = InitSamples(bAllocateHessians,
+            bRmse,
+            bUseApprox,
+            cScores,
+            pDataSetShared,
+            cSharedSamples,
+            aBag,
+            aIntercept,
+            aInitScores,
+            cWeights,
+            cFeatures);
+      if(Error_None != error) {
+         return error;
       }
    }
 
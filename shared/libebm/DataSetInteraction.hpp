@@ -99,6 +99,8 @@ struct DataSetInteraction final {
    }
 
    ErrorEbm InitDataSetInteraction(const bool bAllocateHessians,
+         const bool bRmse,
+         const BoolEbm bUseApprox,
          const size_t cScores,
          const size_t cSubsetItemsMax,
          const ObjectiveWrapper* const pObjectiveCpu,
@@ -106,6 +108,8 @@ struct DataSetInteraction final {
          const unsigned char* const pDataSetShared,
          const size_t cSharedSamples,
          const BagEbm* const aBag,
+         const double* const aIntercept,
+         const double* const aInitScores,
          const size_t cIncludedSamples,
          const size_t cWeights,
          const size_t cFeatures);
@@ -123,13 +127,18 @@ struct DataSetInteraction final {
  private:
    ErrorEbm InitGradHess(const bool bAllocateHessians, const size_t cScores);
 
-   ErrorEbm InitFeatureData(const unsigned char* const pDataSetShared,
+   ErrorEbm InitSamples(const bool bHessian,
+         const bool bRmse,
+         const BoolEbm bUseApprox,
+         const size_t cScores,
+         const unsigned char* const pDataSetShared,
          const size_t cSharedSamples,
          const BagEbm* const aBag,
+         const double* const aIntercept,
+         const double* const aInitScores,
+         const size_t cWeights,
          const size_t cFeatures);
 
-   ErrorEbm InitWeights(const unsigned char* const pDataSetShared, const BagEbm* const aBag);
-
    size_t m_cSamples;
    size_t m_cSubsets;
    DataSubsetInteraction* m_aSubsets;
@@ -24,6 +24,13 @@ NEVER_INLINE extern ErrorEbm GetObjective(const Config* const pConfig,
       ObjectiveWrapper* const pCpuObjectiveWrapperOut,
       ObjectiveWrapper* const pSIMDObjectiveWrapperOut) noexcept;
 
+extern ErrorEbm ApplyInverseLinkZone(const AccelerationFlags acceleration,
+      const LinkEbm link,
+      const double linkParam,
+      const size_t cScores,
+      const size_t cSamples,
+      double* const aScores) noexcept;
+
 EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION DetermineTask(const char* objective, TaskEbm* taskOut) {
    LOG_N(Trace_Info,
          "Entered DetermineTask: "
@@ -179,6 +186,93 @@ EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION DetermineLinkFunction(LinkFlags fla
    return Error_None;
 }
 
+EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION InverseLink(AccelerationFlags acceleration,
+      LinkEbm link,
+      double linkParam,
+      IntEbm countSamples,
+      IntEbm countScores,
+      double* scoresInOut) {
+   LOG_N(Trace_Info,
+         "Entered InverseLink: "
+         "acceleration=0x%" UAccelerationFlagsPrintf ", "
+         "link=%" LinkEbmPrintf ", "
+         "linkParam=%le, "
+         "countSamples=%" IntEbmPrintf ", "
+         "countScores=%" IntEbmPrintf ", "
+         "scoresInOut=%p",
+         static_cast<UAccelerationFlags>(acceleration), // signed to unsigned conversion is defined behavior in C++
+         link,
+         linkParam,
+         countSamples,
+         countScores,
+         static_cast<void*>(scoresInOut));
+
+   if(countSamples < IntEbm{0} || IsConvertError<size_t>(countSamples)) {
+      LOG_0(Trace_Error, "ERROR InverseLink countSamples must be a non-negative size_t");
+      return Error_IllegalParamVal;
+   }
+   const size_t cSamples = static_cast<size_t>(countSamples);
+   if(countScores < IntEbm{1} || IsConvertError<size_t>(countScores)) {
+      LOG_0(Trace_Error, "ERROR InverseLink countScores must be a positive size_t");
+      return Error_IllegalParamVal;
+   }
+   const size_t cScores = static_cast<size_t>(countScores);
+   if(IsMultiplyError(sizeof(*scoresInOut), cSamples, cScores)) {
+      LOG_0(Trace_Error, "ERROR InverseLink IsMultiplyError(sizeof(*scoresInOut), cSamples, cScores)");
+      return Error_IllegalParamVal;
+   }
+   if(size_t{0} == cSamples) {
+      return Error_None;
+   }
+   if(nullptr == scoresInOut) {
+      LOG_0(Trace_Error, "ERROR InverseLink scoresInOut cannot be nullptr");
+      return Error_IllegalParamVal;
+   }
+   if((Link_logit == link || Link_probit == link || Link_cloglog == link || Link_loglog == link ||
+            Link_cauchit == link) &&
+         size_t{1} != cScores) {
+      LOG_0(Trace_Error, "ERROR InverseLink binary classification links require countScores of 1");
+      return Error_IllegalParamVal;
+   }
+
+   const size_t c = cSamples * cScores;
+   ErrorEbm error = Error_None;
+   switch(link) {
+   case Link_probit:
+      // erfc and atan aren't among our zone primitives, and these models are rare enough that scalar loops are fine
+      for(size_t i = 0; i < c; ++i) {
+         scoresInOut[i] = 0.5 * std::erfc(scoresInOut[i] * -0.70710678118654752440);
+      }
+      break;
+   case Link_cauchit:
+      for(size_t i = 0; i < c; ++i) {
+         scoresInOut[i] = 0.5 + std::atan(scoresInOut[i]) * 0.31830988618379067154;
+      }
+      break;
+   case Link_power:
+   case Link_identity:
+   case Link_logit:
+   case Link_vlogit:
+   case Link_mlogit:
+   case Link_cloglog:
+   case Link_loglog:
+   case Link_log:
+   case Link_inverse:
+   case Link_inverse_square:
+   case Link_sqrt:
+      error = ApplyInverseLinkZone(acceleration, link, linkParam, cScores, cSamples, scoresInOut);
+      break;
+   default:
+      LOG_0(Trace_Error, "ERROR InverseLink link has no native inverse");
+      error = Error_IllegalParamVal;
+      break;
+   }
+
+   LOG_0(Trace_Info, "Exited InverseLink");
+
+   return error;
+}
+
 static const char g_sCustomRegression[] = "custom_regression";
 static const char g_sCustomRanking[] = "custom_ranking";
 static const char g_sMonoClassification[] = "monoclassification";
@@ -1075,4 +1075,199 @@ exit_with_log:;
    return error;
 }
 
+// the integer table holds one bin per integer between the first and last cut.  We only build it when it's no larger
+// than this and no larger than the number of samples, otherwise filling it could cost more than the searches it saves
+static constexpr size_t k_cIntegerTableMax = 4096;
+// the recent value cache is direct mapped.  It's a power of 2 and small enough to stay in L1 alongside the cuts
+static constexpr size_t k_cBitsRecentCache = 8;
+static constexpr size_t k_cRecentCache = size_t{1} << k_cBitsRecentCache;
+// below this many cuts the unrolled branchless comparisons in Discretize beat any table lookup
+static constexpr IntEbm k_cCutsMinCache = 7;
+
+struct RecentCacheEntry final {
+   double m_val;
+   IntEbm m_iBin;
+};
+static_assert(std::is_standard_layout<RecentCacheEntry>::value,
+      "We use the struct hack in several places, so disallow non-standard_layout types in general");
+static_assert(std::is_trivial<RecentCacheEntry>::value,
+      "We use memcpy in several places, so disallow non-trivial types in general");
+
+INLINE_ALWAYS static size_t HashRecentCache(const double val) {
+   uint64_t bits;
+   static_assert(sizeof(bits) == sizeof(val), "double must be 64 bits");
+   memcpy(&bits, &val, sizeof(val));
+   // fibonacci hashing.  The top bits of the product depend on all the bits of the double, which matters since
+   // integer valued doubles have all their entropy in the upper mantissa and exponent bits
+   return static_cast<size_t>((bits * uint64_t{0x9E3779B97F4A7C15}) >> (64 - k_cBitsRecentCache));
+}
+
+static int g_cLogEnterDiscretizeCached = 25;
+static int g_cLogExitDiscretizeCached = 25;
+
+EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION DiscretizeCached(IntEbm countSamples,
+      const double* featureVals,
+      IntEbm countCuts,
+      const double* cutsLowerBoundInclusive,
+      IntEbm* binIndexesOut,
+      IntEbm* countCacheHitsOut) {
+   // Production columns often have a few hundred distinct values repeated millions of times.  This function returns
+   // exactly what Discretize returns, but for each call (which is one feature) it keeps a perfect table for
+   // integer valued samples within the span of the cuts and a direct mapped cache of recently seen exact values,
+   // so repeated values skip the binary search.  countCacheHitsOut receives the number of samples resolved from
+   // either table so that callers can confirm the cache pays off on their data.
+
+   LOG_COUNTED_N(&g_cLogEnterDiscretizeCached,
+         Trace_Info,
+         Trace_Verbose,
+         "Entered DiscretizeCached: "
+         "countSamples=%" IntEbmPrintf ", "
+         "featureVals=%p, "
+         "countCuts=%" IntEbmPrintf ", "
+         "cutsLowerBoundInclusive=%p, "
+         "binIndexesOut=%p, "
+         "countCacheHitsOut=%p",
+         countSamples,
+         static_cast<const void*>(featureVals),
+         countCuts,
+         static_cast<const void*>(cutsLowerBoundInclusive),
+         static_cast<void*>(binIndexesOut),
+         static_cast<void*>(countCacheHitsOut));
+
+   ErrorEbm error;
+   size_t cHits = 0;
+
+   if(countCuts < k_cCutsMinCache || countSamples <= IntEbm{0} ||
+         std::numeric_limits<IntEbm>::max() - IntEbm{2} < countCuts || IsConvertError<size_t>(countSamples) ||
+         IsConvertError<size_t>(countCuts)) {
+      // Discretize is faster than the cache for small numbers of cuts, and it handles all our illegal inputs
+      error = Discretize(countSamples, featureVals, countCuts, cutsLowerBoundInclusive, binIndexesOut);
+      goto exit_with_log;
+   }
+
+   {
+      const size_t cSamples = static_cast<size_t>(countSamples);
+      const size_t cCuts = static_cast<size_t>(countCuts);
+
+      if(IsMultiplyError(sizeof(double), cSamples) || IsMultiplyError(sizeof(*binIndexesOut), cSamples) ||
+            IsMultiplyError(sizeof(*cutsLowerBoundInclusive), cCuts) ||
+            size_t{std::numeric_limits<ptrdiff_t>::max()} < cCuts ||
+            std::numeric_limits<size_t>::max() / size_t{2} + size_t{1} < cCuts) {
+         error = Discretize(countSamples, featureVals, countCuts, cutsLowerBoundInclusive, binIndexesOut);
+         goto exit_with_log;
+      }
+
+      if(UNLIKELY(nullptr == featureVals)) {
+         LOG_0(Trace_Error, "ERROR DiscretizeCached featureVals cannot be null");
+         error = Error_IllegalParamVal;
+         goto exit_with_log;
+      }
+
+      if(UNLIKELY(nullptr == binIndexesOut)) {
+         LOG_0(Trace_Error, "ERROR DiscretizeCached binIndexesOut cannot be null");
+         error = Error_IllegalParamVal;
+         goto exit_with_log;
+      }
+
+      if(UNLIKELY(nullptr == cutsLowerBoundInclusive)) {
+         LOG_0(Trace_Error, "ERROR DiscretizeCached cutsLowerBoundInclusive cannot be null");
+         error = Error_IllegalParamVal;
+         goto exit_with_log;
+      }
+
+      const double cutLow = cutsLowerBoundInclusive[0];
+      const double cutHigh = cutsLowerBoundInclusive[cCuts - size_t{1}];
+      const IntEbm iBinHigh = countCuts + IntEbm{1};
+
+      // integers in [intLow, intHigh] are strictly inside the cuts.  Anything outside resolves with one comparison
+      const double intLow = std::ceil(cutLow);
+      const double intHigh = std::floor(cutHigh);
+      IntEbm* aIntegerBins = nullptr;
+      if(intLow <= intHigh && intHigh - intLow < static_cast<double>(k_cIntegerTableMax) &&
+            intHigh - intLow < static_cast<double>(cSamples)) {
+         const size_t cIntegers = static_cast<size_t>(intHigh - intLow) + size_t{1};
+         aIntegerBins = static_cast<IntEbm*>(malloc(sizeof(*aIntegerBins) * cIntegers));
+         if(UNLIKELY(nullptr == aIntegerBins)) {
+            LOG_0(Trace_Warning, "WARNING DiscretizeCached nullptr == aIntegerBins");
+            error = Error_OutOfMemory;
+            goto exit_with_log;
+         }
+         // sweep the integers and the cuts together, which is cheaper than a search per integer
+         size_t iCut = 0;
+         for(size_t iInteger = 0; iInteger < cIntegers; ++iInteger) {
+            const double val = intLow + static_cast<double>(iInteger);
+            while(iCut < cCuts && cutsLowerBoundInclusive[iCut] <= val) {
+               ++iCut;
+            }
+            aIntegerBins[iInteger] = static_cast<IntEbm>(iCut + size_t{1});
+            EBM_ASSERT(aIntegerBins[iInteger] == DiscretizeOneSample(val, countCuts, cutsLowerBoundInclusive));
+         }
+      }
+
+      RecentCacheEntry aRecent[k_cRecentCache];
+      for(size_t iRecent = 0; iRecent < k_cRecentCache; ++iRecent) {
+         // NaN never compares equal, so empty slots always miss
+         aRecent[iRecent].m_val = std::numeric_limits<double>::quiet_NaN();
+         aRecent[iRecent].m_iBin = IntEbm{0};
+      }
+
+      const double* pVal = featureVals;
+      const double* const pValsEnd = featureVals + cSamples;
+      IntEbm* piBin = binIndexesOut;
+      do {
+         const double val = *pVal;
+         IntEbm iBin;
+         if(PREDICTABLE(std::isnan(val))) {
+            iBin = IntEbm{0};
+         } else if(val < cutLow) {
+            iBin = IntEbm{1};
+         } else if(cutHigh <= val) {
+            iBin = iBinHigh;
+         } else {
+            // val - intLow rounds, so a non-integer like 1 + 2^-52 can land on a whole offset.  Only integers are
+            // looked up, and both val and intLow are integers within the table span so their difference is exact
+            if(nullptr != aIntegerBins && std::floor(val) == val && intLow <= val && val <= intHigh) {
+               iBin = aIntegerBins[static_cast<size_t>(val - intLow)];
+               ++cHits;
+            } else {
+               RecentCacheEntry* const pRecent = &aRecent[HashRecentCache(val)];
+               if(pRecent->m_val == val) {
+                  iBin = pRecent->m_iBin;
+                  ++cHits;
+               } else {
+                  iBin = DiscretizeOneSample(val, countCuts, cutsLowerBoundInclusive);
+                  pRecent->m_val = val;
+                  pRecent->m_iBin = iBin;
+               }
+            }
+         }
+         EBM_ASSERT(iBin == DiscretizeOneSample(val, countCuts, cutsLowerBoundInclusive));
+         *piBin = iBin;
+         ++piBin;
+         ++pVal;
+      } while(LIKELY(pValsEnd != pVal));
+
+      free(aIntegerBins);
+      error = Error_None;
+   }
+
+exit_with_log:;
+
+   if(nullptr != countCacheHitsOut) {
+      EBM_ASSERT(!IsConvertError<IntEbm>(cHits));
+      *countCacheHitsOut = static_cast<IntEbm>(cHits);
+   }
+
+   LOG_COUNTED_N(&g_cLogExitDiscretizeCached,
+         Trace_Info,
+         Trace_Verbose,
+         "Exited DiscretizeCached: "
+         "countCacheHits=%zu, "
+         "return=%" ErrorEbmPrintf,
+         cHits,
+         error);
+
+   return error;
+}
+
 } // namespace DEFINED_ZONE_NAME
@@ -27,9 +27,11 @@
 #include "Feature.hpp"
 #include "Term.hpp"
 #include "Tensor.hpp"
+#include "TensorTotalsSum.hpp" // MonotoneDimension
 #include "TreeNodeMulti.hpp"
 #include "BoosterCore.hpp"
 #include "BoosterShell.hpp"
+#include "api_recording.hpp"
 
 namespace DEFINED_ZONE_NAME {
 #ifndef DEFINED_ZONE_NAME
@@ -113,6 +115,8 @@ extern ErrorEbm PartitionMultiDimensionalTree(const bool bHessian,
       Tensor* const pInnerTermUpdate,
       void* const pRootTreeNodeBase,
       const size_t* const acBins,
+      const MonotoneDimension* const aMonotoneDimensions,
+      FloatCalc* const aGainBounds,
       double* const aTensorWeights,
       double* const aTensorGrad,
       double* const aTensorHess,
@@ -139,6 +143,58 @@ extern ErrorEbm PartitionMultiDimensionalCorner(const bool bHessian,
       BinBase* const aAuxiliaryBinsBase,
       Tensor* const pInnerTermUpdate,
       const size_t* const acBins,
+      const MonotoneDimension* const aMonotoneDimensions,
+      double* const pTotalGain
+#ifndef NDEBUG
+      ,
+      const BinBase* const aDebugCopyBinsBase,
+      const BinBase* const pBinsEndDebug
+#endif // NDEBUG
+);
+
+extern ErrorEbm PartitionMultiDimensionalStraightBoosting(const bool bHessian,
+      const size_t cRuntimeScores,
+      const size_t cRealDimensions,
+      const TermBoostFlags flags,
+      const size_t cSamplesLeafMin,
+      const FloatCalc hessianMin,
+      const FloatCalc regAlpha,
+      const FloatCalc regLambda,
+      const FloatCalc deltaStepMax,
+      const BinBase* const aBinsBase,
+      BinBase* const aAuxiliaryBinsBase,
+      Tensor* const pInnerTermUpdate,
+      const size_t* const acBins,
+      const IntEbm* const aLeavesMax,
+      const MonotoneDimension* const aMonotoneDimensions,
+      double* const pTotalGain
+#ifndef NDEBUG
+      ,
+      const BinBase* const aDebugCopyBinsBase,
+      const BinBase* const pBinsEndDebug
+#endif // NDEBUG
+);
+
+extern ErrorEbm PartitionMultiDimensionalDeep(BoosterShell* const pBoosterShell,
+      const bool bHessian,
+      const size_t cRuntimeScores,
+      const size_t cDimensions,
+      const size_t cRealDimensions,
+      const TermBoostFlags flags,
+      const size_t cSamplesLeafMin,
+      const FloatCalc hessianMin,
+      const FloatCalc regAlpha,
+      const FloatCalc regLambda,
+      const FloatCalc deltaStepMax,
+      const BinBase* const aBinsBase,
+      BinBase* const aAuxiliaryBinsBase,
+      Tensor* const pInnerTermUpdate,
+      const size_t* const acBins,
+      const IntEbm* const aLeavesMax,
+      const MonotoneDimension* const aMonotoneDimensions,
+      double* const aTensorWeights,
+      double* const aTensorGrad,
+      double* const aTensorHess,
       double* const pTotalGain
 #ifndef NDEBUG
       ,
@@ -154,6 +210,8 @@ extern ErrorEbm PartitionRandomBoosting(RandomDeterministic* const pRng,
       const FloatCalc regAlpha,
       const FloatCalc regLambda,
       const FloatCalc deltaStepMax,
+      const size_t cSamplesLeafMin,
+      const size_t cRandomRetries,
       const IntEbm* const aLeavesMax,
       const MonotoneDirection monotoneDirection,
       double* const pTotalGain);
@@ -295,6 +353,8 @@ static ErrorEbm BoostMultiDimensional(BoosterShell* const pBoosterShell,
       const FloatCalc regAlpha,
       const FloatCalc regLambda,
       const FloatCalc deltaStepMax,
+      const IntEbm* const aLeavesMax,
+      const MonotoneDimension* const aMonotoneDimensions,
       double* const pTotalGain) {
    LOG_0(Trace_Verbose, "Entered BoostMultiDimensional");
 
@@ -390,7 +450,41 @@ static ErrorEbm BoostMultiDimensional(BoosterShell* const pBoosterShell,
       ++pTermFeature;
    } while(pTermFeaturesEnd != pTermFeature);
 
-   if(!(flags & TermBoostFlags_Corners)) {
+   if(0 != (TermBoostFlags_Straight & flags) && 2 == cRealDimensions) {
+      // the same straight cut search that scores pairs during interaction detection
+      error = PartitionMultiDimensionalStraightBoosting(bHessian,
+            cRuntimeScores,
+            cRealDimensions,
+            flags,
+            cSamplesLeafMin,
+            hessianMin,
+            regAlpha,
+            regLambda,
+            deltaStepMax,
+            pBoosterShell->GetBoostingMainBins(),
+            aAuxiliaryBins,
+            pBoosterShell->GetInnerTermUpdate(),
+            acBins2,
+            aLeavesMax,
+            aMonotoneDimensions,
+            pTotalGain
+#ifndef NDEBUG
+            ,
+            aDebugCopyBins,
+            pBoosterShell->GetDebugMainBinsEnd()
+#endif // NDEBUG
+      );
+
+      if(Error_None != error) {
+#ifndef NDEBUG
+         free(aDebugCopyBins);
+#endif // NDEBUG
+
+         LOG_0(Trace_Verbose, "Exited BoostMultiDimensional with Error code");
+
+         return error;
+      }
+   } else if(!(flags & TermBoostFlags_Corners)) {
       double* aWeights = nullptr;
       double* pGradient = nullptr;
       double* pHessian = nullptr;
@@ -423,97 +517,136 @@ static ErrorEbm BoostMultiDimensional(BoosterShell* const pBoosterShell,
          }
       }
 
-      if(IsOverflowTreeNodeMultiSize(bHessian, cRuntimeScores)) {
-         // TODO: move this to init
-         return Error_OutOfMemory;
-      }
-
-      size_t cPossibleSplits = 0;
-      size_t cBytes = 1;
-
-      pTermFeature = pTerm->GetTermFeatures();
-      do {
-         const FeatureBoosting* pFeature = pTermFeature->m_pFeature;
-         const size_t cBins = pFeature->GetCountBins();
-         EBM_ASSERT(size_t{1} <= cBins); // we don't boost on empty training sets
-         const size_t cSplits = cBins - 1;
-         if(IsAddError(cPossibleSplits, cSplits)) {
+      if(0 != (TermBoostFlags_DeepTree & flags)) {
+         // best-first greedy tree whose size is set by aLeavesMax instead of the number of dimensions
+         error = PartitionMultiDimensionalDeep(pBoosterShell,
+               bHessian,
+               cRuntimeScores,
+               pTerm->GetCountDimensions(),
+               cRealDimensions,
+               flags,
+               cSamplesLeafMin,
+               hessianMin,
+               regAlpha,
+               regLambda,
+               deltaStepMax,
+               pBoosterShell->GetBoostingMainBins(),
+               aAuxiliaryBins,
+               pBoosterShell->GetInnerTermUpdate(),
+               acBins2,
+               aLeavesMax,
+               aMonotoneDimensions,
+               aWeights,
+               pGradient,
+               pHessian,
+               pTotalGain
+#ifndef NDEBUG
+               ,
+               aDebugCopyBins,
+               pBoosterShell->GetDebugMainBinsEnd()
+#endif // NDEBUG
+         );
+      } else {
+         if(IsOverflowTreeNodeMultiSize(bHessian, cRuntimeScores)) {
+            // TODO: move this to init
             return Error_OutOfMemory;
          }
-         cPossibleSplits += cSplits;
-         if(IsMultiplyError(cBins, cBytes)) {
+
+         size_t cPossibleSplits = 0;
+         size_t cBytes = 1;
+
+         pTermFeature = pTerm->GetTermFeatures();
+         do {
+            const FeatureBoosting* pFeature = pTermFeature->m_pFeature;
+            const size_t cBins = pFeature->GetCountBins();
+            EBM_ASSERT(size_t{1} <= cBins); // we don't boost on empty training sets
+            const size_t cSplits = cBins - 1;
+            if(IsAddError(cPossibleSplits, cSplits)) {
+               return Error_OutOfMemory;
+            }
+            cPossibleSplits += cSplits;
+            if(IsMultiplyError(cBins, cBytes)) {
+               return Error_OutOfMemory;
+            }
+            cBytes *= cBins;
+            ++pTermFeature;
+         } while(pTermFeaturesEnd != pTermFeature);
+
+         // For pairs, this calculates the exact max number of splits. For higher dimensions
+         // the max number of splits will be less, but it should be close enough.
+         // Each bin gets a tree node to record the gradient totals, and each split gets a TreeNode
+         // during construction. Each split contains a minimum of 1 bin on each side, so we have
+         // cBins - 1 potential splits.
+
+         if(IsAddError(cBytes, cBytes - 1)) {
             return Error_OutOfMemory;
          }
-         cBytes *= cBins;
-         ++pTermFeature;
-      } while(pTermFeaturesEnd != pTermFeature);
-
-      // For pairs, this calculates the exact max number of splits. For higher dimensions
-      // the max number of splits will be less, but it should be close enough.
-      // Each bin gets a tree node to record the gradient totals, and each split gets a TreeNode
-      // during construction. Each split contains a minimum of 1 bin on each side, so we have
-      // cBins - 1 potential splits.
-
-      if(IsAddError(cBytes, cBytes - 1)) {
-         return Error_OutOfMemory;
-      }
-      cBytes = cBytes + cBytes - 1;
+         cBytes = cBytes + cBytes - 1;
 
-      const size_t cBytesTreeNodeMulti = GetTreeNodeMultiSize(bHessian, cRuntimeScores);
+         const size_t cBytesTreeNodeMulti = GetTreeNodeMultiSize(bHessian, cRuntimeScores);
 
-      if(IsMultiplyError(cBytesTreeNodeMulti, cBytes)) {
-         return Error_OutOfMemory;
-      }
-      cBytes *= cBytesTreeNodeMulti;
+         if(IsMultiplyError(cBytesTreeNodeMulti, cBytes)) {
+            return Error_OutOfMemory;
+         }
+         cBytes *= cBytesTreeNodeMulti;
 
-      const size_t cBytesBest = cBytesTreeNodeMulti * (size_t{1} + (cRealDimensions << 1));
-      EBM_ASSERT(cBytesBest <= cBytes);
+         const size_t cBytesBest = cBytesTreeNodeMulti * (size_t{1} + (cRealDimensions << 1));
+         EBM_ASSERT(cBytesBest <= cBytes);
 
-      // double it because we during the multi-dimensional sweep we need the best and we need the current
-      if(IsAddError(cBytesBest, cBytesBest)) {
-         return Error_OutOfMemory;
-      }
-      const size_t cBytesSweep = cBytesBest + cBytesBest;
-
-      cBytes = EbmMax(cBytes, cBytesSweep);
+         // double it because we during the multi-dimensional sweep we need the best and we need the current
+         if(IsAddError(cBytesBest, cBytesBest)) {
+            return Error_OutOfMemory;
+         }
+         const size_t cBytesSweep = cBytesBest + cBytesBest;
 
-      error = pBoosterShell->ReserveTreeNodesTemp(cBytes);
-      if(Error_None != error) {
-         return error;
-      }
+         cBytes = EbmMax(cBytes, cBytesSweep);
 
-      error = pBoosterShell->ReserveTemp1(cPossibleSplits * sizeof(unsigned char));
-      if(Error_None != error) {
-         return error;
-      }
+         error = pBoosterShell->ReserveTreeNodesTemp(cBytes);
+         if(Error_None != error) {
+            return error;
+         }
 
-      error = PartitionMultiDimensionalTree(bHessian,
-            cRuntimeScores,
-            pTerm->GetCountDimensions(),
-            cRealDimensions,
-            flags,
-            cSamplesLeafMin,
-            hessianMin,
-            regAlpha,
-            regLambda,
-            deltaStepMax,
-            pBoosterShell->GetBoostingMainBins(),
-            aAuxiliaryBins,
-            pBoosterShell->GetInnerTermUpdate(),
-            pBoosterShell->GetTreeNodeMultiTemp(),
-            acBins2,
-            aWeights,
-            pGradient,
-            pHessian,
-            pTotalGain,
-            cPossibleSplits,
-            pBoosterShell->GetTemp1()
+         // Temp1 holds the cumulative gain bounds used to prune the sweep, followed by the split flags
+         if(IsMultiplyError(sizeof(FloatCalc), cTensorBins) ||
+               IsAddError(sizeof(FloatCalc) * cTensorBins, cPossibleSplits * sizeof(unsigned char))) {
+            return Error_OutOfMemory;
+         }
+         error = pBoosterShell->ReserveTemp1(sizeof(FloatCalc) * cTensorBins + cPossibleSplits * sizeof(unsigned char));
+         if(Error_None != error) {
+            return error;
+         }
+         FloatCalc* const aGainBounds = static_cast<FloatCalc*>(pBoosterShell->GetTemp1());
+
+         error = PartitionMultiDimensionalTree(bHessian,
+               cRuntimeScores,
+               pTerm->GetCountDimensions(),
+               cRealDimensions,
+               flags,
+               cSamplesLeafMin,
+               hessianMin,
+               regAlpha,
+               regLambda,
+               deltaStepMax,
+               pBoosterShell->GetBoostingMainBins(),
+               aAuxiliaryBins,
+               pBoosterShell->GetInnerTermUpdate(),
+               pBoosterShell->GetTreeNodeMultiTemp(),
+               acBins2,
+               aMonotoneDimensions,
+               aGainBounds,
+               aWeights,
+               pGradient,
+               pHessian,
+               pTotalGain,
+               cPossibleSplits,
+               aGainBounds + cTensorBins
 #ifndef NDEBUG
-                  ,
-            aDebugCopyBins,
-            pBoosterShell->GetDebugMainBinsEnd()
+               ,
+               aDebugCopyBins,
+               pBoosterShell->GetDebugMainBinsEnd()
 #endif // NDEBUG
-      );
+         );
+      }
 
       if(Error_None != error) {
          free(aWeights);
@@ -529,7 +662,9 @@ static ErrorEbm BoostMultiDimensional(BoosterShell* const pBoosterShell,
       EBM_ASSERT(!std::isnan(*pTotalGain));
       EBM_ASSERT(0 <= *pTotalGain);
 
-      if(0 != (TermBoostFlags_PurifyUpdate & flags) && 0 == (TermBoostFlags_PurifyGain & flags)) {
+      // the deep tree search does not purify while choosing splits, so it always purifies the result here
+      if(0 != (TermBoostFlags_PurifyUpdate & flags) &&
+            (0 == (TermBoostFlags_PurifyGain & flags) || 0 != (TermBoostFlags_DeepTree & flags))) {
          Tensor* const pTensor = pBoosterShell->GetInnerTermUpdate();
 
          size_t cDimensions = pTerm->GetCountDimensions();
@@ -633,6 +768,7 @@ static ErrorEbm BoostMultiDimensional(BoosterShell* const pBoosterShell,
             aAuxiliaryBins,
             pBoosterShell->GetInnerTermUpdate(),
             acBins2,
+            aMonotoneDimensions,
             pTotalGain
 #ifndef NDEBUG
             ,
@@ -670,6 +806,8 @@ static ErrorEbm BoostRandom(RandomDeterministic* const pRng,
       const FloatCalc regAlpha,
       const FloatCalc regLambda,
       const FloatCalc deltaStepMax,
+      const size_t cSamplesLeafMin,
+      const size_t cRandomRetries,
       const IntEbm* const aLeavesMax,
       const MonotoneDirection monotoneDirection,
       double* const pTotalGain) {
@@ -690,6 +828,8 @@ static ErrorEbm BoostRandom(RandomDeterministic* const pRng,
          regAlpha,
          regLambda,
          deltaStepMax,
+         cSamplesLeafMin,
+         cRandomRetries,
          aLeavesMax,
          monotoneDirection,
          pTotalGain);
@@ -725,6 +865,7 @@ EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION GenerateTermUpdate(void* rng,
       double categoricalSmoothing,
       IntEbm maxCategoricalThreshold,
       double categoricalInclusionPercent,
+      IntEbm randomRetries,
       const IntEbm* leavesMax,
       const MonotoneDirection* direction,
       double* avgGainOut) {
@@ -748,6 +889,7 @@ EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION GenerateTermUpdate(void* rng,
          "categoricalSmoothing=%le, "
          "maxCategoricalThreshold=%" IntEbmPrintf ", "
          "categoricalInclusionPercent=%le, "
+         "randomRetries=%" IntEbmPrintf ", "
          "leavesMax=%p, "
          "direction=%p, "
          "avgGainOut=%p",
@@ -765,6 +907,7 @@ EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION GenerateTermUpdate(void* rng,
          categoricalSmoothing,
          maxCategoricalThreshold,
          categoricalInclusionPercent,
+         randomRetries,
          static_cast<const void*>(leavesMax),
          static_cast<const void*>(direction),
          static_cast<void*>(avgGainOut));
@@ -779,6 +922,27 @@ EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION GenerateTermUpdate(void* rng,
       return Error_IllegalParamVal;
    }
 
+   if(IsRecording()) {
+      // nothing has advanced the RNG yet, so its current state is the one to replay from
+      RecordGenerateTermUpdate(static_cast<const unsigned char*>(rng),
+            pBoosterShell,
+            indexTerm,
+            flags,
+            learningRate,
+            minSamplesLeaf,
+            minHessian,
+            regAlpha,
+            regLambda,
+            maxDeltaStep,
+            minCategorySamples,
+            categoricalSmoothing,
+            maxCategoricalThreshold,
+            categoricalInclusionPercent,
+            randomRetries,
+            leavesMax,
+            direction);
+   }
+
    // set this to illegal so if we exit with an error we have an invalid index
    pBoosterShell->SetTermIndex(BoosterShell::k_illegalTermIndex);
 
@@ -818,7 +982,8 @@ EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION GenerateTermUpdate(void* rng,
          ~(TermBoostFlags_PurifyGain | TermBoostFlags_DisableNewtonGain | TermBoostFlags_DisableCategorical |
                TermBoostFlags_PurifyUpdate | TermBoostFlags_DisableNewtonUpdate | TermBoostFlags_GradientSums |
                TermBoostFlags_RandomSplits | TermBoostFlags_Corners | TermBoostFlags_MissingLow |
-               TermBoostFlags_MissingHigh | TermBoostFlags_MissingSeparate)) {
+               TermBoostFlags_MissingHigh | TermBoostFlags_MissingSeparate | TermBoostFlags_RandomMinLeafHard |
+               TermBoostFlags_RandomMinLeafSoft | TermBoostFlags_Straight | TermBoostFlags_DeepTree)) {
       LOG_0(Trace_Error, "ERROR GenerateTermUpdate flags contains unknown flags. Ignoring extras.");
    }
 
@@ -834,6 +999,25 @@ EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION GenerateTermUpdate(void* rng,
       }
    }
 
+   if(TermBoostFlags_Corners & flags) {
+      if((TermBoostFlags_Straight | TermBoostFlags_DeepTree) & flags) {
+         LOG_0(Trace_Error, "ERROR GenerateTermUpdate flags contains multiple multi-dimensional partitioning flags.");
+         return Error_IllegalParamVal;
+      }
+   } else if(TermBoostFlags_Straight & flags) {
+      if(TermBoostFlags_DeepTree & flags) {
+         LOG_0(Trace_Error, "ERROR GenerateTermUpdate flags contains multiple multi-dimensional partitioning flags.");
+         return Error_IllegalParamVal;
+      }
+   }
+
+   if(TermBoostFlags_RandomMinLeafHard & flags) {
+      if(TermBoostFlags_RandomMinLeafSoft & flags) {
+         LOG_0(Trace_Error, "ERROR GenerateTermUpdate flags contains both RandomMinLeaf flags.");
+         return Error_IllegalParamVal;
+      }
+   }
+
    if(std::isnan(learningRate)) {
       LOG_0(Trace_Warning, "WARNING GenerateTermUpdate learningRate is NaN");
    } else if(std::numeric_limits<double>::infinity() == learningRate) {
@@ -928,6 +1112,23 @@ EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION GenerateTermUpdate(void* rng,
             "WARNING GenerateTermUpdate categoricalInclusionPercent must be a positive number between 0 and 1.");
    }
 
+   size_t cRandomRetries = size_t{1}; // this is the min value, and also what 0 means
+   if(IntEbm{1} <= randomRetries) {
+      cRandomRetries = static_cast<size_t>(randomRetries);
+      if(IsConvertError<size_t>(randomRetries)) {
+         // we could never finish this many retries anyways
+         cRandomRetries = std::numeric_limits<size_t>::max();
+      }
+   } else if(randomRetries < IntEbm{0}) {
+      LOG_0(Trace_Warning, "WARNING GenerateTermUpdate randomRetries can't be less than 0.  Adjusting to 1.");
+   }
+   if(size_t{1} != cRandomRetries && EBM_FALSE != pBoosterCore->IsDifferentialPrivacy()) {
+      // choosing the best of several cut sets looks at the gradients without any privacy accounting, which would
+      // leak beyond the privacy budget of a differentially private booster
+      LOG_0(Trace_Error, "ERROR GenerateTermUpdate randomRetries above 1 is not allowed with differential privacy");
+      return Error_IllegalParamVal;
+   }
+
    const size_t cScores = pBoosterCore->GetCountScores();
    if(size_t{0} == cScores) {
       // if there is only 1 target class for classification, then we can predict the output with 100% accuracy.
@@ -955,6 +1156,8 @@ EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION GenerateTermUpdate(void* rng,
    bool bUnseen = false;
    bool bNominal = false;
    MonotoneDirection monotoneDirection = MONOTONE_NONE;
+   bool bMonotoneNominal = false;
+   MonotoneDimension aMonotoneDimensions[k_cDimensionsMax];
    size_t iDimensionImportant = 0;
 
    size_t cRealDimensions = 0;
@@ -996,6 +1199,8 @@ EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION GenerateTermUpdate(void* rng,
                   featureDirection = *direction;
                   ++direction;
                }
+               aMonotoneDimensions[iDimensionInit].m_direction = MONOTONE_NONE;
+               aMonotoneDimensions[iDimensionInit].m_iBinOrdered = 0;
                if(size_t{1} < cBins) {
                   // if there is only 1 dimension then this is our first time here and lastDimensionLeavesMax must be
                   // zero
@@ -1008,6 +1213,12 @@ EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION GenerateTermUpdate(void* rng,
                   bUnseen = pFeature->IsUnseen();
                   bNominal = pFeature->IsNominal();
                   monotoneDirection |= featureDirection;
+                  if(MONOTONE_NONE != featureDirection) {
+                     bMonotoneNominal = bMonotoneNominal || bNominal;
+                     aMonotoneDimensions[iDimensionInit].m_direction = featureDirection;
+                     // the missing bin is unordered, so the constraint only applies from bin 1 onwards
+                     aMonotoneDimensions[iDimensionInit].m_iBinOrdered = bMissing ? size_t{1} : size_t{0};
+                  }
                   EBM_ASSERT(nullptr != pLeavesMax);
                   const IntEbm countLeavesMax = *pLeavesMax;
                   if(countLeavesMax <= IntEbm{1}) {
@@ -1099,8 +1310,11 @@ EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION GenerateTermUpdate(void* rng,
       // are going to remain having 0 splits.
       pBoosterShell->GetInnerTermUpdate()->Reset();
 
+      // Nominal features have no order to be monotone along, and random splits only enforce the constraint on
+      // single dimensional terms, so in those cases a monotone term gets a single update for the entire tensor.
       if(IntEbm{0} == lastDimensionLeavesMax ||
-            ((1 != cRealDimensions || bNominal || 1 != cScores) && MONOTONE_NONE != monotoneDirection)) {
+            ((1 == cRealDimensions ? bNominal : bMonotoneNominal || 0 != (TermBoostFlags_RandomSplits & flags)) &&
+                  MONOTONE_NONE != monotoneDirection)) {
          // this is kind of hacky where if any one of a number of things occurs (like we have only 1 leaf)
          // we sum everything into a single bin. The alternative would be to always sum into the tensor bins
          // but then collapse them afterwards into a single bin, but that's more work.
@@ -1137,6 +1351,7 @@ EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION GenerateTermUpdate(void* rng,
          DataSubsetBoosting* pSubset = pBoosterCore->GetTrainingSet()->GetSubsets();
          EBM_ASSERT(nullptr != pSubset);
          const DataSubsetBoosting* const pSubsetsEnd = pSubset + pBoosterCore->GetTrainingSet()->GetCountSubsets();
+         size_t iSubset = 0;
          do {
             int cPack;
             if(1 == cTensorBins) {
@@ -1214,7 +1429,9 @@ EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION GenerateTermUpdate(void* rng,
             params.m_cBytesFastBins = cBytesPerFastBin * cTensorBins;
             params.m_aGradientsAndHessians = pSubset->GetGradHess();
             params.m_aWeights = pSubset->GetSubsetInnerBag(iBag)->GetWeights();
-            params.m_aPacked = BoosterShell::k_interceptTermIndex == iTerm ? nullptr : pSubset->GetTermData(iTerm);
+            params.m_aPacked = BoosterShell::k_interceptTermIndex == iTerm ?
+                  nullptr :
+                  pSubset->GetTermData(iTerm, pTerm, pBoosterShell->GetTermDataScratch(iSubset));
             params.m_aFastBins = aFastBins;
 #ifndef NDEBUG
             params.m_pDebugFastBinsEnd = IndexBin(aFastBins, cBytesPerFastBin * cParallelTensorBins);
@@ -1228,6 +1445,7 @@ EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION GenerateTermUpdate(void* rng,
             const bool bDoubleSrc = sizeof(FloatBig) == pSubset->GetObjectiveWrapper()->m_cFloatBytes;
 
             ++pSubset;
+            ++iSubset;
 
             BinBase* pFastBins = aFastBins;
             for(size_t i = 0; i < cSIMDPack; ++i) {
@@ -1299,6 +1517,8 @@ EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION GenerateTermUpdate(void* rng,
                      regAlphaCalc,
                      regLambdaCalc,
                      deltaStepMax,
+                     cSamplesLeafMin,
+                     cRandomRetries,
                      leavesMax,
                      monotoneDirection,
                      &gain);
@@ -1348,6 +1568,8 @@ EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION GenerateTermUpdate(void* rng,
                      regAlphaCalc,
                      regLambdaCalc,
                      deltaStepMax,
+                     leavesMax,
+                     MONOTONE_NONE == monotoneDirection ? nullptr : aMonotoneDimensions,
                      &gain);
                if(Error_None != error) {
                   return error;
@@ -145,6 +145,8 @@ ErrorEbm InteractionCore::Create(const unsigned char* const pDataSetShared,
       const size_t cFeatures,
       const size_t cWeights,
       const BagEbm* const aBag,
+      const double* const aIntercept,
+      const double* const aInitScores,
       const CreateInteractionFlags flags,
       const AccelerationFlags acceleration,
       const char* const sObjective,
@@ -325,6 +327,8 @@ ErrorEbm InteractionCore::Create(const unsigned char* const pDataSetShared,
          const bool bHessian = pInteractionCore->IsHessian();
 
          error = pInteractionCore->m_dataFrame.InitDataSetInteraction(bHessian,
+               pInteractionCore->IsRmse(),
+               pInteractionCore->IsUseApprox(),
                cScores,
                bForceMultipleSubsets ? k_cSubsetSamplesMax : SIZE_MAX,
                &pInteractionCore->m_objectiveCpu,
@@ -332,6 +336,8 @@ ErrorEbm InteractionCore::Create(const unsigned char* const pDataSetShared,
                pDataSetShared,
                cSamples,
                aBag,
+               aIntercept,
+               aInitScores,
                cTrainingSamples,
                cWeights,
                cFeatures);
@@ -350,401 +356,4 @@ ErrorEbm InteractionCore::Create(const unsigned char* const pDataSetShared,
    return Error_None;
 }
 
-WARNING_PUSH
-WARNING_DISABLE_UNINITIALIZED_LOCAL_VARIABLE
-ErrorEbm InteractionCore::InitializeInteractionGradientsAndHessians(const unsigned char* const pDataSetShared,
-      const size_t cWeights,
-      const double* const aIntercept,
-      const BagEbm* const aBag,
-      const double* const aInitScores) {
-   ErrorEbm error = Error_None;
-   if(size_t{0} != m_dataFrame.GetCountSamples()) {
-      ptrdiff_t cClasses;
-      const void* const aTargetsFrom = GetDataSetSharedTarget(pDataSetShared, 0, &cClasses);
-      EBM_ASSERT(nullptr != aTargetsFrom); // we previously called GetDataSetSharedTarget and got back a non-null result
-      EBM_ASSERT(0 != cClasses); // no gradients if 0 == cClasses
-      EBM_ASSERT(1 != cClasses); // no gradients if 1 == cClasses
-      const size_t cScores = GetCountScores();
-      EBM_ASSERT(1 <= cScores);
-
-      size_t cBytesScoresMax = 0;
-      size_t cBytesAllScoresMax = 0;
-      size_t cBytesTempMax = 0;
-      size_t cBytesTargetMax = 0;
-      DataSubsetInteraction* pSubsetInit = GetDataSetInteraction()->GetSubsets();
-      EBM_ASSERT(nullptr != pSubsetInit);
-      EBM_ASSERT(1 <= GetDataSetInteraction()->GetCountSubsets());
-      const DataSubsetInteraction* const pSubsetsEnd = pSubsetInit + GetDataSetInteraction()->GetCountSubsets();
-      do {
-         size_t cSamples = pSubsetInit->GetCountSamples();
-         EBM_ASSERT(1 <= cSamples);
-
-         EBM_ASSERT(0 == cSamples % pSubsetInit->GetObjectiveWrapper()->m_cSIMDPack);
-         EBM_ASSERT(pSubsetInit->GetObjectiveWrapper()->m_cSIMDPack <= cSamples);
-         if(IsMultiplyError(pSubsetInit->GetObjectiveWrapper()->m_cFloatBytes, cScores, cSamples)) {
-            LOG_0(Trace_Warning,
-                  "WARNING InteractionCore::InitializeInteractionGradientsAndHessians "
-                  "IsMultiplyError(pSubsetInit->GetObjectiveWrapper()->m_cFloatBytes, cScores, cSamples)");
-            return Error_OutOfMemory;
-         }
-         const size_t cBytesScores = pSubsetInit->GetObjectiveWrapper()->m_cFloatBytes * cScores;
-         const size_t cBytesTemp = cBytesScores * pSubsetInit->GetObjectiveWrapper()->m_cSIMDPack;
-         const size_t cBytesAllScores = cBytesScores * cSamples;
-
-         cBytesScoresMax = EbmMax(cBytesScoresMax, cBytesScores);
-         cBytesAllScoresMax = EbmMax(cBytesAllScoresMax, cBytesAllScores);
-         cBytesTempMax = EbmMax(cBytesTempMax, cBytesTemp);
-
-         if(ptrdiff_t{Task_GeneralClassification} <= cClasses) {
-            if(IsMultiplyError(pSubsetInit->GetObjectiveWrapper()->m_cUIntBytes, cSamples)) {
-               LOG_0(Trace_Warning,
-                     "WARNING InteractionCore::InitializeInteractionGradientsAndHessians "
-                     "IsMultiplyError(pSubsetInit->GetObjectiveWrapper()->m_cUIntBytes, cSamples)");
-               return Error_OutOfMemory;
-            }
-            const size_t cBytesTarget = pSubsetInit->GetObjectiveWrapper()->m_cUIntBytes * cSamples;
-            cBytesTargetMax = EbmMax(cBytesTargetMax, cBytesTarget);
-         } else {
-            if(IsMultiplyError(pSubsetInit->GetObjectiveWrapper()->m_cFloatBytes, cSamples)) {
-               LOG_0(Trace_Warning,
-                     "WARNING InteractionCore::InitializeInteractionGradientsAndHessians "
-                     "IsMultiplyError(pSubsetInit->GetObjectiveWrapper()->m_cFloatBytes, cSamples)");
-               return Error_OutOfMemory;
-            }
-            const size_t cBytesTarget = pSubsetInit->GetObjectiveWrapper()->m_cFloatBytes * cSamples;
-            cBytesTargetMax = EbmMax(cBytesTargetMax, cBytesTarget);
-         }
-
-         ++pSubsetInit;
-      } while(pSubsetsEnd != pSubsetInit);
-
-      ApplyUpdateBridge data;
-
-      void* const aSampleScoreTo = AlignedAlloc(cBytesAllScoresMax);
-      if(UNLIKELY(nullptr == aSampleScoreTo)) {
-         LOG_0(Trace_Warning,
-               "WARNING InteractionCore::InitializeInteractionGradientsAndHessians nullptr == aSampleScoreTo");
-         return Error_OutOfMemory;
-      }
-      data.m_aSampleScores = aSampleScoreTo;
-
-      void* const aUpdateScores = AlignedAlloc(cBytesScoresMax);
-      if(UNLIKELY(nullptr == aUpdateScores)) {
-         LOG_0(Trace_Warning,
-               "WARNING InteractionCore::InitializeInteractionGradientsAndHessians nullptr == aUpdateScores");
-         error = Error_OutOfMemory;
-         goto free_sample_scores;
-      }
-      data.m_aUpdateTensorScores = aUpdateScores;
-
-      memset(aUpdateScores, 0, cBytesScoresMax);
-
-      data.m_aMulticlassMidwayTemp = nullptr;
-      if(ptrdiff_t{Task_GeneralClassification} <= cClasses) {
-         void* const aTargetTo = AlignedAlloc(cBytesTargetMax);
-         if(UNLIKELY(nullptr == aTargetTo)) {
-            LOG_0(Trace_Warning,
-                  "WARNING InteractionCore::InitializeInteractionGradientsAndHessians nullptr == aTargetTo");
-            error = Error_OutOfMemory;
-            goto free_tensor_scores;
-         }
-         data.m_aTargets = aTargetTo;
-
-         if(size_t{1} != cScores) {
-            void* const aMulticlassMidwayTemp = AlignedAlloc(cBytesTempMax);
-            if(UNLIKELY(nullptr == aMulticlassMidwayTemp)) {
-               LOG_0(Trace_Warning,
-                     "WARNING InteractionCore::InitializeInteractionGradientsAndHessians nullptr == "
-                     "aMulticlassMidwayTemp");
-               error = Error_OutOfMemory;
-               goto free_targets;
-            }
-            data.m_aMulticlassMidwayTemp = aMulticlassMidwayTemp;
-         }
-
-         const UIntShared* pTargetFrom = static_cast<const UIntShared*>(aTargetsFrom);
-
-         const BagEbm* pSampleReplication = aBag;
-         const double* pInitScoreFrom = aInitScores;
-         BagEbm replication = 0;
-         const double* pInitScoreFromOld = nullptr;
-         UIntShared target;
-
-         DataSubsetInteraction* pSubset = GetDataSetInteraction()->GetSubsets();
-         do {
-            EBM_ASSERT(1 <= pSubset->GetCountSamples());
-
-            const size_t cSIMDPack = pSubset->GetObjectiveWrapper()->m_cSIMDPack;
-            EBM_ASSERT(0 == pSubset->GetCountSamples() % cSIMDPack);
-
-            void* pTargetTo = aTargetTo;
-            void* pSampleScoreTo = aSampleScoreTo;
-            const void* const pTargetToEnd =
-                  IndexByte(aTargetTo, pSubset->GetObjectiveWrapper()->m_cUIntBytes * pSubset->GetCountSamples());
-            do {
-               size_t iPartition = 0;
-               do {
-                  if(BagEbm{0} == replication) {
-                     replication = 1;
-                     size_t cAdvance = cScores;
-                     if(nullptr != pSampleReplication) {
-                        cAdvance = 0; // we'll add this now inside the loop below
-                        do {
-                           do {
-                              replication = *pSampleReplication;
-                              ++pSampleReplication;
-                              ++pTargetFrom;
-                           } while(BagEbm{0} == replication);
-                           cAdvance += cScores;
-                        } while(replication < BagEbm{0});
-                        --pTargetFrom;
-                     }
-
-                     if(nullptr != pInitScoreFrom) {
-                        pInitScoreFrom += cAdvance;
-                        pInitScoreFromOld = pInitScoreFrom - cScores;
-                     }
-
-                     target = *pTargetFrom;
-                     ++pTargetFrom; // target data is shared so unlike init scores we must keep them even if replication
-                                    // is zero
-
-                     // the shared data storage structure ensures that all target values are less than the number of
-                     // classes we also check that the number of classes can be converted to a ptrdiff_t and also a
-                     // UIntMain so we do not need the runtime to check this
-                     EBM_ASSERT(target < static_cast<UIntShared>(cClasses));
-                  }
-
-                  if(sizeof(UIntBig) == pSubset->GetObjectiveWrapper()->m_cUIntBytes) {
-                     *reinterpret_cast<UIntBig*>(pTargetTo) = static_cast<UIntBig>(target);
-                  } else {
-                     EBM_ASSERT(sizeof(UIntSmall) == pSubset->GetObjectiveWrapper()->m_cUIntBytes);
-                     *reinterpret_cast<UIntSmall*>(pTargetTo) = static_cast<UIntSmall>(target);
-                  }
-                  pTargetTo = IndexByte(pTargetTo, pSubset->GetObjectiveWrapper()->m_cUIntBytes);
-
-                  size_t iScore = 0;
-                  do {
-                     double initScore = 0.0;
-                     if(nullptr != aIntercept) {
-                        initScore = aIntercept[iScore];
-                     }
-                     if(nullptr != pInitScoreFromOld) {
-                        initScore += pInitScoreFromOld[iScore];
-                     }
-
-                     if(sizeof(FloatBig) == pSubset->GetObjectiveWrapper()->m_cFloatBytes) {
-                        reinterpret_cast<FloatBig*>(pSampleScoreTo)[iScore * cSIMDPack + iPartition] =
-                              static_cast<FloatBig>(initScore);
-                     } else {
-                        EBM_ASSERT(sizeof(FloatSmall) == pSubset->GetObjectiveWrapper()->m_cFloatBytes);
-                        reinterpret_cast<FloatSmall*>(pSampleScoreTo)[iScore * cSIMDPack + iPartition] =
-                              static_cast<FloatSmall>(initScore);
-                     }
-                     ++iScore;
-                  } while(cScores != iScore);
-                  --replication;
-
-                  ++iPartition;
-               } while(cSIMDPack != iPartition);
-               pSampleScoreTo =
-                     IndexByte(pSampleScoreTo, cScores * pSubset->GetObjectiveWrapper()->m_cFloatBytes * cSIMDPack);
-            } while(pTargetToEnd != pTargetTo);
-
-            data.m_cScores = cScores;
-            data.m_cPack = k_cItemsPerBitPackUndefined;
-            data.m_bHessianNeeded = IsHessian() ? EBM_TRUE : EBM_FALSE;
-            data.m_bUseApprox = IsUseApprox();
-            data.m_bValidation = EBM_FALSE;
-            data.m_cSamples = pSubset->GetCountSamples();
-            data.m_aPacked = nullptr;
-            data.m_aWeights = nullptr;
-            data.m_aGradientsAndHessians = pSubset->GetGradHess();
-            data.m_metricOut = 0.0;
-            // this is a kind of hack (a good one) where we are sending in an update of all zeros in order to
-            // reuse the same code that we use for boosting in order to generate our gradients and hessians
-            error = pSubset->ObjectiveApplyUpdate(&data);
-            if(Error_None != error) {
-               goto free_temp;
-            }
-            ++pSubset;
-         } while(pSubsetsEnd != pSubset);
-         EBM_ASSERT(0 == replication);
-
-      free_temp:
-         AlignedFree(data.m_aMulticlassMidwayTemp); // nullptr ok
-      } else {
-         void* const aTargetTo = AlignedAlloc(cBytesTargetMax);
-         if(UNLIKELY(nullptr == aTargetTo)) {
-            LOG_0(Trace_Warning,
-                  "WARNING InteractionCore::InitializeInteractionGradientsAndHessians nullptr == aTargetTo");
-            error = Error_OutOfMemory;
-            goto free_tensor_scores;
-         }
-         data.m_aTargets = aTargetTo;
-
-         const FloatShared* pTargetFrom = static_cast<const FloatShared*>(aTargetsFrom);
-
-         const BagEbm* pSampleReplication = aBag;
-         const double* pInitScoreFrom = aInitScores;
-         BagEbm replication = 0;
-         double initScore;
-         const double intercept = nullptr == aIntercept ? 0.0 : *aIntercept;
-         FloatShared target;
-
-         DataSubsetInteraction* pSubset = GetDataSetInteraction()->GetSubsets();
-         do {
-            EBM_ASSERT(1 <= pSubset->GetCountSamples());
-            void* pTargetTo = aTargetTo;
-            void* pSampleScoreTo = aSampleScoreTo;
-            const void* const pTargetToEnd =
-                  IndexByte(aTargetTo, pSubset->GetObjectiveWrapper()->m_cFloatBytes * pSubset->GetCountSamples());
-            do {
-               if(BagEbm{0} == replication) {
-                  replication = 1;
-                  size_t cAdvance = 1;
-                  if(nullptr != pSampleReplication) {
-                     cAdvance = 0; // we'll add this now inside the loop below
-                     do {
-                        do {
-                           replication = *pSampleReplication;
-                           ++pSampleReplication;
-                           ++pTargetFrom;
-                        } while(BagEbm{0} == replication);
-                        ++cAdvance;
-                     } while(replication < BagEbm{0});
-                     --pTargetFrom;
-                  }
-
-                  initScore = intercept;
-                  if(nullptr != pInitScoreFrom) {
-                     pInitScoreFrom += cAdvance;
-                     initScore += pInitScoreFrom[-1];
-                  }
-
-                  target = *pTargetFrom;
-                  ++pTargetFrom; // target data is shared so unlike init scores we must keep them even if replication is
-                                 // zero
-               }
-
-               if(sizeof(FloatBig) == pSubset->GetObjectiveWrapper()->m_cFloatBytes) {
-                  *reinterpret_cast<FloatBig*>(pTargetTo) = static_cast<FloatBig>(target);
-                  *reinterpret_cast<FloatBig*>(pSampleScoreTo) = static_cast<FloatBig>(initScore);
-               } else {
-                  EBM_ASSERT(sizeof(FloatSmall) == pSubset->GetObjectiveWrapper()->m_cFloatBytes);
-                  *reinterpret_cast<FloatSmall*>(pTargetTo) = static_cast<FloatSmall>(target);
-                  *reinterpret_cast<FloatSmall*>(pSampleScoreTo) = static_cast<FloatSmall>(initScore);
-               }
-               pTargetTo = IndexByte(pTargetTo, pSubset->GetObjectiveWrapper()->m_cFloatBytes);
-               pSampleScoreTo = IndexByte(pSampleScoreTo, pSubset->GetObjectiveWrapper()->m_cFloatBytes);
-
-               --replication;
-
-            } while(pTargetToEnd != pTargetTo);
-
-            EBM_ASSERT(1 == cScores);
-            data.m_cScores = 1;
-            data.m_cPack = k_cItemsPerBitPackUndefined;
-            data.m_bHessianNeeded = IsHessian() ? EBM_TRUE : EBM_FALSE;
-            data.m_bUseApprox = IsUseApprox();
-            data.m_bValidation = EBM_FALSE;
-            data.m_cSamples = pSubset->GetCountSamples();
-            data.m_aPacked = nullptr;
-            data.m_aWeights = nullptr;
-            data.m_aGradientsAndHessians = pSubset->GetGradHess();
-            data.m_metricOut = 0.0;
-            // this is a kind of hack (a good one) where we are sending in an update of all zeros in order to
-            // reuse the same code that we use for boosting in order to generate our gradients and hessians
-            error = pSubset->ObjectiveApplyUpdate(&data);
-            if(Error_None != error) {
-               goto free_targets;
-            }
-            ++pSubset;
-         } while(pSubsetsEnd != pSubset);
-         EBM_ASSERT(0 == replication);
-      }
-
-   free_targets:
-      AlignedFree(const_cast<void*>(data.m_aTargets));
-   free_tensor_scores:
-      AlignedFree(const_cast<void*>(data.m_aUpdateTensorScores));
-   free_sample_scores:
-      AlignedFree(data.m_aSampleScores);
-
-      if(size_t{0} != cWeights) {
-         // optimize by now multiplying the gradients and hessians by the weights. The gradients and hessians are
-         // constants after we exit this function and we just bin the non-changing values after this. By multiplying
-         // here we can avoid doing the multiplication each time we bin them.
-
-         const FloatShared* pWeight = GetDataSetSharedWeight(pDataSetShared, 0);
-         EBM_ASSERT(nullptr != pWeight);
-
-         size_t cTotalScores = cScores;
-         if(IsHessian()) {
-            EBM_ASSERT(!IsMultiplyError(size_t{2}, cTotalScores)); // we are accessing allocated memory
-            cTotalScores = cTotalScores << 1;
-         }
-
-         const BagEbm* pSampleReplication = aBag;
-         BagEbm replication = 0;
-         FloatShared weight;
-
-         DataSubsetInteraction* pSubset = GetDataSetInteraction()->GetSubsets();
-         do {
-            const size_t cSIMDPack = pSubset->GetObjectiveWrapper()->m_cSIMDPack;
-
-            EBM_ASSERT(1 <= pSubset->GetCountSamples());
-            EBM_ASSERT(0 == pSubset->GetCountSamples() % cSIMDPack);
-
-            void* pGradHess = pSubset->GetGradHess();
-            const void* const pGradHessEnd = IndexByte(
-                  pGradHess, pSubset->GetObjectiveWrapper()->m_cFloatBytes * cTotalScores * pSubset->GetCountSamples());
-            do {
-               size_t iPartition = 0;
-               do {
-                  if(BagEbm{0} == replication) {
-                     replication = 1;
-                     if(nullptr != pSampleReplication) {
-                        do {
-                           replication = *pSampleReplication;
-                           ++pSampleReplication;
-                           ++pWeight;
-                        } while(replication <= BagEbm{0});
-                        --pWeight;
-                     }
-                     weight = *pWeight;
-                     ++pWeight;
-                  }
-                  size_t iScore = 0;
-                  if(sizeof(FloatBig) == pSubset->GetObjectiveWrapper()->m_cFloatBytes) {
-                     const FloatBig weightConverted = static_cast<FloatBig>(weight);
-                     do {
-                        reinterpret_cast<FloatBig*>(pGradHess)[iScore * cSIMDPack + iPartition] *= weightConverted;
-                        ++iScore;
-                     } while(cTotalScores != iScore);
-                  } else {
-                     EBM_ASSERT(sizeof(FloatSmall) == pSubset->GetObjectiveWrapper()->m_cFloatBytes);
-                     const FloatSmall weightConverted = static_cast<FloatSmall>(weight);
-                     do {
-                        reinterpret_cast<FloatSmall*>(pGradHess)[iScore * cSIMDPack + iPartition] *= weightConverted;
-                        ++iScore;
-                     } while(cTotalScores != iScore);
-                  }
-                  --replication;
-
-                  ++iPartition;
-               } while(cSIMDPack != iPartition);
-               pGradHess =
-                     IndexByte(pGradHess, pSubset->GetObjectiveWrapper()->m_cFloatBytes * cTotalScores * cSIMDPack);
-            } while(pGradHessEnd != pGradHess);
-
-            ++pSubset;
-         } while(pSubsetsEnd != pSubset);
-         EBM_ASSERT(0 == replication);
-      }
-   }
-   return error;
-}
-WARNING_POP
-
 } // namespace DEFINED_ZONE_NAME
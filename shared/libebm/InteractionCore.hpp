@@ -84,18 +84,14 @@ class InteractionCore final {
          const size_t cFeatures,
          const size_t cWeights,
          const BagEbm* const aBag,
+         const double* const aIntercept,
+         const double* const aInitScores,
          const CreateInteractionFlags flags,
          const AccelerationFlags acceleration,
          const char* const sObjective,
          const double* const experimentalParams,
          InteractionCore** const ppInteractionCoreOut);
 
-   ErrorEbm InitializeInteractionGradientsAndHessians(const unsigned char* const pDataSetShared,
-         const size_t cWeights,
-         const double* const aIntercept,
-         const BagEbm* const aBag,
-         const double* const aInitScores);
-
    inline BoolEbm CheckTargets(const size_t c, const void* const aTargets) const noexcept {
       EBM_ASSERT(nullptr != aTargets);
       EBM_ASSERT(nullptr != m_objectiveCpu.m_pObjective);
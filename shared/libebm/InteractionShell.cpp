@@ -16,18 +16,15 @@
 #include "dataset_shared.hpp" // GetDataSetSharedHeader
 #include "InteractionCore.hpp"
 #include "InteractionShell.hpp"
+#include "api_recording.hpp"
 
 namespace DEFINED_ZONE_NAME {
 #ifndef DEFINED_ZONE_NAME
 #error DEFINED_ZONE_NAME must be defined
 #endif // DEFINED_ZONE_NAME
 
-extern void InitializeRmseGradientsAndHessiansInteraction(const unsigned char* const pDataSetShared,
-      const size_t cWeights,
-      const double intercept,
-      const BagEbm* const aBag,
-      const double* const aInitScores,
-      DataSetInteraction* const pDataSet);
+extern ErrorEbm AllocateBagFromPlan(
+      const void* const dataSet, const void* const bagPlan, const IntEbm indexBag, BagEbm** const paBagOut);
 
 void InteractionShell::Free(InteractionShell* const pInteractionShell) {
    LOG_0(Trace_Info, "Entered InteractionShell::Free");
@@ -169,6 +166,8 @@ EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION CreateInteractionDetector(const voi
          cFeatures,
          cWeights,
          bag,
+         intercept,
+         initScores,
          flags,
          acceleration,
          objective,
@@ -188,33 +187,66 @@ EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION CreateInteractionDetector(const voi
       return Error_OutOfMemory;
    }
 
-   if(size_t{0} != pInteractionCore->GetCountScores()) {
-      if(!pInteractionCore->IsRmse()) {
-         error = pInteractionCore->InitializeInteractionGradientsAndHessians(
-               static_cast<const unsigned char*>(dataSet), cWeights, intercept, bag, initScores);
-         if(Error_None != error) {
-            // DO NOT FREE pInteractionCore since it's owned by pInteractionShell, which we free here
-            InteractionShell::Free(pInteractionShell);
-            return error;
-         }
-      } else {
-         InitializeRmseGradientsAndHessiansInteraction(static_cast<const unsigned char*>(dataSet),
-               cWeights,
-               nullptr == intercept ? 0.0 : *intercept,
-               bag,
-               initScores,
-               pInteractionCore->GetDataSetInteraction());
-      }
-   }
-
    const InteractionHandle handle = pInteractionShell->GetHandle();
 
+   if(IsRecording()) {
+      RecordCreateInteractionDetector(dataSet,
+            intercept,
+            bag,
+            initScores,
+            flags,
+            acceleration,
+            objective,
+            pInteractionCore->GetCountScores(),
+            handle);
+   }
+
    LOG_N(Trace_Info, "Exited CreateInteractionDetector: *interactionHandleOut=%p", static_cast<void*>(handle));
 
    *interactionHandleOut = handle;
    return Error_None;
 }
 
+EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION CreateInteractionDetectorFromBagPlan(const void* dataSet,
+      const double* intercept,
+      const void* bagPlan,
+      IntEbm indexBag,
+      const double* initScores,
+      CreateInteractionFlags flags,
+      AccelerationFlags acceleration,
+      const char* objective,
+      const double* experimentalParams,
+      InteractionHandle* interactionHandleOut) {
+   LOG_N(Trace_Info,
+         "Entered CreateInteractionDetectorFromBagPlan: "
+         "bagPlan=%p, "
+         "indexBag=%" IntEbmPrintf,
+         bagPlan,
+         indexBag);
+
+   if(nullptr == interactionHandleOut) {
+      LOG_0(Trace_Error, "ERROR CreateInteractionDetectorFromBagPlan nullptr == interactionHandleOut");
+      return Error_IllegalParamVal;
+   }
+   *interactionHandleOut = nullptr; // set this to nullptr as soon as possible so the caller doesn't attempt to free it
+
+   BagEbm* aBag;
+   ErrorEbm error = AllocateBagFromPlan(dataSet, bagPlan, indexBag, &aBag);
+   if(Error_None != error) {
+      // already logged
+      return error;
+   }
+
+   // CreateInteractionDetector does not hold onto the bag after it returns, and it records the unpacked bag
+   error = CreateInteractionDetector(
+         dataSet, intercept, aBag, initScores, flags, acceleration, objective, experimentalParams, interactionHandleOut);
+
+   free(aBag);
+
+   LOG_0(Trace_Info, "Exited CreateInteractionDetectorFromBagPlan");
+   return error;
+}
+
 EBM_API_BODY void EBM_CALLING_CONVENTION FreeInteractionDetector(InteractionHandle interactionHandle) {
    LOG_N(Trace_Info, "Entered FreeInteractionDetector: interactionHandle=%p", static_cast<void*>(interactionHandle));
 
@@ -222,6 +254,10 @@ EBM_API_BODY void EBM_CALLING_CONVENTION FreeInteractionDetector(InteractionHand
    // if the conversion above doesn't work, it'll return null, and our free will not in fact free any memory,
    // but it will not crash. We'll leak memory, but at least we'll log that.
 
+   if(nullptr != pInteractionShell && IsRecording()) {
+      RecordFreeInteractionDetector(interactionHandle);
+   }
+
    // it's legal to call free on nullptr, just like for free().  This is checked inside InteractionCore::Free()
    InteractionShell::Free(pInteractionShell);
 
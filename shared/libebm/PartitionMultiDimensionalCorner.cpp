@@ -158,6 +158,7 @@ template<bool bHessian, size_t cCompilerScores> class PartitionMultiDimensionalC
          BinBase* const aAuxiliaryBinsBase,
          Tensor* const pInnerTermUpdate,
          const size_t* const acBins,
+         const MonotoneDimension* const aMonotoneDimensions,
          double* const pTotalGain
 #ifndef NDEBUG
          ,
@@ -225,6 +226,7 @@ template<bool bHessian, size_t cCompilerScores> class PartitionMultiDimensionalC
             aBestDimensions[k_dynamicDimensions == cCompilerDimensions ? k_cDimensionsMax : cCompilerDimensions];
 
       size_t aiOriginalIndex[k_dynamicDimensions == cCompilerDimensions ? k_cDimensionsMax : cCompilerDimensions];
+      MonotoneDimension aMonotone[k_dynamicDimensions == cCompilerDimensions ? k_cDimensionsMax : cCompilerDimensions];
       {
          size_t iDimensionLoop = 0;
          size_t iDimInit = 0;
@@ -234,6 +236,9 @@ template<bool bHessian, size_t cCompilerScores> class PartitionMultiDimensionalC
             EBM_ASSERT(size_t{1} <= cBins); // we don't boost on empty training sets
             if(size_t{1} < cBins) {
                aiOriginalIndex[iDimInit] = iDimensionLoop;
+               if(nullptr != aMonotoneDimensions) {
+                  aMonotone[iDimInit] = aMonotoneDimensions[iDimensionLoop];
+               }
                ++iDimInit;
             }
             ++iDimensionLoop;
@@ -242,6 +247,8 @@ template<bool bHessian, size_t cCompilerScores> class PartitionMultiDimensionalC
 
       const size_t cTotalSamples = static_cast<size_t>(pTotal->GetCountSamples());
 
+      const bool bUpdateWithHessian = bHessian && !(TermBoostFlags_DisableNewtonUpdate & flags);
+
       TensorSumDimension
             aDimensions[k_dynamicDimensions == cCompilerDimensions ? k_cDimensionsMax : cCompilerDimensions];
       TensorSumDimension* pDimensionEnd = &aDimensions[cRealDimensions];
@@ -325,6 +332,65 @@ template<bool bHessian, size_t cCompilerScores> class PartitionMultiDimensionalC
                   } while(cScores != iScore);
                   EBM_ASSERT(std::isnan(gain) || 0 <= gain); // sumation of positive numbers should be positive
 
+                  if(nullptr != aMonotoneDimensions) {
+                     // The corner box touches one end of every dimension, so along any constrained dimension the box
+                     // is entirely below or entirely above the remainder of the tensor that shares its lines.
+                     for(size_t iDim = 0; iDim < cRealDimensions; ++iDim) {
+                        const MonotoneDirection monotoneDirection = aMonotone[iDim].m_direction;
+                        if(MONOTONE_NONE == monotoneDirection) {
+                           continue;
+                        }
+                        const size_t iBinOrdered = aMonotone[iDim].m_iBinOrdered;
+                        bool bBoxBelow;
+                        if(0 == aDimensions[iDim].m_iLow) {
+                           if(aDimensions[iDim].m_iHigh <= iBinOrdered) {
+                              // the box only holds missing values along this dimension
+                              continue;
+                           }
+                           bBoxBelow = true;
+                        } else {
+                           EBM_ASSERT(aDimensions[iDim].m_cBins == aDimensions[iDim].m_iHigh);
+                           if(aDimensions[iDim].m_iLow <= iBinOrdered) {
+                              // the remainder only holds missing values along this dimension
+                              continue;
+                           }
+                           bBoxBelow = false;
+                        }
+
+                        FloatCalc hessBox = static_cast<FloatCalc>(pTempBin->GetWeight());
+                        FloatCalc hessOther = static_cast<FloatCalc>(weightAll - pTempBin->GetWeight());
+                        for(size_t iScoreCheck = 0; iScoreCheck < cScores; ++iScoreCheck) {
+                           const FloatMain gradBox = aGradientPairsLocal[iScoreCheck].m_sumGradients;
+                           if(bUpdateWithHessian) {
+                              const FloatMain hessBoxOrig = aGradientPairsLocal[iScoreCheck].GetHess();
+                              hessBox = static_cast<FloatCalc>(hessBoxOrig);
+                              hessOther =
+                                    static_cast<FloatCalc>(aGradientPairTotal[iScoreCheck].GetHess() - hessBoxOrig);
+                           }
+                           const FloatCalc negUpdateBox = CalcNegUpdate<true>(
+                                 static_cast<FloatCalc>(gradBox), hessBox, regAlpha, regLambda, deltaStepMax);
+                           const FloatCalc negUpdateOther = CalcNegUpdate<true>(
+                                 static_cast<FloatCalc>(aGradientPairTotal[iScoreCheck].m_sumGradients - gradBox),
+                                 hessOther,
+                                 regAlpha,
+                                 regLambda,
+                                 deltaStepMax);
+                           const FloatCalc negUpdateBelow = bBoxBelow ? negUpdateBox : negUpdateOther;
+                           const FloatCalc negUpdateAbove = bBoxBelow ? negUpdateOther : negUpdateBox;
+                           if(MonotoneDirection{0} < monotoneDirection) {
+                              if(negUpdateBelow < negUpdateAbove) {
+                                 goto next;
+                              }
+                           } else {
+                              EBM_ASSERT(monotoneDirection < MonotoneDirection{0});
+                              if(negUpdateAbove < negUpdateBelow) {
+                                 goto next;
+                              }
+                           }
+                        }
+                     }
+                  }
+
                   if(UNLIKELY(/* NaN */ !LIKELY(gain <= bestGain))) {
                      // propagate NaNs
                      bestGain = gain;
@@ -420,8 +486,6 @@ template<bool bHessian, size_t cCompilerScores> class PartitionMultiDimensionalC
       // we don't need to call pInnerTermUpdate->EnsureTensorScoreCapacity,
       // since our value capacity would be 1, which is pre-allocated
 
-      const bool bUpdateWithHessian = bHessian && !(TermBoostFlags_DisableNewtonUpdate & flags);
-
       FloatScore* const aUpdateScores = pInnerTermUpdate->GetTensorScoresPointer();
       FloatCalc weight2 = static_cast<FloatCalc>(weightAll);
       for(size_t iScore = 0; iScore < cScores; ++iScore) {
@@ -458,6 +522,7 @@ template<bool bHessian, size_t cPossibleScores> class PartitionMultiDimensionalC
          BinBase* const aAuxiliaryBinsBase,
          Tensor* const pInnerTermUpdate,
          const size_t* const acBins,
+         const MonotoneDimension* const aMonotoneDimensions,
          double* const pTotalGain
 #ifndef NDEBUG
          ,
@@ -478,6 +543,7 @@ template<bool bHessian, size_t cPossibleScores> class PartitionMultiDimensionalC
                aAuxiliaryBinsBase,
                pInnerTermUpdate,
                acBins,
+               aMonotoneDimensions,
                pTotalGain
 #ifndef NDEBUG
                ,
@@ -498,6 +564,7 @@ template<bool bHessian, size_t cPossibleScores> class PartitionMultiDimensionalC
                aAuxiliaryBinsBase,
                pInnerTermUpdate,
                acBins,
+               aMonotoneDimensions,
                pTotalGain
 #ifndef NDEBUG
                ,
@@ -525,6 +592,7 @@ template<bool bHessian> class PartitionMultiDimensionalCornerTarget<bHessian, k_
          BinBase* const aAuxiliaryBinsBase,
          Tensor* const pInnerTermUpdate,
          const size_t* const acBins,
+         const MonotoneDimension* const aMonotoneDimensions,
          double* const pTotalGain
 #ifndef NDEBUG
          ,
@@ -544,6 +612,7 @@ template<bool bHessian> class PartitionMultiDimensionalCornerTarget<bHessian, k_
             aAuxiliaryBinsBase,
             pInnerTermUpdate,
             acBins,
+            aMonotoneDimensions,
             pTotalGain
 #ifndef NDEBUG
             ,
@@ -567,6 +636,7 @@ extern ErrorEbm PartitionMultiDimensionalCorner(const bool bHessian,
       BinBase* const aAuxiliaryBinsBase,
       Tensor* const pInnerTermUpdate,
       const size_t* const acBins,
+      const MonotoneDimension* const aMonotoneDimensions,
       double* const pTotalGain
 #ifndef NDEBUG
       ,
@@ -592,6 +662,7 @@ extern ErrorEbm PartitionMultiDimensionalCorner(const bool bHessian,
                aAuxiliaryBinsBase,
                pInnerTermUpdate,
                acBins,
+               aMonotoneDimensions,
                pTotalGain
 #ifndef NDEBUG
                ,
@@ -612,6 +683,7 @@ extern ErrorEbm PartitionMultiDimensionalCorner(const bool bHessian,
                aAuxiliaryBinsBase,
                pInnerTermUpdate,
                acBins,
+               aMonotoneDimensions,
                pTotalGain
 #ifndef NDEBUG
                ,
@@ -635,6 +707,7 @@ extern ErrorEbm PartitionMultiDimensionalCorner(const bool bHessian,
                aAuxiliaryBinsBase,
                pInnerTermUpdate,
                acBins,
+               aMonotoneDimensions,
                pTotalGain
 #ifndef NDEBUG
                ,
@@ -655,6 +728,7 @@ extern ErrorEbm PartitionMultiDimensionalCorner(const bool bHessian,
                aAuxiliaryBinsBase,
                pInnerTermUpdate,
                acBins,
+               aMonotoneDimensions,
                pTotalGain
 #ifndef NDEBUG
                ,
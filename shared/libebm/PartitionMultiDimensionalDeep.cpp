@@ -0,0 +1,1054 @@
+// Copyright (c) 2023 The InterpretML Contributors
+// Licensed under the MIT license.
+// Author: Paul Koch <code@koch.ninja>
+
+#include "pch.hpp"
+
+#include <stddef.h> // size_t, ptrdiff_t
+#include <string.h> // memcpy, memset
+
+#include "libebm.h" // ErrorEbm
+#include "logging.h" // EBM_ASSERT
+#include "unzoned.h" // LIKELY
+
+#define ZONE_main
+#include "zones.h"
+
+#include "GradientPair.hpp"
+#include "Bin.hpp"
+
+#include "ebm_internal.hpp"
+#include "ebm_stats.hpp"
+#include "Tensor.hpp"
+#include "TensorTotalsSum.hpp"
+#include "BoosterShell.hpp"
+
+namespace DEFINED_ZONE_NAME {
+#ifndef DEFINED_ZONE_NAME
+#error DEFINED_ZONE_NAME must be defined
+#endif // DEFINED_ZONE_NAME
+
+// PartitionMultiDimensionalTree tries every tree that has one split per dimension, which limits an update to
+// cRealDimensions + 1 leaves.  With TermBoostFlags_DeepTree we instead grow the tree best-first: we keep the best split
+// of every leaf and repeatedly take the leaf whose split gains the most, until the leaf budget runs out or no split
+// reaches k_gainMin.  Every region sum comes from the cumulative tensor that TensorTotalsBuild made, so finding the
+// best split of a leaf costs O(bins) lookups and never touches the data again.
+//
+// Each dimension may be split (aLeavesMax[iDimension] - 1) times in total across all branches of the tree, so a pair
+// with aLeavesMax of {16, 16} can have up to 31 leaves.
+
+struct DeepLeaf {
+   // the real dimension of the best split, or k_cDimensionsMax if the leaf has no valid split
+   size_t m_iSplitDimension;
+   // the first bin of the high side of the best split
+   size_t m_iSplit;
+   FloatCalc m_splitGain;
+   TensorSumDimension m_aBox[k_cDimensionsMax];
+};
+
+static constexpr size_t k_noSplitDimension = k_cDimensionsMax;
+
+template<bool bHessian, size_t cCompilerScores>
+static bool IsDeepPairViolated(const size_t cScores,
+      const size_t cRealDimensions,
+      const bool bUpdateWithHessian,
+      const FloatCalc regAlpha,
+      const FloatCalc regLambda,
+      const FloatCalc deltaStepMax,
+      const MonotoneDimension* const aMonotone,
+      const TensorSumDimension* const aBox1,
+      const Bin<FloatMain, UIntMain, true, true, bHessian, GetArrayScores(cCompilerScores)>* const pBin1,
+      const TensorSumDimension* const aBox2,
+      const Bin<FloatMain, UIntMain, true, true, bHessian, GetArrayScores(cCompilerScores)>* const pBin2) {
+   // same rule as the tree search: two leaves that share a line along a constrained dimension must have their updates
+   // ordered the same way as their boxes
+   for(size_t iDim = 0; iDim < cRealDimensions; ++iDim) {
+      const MonotoneDirection direction = aMonotone[iDim].m_direction;
+      if(MONOTONE_NONE == direction) {
+         continue;
+      }
+
+      bool bShareLine = true;
+      for(size_t iDimOther = 0; iDimOther < cRealDimensions; ++iDimOther) {
+         if(iDimOther != iDim &&
+               (aBox1[iDimOther].m_iHigh <= aBox2[iDimOther].m_iLow ||
+                     aBox2[iDimOther].m_iHigh <= aBox1[iDimOther].m_iLow)) {
+            bShareLine = false;
+            break;
+         }
+      }
+      if(!bShareLine) {
+         continue;
+      }
+
+      const size_t iBinOrdered = aMonotone[iDim].m_iBinOrdered;
+      const size_t iLow1 = EbmMax(aBox1[iDim].m_iLow, iBinOrdered);
+      const size_t iLow2 = EbmMax(aBox2[iDim].m_iLow, iBinOrdered);
+      if(aBox1[iDim].m_iHigh <= iLow1 || aBox2[iDim].m_iHigh <= iLow2) {
+         // one of the leaves only holds missing values along this dimension
+         continue;
+      }
+
+      const auto* pBinBelow = pBin1;
+      const auto* pBinAbove = pBin2;
+      if(aBox2[iDim].m_iHigh <= iLow1) {
+         pBinBelow = pBin2;
+         pBinAbove = pBin1;
+      } else {
+         // leaves that share a line are disjoint along the remaining dimension
+         EBM_ASSERT(aBox1[iDim].m_iHigh <= iLow2);
+      }
+
+      const auto* const aGradPairsBelow = pBinBelow->GetGradientPairs();
+      const auto* const aGradPairsAbove = pBinAbove->GetGradientPairs();
+      FloatCalc hessBelow = static_cast<FloatCalc>(pBinBelow->GetWeight());
+      FloatCalc hessAbove = static_cast<FloatCalc>(pBinAbove->GetWeight());
+      for(size_t iScore = 0; iScore < cScores; ++iScore) {
+         if(bUpdateWithHessian) {
+            hessBelow = static_cast<FloatCalc>(aGradPairsBelow[iScore].GetHess());
+            hessAbove = static_cast<FloatCalc>(aGradPairsAbove[iScore].GetHess());
+         }
+         const FloatCalc negUpdateBelow = CalcNegUpdate<true>(static_cast<FloatCalc>(
+                                                                    aGradPairsBelow[iScore].m_sumGradients),
+               hessBelow,
+               regAlpha,
+               regLambda,
+               deltaStepMax);
+         const FloatCalc negUpdateAbove = CalcNegUpdate<true>(static_cast<FloatCalc>(
+                                                                    aGradPairsAbove[iScore].m_sumGradients),
+               hessAbove,
+               regAlpha,
+               regLambda,
+               deltaStepMax);
+         // multiclass requires every class score to follow the direction
+         if(MonotoneDirection{0} < direction) {
+            if(negUpdateBelow < negUpdateAbove) {
+               return true;
+            }
+         } else {
+            EBM_ASSERT(direction < MonotoneDirection{0});
+            if(negUpdateAbove < negUpdateBelow) {
+               return true;
+            }
+         }
+      }
+   }
+   return false;
+}
+
+template<bool bHessian, size_t cCompilerScores> class PartitionMultiDimensionalDeepInternal final {
+ public:
+   PartitionMultiDimensionalDeepInternal() = delete; // this is a static class.  Do not construct
+
+   WARNING_PUSH
+   WARNING_DISABLE_UNINITIALIZED_LOCAL_VARIABLE
+   INLINE_RELEASE_UNTEMPLATED static ErrorEbm Func(BoosterShell* const pBoosterShell,
+         const size_t cRuntimeScores,
+         const size_t cDimensions,
+         const size_t cRealDimensions,
+         const TermBoostFlags flags,
+         const size_t cSamplesLeafMin,
+         const FloatCalc hessianMin,
+         const FloatCalc regAlpha,
+         const FloatCalc regLambda,
+         const FloatCalc deltaStepMax,
+         const BinBase* const aBinsBase,
+         BinBase* const aAuxiliaryBinsBase,
+         Tensor* const pInnerTermUpdate,
+         const size_t* const acBins,
+         const IntEbm* const aLeavesMax,
+         const MonotoneDimension* const aMonotoneDimensions,
+         double* const aTensorWeights,
+         double* const aTensorGrad,
+         double* const aTensorHess,
+         double* const pTotalGain
+#ifndef NDEBUG
+         ,
+         const BinBase* const aDebugCopyBinsBase,
+         const BinBase* const pBinsEndDebug
+#endif // NDEBUG
+   ) {
+      static constexpr size_t cCompilerDimensions = k_dynamicDimensions;
+
+      UNUSED(cDimensions); // only checked in debug builds
+
+      ErrorEbm error;
+
+      const auto* const aBins =
+            aBinsBase->Specialize<FloatMain, UIntMain, true, true, bHessian, GetArrayScores(cCompilerScores)>();
+      auto* const aAuxiliaryBins =
+            aAuxiliaryBinsBase
+                  ->Specialize<FloatMain, UIntMain, true, true, bHessian, GetArrayScores(cCompilerScores)>();
+
+#ifndef NDEBUG
+      const auto* const aDebugCopyBins =
+            aDebugCopyBinsBase
+                  ->Specialize<FloatMain, UIntMain, true, true, bHessian, GetArrayScores(cCompilerScores)>();
+#endif // NDEBUG
+
+      const size_t cScores = GET_COUNT_SCORES(cCompilerScores, cRuntimeScores);
+      const size_t cBytesPerBin = GetBinSize<FloatMain, UIntMain>(true, true, bHessian, cScores);
+
+      const bool bUseLogitBoost = bHessian && !(TermBoostFlags_DisableNewtonGain & flags);
+      const bool bUpdateWithHessian = bHessian && !(TermBoostFlags_DisableNewtonUpdate & flags);
+
+      EBM_ASSERT(std::numeric_limits<FloatCalc>::min() <= hessianMin);
+
+      // the bin before the aAuxiliaryBins is the last summation bin of aBinsBase,
+      // which contains the totals of all bins
+      const auto* const pTotal = NegativeIndexBin(aAuxiliaryBins, cBytesPerBin);
+      ASSERT_BIN_OK(cBytesPerBin, pTotal, pBinsEndDebug);
+
+      // the first two auxiliary bins hold the low and high sides of the split being evaluated
+      auto* const pLowBin = aAuxiliaryBins;
+      ASSERT_BIN_OK(cBytesPerBin, pLowBin, pBinsEndDebug);
+      auto* const pHighBin = IndexBin(aAuxiliaryBins, cBytesPerBin);
+      ASSERT_BIN_OK(cBytesPerBin, pHighBin, pBinsEndDebug);
+
+      size_t aiOriginalIndex[k_cDimensionsMax];
+      size_t acRealBins[k_cDimensionsMax];
+      size_t acSplitsLeft[k_cDimensionsMax];
+      MonotoneDimension aMonotone[k_cDimensionsMax];
+
+      EBM_ASSERT(2 <= cRealDimensions);
+      EBM_ASSERT(nullptr != aLeavesMax);
+
+      size_t cTensorBins = 1;
+      size_t cLeavesMax = 1;
+      size_t cSliceIndexes = 0;
+      size_t iDimensionLoop = 0;
+      size_t iDimInit = 0;
+      do {
+         EBM_ASSERT(iDimensionLoop < cDimensions);
+         const size_t cBins = acBins[iDimensionLoop];
+         EBM_ASSERT(size_t{1} <= cBins); // we don't boost on empty training sets
+         if(size_t{1} < cBins) {
+            aiOriginalIndex[iDimInit] = iDimensionLoop;
+            acRealBins[iDimInit] = cBins;
+            if(nullptr != aMonotoneDimensions) {
+               aMonotone[iDimInit] = aMonotoneDimensions[iDimensionLoop];
+            }
+
+            const IntEbm countLeavesMax = aLeavesMax[iDimensionLoop];
+            size_t cSplitsMax = 0;
+            if(IntEbm{1} < countLeavesMax) {
+               cSplitsMax = IsConvertError<size_t>(countLeavesMax - IntEbm{1}) ?
+                     std::numeric_limits<size_t>::max() :
+                     static_cast<size_t>(countLeavesMax - IntEbm{1});
+            }
+            acSplitsLeft[iDimInit] = cSplitsMax;
+            cLeavesMax = IsAddError(cLeavesMax, cSplitsMax) ? std::numeric_limits<size_t>::max() :
+                                                              cLeavesMax + cSplitsMax;
+
+            // the tensor was allocated, so neither of these can overflow
+            EBM_ASSERT(!IsMultiplyError(cTensorBins, cBins));
+            cTensorBins *= cBins;
+            EBM_ASSERT(!IsAddError(cSliceIndexes, cBins));
+            cSliceIndexes += cBins;
+
+            ++iDimInit;
+         }
+         ++iDimensionLoop;
+      } while(cRealDimensions != iDimInit);
+
+      // every leaf holds at least one tensor bin
+      cLeavesMax = EbmMin(cLeavesMax, cTensorBins);
+
+      // the leaves, their bins, and the slice indexes live in the shell's Temp1 buffer, which grows to the largest
+      // term and is then reused by every later boosting step
+      if(IsMultiplyError(sizeof(DeepLeaf), cLeavesMax) || IsMultiplyError(cBytesPerBin, cLeavesMax) ||
+            IsMultiplyError(sizeof(size_t), cSliceIndexes)) {
+         LOG_0(Trace_Warning, "WARNING PartitionMultiDimensionalDeep IsMultiplyError");
+         return Error_OutOfMemory;
+      }
+      const size_t cBytesLeaves = sizeof(DeepLeaf) * cLeavesMax;
+      const size_t cBytesLeafBins = cBytesPerBin * cLeavesMax;
+      const size_t cBytesSliceIndexes = sizeof(size_t) * cSliceIndexes;
+      if(IsAddError(cBytesLeaves, cBytesLeafBins, cBytesSliceIndexes)) {
+         LOG_0(Trace_Warning, "WARNING PartitionMultiDimensionalDeep IsAddError");
+         return Error_OutOfMemory;
+      }
+      error = pBoosterShell->ReserveTemp1(cBytesLeaves + cBytesLeafBins + cBytesSliceIndexes);
+      if(Error_None != error) {
+         // already logged
+         return error;
+      }
+      char* const pMem = static_cast<char*>(pBoosterShell->GetTemp1());
+      DeepLeaf* const aLeaves = reinterpret_cast<DeepLeaf*>(pMem);
+      auto* const aLeafBins = reinterpret_cast<BinBase*>(pMem + cBytesLeaves)
+                                    ->Specialize<FloatMain, UIntMain, true, true, bHessian,
+                                          GetArrayScores(cCompilerScores)>();
+      size_t* const aSliceIndexes = reinterpret_cast<size_t*>(pMem + cBytesLeaves + cBytesLeafBins);
+
+      bool bOverflow = false;
+
+      // finds the best split of the leaf along the dimensions that still have splits left, or none if nothing
+      // reaches k_gainMin
+      const auto FindBestSplit = [&](const size_t iLeaf, const size_t cLeavesCur) {
+         DeepLeaf* const pLeaf = &aLeaves[iLeaf];
+         const auto* const pLeafBin = IndexBin(aLeafBins, cBytesPerBin * iLeaf);
+         const auto* const aLeafGradientPairs = pLeafBin->GetGradientPairs();
+
+         pLeaf->m_iSplitDimension = k_noSplitDimension;
+         pLeaf->m_iSplit = 0;
+         pLeaf->m_splitGain = 0;
+
+         FloatCalc gainParent = 0;
+         FloatCalc hessParent = static_cast<FloatCalc>(pLeafBin->GetWeight());
+         for(size_t iScore = 0; iScore < cScores; ++iScore) {
+            if(bUseLogitBoost) {
+               hessParent = static_cast<FloatCalc>(aLeafGradientPairs[iScore].GetHess());
+            }
+            gainParent += CalcPartialGain<false>(static_cast<FloatCalc>(aLeafGradientPairs[iScore].m_sumGradients),
+                  hessParent,
+                  regAlpha,
+                  regLambda,
+                  deltaStepMax);
+         }
+         if(UNLIKELY(/* NaN */ !LIKELY(gainParent <= std::numeric_limits<FloatCalc>::max()))) {
+            bOverflow = true;
+            return;
+         }
+
+         // a split must beat the parent by k_gainMin
+         FloatCalc bestGain = gainParent + k_gainMin;
+
+         TensorSumDimension aBox[k_cDimensionsMax];
+         memcpy(aBox, pLeaf->m_aBox, sizeof(*aBox) * cRealDimensions);
+         for(size_t iDim = 0; iDim < cRealDimensions; ++iDim) {
+            if(size_t{0} == acSplitsLeft[iDim]) {
+               continue;
+            }
+            const size_t iHigh = aBox[iDim].m_iHigh;
+            for(size_t iSplit = aBox[iDim].m_iLow + 1; iSplit < iHigh; ++iSplit) {
+               aBox[iDim].m_iHigh = iSplit;
+               TensorTotalsSum<bHessian, cCompilerScores, cCompilerDimensions>(cScores,
+                     cRealDimensions,
+                     aBox,
+                     aBins,
+                     *pLowBin,
+                     pLowBin->GetGradientPairs()
+#ifndef NDEBUG
+                           ,
+                     aDebugCopyBins,
+                     pBinsEndDebug
+#endif // NDEBUG
+               );
+               if(pLowBin->GetCountSamples() < cSamplesLeafMin) {
+                  continue;
+               }
+               // the high side is whatever the low side leaves of the parent
+               pHighBin->Copy(cScores, *pLeafBin);
+               pHighBin->Subtract(cScores, *pLowBin);
+               if(pHighBin->GetCountSamples() < cSamplesLeafMin) {
+                  continue;
+               }
+
+               const auto* const aLowGradientPairs = pLowBin->GetGradientPairs();
+               const auto* const aHighGradientPairs = pHighBin->GetGradientPairs();
+               FloatCalc hessLow = static_cast<FloatCalc>(pLowBin->GetWeight());
+               FloatCalc hessHigh = static_cast<FloatCalc>(pHighBin->GetWeight());
+               FloatCalc gain = 0;
+               size_t iScore = 0;
+               do {
+                  if(bUseLogitBoost) {
+                     hessLow = static_cast<FloatCalc>(aLowGradientPairs[iScore].GetHess());
+                     hessHigh = static_cast<FloatCalc>(aHighGradientPairs[iScore].GetHess());
+                  }
+                  if(hessLow < hessianMin || hessHigh < hessianMin) {
+                     goto next_split;
+                  }
+                  gain += CalcPartialGain<false>(static_cast<FloatCalc>(aLowGradientPairs[iScore].m_sumGradients),
+                        hessLow,
+                        regAlpha,
+                        regLambda,
+                        deltaStepMax);
+                  gain += CalcPartialGain<false>(static_cast<FloatCalc>(aHighGradientPairs[iScore].m_sumGradients),
+                        hessHigh,
+                        regAlpha,
+                        regLambda,
+                        deltaStepMax);
+                  ++iScore;
+               } while(cScores != iScore);
+
+               if(UNLIKELY(/* NaN */ !LIKELY(gain <= std::numeric_limits<FloatCalc>::max()))) {
+                  bOverflow = true;
+                  continue;
+               }
+               if(gain <= bestGain) {
+                  continue;
+               }
+
+               if(nullptr != aMonotoneDimensions) {
+                  TensorSumDimension aHighBox[k_cDimensionsMax];
+                  memcpy(aHighBox, aBox, sizeof(*aBox) * cRealDimensions);
+                  aHighBox[iDim].m_iLow = iSplit;
+                  aHighBox[iDim].m_iHigh = iHigh;
+                  if(IsDeepPairViolated<bHessian, cCompilerScores>(cScores,
+                           cRealDimensions,
+                           bUpdateWithHessian,
+                           regAlpha,
+                           regLambda,
+                           deltaStepMax,
+                           aMonotone,
+                           aBox,
+                           pLowBin,
+                           aHighBox,
+                           pHighBin)) {
+                     continue;
+                  }
+                  for(size_t iOther = 0; iOther < cLeavesCur; ++iOther) {
+                     if(iOther == iLeaf) {
+                        continue;
+                     }
+                     const TensorSumDimension* const aOtherBox = aLeaves[iOther].m_aBox;
+                     const auto* const pOtherBin = IndexBin(aLeafBins, cBytesPerBin * iOther);
+                     if(IsDeepPairViolated<bHessian, cCompilerScores>(cScores,
+                              cRealDimensions,
+                              bUpdateWithHessian,
+                              regAlpha,
+                              regLambda,
+                              deltaStepMax,
+                              aMonotone,
+                              aBox,
+                              pLowBin,
+                              aOtherBox,
+                              pOtherBin) ||
+                           IsDeepPairViolated<bHessian, cCompilerScores>(cScores,
+                                 cRealDimensions,
+                                 bUpdateWithHessian,
+                                 regAlpha,
+                                 regLambda,
+                                 deltaStepMax,
+                                 aMonotone,
+                                 aHighBox,
+                                 pHighBin,
+                                 aOtherBox,
+                                 pOtherBin)) {
+                        goto next_split;
+                     }
+                  }
+               }
+
+               bestGain = gain;
+               pLeaf->m_iSplitDimension = iDim;
+               pLeaf->m_iSplit = iSplit;
+
+            next_split:;
+            }
+            aBox[iDim].m_iHigh = iHigh;
+         }
+
+         if(k_noSplitDimension != pLeaf->m_iSplitDimension) {
+            pLeaf->m_splitGain = bestGain - gainParent;
+            EBM_ASSERT(k_gainMin <= pLeaf->m_splitGain);
+         }
+      };
+
+      DeepLeaf* const pRoot = &aLeaves[0];
+      for(size_t iDim = 0; iDim < cRealDimensions; ++iDim) {
+         pRoot->m_aBox[iDim].m_iLow = 0;
+         pRoot->m_aBox[iDim].m_iHigh = acRealBins[iDim];
+         pRoot->m_aBox[iDim].m_cBins = acRealBins[iDim];
+      }
+      aLeafBins->Copy(cScores, *pTotal);
+
+      size_t cLeaves = 1;
+      FloatCalc totalGain = 0;
+      FindBestSplit(0, cLeaves);
+      while(cLeaves < cLeavesMax) {
+         size_t iBestLeaf = cLeaves;
+         FloatCalc bestSplitGain = 0;
+         for(size_t iLeaf = 0; iLeaf < cLeaves; ++iLeaf) {
+            const DeepLeaf* const pLeaf = &aLeaves[iLeaf];
+            if(k_noSplitDimension != pLeaf->m_iSplitDimension && bestSplitGain < pLeaf->m_splitGain) {
+               bestSplitGain = pLeaf->m_splitGain;
+               iBestLeaf = iLeaf;
+            }
+         }
+         if(cLeaves == iBestLeaf) {
+            break;
+         }
+
+         DeepLeaf* const pLeaf = &aLeaves[iBestLeaf];
+         const size_t iDim = pLeaf->m_iSplitDimension;
+         const size_t iSplit = pLeaf->m_iSplit;
+
+         if(nullptr != aMonotoneDimensions) {
+            // leaves split since this split was found may now sit next to it, so check it again before using it
+            const FloatCalc splitGainPrev = pLeaf->m_splitGain;
+            FindBestSplit(iBestLeaf, cLeaves);
+            if(pLeaf->m_iSplitDimension != iDim || pLeaf->m_iSplit != iSplit ||
+                  pLeaf->m_splitGain != splitGainPrev) {
+               continue;
+            }
+         }
+
+         // the low side stays in the existing leaf and the high side becomes a new leaf
+         DeepLeaf* const pNewLeaf = &aLeaves[cLeaves];
+         memcpy(pNewLeaf->m_aBox, pLeaf->m_aBox, sizeof(*pLeaf->m_aBox) * cRealDimensions);
+         pNewLeaf->m_aBox[iDim].m_iLow = iSplit;
+         pLeaf->m_aBox[iDim].m_iHigh = iSplit;
+
+         auto* const pLeafBin = IndexBin(aLeafBins, cBytesPerBin * iBestLeaf);
+         auto* const pNewLeafBin = IndexBin(aLeafBins, cBytesPerBin * cLeaves);
+         TensorTotalsSum<bHessian, cCompilerScores, cCompilerDimensions>(cScores,
+               cRealDimensions,
+               pLeaf->m_aBox,
+               aBins,
+               *pLowBin,
+               pLowBin->GetGradientPairs()
+#ifndef NDEBUG
+                     ,
+               aDebugCopyBins,
+               pBinsEndDebug
+#endif // NDEBUG
+         );
+         pNewLeafBin->Copy(cScores, *pLeafBin);
+         pNewLeafBin->Subtract(cScores, *pLowBin);
+         pLeafBin->Copy(cScores, *pLowBin);
+
+         totalGain += pLeaf->m_splitGain;
+         ++cLeaves;
+
+         EBM_ASSERT(size_t{0} != acSplitsLeft[iDim]);
+         --acSplitsLeft[iDim];
+
+         FindBestSplit(iBestLeaf, cLeaves);
+         FindBestSplit(cLeaves - 1, cLeaves);
+         if(size_t{0} == acSplitsLeft[iDim]) {
+            // the best splits of other leaves may have used this dimension
+            for(size_t iLeaf = 0; iLeaf < cLeaves; ++iLeaf) {
+               if(aLeaves[iLeaf].m_iSplitDimension == iDim) {
+                  FindBestSplit(iLeaf, cLeaves);
+               }
+            }
+         }
+      }
+
+      *pTotalGain = 0;
+      if(UNLIKELY(bOverflow) || UNLIKELY(/* NaN */ !LIKELY(totalGain <= std::numeric_limits<FloatCalc>::max()))) {
+         // signal that we've hit an overflow.  Use +inf here since our caller likes that and will flip to -inf
+         *pTotalGain = std::numeric_limits<double>::infinity();
+         cLeaves = 1;
+         aLeafBins->Copy(cScores, *pTotal);
+      } else if(size_t{1} != cLeaves) {
+         EBM_ASSERT(k_gainMin <= totalGain);
+         *pTotalGain = static_cast<double>(totalGain);
+      }
+
+      if(size_t{1} == cLeaves) {
+         // there were no good splits found
+         pInnerTermUpdate->Reset();
+
+         // we don't need to call pInnerTermUpdate->EnsureTensorScoreCapacity,
+         // since our value capacity would be 1, which is pre-allocated
+
+         FloatScore* const aUpdateScores = pInnerTermUpdate->GetTensorScoresPointer();
+         const auto* const aGradientPairs = pTotal->GetGradientPairs();
+         FloatCalc hess = static_cast<FloatCalc>(pTotal->GetWeight());
+         for(size_t iScore = 0; iScore < cScores; ++iScore) {
+            if(bUpdateWithHessian) {
+               hess = static_cast<FloatCalc>(aGradientPairs[iScore].GetHess());
+            }
+            const FloatCalc update = -CalcNegUpdate<true>(static_cast<FloatCalc>(aGradientPairs[iScore].m_sumGradients),
+                  hess,
+                  regAlpha,
+                  regLambda,
+                  deltaStepMax);
+            aUpdateScores[iScore] = static_cast<FloatScore>(update);
+         }
+
+         if(nullptr != aTensorWeights || nullptr != aTensorGrad || nullptr != aTensorHess) {
+            FloatCalc tensorHess = static_cast<FloatCalc>(pTotal->GetWeight());
+            if(nullptr != aTensorWeights) {
+               aTensorWeights[0] = tensorHess;
+            }
+            for(size_t iScore = 0; iScore < cScores; ++iScore) {
+               if(nullptr != aTensorHess) {
+                  if(bUseLogitBoost) {
+                     tensorHess = static_cast<FloatCalc>(aGradientPairs[iScore].GetHess());
+                  }
+                  aTensorHess[iScore] = tensorHess;
+               }
+               if(nullptr != aTensorGrad) {
+                  aTensorGrad[iScore] = static_cast<FloatCalc>(aGradientPairs[iScore].m_sumGradients);
+               }
+            }
+         }
+
+         return Error_None;
+      }
+
+      // The tensor needs a slice boundary wherever any leaf starts.  aSliceIndexes maps each bin of a dimension to
+      // the slice that holds it, after first marking the bins that start a slice.
+      size_t acSlices[k_cDimensionsMax];
+      size_t* aDimSliceIndexes = aSliceIndexes;
+      size_t cTensorCells = 1;
+      for(size_t iDim = 0; iDim < cRealDimensions; ++iDim) {
+         const size_t cBins = acRealBins[iDim];
+         memset(aDimSliceIndexes, 0, sizeof(*aDimSliceIndexes) * cBins);
+         for(size_t iLeaf = 0; iLeaf < cLeaves; ++iLeaf) {
+            aDimSliceIndexes[aLeaves[iLeaf].m_aBox[iDim].m_iLow] = 1;
+         }
+         const size_t iOriginalDimension = aiOriginalIndex[iDim];
+         size_t cSplits = 0;
+         for(size_t iBin = 1; iBin < cBins; ++iBin) {
+            cSplits += aDimSliceIndexes[iBin];
+         }
+         error = pInnerTermUpdate->SetCountSlices(iOriginalDimension, cSplits + 1);
+         if(Error_None != error) {
+            // already logged
+            return error;
+         }
+         UIntSplit* pSplits = pInnerTermUpdate->GetSplitPointer(iOriginalDimension);
+         size_t iSlice = 0;
+         aDimSliceIndexes[0] = 0;
+         for(size_t iBin = 1; iBin < cBins; ++iBin) {
+            if(size_t{0} != aDimSliceIndexes[iBin]) {
+               *pSplits = static_cast<UIntSplit>(iBin);
+               ++pSplits;
+               ++iSlice;
+            }
+            aDimSliceIndexes[iBin] = iSlice;
+         }
+         acSlices[iDim] = cSplits + 1;
+         cTensorCells *= cSplits + 1;
+         aDimSliceIndexes += cBins;
+      }
+
+      error = pInnerTermUpdate->EnsureTensorScoreCapacity(cScores * cTensorCells);
+      if(Error_None != error) {
+         // already logged
+         return error;
+      }
+      FloatScore* const aUpdateScores = pInnerTermUpdate->GetTensorScoresPointer();
+
+      // every tensor cell lies inside exactly one leaf, so fill the cells of each leaf with its update
+      for(size_t iLeaf = 0; iLeaf < cLeaves; ++iLeaf) {
+         const DeepLeaf* const pLeaf = &aLeaves[iLeaf];
+         const auto* const pLeafBin = IndexBin(aLeafBins, cBytesPerBin * iLeaf);
+         const auto* const aGradientPairs = pLeafBin->GetGradientPairs();
+
+         size_t aiSliceFirst[k_cDimensionsMax];
+         size_t aiSliceLast[k_cDimensionsMax];
+         size_t aiSliceCur[k_cDimensionsMax];
+         const size_t* aDimSliceIndexesCur = aSliceIndexes;
+         for(size_t iDim = 0; iDim < cRealDimensions; ++iDim) {
+            aiSliceFirst[iDim] = aDimSliceIndexesCur[pLeaf->m_aBox[iDim].m_iLow];
+            aiSliceLast[iDim] = aDimSliceIndexesCur[pLeaf->m_aBox[iDim].m_iHigh - 1];
+            aiSliceCur[iDim] = aiSliceFirst[iDim];
+            aDimSliceIndexesCur += acRealBins[iDim];
+         }
+
+         while(true) {
+            size_t iCell = 0;
+            size_t cStride = 1;
+            for(size_t iDim = 0; iDim < cRealDimensions; ++iDim) {
+               iCell += aiSliceCur[iDim] * cStride;
+               cStride *= acSlices[iDim];
+            }
+            FloatScore* const pCellScores = &aUpdateScores[iCell * cScores];
+            FloatCalc hess = static_cast<FloatCalc>(pLeafBin->GetWeight());
+            for(size_t iScore = 0; iScore < cScores; ++iScore) {
+               if(bUpdateWithHessian) {
+                  hess = static_cast<FloatCalc>(aGradientPairs[iScore].GetHess());
+               }
+               const FloatCalc update =
+                     -CalcNegUpdate<true>(static_cast<FloatCalc>(aGradientPairs[iScore].m_sumGradients),
+                           hess,
+                           regAlpha,
+                           regLambda,
+                           deltaStepMax);
+               pCellScores[iScore] = static_cast<FloatScore>(update);
+            }
+
+            size_t iDim = 0;
+            while(true) {
+               if(aiSliceCur[iDim] != aiSliceLast[iDim]) {
+                  ++aiSliceCur[iDim];
+                  break;
+               }
+               aiSliceCur[iDim] = aiSliceFirst[iDim];
+               ++iDim;
+               if(cRealDimensions == iDim) {
+                  goto done_leaf;
+               }
+            }
+         }
+      done_leaf:;
+      }
+
+      if(nullptr != aTensorWeights || nullptr != aTensorGrad || nullptr != aTensorHess) {
+         // purification works on the tensor cells rather than the leaves, so sum each cell
+         double* pTensorWeights = aTensorWeights;
+         double* pTensorGrad = aTensorGrad;
+         double* pTensorHess = aTensorHess;
+
+         TensorSumDimension aCell[k_cDimensionsMax];
+         size_t aiSlice[k_cDimensionsMax];
+         for(size_t iDim = 0; iDim < cRealDimensions; ++iDim) {
+            aiSlice[iDim] = 0;
+            aCell[iDim].m_cBins = acRealBins[iDim];
+            aCell[iDim].m_iLow = 0;
+            aCell[iDim].m_iHigh = 1 == acSlices[iDim] ?
+                  acRealBins[iDim] :
+                  static_cast<size_t>(pInnerTermUpdate->GetSplitPointer(aiOriginalIndex[iDim])[0]);
+         }
+         while(true) {
+            TensorTotalsSum<bHessian, cCompilerScores, cCompilerDimensions>(cScores,
+                  cRealDimensions,
+                  aCell,
+                  aBins,
+                  *pLowBin,
+                  pLowBin->GetGradientPairs()
+#ifndef NDEBUG
+                        ,
+                  aDebugCopyBins,
+                  pBinsEndDebug
+#endif // NDEBUG
+            );
+            FloatCalc tensorHess = static_cast<FloatCalc>(pLowBin->GetWeight());
+            if(nullptr != pTensorWeights) {
+               *pTensorWeights = tensorHess;
+               ++pTensorWeights;
+            }
+            const auto* const aGradientPairs = pLowBin->GetGradientPairs();
+            for(size_t iScore = 0; iScore < cScores; ++iScore) {
+               if(nullptr != pTensorHess) {
+                  if(bUseLogitBoost) {
+                     tensorHess = static_cast<FloatCalc>(aGradientPairs[iScore].GetHess());
+                  }
+                  *pTensorHess = tensorHess;
+                  ++pTensorHess;
+               }
+               if(nullptr != pTensorGrad) {
+                  *pTensorGrad = static_cast<FloatCalc>(aGradientPairs[iScore].m_sumGradients);
+                  ++pTensorGrad;
+               }
+            }
+
+            size_t iDim = 0;
+            while(true) {
+               const UIntSplit* const aSplits = pInnerTermUpdate->GetSplitPointer(aiOriginalIndex[iDim]);
+               const size_t iSlice = aiSlice[iDim] + 1;
+               if(iSlice < acSlices[iDim]) {
+                  aCell[iDim].m_iLow = aCell[iDim].m_iHigh;
+                  aCell[iDim].m_iHigh =
+                        acSlices[iDim] - 1 == iSlice ? acRealBins[iDim] : static_cast<size_t>(aSplits[iSlice]);
+                  aiSlice[iDim] = iSlice;
+                  break;
+               }
+               aiSlice[iDim] = 0;
+               aCell[iDim].m_iLow = 0;
+               aCell[iDim].m_iHigh = 1 == acSlices[iDim] ? acRealBins[iDim] : static_cast<size_t>(aSplits[0]);
+               ++iDim;
+               if(cRealDimensions == iDim) {
+                  goto done_cells;
+               }
+            }
+         }
+      done_cells:;
+      }
+
+      return Error_None;
+   }
+   WARNING_POP
+};
+
+template<bool bHessian, size_t cPossibleScores> class PartitionMultiDimensionalDeepTarget final {
+ public:
+   PartitionMultiDimensionalDeepTarget() = delete; // this is a static class.  Do not construct
+
+   INLINE_RELEASE_UNTEMPLATED static ErrorEbm Func(BoosterShell* const pBoosterShell,
+         const size_t cRuntimeScores,
+         const size_t cDimensions,
+         const size_t cRealDimensions,
+         const TermBoostFlags flags,
+         const size_t cSamplesLeafMin,
+         const FloatCalc hessianMin,
+         const FloatCalc regAlpha,
+         const FloatCalc regLambda,
+         const FloatCalc deltaStepMax,
+         const BinBase* const aBinsBase,
+         BinBase* const aAuxiliaryBinsBase,
+         Tensor* const pInnerTermUpdate,
+         const size_t* const acBins,
+         const IntEbm* const aLeavesMax,
+         const MonotoneDimension* const aMonotoneDimensions,
+         double* const aTensorWeights,
+         double* const aTensorGrad,
+         double* const aTensorHess,
+         double* const pTotalGain
+#ifndef NDEBUG
+         ,
+         const BinBase* const aDebugCopyBinsBase,
+         const BinBase* const pBinsEndDebug
+#endif // NDEBUG
+   ) {
+      if(cPossibleScores == cRuntimeScores) {
+         return PartitionMultiDimensionalDeepInternal<bHessian, cPossibleScores>::Func(pBoosterShell,
+               cRuntimeScores,
+               cDimensions,
+               cRealDimensions,
+               flags,
+               cSamplesLeafMin,
+               hessianMin,
+               regAlpha,
+               regLambda,
+               deltaStepMax,
+               aBinsBase,
+               aAuxiliaryBinsBase,
+               pInnerTermUpdate,
+               acBins,
+               aLeavesMax,
+               aMonotoneDimensions,
+               aTensorWeights,
+               aTensorGrad,
+               aTensorHess,
+               pTotalGain
+#ifndef NDEBUG
+               ,
+               aDebugCopyBinsBase,
+               pBinsEndDebug
+#endif // NDEBUG
+         );
+      } else {
+         return PartitionMultiDimensionalDeepTarget<bHessian, cPossibleScores + 1>::Func(pBoosterShell,
+               cRuntimeScores,
+               cDimensions,
+               cRealDimensions,
+               flags,
+               cSamplesLeafMin,
+               hessianMin,
+               regAlpha,
+               regLambda,
+               deltaStepMax,
+               aBinsBase,
+               aAuxiliaryBinsBase,
+               pInnerTermUpdate,
+               acBins,
+               aLeavesMax,
+               aMonotoneDimensions,
+               aTensorWeights,
+               aTensorGrad,
+               aTensorHess,
+               pTotalGain
+#ifndef NDEBUG
+               ,
+               aDebugCopyBinsBase,
+               pBinsEndDebug
+#endif // NDEBUG
+         );
+      }
+   }
+};
+
+template<bool bHessian> class PartitionMultiDimensionalDeepTarget<bHessian, k_cCompilerScoresMax + 1> final {
+ public:
+   PartitionMultiDimensionalDeepTarget() = delete; // this is a static class.  Do not construct
+
+   INLINE_RELEASE_UNTEMPLATED static ErrorEbm Func(BoosterShell* const pBoosterShell,
+         const size_t cRuntimeScores,
+         const size_t cDimensions,
+         const size_t cRealDimensions,
+         const TermBoostFlags flags,
+         const size_t cSamplesLeafMin,
+         const FloatCalc hessianMin,
+         const FloatCalc regAlpha,
+         const FloatCalc regLambda,
+         const FloatCalc deltaStepMax,
+         const BinBase* const aBinsBase,
+         BinBase* const aAuxiliaryBinsBase,
+         Tensor* const pInnerTermUpdate,
+         const size_t* const acBins,
+         const IntEbm* const aLeavesMax,
+         const MonotoneDimension* const aMonotoneDimensions,
+         double* const aTensorWeights,
+         double* const aTensorGrad,
+         double* const aTensorHess,
+         double* const pTotalGain
+#ifndef NDEBUG
+         ,
+         const BinBase* const aDebugCopyBinsBase,
+         const BinBase* const pBinsEndDebug
+#endif // NDEBUG
+   ) {
+      return PartitionMultiDimensionalDeepInternal<bHessian, k_dynamicScores>::Func(pBoosterShell,
+            cRuntimeScores,
+            cDimensions,
+            cRealDimensions,
+            flags,
+            cSamplesLeafMin,
+            hessianMin,
+            regAlpha,
+            regLambda,
+            deltaStepMax,
+            aBinsBase,
+            aAuxiliaryBinsBase,
+            pInnerTermUpdate,
+            acBins,
+            aLeavesMax,
+            aMonotoneDimensions,
+            aTensorWeights,
+            aTensorGrad,
+            aTensorHess,
+            pTotalGain
+#ifndef NDEBUG
+            ,
+            aDebugCopyBinsBase,
+            pBinsEndDebug
+#endif // NDEBUG
+      );
+   }
+};
+
+extern ErrorEbm PartitionMultiDimensionalDeep(BoosterShell* const pBoosterShell,
+      const bool bHessian,
+      const size_t cRuntimeScores,
+      const size_t cDimensions,
+      const size_t cRealDimensions,
+      const TermBoostFlags flags,
+      const size_t cSamplesLeafMin,
+      const FloatCalc hessianMin,
+      const FloatCalc regAlpha,
+      const FloatCalc regLambda,
+      const FloatCalc deltaStepMax,
+      const BinBase* const aBinsBase,
+      BinBase* const aAuxiliaryBinsBase,
+      Tensor* const pInnerTermUpdate,
+      const size_t* const acBins,
+      const IntEbm* const aLeavesMax,
+      const MonotoneDimension* const aMonotoneDimensions,
+      double* const aTensorWeights,
+      double* const aTensorGrad,
+      double* const aTensorHess,
+      double* const pTotalGain
+#ifndef NDEBUG
+      ,
+      const BinBase* const aDebugCopyBinsBase,
+      const BinBase* const pBinsEndDebug
+#endif // NDEBUG
+) {
+   ErrorEbm error;
+
+   EBM_ASSERT(1 <= cRuntimeScores);
+   if(bHessian) {
+      if(size_t{1} != cRuntimeScores) {
+         // muticlass
+         error = PartitionMultiDimensionalDeepTarget<true, k_cCompilerScoresStart>::Func(pBoosterShell,
+               cRuntimeScores,
+               cDimensions,
+               cRealDimensions,
+               flags,
+               cSamplesLeafMin,
+               hessianMin,
+               regAlpha,
+               regLambda,
+               deltaStepMax,
+               aBinsBase,
+               aAuxiliaryBinsBase,
+               pInnerTermUpdate,
+               acBins,
+               aLeavesMax,
+               aMonotoneDimensions,
+               aTensorWeights,
+               aTensorGrad,
+               aTensorHess,
+               pTotalGain
+#ifndef NDEBUG
+               ,
+               aDebugCopyBinsBase,
+               pBinsEndDebug
+#endif // NDEBUG
+         );
+      } else {
+         error = PartitionMultiDimensionalDeepInternal<true, k_oneScore>::Func(pBoosterShell,
+               cRuntimeScores,
+               cDimensions,
+               cRealDimensions,
+               flags,
+               cSamplesLeafMin,
+               hessianMin,
+               regAlpha,
+               regLambda,
+               deltaStepMax,
+               aBinsBase,
+               aAuxiliaryBinsBase,
+               pInnerTermUpdate,
+               acBins,
+               aLeavesMax,
+               aMonotoneDimensions,
+               aTensorWeights,
+               aTensorGrad,
+               aTensorHess,
+               pTotalGain
+#ifndef NDEBUG
+               ,
+               aDebugCopyBinsBase,
+               pBinsEndDebug
+#endif // NDEBUG
+         );
+      }
+   } else {
+      if(size_t{1} != cRuntimeScores) {
+         // Odd: gradient multiclass. Allow it, but do not optimize for it
+         error = PartitionMultiDimensionalDeepInternal<false, k_dynamicScores>::Func(pBoosterShell,
+               cRuntimeScores,
+               cDimensions,
+               cRealDimensions,
+               flags,
+               cSamplesLeafMin,
+               hessianMin,
+               regAlpha,
+               regLambda,
+               deltaStepMax,
+               aBinsBase,
+               aAuxiliaryBinsBase,
+               pInnerTermUpdate,
+               acBins,
+               aLeavesMax,
+               aMonotoneDimensions,
+               aTensorWeights,
+               aTensorGrad,
+               aTensorHess,
+               pTotalGain
+#ifndef NDEBUG
+               ,
+               aDebugCopyBinsBase,
+               pBinsEndDebug
+#endif // NDEBUG
+         );
+      } else {
+         error = PartitionMultiDimensionalDeepInternal<false, k_oneScore>::Func(pBoosterShell,
+               cRuntimeScores,
+               cDimensions,
+               cRealDimensions,
+               flags,
+               cSamplesLeafMin,
+               hessianMin,
+               regAlpha,
+               regLambda,
+               deltaStepMax,
+               aBinsBase,
+               aAuxiliaryBinsBase,
+               pInnerTermUpdate,
+               acBins,
+               aLeavesMax,
+               aMonotoneDimensions,
+               aTensorWeights,
+               aTensorGrad,
+               aTensorHess,
+               pTotalGain
+#ifndef NDEBUG
+               ,
+               aDebugCopyBinsBase,
+               pBinsEndDebug
+#endif // NDEBUG
+         );
+      }
+   }
+   return error;
+}
+
+} // namespace DEFINED_ZONE_NAME
@@ -6,6 +6,7 @@
 
 #include <stddef.h> // size_t, ptrdiff_t
 
+#include "libebm.h" // ErrorEbm
 #include "logging.h"
 #include "unzoned.h" // LIKELY
 
@@ -17,6 +18,7 @@
 
 #include "ebm_internal.hpp"
 #include "ebm_stats.hpp"
+#include "Tensor.hpp"
 #include "TensorTotalsSum.hpp"
 #include "InteractionCore.hpp"
 
@@ -25,24 +27,29 @@ namespace DEFINED_ZONE_NAME {
 #error DEFINED_ZONE_NAME must be defined
 #endif // DEFINED_ZONE_NAME
 
-// TODO: Modify this file so that it can return a boosting update corresponding to the straight cuts
-//       that were selected. After that we can use it for both boosting and interaction detection.
+// Finds the pair of straight cuts (one per dimension) that splits a pair tensor into the best 2x2 tensor.
+// Interaction detection only needs the gain, while boosting with TermBoostFlags_Straight also takes the
+// cuts in aiBestSplits and turns them into an update tensor, so both share this search.
 
 template<bool bHessian, size_t cCompilerScores> class PartitionMultiDimensionalStraightInternal final {
  public:
    PartitionMultiDimensionalStraightInternal() = delete; // this is a static class.  Do not construct
 
-   INLINE_RELEASE_UNTEMPLATED static double Func(InteractionCore* const pInteractionCore,
+   INLINE_RELEASE_UNTEMPLATED static double Func(const size_t cRuntimeScores,
          const size_t cRuntimeRealDimensions,
          const size_t* const acBins,
-         const CalcInteractionFlags flags,
+         const bool bPurify,
+         const bool bDisableNewton,
+         const bool bUpdateWithHessian,
          const size_t cSamplesLeafMin,
          const FloatCalc hessianMin,
          const FloatCalc regAlpha,
          const FloatCalc regLambda,
          const FloatCalc deltaStepMax,
+         const MonotoneDimension* const aMonotoneDimensions,
          BinBase* const aAuxiliaryBinsBase,
-         BinBase* const aBinsBase
+         const BinBase* const aBinsBase,
+         size_t* const aiBestSplits
 #ifndef NDEBUG
          ,
          const BinBase* const aDebugCopyBinsBase,
@@ -63,7 +70,7 @@ template<bool bHessian, size_t cCompilerScores> class PartitionMultiDimensionalS
                   ->Specialize<FloatMain, UIntMain, true, true, bHessian, GetArrayScores(cCompilerScores)>();
 #endif // NDEBUG
 
-      const size_t cScores = GET_COUNT_SCORES(cCompilerScores, pInteractionCore->GetCountScores());
+      const size_t cScores = GET_COUNT_SCORES(cCompilerScores, cRuntimeScores);
       const size_t cBytesPerBin = GetBinSize<FloatMain, UIntMain>(true, true, bHessian, cScores);
 
       const size_t cRealDimensions = GET_COUNT_DIMENSIONS(cCompilerDimensions, cRuntimeRealDimensions);
@@ -106,10 +113,12 @@ template<bool bHessian, size_t cCompilerScores> class PartitionMultiDimensionalS
 
       EBM_ASSERT(std::numeric_limits<FloatCalc>::min() <= hessianMin);
 
-      const bool bUseLogitBoost = bHessian && !(CalcInteractionFlags_DisableNewton & flags);
+      const bool bUseLogitBoost = bHessian && !bDisableNewton;
 
       // if a negative value were to occur, then it would be due to numeric instability, so clip it to zero here
       FloatCalc bestGain = 0;
+      size_t iBestX = 0;
+      size_t iBestY = 0;
 
       EBM_ASSERT(2 == cRealDimensions); // our TensorTotalsSum needs to be templated as dynamic if we want to have
                                         // something other than 2 dimensions
@@ -241,7 +250,7 @@ template<bool bHessian, size_t cCompilerScores> class PartitionMultiDimensionalS
                      goto next;
                   }
 
-                  if(CalcInteractionFlags_Purify & flags) {
+                  if(bPurify) {
                      // purified gain
 
                      // TODO: The interaction score is exactly equivalent to the gain calculated during
@@ -369,13 +378,68 @@ template<bool bHessian, size_t cCompilerScores> class PartitionMultiDimensionalS
                   }
                }
                // gain should be positive if we're dealing with unpurified updates
-               EBM_ASSERT(0 != (CalcInteractionFlags_Purify & flags) || std::isnan(gain) || 0 <= gain);
+               EBM_ASSERT(bPurify || std::isnan(gain) || 0 <= gain);
+
+               if(nullptr != aMonotoneDimensions) {
+                  // The 2x2 update has two cells below the cut and two above it along each dimension.  Reject the
+                  // cuts if either pair of neighbouring cells is ordered against the constraint.
+                  for(size_t iDim = 0; iDim < cRealDimensions; ++iDim) {
+                     const MonotoneDirection monotoneDirection = aMonotoneDimensions[iDim].m_direction;
+                     if(MONOTONE_NONE == monotoneDirection) {
+                        continue;
+                     }
+                     if((0 == iDim ? x : y) + 1 <= aMonotoneDimensions[iDim].m_iBinOrdered) {
+                        // the cells below the cut only hold missing values along this dimension
+                        continue;
+                     }
+                     const FloatMain aWeights[4] = {
+                           bin00.GetWeight(), bin01.GetWeight(), bin10.GetWeight(), bin11.GetWeight()};
+                     for(size_t iScore = 0; iScore < cScores; ++iScore) {
+                        FloatCalc negUpdates[4];
+                        const GradientPair<FloatMain, bHessian>* const apGradientPairs[4] = {
+                              &aGradientPairs00[iScore],
+                              &aGradientPairs01[iScore],
+                              &aGradientPairs10[iScore],
+                              &aGradientPairs11[iScore]};
+                        for(size_t iCell = 0; iCell < 4; ++iCell) {
+                           const FloatCalc hess = static_cast<FloatCalc>(
+                                 bUpdateWithHessian ? apGradientPairs[iCell]->GetHess() : aWeights[iCell]);
+                           negUpdates[iCell] =
+                                 CalcNegUpdate<true>(static_cast<FloatCalc>(apGradientPairs[iCell]->m_sumGradients),
+                                       hess,
+                                       regAlpha,
+                                       regLambda,
+                                       deltaStepMax);
+                        }
+                        // cells are ordered with dimension 0 changing fastest, so the cell above iCell along
+                        // dimension iDim is at iCell + (1 << iDim)
+                        const size_t iAbove = size_t{1} << iDim;
+                        const size_t iOther = size_t{1} << (1 - iDim);
+                        for(size_t iBelow = 0; iBelow <= iOther; iBelow += iOther) {
+                           const FloatCalc negUpdateBelow = negUpdates[iBelow];
+                           const FloatCalc negUpdateAbove = negUpdates[iBelow + iAbove];
+                           if(MonotoneDirection{0} < monotoneDirection) {
+                              if(negUpdateBelow < negUpdateAbove) {
+                                 goto next;
+                              }
+                           } else {
+                              EBM_ASSERT(monotoneDirection < MonotoneDirection{0});
+                              if(negUpdateAbove < negUpdateBelow) {
+                                 goto next;
+                              }
+                           }
+                        }
+                     }
+                  }
+               }
 
                // If we get a NaN result, we'd like to propagate it by making bestGain NaN.
                // The rules for NaN values say that non equality comparisons are all false so,
                // let's flip this comparison such that it should be true for NaN values.
                if(UNLIKELY(/* NaN */ !LIKELY(gain <= bestGain))) {
                   bestGain = gain;
+                  iBestX = x;
+                  iBestY = y;
                } else {
                   EBM_ASSERT(!std::isnan(gain));
                }
@@ -391,12 +455,16 @@ template<bool bHessian, size_t cCompilerScores> class PartitionMultiDimensionalS
       // we start from zero, so bestGain can't be negative here
       EBM_ASSERT(std::isnan(bestGain) || 0 <= bestGain);
 
+      // the cut in each dimension is the count of bins on its low side
+      aiBestSplits[0] = iBestX + 1;
+      aiBestSplits[1] = iBestY + 1;
+
       if(FloatCalc{0} < bestGain) {
          // For purified, our gain is from the improvemennt of having no update to the purified update,
          // which means the parent partial gain is zero since there would be no update with purified.
          // For non-purified, there would be an update even without a split, so the parent partial gain
          // needs to be subtracted.
-         if(!(CalcInteractionFlags_Purify & flags)) {
+         if(!bPurify) {
             // if we are detecting impure interaction then so far we have only calculated the children partial gain
             // but we still need to subtract the partial gain of the parent to have
             // gain. All the splits we've analyzed so far though had the same non-split partial gain, so we subtract it
@@ -431,35 +499,43 @@ template<bool bHessian, size_t cPossibleScores> class PartitionMultiDimensionalS
  public:
    PartitionMultiDimensionalStraightTarget() = delete; // this is a static class.  Do not construct
 
-   INLINE_RELEASE_UNTEMPLATED static double Func(InteractionCore* const pInteractionCore,
+   INLINE_RELEASE_UNTEMPLATED static double Func(const size_t cRuntimeScores,
          const size_t cRealDimensions,
          const size_t* const acBins,
-         const CalcInteractionFlags flags,
+         const bool bPurify,
+         const bool bDisableNewton,
+         const bool bUpdateWithHessian,
          const size_t cSamplesLeafMin,
          const FloatCalc hessianMin,
          const FloatCalc regAlpha,
          const FloatCalc regLambda,
          const FloatCalc deltaStepMax,
-         BinBase* aAuxiliaryBinsBase,
-         BinBase* const aBinsBase
+         const MonotoneDimension* const aMonotoneDimensions,
+         BinBase* const aAuxiliaryBinsBase,
+         const BinBase* const aBinsBase,
+         size_t* const aiBestSplits
 #ifndef NDEBUG
          ,
          const BinBase* const aDebugCopyBinsBase,
          const BinBase* const pBinsEndDebug
 #endif // NDEBUG
    ) {
-      if(cPossibleScores == pInteractionCore->GetCountScores()) {
-         return PartitionMultiDimensionalStraightInternal<bHessian, cPossibleScores>::Func(pInteractionCore,
+      if(cPossibleScores == cRuntimeScores) {
+         return PartitionMultiDimensionalStraightInternal<bHessian, cPossibleScores>::Func(cRuntimeScores,
                cRealDimensions,
                acBins,
-               flags,
+               bPurify,
+               bDisableNewton,
+               bUpdateWithHessian,
                cSamplesLeafMin,
                hessianMin,
                regAlpha,
                regLambda,
                deltaStepMax,
+               aMonotoneDimensions,
                aAuxiliaryBinsBase,
-               aBinsBase
+               aBinsBase,
+               aiBestSplits
 #ifndef NDEBUG
                ,
                aDebugCopyBinsBase,
@@ -467,17 +543,21 @@ template<bool bHessian, size_t cPossibleScores> class PartitionMultiDimensionalS
 #endif // NDEBUG
          );
       } else {
-         return PartitionMultiDimensionalStraightTarget<bHessian, cPossibleScores + 1>::Func(pInteractionCore,
+         return PartitionMultiDimensionalStraightTarget<bHessian, cPossibleScores + 1>::Func(cRuntimeScores,
                cRealDimensions,
                acBins,
-               flags,
+               bPurify,
+               bDisableNewton,
+               bUpdateWithHessian,
                cSamplesLeafMin,
                hessianMin,
                regAlpha,
                regLambda,
                deltaStepMax,
+               aMonotoneDimensions,
                aAuxiliaryBinsBase,
-               aBinsBase
+               aBinsBase,
+               aiBestSplits
 #ifndef NDEBUG
                ,
                aDebugCopyBinsBase,
@@ -492,34 +572,42 @@ template<bool bHessian> class PartitionMultiDimensionalStraightTarget<bHessian,
  public:
    PartitionMultiDimensionalStraightTarget() = delete; // this is a static class.  Do not construct
 
-   INLINE_RELEASE_UNTEMPLATED static double Func(InteractionCore* const pInteractionCore,
+   INLINE_RELEASE_UNTEMPLATED static double Func(const size_t cRuntimeScores,
          const size_t cRealDimensions,
          const size_t* const acBins,
-         const CalcInteractionFlags flags,
+         const bool bPurify,
+         const bool bDisableNewton,
+         const bool bUpdateWithHessian,
          const size_t cSamplesLeafMin,
          const FloatCalc hessianMin,
          const FloatCalc regAlpha,
          const FloatCalc regLambda,
          const FloatCalc deltaStepMax,
-         BinBase* aAuxiliaryBinsBase,
-         BinBase* const aBinsBase
+         const MonotoneDimension* const aMonotoneDimensions,
+         BinBase* const aAuxiliaryBinsBase,
+         const BinBase* const aBinsBase,
+         size_t* const aiBestSplits
 #ifndef NDEBUG
          ,
          const BinBase* const aDebugCopyBinsBase,
          const BinBase* const pBinsEndDebug
 #endif // NDEBUG
    ) {
-      return PartitionMultiDimensionalStraightInternal<bHessian, k_dynamicScores>::Func(pInteractionCore,
+      return PartitionMultiDimensionalStraightInternal<bHessian, k_dynamicScores>::Func(cRuntimeScores,
             cRealDimensions,
             acBins,
-            flags,
+            bPurify,
+            bDisableNewton,
+            bUpdateWithHessian,
             cSamplesLeafMin,
             hessianMin,
             regAlpha,
             regLambda,
             deltaStepMax,
+            aMonotoneDimensions,
             aAuxiliaryBinsBase,
-            aBinsBase
+            aBinsBase,
+            aiBestSplits
 #ifndef NDEBUG
             ,
             aDebugCopyBinsBase,
@@ -529,40 +617,47 @@ template<bool bHessian> class PartitionMultiDimensionalStraightTarget<bHessian,
    }
 };
 
-extern double PartitionMultiDimensionalStraight(InteractionCore* const pInteractionCore,
+static double FindStraightCuts(const bool bHessian,
+      const size_t cRuntimeScores,
       const size_t cRealDimensions,
       const size_t* const acBins,
-      const CalcInteractionFlags flags,
+      const bool bPurify,
+      const bool bDisableNewton,
+      const bool bUpdateWithHessian,
       const size_t cSamplesLeafMin,
       const FloatCalc hessianMin,
       const FloatCalc regAlpha,
       const FloatCalc regLambda,
       const FloatCalc deltaStepMax,
-      BinBase* aAuxiliaryBinsBase,
-      BinBase* const aBinsBase
+      const MonotoneDimension* const aMonotoneDimensions,
+      BinBase* const aAuxiliaryBinsBase,
+      const BinBase* const aBinsBase,
+      size_t* const aiBestSplits
 #ifndef NDEBUG
       ,
       const BinBase* const aDebugCopyBinsBase,
       const BinBase* const pBinsEndDebug
 #endif // NDEBUG
 ) {
-   const size_t cRuntimeScores = pInteractionCore->GetCountScores();
-
    EBM_ASSERT(1 <= cRuntimeScores);
-   if(pInteractionCore->IsHessian()) {
+   if(bHessian) {
       if(size_t{1} != cRuntimeScores) {
          // muticlass
-         return PartitionMultiDimensionalStraightTarget<true, k_cCompilerScoresStart>::Func(pInteractionCore,
+         return PartitionMultiDimensionalStraightTarget<true, k_cCompilerScoresStart>::Func(cRuntimeScores,
                cRealDimensions,
                acBins,
-               flags,
+               bPurify,
+               bDisableNewton,
+               bUpdateWithHessian,
                cSamplesLeafMin,
                hessianMin,
                regAlpha,
                regLambda,
                deltaStepMax,
+               aMonotoneDimensions,
                aAuxiliaryBinsBase,
-               aBinsBase
+               aBinsBase,
+               aiBestSplits
 #ifndef NDEBUG
                ,
                aDebugCopyBinsBase,
@@ -570,17 +665,21 @@ extern double PartitionMultiDimensionalStraight(InteractionCore* const pInteract
 #endif // NDEBUG
          );
       } else {
-         return PartitionMultiDimensionalStraightInternal<true, k_oneScore>::Func(pInteractionCore,
+         return PartitionMultiDimensionalStraightInternal<true, k_oneScore>::Func(cRuntimeScores,
                cRealDimensions,
                acBins,
-               flags,
+               bPurify,
+               bDisableNewton,
+               bUpdateWithHessian,
                cSamplesLeafMin,
                hessianMin,
                regAlpha,
                regLambda,
                deltaStepMax,
+               aMonotoneDimensions,
                aAuxiliaryBinsBase,
-               aBinsBase
+               aBinsBase,
+               aiBestSplits
 #ifndef NDEBUG
                ,
                aDebugCopyBinsBase,
@@ -591,17 +690,21 @@ extern double PartitionMultiDimensionalStraight(InteractionCore* const pInteract
    } else {
       if(size_t{1} != cRuntimeScores) {
          // Odd: gradient multiclass. Allow it, but do not optimize for it
-         return PartitionMultiDimensionalStraightInternal<false, k_dynamicScores>::Func(pInteractionCore,
+         return PartitionMultiDimensionalStraightInternal<false, k_dynamicScores>::Func(cRuntimeScores,
                cRealDimensions,
                acBins,
-               flags,
+               bPurify,
+               bDisableNewton,
+               bUpdateWithHessian,
                cSamplesLeafMin,
                hessianMin,
                regAlpha,
                regLambda,
                deltaStepMax,
+               aMonotoneDimensions,
                aAuxiliaryBinsBase,
-               aBinsBase
+               aBinsBase,
+               aiBestSplits
 #ifndef NDEBUG
                ,
                aDebugCopyBinsBase,
@@ -609,17 +712,21 @@ extern double PartitionMultiDimensionalStraight(InteractionCore* const pInteract
 #endif // NDEBUG
          );
       } else {
-         return PartitionMultiDimensionalStraightInternal<false, k_oneScore>::Func(pInteractionCore,
+         return PartitionMultiDimensionalStraightInternal<false, k_oneScore>::Func(cRuntimeScores,
                cRealDimensions,
                acBins,
-               flags,
+               bPurify,
+               bDisableNewton,
+               bUpdateWithHessian,
                cSamplesLeafMin,
                hessianMin,
                regAlpha,
                regLambda,
                deltaStepMax,
+               aMonotoneDimensions,
                aAuxiliaryBinsBase,
-               aBinsBase
+               aBinsBase,
+               aiBestSplits
 #ifndef NDEBUG
                ,
                aDebugCopyBinsBase,
@@ -630,4 +737,557 @@ extern double PartitionMultiDimensionalStraight(InteractionCore* const pInteract
    }
 }
 
+extern double PartitionMultiDimensionalStraight(InteractionCore* const pInteractionCore,
+      const size_t cRealDimensions,
+      const size_t* const acBins,
+      const CalcInteractionFlags flags,
+      const size_t cSamplesLeafMin,
+      const FloatCalc hessianMin,
+      const FloatCalc regAlpha,
+      const FloatCalc regLambda,
+      const FloatCalc deltaStepMax,
+      BinBase* aAuxiliaryBinsBase,
+      BinBase* const aBinsBase
+#ifndef NDEBUG
+      ,
+      const BinBase* const aDebugCopyBinsBase,
+      const BinBase* const pBinsEndDebug
+#endif // NDEBUG
+) {
+   // interaction detection only wants the gain, so the cuts are discarded
+   size_t aiBestSplits[2];
+   return FindStraightCuts(pInteractionCore->IsHessian(),
+         pInteractionCore->GetCountScores(),
+         cRealDimensions,
+         acBins,
+         0 != (CalcInteractionFlags_Purify & flags),
+         0 != (CalcInteractionFlags_DisableNewton & flags),
+         false,
+         cSamplesLeafMin,
+         hessianMin,
+         regAlpha,
+         regLambda,
+         deltaStepMax,
+         nullptr,
+         aAuxiliaryBinsBase,
+         aBinsBase,
+         aiBestSplits
+#ifndef NDEBUG
+         ,
+         aDebugCopyBinsBase,
+         pBinsEndDebug
+#endif // NDEBUG
+   );
+}
+
+template<bool bHessian>
+static double FindSingleStraightCut(const size_t cScores,
+      const size_t* const acRealBins,
+      const size_t iCutDimension,
+      const bool bDisableNewton,
+      const bool bUpdateWithHessian,
+      const size_t cSamplesLeafMin,
+      const FloatCalc hessianMin,
+      const FloatCalc regAlpha,
+      const FloatCalc regLambda,
+      const FloatCalc deltaStepMax,
+      const MonotoneDimension* const aMonotoneDimensions,
+      const BinBase* const aBinsBase,
+      BinBase* const aAuxiliaryBinsBase,
+      size_t* const aiBestSplits
+#ifndef NDEBUG
+      ,
+      const BinBase* const aDebugCopyBinsBase,
+      const BinBase* const pBinsEndDebug
+#endif // NDEBUG
+) {
+   // When the other dimension is capped at one leaf, the pair can only be cut along iCutDimension, so this scans the
+   // cuts of that dimension with the other dimension summed over its full range.  It runs once per boosting step, so
+   // like MakeStraightTensor it is not specialized on the number of scores.
+   static constexpr size_t cCompilerDimensions = 2;
+   static constexpr size_t cCells = 2;
+
+   const size_t cBytesPerBin = GetBinSize<FloatMain, UIntMain>(true, true, bHessian, cScores);
+
+   const auto* const aBins =
+         aBinsBase->Specialize<FloatMain, UIntMain, true, true, bHessian, GetArrayScores(k_dynamicScores)>();
+   auto* const aCells =
+         aAuxiliaryBinsBase->Specialize<FloatMain, UIntMain, true, true, bHessian, GetArrayScores(k_dynamicScores)>();
+
+#ifndef NDEBUG
+   const auto* const aDebugCopyBins =
+         aDebugCopyBinsBase->Specialize<FloatMain, UIntMain, true, true, bHessian, GetArrayScores(k_dynamicScores)>();
+#endif // NDEBUG
+
+   const bool bUseLogitBoost = bHessian && !bDisableNewton;
+   const size_t cBins = acRealBins[iCutDimension];
+   EBM_ASSERT(size_t{2} <= cBins);
+
+   FloatCalc bestGain = 0;
+   size_t iBestSplit = 0;
+   size_t iSplit = 1;
+   do {
+      TensorSumDimension aDimensions[cCompilerDimensions];
+      for(size_t iCell = 0; iCell < cCells; ++iCell) {
+         for(size_t iDimension = 0; iDimension < cCompilerDimensions; ++iDimension) {
+            aDimensions[iDimension].m_cBins = acRealBins[iDimension];
+            aDimensions[iDimension].m_iLow = 0;
+            aDimensions[iDimension].m_iHigh = acRealBins[iDimension];
+         }
+         if(0 != iCell) {
+            aDimensions[iCutDimension].m_iLow = iSplit;
+         } else {
+            aDimensions[iCutDimension].m_iHigh = iSplit;
+         }
+         auto* const pCell = IndexBin(aCells, cBytesPerBin * iCell);
+         ASSERT_BIN_OK(cBytesPerBin, pCell, pBinsEndDebug);
+         TensorTotalsSum<bHessian, k_dynamicScores, cCompilerDimensions>(cScores,
+               cCompilerDimensions,
+               aDimensions,
+               aBins,
+               *pCell,
+               pCell->GetGradientPairs()
+#ifndef NDEBUG
+                     ,
+               aDebugCopyBins,
+               pBinsEndDebug
+#endif // NDEBUG
+         );
+         if(pCell->GetCountSamples() < cSamplesLeafMin) {
+            goto next;
+         }
+      }
+
+      {
+         const auto* const pLow = IndexBin(aCells, cBytesPerBin * 0);
+         const auto* const pHigh = IndexBin(aCells, cBytesPerBin * 1);
+         const MonotoneDirection monotoneDirection =
+               nullptr == aMonotoneDimensions ? MONOTONE_NONE : aMonotoneDimensions[iCutDimension].m_direction;
+         const bool bCheckMonotone =
+               MONOTONE_NONE != monotoneDirection && aMonotoneDimensions[iCutDimension].m_iBinOrdered < iSplit;
+
+         FloatCalc gain = 0;
+         for(size_t iScore = 0; iScore < cScores; ++iScore) {
+            const auto* const pGradientPairLow = &pLow->GetGradientPairs()[iScore];
+            const auto* const pGradientPairHigh = &pHigh->GetGradientPairs()[iScore];
+            const FloatCalc gradLow = static_cast<FloatCalc>(pGradientPairLow->m_sumGradients);
+            const FloatCalc gradHigh = static_cast<FloatCalc>(pGradientPairHigh->m_sumGradients);
+            const FloatCalc hessLow =
+                  static_cast<FloatCalc>(bUseLogitBoost ? pGradientPairLow->GetHess() : pLow->GetWeight());
+            const FloatCalc hessHigh =
+                  static_cast<FloatCalc>(bUseLogitBoost ? pGradientPairHigh->GetHess() : pHigh->GetWeight());
+            if(hessLow < hessianMin || hessHigh < hessianMin) {
+               goto next;
+            }
+
+            if(bCheckMonotone) {
+               const FloatCalc negUpdateLow = CalcNegUpdate<true>(gradLow,
+                     static_cast<FloatCalc>(bUpdateWithHessian ? pGradientPairLow->GetHess() : pLow->GetWeight()),
+                     regAlpha,
+                     regLambda,
+                     deltaStepMax);
+               const FloatCalc negUpdateHigh = CalcNegUpdate<true>(gradHigh,
+                     static_cast<FloatCalc>(bUpdateWithHessian ? pGradientPairHigh->GetHess() : pHigh->GetWeight()),
+                     regAlpha,
+                     regLambda,
+                     deltaStepMax);
+               if(MonotoneDirection{0} < monotoneDirection) {
+                  if(negUpdateLow < negUpdateHigh) {
+                     goto next;
+                  }
+               } else {
+                  EBM_ASSERT(monotoneDirection < MonotoneDirection{0});
+                  if(negUpdateHigh < negUpdateLow) {
+                     goto next;
+                  }
+               }
+            }
+
+            gain += CalcPartialGain<false>(gradLow, hessLow, regAlpha, regLambda, deltaStepMax);
+            gain += CalcPartialGain<false>(gradHigh, hessHigh, regAlpha, regLambda, deltaStepMax);
+         }
+         EBM_ASSERT(std::isnan(gain) || 0 <= gain);
+
+         // flip the comparison so that a NaN gain propagates into bestGain
+         if(UNLIKELY(/* NaN */ !LIKELY(gain <= bestGain))) {
+            bestGain = gain;
+            iBestSplit = iSplit;
+         } else {
+            EBM_ASSERT(!std::isnan(gain));
+         }
+      }
+
+   next:;
+
+      ++iSplit;
+   } while(cBins != iSplit);
+
+   // 0 leaves the other dimension uncut
+   aiBestSplits[0] = 0;
+   aiBestSplits[1] = 0;
+   aiBestSplits[iCutDimension] = iBestSplit;
+
+   if(FloatCalc{0} < bestGain) {
+      // the bin before the aAuxiliaryBins is the last summation bin of aBinsBase, which contains the totals of all bins
+      const auto* const pTotal = NegativeIndexBin(aCells, cBytesPerBin);
+      const auto* const aGradientPairs = pTotal->GetGradientPairs();
+      for(size_t iScore = 0; iScore < cScores; ++iScore) {
+         const FloatCalc hess =
+               static_cast<FloatCalc>(bUseLogitBoost ? aGradientPairs[iScore].GetHess() : pTotal->GetWeight());
+         EBM_ASSERT(hessianMin <= hess);
+         bestGain -= CalcPartialGain<false>(
+               static_cast<FloatCalc>(aGradientPairs[iScore].m_sumGradients), hess, regAlpha, regLambda, deltaStepMax);
+      }
+   }
+   return static_cast<double>(bestGain);
+}
+
+template<bool bHessian>
+static ErrorEbm MakeStraightTensor(const size_t cScores,
+      const size_t* const acRealBins,
+      const size_t* const aiOriginalIndex,
+      const size_t* const aiSplits,
+      const bool bPurifyUpdate,
+      const bool bUpdateWithHessian,
+      const FloatCalc regAlpha,
+      const FloatCalc regLambda,
+      const FloatCalc deltaStepMax,
+      const BinBase* const aBinsBase,
+      BinBase* const aAuxiliaryBinsBase,
+      Tensor* const pInnerTermUpdate
+#ifndef NDEBUG
+      ,
+      const BinBase* const aDebugCopyBinsBase,
+      const BinBase* const pBinsEndDebug
+#endif // NDEBUG
+) {
+   // this runs once per boosting step on at most 4 cells, so it is not worth specializing on the number of scores.
+   // A split of 0 leaves that dimension uncut, which FindSingleStraightCut uses for a dimension capped at one leaf.
+   static constexpr size_t cCompilerDimensions = 2;
+
+   ErrorEbm error;
+
+   const size_t cBytesPerBin = GetBinSize<FloatMain, UIntMain>(true, true, bHessian, cScores);
+
+   const auto* const aBins =
+         aBinsBase->Specialize<FloatMain, UIntMain, true, true, bHessian, GetArrayScores(k_dynamicScores)>();
+   auto* const aCells =
+         aAuxiliaryBinsBase->Specialize<FloatMain, UIntMain, true, true, bHessian, GetArrayScores(k_dynamicScores)>();
+
+#ifndef NDEBUG
+   const auto* const aDebugCopyBins =
+         aDebugCopyBinsBase->Specialize<FloatMain, UIntMain, true, true, bHessian, GetArrayScores(k_dynamicScores)>();
+#endif // NDEBUG
+
+   if(nullptr == aiSplits) {
+      // no cuts, so the update is a single cell.  Purified, a single cell has nothing left after removing its mean
+      pInnerTermUpdate->Reset();
+      if(!bPurifyUpdate) {
+         // the bin before the aAuxiliaryBins is the last summation bin of aBinsBase,
+         // which contains the totals of all bins
+         const auto* const pTotal = NegativeIndexBin(aCells, cBytesPerBin);
+         ASSERT_BIN_OK(cBytesPerBin, pTotal, pBinsEndDebug);
+         const auto* const aGradientPairs = pTotal->GetGradientPairs();
+         FloatScore* const aUpdateScores = pInnerTermUpdate->GetTensorScoresPointer();
+         for(size_t iScore = 0; iScore < cScores; ++iScore) {
+            const FloatCalc hess =
+                  static_cast<FloatCalc>(bUpdateWithHessian ? aGradientPairs[iScore].GetHess() : pTotal->GetWeight());
+            const FloatCalc update =
+                  -CalcNegUpdate<true>(static_cast<FloatCalc>(aGradientPairs[iScore].m_sumGradients),
+                        hess,
+                        regAlpha,
+                        regLambda,
+                        deltaStepMax);
+            aUpdateScores[iScore] = static_cast<FloatScore>(update);
+         }
+      }
+      return Error_None;
+   }
+
+   // the cut dimensions, in order, so that cells are ordered like the tensor with the first cut dimension changing
+   // fastest
+   size_t aiCutDimensions[cCompilerDimensions];
+   size_t cCutDimensions = 0;
+   for(size_t iDimension = 0; iDimension < cCompilerDimensions; ++iDimension) {
+      if(size_t{0} != aiSplits[iDimension]) {
+         aiCutDimensions[cCutDimensions] = iDimension;
+         ++cCutDimensions;
+      }
+   }
+   EBM_ASSERT(size_t{1} <= cCutDimensions);
+   const size_t cCells = size_t{1} << cCutDimensions;
+
+   pInnerTermUpdate->Reset();
+   error = pInnerTermUpdate->EnsureTensorScoreCapacity(cScores * cCells);
+   if(Error_None != error) {
+      // already logged
+      return error;
+   }
+
+   for(size_t iCut = 0; iCut < cCutDimensions; ++iCut) {
+      const size_t iDimension = aiCutDimensions[iCut];
+      const size_t iOriginalDimension = aiOriginalIndex[iDimension];
+      error = pInnerTermUpdate->SetCountSlices(iOriginalDimension, 2);
+      if(Error_None != error) {
+         // already logged
+         return error;
+      }
+      *pInnerTermUpdate->GetSplitPointer(iOriginalDimension) = static_cast<UIntSplit>(aiSplits[iDimension]);
+   }
+
+   // sum the cells into the auxiliary bins
+   TensorSumDimension aDimensions[cCompilerDimensions];
+   for(size_t iCell = 0; iCell < cCells; ++iCell) {
+      for(size_t iDimension = 0; iDimension < cCompilerDimensions; ++iDimension) {
+         aDimensions[iDimension].m_cBins = acRealBins[iDimension];
+         aDimensions[iDimension].m_iLow = 0;
+         aDimensions[iDimension].m_iHigh = acRealBins[iDimension];
+      }
+      for(size_t iCut = 0; iCut < cCutDimensions; ++iCut) {
+         const size_t iDimension = aiCutDimensions[iCut];
+         if(0 != ((iCell >> iCut) & 1)) {
+            aDimensions[iDimension].m_iLow = aiSplits[iDimension];
+         } else {
+            aDimensions[iDimension].m_iHigh = aiSplits[iDimension];
+         }
+      }
+      auto* const pCell = IndexBin(aCells, cBytesPerBin * iCell);
+      ASSERT_BIN_OK(cBytesPerBin, pCell, pBinsEndDebug);
+      TensorTotalsSum<bHessian, k_dynamicScores, cCompilerDimensions>(cScores,
+            cCompilerDimensions,
+            aDimensions,
+            aBins,
+            *pCell,
+            pCell->GetGradientPairs()
+#ifndef NDEBUG
+                  ,
+            aDebugCopyBins,
+            pBinsEndDebug
+#endif // NDEBUG
+      );
+   }
+
+   FloatScore* const aUpdateScores = pInnerTermUpdate->GetTensorScoresPointer();
+   for(size_t iScore = 0; iScore < cScores; ++iScore) {
+      FloatCalc aWeights[size_t{1} << cCompilerDimensions];
+      FloatCalc aNegUpdates[size_t{1} << cCompilerDimensions];
+      for(size_t iCell = 0; iCell < cCells; ++iCell) {
+         const auto* const pCell = IndexBin(aCells, cBytesPerBin * iCell);
+         const auto* const pGradientPair = &pCell->GetGradientPairs()[iScore];
+         aWeights[iCell] = static_cast<FloatCalc>(pCell->GetWeight());
+         const FloatCalc hess =
+               bUpdateWithHessian ? static_cast<FloatCalc>(pGradientPair->GetHess()) : aWeights[iCell];
+         aNegUpdates[iCell] = CalcNegUpdate<true>(
+               static_cast<FloatCalc>(pGradientPair->m_sumGradients), hess, regAlpha, regLambda, deltaStepMax);
+      }
+
+      if(bPurifyUpdate) {
+         // the closed form solution for purifying a 2x2 tensor that is derived in the search above.  A tensor cut
+         // along only one dimension is all main effect, so nothing is left after purifying it
+         if(cCompilerDimensions == cCutDimensions && FloatCalc{0} != aWeights[0] && FloatCalc{0} != aWeights[1] &&
+               FloatCalc{0} != aWeights[2] && FloatCalc{0} != aWeights[3]) {
+            const FloatCalc common = aNegUpdates[0] - aNegUpdates[1] - aNegUpdates[2] + aNegUpdates[3];
+            for(size_t iCell = 0; iCell < cCells; ++iCell) {
+               FloatCalc denominator = FloatCalc{1};
+               for(size_t iOther = 0; iOther < cCells; ++iOther) {
+                  if(iOther != iCell) {
+                     denominator += aWeights[iCell] / aWeights[iOther];
+                  }
+               }
+               // cells 00 and 11 share the sign of the common term, while 01 and 10 have the opposite sign
+               const FloatCalc numerator = (0 == iCell || cCells - 1 == iCell) ? common : -common;
+               aNegUpdates[iCell] = numerator / denominator;
+            }
+         } else {
+            for(size_t iCell = 0; iCell < cCells; ++iCell) {
+               aNegUpdates[iCell] = 0;
+            }
+         }
+      }
+
+      for(size_t iCell = 0; iCell < cCells; ++iCell) {
+         aUpdateScores[iCell * cScores + iScore] = static_cast<FloatScore>(-aNegUpdates[iCell]);
+      }
+   }
+   return Error_None;
+}
+
+extern ErrorEbm PartitionMultiDimensionalStraightBoosting(const bool bHessian,
+      const size_t cRuntimeScores,
+      const size_t cRealDimensions,
+      const TermBoostFlags flags,
+      const size_t cSamplesLeafMin,
+      const FloatCalc hessianMin,
+      const FloatCalc regAlpha,
+      const FloatCalc regLambda,
+      const FloatCalc deltaStepMax,
+      const BinBase* const aBinsBase,
+      BinBase* const aAuxiliaryBinsBase,
+      Tensor* const pInnerTermUpdate,
+      const size_t* const acBins,
+      const IntEbm* const aLeavesMax,
+      const MonotoneDimension* const aMonotoneDimensions,
+      double* const pTotalGain
+#ifndef NDEBUG
+      ,
+      const BinBase* const aDebugCopyBinsBase,
+      const BinBase* const pBinsEndDebug
+#endif // NDEBUG
+) {
+   EBM_ASSERT(2 == cRealDimensions); // straight cuts are only defined for pairs
+   EBM_ASSERT(nullptr != aLeavesMax);
+
+   size_t acRealBins[2];
+   size_t aiOriginalIndex[2];
+   bool abCut[2];
+   MonotoneDimension aMonotone[2];
+   size_t iDimensionLoop = 0;
+   size_t iDimInit = 0;
+   do {
+      const size_t cBins = acBins[iDimensionLoop];
+      EBM_ASSERT(size_t{1} <= cBins); // we don't boost on empty training sets
+      if(size_t{1} < cBins) {
+         acRealBins[iDimInit] = cBins;
+         aiOriginalIndex[iDimInit] = iDimensionLoop;
+         // a dimension capped at one leaf stays uncut
+         abCut[iDimInit] = IntEbm{1} < aLeavesMax[iDimensionLoop];
+         if(nullptr != aMonotoneDimensions) {
+            aMonotone[iDimInit] = aMonotoneDimensions[iDimensionLoop];
+         }
+         ++iDimInit;
+      }
+      ++iDimensionLoop;
+   } while(cRealDimensions != iDimInit);
+
+   const bool bPurifyUpdate = 0 != (TermBoostFlags_PurifyUpdate & flags);
+   const bool bUpdateWithHessian = bHessian && !(TermBoostFlags_DisableNewtonUpdate & flags);
+
+   const bool bPurify = 0 != ((TermBoostFlags_PurifyGain | TermBoostFlags_PurifyUpdate) & flags);
+
+   size_t aiBestSplits[2];
+   double bestGain = 0.0;
+   if(abCut[0] && abCut[1]) {
+      bestGain = FindStraightCuts(bHessian,
+            cRuntimeScores,
+            cRealDimensions,
+            acRealBins,
+            bPurify,
+            0 != (TermBoostFlags_DisableNewtonGain & flags),
+            bUpdateWithHessian,
+            cSamplesLeafMin,
+            hessianMin,
+            regAlpha,
+            regLambda,
+            deltaStepMax,
+            nullptr == aMonotoneDimensions ? nullptr : aMonotone,
+            aAuxiliaryBinsBase,
+            aBinsBase,
+            aiBestSplits
+#ifndef NDEBUG
+            ,
+            aDebugCopyBinsBase,
+            pBinsEndDebug
+#endif // NDEBUG
+      );
+   } else if((abCut[0] || abCut[1]) && !bPurify) {
+      // a cut along only one dimension of a pair is all main effect, so purified it has no gain and we skip it
+      const size_t iCutDimension = abCut[0] ? 0 : 1;
+      if(bHessian) {
+         bestGain = FindSingleStraightCut<true>(cRuntimeScores,
+               acRealBins,
+               iCutDimension,
+               0 != (TermBoostFlags_DisableNewtonGain & flags),
+               bUpdateWithHessian,
+               cSamplesLeafMin,
+               hessianMin,
+               regAlpha,
+               regLambda,
+               deltaStepMax,
+               nullptr == aMonotoneDimensions ? nullptr : aMonotone,
+               aBinsBase,
+               aAuxiliaryBinsBase,
+               aiBestSplits
+#ifndef NDEBUG
+               ,
+               aDebugCopyBinsBase,
+               pBinsEndDebug
+#endif // NDEBUG
+         );
+      } else {
+         bestGain = FindSingleStraightCut<false>(cRuntimeScores,
+               acRealBins,
+               iCutDimension,
+               0 != (TermBoostFlags_DisableNewtonGain & flags),
+               bUpdateWithHessian,
+               cSamplesLeafMin,
+               hessianMin,
+               regAlpha,
+               regLambda,
+               deltaStepMax,
+               nullptr == aMonotoneDimensions ? nullptr : aMonotone,
+               aBinsBase,
+               aAuxiliaryBinsBase,
+               aiBestSplits
+#ifndef NDEBUG
+               ,
+               aDebugCopyBinsBase,
+               pBinsEndDebug
+#endif // NDEBUG
+         );
+      }
+   }
+
+   const size_t* aiSplits = nullptr;
+   *pTotalGain = 0;
+   EBM_ASSERT(std::numeric_limits<FloatCalc>::min() <= k_gainMin);
+   if(LIKELY(/* NaN */ !UNLIKELY(bestGain < static_cast<double>(k_gainMin)))) {
+      // signal that we've hit an overflow.  Use +inf here since our caller likes that and will flip to -inf
+      *pTotalGain = std::numeric_limits<double>::infinity();
+      if(LIKELY(/* NaN */ bestGain <= std::numeric_limits<double>::max())) {
+         *pTotalGain = bestGain;
+         aiSplits = aiBestSplits;
+      }
+   }
+
+   if(bHessian) {
+      return MakeStraightTensor<true>(cRuntimeScores,
+            acRealBins,
+            aiOriginalIndex,
+            aiSplits,
+            bPurifyUpdate,
+            bUpdateWithHessian,
+            regAlpha,
+            regLambda,
+            deltaStepMax,
+            aBinsBase,
+            aAuxiliaryBinsBase,
+            pInnerTermUpdate
+#ifndef NDEBUG
+            ,
+            aDebugCopyBinsBase,
+            pBinsEndDebug
+#endif // NDEBUG
+      );
+   } else {
+      return MakeStraightTensor<false>(cRuntimeScores,
+            acRealBins,
+            aiOriginalIndex,
+            aiSplits,
+            bPurifyUpdate,
+            bUpdateWithHessian,
+            regAlpha,
+            regLambda,
+            deltaStepMax,
+            aBinsBase,
+            aAuxiliaryBinsBase,
+            pInnerTermUpdate
+#ifndef NDEBUG
+            ,
+            aDebugCopyBinsBase,
+            pBinsEndDebug
+#endif // NDEBUG
+      );
+   }
+}
+
 } // namespace DEFINED_ZONE_NAME
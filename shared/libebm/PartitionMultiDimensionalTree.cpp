@@ -260,6 +260,238 @@ done1:;
    return Error_None;
 }
 
+template<bool bHessian, size_t cCompilerScores>
+static bool IsMonotoneViolated(const size_t cScores,
+      const size_t cRealDimensions,
+      const bool bUpdateWithHessian,
+      const FloatCalc regAlpha,
+      const FloatCalc regLambda,
+      const FloatCalc deltaStepMax,
+      const MonotoneDimension* const aMonotone,
+      const size_t cLeaves,
+      const Bin<FloatMain, UIntMain, true, true, bHessian, GetArrayScores(cCompilerScores)>* const* const apLeafBins,
+      const TensorSumDimension* const aLeafBoxes) {
+   // The update is constant within each leaf's box, so the tensor is monotone along a dimension if every pair of
+   // leaves that share a line along that dimension has updates ordered the same way as their boxes.
+
+   EBM_ASSERT(2 <= cLeaves);
+   for(size_t iLeaf1 = 0; iLeaf1 < cLeaves; ++iLeaf1) {
+      const TensorSumDimension* const aBox1 = &aLeafBoxes[iLeaf1 * cRealDimensions];
+      for(size_t iLeaf2 = iLeaf1 + 1; iLeaf2 < cLeaves; ++iLeaf2) {
+         const TensorSumDimension* const aBox2 = &aLeafBoxes[iLeaf2 * cRealDimensions];
+         for(size_t iDim = 0; iDim < cRealDimensions; ++iDim) {
+            const MonotoneDirection direction = aMonotone[iDim].m_direction;
+            if(MONOTONE_NONE == direction) {
+               continue;
+            }
+
+            bool bShareLine = true;
+            for(size_t iDimOther = 0; iDimOther < cRealDimensions; ++iDimOther) {
+               if(iDimOther != iDim &&
+                     (aBox1[iDimOther].m_iHigh <= aBox2[iDimOther].m_iLow ||
+                           aBox2[iDimOther].m_iHigh <= aBox1[iDimOther].m_iLow)) {
+                  bShareLine = false;
+                  break;
+               }
+            }
+            if(!bShareLine) {
+               continue;
+            }
+
+            const size_t iBinOrdered = aMonotone[iDim].m_iBinOrdered;
+            const size_t iLow1 = EbmMax(aBox1[iDim].m_iLow, iBinOrdered);
+            const size_t iLow2 = EbmMax(aBox2[iDim].m_iLow, iBinOrdered);
+            if(aBox1[iDim].m_iHigh <= iLow1 || aBox2[iDim].m_iHigh <= iLow2) {
+               // one of the leaves only holds missing values along this dimension
+               continue;
+            }
+
+            const auto* pBinBelow = apLeafBins[iLeaf1];
+            const auto* pBinAbove = apLeafBins[iLeaf2];
+            if(aBox2[iDim].m_iHigh <= iLow1) {
+               pBinBelow = apLeafBins[iLeaf2];
+               pBinAbove = apLeafBins[iLeaf1];
+            } else {
+               // leaves that share a line are disjoint along the remaining dimension
+               EBM_ASSERT(aBox1[iDim].m_iHigh <= iLow2);
+            }
+
+            const auto* const aGradPairsBelow = pBinBelow->GetGradientPairs();
+            const auto* const aGradPairsAbove = pBinAbove->GetGradientPairs();
+            FloatCalc hessBelow = static_cast<FloatCalc>(pBinBelow->GetWeight());
+            FloatCalc hessAbove = static_cast<FloatCalc>(pBinAbove->GetWeight());
+            for(size_t iScore = 0; iScore < cScores; ++iScore) {
+               if(bUpdateWithHessian) {
+                  hessBelow = static_cast<FloatCalc>(aGradPairsBelow[iScore].GetHess());
+                  hessAbove = static_cast<FloatCalc>(aGradPairsAbove[iScore].GetHess());
+               }
+               const FloatCalc negUpdateBelow =
+                     CalcNegUpdate<true>(static_cast<FloatCalc>(aGradPairsBelow[iScore].m_sumGradients),
+                           hessBelow,
+                           regAlpha,
+                           regLambda,
+                           deltaStepMax);
+               const FloatCalc negUpdateAbove =
+                     CalcNegUpdate<true>(static_cast<FloatCalc>(aGradPairsAbove[iScore].m_sumGradients),
+                           hessAbove,
+                           regAlpha,
+                           regLambda,
+                           deltaStepMax);
+               // multiclass requires every class score to follow the direction
+               if(MonotoneDirection{0} < direction) {
+                  if(negUpdateBelow < negUpdateAbove) {
+                     return true;
+                  }
+               } else {
+                  EBM_ASSERT(direction < MonotoneDirection{0});
+                  if(negUpdateAbove < negUpdateBelow) {
+                     return true;
+                  }
+               }
+            }
+         }
+      }
+   }
+   return false;
+}
+
+// fraction of the whole tensor's gain bound that we add to region bounds before pruning with them
+static constexpr FloatCalc k_gainBoundSlack = FloatCalc{1e-9};
+
+template<bool bHessian, size_t cCompilerScores>
+static FloatCalc BuildGainBounds(const size_t cRuntimeScores,
+      const size_t cRealDimensions,
+      const bool bUseLogitBoost,
+      const TensorSumDimension* const aDimensions,
+      const Bin<FloatMain, UIntMain, true, true, bHessian, GetArrayScores(cCompilerScores)>* const aBins,
+      Bin<FloatMain, UIntMain, true, true, bHessian, GetArrayScores(cCompilerScores)>* const aAuxiliaryBins,
+      FloatCalc* const aGainBounds
+#ifndef NDEBUG
+      ,
+      const Bin<FloatMain, UIntMain, true, true, bHessian, GetArrayScores(cCompilerScores)>* const aDebugCopyBins,
+      const BinBase* const pBinsEndDebug
+#endif // NDEBUG
+) {
+   // By Cauchy-Schwarz, (g1 + g2)^2 / (h1 + h2) <= g1^2 / h1 + g2^2 / h2 when the hessians are positive, and the L1, L2
+   // and max delta step regularizations only lower the partial gain, so no way of splitting a region can gain more
+   // than the sum of g^2 / h over its bins.  We store those per-bin bounds as cumulative totals, like aBins, so that
+   // the bound of any region can be looked up from its corners.
+
+   const size_t cScores = GET_COUNT_SCORES(cCompilerScores, cRuntimeScores);
+
+   Bin<FloatMain, UIntMain, true, true, bHessian, GetArrayScores(cCompilerScores)> binTemp;
+   static constexpr bool bUseStackMemory = k_dynamicScores != cCompilerScores;
+   auto* const aGradientPairsTemp = bUseStackMemory ? binTemp.GetGradientPairs() : aAuxiliaryBins->GetGradientPairs();
+
+   TensorSumDimension aBinDimensions[k_cDimensionsMax];
+   size_t iDimension = 0;
+   do {
+      aBinDimensions[iDimension].m_iLow = 0;
+      aBinDimensions[iDimension].m_iHigh = 1;
+      aBinDimensions[iDimension].m_cBins = aDimensions[iDimension].m_cBins;
+      ++iDimension;
+   } while(cRealDimensions != iDimension);
+
+   FloatCalc* pGainBound = aGainBounds;
+   while(true) {
+      TensorTotalsSum<bHessian, cCompilerScores, k_dynamicDimensions>(cScores,
+            cRealDimensions,
+            aBinDimensions,
+            aBins,
+            binTemp,
+            aGradientPairsTemp
+#ifndef NDEBUG
+            ,
+            aDebugCopyBins,
+            pBinsEndDebug
+#endif // NDEBUG
+      );
+
+      FloatCalc gainBound = 0;
+      FloatCalc hess = static_cast<FloatCalc>(binTemp.GetWeight());
+      for(size_t iScore = 0; iScore < cScores; ++iScore) {
+         if(bUseLogitBoost) {
+            hess = static_cast<FloatCalc>(aGradientPairsTemp[iScore].GetHess());
+         }
+         const FloatCalc grad = static_cast<FloatCalc>(aGradientPairsTemp[iScore].m_sumGradients);
+         if(FloatCalc{0} != grad) {
+            // non-positive hessians break the inequality, so make the bound useless for regions holding this bin
+            gainBound += LIKELY(std::numeric_limits<FloatCalc>::min() <= hess) ?
+                  grad / hess * grad :
+                  std::numeric_limits<FloatCalc>::infinity();
+         }
+      }
+      *pGainBound = gainBound;
+      ++pGainBound;
+
+      iDimension = 0;
+      while(true) {
+         TensorSumDimension* const pDimension = &aBinDimensions[iDimension];
+         ++pDimension->m_iLow;
+         ++pDimension->m_iHigh;
+         if(pDimension->m_iHigh <= pDimension->m_cBins) {
+            break;
+         }
+         pDimension->m_iLow = 0;
+         pDimension->m_iHigh = 1;
+         ++iDimension;
+         if(cRealDimensions == iDimension) {
+            goto done;
+         }
+      }
+   }
+done:;
+
+   const size_t cTensorBins = static_cast<size_t>(pGainBound - aGainBounds);
+
+   // accumulate along each dimension in turn, which turns the per-bin bounds into cumulative totals
+   size_t cStride = 1;
+   iDimension = 0;
+   do {
+      const size_t cBins = aDimensions[iDimension].m_cBins;
+      for(size_t iTensor = cStride; iTensor < cTensorBins; ++iTensor) {
+         if(size_t{0} != iTensor / cStride % cBins) {
+            aGainBounds[iTensor] += aGainBounds[iTensor - cStride];
+         }
+      }
+      cStride *= cBins;
+      ++iDimension;
+   } while(cRealDimensions != iDimension);
+   EBM_ASSERT(cTensorBins == cStride);
+
+   return aGainBounds[cTensorBins - 1];
+}
+
+static FloatCalc SumGainBounds(
+      const size_t cRealDimensions, const TensorSumDimension* const aDimensions, const FloatCalc* const aGainBounds) {
+   // inclusion-exclusion over the corners of the region, in the same way that TensorTotalsSumMulti sums aBins
+   FloatCalc total = 0;
+   const size_t cCorners = size_t{1} << cRealDimensions;
+   for(size_t iCorner = 0; iCorner < cCorners; ++iCorner) {
+      size_t iTensor = 0;
+      size_t cStride = 1;
+      bool bSubtract = false;
+      bool bOutside = false;
+      for(size_t iDimension = 0; iDimension < cRealDimensions; ++iDimension) {
+         size_t iBin = aDimensions[iDimension].m_iHigh - 1;
+         if(0 != ((iCorner >> iDimension) & 1)) {
+            if(0 == aDimensions[iDimension].m_iLow) {
+               bOutside = true;
+               break;
+            }
+            iBin = aDimensions[iDimension].m_iLow - 1;
+            bSubtract = !bSubtract;
+         }
+         iTensor += iBin * cStride;
+         cStride *= aDimensions[iDimension].m_cBins;
+      }
+      if(!bOutside) {
+         total += bSubtract ? -aGainBounds[iTensor] : aGainBounds[iTensor];
+      }
+   }
+   return total;
+}
+
 template<bool bHessian, size_t cCompilerScores> class PartitionMultiDimensionalTreeInternal final {
  public:
    PartitionMultiDimensionalTreeInternal() = delete; // this is a static class.  Do not construct
@@ -280,6 +512,8 @@ template<bool bHessian, size_t cCompilerScores> class PartitionMultiDimensionalT
          Tensor* const pInnerTermUpdate,
          void* const pRootTreeNodeBase,
          const size_t* const acBins,
+         const MonotoneDimension* const aMonotoneDimensions,
+         FloatCalc* const aGainBounds,
          double* const aTensorWeights,
          double* const aTensorGrad,
          double* const aTensorHess,
@@ -336,6 +570,7 @@ template<bool bHessian, size_t cCompilerScores> class PartitionMultiDimensionalT
       size_t iDimensionLoop = 0;
       size_t iDimInit = 0;
       size_t aiOriginalIndex[k_dynamicDimensions == cCompilerDimensions ? k_cDimensionsMax : cCompilerDimensions];
+      MonotoneDimension aMonotone[k_dynamicDimensions == cCompilerDimensions ? k_cDimensionsMax : cCompilerDimensions];
 #ifndef NDEBUG
       size_t aiDEBUGDim[k_dynamicDimensions == cCompilerDimensions ? k_cDimensionsMax : cCompilerDimensions];
 #endif // NDEBUG
@@ -347,6 +582,9 @@ template<bool bHessian, size_t cCompilerScores> class PartitionMultiDimensionalT
          if(size_t{1} < cBins) {
             aiOriginalIndex[iDimInit] = iDimensionLoop;
             aDimensions[iDimInit].m_cBins = cBins;
+            if(nullptr != aMonotoneDimensions) {
+               aMonotone[iDimInit] = aMonotoneDimensions[iDimensionLoop];
+            }
 
 #ifndef NDEBUG
             aiDEBUGDim[iDimInit] = cRealDimensions - 1 - iDimInit;
@@ -382,15 +620,79 @@ template<bool bHessian, size_t cCompilerScores> class PartitionMultiDimensionalT
       pTreeNode->SetParent(pParentTreeNode);
       pTreeNode->SetChildren(pHigh); // we need to set it to something because we access this pointer below
 
-      // TODO: we should calculate the default partial gain before splitting anything. Once we have that
-      // number we can calculate the minimum gain we need to reach k_gainMin after the cuts are made
-      // which will allow us to avoid some work when the eventual gain will be less than our minimum
       FloatCalc bestGain = -std::numeric_limits<double>::infinity();
 
       EBM_ASSERT(std::numeric_limits<FloatCalc>::min() <= hessianMin);
 
+      // the bin before the aAuxiliaryBins is the last summation bin of aBinsBase,
+      // which contains the totals of all bins
+      const auto* const pTotal = NegativeIndexBin(aAuxiliaryBins, cBytesPerBin);
+
+      ASSERT_BIN_OK(cBytesPerBin, pTotal, pBinsEndDebug);
+
+      const auto* const pGradientPairTotal = pTotal->GetGradientPairs();
+
+      const FloatMain weightAll = pTotal->GetWeight();
+      EBM_ASSERT(0 < weightAll);
+
+      // A sweep of the deepest split is skipped when even splitting its region into single bins could not beat the
+      // best tree so far, or could not reach k_gainMin over the parent.  The purified gain is not bounded that way.
+      const bool bPruneSweeps = nullptr != aGainBounds && 0 == (TermBoostFlags_PurifyGain & flags);
+      FloatCalc gainFloor = -std::numeric_limits<FloatCalc>::infinity();
+      FloatCalc gainBoundSlack = 0;
+      if(bPruneSweeps) {
+         const FloatCalc gainBoundAll = BuildGainBounds<bHessian, cCompilerScores>(cScores,
+               cRealDimensions,
+               bUseLogitBoost,
+               aDimensions,
+               aBins,
+               aAuxiliaryBins,
+               aGainBounds
+#ifndef NDEBUG
+               ,
+               aDebugCopyBins,
+               pBinsEndDebug
+#endif // NDEBUG
+         );
+         // the cumulative totals lose precision for regions far from the origin, so leave room for that
+         gainBoundSlack = gainBoundAll * k_gainBoundSlack;
+
+         FloatCalc gainParent = 0;
+         for(size_t iScore = 0; iScore < cScores; ++iScore) {
+            const FloatCalc hess =
+                  static_cast<FloatCalc>(bUseLogitBoost ? pGradientPairTotal[iScore].GetHess() : weightAll);
+            gainParent += CalcPartialGain<true>(static_cast<FloatCalc>(pGradientPairTotal[iScore].m_sumGradients),
+                  hess,
+                  regAlpha,
+                  regLambda,
+                  deltaStepMax);
+         }
+         gainParent += k_gainMin;
+         if(LIKELY(gainParent <= std::numeric_limits<FloatCalc>::max())) {
+            // an overflowing parent gain is reported as +inf below, which the floor must not hide
+            gainFloor = gainParent;
+         }
+      }
+
       const TensorSumDimension* const pDimensionEnd = &aDimensions[cRealDimensions];
 
+      const bool bUpdateWithHessian = bHessian && !(TermBoostFlags_DisableNewtonUpdate & flags);
+
+      // when constrained, we keep the box and sums of each leaf so the whole tree can be checked once it is complete
+      static constexpr size_t k_cLeafDimensionsMax =
+            k_dynamicDimensions == cCompilerDimensions ? k_cDimensionsMax : cCompilerDimensions;
+      size_t cLeaves;
+      const Bin<FloatMain, UIntMain, true, true, bHessian, GetArrayScores(cCompilerScores)>*
+            apLeafBins[k_cLeafDimensionsMax + 1];
+      TensorSumDimension aLeafBoxes[(k_cLeafDimensionsMax + 1) * k_cLeafDimensionsMax];
+
+      // The deepest split moves fastest, so while it sweeps, the leaves hanging off the nodes above it and the region
+      // it splits stay the same.  We keep those from the first position of each sweep and reuse them.
+      bool bPrefixCached = false;
+      FloatCalc gainPrefix = 0;
+      size_t cLeavesPrefix = 0;
+      TensorSumDimension aSweepDimensions[k_cLeafDimensionsMax];
+
       while(true) {
          pTreeNode = pLastSplitTreeNode;
          while(true) {
@@ -429,23 +731,46 @@ template<bool bHessian, size_t cCompilerScores> class PartitionMultiDimensionalT
 
          while(true) {
             while(true) {
-               EBM_ASSERT(1 <= cRealDimensions);
-               TensorSumDimension* pDimension = aDimensions;
-               do {
-                  pDimension->m_iLow = 0;
-                  pDimension->m_iHigh = pDimension->m_cBins;
-                  ++pDimension;
-               } while(pDimensionEnd != pDimension);
-
-               // TODO: We can optimize away some of these calls to TensorTotalsSum because some of the
-               // tensors do not change in each tree cut. For example, if we had a primary cut on the 0th dimension
-               // and one cut in the 1st dimension on the lower side of the 0th dimension cut, then if we move the
-               // cut along the 1st dimension, the tensor sum on the opposite since is not changing.
-               FloatCalc gain = 0.0;
-
-               pTreeNode = pDeepTreeNode;
+               auto* const pSweepTreeNode = pLastTreeNode->GetParent();
+               FloatCalc gain;
+               if(bPrefixCached) {
+                  memcpy(aDimensions, aSweepDimensions, sizeof(*aDimensions) * cRealDimensions);
+                  gain = gainPrefix;
+                  cLeaves = cLeavesPrefix;
+                  pTreeNode = pSweepTreeNode;
+               } else {
+                  EBM_ASSERT(1 <= cRealDimensions);
+                  TensorSumDimension* pDimension = aDimensions;
+                  do {
+                     pDimension->m_iLow = 0;
+                     pDimension->m_iHigh = pDimension->m_cBins;
+                     ++pDimension;
+                  } while(pDimensionEnd != pDimension);
+
+                  gain = 0.0;
+                  cLeaves = 0;
+                  pTreeNode = pDeepTreeNode;
+               }
+
                TreeNodeMulti<bHessian, GetArrayScores(cCompilerScores)>* pNextTreeNode;
                do {
+                  if(!bPrefixCached && pSweepTreeNode == pTreeNode) {
+                     EBM_ASSERT(0 == pTreeNode->GetSplitIndex());
+                     memcpy(aSweepDimensions, aDimensions, sizeof(*aDimensions) * cRealDimensions);
+                     gainPrefix = gain;
+                     cLeavesPrefix = cLeaves;
+                     bPrefixCached = true;
+
+                     if(bPruneSweeps) {
+                        const FloatCalc gainBound =
+                              gain + SumGainBounds(cRealDimensions, aDimensions, aGainBounds) + gainBoundSlack;
+                        // NaN bounds compare false and are never pruned
+                        if(gainBound < bestGain || gainBound < gainFloor) {
+                           goto skip_sweep;
+                        }
+                     }
+                  }
+
                   pNextTreeNode = nullptr;
 
                   EBM_ASSERT(pTreeNode->IsSplit());
@@ -476,7 +801,15 @@ template<bool bHessian, size_t cCompilerScores> class PartitionMultiDimensionalT
                      );
 
                      if(pLowSum->GetBin()->GetCountSamples() < cSamplesLeafMin) {
-                        goto next;
+                        goto invalid_leaf;
+                     }
+
+                     if(nullptr != aMonotoneDimensions) {
+                        apLeafBins[cLeaves] = pLowSum->GetBin();
+                        memcpy(&aLeafBoxes[cLeaves * cRealDimensions],
+                              aDimensions,
+                              sizeof(*aDimensions) * cRealDimensions);
+                        ++cLeaves;
                      }
 
                      EBM_ASSERT(1 <= cScores);
@@ -487,7 +820,7 @@ template<bool bHessian, size_t cCompilerScores> class PartitionMultiDimensionalT
                            hessian = static_cast<FloatCalc>(aGradientPairsLocal[iScore].GetHess());
                         }
                         if(hessian < hessianMin) {
-                           goto next;
+                           goto invalid_leaf;
                         }
 
                         const FloatCalc gain1 =
@@ -528,7 +861,15 @@ template<bool bHessian, size_t cCompilerScores> class PartitionMultiDimensionalT
                      );
 
                      if(pHighSum->GetBin()->GetCountSamples() < cSamplesLeafMin) {
-                        goto next;
+                        goto invalid_leaf;
+                     }
+
+                     if(nullptr != aMonotoneDimensions) {
+                        apLeafBins[cLeaves] = pHighSum->GetBin();
+                        memcpy(&aLeafBoxes[cLeaves * cRealDimensions],
+                              aDimensions,
+                              sizeof(*aDimensions) * cRealDimensions);
+                        ++cLeaves;
                      }
 
                      EBM_ASSERT(1 <= cScores);
@@ -539,7 +880,7 @@ template<bool bHessian, size_t cCompilerScores> class PartitionMultiDimensionalT
                            hessian = static_cast<FloatCalc>(aGradientPairsLocal[iScore].GetHess());
                         }
                         if(hessian < hessianMin) {
-                           goto next;
+                           goto invalid_leaf;
                         }
 
                         const FloatCalc gain1 =
@@ -563,6 +904,22 @@ template<bool bHessian, size_t cCompilerScores> class PartitionMultiDimensionalT
                   pTreeNode = pNextTreeNode;
                } while(nullptr != pTreeNode);
 
+               if(nullptr != aMonotoneDimensions) {
+                  EBM_ASSERT(cRealDimensions + 1 == cLeaves);
+                  if(IsMonotoneViolated<bHessian, cCompilerScores>(cScores,
+                           cRealDimensions,
+                           bUpdateWithHessian,
+                           regAlpha,
+                           regLambda,
+                           deltaStepMax,
+                           aMonotone,
+                           cLeaves,
+                           apLeafBins,
+                           aLeafBoxes)) {
+                     goto next;
+                  }
+               }
+
                if(0 != (TermBoostFlags_PurifyGain & flags)) {
                   // TODO: we're doing extra computation above when we calculate the unpurified gain so eliminate that
 
@@ -685,6 +1042,17 @@ template<bool bHessian, size_t cCompilerScores> class PartitionMultiDimensionalT
                } else {
                   EBM_ASSERT(!std::isnan(gain));
                }
+               goto next;
+
+            invalid_leaf:;
+               if(pSweepTreeNode == pTreeNode) {
+                  goto next;
+               }
+               // a leaf above the deepest split is invalid for every position of the deepest split
+
+            skip_sweep:;
+               // move the deepest split to its last position so that the advance below starts the next sweep
+               pSweepTreeNode->SetSplitIndex(aDimensions[pSweepTreeNode->GetDimensionIndex()].m_cBins - 2);
 
             next:;
 
@@ -703,6 +1071,7 @@ template<bool bHessian, size_t cCompilerScores> class PartitionMultiDimensionalT
                      break;
                   }
                   pTreeNode->SetSplitIndex(0);
+                  bPrefixCached = false;
                   pTreeNode = pTreeNode->GetParent();
                   if(nullptr == pTreeNode) {
                      goto next_tree;
@@ -813,19 +1182,6 @@ template<bool bHessian, size_t cCompilerScores> class PartitionMultiDimensionalT
       }
    done:;
 
-      // the bin before the aAuxiliaryBins is the last summation bin of aBinsBase,
-      // which contains the totals of all bins
-      const auto* const pTotal = NegativeIndexBin(aAuxiliaryBins, cBytesPerBin);
-
-      ASSERT_BIN_OK(cBytesPerBin, pTotal, pBinsEndDebug);
-
-      const auto* const pGradientPairTotal = pTotal->GetGradientPairs();
-
-      const FloatMain weightAll = pTotal->GetWeight();
-      EBM_ASSERT(0 < weightAll);
-
-      const bool bUpdateWithHessian = bHessian && !(TermBoostFlags_DisableNewtonUpdate & flags);
-
       *pTotalGain = 0;
       EBM_ASSERT(std::numeric_limits<FloatCalc>::min() <= k_gainMin);
       if(LIKELY(/* NaN */ !UNLIKELY(bestGain < k_gainMin))) {
@@ -841,9 +1197,6 @@ template<bool bHessian, size_t cCompilerScores> class PartitionMultiDimensionalT
             if(0 == (TermBoostFlags_PurifyGain & flags)) {
                // for purified, we don't subtract the parent since the parent's partial gain is zero when purified
 
-               // TODO: we should move this computation to the top and then calculate how much gain we need
-               // for the split in order to reach the k_gainMin value
-
                // now subtract the parent partial gain
                for(size_t iScore = 0; iScore < cScores; ++iScore) {
                   const FloatCalc hess =
@@ -995,6 +1348,8 @@ template<bool bHessian, size_t cPossibleScores> class PartitionMultiDimensionalT
          Tensor* const pInnerTermUpdate,
          void* const pRootTreeNodeBase,
          const size_t* const acBins,
+         const MonotoneDimension* const aMonotoneDimensions,
+         FloatCalc* const aGainBounds,
          double* const aTensorWeights,
          double* const aTensorGrad,
          double* const aTensorHess,
@@ -1022,6 +1377,8 @@ template<bool bHessian, size_t cPossibleScores> class PartitionMultiDimensionalT
                pInnerTermUpdate,
                pRootTreeNodeBase,
                acBins,
+               aMonotoneDimensions,
+               aGainBounds,
                aTensorWeights,
                aTensorGrad,
                aTensorHess,
@@ -1049,6 +1406,8 @@ template<bool bHessian, size_t cPossibleScores> class PartitionMultiDimensionalT
                pInnerTermUpdate,
                pRootTreeNodeBase,
                acBins,
+               aMonotoneDimensions,
+               aGainBounds,
                aTensorWeights,
                aTensorGrad,
                aTensorHess,
@@ -1083,6 +1442,8 @@ template<bool bHessian> class PartitionMultiDimensionalTreeTarget<bHessian, k_cC
          Tensor* const pInnerTermUpdate,
          void* const pRootTreeNodeBase,
          const size_t* const acBins,
+         const MonotoneDimension* const aMonotoneDimensions,
+         FloatCalc* const aGainBounds,
          double* const aTensorWeights,
          double* const aTensorGrad,
          double* const aTensorHess,
@@ -1109,6 +1470,8 @@ template<bool bHessian> class PartitionMultiDimensionalTreeTarget<bHessian, k_cC
             pInnerTermUpdate,
             pRootTreeNodeBase,
             acBins,
+            aMonotoneDimensions,
+            aGainBounds,
             aTensorWeights,
             aTensorGrad,
             aTensorHess,
@@ -1139,6 +1502,8 @@ extern ErrorEbm PartitionMultiDimensionalTree(const bool bHessian,
       Tensor* const pInnerTermUpdate,
       void* const pRootTreeNodeBase,
       const size_t* const acBins,
+      const MonotoneDimension* const aMonotoneDimensions,
+      FloatCalc* const aGainBounds,
       double* const aTensorWeights,
       double* const aTensorGrad,
       double* const aTensorHess,
@@ -1187,6 +1552,8 @@ extern ErrorEbm PartitionMultiDimensionalTree(const bool bHessian,
                pInnerTermUpdate,
                pRootTreeNodeBase,
                acBins,
+               aMonotoneDimensions,
+               aGainBounds,
                aTensorWeights,
                aTensorGrad,
                aTensorHess,
@@ -1214,6 +1581,8 @@ extern ErrorEbm PartitionMultiDimensionalTree(const bool bHessian,
                pInnerTermUpdate,
                pRootTreeNodeBase,
                acBins,
+               aMonotoneDimensions,
+               aGainBounds,
                aTensorWeights,
                aTensorGrad,
                aTensorHess,
@@ -1244,6 +1613,8 @@ extern ErrorEbm PartitionMultiDimensionalTree(const bool bHessian,
                pInnerTermUpdate,
                pRootTreeNodeBase,
                acBins,
+               aMonotoneDimensions,
+               aGainBounds,
                aTensorWeights,
                aTensorGrad,
                aTensorHess,
@@ -1271,6 +1642,8 @@ extern ErrorEbm PartitionMultiDimensionalTree(const bool bHessian,
                pInnerTermUpdate,
                pRootTreeNodeBase,
                acBins,
+               aMonotoneDimensions,
+               aGainBounds,
                aTensorWeights,
                aTensorGrad,
                aTensorHess,
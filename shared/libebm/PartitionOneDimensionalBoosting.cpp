@@ -904,46 +904,15 @@ template<bool bHessian> class CompareNodeGain final {
    }
 };
 
-template<bool bHessian, size_t cCompilerScores> class CompareBin final {
-   bool m_bHessianRuntime;
-   FloatCalc m_categoricalSmoothing;
-
- public:
-   INLINE_ALWAYS CompareBin(const bool bHessianRuntime, FloatCalc categoricalSmoothing) {
-      m_bHessianRuntime = bHessianRuntime;
-      m_categoricalSmoothing = categoricalSmoothing;
-   }
-
-   INLINE_ALWAYS bool operator()(Bin<FloatMain, UIntMain, true, true, bHessian, GetArrayScores(cCompilerScores)>*& lhs,
-         Bin<FloatMain, UIntMain, true, true, bHessian, GetArrayScores(cCompilerScores)>*& rhs) const noexcept {
+struct CompareCategoricalSortKey final {
+   INLINE_ALWAYS bool operator()(const CategoricalSortKey& lhs, const CategoricalSortKey& rhs) const noexcept {
       // NEVER check for exact equality (as a precondition is ok), since then we'd violate the weak ordering rule
       // https://medium.com/@shiansu/strict-weak-ordering-and-the-c-stl-f7dcfa4d4e07
-
-      EBM_ASSERT(!std::isnan(m_categoricalSmoothing));
-
-      // this only works for bins with 1 score since with multiple what would the sort index be?
-      FloatCalc val1 = static_cast<FloatCalc>(lhs->GetGradientPairs()[0].m_sumGradients);
-      FloatCalc val2 = static_cast<FloatCalc>(rhs->GetGradientPairs()[0].m_sumGradients);
-      if(!std::isinf(m_categoricalSmoothing)) {
-         FloatCalc hess1;
-         FloatCalc hess2;
-         const bool bUpdateWithHessian = bHessian && m_bHessianRuntime;
-         if(!bUpdateWithHessian) {
-            hess1 = static_cast<FloatCalc>(lhs->GetWeight());
-            hess2 = static_cast<FloatCalc>(rhs->GetWeight());
-         } else {
-            hess1 = static_cast<FloatCalc>(lhs->GetGradientPairs()[0].GetHess());
-            hess2 = static_cast<FloatCalc>(rhs->GetGradientPairs()[0].GetHess());
-         }
-         val1 /= (hess1 + m_categoricalSmoothing);
-         val2 /= (hess2 + m_categoricalSmoothing);
-      }
-
-      if(val1 == val2) {
+      if(lhs.m_key == rhs.m_key) {
          // As the tie breaker to make the sort values unique, use the pointer itself.
-         return lhs < rhs;
+         return lhs.m_pBin < rhs.m_pBin;
       }
-      return val1 < val2;
+      return lhs.m_key < rhs.m_key;
    }
 };
 
@@ -994,8 +963,6 @@ template<bool bHessian, size_t cCompilerScores> class PartitionOneDimensionalBoo
       BoosterCore* const pBoosterCore = pBoosterShell->GetBoosterCore();
       const size_t cScores = GET_COUNT_SCORES(cCompilerScores, pBoosterCore->GetCountScores());
 
-      EBM_ASSERT(1 == cScores || MONOTONE_NONE == monotoneDirection);
-
       const size_t cBytesPerBin = GetBinSize<FloatMain, UIntMain>(true, true, bHessian, cScores);
       auto* const pRootTreeNode = pBoosterShell->GetTreeNodesTemp<bHessian, GetArrayScores(cCompilerScores)>();
       pRootTreeNode->Init();
@@ -1205,10 +1172,45 @@ template<bool bHessian, size_t cCompilerScores> class PartitionOneDimensionalBoo
          }
 
          if(bSort) {
-            std::sort(apBins,
-                  ppBin,
-                  CompareBin<bHessian, cCompilerScores>(
-                        !(TermBoostFlags_DisableNewtonUpdate & flags), categoricalSmoothing));
+            EBM_ASSERT(!std::isnan(categoricalSmoothing));
+
+            // The keys live after the pointer array, which BoosterCore sized for cBins entries.  Computing the
+            // ratios in one pass means the sort touches 16 byte keys instead of dividing twice per comparison
+            // through pointers into the Bins.  The buffer is aligned, but on 32 bit builds an odd number of
+            // pointers leaves their end misaligned for the doubles in the keys, so round the offset up.
+            static constexpr size_t k_cKeyAlignment = alignof(CategoricalSortKey);
+            const size_t cBytesBeforeKeys = cBytesPerBin * cBins + sizeof(*apBins) * cBins;
+            const size_t cBytesKeysOffset =
+                  (cBytesBeforeKeys + (k_cKeyAlignment - size_t{1})) / k_cKeyAlignment * k_cKeyAlignment;
+            CategoricalSortKey* const aKeys =
+                  reinterpret_cast<CategoricalSortKey*>(reinterpret_cast<char*>(aBins) + cBytesKeysOffset);
+            EBM_ASSERT(reinterpret_cast<char*>(apBins + cBins) <= reinterpret_cast<char*>(aKeys));
+            const size_t cSort = ppBin - apBins;
+            const bool bUpdateWithHessian = bHessian && !(TermBoostFlags_DisableNewtonUpdate & flags);
+            const bool bSmoothing = !std::isinf(categoricalSmoothing);
+            size_t iSort = 0;
+            do {
+               auto* const pBinSort = apBins[iSort];
+               // this only works for bins with 1 score since with multiple what would the sort index be?
+               FloatCalc key = static_cast<FloatCalc>(pBinSort->GetGradientPairs()[0].m_sumGradients);
+               if(bSmoothing) {
+                  const FloatCalc hess = bUpdateWithHessian ?
+                        static_cast<FloatCalc>(pBinSort->GetGradientPairs()[0].GetHess()) :
+                        static_cast<FloatCalc>(pBinSort->GetWeight());
+                  key /= (hess + categoricalSmoothing);
+               }
+               aKeys[iSort].m_key = key;
+               aKeys[iSort].m_pBin = pBinSort;
+               ++iSort;
+            } while(cSort != iSort);
+
+            std::sort(aKeys, aKeys + cSort, CompareCategoricalSortKey());
+
+            iSort = 0;
+            do {
+               apBins[iSort] = static_cast<typename std::remove_pointer<decltype(ppBin)>::type>(aKeys[iSort].m_pBin);
+               ++iSort;
+            } while(cSort != iSort);
          }
       } else {
          if(bMissing && (TermBoostFlags_MissingHigh & flags)) {
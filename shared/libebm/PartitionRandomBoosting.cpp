@@ -5,6 +5,7 @@
 #include "pch.hpp"
 
 #include <stddef.h> // size_t, ptrdiff_t
+#include <string.h> // memcpy
 #include <algorithm> // sort
 
 #include "libebm.h" // ErrorEbm
@@ -41,21 +42,23 @@ template<bool bHessian, size_t cCompilerScores> class PartitionRandomBoostingInt
          const FloatCalc regAlpha,
          const FloatCalc regLambda,
          const FloatCalc deltaStepMax,
+         const size_t cSamplesLeafMin,
+         const size_t cRandomRetries,
          const IntEbm* const aLeavesMax,
          const MonotoneDirection monotoneDirection,
          double* const pTotalGain) {
       // THIS RANDOM SPLIT FUNCTION IS PRIMARILY USED FOR DIFFERENTIAL PRIVACY EBMs
 
-      // TODO: add a new random_rety option that will retry random splitting for N times and select the one with the
-      // best gain
-      // TODO: accept the minimum number of items in a split and then refuse to allow the split if we violate it, or
-      //       provide a soft trigger that generates 10 random ones and selects the one that violates the least
-      //       maybe provide a flag to indicate if we want a hard or soft allowance.  We won't be splitting if we
-      //       require a soft allowance and a lot of regions have zeros.
-      // TODO: accept 0 == minSamplesLeaf as a minimum number of items so that we can always choose to allow a tensor
-      // split (for DP)
+      // We draw cRandomRetries random cut sets and collapse the same main histogram once per cut set, so retries
+      // never re-bin the samples.  The cut set with the fewest leaves below cSamplesLeafMin (when one of the
+      // RandomMinLeaf flags is set) and then the highest gain is kept.  With the hard flag, a cut set that leaves
+      // any region too small is never used, and if every draw does that we make a single update for the tensor.
+      // Choosing among cut sets by gain looks at the data, so GenerateTermUpdate rejects retries for DP boosters.
+
       // TODO: move most of this code out of this function into a non-templated place
 
+      EBM_ASSERT(size_t{1} <= cRandomRetries);
+
       ErrorEbm error;
       BoosterCore* const pBoosterCore = pBoosterShell->GetBoosterCore();
 
@@ -167,285 +170,405 @@ template<bool bHessian, size_t cCompilerScores> class PartitionRandomBoostingInt
 
       const size_t cBytesBuffer = EbmMax(cBytesSlicesAndCollapsedTensor, cBytesSlicesPlusRandom);
 
+      // when retrying, the cuts of the current draw and of the best draw so far are kept after the working area so
+      // that the best draw can be collapsed again if a later draw overwrote its collapsed tensor
+      const bool bRetry = size_t{1} != cRandomRetries;
+      size_t cBytesAllocate = cBytesBuffer;
+      if(bRetry) {
+         if(IsMultiplyError(size_t{2}, cBytesSlices)) {
+            LOG_0(Trace_Warning, "WARNING PartitionRandomBoostingInternal IsMultiplyError(size_t{2}, cBytesSlices)");
+            return Error_OutOfMemory;
+         }
+         if(IsAddError(cBytesAllocate, size_t{2} * cBytesSlices)) {
+            LOG_0(Trace_Warning,
+                  "WARNING PartitionRandomBoostingInternal IsAddError(cBytesAllocate, size_t{2} * cBytesSlices)");
+            return Error_OutOfMemory;
+         }
+         cBytesAllocate += size_t{2} * cBytesSlices;
+      }
+
       // TODO: use GrowThreadByteBuffer2 for this, but first we need to change that to allocate void or bytes
-      char* const pBuffer = static_cast<char*>(malloc(cBytesBuffer));
+      char* const pBuffer = static_cast<char*>(malloc(cBytesAllocate));
       if(UNLIKELY(nullptr == pBuffer)) {
          LOG_0(Trace_Warning, "WARNING PartitionRandomBoostingInternal nullptr == pBuffer");
          return Error_OutOfMemory;
       }
       size_t* const acItemsInNextSliceOrBytesInCurrentSlice = reinterpret_cast<size_t*>(pBuffer);
 
-      const IntEbm* pLeavesMax2 = aLeavesMax;
-      size_t* pcItemsInNextSliceOrBytesInCurrentSlice2 = acItemsInNextSliceOrBytesInCurrentSlice;
-      const TermFeature* pTermFeature2 = pTerm->GetTermFeatures();
-      do {
-         size_t cTreeSplitsMax;
-         if(nullptr == pLeavesMax2) {
-            cTreeSplitsMax = size_t{0};
-         } else {
-            const IntEbm countLeavesMax = *pLeavesMax2;
-            ++pLeavesMax2;
-            if(countLeavesMax <= IntEbm{1}) {
-               cTreeSplitsMax = size_t{0};
-            } else {
-               cTreeSplitsMax = static_cast<size_t>(countLeavesMax) - size_t{1};
-               if(IsConvertError<size_t>(countLeavesMax)) {
-                  // we can never exceed a size_t number of leaves, so let's just set it to the maximum if we
-                  // were going to overflow because it will generate the same results as if we used the true number
-                  cTreeSplitsMax = std::numeric_limits<size_t>::max() - size_t{1};
-               }
-            }
-         }
+      size_t* aCandidateSplits = nullptr;
+      size_t* aBestSplits = nullptr;
+      if(bRetry) {
+         aCandidateSplits = reinterpret_cast<size_t*>(pBuffer + cBytesBuffer);
+         aBestSplits = aCandidateSplits + cSlicesTotal;
+      }
 
-         const FeatureBoosting* const pFeature = pTermFeature2->m_pFeature;
-         const size_t cBins = pFeature->GetCountBins();
-         EBM_ASSERT(size_t{1} <= cBins); // we don't boost on empty training sets
-         size_t cPossibleSplitLocations = cBins - size_t{1};
-         if(size_t{0} != cPossibleSplitLocations) {
-            // drop any dimensions with 1 bin since the tensor is the same without the extra dimension
+      // put the histograms right after our slice array
+      auto* const aCollapsedBins =
+            reinterpret_cast<Bin<FloatMain, UIntMain, true, true, bHessian, GetArrayScores(cCompilerScores)>*>(
+                  acItemsInNextSliceOrBytesInCurrentSlice + cSlicesTotal);
+      const auto* const pCollapsedBinEnd = IndexBin(aCollapsedBins, cCollapsedTensorCells);
 
-            if(size_t{0} != cTreeSplitsMax) {
-               size_t* pFillIndexes = pcItemsInNextSliceOrBytesInCurrentSlice2;
-               size_t iEdge = cPossibleSplitLocations; // 1 means split between bin 0 and bin 1
-               do {
-                  *pFillIndexes = iEdge;
-                  ++pFillIndexes;
-                  --iEdge;
-               } while(size_t{0} != iEdge);
+      struct RandomSplitState {
+         size_t m_cItemsInSliceRemaining;
+         size_t m_cBytesSubtractResetCollapsedBin;
 
-               size_t* pOriginal = pcItemsInNextSliceOrBytesInCurrentSlice2;
+         const size_t* m_pcItemsInNextSlice;
+         const size_t* m_pcItemsInNextSliceEnd;
+      };
+      RandomSplitState randomSplitState[k_cDimensionsMax - size_t{1}]; // the first dimension is special cased
+      RandomSplitState* pStateInit;
+      const size_t* pcBytesInSliceEnd;
 
-               const size_t cSplits = EbmMin(cTreeSplitsMax, cPossibleSplitLocations);
-               EBM_ASSERT(1 <= cSplits);
-               const size_t* const pcItemsInNextSliceOrBytesInCurrentSliceEnd =
-                     pcItemsInNextSliceOrBytesInCurrentSlice2 + cSplits;
-               do {
-                  const size_t iRandom = pRng->NextFast(cPossibleSplitLocations);
-                  size_t* const pRandomSwap = pcItemsInNextSliceOrBytesInCurrentSlice2 + iRandom;
-                  const size_t temp = *pRandomSwap;
-                  *pRandomSwap = *pcItemsInNextSliceOrBytesInCurrentSlice2;
-                  *pcItemsInNextSliceOrBytesInCurrentSlice2 = temp;
-                  --cPossibleSplitLocations;
-                  ++pcItemsInNextSliceOrBytesInCurrentSlice2;
-               } while(pcItemsInNextSliceOrBytesInCurrentSliceEnd != pcItemsInNextSliceOrBytesInCurrentSlice2);
+      const bool bMinLeafHard = 0 != (TermBoostFlags_RandomMinLeafHard & flags);
+      const bool bMinLeaf = bMinLeafHard || 0 != (TermBoostFlags_RandomMinLeafSoft & flags);
+      const bool bUseLogitBoost = bHessian && !(TermBoostFlags_DisableNewtonGain & flags);
+
+      size_t cViolationsBest = std::numeric_limits<size_t>::max();
+      FloatCalc gainBest = std::numeric_limits<FloatCalc>::lowest();
+      FloatCalc gainParentBest = 0;
+      bool bLastBest = true;
+      bool bReplayBest = false;
+      size_t cRetriesRemaining = cRandomRetries;
+      while(true) {
+         if(!bReplayBest) {
+            const IntEbm* pLeavesMax2 = aLeavesMax;
+            size_t* pcItemsInNextSliceOrBytesInCurrentSlice2 = acItemsInNextSliceOrBytesInCurrentSlice;
+            const TermFeature* pTermFeature2 = pTerm->GetTermFeatures();
+            do {
+               size_t cTreeSplitsMax;
+               if(nullptr == pLeavesMax2) {
+                  cTreeSplitsMax = size_t{0};
+               } else {
+                  const IntEbm countLeavesMax = *pLeavesMax2;
+                  ++pLeavesMax2;
+                  if(countLeavesMax <= IntEbm{1}) {
+                     cTreeSplitsMax = size_t{0};
+                  } else {
+                     cTreeSplitsMax = static_cast<size_t>(countLeavesMax) - size_t{1};
+                     if(IsConvertError<size_t>(countLeavesMax)) {
+                        // we can never exceed a size_t number of leaves, so let's just set it to the maximum if
+                        // we were going to overflow because it will generate the same results as if we used the
+                        // true number
+                        cTreeSplitsMax = std::numeric_limits<size_t>::max() - size_t{1};
+                     }
+                  }
+               }
 
-               std::sort(pOriginal, pcItemsInNextSliceOrBytesInCurrentSlice2);
+               const FeatureBoosting* const pFeature = pTermFeature2->m_pFeature;
+               const size_t cBins = pFeature->GetCountBins();
+               EBM_ASSERT(size_t{1} <= cBins); // we don't boost on empty training sets
+               size_t cPossibleSplitLocations = cBins - size_t{1};
+               if(size_t{0} != cPossibleSplitLocations) {
+                  // drop any dimensions with 1 bin since the tensor is the same without the extra dimension
+
+                  if(size_t{0} != cTreeSplitsMax) {
+                     size_t* pFillIndexes = pcItemsInNextSliceOrBytesInCurrentSlice2;
+                     size_t iEdge = cPossibleSplitLocations; // 1 means split between bin 0 and bin 1
+                     do {
+                        *pFillIndexes = iEdge;
+                        ++pFillIndexes;
+                        --iEdge;
+                     } while(size_t{0} != iEdge);
+
+                     size_t* pOriginal = pcItemsInNextSliceOrBytesInCurrentSlice2;
+
+                     const size_t cSplits = EbmMin(cTreeSplitsMax, cPossibleSplitLocations);
+                     EBM_ASSERT(1 <= cSplits);
+                     const size_t* const pcItemsInNextSliceOrBytesInCurrentSliceEnd =
+                           pcItemsInNextSliceOrBytesInCurrentSlice2 + cSplits;
+                     do {
+                        const size_t iRandom = pRng->NextFast(cPossibleSplitLocations);
+                        size_t* const pRandomSwap = pcItemsInNextSliceOrBytesInCurrentSlice2 + iRandom;
+                        const size_t temp = *pRandomSwap;
+                        *pRandomSwap = *pcItemsInNextSliceOrBytesInCurrentSlice2;
+                        *pcItemsInNextSliceOrBytesInCurrentSlice2 = temp;
+                        --cPossibleSplitLocations;
+                        ++pcItemsInNextSliceOrBytesInCurrentSlice2;
+                     } while(pcItemsInNextSliceOrBytesInCurrentSliceEnd != pcItemsInNextSliceOrBytesInCurrentSlice2);
+
+                     std::sort(pOriginal, pcItemsInNextSliceOrBytesInCurrentSlice2);
+                  }
+                  *pcItemsInNextSliceOrBytesInCurrentSlice2 = cBins; // index 1 past the last item
+                  ++pcItemsInNextSliceOrBytesInCurrentSlice2;
+               }
+               ++pTermFeature2;
+            } while(pTermFeaturesEnd != pTermFeature2);
+            if(bRetry) {
+               memcpy(aCandidateSplits, acItemsInNextSliceOrBytesInCurrentSlice, cBytesSlices);
             }
-            *pcItemsInNextSliceOrBytesInCurrentSlice2 = cBins; // index 1 past the last item
-            ++pcItemsInNextSliceOrBytesInCurrentSlice2;
          }
-         ++pTermFeature2;
-      } while(pTermFeaturesEnd != pTermFeature2);
 
-      const IntEbm* pLeavesMax3 = aLeavesMax;
-      const size_t* pcBytesInSliceEnd;
-      const TermFeature* pTermFeature3 = pTerm->GetTermFeatures();
-      size_t* pcItemsInNextSliceOrBytesInCurrentSlice3 = acItemsInNextSliceOrBytesInCurrentSlice;
-      size_t cBytesCollapsedTensor3;
-      while(true) {
-         EBM_ASSERT(pTermFeature3 < pTermFeaturesEnd);
+         const IntEbm* pLeavesMax3 = aLeavesMax;
+         const TermFeature* pTermFeature3 = pTerm->GetTermFeatures();
+         size_t* pcItemsInNextSliceOrBytesInCurrentSlice3 = acItemsInNextSliceOrBytesInCurrentSlice;
+         size_t cBytesCollapsedTensor3;
+         while(true) {
+            EBM_ASSERT(pTermFeature3 < pTermFeaturesEnd);
 
-         size_t cLeavesMax;
-         if(nullptr == pLeavesMax3) {
-            cLeavesMax = size_t{1};
-         } else {
-            const IntEbm countLeavesMax = *pLeavesMax3;
-            ++pLeavesMax3;
-            if(countLeavesMax <= IntEbm{1}) {
+            size_t cLeavesMax;
+            if(nullptr == pLeavesMax3) {
                cLeavesMax = size_t{1};
             } else {
-               cLeavesMax = static_cast<size_t>(countLeavesMax);
-               if(IsConvertError<size_t>(countLeavesMax)) {
-                  // we can never exceed a size_t number of leaves, so let's just set it to the maximum if we
-                  // were going to overflow because it will generate the same results as if we used the true number
-                  cLeavesMax = std::numeric_limits<size_t>::max();
+               const IntEbm countLeavesMax = *pLeavesMax3;
+               ++pLeavesMax3;
+               if(countLeavesMax <= IntEbm{1}) {
+                  cLeavesMax = size_t{1};
+               } else {
+                  cLeavesMax = static_cast<size_t>(countLeavesMax);
+                  if(IsConvertError<size_t>(countLeavesMax)) {
+                     // we can never exceed a size_t number of leaves, so let's just set it to the maximum if we
+                     // were going to overflow because it will generate the same results as if we used the true number
+                     cLeavesMax = std::numeric_limits<size_t>::max();
+                  }
                }
             }
-         }
-
-         // the first dimension is special.  we put byte until next item into it instead of counts remaining
-         const FeatureBoosting* const pFeature = pTermFeature3->m_pFeature;
-         ++pTermFeature3;
-         const size_t cBins = pFeature->GetCountBins();
-         EBM_ASSERT(size_t{1} <= cBins); // we don't boost on empty training sets
-         if(size_t{1} < cBins) {
-            // drop any dimensions with 1 bin since the tensor is the same without the extra dimension
 
-            const size_t cFirstSlices = EbmMin(cLeavesMax, cBins);
-            cBytesCollapsedTensor3 = cBytesPerBin * cFirstSlices;
+            // the first dimension is special.  we put byte until next item into it instead of counts remaining
+            const FeatureBoosting* const pFeature = pTermFeature3->m_pFeature;
+            ++pTermFeature3;
+            const size_t cBins = pFeature->GetCountBins();
+            EBM_ASSERT(size_t{1} <= cBins); // we don't boost on empty training sets
+            if(size_t{1} < cBins) {
+               // drop any dimensions with 1 bin since the tensor is the same without the extra dimension
 
-            pcBytesInSliceEnd = acItemsInNextSliceOrBytesInCurrentSlice + cFirstSlices;
-            size_t iPrev = size_t{0};
-            do {
-               // The Clang static analysis tool does not like our access here to the
-               // acItemsInNextSliceOrBytesInCurrentSlice buffer via the pcItemsInNextSliceOrBytesInCurrentSlice3
-               // pointer. I think this is because we allocate the buffer to contain both the split information
-               // and also the tensor information, and above this point we have only filled in the split information
-               // which leaves the buffer only partly initialized as we use it here. If we put a
-               // memset(acItemsInNextSliceOrBytesInCurrentSlice, 0, cBytesBuffer) after allocation then
-               // this analysis warning goes away which reinforces this suspicion.
-               StopClangAnalysis();
-
-               const size_t iCur = *pcItemsInNextSliceOrBytesInCurrentSlice3;
-               EBM_ASSERT(iPrev < iCur);
-               // turn these into bytes from the previous
-               *pcItemsInNextSliceOrBytesInCurrentSlice3 = (iCur - iPrev) * cBytesPerBin;
-               iPrev = iCur;
-               ++pcItemsInNextSliceOrBytesInCurrentSlice3;
-            } while(pcBytesInSliceEnd != pcItemsInNextSliceOrBytesInCurrentSlice3);
+               const size_t cFirstSlices = EbmMin(cLeavesMax, cBins);
+               cBytesCollapsedTensor3 = cBytesPerBin * cFirstSlices;
 
-            // we found a non-eliminated dimension.  We treat the first dimension differently from others, so
-            // if our first dimension is eliminated we need to keep looking until we find our first REAL dimension
-            break;
+               pcBytesInSliceEnd = acItemsInNextSliceOrBytesInCurrentSlice + cFirstSlices;
+               size_t iPrev = size_t{0};
+               do {
+                  // The Clang static analysis tool does not like our access here to the
+                  // acItemsInNextSliceOrBytesInCurrentSlice buffer via the pcItemsInNextSliceOrBytesInCurrentSlice3
+                  // pointer. I think this is because we allocate the buffer to contain both the split information
+                  // and also the tensor information, and above this point we have only filled in the split information
+                  // which leaves the buffer only partly initialized as we use it here. If we put a
+                  // memset(acItemsInNextSliceOrBytesInCurrentSlice, 0, cBytesBuffer) after allocation then
+                  // this analysis warning goes away which reinforces this suspicion.
+                  StopClangAnalysis();
+
+                  const size_t iCur = *pcItemsInNextSliceOrBytesInCurrentSlice3;
+                  EBM_ASSERT(iPrev < iCur);
+                  // turn these into bytes from the previous
+                  *pcItemsInNextSliceOrBytesInCurrentSlice3 = (iCur - iPrev) * cBytesPerBin;
+                  iPrev = iCur;
+                  ++pcItemsInNextSliceOrBytesInCurrentSlice3;
+               } while(pcBytesInSliceEnd != pcItemsInNextSliceOrBytesInCurrentSlice3);
+
+               // we found a non-eliminated dimension.  We treat the first dimension differently from others, so
+               // if our first dimension is eliminated we need to keep looking until we find our first REAL dimension
+               break;
+            }
          }
-      }
-
-      struct RandomSplitState {
-         size_t m_cItemsInSliceRemaining;
-         size_t m_cBytesSubtractResetCollapsedBin;
 
-         const size_t* m_pcItemsInNextSlice;
-         const size_t* m_pcItemsInNextSliceEnd;
-      };
-      RandomSplitState randomSplitState[k_cDimensionsMax - size_t{1}]; // the first dimension is special cased
-      RandomSplitState* pStateInit = &randomSplitState[0];
+         pStateInit = &randomSplitState[0];
 
-      for(; pTermFeaturesEnd != pTermFeature3; ++pTermFeature3) {
-         size_t cLeavesMax;
-         if(nullptr == pLeavesMax3) {
-            cLeavesMax = size_t{1};
-         } else {
-            const IntEbm countLeavesMax = *pLeavesMax3;
-            ++pLeavesMax3;
-            if(countLeavesMax <= IntEbm{1}) {
+         for(; pTermFeaturesEnd != pTermFeature3; ++pTermFeature3) {
+            size_t cLeavesMax;
+            if(nullptr == pLeavesMax3) {
                cLeavesMax = size_t{1};
             } else {
-               cLeavesMax = static_cast<size_t>(countLeavesMax);
-               if(IsConvertError<size_t>(countLeavesMax)) {
-                  // we can never exceed a size_t number of leaves, so let's just set it to the maximum if we
-                  // were going to overflow because it will generate the same results as if we used the true number
-                  cLeavesMax = std::numeric_limits<size_t>::max();
+               const IntEbm countLeavesMax = *pLeavesMax3;
+               ++pLeavesMax3;
+               if(countLeavesMax <= IntEbm{1}) {
+                  cLeavesMax = size_t{1};
+               } else {
+                  cLeavesMax = static_cast<size_t>(countLeavesMax);
+                  if(IsConvertError<size_t>(countLeavesMax)) {
+                     // we can never exceed a size_t number of leaves, so let's just set it to the maximum if we
+                     // were going to overflow because it will generate the same results as if we used the true number
+                     cLeavesMax = std::numeric_limits<size_t>::max();
+                  }
                }
             }
-         }
 
-         const FeatureBoosting* const pFeature = pTermFeature3->m_pFeature;
-         const size_t cBins = pFeature->GetCountBins();
-         EBM_ASSERT(size_t{1} <= cBins); // we don't boost on empty training sets
-         if(size_t{1} < cBins) {
-            // drop any dimensions with 1 bin since the tensor is the same without the extra dimension
+            const FeatureBoosting* const pFeature = pTermFeature3->m_pFeature;
+            const size_t cBins = pFeature->GetCountBins();
+            EBM_ASSERT(size_t{1} <= cBins); // we don't boost on empty training sets
+            if(size_t{1} < cBins) {
+               // drop any dimensions with 1 bin since the tensor is the same without the extra dimension
 
-            size_t cSlices = EbmMin(cLeavesMax, cBins);
+               size_t cSlices = EbmMin(cLeavesMax, cBins);
 
-            pStateInit->m_cBytesSubtractResetCollapsedBin = cBytesCollapsedTensor3;
+               pStateInit->m_cBytesSubtractResetCollapsedBin = cBytesCollapsedTensor3;
 
-            EBM_ASSERT(!IsMultiplyError(cBytesCollapsedTensor3, cSlices)); // our allocated histogram is bigger
-            cBytesCollapsedTensor3 *= cSlices;
+               EBM_ASSERT(!IsMultiplyError(cBytesCollapsedTensor3, cSlices)); // our allocated histogram is bigger
+               cBytesCollapsedTensor3 *= cSlices;
 
-            const size_t iFirst = *pcItemsInNextSliceOrBytesInCurrentSlice3;
-            EBM_ASSERT(1 <= iFirst);
-            pStateInit->m_cItemsInSliceRemaining = iFirst;
-            pStateInit->m_pcItemsInNextSlice = pcItemsInNextSliceOrBytesInCurrentSlice3;
+               const size_t iFirst = *pcItemsInNextSliceOrBytesInCurrentSlice3;
+               EBM_ASSERT(1 <= iFirst);
+               pStateInit->m_cItemsInSliceRemaining = iFirst;
+               pStateInit->m_pcItemsInNextSlice = pcItemsInNextSliceOrBytesInCurrentSlice3;
 
-            size_t iPrev = iFirst;
-            for(--cSlices; LIKELY(size_t{0} != cSlices); --cSlices) {
-               size_t* const pCur = pcItemsInNextSliceOrBytesInCurrentSlice3 + size_t{1};
-               const size_t iCur = *pCur;
-               EBM_ASSERT(iPrev < iCur);
-               *pcItemsInNextSliceOrBytesInCurrentSlice3 = iCur - iPrev;
-               iPrev = iCur;
-               pcItemsInNextSliceOrBytesInCurrentSlice3 = pCur;
+               size_t iPrev = iFirst;
+               for(--cSlices; LIKELY(size_t{0} != cSlices); --cSlices) {
+                  size_t* const pCur = pcItemsInNextSliceOrBytesInCurrentSlice3 + size_t{1};
+                  const size_t iCur = *pCur;
+                  EBM_ASSERT(iPrev < iCur);
+                  *pcItemsInNextSliceOrBytesInCurrentSlice3 = iCur - iPrev;
+                  iPrev = iCur;
+                  pcItemsInNextSliceOrBytesInCurrentSlice3 = pCur;
+               }
+               *pcItemsInNextSliceOrBytesInCurrentSlice3 = iFirst;
+               ++pcItemsInNextSliceOrBytesInCurrentSlice3;
+               pStateInit->m_pcItemsInNextSliceEnd = pcItemsInNextSliceOrBytesInCurrentSlice3;
+               ++pStateInit;
             }
-            *pcItemsInNextSliceOrBytesInCurrentSlice3 = iFirst;
-            ++pcItemsInNextSliceOrBytesInCurrentSlice3;
-            pStateInit->m_pcItemsInNextSliceEnd = pcItemsInNextSliceOrBytesInCurrentSlice3;
-            ++pStateInit;
          }
-      }
 
-      // put the histograms right after our slice array
-      auto* const aCollapsedBins =
-            reinterpret_cast<Bin<FloatMain, UIntMain, true, true, bHessian, GetArrayScores(cCompilerScores)>*>(
-                  pcItemsInNextSliceOrBytesInCurrentSlice3);
+         EBM_ASSERT(reinterpret_cast<void*>(pcItemsInNextSliceOrBytesInCurrentSlice3) ==
+               reinterpret_cast<void*>(aCollapsedBins));
+         EBM_ASSERT(IndexBin(aCollapsedBins, cBytesCollapsedTensor3) == pCollapsedBinEnd);
 
-      aCollapsedBins->ZeroMem(cBytesCollapsedTensor3);
-      const auto* const pCollapsedBinEnd = IndexBin(aCollapsedBins, cBytesCollapsedTensor3);
+         aCollapsedBins->ZeroMem(cBytesCollapsedTensor3);
 
-      // we special case the first dimension, so drop it by subtracting
-      EBM_ASSERT(&randomSplitState[pTerm->GetCountRealDimensions() - size_t{1}] == pStateInit);
+         // we special case the first dimension, so drop it by subtracting
+         EBM_ASSERT(&randomSplitState[pTerm->GetCountRealDimensions() - size_t{1}] == pStateInit);
 
-      const auto* pBin = aBins;
-      auto* pCollapsedBin1 = aCollapsedBins;
+         const auto* pBin = aBins;
+         auto* pCollapsedBin1 = aCollapsedBins;
 
-      {
-      move_next_slice:;
+         {
+         move_next_slice:;
 
-         // for the first dimension, acItemsInNextSliceOrBytesInCurrentSlice contains the number of bytes to proceed
-         // until the next pBinSliceEnd point.  For the second dimension and higher, it contains a
-         // count of items for the NEXT slice.  The 0th element contains the count of items for the
-         // 1st slice.  Yeah, it's pretty confusing, but it allows for some pretty compact code in this
-         // super critical inner loop without overburdening the CPU registers when we execute the outer loop.
-         const size_t* pcItemsInNextSliceOrBytesInCurrentSlice = acItemsInNextSliceOrBytesInCurrentSlice;
-         do {
-            const auto* const pBinSliceEnd = IndexBin(pBin, *pcItemsInNextSliceOrBytesInCurrentSlice);
+            // for the first dimension, acItemsInNextSliceOrBytesInCurrentSlice contains the number of bytes to proceed
+            // until the next pBinSliceEnd point.  For the second dimension and higher, it contains a
+            // count of items for the NEXT slice.  The 0th element contains the count of items for the
+            // 1st slice.  Yeah, it's pretty confusing, but it allows for some pretty compact code in this
+            // super critical inner loop without overburdening the CPU registers when we execute the outer loop.
+            const size_t* pcItemsInNextSliceOrBytesInCurrentSlice = acItemsInNextSliceOrBytesInCurrentSlice;
             do {
-               ASSERT_BIN_OK(cBytesPerBin, pBin, pBoosterShell->GetDebugMainBinsEnd());
-               // TODO: add this first into a local Bin that can be put in registers then write it to
-               // pCollapsedBin1 aferwards
-               pCollapsedBin1->Add(cScores, *pBin);
+               const auto* const pBinSliceEnd = IndexBin(pBin, *pcItemsInNextSliceOrBytesInCurrentSlice);
+               do {
+                  ASSERT_BIN_OK(cBytesPerBin, pBin, pBoosterShell->GetDebugMainBinsEnd());
+                  // TODO: add this first into a local Bin that can be put in registers then write it to
+                  // pCollapsedBin1 aferwards
+                  pCollapsedBin1->Add(cScores, *pBin);
+
+                  // we're walking through all bins, so just move to the next one in the flat array,
+                  // with the knowledge that we'll figure out it's multi-dimenional index below
+                  pBin = IndexBin(pBin, cBytesPerBin);
+               } while(LIKELY(pBinSliceEnd != pBin));
+
+               pCollapsedBin1 = IndexBin(pCollapsedBin1, cBytesPerBin);
+
+               ++pcItemsInNextSliceOrBytesInCurrentSlice;
+            } while(PREDICTABLE(pcBytesInSliceEnd != pcItemsInNextSliceOrBytesInCurrentSlice));
+
+            for(RandomSplitState* pState = randomSplitState; PREDICTABLE(pStateInit != pState); ++pState) {
+               EBM_ASSERT(size_t{1} <= pState->m_cItemsInSliceRemaining);
+               const size_t cItemsInSliceRemaining = pState->m_cItemsInSliceRemaining - size_t{1};
+               if(LIKELY(size_t{0} != cItemsInSliceRemaining)) {
+                  // ideally, the compiler would move this to the location right above the first loop and it would
+                  // jump over it on the first loop, but I wasn't able to make the Visual Studio compiler do it
 
-               // we're walking through all bins, so just move to the next one in the flat array,
-               // with the knowledge that we'll figure out it's multi-dimenional index below
-               pBin = IndexBin(pBin, cBytesPerBin);
-            } while(LIKELY(pBinSliceEnd != pBin));
+                  pState->m_cItemsInSliceRemaining = cItemsInSliceRemaining;
+                  pCollapsedBin1 = NegativeIndexBin(pCollapsedBin1, pState->m_cBytesSubtractResetCollapsedBin);
 
-            pCollapsedBin1 = IndexBin(pCollapsedBin1, cBytesPerBin);
+                  goto move_next_slice;
+               }
+
+               const size_t* pcItemsInNextSlice = pState->m_pcItemsInNextSlice;
+               EBM_ASSERT(pcItemsInNextSliceOrBytesInCurrentSlice <= pcItemsInNextSlice);
+               EBM_ASSERT(pcItemsInNextSlice < pState->m_pcItemsInNextSliceEnd);
+               pState->m_cItemsInSliceRemaining = *pcItemsInNextSlice;
+               ++pcItemsInNextSlice;
+               // it would be legal for us to move this assignment into the if statement below, since if we don't
+               // enter the if statement we overwrite the value that we just wrote, but writing it here allows the
+               // compiler to emit a sinlge jne instruction to move to move_next_slice without using an extra
+               // jmp instruction.  Typically we have 3 slices, so we avoid 2 jmp instructions for the cost of
+               // 1 extra assignment that'll happen 1/3 of the time when m_pcItemsInNextSliceEnd == pcItemsInNextSlice
+               // Something would have to be wrong for us to have less than 2 slices since then we'd be ignoring a
+               // dimension, so even in the realistic worst case the 1 jmp instruction balances the extra mov
+               // instruction
+               pState->m_pcItemsInNextSlice = pcItemsInNextSlice;
+               if(UNPREDICTABLE(pState->m_pcItemsInNextSliceEnd != pcItemsInNextSlice)) {
+                  goto move_next_slice;
+               }
+               // the end of the previous dimension is the start of our current one
+               pState->m_pcItemsInNextSlice = pcItemsInNextSliceOrBytesInCurrentSlice;
+               pcItemsInNextSliceOrBytesInCurrentSlice = pcItemsInNextSlice;
+            }
+         }
 
-            ++pcItemsInNextSliceOrBytesInCurrentSlice;
-         } while(PREDICTABLE(pcBytesInSliceEnd != pcItemsInNextSliceOrBytesInCurrentSlice));
+         if(bReplayBest) {
+            break;
+         }
 
-         for(RandomSplitState* pState = randomSplitState; PREDICTABLE(pStateInit != pState); ++pState) {
-            EBM_ASSERT(size_t{1} <= pState->m_cItemsInSliceRemaining);
-            const size_t cItemsInSliceRemaining = pState->m_cItemsInSliceRemaining - size_t{1};
-            if(LIKELY(size_t{0} != cItemsInSliceRemaining)) {
-               // ideally, the compiler would move this to the location right above the first loop and it would
-               // jump over it on the first loop, but I wasn't able to make the Visual Studio compiler do it
+         if(bRetry || bMinLeaf) {
+            size_t cViolations = 0;
+            if(bMinLeaf) {
+               const auto* pCollapsedBin = aCollapsedBins;
+               do {
+                  if(static_cast<size_t>(pCollapsedBin->GetCountSamples()) < cSamplesLeafMin) {
+                     ++cViolations;
+                  }
+                  pCollapsedBin = IndexBin(pCollapsedBin, cBytesPerBin);
+               } while(pCollapsedBinEnd != pCollapsedBin);
+            }
 
-               pState->m_cItemsInSliceRemaining = cItemsInSliceRemaining;
-               pCollapsedBin1 = NegativeIndexBin(pCollapsedBin1, pState->m_cBytesSubtractResetCollapsedBin);
+            // every leaf is scored without regard to the parent since the parent is the same for all draws
+            FloatCalc gainCandidate = 0;
+            FloatCalc gainParent = 0;
+            if(bRetry) {
+               for(size_t iScore = 0; iScore < cScores; ++iScore) {
+                  FloatCalc gradParent = 0;
+                  FloatCalc hessParent = 0;
+                  const auto* pCollapsedBin = aCollapsedBins;
+                  do {
+                     const auto* const aGradHess = pCollapsedBin->GetGradientPairs();
+                     const FloatCalc grad = static_cast<FloatCalc>(aGradHess[iScore].m_sumGradients);
+                     FloatCalc hess = static_cast<FloatCalc>(pCollapsedBin->GetWeight());
+                     if(bUseLogitBoost) {
+                        hess = static_cast<FloatCalc>(aGradHess[iScore].GetHess());
+                     }
+                     gainCandidate += CalcPartialGain<true>(grad, hess, regAlpha, regLambda, deltaStepMax);
+                     gradParent += grad;
+                     hessParent += hess;
+                     pCollapsedBin = IndexBin(pCollapsedBin, cBytesPerBin);
+                  } while(pCollapsedBinEnd != pCollapsedBin);
+                  gainParent += CalcPartialGain<true>(gradParent, hessParent, regAlpha, regLambda, deltaStepMax);
+               }
+            }
 
-               goto move_next_slice;
+            bLastBest = false;
+            if(cViolations < cViolationsBest || (cViolations == cViolationsBest && gainBest < gainCandidate)) {
+               bLastBest = true;
+               cViolationsBest = cViolations;
+               gainBest = gainCandidate;
+               gainParentBest = gainParent;
+               if(bRetry) {
+                  size_t* const aSwap = aBestSplits;
+                  aBestSplits = aCandidateSplits;
+                  aCandidateSplits = aSwap;
+               }
             }
+         }
 
-            const size_t* pcItemsInNextSlice = pState->m_pcItemsInNextSlice;
-            EBM_ASSERT(pcItemsInNextSliceOrBytesInCurrentSlice <= pcItemsInNextSlice);
-            EBM_ASSERT(pcItemsInNextSlice < pState->m_pcItemsInNextSliceEnd);
-            pState->m_cItemsInSliceRemaining = *pcItemsInNextSlice;
-            ++pcItemsInNextSlice;
-            // it would be legal for us to move this assignment into the if statement below, since if we don't
-            // enter the if statement we overwrite the value that we just wrote, but writing it here allows the
-            // compiler to emit a sinlge jne instruction to move to move_next_slice without using an extra
-            // jmp instruction.  Typically we have 3 slices, so we avoid 2 jmp instructions for the cost of
-            // 1 extra assignment that'll happen 1/3 of the time when m_pcItemsInNextSliceEnd == pcItemsInNextSlice
-            // Something would have to be wrong for us to have less than 2 slices since then we'd be ignoring a
-            // dimension, so even in the realistic worst case the 1 jmp instruction balances the extra mov instruction
-            pState->m_pcItemsInNextSlice = pcItemsInNextSlice;
-            if(UNPREDICTABLE(pState->m_pcItemsInNextSliceEnd != pcItemsInNextSlice)) {
-               goto move_next_slice;
+         --cRetriesRemaining;
+         if(size_t{0} == cRetriesRemaining) {
+            if(bLastBest) {
+               break;
             }
-            // the end of the previous dimension is the start of our current one
-            pState->m_pcItemsInNextSlice = pcItemsInNextSliceOrBytesInCurrentSlice;
-            pcItemsInNextSliceOrBytesInCurrentSlice = pcItemsInNextSlice;
+            // a later draw overwrote the collapsed tensor of the best draw, so collapse the best draw again
+            memcpy(acItemsInNextSliceOrBytesInCurrentSlice, aBestSplits, cBytesSlices);
+            bReplayBest = true;
          }
       }
 
-      // TODO: retrieve the gain.  Always calculate the gain without respect to the parent and pick the best one
-      //       Then, before exiting, on the last one we collapse the collapsed tensor even more into just a single
-      //       bin from which we can calculate the parent and subtract the best child from the parent.
+      // with the hard rule, if every draw left a region below the minimum we make one update for the whole tensor
+      bool bCollapse = bMinLeafHard && size_t{0} != cViolationsBest;
 
-      // FloatCalc gain;
-      // FloatCalc gainParent = 0;
       FloatCalc gain = 0;
+      if(bRetry && !bCollapse) {
+         gain = gainBest - gainParentBest;
+         if(std::isnan(gain)) {
+            // the partial gains overflowed, which we report as +inf like the other boosting functions
+            gain = std::numeric_limits<FloatCalc>::infinity();
+         } else if(gain < k_gainMin) {
+            // also filters out slightly negative numbers that can arrise from floating point noise
+            gain = 0;
+         }
+      }
 
       const TermFeature* pTermFeature4 = pTerm->GetTermFeatures();
       size_t iDimensionWrite = static_cast<size_t>(~size_t{0}); // this is -1, but without the compiler warning
@@ -531,110 +654,112 @@ template<bool bHessian, size_t cCompilerScores> class PartitionRandomBoostingInt
       FloatScore* pUpdateScore = pInnerTermUpdate->GetTensorScoresPointer();
       auto* pCollapsedBin2 = aCollapsedBins;
 
-      if(TermBoostFlags_GradientSums & flags) {
-         do {
-            auto* const pGradientPair = pCollapsedBin2->GetGradientPairs();
-
-            for(size_t iScore = 0; iScore < cScores; ++iScore) {
-               const FloatCalc updateScore =
-                     CalcGradientUpdate(static_cast<FloatCalc>(pGradientPair[iScore].m_sumGradients));
-               *pUpdateScore = static_cast<FloatScore>(updateScore);
-               ++pUpdateScore;
-            }
-            pCollapsedBin2 = IndexBin(pCollapsedBin2, cBytesPerBin);
-         } while(pCollapsedBinEnd != pCollapsedBin2);
-      } else {
-         bool bSucceed = true;
-         bool bFirst = true;
+      const bool bUpdateWithHessian = bHessian && !(TermBoostFlags_DisableNewtonUpdate & flags);
+      if(!bCollapse) {
+         if(TermBoostFlags_GradientSums & flags) {
+            do {
+               auto* const pGradientPair = pCollapsedBin2->GetGradientPairs();
 
-         const bool bUpdateWithHessian = bHessian && !(TermBoostFlags_DisableNewtonUpdate & flags);
-         do {
-            auto* const pGradientPair = pCollapsedBin2->GetGradientPairs();
-            for(size_t iScore = 0; iScore < cScores; ++iScore) {
-               FloatCalc updateScore;
-               if(bUpdateWithHessian) {
-                  updateScore = -CalcNegUpdate<true>(static_cast<FloatCalc>(pGradientPair[iScore].m_sumGradients),
-                        static_cast<FloatCalc>(pGradientPair[iScore].GetHess()),
-                        regAlpha,
-                        regLambda,
-                        deltaStepMax);
-               } else {
-                  updateScore = -CalcNegUpdate<true>(static_cast<FloatCalc>(pGradientPair[iScore].m_sumGradients),
-                        static_cast<FloatCalc>(pCollapsedBin2->GetWeight()),
-                        regAlpha,
-                        regLambda,
-                        deltaStepMax);
+               for(size_t iScore = 0; iScore < cScores; ++iScore) {
+                  const FloatCalc updateScore =
+                        CalcGradientUpdate(static_cast<FloatCalc>(pGradientPair[iScore].m_sumGradients));
+                  *pUpdateScore = static_cast<FloatScore>(updateScore);
+                  ++pUpdateScore;
                }
-               if(MONOTONE_NONE != monotoneDirection) {
-                  EBM_ASSERT(1 == pTerm->GetCountRealDimensions());
-                  if(!bFirst) {
-                     const FloatCalc updatePrev = static_cast<FloatCalc>(*(pUpdateScore - cScores));
-                     if(MonotoneDirection{0} < monotoneDirection) {
-                        if(updateScore < updatePrev) {
-                           bSucceed = false;
-                           break;
-                        }
-                     } else {
-                        EBM_ASSERT(monotoneDirection < MonotoneDirection{0});
-                        if(updatePrev < updateScore) {
-                           bSucceed = false;
-                           break;
+               pCollapsedBin2 = IndexBin(pCollapsedBin2, cBytesPerBin);
+            } while(pCollapsedBinEnd != pCollapsedBin2);
+         } else {
+            bool bFirst = true;
+            do {
+               auto* const pGradientPair = pCollapsedBin2->GetGradientPairs();
+               for(size_t iScore = 0; iScore < cScores; ++iScore) {
+                  FloatCalc updateScore;
+                  if(bUpdateWithHessian) {
+                     updateScore = -CalcNegUpdate<true>(static_cast<FloatCalc>(pGradientPair[iScore].m_sumGradients),
+                           static_cast<FloatCalc>(pGradientPair[iScore].GetHess()),
+                           regAlpha,
+                           regLambda,
+                           deltaStepMax);
+                  } else {
+                     updateScore = -CalcNegUpdate<true>(static_cast<FloatCalc>(pGradientPair[iScore].m_sumGradients),
+                           static_cast<FloatCalc>(pCollapsedBin2->GetWeight()),
+                           regAlpha,
+                           regLambda,
+                           deltaStepMax);
+                  }
+                  if(MONOTONE_NONE != monotoneDirection) {
+                     EBM_ASSERT(1 == pTerm->GetCountRealDimensions());
+                     if(!bFirst) {
+                        const FloatCalc updatePrev = static_cast<FloatCalc>(*(pUpdateScore - cScores));
+                        if(MonotoneDirection{0} < monotoneDirection) {
+                           if(updateScore < updatePrev) {
+                              bCollapse = true;
+                              break;
+                           }
+                        } else {
+                           EBM_ASSERT(monotoneDirection < MonotoneDirection{0});
+                           if(updatePrev < updateScore) {
+                              bCollapse = true;
+                              break;
+                           }
                         }
                      }
                   }
+                  *pUpdateScore = static_cast<FloatScore>(updateScore);
+                  ++pUpdateScore;
                }
-               *pUpdateScore = static_cast<FloatScore>(updateScore);
-               ++pUpdateScore;
-            }
-            bFirst = false;
-            pCollapsedBin2 = IndexBin(pCollapsedBin2, cBytesPerBin);
-         } while(pCollapsedBinEnd != pCollapsedBin2);
+               bFirst = false;
+               pCollapsedBin2 = IndexBin(pCollapsedBin2, cBytesPerBin);
+            } while(pCollapsedBinEnd != pCollapsedBin2);
+         }
+      }
 
-         if(!bSucceed) {
-            // we failed a requirement, so we need to collapse all bins into one with no splits
-            gain = 0;
+      if(bCollapse) {
+         // we failed a requirement, so we need to collapse all bins into one with no splits
+         gain = 0;
 
-            size_t cRealDimensions = pTerm->GetCountRealDimensions();
-            for(size_t iDimension = 0; iDimension < cRealDimensions; ++iDimension) {
+         const size_t cDimensions = pTerm->GetCountDimensions();
+         for(size_t iDimension = 0; iDimension < cDimensions; ++iDimension) {
 #ifndef NDEBUG
-               const ErrorEbm errorDebug =
+            const ErrorEbm errorDebug =
 #endif // NDEBUG
-                     pInnerTermUpdate->SetCountSlices(iDimension, 1);
-               // we can't fail since we're setting this to zero, so no allocations.  We don't in fact need the split
-               // array at all
-               EBM_ASSERT(Error_None == errorDebug);
-            }
+                  pInnerTermUpdate->SetCountSlices(iDimension, 1);
+            // we can't fail since we're setting this to zero, so no allocations.  We don't in fact need the split
+            // array at all
+            EBM_ASSERT(Error_None == errorDebug);
+         }
 
-            // combine all histogram bins into the 0th bin
-            auto* pCollapsedBin3 = aCollapsedBins;
-            goto skip_first; // do not need to add the first bin to itself
-            do {
-               aCollapsedBins->Add(cScores, *pCollapsedBin3);
-            skip_first:
-               pCollapsedBin3 = IndexBin(pCollapsedBin3, cBytesPerBin);
-            } while(pCollapsedBinEnd != pCollapsedBin3);
-
-            pUpdateScore = pInnerTermUpdate->GetTensorScoresPointer();
-            // handle the single bin that we collapsed everything into
-            auto* const pGradientPair = aCollapsedBins->GetGradientPairs();
-            for(size_t iScore = 0; iScore < cScores; ++iScore) {
-               FloatCalc updateScore;
-               if(bUpdateWithHessian) {
-                  updateScore = -CalcNegUpdate<true>(static_cast<FloatCalc>(pGradientPair[iScore].m_sumGradients),
-                        static_cast<FloatCalc>(pGradientPair[iScore].GetHess()),
-                        regAlpha,
-                        regLambda,
-                        deltaStepMax);
-               } else {
-                  updateScore = -CalcNegUpdate<true>(static_cast<FloatCalc>(pGradientPair[iScore].m_sumGradients),
-                        static_cast<FloatCalc>(aCollapsedBins->GetWeight()),
-                        regAlpha,
-                        regLambda,
-                        deltaStepMax);
-               }
-               *pUpdateScore = static_cast<FloatScore>(updateScore);
-               ++pUpdateScore;
+         // combine all histogram bins into the 0th bin
+         auto* pCollapsedBin3 = aCollapsedBins;
+         goto skip_first; // do not need to add the first bin to itself
+         do {
+            aCollapsedBins->Add(cScores, *pCollapsedBin3);
+         skip_first:
+            pCollapsedBin3 = IndexBin(pCollapsedBin3, cBytesPerBin);
+         } while(pCollapsedBinEnd != pCollapsedBin3);
+
+         pUpdateScore = pInnerTermUpdate->GetTensorScoresPointer();
+         // handle the single bin that we collapsed everything into
+         auto* const pGradientPair = aCollapsedBins->GetGradientPairs();
+         for(size_t iScore = 0; iScore < cScores; ++iScore) {
+            FloatCalc updateScore;
+            if(TermBoostFlags_GradientSums & flags) {
+               updateScore = CalcGradientUpdate(static_cast<FloatCalc>(pGradientPair[iScore].m_sumGradients));
+            } else if(bUpdateWithHessian) {
+               updateScore = -CalcNegUpdate<true>(static_cast<FloatCalc>(pGradientPair[iScore].m_sumGradients),
+                     static_cast<FloatCalc>(pGradientPair[iScore].GetHess()),
+                     regAlpha,
+                     regLambda,
+                     deltaStepMax);
+            } else {
+               updateScore = -CalcNegUpdate<true>(static_cast<FloatCalc>(pGradientPair[iScore].m_sumGradients),
+                     static_cast<FloatCalc>(aCollapsedBins->GetWeight()),
+                     regAlpha,
+                     regLambda,
+                     deltaStepMax);
             }
+            *pUpdateScore = static_cast<FloatScore>(updateScore);
+            ++pUpdateScore;
          }
       }
 
@@ -655,6 +780,8 @@ template<bool bHessian, size_t cPossibleScores> class PartitionRandomBoostingTar
          const FloatCalc regAlpha,
          const FloatCalc regLambda,
          const FloatCalc deltaStepMax,
+         const size_t cSamplesLeafMin,
+         const size_t cRandomRetries,
          const IntEbm* const aLeavesMax,
          const MonotoneDirection monotoneDirection,
          double* const pTotalGain) {
@@ -667,6 +794,8 @@ template<bool bHessian, size_t cPossibleScores> class PartitionRandomBoostingTar
                regAlpha,
                regLambda,
                deltaStepMax,
+               cSamplesLeafMin,
+               cRandomRetries,
                aLeavesMax,
                monotoneDirection,
                pTotalGain);
@@ -678,6 +807,8 @@ template<bool bHessian, size_t cPossibleScores> class PartitionRandomBoostingTar
                regAlpha,
                regLambda,
                deltaStepMax,
+               cSamplesLeafMin,
+               cRandomRetries,
                aLeavesMax,
                monotoneDirection,
                pTotalGain);
@@ -696,6 +827,8 @@ template<bool bHessian> class PartitionRandomBoostingTarget<bHessian, k_cCompile
          const FloatCalc regAlpha,
          const FloatCalc regLambda,
          const FloatCalc deltaStepMax,
+         const size_t cSamplesLeafMin,
+         const size_t cRandomRetries,
          const IntEbm* const aLeavesMax,
          const MonotoneDirection monotoneDirection,
          double* const pTotalGain) {
@@ -706,6 +839,8 @@ template<bool bHessian> class PartitionRandomBoostingTarget<bHessian, k_cCompile
             regAlpha,
             regLambda,
             deltaStepMax,
+            cSamplesLeafMin,
+            cRandomRetries,
             aLeavesMax,
             monotoneDirection,
             pTotalGain);
@@ -719,6 +854,8 @@ extern ErrorEbm PartitionRandomBoosting(RandomDeterministic* const pRng,
       const FloatCalc regAlpha,
       const FloatCalc regLambda,
       const FloatCalc deltaStepMax,
+      const size_t cSamplesLeafMin,
+      const size_t cRandomRetries,
       const IntEbm* const aLeavesMax,
       const MonotoneDirection monotoneDirection,
       double* const pTotalGain) {
@@ -736,6 +873,8 @@ extern ErrorEbm PartitionRandomBoosting(RandomDeterministic* const pRng,
                regAlpha,
                regLambda,
                deltaStepMax,
+               cSamplesLeafMin,
+               cRandomRetries,
                aLeavesMax,
                monotoneDirection,
                pTotalGain);
@@ -747,6 +886,8 @@ extern ErrorEbm PartitionRandomBoosting(RandomDeterministic* const pRng,
                regAlpha,
                regLambda,
                deltaStepMax,
+               cSamplesLeafMin,
+               cRandomRetries,
                aLeavesMax,
                monotoneDirection,
                pTotalGain);
@@ -761,6 +902,8 @@ extern ErrorEbm PartitionRandomBoosting(RandomDeterministic* const pRng,
                regAlpha,
                regLambda,
                deltaStepMax,
+               cSamplesLeafMin,
+               cRandomRetries,
                aLeavesMax,
                monotoneDirection,
                pTotalGain);
@@ -772,6 +915,8 @@ extern ErrorEbm PartitionRandomBoosting(RandomDeterministic* const pRng,
                regAlpha,
                regLambda,
                deltaStepMax,
+               cSamplesLeafMin,
+               cRandomRetries,
                aLeavesMax,
                monotoneDirection,
                pTotalGain);
@@ -214,22 +214,25 @@ bool Tensor::MultiplyAndCheckForIssues(const double v) {
       cTensorScores *= pThisDimensionInfo[iDimension].m_cSlices;
    }
 
+   static_assert(sizeof(FloatScore) == sizeof(uint64_t), "the non-finite bit test below assumes 64 bit scores");
+   // NaN and +-infinity are the only values with all exponent bits set, so we can detect both with a single
+   // mask and compare. This avoids std::isnan/std::isinf, which some compilers optimize away under fast-math, and it
+   // keeps the loop free of branches so that the compiler can vectorize it
+   static constexpr uint64_t k_exponentMask = uint64_t{0x7FF0000000000000};
+
    FloatScore* pCur = &m_aTensorScores[0];
    FloatScore* pEnd = &m_aTensorScores[cTensorScores];
-   int bBad = 0;
+   uint64_t bBad = 0;
    // we always have 1 score, even if we have zero splits
    do {
       const FloatScore val = *pCur * vFloat;
-      // TODO: these can be done with bitwise operators, which would be good for SIMD.  Check to see what assembly this
-      // turns into. since both NaN and +-infinity have the exponential as FF, and no other values do, the best
-      // optimized assembly would test the exponential bits for FF and then OR a 1 if the test is true and 0 if the test
-      // is false
-      // TODO: another issue is that isnan and isinf don't work on some compilers with some compiler settings
-      bBad |= std::isnan(val) || std::isinf(val);
+      uint64_t bits;
+      memcpy(&bits, &val, sizeof(bits));
+      bBad |= static_cast<uint64_t>(k_exponentMask == (k_exponentMask & bits));
       *pCur = val;
       ++pCur;
    } while(pEnd != pCur);
-   return !!bBad;
+   return 0 != bBad;
 }
 
 ErrorEbm Tensor::Expand(const Term* const pTerm) {
@@ -248,6 +251,25 @@ ErrorEbm Tensor::Expand(const Term* const pTerm) {
    if(size_t{0} != cDimensions) {
       const TermFeature* pTermFeature1 = pTerm->GetTermFeatures();
       const TermFeature* const pTermFeaturesEnd = &pTermFeature1[cDimensions];
+
+      // splits are unique and ordered within [1, cBins - 1], so a dimension that already has cBins slices is
+      // already split at every bin boundary.  Fully split tensors are common after full or deep pair boosting, and
+      // for them the cell layout is already the expanded layout, so we only need to flip the flag
+      const DimensionInfo* pDimensionCheck = GetDimensions();
+      const TermFeature* pTermFeatureCheck = pTermFeature1;
+      do {
+         if(pTermFeatureCheck->m_pFeature->GetCountBins() != pDimensionCheck->m_cSlices) {
+            break;
+         }
+         ++pDimensionCheck;
+         ++pTermFeatureCheck;
+      } while(pTermFeaturesEnd != pTermFeatureCheck);
+      if(pTermFeaturesEnd == pTermFeatureCheck) {
+         m_bExpanded = true;
+         LOG_0(Trace_Verbose, "Exited Expand");
+         return Error_None;
+      }
+
       DimensionInfoStackExpand aDimensionInfoStackExpand[k_cDimensionsMax];
       DimensionInfoStackExpand* pDimensionInfoStackFirst = aDimensionInfoStackExpand;
       const DimensionInfo* pDimensionFirst1 = GetDimensions();
@@ -442,7 +464,10 @@ void Tensor::AddExpandedWithBadValueProtection(const FloatScore* const aFromScor
       // soon but we want to preserve the best term scores that we had
 
       FloatScore score = *pFromScore;
-      score = std::isnan(score) ? FloatScore{0} : score;
+      uint64_t bits;
+      memcpy(&bits, &score, sizeof(bits));
+      // NaN is the only value whose magnitude bits compare above the bit pattern of +infinity
+      score = uint64_t{0x7FF0000000000000} < (uint64_t{0x7FFFFFFFFFFFFFFF} & bits) ? FloatScore{0} : score;
       score = *pToScore + score;
       // this is a check for -infinity, without the -infinity value since some compilers make that illegal
       // even so far as to make isinf always FALSE with some compiler flags
@@ -481,13 +506,39 @@ ErrorEbm Tensor::Add(const Tensor& rhs) {
       return Error_None;
    }
 
-   if(m_bExpanded) {
-      // TODO: the existing code below works, but handle this differently (we can do it more efficiently)
-   }
+   // If both tensors are sliced identically, which is always the case when both are expanded and is common when
+   // the inner bags of a pair all pick the same cuts, then the cells line up and we can add them directly without
+   // merging the splits.  The flat loop has no data dependent control flow, so it vectorizes.
+   const DimensionInfo* pDimensionSame1 = GetDimensions();
+   const DimensionInfo* pDimensionSame2 = rhs.GetDimensions();
+   const DimensionInfo* const pDimensionSame1End = &pDimensionSame1[m_cDimensions];
+   size_t cSameTensorScores = m_cScores;
+   do {
+      const size_t cSlices = pDimensionSame1->m_cSlices;
+      if(cSlices != pDimensionSame2->m_cSlices) {
+         break;
+      }
+      if(size_t{1} < cSlices &&
+            0 != memcmp(pDimensionSame1->m_aSplits, pDimensionSame2->m_aSplits, sizeof(UIntSplit) * (cSlices - 1))) {
+         break;
+      }
+      cSameTensorScores *= cSlices; // this can't overflow since we're counting existing allocated memory
+      ++pDimensionSame1;
+      ++pDimensionSame2;
+   } while(pDimensionSame1End != pDimensionSame1);
+   if(pDimensionSame1End == pDimensionSame1) {
+      FloatScore* pTo = &m_aTensorScores[0];
+      const FloatScore* pFrom = &rhs.m_aTensorScores[0];
+      const FloatScore* const pToEnd = &pTo[cSameTensorScores];
+      do {
+         *pTo += *pFrom;
+         ++pTo;
+         ++pFrom;
+      } while(pToEnd != pTo);
 
-   if(rhs.m_bExpanded) {
-      // TODO: the existing code below works, but handle this differently (we can do it more efficiently)
+      return Error_None;
    }
+   EBM_ASSERT(!m_bExpanded || !rhs.m_bExpanded);
 
    const DimensionInfo* pDimensionFirst1 = GetDimensions();
    const DimensionInfo* pDimensionFirst2 = rhs.GetDimensions();
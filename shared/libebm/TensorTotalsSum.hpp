@@ -24,6 +24,13 @@ struct TensorSumDimension {
    size_t m_cBins;
 };
 
+// The monotone constraint on one dimension of a multi-dimensional term.  When the feature has missing values they
+// are in bin 0, which has no order relative to the other bins, so only bins from m_iBinOrdered onwards are constrained.
+struct MonotoneDimension {
+   MonotoneDirection m_direction;
+   size_t m_iBinOrdered;
+};
+
 #ifndef NDEBUG
 #ifdef CHECK_TENSORS
 
@@ -0,0 +1,1057 @@
+// Copyright (c) 2023 The InterpretML Contributors
+// Licensed under the MIT license.
+// Author: Paul Koch <code@koch.ninja>
+
+#include "pch.hpp"
+
+#include <stdlib.h> // malloc, realloc, free
+#include <stddef.h> // size_t, ptrdiff_t
+#include <stdio.h> // FILE, fopen, fwrite, fread, fclose
+#include <string.h> // memcpy, memset, memcmp, strlen
+#include <stdint.h> // uint32_t, uint64_t, uintptr_t
+#include <type_traits> // is_standard_layout, is_trivial
+#include <atomic>
+#include <mutex>
+#include <chrono>
+
+#include "libebm.h"
+#include "logging.h" // EBM_ASSERT
+#include "unzoned.h"
+
+#define ZONE_main
+#include "zones.h"
+
+#include "ebm_internal.hpp"
+#include "RandomDeterministic.hpp" // RandomDeterministic
+#include "Feature.hpp" // FeatureBoosting
+#include "Term.hpp" // Term
+#include "BoosterCore.hpp" // BoosterCore
+#include "BoosterShell.hpp" // BoosterShell
+#include "dataset_shared.hpp" // GetDataSetSharedSize
+#include "api_recording.hpp"
+
+namespace DEFINED_ZONE_NAME {
+#ifndef DEFINED_ZONE_NAME
+#error DEFINED_ZONE_NAME must be defined
+#endif // DEFINED_ZONE_NAME
+
+static_assert(sizeof(RandomDeterministic) == k_cBytesRecordedRng, "k_cBytesRecordedRng must match the RNG size");
+
+// The recording is a magic number followed by a sequence of records.  Each record starts with a RecordedCall id.
+// Integers are stored as 64 bits, and arrays as a 64 bit item count followed by the raw items, with a count of
+// k_nullArray standing for nullptr.  Handles are stored as the pointer values seen while recording and are only used
+// to link the calls together.  Everything is in native byte order.
+static constexpr char k_recordingMagic[8] = {'E', 'B', 'M', 'R', 'E', 'C', '0', '2'};
+static constexpr uint64_t k_nullArray = ~uint64_t{0};
+
+enum RecordedCall : uint32_t {
+   RecordedCall_DataSet = 1,
+   RecordedCall_CreateBooster = 2,
+   RecordedCall_CreateBoosterView = 3,
+   RecordedCall_FreeBooster = 4,
+   RecordedCall_GenerateTermUpdate = 5,
+   RecordedCall_SetTermUpdate = 6,
+   RecordedCall_ApplyTermUpdate = 7,
+   RecordedCall_CreateInteractionDetector = 8,
+   RecordedCall_FreeInteractionDetector = 9,
+   RecordedCall_CalcInteractionStrength = 10,
+   RecordedCall_CalcInteractionStrengths = 11,
+   RecordedCall_DeserializeBooster = 12,
+};
+
+struct RecordedDataSet {
+   const void* m_pDataSet;
+   size_t m_cBytes;
+   uint64_t m_hash;
+};
+static_assert(std::is_standard_layout<RecordedDataSet>::value,
+      "We use the struct hack in several places, so disallow non-standard_layout types in general");
+static_assert(std::is_trivial<RecordedDataSet>::value,
+      "We use memcpy in several places, so disallow non-trivial types in general");
+
+// g_bRecording lets the API functions skip the recorder with a single relaxed load.  Everything else is guarded by
+// g_recordingMutex, which also serializes the records written by different threads.
+static std::atomic<bool> g_bRecording{false};
+static std::mutex g_recordingMutex;
+static FILE* g_pRecordingFile = nullptr;
+static RecordedDataSet* g_aRecordedDataSets = nullptr;
+static size_t g_cRecordedDataSets = 0;
+
+extern bool IsRecording() { return g_bRecording.load(std::memory_order_relaxed); }
+
+extern void SaveRecordedRng(const void* const rng, unsigned char* const aRngOut) {
+   EBM_ASSERT(nullptr != aRngOut);
+   if(nullptr != rng) {
+      memcpy(aRngOut, rng, k_cBytesRecordedRng);
+   }
+}
+
+static void CloseRecording() {
+   // the caller must hold g_recordingMutex
+   g_bRecording.store(false, std::memory_order_relaxed);
+   if(nullptr != g_pRecordingFile) {
+      fclose(g_pRecordingFile);
+      g_pRecordingFile = nullptr;
+   }
+   free(g_aRecordedDataSets);
+   g_aRecordedDataSets = nullptr;
+   g_cRecordedDataSets = 0;
+}
+
+static void WriteBytes(const void* const p, const size_t cBytes) {
+   if(nullptr != g_pRecordingFile && size_t{0} != cBytes) {
+      if(cBytes != fwrite(p, 1, cBytes, g_pRecordingFile)) {
+         // a truncated recording is useless, so stop recording instead of writing more
+         LOG_0(Trace_Warning, "WARNING WriteBytes could not write to the recording, so recording was stopped");
+         CloseRecording();
+      }
+   }
+}
+
+static void WriteU64(const uint64_t val) { WriteBytes(&val, sizeof(val)); }
+static void WriteInt(const IntEbm val) { WriteU64(static_cast<uint64_t>(val)); }
+static void WriteDouble(const double val) { WriteBytes(&val, sizeof(val)); }
+static void WriteHandle(const void* const handle) {
+   WriteU64(static_cast<uint64_t>(reinterpret_cast<uintptr_t>(handle)));
+}
+
+static void WriteArray(const void* const a, const size_t cItems, const size_t cBytesPerItem) {
+   if(nullptr == a) {
+      WriteU64(k_nullArray);
+   } else {
+      WriteU64(static_cast<uint64_t>(cItems));
+      WriteBytes(a, cItems * cBytesPerItem);
+   }
+}
+
+static void WriteString(const char* const s) { WriteArray(s, nullptr == s ? size_t{0} : strlen(s), sizeof(*s)); }
+
+static void WriteRecordedCall(const RecordedCall call) {
+   const uint32_t id = static_cast<uint32_t>(call);
+   WriteBytes(&id, sizeof(id));
+}
+
+static uint64_t HashBytes(const unsigned char* const a, const size_t cBytes) {
+   // FNV-1a is plenty to tell apart datasets that happen to reuse the same memory
+   uint64_t hash = 14695981039346656037u;
+   for(size_t i = 0; i < cBytes; ++i) {
+      hash ^= static_cast<uint64_t>(a[i]);
+      hash *= 1099511628211u;
+   }
+   return hash;
+}
+
+static bool WriteDataSet(const void* const dataSet, uint64_t* const piDataSetOut) {
+   // the caller must hold g_recordingMutex.  Each distinct dataset is written once and then referenced by index.
+   size_t cBytes;
+   if(Error_None != GetDataSetSharedSize(static_cast<const unsigned char*>(dataSet), &cBytes)) {
+      LOG_0(Trace_Warning, "WARNING WriteDataSet the dataset is not valid, so the call was not recorded");
+      return false;
+   }
+   const uint64_t hash = HashBytes(static_cast<const unsigned char*>(dataSet), cBytes);
+   for(size_t iDataSet = 0; iDataSet < g_cRecordedDataSets; ++iDataSet) {
+      const RecordedDataSet* const pRecorded = &g_aRecordedDataSets[iDataSet];
+      if(dataSet == pRecorded->m_pDataSet && cBytes == pRecorded->m_cBytes && hash == pRecorded->m_hash) {
+         *piDataSetOut = static_cast<uint64_t>(iDataSet);
+         return true;
+      }
+   }
+
+   RecordedDataSet* const aRecordedDataSets = static_cast<RecordedDataSet*>(
+         realloc(g_aRecordedDataSets, sizeof(RecordedDataSet) * (g_cRecordedDataSets + size_t{1})));
+   if(nullptr == aRecordedDataSets) {
+      LOG_0(Trace_Warning, "WARNING WriteDataSet out of memory, so recording was stopped");
+      CloseRecording();
+      return false;
+   }
+   g_aRecordedDataSets = aRecordedDataSets;
+   RecordedDataSet* const pRecorded = &aRecordedDataSets[g_cRecordedDataSets];
+   pRecorded->m_pDataSet = dataSet;
+   pRecorded->m_cBytes = cBytes;
+   pRecorded->m_hash = hash;
+   *piDataSetOut = static_cast<uint64_t>(g_cRecordedDataSets);
+   ++g_cRecordedDataSets;
+
+   WriteRecordedCall(RecordedCall_DataSet);
+   WriteU64(*piDataSetOut);
+   WriteArray(dataSet, cBytes, 1);
+   return nullptr != g_pRecordingFile;
+}
+
+static bool GetBagCounts(const void* const dataSet, const BagEbm* const bag, size_t* const pcSamplesOut,
+      size_t* const pcIncludedOut) {
+   UIntShared countSamples;
+   size_t cFeaturesUnused;
+   size_t cWeightsUnused;
+   size_t cTargetsUnused;
+   if(Error_None !=
+         GetDataSetSharedHeader(static_cast<const unsigned char*>(dataSet),
+               &countSamples,
+               &cFeaturesUnused,
+               &cWeightsUnused,
+               &cTargetsUnused)) {
+      return false;
+   }
+   if(IsConvertError<size_t>(countSamples)) {
+      return false;
+   }
+   const size_t cSamples = static_cast<size_t>(countSamples);
+   size_t cIncluded = cSamples;
+   if(nullptr != bag) {
+      cIncluded = 0;
+      for(size_t iSample = 0; iSample < cSamples; ++iSample) {
+         if(BagEbm{0} != bag[iSample]) {
+            ++cIncluded;
+         }
+      }
+   }
+   *pcSamplesOut = cSamples;
+   *pcIncludedOut = cIncluded;
+   return true;
+}
+
+static size_t CountTermFeatures(const IntEbm countTerms, const IntEbm* const dimensionCounts) {
+   // the API function validates these after we record them, so only sum the legal ones here
+   size_t cTermFeatures = 0;
+   if(nullptr != dimensionCounts) {
+      for(IntEbm iTerm = 0; iTerm < countTerms; ++iTerm) {
+         const IntEbm countDimensions = dimensionCounts[iTerm];
+         if(IntEbm{0} < countDimensions && !IsConvertError<size_t>(countDimensions)) {
+            cTermFeatures += static_cast<size_t>(countDimensions);
+         }
+      }
+   }
+   return cTermFeatures;
+}
+
+extern void RecordCreateBooster(const unsigned char* const aRngBefore,
+      const void* const dataSet,
+      const double* const intercept,
+      const BagEbm* const bag,
+      const double* const initScores,
+      const IntEbm countTerms,
+      const IntEbm* const dimensionCounts,
+      const IntEbm* const featureIndexes,
+      const IntEbm countInnerBags,
+      const CreateBoosterFlags flags,
+      const AccelerationFlags acceleration,
+      const char* const objective,
+      const size_t cScores,
+      const BoosterHandle boosterHandle) {
+   const std::lock_guard<std::mutex> lock(g_recordingMutex);
+   if(nullptr == g_pRecordingFile) {
+      return;
+   }
+   size_t cSamples;
+   size_t cIncluded;
+   if(!GetBagCounts(dataSet, bag, &cSamples, &cIncluded)) {
+      return;
+   }
+   uint64_t iDataSet;
+   if(!WriteDataSet(dataSet, &iDataSet)) {
+      return;
+   }
+   WriteRecordedCall(RecordedCall_CreateBooster);
+   WriteArray(aRngBefore, k_cBytesRecordedRng, 1);
+   WriteU64(iDataSet);
+   WriteArray(size_t{0} == cScores ? nullptr : intercept, cScores, sizeof(*intercept));
+   WriteArray(bag, cSamples, sizeof(*bag));
+   WriteArray(size_t{0} == cScores ? nullptr : initScores, cIncluded * cScores, sizeof(*initScores));
+   WriteInt(countTerms);
+   WriteArray(dimensionCounts, static_cast<size_t>(countTerms), sizeof(*dimensionCounts));
+   WriteArray(featureIndexes, CountTermFeatures(countTerms, dimensionCounts), sizeof(*featureIndexes));
+   WriteInt(countInnerBags);
+   WriteInt(static_cast<IntEbm>(flags));
+   WriteInt(static_cast<IntEbm>(acceleration));
+   WriteString(objective);
+   WriteHandle(boosterHandle);
+}
+
+extern void RecordCreateBoosterView(const BoosterHandle boosterHandle, const BoosterHandle boosterHandleView) {
+   const std::lock_guard<std::mutex> lock(g_recordingMutex);
+   WriteRecordedCall(RecordedCall_CreateBoosterView);
+   WriteHandle(boosterHandle);
+   WriteHandle(boosterHandleView);
+}
+
+extern void RecordFreeBooster(const BoosterHandle boosterHandle) {
+   const std::lock_guard<std::mutex> lock(g_recordingMutex);
+   WriteRecordedCall(RecordedCall_FreeBooster);
+   WriteHandle(boosterHandle);
+}
+
+static size_t CountRecordedTermDimensions(BoosterShell* const pBoosterShell, const IntEbm indexTerm) {
+   const BoosterCore* const pBoosterCore = pBoosterShell->GetBoosterCore();
+   if(indexTerm < IntEbm{0} || static_cast<IntEbm>(pBoosterCore->GetCountTerms()) <= indexTerm) {
+      return 0;
+   }
+   return pBoosterCore->GetTerms()[static_cast<size_t>(indexTerm)]->GetCountDimensions();
+}
+
+extern void RecordGenerateTermUpdate(const unsigned char* const aRngBefore,
+      BoosterShell* const pBoosterShell,
+      const IntEbm indexTerm,
+      const TermBoostFlags flags,
+      const double learningRate,
+      const IntEbm minSamplesLeaf,
+      const double minHessian,
+      const double regAlpha,
+      const double regLambda,
+      const double maxDeltaStep,
+      const IntEbm minCategorySamples,
+      const double categoricalSmoothing,
+      const IntEbm maxCategoricalThreshold,
+      const double categoricalInclusionPercent,
+      const IntEbm randomRetries,
+      const IntEbm* const leavesMax,
+      const MonotoneDirection* const direction) {
+   EBM_ASSERT(nullptr != pBoosterShell);
+   const size_t cDimensions = CountRecordedTermDimensions(pBoosterShell, indexTerm);
+
+   const std::lock_guard<std::mutex> lock(g_recordingMutex);
+   WriteRecordedCall(RecordedCall_GenerateTermUpdate);
+   WriteArray(aRngBefore, k_cBytesRecordedRng, 1);
+   WriteHandle(pBoosterShell->GetHandle());
+   WriteInt(indexTerm);
+   WriteInt(static_cast<IntEbm>(flags));
+   WriteDouble(learningRate);
+   WriteInt(minSamplesLeaf);
+   WriteDouble(minHessian);
+   WriteDouble(regAlpha);
+   WriteDouble(regLambda);
+   WriteDouble(maxDeltaStep);
+   WriteInt(minCategorySamples);
+   WriteDouble(categoricalSmoothing);
+   WriteInt(maxCategoricalThreshold);
+   WriteDouble(categoricalInclusionPercent);
+   WriteInt(randomRetries);
+   WriteArray(leavesMax, cDimensions, sizeof(*leavesMax));
+   WriteArray(direction, cDimensions, sizeof(*direction));
+}
+
+extern void RecordSetTermUpdate(
+      BoosterShell* const pBoosterShell, const IntEbm indexTerm, const double* const updateScoresTensor) {
+   EBM_ASSERT(nullptr != pBoosterShell);
+   const BoosterCore* const pBoosterCore = pBoosterShell->GetBoosterCore();
+   size_t cTensorScores = pBoosterCore->GetCountScores();
+   if(IntEbm{0} <= indexTerm && indexTerm < static_cast<IntEbm>(pBoosterCore->GetCountTerms())) {
+      const Term* const pTerm = pBoosterCore->GetTerms()[static_cast<size_t>(indexTerm)];
+      if(size_t{0} == pTerm->GetCountTensorBins()) {
+         cTensorScores = 0;
+      } else {
+         // the caller's tensor includes the missing and unseen bins that the booster drops internally
+         const TermFeature* pTermFeature = pTerm->GetTermFeatures();
+         const TermFeature* const pTermFeaturesEnd = pTermFeature + pTerm->GetCountDimensions();
+         for(; pTermFeaturesEnd != pTermFeature; ++pTermFeature) {
+            const FeatureBoosting* const pFeature = pTermFeature->m_pFeature;
+            cTensorScores *= pFeature->GetCountBins() + (pFeature->IsMissing() ? size_t{0} : size_t{1}) +
+                  (pFeature->IsUnseen() ? size_t{0} : size_t{1});
+         }
+      }
+   }
+
+   const std::lock_guard<std::mutex> lock(g_recordingMutex);
+   WriteRecordedCall(RecordedCall_SetTermUpdate);
+   WriteHandle(pBoosterShell->GetHandle());
+   WriteInt(indexTerm);
+   WriteArray(size_t{0} == cTensorScores ? nullptr : updateScoresTensor, cTensorScores, sizeof(*updateScoresTensor));
+}
+
+extern void RecordApplyTermUpdate(const BoosterHandle boosterHandle) {
+   const std::lock_guard<std::mutex> lock(g_recordingMutex);
+   WriteRecordedCall(RecordedCall_ApplyTermUpdate);
+   WriteHandle(boosterHandle);
+}
+
+extern void RecordDeserializeBooster(
+      const BoosterHandle boosterHandle, const IntEbm countBytes, const void* const state, const void* const rngOut) {
+   const std::lock_guard<std::mutex> lock(g_recordingMutex);
+   WriteRecordedCall(RecordedCall_DeserializeBooster);
+   WriteHandle(boosterHandle);
+   WriteInt(countBytes);
+   // DeserializeBooster checks that countBytes fits in a size_t before recording
+   WriteArray(state, static_cast<size_t>(countBytes), 1);
+   // the rng that the state restores is replaced by the recorded rng of the next call that uses it
+   WriteU64(nullptr == rngOut ? uint64_t{0} : uint64_t{1});
+}
+
+extern void RecordCreateInteractionDetector(const void* const dataSet,
+      const double* const intercept,
+      const BagEbm* const bag,
+      const double* const initScores,
+      const CreateInteractionFlags flags,
+      const AccelerationFlags acceleration,
+      const char* const objective,
+      const size_t cScores,
+      const InteractionHandle interactionHandle) {
+   const std::lock_guard<std::mutex> lock(g_recordingMutex);
+   if(nullptr == g_pRecordingFile) {
+      return;
+   }
+   size_t cSamples;
+   size_t cIncluded;
+   if(!GetBagCounts(dataSet, bag, &cSamples, &cIncluded)) {
+      return;
+   }
+   uint64_t iDataSet;
+   if(!WriteDataSet(dataSet, &iDataSet)) {
+      return;
+   }
+   WriteRecordedCall(RecordedCall_CreateInteractionDetector);
+   WriteU64(iDataSet);
+   WriteArray(size_t{0} == cScores ? nullptr : intercept, cScores, sizeof(*intercept));
+   WriteArray(bag, cSamples, sizeof(*bag));
+   WriteArray(size_t{0} == cScores ? nullptr : initScores, cIncluded * cScores, sizeof(*initScores));
+   WriteInt(static_cast<IntEbm>(flags));
+   WriteInt(static_cast<IntEbm>(acceleration));
+   WriteString(objective);
+   WriteHandle(interactionHandle);
+}
+
+extern void RecordFreeInteractionDetector(const InteractionHandle interactionHandle) {
+   const std::lock_guard<std::mutex> lock(g_recordingMutex);
+   WriteRecordedCall(RecordedCall_FreeInteractionDetector);
+   WriteHandle(interactionHandle);
+}
+
+extern void RecordCalcInteractionStrength(const InteractionHandle interactionHandle,
+      const IntEbm countDimensions,
+      const IntEbm* const featureIndexes,
+      const CalcInteractionFlags flags,
+      const IntEbm maxCardinality,
+      const IntEbm minSamplesLeaf,
+      const double minHessian,
+      const double regAlpha,
+      const double regLambda,
+      const double maxDeltaStep) {
+   const size_t cDimensions = CountTermFeatures(1, &countDimensions);
+
+   const std::lock_guard<std::mutex> lock(g_recordingMutex);
+   WriteRecordedCall(RecordedCall_CalcInteractionStrength);
+   WriteHandle(interactionHandle);
+   WriteInt(countDimensions);
+   WriteArray(featureIndexes, cDimensions, sizeof(*featureIndexes));
+   WriteInt(static_cast<IntEbm>(flags));
+   WriteInt(maxCardinality);
+   WriteInt(minSamplesLeaf);
+   WriteDouble(minHessian);
+   WriteDouble(regAlpha);
+   WriteDouble(regLambda);
+   WriteDouble(maxDeltaStep);
+}
+
+extern void RecordCalcInteractionStrengths(const InteractionHandle interactionHandle,
+      const IntEbm countTerms,
+      const IntEbm* const dimensionCounts,
+      const IntEbm* const featureIndexes,
+      const CalcInteractionFlags flags,
+      const IntEbm maxCardinality,
+      const IntEbm minSamplesLeaf,
+      const double minHessian,
+      const double regAlpha,
+      const double regLambda,
+      const double maxDeltaStep,
+      const IntEbm countThreads) {
+   const size_t cTerms = countTerms < IntEbm{0} || IsConvertError<size_t>(countTerms) ?
+         size_t{0} :
+         static_cast<size_t>(countTerms);
+   const size_t cTermFeatures = CountTermFeatures(countTerms, dimensionCounts);
+
+   const std::lock_guard<std::mutex> lock(g_recordingMutex);
+   WriteRecordedCall(RecordedCall_CalcInteractionStrengths);
+   WriteHandle(interactionHandle);
+   WriteInt(countTerms);
+   WriteArray(dimensionCounts, cTerms, sizeof(*dimensionCounts));
+   WriteArray(featureIndexes, cTermFeatures, sizeof(*featureIndexes));
+   WriteInt(static_cast<IntEbm>(flags));
+   WriteInt(maxCardinality);
+   WriteInt(minSamplesLeaf);
+   WriteDouble(minHessian);
+   WriteDouble(regAlpha);
+   WriteDouble(regLambda);
+   WriteDouble(maxDeltaStep);
+   WriteInt(countThreads);
+}
+
+EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION StartRecording(const char* filename) {
+   LOG_0(Trace_Info, "Entered StartRecording");
+
+   if(nullptr == filename) {
+      LOG_0(Trace_Error, "ERROR StartRecording nullptr == filename");
+      return Error_IllegalParamVal;
+   }
+
+   const std::lock_guard<std::mutex> lock(g_recordingMutex);
+   if(nullptr != g_pRecordingFile) {
+      LOG_0(Trace_Error, "ERROR StartRecording a recording is already active");
+      return Error_IllegalParamVal;
+   }
+
+   FILE* const pFile = fopen(filename, "wb");
+   if(nullptr == pFile) {
+      LOG_0(Trace_Error, "ERROR StartRecording could not open the recording file");
+      return Error_IllegalParamVal;
+   }
+   g_pRecordingFile = pFile;
+   WriteBytes(k_recordingMagic, sizeof(k_recordingMagic));
+   if(nullptr == g_pRecordingFile) {
+      // already logged
+      return Error_UnexpectedInternal;
+   }
+   g_bRecording.store(true, std::memory_order_relaxed);
+
+   LOG_0(Trace_Info, "Exited StartRecording");
+   return Error_None;
+}
+
+EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION StopRecording(void) {
+   LOG_0(Trace_Info, "Entered StopRecording");
+
+   const std::lock_guard<std::mutex> lock(g_recordingMutex);
+   if(nullptr == g_pRecordingFile) {
+      LOG_0(Trace_Warning, "WARNING StopRecording there is no active recording");
+      return Error_IllegalParamVal;
+   }
+   const bool bFlushed = 0 == fflush(g_pRecordingFile);
+   CloseRecording();
+   if(!bFlushed) {
+      LOG_0(Trace_Warning, "WARNING StopRecording could not flush the recording");
+      return Error_UnexpectedInternal;
+   }
+
+   LOG_0(Trace_Info, "Exited StopRecording");
+   return Error_None;
+}
+
+struct ReplayHandle {
+   uint64_t m_recorded;
+   void* m_handle;
+   bool m_bBooster;
+};
+static_assert(std::is_standard_layout<ReplayHandle>::value,
+      "We use the struct hack in several places, so disallow non-standard_layout types in general");
+static_assert(std::is_trivial<ReplayHandle>::value,
+      "We use memcpy in several places, so disallow non-trivial types in general");
+
+struct ReplayState {
+   FILE* m_pFile;
+   bool m_bCorrupt;
+
+   unsigned char** m_aDataSets;
+   size_t m_cDataSets;
+
+   ReplayHandle* m_aHandles;
+   size_t m_cHandles;
+};
+static_assert(std::is_standard_layout<ReplayState>::value,
+      "We use the struct hack in several places, so disallow non-standard_layout types in general");
+static_assert(std::is_trivial<ReplayState>::value,
+      "We use memcpy in several places, so disallow non-trivial types in general");
+
+static void ReadBytes(ReplayState* const pState, void* const p, const size_t cBytes) {
+   if(pState->m_bCorrupt) {
+      memset(p, 0, cBytes);
+      return;
+   }
+   if(size_t{0} != cBytes && cBytes != fread(p, 1, cBytes, pState->m_pFile)) {
+      LOG_0(Trace_Error, "ERROR ReadBytes the recording is truncated");
+      pState->m_bCorrupt = true;
+      memset(p, 0, cBytes);
+   }
+}
+
+static uint64_t ReadU64(ReplayState* const pState) {
+   uint64_t val;
+   ReadBytes(pState, &val, sizeof(val));
+   return val;
+}
+static IntEbm ReadInt(ReplayState* const pState) { return static_cast<IntEbm>(ReadU64(pState)); }
+static double ReadDouble(ReplayState* const pState) {
+   double val;
+   ReadBytes(pState, &val, sizeof(val));
+   return val;
+}
+
+static void* ReadArray(ReplayState* const pState, const size_t cBytesPerItem) {
+   // returns nullptr for recorded nullptr arrays.  Empty arrays get a small allocation so they stay non-null.
+   const uint64_t cItems = ReadU64(pState);
+   if(k_nullArray == cItems || pState->m_bCorrupt) {
+      return nullptr;
+   }
+   if(IsConvertError<size_t>(cItems) || IsMultiplyError(cBytesPerItem, static_cast<size_t>(cItems))) {
+      LOG_0(Trace_Error, "ERROR ReadArray the recording has an array that is too large");
+      pState->m_bCorrupt = true;
+      return nullptr;
+   }
+   const size_t cBytes = cBytesPerItem * static_cast<size_t>(cItems);
+   // one extra byte terminates strings
+   void* const a = malloc(cBytes + size_t{1});
+   if(nullptr == a) {
+      LOG_0(Trace_Warning, "WARNING ReadArray out of memory");
+      pState->m_bCorrupt = true;
+      return nullptr;
+   }
+   ReadBytes(pState, a, cBytes);
+   static_cast<char*>(a)[cBytes] = '\0';
+   return a;
+}
+
+static void* GetReplayHandle(const ReplayState* const pState, const uint64_t recorded, const bool bBooster) {
+   for(size_t iHandle = 0; iHandle < pState->m_cHandles; ++iHandle) {
+      const ReplayHandle* const pHandle = &pState->m_aHandles[iHandle];
+      if(recorded == pHandle->m_recorded && bBooster == pHandle->m_bBooster) {
+         return pHandle->m_handle;
+      }
+   }
+   // an unknown handle replays as nullptr, which the API functions reject the same way they rejected it originally
+   return nullptr;
+}
+
+static bool AddReplayHandle(
+      ReplayState* const pState, const uint64_t recorded, void* const handle, const bool bBooster) {
+   if(nullptr == handle) {
+      return true;
+   }
+   ReplayHandle* const aHandles =
+         static_cast<ReplayHandle*>(realloc(pState->m_aHandles, sizeof(ReplayHandle) * (pState->m_cHandles + 1)));
+   if(nullptr == aHandles) {
+      LOG_0(Trace_Warning, "WARNING AddReplayHandle out of memory");
+      return false;
+   }
+   pState->m_aHandles = aHandles;
+   aHandles[pState->m_cHandles].m_recorded = recorded;
+   aHandles[pState->m_cHandles].m_handle = handle;
+   aHandles[pState->m_cHandles].m_bBooster = bBooster;
+   ++pState->m_cHandles;
+   return true;
+}
+
+static void RemoveReplayHandle(ReplayState* const pState, const uint64_t recorded, const bool bBooster) {
+   // the most recent handle with this value is the live one since freed memory can be reused for new handles
+   size_t iHandle = pState->m_cHandles;
+   while(size_t{0} != iHandle) {
+      --iHandle;
+      ReplayHandle* const pHandle = &pState->m_aHandles[iHandle];
+      if(recorded == pHandle->m_recorded && bBooster == pHandle->m_bBooster) {
+         --pState->m_cHandles;
+         *pHandle = pState->m_aHandles[pState->m_cHandles];
+         return;
+      }
+   }
+}
+
+static const unsigned char* GetReplayDataSet(ReplayState* const pState, const uint64_t iDataSet) {
+   if(pState->m_cDataSets <= iDataSet) {
+      LOG_0(Trace_Error, "ERROR GetReplayDataSet the recording references a dataset that it does not contain");
+      pState->m_bCorrupt = true;
+      return nullptr;
+   }
+   return pState->m_aDataSets[static_cast<size_t>(iDataSet)];
+}
+
+static ErrorEbm ReplayCall(ReplayState* const pState,
+      const RecordedCall call,
+      const char** const pApiNameOut,
+      std::chrono::steady_clock::duration* const pDurationOut) {
+   // sets *pApiNameOut to nullptr for records that are not API calls
+   *pApiNameOut = nullptr;
+
+   ErrorEbm error = Error_None;
+   std::chrono::steady_clock::time_point start;
+   alignas(RandomDeterministic) unsigned char aRng[k_cBytesRecordedRng];
+   void* apArrays[4] = {nullptr, nullptr, nullptr, nullptr};
+   char* objective = nullptr;
+   switch(call) {
+   case RecordedCall_DataSet: {
+      const uint64_t iDataSet = ReadU64(pState);
+      unsigned char* const pDataSet = static_cast<unsigned char*>(ReadArray(pState, 1));
+      if(pState->m_bCorrupt || nullptr == pDataSet || pState->m_cDataSets != iDataSet) {
+         LOG_0(Trace_Error, "ERROR ReplayCall the recording has an invalid dataset record");
+         pState->m_bCorrupt = true;
+         free(pDataSet);
+         return Error_IllegalParamVal;
+      }
+      unsigned char** const aDataSets = static_cast<unsigned char**>(
+            realloc(pState->m_aDataSets, sizeof(unsigned char*) * (pState->m_cDataSets + 1)));
+      if(nullptr == aDataSets) {
+         LOG_0(Trace_Warning, "WARNING ReplayCall out of memory");
+         free(pDataSet);
+         return Error_OutOfMemory;
+      }
+      pState->m_aDataSets = aDataSets;
+      aDataSets[pState->m_cDataSets] = pDataSet;
+      ++pState->m_cDataSets;
+      return Error_None;
+   }
+   case RecordedCall_CreateBooster: {
+      *pApiNameOut = "CreateBooster";
+      void* const pRng = ReadArray(pState, 1);
+      if(nullptr != pRng) {
+         memcpy(aRng, pRng, k_cBytesRecordedRng);
+         free(pRng);
+      }
+      const unsigned char* const pDataSet = GetReplayDataSet(pState, ReadU64(pState));
+      apArrays[0] = ReadArray(pState, sizeof(double));
+      apArrays[1] = ReadArray(pState, sizeof(BagEbm));
+      apArrays[2] = ReadArray(pState, sizeof(double));
+      const IntEbm countTerms = ReadInt(pState);
+      apArrays[3] = ReadArray(pState, sizeof(IntEbm));
+      IntEbm* const featureIndexes = static_cast<IntEbm*>(ReadArray(pState, sizeof(IntEbm)));
+      const IntEbm countInnerBags = ReadInt(pState);
+      const CreateBoosterFlags flags = static_cast<CreateBoosterFlags>(ReadInt(pState));
+      const AccelerationFlags acceleration = static_cast<AccelerationFlags>(ReadInt(pState));
+      objective = static_cast<char*>(ReadArray(pState, sizeof(char)));
+      const uint64_t recorded = ReadU64(pState);
+      if(!pState->m_bCorrupt) {
+         BoosterHandle boosterHandle = nullptr;
+         start = std::chrono::steady_clock::now();
+         error = CreateBooster(nullptr == pRng ? nullptr : aRng,
+               pDataSet,
+               static_cast<const double*>(apArrays[0]),
+               static_cast<const BagEbm*>(apArrays[1]),
+               static_cast<const double*>(apArrays[2]),
+               countTerms,
+               static_cast<const IntEbm*>(apArrays[3]),
+               featureIndexes,
+               countInnerBags,
+               flags,
+               acceleration,
+               objective,
+               nullptr,
+               &boosterHandle);
+         *pDurationOut = std::chrono::steady_clock::now() - start;
+         if(!AddReplayHandle(pState, recorded, boosterHandle, true)) {
+            FreeBooster(boosterHandle);
+            error = Error_OutOfMemory;
+         }
+      }
+      free(featureIndexes);
+      break;
+   }
+   case RecordedCall_CreateBoosterView: {
+      *pApiNameOut = "CreateBoosterView";
+      BoosterHandle boosterHandle = static_cast<BoosterHandle>(GetReplayHandle(pState, ReadU64(pState), true));
+      const uint64_t recorded = ReadU64(pState);
+      if(!pState->m_bCorrupt) {
+         BoosterHandle boosterHandleView = nullptr;
+         start = std::chrono::steady_clock::now();
+         error = CreateBoosterView(boosterHandle, &boosterHandleView);
+         *pDurationOut = std::chrono::steady_clock::now() - start;
+         if(!AddReplayHandle(pState, recorded, boosterHandleView, true)) {
+            FreeBooster(boosterHandleView);
+            error = Error_OutOfMemory;
+         }
+      }
+      break;
+   }
+   case RecordedCall_FreeBooster: {
+      *pApiNameOut = "FreeBooster";
+      const uint64_t recorded = ReadU64(pState);
+      if(!pState->m_bCorrupt) {
+         BoosterHandle boosterHandle = static_cast<BoosterHandle>(GetReplayHandle(pState, recorded, true));
+         RemoveReplayHandle(pState, recorded, true);
+         start = std::chrono::steady_clock::now();
+         FreeBooster(boosterHandle);
+         *pDurationOut = std::chrono::steady_clock::now() - start;
+      }
+      break;
+   }
+   case RecordedCall_GenerateTermUpdate: {
+      *pApiNameOut = "GenerateTermUpdate";
+      void* const pRng = ReadArray(pState, 1);
+      if(nullptr != pRng) {
+         memcpy(aRng, pRng, k_cBytesRecordedRng);
+         free(pRng);
+      }
+      BoosterHandle boosterHandle = static_cast<BoosterHandle>(GetReplayHandle(pState, ReadU64(pState), true));
+      const IntEbm indexTerm = ReadInt(pState);
+      const TermBoostFlags flags = static_cast<TermBoostFlags>(ReadInt(pState));
+      const double learningRate = ReadDouble(pState);
+      const IntEbm minSamplesLeaf = ReadInt(pState);
+      const double minHessian = ReadDouble(pState);
+      const double regAlpha = ReadDouble(pState);
+      const double regLambda = ReadDouble(pState);
+      const double maxDeltaStep = ReadDouble(pState);
+      const IntEbm minCategorySamples = ReadInt(pState);
+      const double categoricalSmoothing = ReadDouble(pState);
+      const IntEbm maxCategoricalThreshold = ReadInt(pState);
+      const double categoricalInclusionPercent = ReadDouble(pState);
+      const IntEbm randomRetries = ReadInt(pState);
+      apArrays[0] = ReadArray(pState, sizeof(IntEbm));
+      apArrays[1] = ReadArray(pState, sizeof(MonotoneDirection));
+      if(!pState->m_bCorrupt) {
+         double avgGain;
+         start = std::chrono::steady_clock::now();
+         error = GenerateTermUpdate(nullptr == pRng ? nullptr : aRng,
+               boosterHandle,
+               indexTerm,
+               flags,
+               learningRate,
+               minSamplesLeaf,
+               minHessian,
+               regAlpha,
+               regLambda,
+               maxDeltaStep,
+               minCategorySamples,
+               categoricalSmoothing,
+               maxCategoricalThreshold,
+               categoricalInclusionPercent,
+               randomRetries,
+               static_cast<const IntEbm*>(apArrays[0]),
+               static_cast<const MonotoneDirection*>(apArrays[1]),
+               &avgGain);
+         *pDurationOut = std::chrono::steady_clock::now() - start;
+      }
+      break;
+   }
+   case RecordedCall_SetTermUpdate: {
+      *pApiNameOut = "SetTermUpdate";
+      BoosterHandle boosterHandle = static_cast<BoosterHandle>(GetReplayHandle(pState, ReadU64(pState), true));
+      const IntEbm indexTerm = ReadInt(pState);
+      apArrays[0] = ReadArray(pState, sizeof(double));
+      if(!pState->m_bCorrupt) {
+         start = std::chrono::steady_clock::now();
+         error = SetTermUpdate(boosterHandle, indexTerm, static_cast<const double*>(apArrays[0]));
+         *pDurationOut = std::chrono::steady_clock::now() - start;
+      }
+      break;
+   }
+   case RecordedCall_ApplyTermUpdate: {
+      *pApiNameOut = "ApplyTermUpdate";
+      BoosterHandle boosterHandle = static_cast<BoosterHandle>(GetReplayHandle(pState, ReadU64(pState), true));
+      if(!pState->m_bCorrupt) {
+         double avgValidationMetric;
+         start = std::chrono::steady_clock::now();
+         error = ApplyTermUpdate(boosterHandle, &avgValidationMetric);
+         *pDurationOut = std::chrono::steady_clock::now() - start;
+      }
+      break;
+   }
+   case RecordedCall_DeserializeBooster: {
+      *pApiNameOut = "DeserializeBooster";
+      BoosterHandle boosterHandle = static_cast<BoosterHandle>(GetReplayHandle(pState, ReadU64(pState), true));
+      const IntEbm countBytes = ReadInt(pState);
+      apArrays[0] = ReadArray(pState, 1);
+      const bool bRng = 0 != ReadU64(pState);
+      if(!pState->m_bCorrupt) {
+         start = std::chrono::steady_clock::now();
+         error = DeserializeBooster(boosterHandle, countBytes, apArrays[0], bRng ? aRng : nullptr);
+         *pDurationOut = std::chrono::steady_clock::now() - start;
+      }
+      break;
+   }
+   case RecordedCall_CreateInteractionDetector: {
+      *pApiNameOut = "CreateInteractionDetector";
+      const unsigned char* const pDataSet = GetReplayDataSet(pState, ReadU64(pState));
+      apArrays[0] = ReadArray(pState, sizeof(double));
+      apArrays[1] = ReadArray(pState, sizeof(BagEbm));
+      apArrays[2] = ReadArray(pState, sizeof(double));
+      const CreateInteractionFlags flags = static_cast<CreateInteractionFlags>(ReadInt(pState));
+      const AccelerationFlags acceleration = static_cast<AccelerationFlags>(ReadInt(pState));
+      objective = static_cast<char*>(ReadArray(pState, sizeof(char)));
+      const uint64_t recorded = ReadU64(pState);
+      if(!pState->m_bCorrupt) {
+         InteractionHandle interactionHandle = nullptr;
+         start = std::chrono::steady_clock::now();
+         error = CreateInteractionDetector(pDataSet,
+               static_cast<const double*>(apArrays[0]),
+               static_cast<const BagEbm*>(apArrays[1]),
+               static_cast<const double*>(apArrays[2]),
+               flags,
+               acceleration,
+               objective,
+               nullptr,
+               &interactionHandle);
+         *pDurationOut = std::chrono::steady_clock::now() - start;
+         if(!AddReplayHandle(pState, recorded, interactionHandle, false)) {
+            FreeInteractionDetector(interactionHandle);
+            error = Error_OutOfMemory;
+         }
+      }
+      break;
+   }
+   case RecordedCall_FreeInteractionDetector: {
+      *pApiNameOut = "FreeInteractionDetector";
+      const uint64_t recorded = ReadU64(pState);
+      if(!pState->m_bCorrupt) {
+         InteractionHandle interactionHandle =
+               static_cast<InteractionHandle>(GetReplayHandle(pState, recorded, false));
+         RemoveReplayHandle(pState, recorded, false);
+         start = std::chrono::steady_clock::now();
+         FreeInteractionDetector(interactionHandle);
+         *pDurationOut = std::chrono::steady_clock::now() - start;
+      }
+      break;
+   }
+   case RecordedCall_CalcInteractionStrength: {
+      *pApiNameOut = "CalcInteractionStrength";
+      InteractionHandle interactionHandle =
+            static_cast<InteractionHandle>(GetReplayHandle(pState, ReadU64(pState), false));
+      const IntEbm countDimensions = ReadInt(pState);
+      apArrays[0] = ReadArray(pState, sizeof(IntEbm));
+      const CalcInteractionFlags flags = static_cast<CalcInteractionFlags>(ReadInt(pState));
+      const IntEbm maxCardinality = ReadInt(pState);
+      const IntEbm minSamplesLeaf = ReadInt(pState);
+      const double minHessian = ReadDouble(pState);
+      const double regAlpha = ReadDouble(pState);
+      const double regLambda = ReadDouble(pState);
+      const double maxDeltaStep = ReadDouble(pState);
+      if(!pState->m_bCorrupt) {
+         double avgInteractionStrength;
+         start = std::chrono::steady_clock::now();
+         error = CalcInteractionStrength(interactionHandle,
+               countDimensions,
+               static_cast<const IntEbm*>(apArrays[0]),
+               flags,
+               maxCardinality,
+               minSamplesLeaf,
+               minHessian,
+               regAlpha,
+               regLambda,
+               maxDeltaStep,
+               &avgInteractionStrength);
+         *pDurationOut = std::chrono::steady_clock::now() - start;
+      }
+      break;
+   }
+   case RecordedCall_CalcInteractionStrengths: {
+      *pApiNameOut = "CalcInteractionStrengths";
+      InteractionHandle interactionHandle =
+            static_cast<InteractionHandle>(GetReplayHandle(pState, ReadU64(pState), false));
+      const IntEbm countTerms = ReadInt(pState);
+      apArrays[0] = ReadArray(pState, sizeof(IntEbm));
+      apArrays[1] = ReadArray(pState, sizeof(IntEbm));
+      const CalcInteractionFlags flags = static_cast<CalcInteractionFlags>(ReadInt(pState));
+      const IntEbm maxCardinality = ReadInt(pState);
+      const IntEbm minSamplesLeaf = ReadInt(pState);
+      const double minHessian = ReadDouble(pState);
+      const double regAlpha = ReadDouble(pState);
+      const double regLambda = ReadDouble(pState);
+      const double maxDeltaStep = ReadDouble(pState);
+      const IntEbm countThreads = ReadInt(pState);
+      if(!pState->m_bCorrupt) {
+         size_t cTerms = 0;
+         if(IntEbm{0} < countTerms && !IsConvertError<size_t>(countTerms) &&
+               !IsMultiplyError(sizeof(double), static_cast<size_t>(countTerms))) {
+            cTerms = static_cast<size_t>(countTerms);
+         }
+         apArrays[2] = malloc(sizeof(double) * (cTerms + size_t{1}));
+         if(nullptr == apArrays[2]) {
+            LOG_0(Trace_Warning, "WARNING ReplayCall out of memory");
+            error = Error_OutOfMemory;
+            break;
+         }
+         start = std::chrono::steady_clock::now();
+         error = CalcInteractionStrengths(interactionHandle,
+               countTerms,
+               static_cast<const IntEbm*>(apArrays[0]),
+               static_cast<const IntEbm*>(apArrays[1]),
+               flags,
+               maxCardinality,
+               minSamplesLeaf,
+               minHessian,
+               regAlpha,
+               regLambda,
+               maxDeltaStep,
+               countThreads,
+               static_cast<double*>(apArrays[2]));
+         *pDurationOut = std::chrono::steady_clock::now() - start;
+      }
+      break;
+   }
+   default:
+      LOG_0(Trace_Error, "ERROR ReplayCall the recording contains an unknown record");
+      pState->m_bCorrupt = true;
+      return Error_IllegalParamVal;
+   }
+
+   free(objective);
+   for(void* const pArray : apArrays) {
+      free(pArray);
+   }
+   return error;
+}
+
+EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION ReplayRecording(
+      const char* filename, ReplayCallbackFunction replayCallback) {
+   LOG_N(Trace_Info,
+         "Entered ReplayRecording: "
+         "filename=%p, "
+         "replayCallback=%p",
+         static_cast<const void*>(filename),
+         reinterpret_cast<const void*>(replayCallback));
+
+   if(nullptr == filename) {
+      LOG_0(Trace_Error, "ERROR ReplayRecording nullptr == filename");
+      return Error_IllegalParamVal;
+   }
+
+   ReplayState state;
+   state.m_pFile = fopen(filename, "rb");
+   if(nullptr == state.m_pFile) {
+      LOG_0(Trace_Error, "ERROR ReplayRecording could not open the recording file");
+      return Error_IllegalParamVal;
+   }
+   state.m_bCorrupt = false;
+   state.m_aDataSets = nullptr;
+   state.m_cDataSets = 0;
+   state.m_aHandles = nullptr;
+   state.m_cHandles = 0;
+
+   ErrorEbm error = Error_None;
+
+   char aMagic[sizeof(k_recordingMagic)];
+   ReadBytes(&state, aMagic, sizeof(aMagic));
+   if(state.m_bCorrupt || 0 != memcmp(aMagic, k_recordingMagic, sizeof(aMagic))) {
+      LOG_0(Trace_Error, "ERROR ReplayRecording the file is not a recording");
+      error = Error_IllegalParamVal;
+   } else {
+      IntEbm iCall = 0;
+      while(true) {
+         uint32_t id;
+         if(sizeof(id) != fread(&id, 1, sizeof(id), state.m_pFile)) {
+            // the end of the recording
+            break;
+         }
+         const char* apiName;
+         std::chrono::steady_clock::duration duration = std::chrono::steady_clock::duration::zero();
+         const ErrorEbm errorCall = ReplayCall(&state, static_cast<RecordedCall>(id), &apiName, &duration);
+         if(state.m_bCorrupt) {
+            error = Error_IllegalParamVal;
+            break;
+         }
+         if(Error_OutOfMemory == errorCall && nullptr == apiName) {
+            error = errorCall;
+            break;
+         }
+         if(nullptr != apiName) {
+            if(nullptr != replayCallback) {
+               const double seconds = std::chrono::duration<double>(duration).count();
+               (*replayCallback)(iCall, apiName, errorCall, seconds);
+            }
+            ++iCall;
+         }
+      }
+   }
+
+   // free anything the recording did not free itself, which happens if the recording was stopped midway
+   for(size_t iHandle = 0; iHandle < state.m_cHandles; ++iHandle) {
+      const ReplayHandle* const pHandle = &state.m_aHandles[iHandle];
+      if(pHandle->m_bBooster) {
+         FreeBooster(static_cast<BoosterHandle>(pHandle->m_handle));
+      } else {
+         FreeInteractionDetector(static_cast<InteractionHandle>(pHandle->m_handle));
+      }
+   }
+   free(state.m_aHandles);
+   for(size_t iDataSet = 0; iDataSet < state.m_cDataSets; ++iDataSet) {
+      free(state.m_aDataSets[iDataSet]);
+   }
+   free(state.m_aDataSets);
+   fclose(state.m_pFile);
+
+   LOG_0(Trace_Info, "Exited ReplayRecording");
+   return error;
+}
+
+} // namespace DEFINED_ZONE_NAME
@@ -0,0 +1,104 @@
+// Copyright (c) 2023 The InterpretML Contributors
+// Licensed under the MIT license.
+// Author: Paul Koch <code@koch.ninja>
+
+#ifndef API_RECORDING_HPP
+#define API_RECORDING_HPP
+
+#include <stddef.h> // size_t
+
+#include "libebm.h" // ErrorEbm, BoosterHandle, InteractionHandle
+
+namespace DEFINED_ZONE_NAME {
+#ifndef DEFINED_ZONE_NAME
+#error DEFINED_ZONE_NAME must be defined
+#endif // DEFINED_ZONE_NAME
+
+class BoosterShell;
+
+// The recorder writes the booster and interaction calls that drive a fit into a binary file so that
+// ReplayRecording can re-execute them natively.  Functions that create handles are recorded when they exit
+// successfully since the recording needs the new handle.  The other calls are recorded on entry, which keeps the
+// per-booster order of calls even when several boosters run on different threads.
+
+extern bool IsRecording();
+
+// the RNG state needs to be copied before CreateBooster and GenerateTermUpdate advance it
+static constexpr size_t k_cBytesRecordedRng = 24;
+extern void SaveRecordedRng(const void* const rng, unsigned char* const aRngOut);
+
+extern void RecordCreateBooster(const unsigned char* const aRngBefore,
+      const void* const dataSet,
+      const double* const intercept,
+      const BagEbm* const bag,
+      const double* const initScores,
+      const IntEbm countTerms,
+      const IntEbm* const dimensionCounts,
+      const IntEbm* const featureIndexes,
+      const IntEbm countInnerBags,
+      const CreateBoosterFlags flags,
+      const AccelerationFlags acceleration,
+      const char* const objective,
+      const size_t cScores,
+      const BoosterHandle boosterHandle);
+extern void RecordCreateBoosterView(const BoosterHandle boosterHandle, const BoosterHandle boosterHandleView);
+extern void RecordFreeBooster(const BoosterHandle boosterHandle);
+extern void RecordGenerateTermUpdate(const unsigned char* const aRngBefore,
+      BoosterShell* const pBoosterShell,
+      const IntEbm indexTerm,
+      const TermBoostFlags flags,
+      const double learningRate,
+      const IntEbm minSamplesLeaf,
+      const double minHessian,
+      const double regAlpha,
+      const double regLambda,
+      const double maxDeltaStep,
+      const IntEbm minCategorySamples,
+      const double categoricalSmoothing,
+      const IntEbm maxCategoricalThreshold,
+      const double categoricalInclusionPercent,
+      const IntEbm randomRetries,
+      const IntEbm* const leavesMax,
+      const MonotoneDirection* const direction);
+extern void RecordSetTermUpdate(
+      BoosterShell* const pBoosterShell, const IntEbm indexTerm, const double* const updateScoresTensor);
+extern void RecordApplyTermUpdate(const BoosterHandle boosterHandle);
+extern void RecordDeserializeBooster(
+      const BoosterHandle boosterHandle, const IntEbm countBytes, const void* const state, const void* const rngOut);
+
+extern void RecordCreateInteractionDetector(const void* const dataSet,
+      const double* const intercept,
+      const BagEbm* const bag,
+      const double* const initScores,
+      const CreateInteractionFlags flags,
+      const AccelerationFlags acceleration,
+      const char* const objective,
+      const size_t cScores,
+      const InteractionHandle interactionHandle);
+extern void RecordFreeInteractionDetector(const InteractionHandle interactionHandle);
+extern void RecordCalcInteractionStrength(const InteractionHandle interactionHandle,
+      const IntEbm countDimensions,
+      const IntEbm* const featureIndexes,
+      const CalcInteractionFlags flags,
+      const IntEbm maxCardinality,
+      const IntEbm minSamplesLeaf,
+      const double minHessian,
+      const double regAlpha,
+      const double regLambda,
+      const double maxDeltaStep);
+extern void RecordCalcInteractionStrengths(const InteractionHandle interactionHandle,
+      const IntEbm countTerms,
+      const IntEbm* const dimensionCounts,
+      const IntEbm* const featureIndexes,
+      const CalcInteractionFlags flags,
+      const IntEbm maxCardinality,
+      const IntEbm minSamplesLeaf,
+      const double minHessian,
+      const double regAlpha,
+      const double regLambda,
+      const double maxDeltaStep,
+      const IntEbm countThreads);
+
+} // namespace DEFINED_ZONE_NAME
+
+#endif // API_RECORDING_HPP
@@ -208,6 +208,22 @@ INTERNAL_IMPORT_EXPORT_INCLUDE ErrorEbm CreateObjective_Cuda_32(const Config* co
       const char* const sObjectiveEnd,
       ObjectiveWrapper* const pObjectiveWrapperOut);
 
+INTERNAL_IMPORT_EXPORT_INCLUDE ErrorEbm InverseLink_Cpu_64(const LinkEbm link,
+      const double linkParam,
+      const size_t cScores,
+      const size_t cSamples,
+      double* const aScores);
+INTERNAL_IMPORT_EXPORT_INCLUDE ErrorEbm InverseLink_Avx512f_32(const LinkEbm link,
+      const double linkParam,
+      const size_t cScores,
+      const size_t cSamples,
+      double* const aScores);
+INTERNAL_IMPORT_EXPORT_INCLUDE ErrorEbm InverseLink_Avx2_32(const LinkEbm link,
+      const double linkParam,
+      const size_t cScores,
+      const size_t cSamples,
+      double* const aScores);
+
 INTERNAL_IMPORT_EXPORT_INCLUDE ErrorEbm CreateMetric_Cpu_64(
       const Config* const pConfig, const char* const sMetric, const char* const sMetricEnd
       //   MetricWrapper * const pMetricWrapperOut,
@@ -0,0 +1,259 @@
+// Copyright (c) 2023 The InterpretML Contributors
+// Licensed under the MIT license.
+// Author: Paul Koch <code@koch.ninja>
+
+#ifndef INVERSE_LINK_HPP
+#define INVERSE_LINK_HPP
+
+#include <stddef.h> // size_t
+#include <cmath> // std::isnan
+#include <limits> // numeric_limits
+#include <type_traits> // is_same
+
+#include "libebm.h" // ErrorEbm, LinkEbm
+#include "logging.h" // EBM_ASSERT
+#include "unzoned.h" // INLINE_ALWAYS, SIMD_BYTE_ALIGNMENT
+
+#include "bridge.h" // FloatBig
+
+namespace DEFINED_ZONE_NAME {
+#ifndef DEFINED_ZONE_NAME
+#error DEFINED_ZONE_NAME must be defined
+#endif // DEFINED_ZONE_NAME
+
+// Accuracy: the CPU zone computes in double using our bundled Exp64/Log64 kernels (math.hpp).  InverseLinkTest checks
+// that the CPU log link is within 2 ulps of libm's exp and that logit is within 4 ulps of 1 / (1 + exp(-score)).  The
+// other links have no ulp bound checked and are only tested to 1e-4 relative.  The SIMD zones compute in float, so the
+// relative error of each prediction is around 1e-6 (dominated by the float rounding of the score plus our float
+// Exp).  Probabilities from logit, vlogit, and mlogit are therefore accurate to around 1e-7 absolute.  Scores beyond
+// the float range are clamped to +-FLT_MAX before the transform, which saturates probabilities the same way double
+// would, but the log link overflows to +inf for scores above roughly 88 instead of roughly 709.
+
+template<typename TFloat> INLINE_ALWAYS static typename TFloat::T ToZoneFloat(const double val) noexcept {
+   if(std::is_same<FloatBig, typename TFloat::T>::value) {
+      return static_cast<typename TFloat::T>(val);
+   }
+   // converting an out of range double to float is undefined behavior, so clamp first.  NaN passes through.
+   static constexpr double k_max = static_cast<double>(std::numeric_limits<typename TFloat::T>::max());
+   const double clamped = k_max < val ? k_max : val < -k_max ? -k_max : val;
+   return static_cast<typename TFloat::T>(clamped);
+}
+
+struct InverseLinkLogit final {
+   template<typename TFloat> INLINE_ALWAYS static TFloat Apply(const TFloat& val) noexcept {
+      // 1 / (1 + exp(-val)).  -inf gives exp(+inf) = +inf and then 0.  +inf gives exp(-inf) = 0 and then 1.
+      return TFloat{1} / (TFloat{1} + TFloat::template ApproxExp<false, true>(val));
+   }
+};
+
+struct InverseLinkLog final {
+   template<typename TFloat> INLINE_ALWAYS static TFloat Apply(const TFloat& val) noexcept {
+      return TFloat::template ApproxExp<false>(val);
+   }
+};
+
+struct InverseLinkCloglog final {
+   template<typename TFloat> INLINE_ALWAYS static TFloat Apply(const TFloat& val) noexcept {
+      // 1 - exp(-exp(val))
+      return TFloat{1} - TFloat::template ApproxExp<false, true>(TFloat::template ApproxExp<false>(val));
+   }
+};
+
+struct InverseLinkLoglog final {
+   template<typename TFloat> INLINE_ALWAYS static TFloat Apply(const TFloat& val) noexcept {
+      // exp(-exp(-val))
+      return TFloat::template ApproxExp<false, true>(TFloat::template ApproxExp<false, true>(val));
+   }
+};
+
+struct InverseLinkInverse final {
+   template<typename TFloat> INLINE_ALWAYS static TFloat Apply(const TFloat& val) noexcept { return TFloat{1} / val; }
+};
+
+struct InverseLinkInverseSquare final {
+   template<typename TFloat> INLINE_ALWAYS static TFloat Apply(const TFloat& val) noexcept {
+      return TFloat{1} / Sqrt(val);
+   }
+};
+
+struct InverseLinkSqrt final {
+   template<typename TFloat> INLINE_ALWAYS static TFloat Apply(const TFloat& val) noexcept { return val * val; }
+};
+
+struct InverseLinkPower final {
+   template<typename TFloat> INLINE_ALWAYS static TFloat Apply(const TFloat& val, const TFloat& exponent) noexcept {
+      // pow(val, 1 / linkParam) through our bundled Exp and Log kernels instead of libm pow.  Negative scores are
+      // outside the domain of the power link and give NaN even when the exponent happens to be an integer.
+      return TFloat::template ApproxExp<false>(TFloat::template ApproxLog<false>(val) * exponent);
+   }
+};
+
+template<typename TFloat, typename TInverseLink, typename... TArgs>
+static void InverseLinkElements(const size_t c, double* const aScores, const TArgs&... args) noexcept {
+   static constexpr size_t cPack = static_cast<size_t>(TFloat::k_cSIMDPack);
+   alignas(SIMD_BYTE_ALIGNMENT) typename TFloat::T aTemp[cPack];
+
+   double* pScore = aScores;
+   const double* const pScoresEnd = aScores + c;
+   while(pScoresEnd != pScore) {
+      const size_t cRemaining = static_cast<size_t>(pScoresEnd - pScore);
+      const size_t cItems = cRemaining < cPack ? cRemaining : cPack;
+      size_t i = 0;
+      do {
+         aTemp[i] = ToZoneFloat<TFloat>(pScore[i]);
+         ++i;
+      } while(cItems != i);
+      for(; i < cPack; ++i) {
+         // 1 is a legal input for every inverse link, so the padding lanes never generate special values
+         aTemp[i] = typename TFloat::T{1};
+      }
+
+      TInverseLink::Apply(TFloat::Load(aTemp), args...).Store(aTemp);
+
+      i = 0;
+      do {
+         pScore[i] = static_cast<double>(aTemp[i]);
+         ++i;
+      } while(cItems != i);
+      pScore += cItems;
+   }
+}
+
+template<typename TFloat>
+static void InverseLinkSoftmax(const size_t cScores, const size_t cSamples, double* const aScores) noexcept {
+   // Each SIMD lane handles one sample, so the scores of cPack samples are gathered per class.  We stage exp(score -
+   // max) back into the caller's buffer between passes, which keeps our temporary memory independent of cScores.
+   static constexpr size_t cPack = static_cast<size_t>(TFloat::k_cSIMDPack);
+   alignas(SIMD_BYTE_ALIGNMENT) typename TFloat::T aTemp[cPack];
+
+   EBM_ASSERT(2 <= cScores);
+
+   size_t iSample = 0;
+   while(cSamples != iSample) {
+      const size_t cRemaining = cSamples - iSample;
+      const size_t cItems = cRemaining < cPack ? cRemaining : cPack;
+      double* const aRows = aScores + iSample * cScores;
+
+      size_t iScore = 0;
+      TFloat maxScore;
+      do {
+         size_t i = 0;
+         do {
+            aTemp[i] = ToZoneFloat<TFloat>(aRows[i * cScores + iScore]);
+            ++i;
+         } while(cItems != i);
+         for(; i < cPack; ++i) {
+            aTemp[i] = typename TFloat::T{0};
+         }
+         const TFloat score = TFloat::Load(aTemp);
+         // NaN is never less than anything, so a NaN in the first class propagates and any later NaN is caught below
+         maxScore = 0 == iScore ? score : IfThenElse(maxScore < score, score, maxScore);
+         ++iScore;
+      } while(cScores != iScore);
+
+      TFloat sumExp = 0.0;
+      iScore = 0;
+      do {
+         size_t i = 0;
+         do {
+            aTemp[i] = ToZoneFloat<TFloat>(aRows[i * cScores + iScore]);
+            ++i;
+         } while(cItems != i);
+         for(; i < cPack; ++i) {
+            aTemp[i] = typename TFloat::T{0};
+         }
+         const TFloat score = TFloat::Load(aTemp);
+         // the maximum class gets exactly 1, which also handles +inf scores (split evenly between all +inf classes)
+         // and rows that are all -inf (uniform) the same way the python mlogit inverse does
+         const TFloat expScore =
+               IfThenElse(score == maxScore, TFloat{1}, TFloat::template ApproxExp<false>(score - maxScore));
+         sumExp += expScore;
+         expScore.Store(aTemp);
+         i = 0;
+         do {
+            aRows[i * cScores + iScore] = static_cast<double>(aTemp[i]);
+            ++i;
+         } while(cItems != i);
+         ++iScore;
+      } while(cScores != iScore);
+
+      sumExp.Store(aTemp);
+      size_t i = 0;
+      do {
+         double* const pRow = aRows + i * cScores;
+         const double sum = static_cast<double>(aTemp[i]);
+         iScore = 0;
+         do {
+            pRow[iScore] /= sum;
+            ++iScore;
+         } while(cScores != iScore);
+         ++i;
+      } while(cItems != i);
+
+      iSample += cItems;
+   }
+}
+
+template<typename TFloat>
+static ErrorEbm InverseLinkZone(const LinkEbm link,
+      const double linkParam,
+      const size_t cScores,
+      const size_t cSamples,
+      double* const aScores) noexcept {
+   EBM_ASSERT(1 <= cScores);
+   EBM_ASSERT(1 <= cSamples);
+   EBM_ASSERT(nullptr != aScores);
+
+   const size_t c = cScores * cSamples;
+   switch(link) {
+   case Link_identity:
+      return Error_None;
+   case Link_logit:
+   case Link_vlogit:
+      InverseLinkElements<TFloat, InverseLinkLogit>(c, aScores);
+      return Error_None;
+   case Link_mlogit:
+      if(1 == cScores) {
+         // a single class is always 100% probable, unless the score was NaN
+         for(size_t i = 0; i < c; ++i) {
+            aScores[i] = std::isnan(aScores[i]) ? aScores[i] : 1.0;
+         }
+         return Error_None;
+      }
+      InverseLinkSoftmax<TFloat>(cScores, cSamples, aScores);
+      return Error_None;
+   case Link_log:
+      InverseLinkElements<TFloat, InverseLinkLog>(c, aScores);
+      return Error_None;
+   case Link_power:
+      if(0.0 == linkParam) {
+         // the limit of the power link as linkParam goes to zero is the log link
+         InverseLinkElements<TFloat, InverseLinkLog>(c, aScores);
+      } else {
+         InverseLinkElements<TFloat, InverseLinkPower>(c, aScores, TFloat{1.0 / linkParam});
+      }
+      return Error_None;
+   case Link_cloglog:
+      InverseLinkElements<TFloat, InverseLinkCloglog>(c, aScores);
+      return Error_None;
+   case Link_loglog:
+      InverseLinkElements<TFloat, InverseLinkLoglog>(c, aScores);
+      return Error_None;
+   case Link_inverse:
+      InverseLinkElements<TFloat, InverseLinkInverse>(c, aScores);
+      return Error_None;
+   case Link_inverse_square:
+      InverseLinkElements<TFloat, InverseLinkInverseSquare>(c, aScores);
+      return Error_None;
+   case Link_sqrt:
+      InverseLinkElements<TFloat, InverseLinkSqrt>(c, aScores);
+      return Error_None;
+   default:
+      // probit and cauchit need erfc and atan, which we don't have zone kernels for, so the caller handles them
+      return Error_IllegalParamVal;
+   }
+}
+
+} // namespace DEFINED_ZONE_NAME
+
+#endif // INVERSE_LINK_HPP
@@ -28,6 +28,7 @@
 #include "math.hpp"
 #include "approximate_math.hpp"
 #include "compute_wrapper.hpp"
+#include "InverseLink.hpp"
 
 namespace DEFINED_ZONE_NAME {
 #ifndef DEFINED_ZONE_NAME
@@ -831,6 +832,14 @@ INTERNAL_IMPORT_EXPORT_BODY ErrorEbm BinSumsInteraction_Avx2_32(
    return (*pBinSumsInteractionCpp)(pParams);
 }
 
+INTERNAL_IMPORT_EXPORT_BODY ErrorEbm InverseLink_Avx2_32(const LinkEbm link,
+      const double linkParam,
+      const size_t cScores,
+      const size_t cSamples,
+      double* const aScores) {
+   return InverseLinkZone<Avx2_32_Float>(link, linkParam, cScores, cSamples, aScores);
+}
+
 INTERNAL_IMPORT_EXPORT_BODY ErrorEbm CreateObjective_Avx2_32(const Config* const pConfig,
       const char* const sObjective,
       const char* const sObjectiveEnd,
@@ -25,6 +25,7 @@
 #include "math.hpp"
 #include "approximate_math.hpp"
 #include "compute_wrapper.hpp"
+#include "InverseLink.hpp"
 
 namespace DEFINED_ZONE_NAME {
 #ifndef DEFINED_ZONE_NAME
@@ -494,6 +495,14 @@ INTERNAL_IMPORT_EXPORT_BODY BoolEbm CheckTargetsC(
    return (*pCheckTargetsCpp)(pObjective, c, aTargets);
 }
 
+INTERNAL_IMPORT_EXPORT_BODY ErrorEbm InverseLink_Cpu_64(const LinkEbm link,
+      const double linkParam,
+      const size_t cScores,
+      const size_t cSamples,
+      double* const aScores) {
+   return InverseLinkZone<Cpu_64_Float>(link, linkParam, cScores, cSamples, aScores);
+}
+
 INTERNAL_IMPORT_EXPORT_BODY ErrorEbm CreateObjective_Cpu_64(const Config* const pConfig,
       const char* const sObjective,
       const char* const sObjectiveEnd,
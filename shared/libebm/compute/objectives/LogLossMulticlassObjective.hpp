@@ -136,6 +136,7 @@ template<typename TFloat> struct LogLossMulticlassObjective : MulticlassObjectiv
       const typename TFloat::TInt::T* pInputData;
       typename TFloat::TInt::T cCastScores;
       typename TFloat::TInt iTensorBin;
+      TFloat updateScoreNext;
 
       if(!bCollapsed) {
          const int cItemsPerBitPack = GET_ITEMS_PER_BIT_PACK(cCompilerPack, pData->m_cPack);
@@ -183,6 +184,9 @@ template<typename TFloat> struct LogLossMulticlassObjective : MulticlassObjectiv
                pInputData += TFloat::TInt::k_cSIMDPack;
             }
          }
+
+         // issue the gathering load for the first score of the first sample as early as possible
+         updateScoreNext = TFloat::Load(aUpdateTensorScores, iTensorBin);
       }
 
       const typename TFloat::TInt::T* pTargetData =
@@ -234,9 +238,16 @@ template<typename TFloat> struct LogLossMulticlassObjective : MulticlassObjectiv
             do {
                TFloat updateScore;
                if(!bCollapsed) {
+                  // The gathering load is the bottleneck when the update tensor does not fit into the cache, so
+                  // each score was gathered one step ahead, and we issue the gather for the next score of this
+                  // sample before the exp below so that the two overlap.  The first score of the next sample is
+                  // gathered once its tensor index is unpacked at the bottom of this loop.
                   // TODO: also try incrementing aUpdateTensorScores instead of incrementing iTensorBin
-                  updateScore = TFloat::Load(aUpdateTensorScores, iTensorBin);
+                  updateScore = updateScoreNext;
                   iTensorBin = iTensorBin + 1;
+                  if(cScores != iScore1 + 1) {
+                     updateScoreNext = TFloat::Load(aUpdateTensorScores, iTensorBin);
+                  }
                } else {
                   updateScore = aUpdateTensorScores[iScore1];
                }
@@ -345,6 +356,10 @@ template<typename TFloat> struct LogLossMulticlassObjective : MulticlassObjectiv
                iTensorBin = Multiply < typename TFloat::TInt, typename TFloat::TInt::T,
                k_dynamicScores != cCompilerScores && 1 != TFloat::k_cSIMDPack,
                static_cast<typename TFloat::TInt::T>(cCompilerScores) > (iTensorBin, cCastScores);
+
+               // after the last sample this gathers from the zeroed bit slot at the end of the packed data, which
+               // is tensor bin 0 and always exists
+               updateScoreNext = TFloat::Load(aUpdateTensorScores, iTensorBin);
             }
 
             if(bCollapsed) {
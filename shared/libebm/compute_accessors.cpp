@@ -236,6 +236,34 @@ extern ErrorEbm GetObjective(const Config* const pConfig,
    return Error_None;
 }
 
+extern ErrorEbm ApplyInverseLinkZone(const AccelerationFlags acceleration,
+      const LinkEbm link,
+      const double linkParam,
+      const size_t cScores,
+      const size_t cSamples,
+      double* const aScores) noexcept {
+   // when compiled with only CPU this variable is not used
+   UNUSED(acceleration);
+
+#ifdef BRIDGE_AVX512F_32
+   if(AccelerationFlags_AVX512F & acceleration) {
+      if(9 <= DetectInstructionset()) {
+         return InverseLink_Avx512f_32(link, linkParam, cScores, cSamples, aScores);
+      }
+   }
+#endif // BRIDGE_AVX512F_32
+
+#ifdef BRIDGE_AVX2_32
+   if(AccelerationFlags_AVX2 & acceleration) {
+      if(8 <= DetectInstructionset() && IsFMA3()) {
+         return InverseLink_Avx2_32(link, linkParam, cScores, cSamples, aScores);
+      }
+   }
+#endif // BRIDGE_AVX2_32
+
+   return InverseLink_Cpu_64(link, linkParam, cScores, cSamples, aScores);
+}
+
 #ifdef NEVER
 // TODO: eventually enable metrics
 INLINE_RELEASE_UNTEMPLATED static ErrorEbm GetMetrics(const Config* const pConfig, const char* sMetric
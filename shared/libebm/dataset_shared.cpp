@@ -336,7 +336,8 @@ static bool IsHeaderError(
    return false;
 }
 
-EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION CheckDataSet(IntEbm countBytesAllocated, const void* dataSet) {
+static ErrorEbm CheckDataSetSize(
+      const IntEbm countBytesAllocated, const void* const dataSet, size_t* const pcBytesOut) {
    // if countBytesAllocated is 0 then we do not check the bytes allocated
    // if countBytesAllocated is positive then countBytesAllocated must exactly equal the dataSet size
    // if countBytesAllocated is negative then -countBytesAllocated must equal or exceed the dataSet size
@@ -829,9 +830,22 @@ EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION CheckDataSet(IntEbm countBytesAlloc
       }
    }
 
+   if(nullptr != pcBytesOut) {
+      *pcBytesOut = iOffsetNext;
+   }
+
    return Error_None;
 }
 
+EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION CheckDataSet(IntEbm countBytesAllocated, const void* dataSet) {
+   return CheckDataSetSize(countBytesAllocated, dataSet, nullptr);
+}
+
+extern ErrorEbm GetDataSetSharedSize(const unsigned char* const pDataSetShared, size_t* const pcBytesOut) {
+   EBM_ASSERT(nullptr != pcBytesOut);
+   return CheckDataSetSize(IntEbm{0}, pDataSetShared, pcBytesOut);
+}
+
 static ErrorEbm LockDataSetShared(const size_t cBytesAllocated, unsigned char* const pFillMem) {
    HeaderDataSetShared* const pHeaderDataSetShared = reinterpret_cast<HeaderDataSetShared*>(pFillMem);
    EBM_ASSERT(k_sharedDataSetWorkingId == pHeaderDataSetShared->m_id);
@@ -2301,4 +2315,686 @@ EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION ExtractTargetClasses(
    return Error_None;
 }
 
+struct BinReader {
+   const UIntShared* m_pData;
+   size_t m_iBinOffset;
+   UIntShared m_maskBits;
+   int m_cBitsPerItemMax;
+   int m_cShift;
+   int m_cShiftReset;
+};
+static_assert(std::is_standard_layout<BinReader>::value,
+      "We use the struct hack in several places, so disallow non-standard_layout types in general");
+static_assert(std::is_trivial<BinReader>::value,
+      "We use memcpy in several places, so disallow non-trivial types in general");
+
+static ErrorEbm InitBinReader(const unsigned char* const pDataSetShared,
+      const size_t cSamples,
+      const size_t cFeatures,
+      const IntEbm indexFeature,
+      BinReader* const pReader,
+      size_t* const pcTensorBinsOut) {
+   EBM_ASSERT(nullptr != pDataSetShared);
+   EBM_ASSERT(nullptr != pReader);
+   EBM_ASSERT(nullptr != pcTensorBinsOut);
+
+   if(indexFeature < IntEbm{0} || IsConvertError<size_t>(indexFeature) ||
+         cFeatures <= static_cast<size_t>(indexFeature)) {
+      LOG_0(Trace_Error, "ERROR InitBinReader featureIndexes value is not a valid feature index");
+      return Error_IllegalParamVal;
+   }
+
+   bool bMissing;
+   bool bUnseen;
+   bool bNominal;
+   bool bSparse;
+   UIntShared countBins;
+   UIntShared defaultValSparse;
+   size_t cNonDefaultsSparse;
+   const void* pFeatureData = GetDataSetSharedFeature(pDataSetShared,
+         static_cast<size_t>(indexFeature),
+         &bMissing,
+         &bUnseen,
+         &bNominal,
+         &bSparse,
+         &countBins,
+         &defaultValSparse,
+         &cNonDefaultsSparse);
+   if(bSparse) {
+      LOG_0(Trace_Error, "ERROR InitBinReader sparse features are not supported yet");
+      return Error_UnexpectedInternal;
+   }
+   EBM_ASSERT(!IsConvertError<size_t>(countBins)); // the shared dataset was checked when the header was read
+   const size_t cBins = static_cast<size_t>(countBins);
+
+   // the shared dataset does not store the missing bin when there are no missing values
+   pReader->m_iBinOffset = bMissing ? size_t{0} : size_t{1};
+
+   // the external tensor has a slot for the missing and unseen bins even if the dataset did not need them
+   *pcTensorBinsOut = cBins + (bMissing ? size_t{0} : size_t{1}) + (bUnseen ? size_t{0} : size_t{1});
+
+   if(cBins <= size_t{1}) {
+      // with only 1 bin nothing is stored since every sample has the same bin
+      pReader->m_pData = nullptr;
+      pReader->m_maskBits = 0;
+      pReader->m_cBitsPerItemMax = 0;
+      pReader->m_cShift = 0;
+      pReader->m_cShiftReset = 0;
+   } else {
+      const int cItemsPerBitPack = GetCountItemsBitPacked<UIntShared>(CountBitsRequired(cBins - size_t{1}));
+      const int cBitsPerItemMax = GetCountBits<UIntShared>(cItemsPerBitPack);
+      pReader->m_pData = static_cast<const UIntShared*>(pFeatureData);
+      pReader->m_maskBits = MakeLowMask<UIntShared>(cBitsPerItemMax);
+      pReader->m_cBitsPerItemMax = cBitsPerItemMax;
+      // the first sample is in the highest occupied bits of the first item, which depends on the sample count
+      pReader->m_cShift = size_t{0} == cSamples ?
+            0 :
+            static_cast<int>((cSamples - size_t{1}) % static_cast<size_t>(cItemsPerBitPack)) * cBitsPerItemMax;
+      pReader->m_cShiftReset = (cItemsPerBitPack - 1) * cBitsPerItemMax;
+   }
+   return Error_None;
+}
+
+INLINE_ALWAYS static size_t ReadBin(BinReader* const pReader) {
+   // returns the external bin index of the next sample
+   size_t iBin = pReader->m_iBinOffset;
+   if(nullptr != pReader->m_pData) {
+      iBin += static_cast<size_t>((*pReader->m_pData >> pReader->m_cShift) & pReader->m_maskBits);
+      pReader->m_cShift -= pReader->m_cBitsPerItemMax;
+      if(pReader->m_cShift < 0) {
+         pReader->m_cShift = pReader->m_cShiftReset;
+         ++pReader->m_pData;
+      }
+   }
+   return iBin;
+}
+
+EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION ScoreDataSet(const void* dataSet,
+      const BagEbm* bag,
+      IntEbm countTerms,
+      const IntEbm* dimensionCounts,
+      const IntEbm* featureIndexes,
+      IntEbm countScores,
+      const double* termScores,
+      double* scoresOut) {
+   LOG_N(Trace_Info,
+         "Entered ScoreDataSet: "
+         "dataSet=%p, "
+         "bag=%p, "
+         "countTerms=%" IntEbmPrintf ", "
+         "dimensionCounts=%p, "
+         "featureIndexes=%p, "
+         "countScores=%" IntEbmPrintf ", "
+         "termScores=%p, "
+         "scoresOut=%p",
+         dataSet,
+         static_cast<const void*>(bag),
+         countTerms,
+         static_cast<const void*>(dimensionCounts),
+         static_cast<const void*>(featureIndexes),
+         countScores,
+         static_cast<const void*>(termScores),
+         static_cast<const void*>(scoresOut));
+
+   UIntShared countSamples;
+   size_t cFeatures;
+   size_t cWeightsUnused;
+   size_t cTargetsUnused;
+   const ErrorEbm error = GetDataSetSharedHeader(
+         static_cast<const unsigned char*>(dataSet), &countSamples, &cFeatures, &cWeightsUnused, &cTargetsUnused);
+   if(Error_None != error) {
+      // already logged
+      return error;
+   }
+
+   if(IsConvertError<size_t>(countSamples)) {
+      LOG_0(Trace_Error, "ERROR ScoreDataSet IsConvertError<size_t>(countSamples)");
+      return Error_IllegalParamVal;
+   }
+   const size_t cSamples = static_cast<size_t>(countSamples);
+
+   if(countTerms < IntEbm{0} || IsConvertError<size_t>(countTerms)) {
+      LOG_0(Trace_Error, "ERROR ScoreDataSet countTerms must be a non-negative integer");
+      return Error_IllegalParamVal;
+   }
+   const size_t cTerms = static_cast<size_t>(countTerms);
+
+   if(countScores <= IntEbm{0} || IsConvertError<size_t>(countScores)) {
+      LOG_0(Trace_Error, "ERROR ScoreDataSet countScores must be a positive integer");
+      return Error_IllegalParamVal;
+   }
+   const size_t cScores = static_cast<size_t>(countScores);
+
+   size_t cIncludedSamples = cSamples;
+   if(nullptr != bag) {
+      cIncludedSamples = 0;
+      for(size_t iSample = 0; iSample < cSamples; ++iSample) {
+         if(BagEbm{0} != bag[iSample]) {
+            ++cIncludedSamples;
+         }
+      }
+   }
+   if(size_t{0} == cIncludedSamples) {
+      return Error_None;
+   }
+
+   if(nullptr == scoresOut) {
+      LOG_0(Trace_Error, "ERROR ScoreDataSet nullptr == scoresOut");
+      return Error_IllegalParamVal;
+   }
+   if(IsMultiplyError(sizeof(*scoresOut), cScores, cIncludedSamples)) {
+      LOG_0(Trace_Error, "ERROR ScoreDataSet IsMultiplyError(sizeof(*scoresOut), cScores, cIncludedSamples)");
+      return Error_IllegalParamVal;
+   }
+   memset(scoresOut, 0, sizeof(*scoresOut) * cScores * cIncludedSamples);
+
+   if(size_t{0} == cTerms) {
+      return Error_None;
+   }
+   if(nullptr == dimensionCounts) {
+      LOG_0(Trace_Error, "ERROR ScoreDataSet nullptr == dimensionCounts");
+      return Error_IllegalParamVal;
+   }
+   if(nullptr == termScores) {
+      LOG_0(Trace_Error, "ERROR ScoreDataSet nullptr == termScores");
+      return Error_IllegalParamVal;
+   }
+
+   const double* pTermScores = termScores;
+   const IntEbm* piFeature = featureIndexes;
+   const IntEbm* pcDimensions = dimensionCounts;
+   const IntEbm* const pcDimensionsEnd = dimensionCounts + cTerms;
+   do {
+      const IntEbm countDimensions = *pcDimensions;
+      if(countDimensions < IntEbm{0} || IntEbm{k_cDimensionsMax} < countDimensions) {
+         LOG_0(Trace_Error, "ERROR ScoreDataSet countDimensions must be between 0 and k_cDimensionsMax");
+         return Error_IllegalParamVal;
+      }
+      const size_t cDimensions = static_cast<size_t>(countDimensions);
+      if(size_t{0} != cDimensions && nullptr == piFeature) {
+         LOG_0(Trace_Error, "ERROR ScoreDataSet nullptr == featureIndexes");
+         return Error_IllegalParamVal;
+      }
+
+      // the tensors are in C order with the scores innermost, so the last dimension has the smallest stride
+      BinReader aReaders[k_cDimensionsMax];
+      size_t aStrides[k_cDimensionsMax];
+      size_t cTensorScores = cScores;
+      size_t iDimension = cDimensions;
+      while(size_t{0} != iDimension) {
+         --iDimension;
+         size_t cTensorBins;
+         const ErrorEbm errorReader = InitBinReader(static_cast<const unsigned char*>(dataSet),
+               cSamples,
+               cFeatures,
+               piFeature[iDimension],
+               &aReaders[iDimension],
+               &cTensorBins);
+         if(Error_None != errorReader) {
+            return errorReader;
+         }
+         aStrides[iDimension] = cTensorScores;
+         if(IsMultiplyError(cTensorScores, cTensorBins)) {
+            LOG_0(Trace_Error, "ERROR ScoreDataSet IsMultiplyError(cTensorScores, cTensorBins)");
+            return Error_IllegalParamVal;
+         }
+         cTensorScores *= cTensorBins;
+      }
+
+      double* pScores = scoresOut;
+      for(size_t iSample = 0; iSample < cSamples; ++iSample) {
+         size_t iTensor = 0;
+         for(size_t iDimensionRead = 0; iDimensionRead < cDimensions; ++iDimensionRead) {
+            iTensor += ReadBin(&aReaders[iDimensionRead]) * aStrides[iDimensionRead];
+         }
+         EBM_ASSERT(iTensor < cTensorScores);
+
+         if(nullptr == bag || BagEbm{0} != bag[iSample]) {
+            const double* const pTensorScores = &pTermScores[iTensor];
+            for(size_t iScore = 0; iScore < cScores; ++iScore) {
+               pScores[iScore] += pTensorScores[iScore];
+            }
+            pScores += cScores;
+         }
+      }
+      EBM_ASSERT(scoresOut + cScores * cIncludedSamples == pScores);
+
+      pTermScores += cTensorScores;
+      piFeature += cDimensions;
+      ++pcDimensions;
+   } while(pcDimensionsEnd != pcDimensions);
+
+   LOG_0(Trace_Info, "Exited ScoreDataSet");
+   return Error_None;
+}
+
+// the number of samples we unpack from each packed column before accumulating them into all the term tensors
+static constexpr size_t k_cBlockSamples = 1024;
+
+EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION ExtractTermBinWeights(const void* dataSet,
+      const double* weights,
+      IntEbm countTerms,
+      const IntEbm* dimensionCounts,
+      const IntEbm* featureIndexes,
+      double* binWeightsOut) {
+   LOG_N(Trace_Info,
+         "Entered ExtractTermBinWeights: "
+         "dataSet=%p, "
+         "weights=%p, "
+         "countTerms=%" IntEbmPrintf ", "
+         "dimensionCounts=%p, "
+         "featureIndexes=%p, "
+         "binWeightsOut=%p",
+         dataSet,
+         static_cast<const void*>(weights),
+         countTerms,
+         static_cast<const void*>(dimensionCounts),
+         static_cast<const void*>(featureIndexes),
+         static_cast<const void*>(binWeightsOut));
+
+   UIntShared countSamples;
+   size_t cFeatures;
+   size_t cWeightsUnused;
+   size_t cTargetsUnused;
+   ErrorEbm error = GetDataSetSharedHeader(
+         static_cast<const unsigned char*>(dataSet), &countSamples, &cFeatures, &cWeightsUnused, &cTargetsUnused);
+   if(Error_None != error) {
+      // already logged
+      return error;
+   }
+
+   if(IsConvertError<size_t>(countSamples)) {
+      LOG_0(Trace_Error, "ERROR ExtractTermBinWeights IsConvertError<size_t>(countSamples)");
+      return Error_IllegalParamVal;
+   }
+   const size_t cSamples = static_cast<size_t>(countSamples);
+
+   if(countTerms < IntEbm{0} || IsConvertError<size_t>(countTerms)) {
+      LOG_0(Trace_Error, "ERROR ExtractTermBinWeights countTerms must be a non-negative integer");
+      return Error_IllegalParamVal;
+   }
+   const size_t cTerms = static_cast<size_t>(countTerms);
+   if(size_t{0} == cTerms) {
+      return Error_None;
+   }
+   if(nullptr == dimensionCounts) {
+      LOG_0(Trace_Error, "ERROR ExtractTermBinWeights nullptr == dimensionCounts");
+      return Error_IllegalParamVal;
+   }
+   if(nullptr == binWeightsOut) {
+      LOG_0(Trace_Error, "ERROR ExtractTermBinWeights nullptr == binWeightsOut");
+      return Error_IllegalParamVal;
+   }
+
+   size_t cTermFeatures = 0;
+   for(size_t iTerm = 0; iTerm < cTerms; ++iTerm) {
+      const IntEbm countDimensions = dimensionCounts[iTerm];
+      if(countDimensions < IntEbm{0} || IntEbm{k_cDimensionsMax} < countDimensions) {
+         LOG_0(Trace_Error, "ERROR ExtractTermBinWeights countDimensions must be between 0 and k_cDimensionsMax");
+         return Error_IllegalParamVal;
+      }
+      cTermFeatures += static_cast<size_t>(countDimensions);
+   }
+   if(size_t{0} != cTermFeatures && nullptr == featureIndexes) {
+      LOG_0(Trace_Error, "ERROR ExtractTermBinWeights nullptr == featureIndexes");
+      return Error_IllegalParamVal;
+   }
+
+   // Each feature used by any term gets a slot.  We unpack a block of samples from each slot's packed column once,
+   // and then every term reads the unpacked bins from the slots, so shared features are only unpacked once per block.
+   static constexpr size_t k_iSlotNone = std::numeric_limits<size_t>::max();
+   const size_t cSlotsMax = cTermFeatures < cFeatures ? cTermFeatures : cFeatures;
+
+   size_t* aiFeatureSlots = nullptr;
+   BinReader* aReaders = nullptr;
+   size_t* aTermSlots = nullptr;
+   size_t* aTermStrides = nullptr;
+   size_t* aBlockBins = nullptr;
+   if(IsMultiplyError(sizeof(size_t), cTerms)) {
+      LOG_0(Trace_Warning, "WARNING ExtractTermBinWeights IsMultiplyError(sizeof(size_t), cTerms)");
+      return Error_OutOfMemory;
+   }
+   size_t* const aTermTensorBins = static_cast<size_t*>(malloc(sizeof(size_t) * cTerms));
+   if(nullptr == aTermTensorBins) {
+      LOG_0(Trace_Warning, "WARNING ExtractTermBinWeights nullptr == aTermTensorBins");
+      return Error_OutOfMemory;
+   }
+   if(size_t{0} != cTermFeatures) {
+      if(size_t{0} == cFeatures) {
+         LOG_0(Trace_Error, "ERROR ExtractTermBinWeights featureIndexes value is not a valid feature index");
+         error = Error_IllegalParamVal;
+         goto exit_error;
+      }
+      if(IsMultiplyError(sizeof(size_t), cFeatures) || IsMultiplyError(sizeof(BinReader), cSlotsMax) ||
+            IsMultiplyError(sizeof(size_t), cTermFeatures) ||
+            IsMultiplyError(sizeof(size_t), k_cBlockSamples, cSlotsMax)) {
+         LOG_0(Trace_Warning, "WARNING ExtractTermBinWeights IsMultiplyError");
+         error = Error_OutOfMemory;
+         goto exit_error;
+      }
+      aiFeatureSlots = static_cast<size_t*>(malloc(sizeof(size_t) * cFeatures));
+      aReaders = static_cast<BinReader*>(malloc(sizeof(BinReader) * cSlotsMax));
+      aTermSlots = static_cast<size_t*>(malloc(sizeof(size_t) * cTermFeatures));
+      aTermStrides = static_cast<size_t*>(malloc(sizeof(size_t) * cTermFeatures));
+      aBlockBins = static_cast<size_t*>(malloc(sizeof(size_t) * k_cBlockSamples * cSlotsMax));
+      if(nullptr == aiFeatureSlots || nullptr == aReaders || nullptr == aTermSlots || nullptr == aTermStrides ||
+            nullptr == aBlockBins) {
+         LOG_0(Trace_Warning, "WARNING ExtractTermBinWeights out of memory");
+         error = Error_OutOfMemory;
+         goto exit_error;
+      }
+      for(size_t iFeature = 0; iFeature < cFeatures; ++iFeature) {
+         aiFeatureSlots[iFeature] = k_iSlotNone;
+      }
+   }
+
+   {
+      size_t cSlots = 0;
+      size_t cBinWeights = 0;
+      size_t iTermFeature = 0;
+      for(size_t iTerm = 0; iTerm < cTerms; ++iTerm) {
+         const size_t cDimensions = static_cast<size_t>(dimensionCounts[iTerm]);
+
+         // the tensors are in C order, so the last dimension has the smallest stride
+         size_t cTensorBins = 1;
+         size_t iDimension = cDimensions;
+         while(size_t{0} != iDimension) {
+            --iDimension;
+            const IntEbm indexFeature = featureIndexes[iTermFeature + iDimension];
+            if(indexFeature < IntEbm{0} || IsConvertError<size_t>(indexFeature) ||
+                  cFeatures <= static_cast<size_t>(indexFeature)) {
+               LOG_0(Trace_Error, "ERROR ExtractTermBinWeights featureIndexes value is not a valid feature index");
+               error = Error_IllegalParamVal;
+               goto exit_error;
+            }
+            const size_t iFeature = static_cast<size_t>(indexFeature);
+
+            BinReader reader;
+            size_t cFeatureBins;
+            error = InitBinReader(static_cast<const unsigned char*>(dataSet),
+                  cSamples,
+                  cFeatures,
+                  indexFeature,
+                  &reader,
+                  &cFeatureBins);
+            if(Error_None != error) {
+               goto exit_error;
+            }
+            if(k_iSlotNone == aiFeatureSlots[iFeature]) {
+               EBM_ASSERT(cSlots < cSlotsMax);
+               aReaders[cSlots] = reader;
+               aiFeatureSlots[iFeature] = cSlots;
+               ++cSlots;
+            }
+            aTermSlots[iTermFeature + iDimension] = aiFeatureSlots[iFeature];
+            aTermStrides[iTermFeature + iDimension] = cTensorBins;
+
+            if(IsMultiplyError(cTensorBins, cFeatureBins)) {
+               LOG_0(Trace_Error, "ERROR ExtractTermBinWeights IsMultiplyError(cTensorBins, cFeatureBins)");
+               error = Error_IllegalParamVal;
+               goto exit_error;
+            }
+            cTensorBins *= cFeatureBins;
+         }
+         iTermFeature += cDimensions;
+
+         if(IsAddError(cBinWeights, cTensorBins) ||
+               IsMultiplyError(sizeof(*binWeightsOut), cBinWeights + cTensorBins)) {
+            LOG_0(Trace_Error, "ERROR ExtractTermBinWeights the term tensors are too large");
+            error = Error_IllegalParamVal;
+            goto exit_error;
+         }
+         aTermTensorBins[iTerm] = cTensorBins;
+         cBinWeights += cTensorBins;
+      }
+      memset(binWeightsOut, 0, sizeof(*binWeightsOut) * cBinWeights);
+
+      size_t iSampleBlock = 0;
+      while(cSamples != iSampleBlock) {
+         const size_t cRemaining = cSamples - iSampleBlock;
+         const size_t cBlock = cRemaining < k_cBlockSamples ? cRemaining : k_cBlockSamples;
+
+         for(size_t iSlot = 0; iSlot < cSlots; ++iSlot) {
+            BinReader* const pReader = &aReaders[iSlot];
+            size_t* const aBins = &aBlockBins[iSlot * k_cBlockSamples];
+            for(size_t i = 0; i < cBlock; ++i) {
+               aBins[i] = ReadBin(pReader);
+            }
+         }
+
+         const double* const aBlockWeights = nullptr == weights ? nullptr : &weights[iSampleBlock];
+         double* pTensor = binWeightsOut;
+         iTermFeature = 0;
+         for(size_t iTerm = 0; iTerm < cTerms; ++iTerm) {
+            const size_t cDimensions = static_cast<size_t>(dimensionCounts[iTerm]);
+            for(size_t i = 0; i < cBlock; ++i) {
+               size_t iTensor = 0;
+               for(size_t iDimension = 0; iDimension < cDimensions; ++iDimension) {
+                  iTensor += aBlockBins[aTermSlots[iTermFeature + iDimension] * k_cBlockSamples + i] *
+                        aTermStrides[iTermFeature + iDimension];
+               }
+               pTensor[iTensor] += nullptr == aBlockWeights ? 1.0 : aBlockWeights[i];
+            }
+            pTensor += aTermTensorBins[iTerm];
+            iTermFeature += cDimensions;
+         }
+         iSampleBlock += cBlock;
+      }
+   }
+
+   LOG_0(Trace_Info, "Exited ExtractTermBinWeights");
+
+exit_error:
+   free(aBlockBins);
+   free(aTermStrides);
+   free(aTermSlots);
+   free(aReaders);
+   free(aiFeatureSlots);
+   free(aTermTensorBins);
+   return error;
+}
+
+// A shared dataset can hold the same feature several times at different bin resolutions.  AppendDataSetSubset builds
+// a dataset from the packed bins of some of those columns plus every weight and target, which lets each stage of a fit
+// take the resolution it needs without discretizing the raw data again.  The sections of a shared dataset do not
+// contain any absolute positions, so they are copied as-is and only the header offsets are rebuilt.
+static IntEbm AppendDataSetSubset(const unsigned char* const pDataSetShared,
+      const IntEbm countFeatures,
+      const IntEbm* const featureIndexes,
+      const size_t cBytesAllocated,
+      unsigned char* const pFillMem) {
+   EBM_ASSERT(size_t{0} == cBytesAllocated && nullptr == pFillMem || nullptr != pFillMem);
+
+   LOG_N(Trace_Info,
+         "Entered AppendDataSetSubset: "
+         "pDataSetShared=%p, "
+         "countFeatures=%" IntEbmPrintf ", "
+         "featureIndexes=%p, "
+         "cBytesAllocated=%zu, "
+         "pFillMem=%p",
+         static_cast<const void*>(pDataSetShared),
+         countFeatures,
+         static_cast<const void*>(featureIndexes),
+         cBytesAllocated,
+         static_cast<void*>(pFillMem));
+
+   if(nullptr != pFillMem && k_cBytesHeaderId <= cBytesAllocated) {
+      // until the subset is complete and checked it should not be mistaken for a valid dataset
+      reinterpret_cast<HeaderDataSetShared*>(pFillMem)->m_id = k_sharedDataSetErrorId;
+   }
+
+   size_t cBytesSource;
+   ErrorEbm error = GetDataSetSharedSize(pDataSetShared, &cBytesSource);
+   if(Error_None != error) {
+      // already logged
+      return error;
+   }
+   EBM_ASSERT(nullptr != pDataSetShared); // checked in GetDataSetSharedSize
+
+   UIntShared countSamples;
+   size_t cFeaturesSource;
+   size_t cWeights;
+   size_t cTargets;
+   error = GetDataSetSharedHeader(pDataSetShared, &countSamples, &cFeaturesSource, &cWeights, &cTargets);
+   if(Error_None != error) {
+      // already logged
+      return error;
+   }
+
+   if(countFeatures < IntEbm{0} || IsConvertError<size_t>(countFeatures)) {
+      LOG_0(Trace_Error, "ERROR AppendDataSetSubset countFeatures must be a non-negative integer");
+      return Error_IllegalParamVal;
+   }
+   const size_t cFeatures = static_cast<size_t>(countFeatures);
+   if(size_t{0} != cFeatures && nullptr == featureIndexes) {
+      LOG_0(Trace_Error, "ERROR AppendDataSetSubset nullptr == featureIndexes");
+      return Error_IllegalParamVal;
+   }
+
+   const HeaderDataSetShared* const pHeaderSource = reinterpret_cast<const HeaderDataSetShared*>(pDataSetShared);
+   const UIntShared* const aOffsetsSource = ArrayToPointer(pHeaderSource->m_offsets);
+   const size_t cOffsetsSource = cFeaturesSource + cWeights + cTargets;
+
+   // the weights and targets follow the features, so they are one contiguous block at the end of the source
+   const size_t cWeightsAndTargets = cWeights + cTargets;
+   const size_t iByteTail =
+         size_t{0} == cWeightsAndTargets ? cBytesSource : static_cast<size_t>(aOffsetsSource[cFeaturesSource]);
+   EBM_ASSERT(iByteTail <= cBytesSource);
+   const size_t cBytesTail = cBytesSource - iByteTail;
+
+   if(IsAddError(cFeatures, cWeightsAndTargets)) {
+      LOG_0(Trace_Error, "ERROR AppendDataSetSubset IsAddError(cFeatures, cWeightsAndTargets)");
+      return Error_IllegalParamVal;
+   }
+   const size_t cOffsets = cFeatures + cWeightsAndTargets;
+   if(IsConvertError<UIntShared>(cFeatures)) {
+      LOG_0(Trace_Error, "ERROR AppendDataSetSubset IsConvertError<UIntShared>(cFeatures)");
+      return Error_IllegalParamVal;
+   }
+   if(IsMultiplyError(sizeof(HeaderDataSetShared::m_offsets[0]), cOffsets)) {
+      LOG_0(Trace_Error,
+            "ERROR AppendDataSetSubset IsMultiplyError(sizeof(HeaderDataSetShared::m_offsets[0]), cOffsets)");
+      return Error_IllegalParamVal;
+   }
+   const size_t cBytesOffsets = sizeof(HeaderDataSetShared::m_offsets[0]) * cOffsets;
+   if(IsAddError(k_cBytesHeaderNoOffset, cBytesOffsets)) {
+      LOG_0(Trace_Error, "ERROR AppendDataSetSubset IsAddError(k_cBytesHeaderNoOffset, cBytesOffsets)");
+      return Error_IllegalParamVal;
+   }
+   const size_t cBytesHeader = k_cBytesHeaderNoOffset + cBytesOffsets;
+
+   size_t iByteCur = cBytesHeader;
+   for(size_t iFeature = 0; iFeature < cFeatures; ++iFeature) {
+      const IntEbm indexFeature = featureIndexes[iFeature];
+      if(indexFeature < IntEbm{0} || IsConvertError<size_t>(indexFeature) ||
+            cFeaturesSource <= static_cast<size_t>(indexFeature)) {
+         LOG_0(Trace_Error, "ERROR AppendDataSetSubset featureIndexes value must be a feature of the dataSet");
+         return Error_IllegalParamVal;
+      }
+      const size_t iFeatureSource = static_cast<size_t>(indexFeature);
+      const size_t iByteSection = static_cast<size_t>(aOffsetsSource[iFeatureSource]);
+      const size_t iByteSectionEnd = iFeatureSource + size_t{1} == cOffsetsSource ?
+            cBytesSource :
+            static_cast<size_t>(aOffsetsSource[iFeatureSource + size_t{1}]);
+      EBM_ASSERT(iByteSection < iByteSectionEnd);
+      const size_t cBytesSection = iByteSectionEnd - iByteSection;
+
+      if(nullptr != pFillMem) {
+         if(IsConvertError<UIntShared>(iByteCur)) {
+            LOG_0(Trace_Error, "ERROR AppendDataSetSubset IsConvertError<UIntShared>(iByteCur)");
+            return Error_IllegalParamVal;
+         }
+         if(cBytesAllocated < iByteCur || cBytesAllocated - iByteCur < cBytesSection) {
+            LOG_0(Trace_Error, "ERROR AppendDataSetSubset cBytesAllocated too small");
+            return Error_IllegalParamVal;
+         }
+         ArrayToPointer(reinterpret_cast<HeaderDataSetShared*>(pFillMem)->m_offsets)[iFeature] =
+               static_cast<UIntShared>(iByteCur);
+         memcpy(pFillMem + iByteCur, pDataSetShared + iByteSection, cBytesSection);
+      }
+
+      if(IsAddError(iByteCur, cBytesSection)) {
+         LOG_0(Trace_Error, "ERROR AppendDataSetSubset IsAddError(iByteCur, cBytesSection)");
+         return Error_IllegalParamVal;
+      }
+      iByteCur += cBytesSection;
+   }
+
+   if(IsAddError(iByteCur, cBytesTail)) {
+      LOG_0(Trace_Error, "ERROR AppendDataSetSubset IsAddError(iByteCur, cBytesTail)");
+      return Error_IllegalParamVal;
+   }
+   const size_t cBytesTotal = iByteCur + cBytesTail;
+   if(IsConvertError<UIntShared>(cBytesTotal) || IsConvertError<IntEbm>(cBytesTotal)) {
+      LOG_0(Trace_Error, "ERROR AppendDataSetSubset cBytesTotal is outside the range of a valid size");
+      return Error_OutOfMemory;
+   }
+
+   if(nullptr == pFillMem) {
+      return static_cast<IntEbm>(cBytesTotal);
+   }
+
+   if(cBytesAllocated != cBytesTotal) {
+      LOG_0(Trace_Error, "ERROR AppendDataSetSubset buffer size and fill size do not agree");
+      return Error_IllegalParamVal;
+   }
+
+   HeaderDataSetShared* const pHeaderDataSetShared = reinterpret_cast<HeaderDataSetShared*>(pFillMem);
+   pHeaderDataSetShared->m_id = k_sharedDataSetWorkingId;
+   pHeaderDataSetShared->m_cSamples = countSamples;
+   pHeaderDataSetShared->m_cFeatures = static_cast<UIntShared>(cFeatures);
+   pHeaderDataSetShared->m_cWeights = pHeaderSource->m_cWeights;
+   pHeaderDataSetShared->m_cTargets = pHeaderSource->m_cTargets;
+
+   if(size_t{0} != cWeightsAndTargets) {
+      // the weight and target sections keep their relative positions, so shift their offsets by the same amount
+      UIntShared* pOffset = ArrayToPointer(pHeaderDataSetShared->m_offsets) + cFeatures;
+      const UIntShared* pOffsetSource = aOffsetsSource + cFeaturesSource;
+      const UIntShared* const pOffsetSourceEnd = aOffsetsSource + cOffsetsSource;
+      do {
+         *pOffset = static_cast<UIntShared>(static_cast<size_t>(*pOffsetSource) - iByteTail + iByteCur);
+         ++pOffset;
+         ++pOffsetSource;
+      } while(pOffsetSourceEnd != pOffsetSource);
+      memcpy(pFillMem + iByteCur, pDataSetShared + iByteTail, cBytesTail);
+   }
+
+   error = LockDataSetShared(cBytesAllocated, pFillMem);
+   if(Error_None != error) {
+      return error;
+   }
+
+   LOG_0(Trace_Info, "Exited AppendDataSetSubset");
+   return Error_None;
+}
+
+EBM_API_BODY IntEbm EBM_CALLING_CONVENTION MeasureDataSetSubset(
+      const void* dataSet, IntEbm countFeatures, const IntEbm* featureIndexes) {
+   return AppendDataSetSubset(static_cast<const unsigned char*>(dataSet), countFeatures, featureIndexes, 0, nullptr);
+}
+
+EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION FillDataSetSubset(const void* dataSet,
+      IntEbm countFeatures,
+      const IntEbm* featureIndexes,
+      IntEbm countBytesAllocated,
+      void* fillMem) {
+   if(nullptr == fillMem) {
+      LOG_0(Trace_Error, "ERROR FillDataSetSubset nullptr == fillMem");
+      return Error_IllegalParamVal;
+   }
+
+   if(IsConvertError<size_t>(countBytesAllocated)) {
+      LOG_0(Trace_Error, "ERROR FillDataSetSubset countBytesAllocated is outside the range of a valid size");
+      return Error_IllegalParamVal;
+   }
+   const size_t cBytesAllocated = static_cast<size_t>(countBytesAllocated);
+
+   const IntEbm ret = AppendDataSetSubset(static_cast<const unsigned char*>(dataSet),
+         countFeatures,
+         featureIndexes,
+         cBytesAllocated,
+         static_cast<unsigned char*>(fillMem));
+   return static_cast<ErrorEbm>(ret);
+}
+
 } // namespace DEFINED_ZONE_NAME
@@ -28,6 +28,9 @@ static_assert(std::is_standard_layout<SparseFeatureDataSetSharedEntry>::value,
 static_assert(std::is_trivial<SparseFeatureDataSetSharedEntry>::value,
       "These structs are shared between processes, so they definetly need to be standard layout and trivial");
 
+// GetDataSetSharedSize walks a finished shared dataset to find how many bytes it occupies
+extern ErrorEbm GetDataSetSharedSize(const unsigned char* const pDataSetShared, size_t* const pcBytesOut);
+
 extern ErrorEbm GetDataSetSharedHeader(const unsigned char* const pDataSetShared,
       UIntShared* const pcSamplesOut,
       size_t* const pcFeaturesOut,
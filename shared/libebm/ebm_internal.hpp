@@ -33,6 +33,17 @@ typedef double FloatCalc;
 typedef double FloatScore;
 typedef double FloatPrecomp;
 
+// nominal features order their categories by gradient/hessian ratio.  We compute each ratio once into a compact array
+// of these keys and sort that instead of comparing through pointers to the much larger Bin structs.
+struct CategoricalSortKey {
+   FloatCalc m_key;
+   void* m_pBin;
+};
+static_assert(std::is_standard_layout<CategoricalSortKey>::value,
+      "We use the struct hack in several places, so disallow non-standard_layout types in general");
+static_assert(std::is_trivial<CategoricalSortKey>::value,
+      "We use memcpy in several places, so disallow non-trivial types in general");
+
 // TODO: put a list of all the epilon constants that we use here throughout (use 1e-7 format).  Make it a percentage
 // based on the data type
 //   minimum eplison from 1 + minimal_change.  If we can make it a constant, then do that, or make it a percentage of a
@@ -216,6 +216,7 @@ typedef struct _InteractionHandle {
 #define CreateBoosterFlags_DifferentialPrivacy (CREATE_BOOSTER_FLAGS_CAST(0x00000001))
 #define CreateBoosterFlags_UseApprox           (CREATE_BOOSTER_FLAGS_CAST(0x00000002))
 #define CreateBoosterFlags_BinaryAsMulticlass  (CREATE_BOOSTER_FLAGS_CAST(0x00000004))
+#define CreateBoosterFlags_PackByFeature       (CREATE_BOOSTER_FLAGS_CAST(0x00000008))
 
 #define TermBoostFlags_Default             (TERM_BOOST_FLAGS_CAST(0x00000000))
 #define TermBoostFlags_PurifyGain          (TERM_BOOST_FLAGS_CAST(0x00000001))
@@ -229,6 +230,10 @@ typedef struct _InteractionHandle {
 #define TermBoostFlags_MissingHigh         (TERM_BOOST_FLAGS_CAST(0x00000100))
 #define TermBoostFlags_MissingSeparate     (TERM_BOOST_FLAGS_CAST(0x00000200))
 #define TermBoostFlags_Corners             (TERM_BOOST_FLAGS_CAST(0x00000400))
+#define TermBoostFlags_RandomMinLeafHard   (TERM_BOOST_FLAGS_CAST(0x00000800))
+#define TermBoostFlags_RandomMinLeafSoft   (TERM_BOOST_FLAGS_CAST(0x00001000))
+#define TermBoostFlags_Straight            (TERM_BOOST_FLAGS_CAST(0x00002000))
+#define TermBoostFlags_DeepTree            (TERM_BOOST_FLAGS_CAST(0x00004000))
 
 #define CreateInteractionFlags_Default             (CREATE_INTERACTION_FLAGS_CAST(0x00000000))
 #define CreateInteractionFlags_DifferentialPrivacy (CREATE_INTERACTION_FLAGS_CAST(0x00000001))
@@ -305,6 +310,16 @@ typedef struct _InteractionHandle {
 #define Link_inverse_square (LINK_CAST(103)) // Inverse Gaussian regression
 #define Link_sqrt           (LINK_CAST(104)) // Square root regression
 
+// Threading: the functions below can be called from any number of threads at once as long as each BoosterHandle and
+// InteractionHandle is used by only one thread at a time.  Independent handles share nothing except the log counters,
+// the log callback, and the API recorder, which are synchronized internally (the counters are decremented atomically
+// and the recorder serializes its writes behind its own lock).  Handles from CreateBoosterView share their booster's
+// read-only data, but each view owns its scratch space, including the buffers that compose term data for boosters
+// created with CreateBoosterFlags_PackByFeature, so GenerateTermUpdate can run on several views at once.
+// ApplyTermUpdate changes the shared booster and must not overlap any other call on the views of that booster.
+// SetLogCallback and SetTraceLevel change process wide settings and must not be called while other threads are inside
+// the library.  The log callback is never invoked by two threads at the same time.
+
 // All our logging messages are pure ASCII (127 values), and therefore also conform to UTF-8
 typedef void(EBM_CALLING_CONVENTION* LogCallbackFunction)(TraceEbm traceLevel, const char* message);
 
@@ -313,11 +328,49 @@ EBM_API_INCLUDE void EBM_CALLING_CONVENTION SetLogCallback(LogCallbackFunction l
 EBM_API_INCLUDE void EBM_CALLING_CONVENTION SetTraceLevel(TraceEbm traceLevel);
 EBM_API_INCLUDE const char* EBM_CALLING_CONVENTION GetTraceLevelString(TraceEbm traceLevel);
 
+// ReplayRecording calls replayCallback after each call it re-executes with the time that call took
+typedef void(EBM_CALLING_CONVENTION* ReplayCallbackFunction)(
+      IntEbm indexCall, const char* apiName, ErrorEbm error, double seconds);
+
+// StartRecording writes the booster and interaction detector calls made after it into a binary file, including the
+// shared datasets they use, so that ReplayRecording can re-execute them natively.  The file is only readable on the
+// same platform.  Recording is off by default and only one recording can be active at a time.
+EBM_API_INCLUDE ErrorEbm EBM_CALLING_CONVENTION StartRecording(const char* filename);
+EBM_API_INCLUDE ErrorEbm EBM_CALLING_CONVENTION StopRecording(void);
+EBM_API_INCLUDE ErrorEbm EBM_CALLING_CONVENTION ReplayRecording(
+      const char* filename, ReplayCallbackFunction replayCallback);
+
 EBM_API_INCLUDE void EBM_CALLING_CONVENTION CleanFloats(IntEbm count, double* valsInOut);
 EBM_API_INCLUDE ErrorEbm EBM_CALLING_CONVENTION SafeMean(
       IntEbm countBags, IntEbm countTensorBins, const double* vals, const double* weights, double* tensorOut);
 EBM_API_INCLUDE ErrorEbm EBM_CALLING_CONVENTION SafeStandardDeviation(
       IntEbm countBags, IntEbm countTensorBins, const double* vals, const double* weights, double* tensorOut);
+EBM_API_INCLUDE ErrorEbm EBM_CALLING_CONVENTION FinalizeBaggedTerms(IntEbm countBags,
+      IntEbm countScores,
+      IntEbm countTerms,
+      const IntEbm* dimensionCounts,
+      const IntEbm* binCounts,
+      const double* binWeights,
+      const double* bagWeights,
+      IntEbm countThreads,
+      double* bagInterceptsInOut,
+      double* bagScoresInOut,
+      double* termScoresOut,
+      double* standardDeviationsOut);
+
+// MonotonizeBaggedTerm applies weighted isotonic regression to every bag of a univariate term.  The first (missing)
+// and last (unseen) bins are left out of the ordered range.  It then recomputes the term scores and the standard
+// deviations across the bags.  The passthrough fraction of any change to the mean moves into bagInterceptsInOut.
+EBM_API_INCLUDE ErrorEbm EBM_CALLING_CONVENTION MonotonizeBaggedTerm(IntEbm countBags,
+      IntEbm countBins,
+      BoolEbm isIncreasing,
+      double passthrough,
+      const double* binWeights,
+      const double* bagWeights,
+      double* bagInterceptsInOut,
+      double* bagScoresInOut,
+      double* termScoresOut,
+      double* standardDeviationsOut);
 
 EBM_API_INCLUDE IntEbm EBM_CALLING_CONVENTION MeasureRNG(void);
 EBM_API_INCLUDE void EBM_CALLING_CONVENTION InitRNG(SeedEbm seed, void* rngOut);
@@ -372,6 +425,14 @@ EBM_API_INCLUDE ErrorEbm EBM_CALLING_CONVENTION Discretize(IntEbm countSamples,
       IntEbm countCuts,
       const double* cutsLowerBoundInclusive,
       IntEbm* binIndexesOut);
+// DiscretizeCached returns the same bins as Discretize, but resolves repeated exact values and integer values inside the
+// cut range from per-call tables instead of searching.  countCacheHitsOut (optional) receives the number of table hits.
+EBM_API_INCLUDE ErrorEbm EBM_CALLING_CONVENTION DiscretizeCached(IntEbm countSamples,
+      const double* featureVals,
+      IntEbm countCuts,
+      const double* cutsLowerBoundInclusive,
+      IntEbm* binIndexesOut,
+      IntEbm* countCacheHitsOut);
 
 EBM_API_INCLUDE IntEbm EBM_CALLING_CONVENTION MeasureDataSetHeader(
       IntEbm countFeatures, IntEbm countWeights, IntEbm countTargets);
@@ -416,6 +477,29 @@ EBM_API_INCLUDE ErrorEbm EBM_CALLING_CONVENTION ExtractBinCounts(
       const void* dataSet, IntEbm countFeaturesVerify, IntEbm* binCountsOut);
 EBM_API_INCLUDE ErrorEbm EBM_CALLING_CONVENTION ExtractTargetClasses(
       const void* dataSet, IntEbm countTargetsVerify, IntEbm* classCountsOut);
+EBM_API_INCLUDE ErrorEbm EBM_CALLING_CONVENTION ScoreDataSet(const void* dataSet,
+      const BagEbm* bag,
+      IntEbm countTerms,
+      const IntEbm* dimensionCounts,
+      const IntEbm* featureIndexes,
+      IntEbm countScores,
+      const double* termScores,
+      double* scoresOut);
+EBM_API_INCLUDE ErrorEbm EBM_CALLING_CONVENTION ExtractTermBinWeights(const void* dataSet,
+      const double* weights,
+      IntEbm countTerms,
+      const IntEbm* dimensionCounts,
+      const IntEbm* featureIndexes,
+      double* binWeightsOut);
+// a dataSet may hold each feature at several bin resolutions.  MeasureDataSetSubset and FillDataSetSubset copy the
+// binned columns at featureIndexes (in that order) and all weights and targets into a new dataset
+EBM_API_INCLUDE IntEbm EBM_CALLING_CONVENTION MeasureDataSetSubset(
+      const void* dataSet, IntEbm countFeatures, const IntEbm* featureIndexes);
+EBM_API_INCLUDE ErrorEbm EBM_CALLING_CONVENTION FillDataSetSubset(const void* dataSet,
+      IntEbm countFeatures,
+      const IntEbm* featureIndexes,
+      IntEbm countBytesAllocated,
+      void* fillMem);
 
 EBM_API_INCLUDE ErrorEbm EBM_CALLING_CONVENTION SampleWithoutReplacement(
       void* rng, IntEbm countTrainingSamples, IntEbm countValidationSamples, BagEbm* bagOut);
@@ -425,6 +509,23 @@ EBM_API_INCLUDE ErrorEbm EBM_CALLING_CONVENTION SampleWithoutReplacementStratifi
       IntEbm countValidationSamples,
       const IntEbm* targets,
       BagEbm* bagOut);
+// A bag plan holds countBags bags packed at 2 bits per sample, where each entry is left out (0), training (+1) or
+// validation (-1).  rngs holds countBags consecutive RNG states of MeasureRNG bytes, one per bag, or is nullptr for a
+// non-deterministic plan.  Without targets or groups every bag matches SampleWithoutReplacement, and with targets it
+// matches SampleWithoutReplacementStratified.  With groups, which cannot be combined with targets, whole groups are
+// moved to validation in a random order until it holds at least countValidationSamples samples.
+EBM_API_INCLUDE IntEbm EBM_CALLING_CONVENTION MeasureBagPlan(IntEbm countBags, IntEbm countSamples);
+EBM_API_INCLUDE ErrorEbm EBM_CALLING_CONVENTION GenerateBagPlan(void* rngs,
+      IntEbm countBags,
+      IntEbm countTrainingSamples,
+      IntEbm countValidationSamples,
+      IntEbm countClasses,
+      const IntEbm* targets,
+      IntEbm countGroups,
+      const IntEbm* groups,
+      IntEbm countBytesAllocated,
+      void* bagPlanOut);
+EBM_API_INCLUDE ErrorEbm EBM_CALLING_CONVENTION ExtractBag(const void* bagPlan, IntEbm indexBag, BagEbm* bagOut);
 
 EBM_API_INCLUDE ErrorEbm EBM_CALLING_CONVENTION DetermineTask(const char* objective, TaskEbm* taskOut);
 EBM_API_INCLUDE const char* EBM_CALLING_CONVENTION GetTaskStr(TaskEbm task);
@@ -438,6 +539,15 @@ EBM_API_INCLUDE ErrorEbm EBM_CALLING_CONVENTION DetermineLinkFunction(LinkFlags
       double* linkParamOut);
 EBM_API_INCLUDE const char* EBM_CALLING_CONVENTION GetLinkFunctionStr(LinkEbm link);
 EBM_API_INCLUDE LinkEbm EBM_CALLING_CONVENTION GetLinkFunctionInt(const char* link);
+// InverseLink converts scores to predictions in place.  scoresInOut is C ordered [countSamples][countScores].  Binary
+// links (logit, probit, etc) return the probability of the positive class.  The CPU path is double precision while
+// the SIMD paths chosen by acceleration compute in float and are accurate to around 1e-6 relative.
+EBM_API_INCLUDE ErrorEbm EBM_CALLING_CONVENTION InverseLink(AccelerationFlags acceleration,
+      LinkEbm link,
+      double linkParam,
+      IntEbm countSamples,
+      IntEbm countScores,
+      double* scoresInOut);
 
 EBM_API_INCLUDE ErrorEbm EBM_CALLING_CONVENTION CreateBooster(void* rng,
       const void* dataSet,
@@ -454,9 +564,38 @@ EBM_API_INCLUDE ErrorEbm EBM_CALLING_CONVENTION CreateBooster(void* rng,
       const char* objective,
       const double* experimentalParams,
       BoosterHandle* boosterHandleOut);
+// CreateBoosterFromBagPlan is CreateBooster with the bag taken from row indexBag of a plan made by GenerateBagPlan
+EBM_API_INCLUDE ErrorEbm EBM_CALLING_CONVENTION CreateBoosterFromBagPlan(void* rng,
+      const void* dataSet,
+      const double* intercept,
+      const void* bagPlan,
+      IntEbm indexBag,
+      const double* initScores,
+      IntEbm countTerms,
+      const IntEbm* dimensionCounts,
+      const IntEbm* featureIndexes,
+      IntEbm countInnerBags,
+      CreateBoosterFlags flags,
+      AccelerationFlags acceleration,
+      const char* objective,
+      const double* experimentalParams,
+      BoosterHandle* boosterHandleOut);
 EBM_API_INCLUDE ErrorEbm EBM_CALLING_CONVENTION CreateBoosterView(
       BoosterHandle boosterHandle, BoosterHandle* boosterHandleViewOut);
 EBM_API_INCLUDE void EBM_CALLING_CONVENTION FreeBooster(BoosterHandle boosterHandle);
+// with TermBoostFlags_RandomSplits, randomRetries random cut sets are drawn and the one with the best gain is kept.
+// randomRetries of 0 is treated as 1, and negative values are adjusted to 1 with a warning.  Picking a cut set by gain
+// uses the data without privacy accounting, so boosters made with CreateBoosterFlags_DifferentialPrivacy return
+// Error_IllegalParamVal for randomRetries above 1.
+// With either RandomMinLeaf flag, the cut set with the fewest leaves below minSamplesLeaf is kept, and gain only
+// breaks ties between cut sets with the same count.  With TermBoostFlags_RandomMinLeafHard, if even that cut set has a
+// leaf below minSamplesLeaf, the whole tensor gets a single update.  TermBoostFlags_RandomMinLeafSoft uses the cut
+// set anyway.
+// with TermBoostFlags_Straight, pairs get at most one cut per dimension chosen by the same search that scores pairs
+// in CalcInteractionStrength. Other terms are unaffected
+// with TermBoostFlags_DeepTree, multi-dimensional terms grow a best-first tree where dimension i can be split up to
+// leavesMax[i] - 1 times across all branches, so a pair with leavesMax of {16, 16} gets up to 31 leaves.
+// TermBoostFlags_Corners, TermBoostFlags_Straight and TermBoostFlags_DeepTree cannot be combined
 EBM_API_INCLUDE ErrorEbm EBM_CALLING_CONVENTION GenerateTermUpdate(void* rng,
       BoosterHandle boosterHandle,
       IntEbm indexTerm,
@@ -471,6 +610,7 @@ EBM_API_INCLUDE ErrorEbm EBM_CALLING_CONVENTION GenerateTermUpdate(void* rng,
       double categoricalSmoothing,
       IntEbm maxCategoricalThreshold,
       double categoricalInclusionPercent,
+      IntEbm randomRetries,
       const IntEbm* leavesMax,
       const MonotoneDirection* direction,
       double* avgGainOut);
@@ -487,6 +627,15 @@ EBM_API_INCLUDE ErrorEbm EBM_CALLING_CONVENTION GetBestTermScores(
       BoosterHandle boosterHandle, IntEbm indexTerm, double* termScoresTensorOut);
 EBM_API_INCLUDE ErrorEbm EBM_CALLING_CONVENTION GetCurrentTermScores(
       BoosterHandle boosterHandle, IntEbm indexTerm, double* termScoresTensorOut);
+// SerializeBooster saves what boosting has changed since CreateBooster, along with the caller's rng if it is not
+// nullptr. DeserializeBooster loads it into a booster created with the same CreateBooster arguments and restores the
+// rng into rngOut, so boosting continues exactly as it would have without the interruption.  Call them between
+// ApplyTermUpdate and the next GenerateTermUpdate since a pending term update is not saved.
+EBM_API_INCLUDE IntEbm EBM_CALLING_CONVENTION MeasureSerializedBooster(BoosterHandle boosterHandle);
+EBM_API_INCLUDE ErrorEbm EBM_CALLING_CONVENTION SerializeBooster(
+      BoosterHandle boosterHandle, void* rng, IntEbm countBytesAllocated, void* stateOut);
+EBM_API_INCLUDE ErrorEbm EBM_CALLING_CONVENTION DeserializeBooster(
+      BoosterHandle boosterHandle, IntEbm countBytes, const void* state, void* rngOut);
 
 EBM_API_INCLUDE ErrorEbm EBM_CALLING_CONVENTION CreateInteractionDetector(const void* dataSet,
       const double* intercept,
@@ -498,6 +647,16 @@ EBM_API_INCLUDE ErrorEbm EBM_CALLING_CONVENTION CreateInteractionDetector(const
       const char* objective,
       const double* experimentalParams,
       InteractionHandle* interactionHandleOut);
+EBM_API_INCLUDE ErrorEbm EBM_CALLING_CONVENTION CreateInteractionDetectorFromBagPlan(const void* dataSet,
+      const double* intercept,
+      const void* bagPlan,
+      IntEbm indexBag,
+      const double* initScores,
+      CreateInteractionFlags flags,
+      AccelerationFlags acceleration,
+      const char* objective,
+      const double* experimentalParams,
+      InteractionHandle* interactionHandleOut);
 EBM_API_INCLUDE void EBM_CALLING_CONVENTION FreeInteractionDetector(InteractionHandle interactionHandle);
 EBM_API_INCLUDE ErrorEbm EBM_CALLING_CONVENTION CalcInteractionStrength(InteractionHandle interactionHandle,
       IntEbm countDimensions,
@@ -510,6 +669,21 @@ EBM_API_INCLUDE ErrorEbm EBM_CALLING_CONVENTION CalcInteractionStrength(Interact
       double regLambda,
       double maxDeltaStep,
       double* avgInteractionStrengthOut);
+// CalcInteractionStrengths evaluates many terms against one detector. The terms are pulled dynamically from a shared
+// queue by countThreads native threads (0 means one per core) and the strengths are returned in input order.
+EBM_API_INCLUDE ErrorEbm EBM_CALLING_CONVENTION CalcInteractionStrengths(InteractionHandle interactionHandle,
+      IntEbm countTerms,
+      const IntEbm* dimensionCounts,
+      const IntEbm* featureIndexes,
+      CalcInteractionFlags flags,
+      IntEbm maxCardinality,
+      IntEbm minSamplesLeaf,
+      double minHessian,
+      double regAlpha,
+      double regLambda,
+      double maxDeltaStep,
+      IntEbm countThreads,
+      double* avgInteractionStrengthsOut);
 
 #ifdef __cplusplus
 } // extern "C"
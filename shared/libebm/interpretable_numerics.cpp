@@ -7,6 +7,9 @@
 #include <stddef.h> // size_t, ptrdiff_t
 #include <limits> // std::numeric_limits
 #include <string.h> // strcpy, strchr, memmove, memcpy
+#include <atomic>
+#include <thread>
+#include <vector>
 
 #include "libebm.h"
 #include "logging.h" // EBM_ASSERT
@@ -1480,7 +1483,46 @@ static double Mean(const size_t cSamples,
    return mean;
 }
 
-// we don't care if an extra log message is outputted due to the non-atomic nature of the decrement to this value
+static double SafeBagMean(
+      const size_t cBags, const size_t cStride, const double* const aVals, const double* const aWeights) {
+   size_t cNaN;
+   size_t cPosInf;
+   size_t cNegInf;
+   double mean = Mean(cBags, cStride, aVals, aWeights, &cNaN, &cPosInf, &cNegInf);
+   // we use NaN as a user indicator that the prediction is illegal, so do everything possible
+   // to avoid creating new NaN values. If we have more +inf than -inf then it's +inf, else -inf
+   // If we have equal numbers of +inf and -inf, use +inf because that's more likely to be noticed.
+   if(0 != cNaN) {
+      mean = std::numeric_limits<double>::quiet_NaN();
+   } else if(0 != cPosInf) {
+      if(cNegInf <= cPosInf) {
+         mean = std::numeric_limits<double>::infinity();
+      } else {
+         mean = -std::numeric_limits<double>::infinity();
+      }
+   } else if(0 != cNegInf) {
+      mean = -std::numeric_limits<double>::infinity();
+   }
+   return mean;
+}
+
+static double SafeBagStddev(
+      const size_t cBags, const size_t cStride, const double* const aVals, const double* const aWeights) {
+   size_t cNaN;
+   size_t cInf;
+   double stddev = Stddev(cBags, cStride, aVals, aWeights, &cNaN, &cInf);
+   // we use NaN as a user indicator that the prediction is illegal, so do everything possible
+   // to avoid creating new NaN values.
+   if(0 != cNaN) {
+      stddev = std::numeric_limits<double>::quiet_NaN();
+   } else if(0 != cInf) {
+      // Even if they are all +inf or -inf make standard deviation +inf since inf is not well defined.
+      stddev = std::numeric_limits<double>::infinity();
+   }
+   return stddev;
+}
+
+// LOG_COUNTED_N decrements this value atomically, so concurrent callers never log more than this many messages
 static int g_cLogEnterSafeMeanCount = 25;
 static int g_cLogExitSafeMeanCount = 25;
 
@@ -1542,25 +1584,7 @@ EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION SafeMean(
    double* pOut = tensorOut;
    const double* const pOutEnd = tensorOut + cTensorBins;
    do {
-      size_t cNaN;
-      size_t cPosInf;
-      size_t cNegInf;
-      double mean = Mean(cBags, cTensorBins, pVal, weights, &cNaN, &cPosInf, &cNegInf);
-      // we use NaN as a user indicator that the prediction is illegal, so do everything possible
-      // to avoid creating new NaN values. If we have more +inf than -inf then it's +inf, else -inf
-      // If we have equal numbers of +inf and -inf, use +inf because that's more likely to be noticed.
-      if(0 != cNaN) {
-         mean = std::numeric_limits<double>::quiet_NaN();
-      } else if(0 != cPosInf) {
-         if(cNegInf <= cPosInf) {
-            mean = std::numeric_limits<double>::infinity();
-         } else {
-            mean = -std::numeric_limits<double>::infinity();
-         }
-      } else if(0 != cNegInf) {
-         mean = -std::numeric_limits<double>::infinity();
-      }
-      *pOut = mean;
+      *pOut = SafeBagMean(cBags, cTensorBins, pVal, weights);
 
       ++pVal;
       ++pOut;
@@ -1571,7 +1595,7 @@ EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION SafeMean(
    return Error_None;
 }
 
-// we don't care if an extra log message is outputted due to the non-atomic nature of the decrement to this value
+// LOG_COUNTED_N decrements this value atomically, so concurrent callers never log more than this many messages
 static int g_cLogEnterSafeStandardDeviationCount = 25;
 static int g_cLogExitSafeStandardDeviationCount = 25;
 
@@ -1633,18 +1657,7 @@ EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION SafeStandardDeviation(
    double* pOut = tensorOut;
    const double* const pOutEnd = tensorOut + cTensorBins;
    do {
-      size_t cNaN;
-      size_t cInf;
-      double stddev = Stddev(cBags, cTensorBins, pVal, weights, &cNaN, &cInf);
-      // we use NaN as a user indicator that the prediction is illegal, so do everything possible
-      // to avoid creating new NaN values.
-      if(0 != cNaN) {
-         stddev = std::numeric_limits<double>::quiet_NaN();
-      } else if(0 != cInf) {
-         // Even if they are all +inf or -inf make standard deviation +inf since inf is not well defined.
-         stddev = std::numeric_limits<double>::infinity();
-      }
-      *pOut = stddev;
+      *pOut = SafeBagStddev(cBags, cTensorBins, pVal, weights);
 
       ++pVal;
       ++pOut;
@@ -1655,7 +1668,678 @@ EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION SafeStandardDeviation(
    return Error_None;
 }
 
-// we don't care if an extra log message is outputted due to the non-atomic nature of the decrement to this value
+struct FinalizeWorkQueue final {
+   // every worker, including the calling thread, pulls the next term index from m_iTermNext.  Terms are
+   // independent since the intercept transfer is deferred until all the workers have joined
+
+   FinalizeWorkQueue() = default;
+
+   size_t m_cBags;
+   size_t m_cScores;
+   size_t m_cTerms;
+   size_t m_cTensorBinsMax;
+   const IntEbm* m_aDimensionCounts;
+   const IntEbm* m_aBinCounts;
+   const size_t* m_aiBinCountStarts;
+   const size_t* m_aiTensorStarts;
+   const double* m_aBinWeights;
+   const double* m_aBagWeights;
+   double* m_aBagScores;
+   double* m_aTermScoresOut;
+   double* m_aStandardDeviationsOut;
+   double* m_aMeans;
+
+   std::atomic_size_t m_iTermNext;
+   std::atomic<ErrorEbm> m_error;
+};
+
+static void FinalizeBaggedTerm(const FinalizeWorkQueue* const pQueue,
+      const size_t iTerm,
+      double* const aScratchVals,
+      double* const aScratchWeights) noexcept {
+   EBM_ASSERT(nullptr != pQueue);
+   EBM_ASSERT(iTerm < pQueue->m_cTerms);
+   EBM_ASSERT(nullptr != aScratchVals);
+   EBM_ASSERT(nullptr != aScratchWeights);
+
+   const size_t cBags = pQueue->m_cBags;
+   const size_t cScores = pQueue->m_cScores;
+   const size_t cDimensions = static_cast<size_t>(pQueue->m_aDimensionCounts[iTerm]);
+   const IntEbm* const aBinCounts = pQueue->m_aBinCounts + pQueue->m_aiBinCountStarts[iTerm];
+   const size_t iTensorStart = pQueue->m_aiTensorStarts[iTerm];
+   const size_t cTensorBins = pQueue->m_aiTensorStarts[iTerm + 1] - iTensorStart;
+   const size_t cCells = cTensorBins * cScores;
+
+   const double* const aWeights = pQueue->m_aBinWeights + iTensorStart;
+   double* const aBagScores = pQueue->m_aBagScores + iTensorStart * cScores * cBags;
+   double* const aMeans = pQueue->m_aMeans + iTerm * cBags * cScores;
+
+   // the tensors are in C order, so the last dimension is the fastest changing one
+   size_t aStrides[k_cDimensionsMax];
+   size_t stride = 1;
+   size_t iDimension = cDimensions;
+   while(size_t{0} != iDimension) {
+      --iDimension;
+      aStrides[iDimension] = stride;
+      stride *= static_cast<size_t>(aBinCounts[iDimension]);
+   }
+   EBM_ASSERT(cTensorBins == stride);
+
+   // if the missing (first) or unseen (last) slice of a dimension has zero weight then whatever boosting put there
+   // is meaningless, so zero it for interpretability
+   bool aZeroLow[k_cDimensionsMax];
+   bool aZeroHigh[k_cDimensionsMax];
+   for(iDimension = 0; iDimension < cDimensions; ++iDimension) {
+      const size_t cBins = static_cast<size_t>(aBinCounts[iDimension]);
+      double sumLow = 0.0;
+      double sumHigh = 0.0;
+      for(size_t iBin = 0; iBin < cTensorBins; ++iBin) {
+         const size_t iCoordinate = iBin / aStrides[iDimension] % cBins;
+         if(size_t{0} == iCoordinate) {
+            sumLow += aWeights[iBin];
+         }
+         if(cBins - size_t{1} == iCoordinate) {
+            sumHigh += aWeights[iBin];
+         }
+      }
+      aZeroLow[iDimension] = 0.0 == sumLow;
+      aZeroHigh[iDimension] = 0.0 == sumHigh;
+   }
+
+   for(size_t iBag = 0; iBag < cBags; ++iBag) {
+      double* const aScores = aBagScores + iBag * cCells;
+      for(size_t iScore = 0; iScore < cScores; ++iScore) {
+         // non-finite scores are excluded from the weighted mean by zeroing both their value and weight
+         double sumWeights = 0.0;
+         for(size_t iBin = 0; iBin < cTensorBins; ++iBin) {
+            double val = aScores[iBin * cScores + iScore];
+            double weight = aWeights[iBin];
+            if(!std::isfinite(val)) {
+               val = 0.0;
+               weight = 0.0;
+            }
+            aScratchVals[iBin] = val;
+            aScratchWeights[iBin] = weight;
+            sumWeights += weight;
+         }
+
+         double mean = 0.0;
+         if(0.0 != sumWeights) {
+            size_t cNaN;
+            size_t cPosInf;
+            size_t cNegInf;
+            mean = Mean(cTensorBins, 1, aScratchVals, aScratchWeights, &cNaN, &cPosInf, &cNegInf);
+            for(size_t iBin = 0; iBin < cTensorBins; ++iBin) {
+               aScores[iBin * cScores + iScore] -= mean;
+            }
+         }
+         aMeans[iBag * cScores + iScore] = mean;
+      }
+
+      for(iDimension = 0; iDimension < cDimensions; ++iDimension) {
+         if(aZeroLow[iDimension] || aZeroHigh[iDimension]) {
+            const size_t cBins = static_cast<size_t>(aBinCounts[iDimension]);
+            for(size_t iBin = 0; iBin < cTensorBins; ++iBin) {
+               const size_t iCoordinate = iBin / aStrides[iDimension] % cBins;
+               if((aZeroLow[iDimension] && size_t{0} == iCoordinate) ||
+                     (aZeroHigh[iDimension] && cBins - size_t{1} == iCoordinate)) {
+                  for(size_t iScore = 0; iScore < cScores; ++iScore) {
+                     aScores[iBin * cScores + iScore] = 0.0;
+                  }
+               }
+            }
+         }
+      }
+   }
+
+   double* const aTermScoresOut = pQueue->m_aTermScoresOut + iTensorStart * cScores;
+   double* const aStandardDeviationsOut = pQueue->m_aStandardDeviationsOut + iTensorStart * cScores;
+   for(size_t iCell = 0; iCell < cCells; ++iCell) {
+      aTermScoresOut[iCell] = SafeBagMean(cBags, cCells, aBagScores + iCell, pQueue->m_aBagWeights);
+      aStandardDeviationsOut[iCell] = SafeBagStddev(cBags, cCells, aBagScores + iCell, pQueue->m_aBagWeights);
+   }
+}
+
+static void FinalizeBaggedTermsWorker(FinalizeWorkQueue* const pQueue) noexcept {
+   EBM_ASSERT(nullptr != pQueue);
+
+   const size_t cTerms = pQueue->m_cTerms;
+
+   // cTensorBinsMax was checked against overflow of the byte count by the caller
+   double* const aScratch = static_cast<double*>(malloc(sizeof(double) * 2 * pQueue->m_cTensorBinsMax));
+   if(nullptr == aScratch) {
+      LOG_0(Trace_Warning, "WARNING FinalizeBaggedTermsWorker nullptr == aScratch");
+      ErrorEbm errorExpected = Error_None;
+      pQueue->m_error.compare_exchange_strong(errorExpected, Error_OutOfMemory, std::memory_order_relaxed);
+      pQueue->m_iTermNext.store(cTerms, std::memory_order_relaxed);
+      return;
+   }
+
+   while(true) {
+      // relaxed ordering is sufficient since each index is claimed by exactly one worker and the results are
+      // published to the caller by joining the threads
+      const size_t iTerm = pQueue->m_iTermNext.fetch_add(1, std::memory_order_relaxed);
+      if(cTerms <= iTerm) {
+         break;
+      }
+      FinalizeBaggedTerm(pQueue, iTerm, aScratch, aScratch + pQueue->m_cTensorBinsMax);
+   }
+
+   free(aScratch);
+}
+
+// LOG_COUNTED_N decrements this value atomically, so concurrent callers never log more than this many messages
+static int g_cLogEnterFinalizeBaggedTermsCount = 25;
+static int g_cLogExitFinalizeBaggedTermsCount = 25;
+
+EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION FinalizeBaggedTerms(IntEbm countBags,
+      IntEbm countScores,
+      IntEbm countTerms,
+      const IntEbm* dimensionCounts,
+      const IntEbm* binCounts,
+      const double* binWeights,
+      const double* bagWeights,
+      IntEbm countThreads,
+      double* bagInterceptsInOut,
+      double* bagScoresInOut,
+      double* termScoresOut,
+      double* standardDeviationsOut) {
+   LOG_COUNTED_N(&g_cLogEnterFinalizeBaggedTermsCount,
+         Trace_Info,
+         Trace_Verbose,
+         "Entered FinalizeBaggedTerms: "
+         "countBags=%" IntEbmPrintf ", "
+         "countScores=%" IntEbmPrintf ", "
+         "countTerms=%" IntEbmPrintf ", "
+         "dimensionCounts=%p, "
+         "binCounts=%p, "
+         "binWeights=%p, "
+         "bagWeights=%p, "
+         "countThreads=%" IntEbmPrintf ", "
+         "bagInterceptsInOut=%p, "
+         "bagScoresInOut=%p, "
+         "termScoresOut=%p, "
+         "standardDeviationsOut=%p",
+         countBags,
+         countScores,
+         countTerms,
+         static_cast<const void*>(dimensionCounts),
+         static_cast<const void*>(binCounts),
+         static_cast<const void*>(binWeights),
+         static_cast<const void*>(bagWeights),
+         countThreads,
+         static_cast<const void*>(bagInterceptsInOut),
+         static_cast<const void*>(bagScoresInOut),
+         static_cast<const void*>(termScoresOut),
+         static_cast<const void*>(standardDeviationsOut));
+
+   if(countBags <= IntEbm{0}) {
+      if(countBags < IntEbm{0}) {
+         LOG_0(Trace_Error, "ERROR FinalizeBaggedTerms countBags < IntEbm{0}");
+         return Error_IllegalParamVal;
+      }
+      return Error_None;
+   }
+   if(IsConvertError<size_t>(countBags)) {
+      LOG_0(Trace_Error, "ERROR FinalizeBaggedTerms IsConvertError<size_t>(countBags)");
+      return Error_IllegalParamVal;
+   }
+   const size_t cBags = static_cast<size_t>(countBags);
+
+   if(countScores <= IntEbm{0}) {
+      LOG_0(Trace_Error, "ERROR FinalizeBaggedTerms countScores <= IntEbm{0}");
+      return Error_IllegalParamVal;
+   }
+   if(IsConvertError<size_t>(countScores)) {
+      LOG_0(Trace_Error, "ERROR FinalizeBaggedTerms IsConvertError<size_t>(countScores)");
+      return Error_IllegalParamVal;
+   }
+   const size_t cScores = static_cast<size_t>(countScores);
+
+   if(countTerms <= IntEbm{0}) {
+      if(countTerms < IntEbm{0}) {
+         LOG_0(Trace_Error, "ERROR FinalizeBaggedTerms countTerms < IntEbm{0}");
+         return Error_IllegalParamVal;
+      }
+      return Error_None;
+   }
+   if(IsConvertError<size_t>(countTerms) || IsAddError(static_cast<size_t>(countTerms), size_t{1}) ||
+         IsMultiplyError(sizeof(size_t), static_cast<size_t>(countTerms) + size_t{1})) {
+      LOG_0(Trace_Warning, "WARNING FinalizeBaggedTerms countTerms too large");
+      return Error_OutOfMemory;
+   }
+   const size_t cTerms = static_cast<size_t>(countTerms);
+
+   if(nullptr == dimensionCounts) {
+      LOG_0(Trace_Error, "ERROR FinalizeBaggedTerms nullptr == dimensionCounts");
+      return Error_IllegalParamVal;
+   }
+   if(nullptr == binWeights) {
+      LOG_0(Trace_Error, "ERROR FinalizeBaggedTerms nullptr == binWeights");
+      return Error_IllegalParamVal;
+   }
+   if(nullptr == bagInterceptsInOut) {
+      LOG_0(Trace_Error, "ERROR FinalizeBaggedTerms nullptr == bagInterceptsInOut");
+      return Error_IllegalParamVal;
+   }
+   if(nullptr == bagScoresInOut) {
+      LOG_0(Trace_Error, "ERROR FinalizeBaggedTerms nullptr == bagScoresInOut");
+      return Error_IllegalParamVal;
+   }
+   if(nullptr == termScoresOut) {
+      LOG_0(Trace_Error, "ERROR FinalizeBaggedTerms nullptr == termScoresOut");
+      return Error_IllegalParamVal;
+   }
+   if(nullptr == standardDeviationsOut) {
+      LOG_0(Trace_Error, "ERROR FinalizeBaggedTerms nullptr == standardDeviationsOut");
+      return Error_IllegalParamVal;
+   }
+
+   // aiBinCountStarts holds cTerms entries and aiTensorStarts holds cTerms + 1 entries
+   size_t* const aiStarts = static_cast<size_t*>(malloc(sizeof(size_t) * (cTerms + cTerms + size_t{1})));
+   if(nullptr == aiStarts) {
+      LOG_0(Trace_Warning, "WARNING FinalizeBaggedTerms nullptr == aiStarts");
+      return Error_OutOfMemory;
+   }
+   size_t* const aiBinCountStarts = aiStarts;
+   size_t* const aiTensorStarts = aiStarts + cTerms;
+
+   // validate the shapes up front so that the workers only see in-range offsets
+   size_t iBinCountStart = 0;
+   size_t iTensorStart = 0;
+   size_t cTensorBinsMax = 1;
+   for(size_t iTerm = 0; iTerm < cTerms; ++iTerm) {
+      const IntEbm countDimensions = dimensionCounts[iTerm];
+      if(countDimensions < IntEbm{0} || IntEbm{k_cDimensionsMax} < countDimensions) {
+         LOG_0(Trace_Error, "ERROR FinalizeBaggedTerms dimensionCounts value out of range");
+         free(aiStarts);
+         return Error_IllegalParamVal;
+      }
+      const size_t cDimensions = static_cast<size_t>(countDimensions);
+      if(size_t{0} != cDimensions && nullptr == binCounts) {
+         LOG_0(Trace_Error, "ERROR FinalizeBaggedTerms binCounts cannot be nullptr if there are dimensions");
+         free(aiStarts);
+         return Error_IllegalParamVal;
+      }
+      size_t cTensorBins = 1;
+      for(size_t iDimension = 0; iDimension < cDimensions; ++iDimension) {
+         const IntEbm countBins = binCounts[iBinCountStart + iDimension];
+         if(countBins <= IntEbm{0}) {
+            LOG_0(Trace_Error, "ERROR FinalizeBaggedTerms binCounts values must be positive");
+            free(aiStarts);
+            return Error_IllegalParamVal;
+         }
+         if(IsConvertError<size_t>(countBins) || IsMultiplyError(cTensorBins, static_cast<size_t>(countBins))) {
+            LOG_0(Trace_Warning, "WARNING FinalizeBaggedTerms tensor too large");
+            free(aiStarts);
+            return Error_OutOfMemory;
+         }
+         cTensorBins *= static_cast<size_t>(countBins);
+      }
+      aiBinCountStarts[iTerm] = iBinCountStart;
+      aiTensorStarts[iTerm] = iTensorStart;
+      iBinCountStart += cDimensions;
+      if(IsAddError(iTensorStart, cTensorBins)) {
+         LOG_0(Trace_Warning, "WARNING FinalizeBaggedTerms tensors too large");
+         free(aiStarts);
+         return Error_OutOfMemory;
+      }
+      iTensorStart += cTensorBins;
+      cTensorBinsMax = EbmMax(cTensorBinsMax, cTensorBins);
+   }
+   aiTensorStarts[cTerms] = iTensorStart;
+
+   // bagScoresInOut holds cBags * iTensorStart * cScores doubles and every worker holds 2 * cTensorBinsMax doubles
+   if(IsMultiplyError(sizeof(double), cBags, iTensorStart, cScores) ||
+         IsMultiplyError(sizeof(double), cTerms, cBags, cScores) ||
+         IsMultiplyError(sizeof(double) * 2, cTensorBinsMax)) {
+      LOG_0(Trace_Warning, "WARNING FinalizeBaggedTerms IsMultiplyError");
+      free(aiStarts);
+      return Error_OutOfMemory;
+   }
+
+   // the means subtracted from each bag's term scores are parked here and moved into the intercepts serially
+   // afterwards, in the same bag then term order as the original sequential implementation
+   double* const aMeans = static_cast<double*>(malloc(sizeof(double) * cTerms * cBags * cScores));
+   if(nullptr == aMeans) {
+      LOG_0(Trace_Warning, "WARNING FinalizeBaggedTerms nullptr == aMeans");
+      free(aiStarts);
+      return Error_OutOfMemory;
+   }
+
+   size_t cThreads = size_t{1};
+   if(IntEbm{0} < countThreads) {
+      if(!IsConvertError<size_t>(countThreads)) {
+         cThreads = static_cast<size_t>(countThreads);
+      }
+   } else {
+      // hardware_concurrency is allowed to return 0 if it cannot determine the number of cores
+      cThreads = EbmMax(size_t{1}, static_cast<size_t>(std::thread::hardware_concurrency()));
+   }
+   cThreads = EbmMin(cThreads, cTerms);
+
+   FinalizeWorkQueue queue;
+   queue.m_cBags = cBags;
+   queue.m_cScores = cScores;
+   queue.m_cTerms = cTerms;
+   queue.m_cTensorBinsMax = cTensorBinsMax;
+   queue.m_aDimensionCounts = dimensionCounts;
+   queue.m_aBinCounts = binCounts;
+   queue.m_aiBinCountStarts = aiBinCountStarts;
+   queue.m_aiTensorStarts = aiTensorStarts;
+   queue.m_aBinWeights = binWeights;
+   queue.m_aBagWeights = bagWeights;
+   queue.m_aBagScores = bagScoresInOut;
+   queue.m_aTermScoresOut = termScoresOut;
+   queue.m_aStandardDeviationsOut = standardDeviationsOut;
+   queue.m_aMeans = aMeans;
+   queue.m_iTermNext.store(0, std::memory_order_relaxed);
+   queue.m_error.store(Error_None, std::memory_order_relaxed);
+
+   size_t cThreadsStarted = 0;
+   try {
+      std::vector<std::thread> threads;
+      threads.reserve(cThreads - size_t{1});
+      try {
+         while(cThreadsStarted < cThreads - size_t{1}) {
+            threads.emplace_back(FinalizeBaggedTermsWorker, &queue);
+            ++cThreadsStarted;
+         }
+      } catch(...) {
+         // the calling thread always participates, so failing to start extra threads only reduces parallelism
+         LOG_0(Trace_Warning, "WARNING FinalizeBaggedTerms could not start all threads");
+      }
+
+      FinalizeBaggedTermsWorker(&queue);
+
+      for(std::thread& thread : threads) {
+         thread.join();
+      }
+   } catch(const std::bad_alloc&) {
+      LOG_0(Trace_Warning, "WARNING FinalizeBaggedTerms out of memory");
+      queue.m_error.store(Error_OutOfMemory, std::memory_order_relaxed);
+   } catch(...) {
+      LOG_0(Trace_Warning, "WARNING FinalizeBaggedTerms thread exception");
+      queue.m_error.store(Error_ThreadStartFailed, std::memory_order_relaxed);
+   }
+
+   const ErrorEbm error = queue.m_error.load(std::memory_order_relaxed);
+   if(Error_None == error) {
+      for(size_t iBag = 0; iBag < cBags; ++iBag) {
+         double* const aIntercept = bagInterceptsInOut + iBag * cScores;
+         for(size_t iTerm = 0; iTerm < cTerms; ++iTerm) {
+            const double* const aTermMeans = aMeans + (iTerm * cBags + iBag) * cScores;
+            for(size_t iScore = 0; iScore < cScores; ++iScore) {
+               aIntercept[iScore] += aTermMeans[iScore];
+            }
+         }
+      }
+   }
+
+   free(aMeans);
+   free(aiStarts);
+
+   LOG_COUNTED_N(&g_cLogExitFinalizeBaggedTermsCount,
+         Trace_Info,
+         Trace_Verbose,
+         "Exited FinalizeBaggedTerms: "
+         "cThreadsStarted=%zu, "
+         "error=%" ErrorEbmPrintf,
+         cThreadsStarted + size_t{1},
+         error);
+
+   return error;
+}
+
+// Weighted pool adjacent violators producing a non-decreasing fit in place.  Only bins with positive weight shape the
+// fit.  Bins without weight take a value linearly interpolated from their fitted neighbours, or the nearest fitted
+// value at the ends, which matches how an isotonic fit over the weighted bins would predict them.
+static void IsotonicIncreasing(const size_t cBins,
+      const double* const aWeights,
+      double* const aVals,
+      double* const aBlockSums,
+      double* const aBlockWeights,
+      size_t* const aiBlockLast) noexcept {
+   EBM_ASSERT(size_t{1} <= cBins);
+
+   size_t cBlocks = 0;
+   for(size_t iBin = 0; iBin < cBins; ++iBin) {
+      const double weight = aWeights[iBin];
+      if(!(0.0 < weight)) {
+         continue;
+      }
+      double sum = weight * aVals[iBin];
+      double weightBlock = weight;
+      // the weights are positive, so comparing the cross products compares the block means without dividing
+      while(size_t{0} != cBlocks && sum * aBlockWeights[cBlocks - 1] < aBlockSums[cBlocks - 1] * weightBlock) {
+         --cBlocks;
+         sum += aBlockSums[cBlocks];
+         weightBlock += aBlockWeights[cBlocks];
+      }
+      aBlockSums[cBlocks] = sum;
+      aBlockWeights[cBlocks] = weightBlock;
+      aiBlockLast[cBlocks] = iBin;
+      ++cBlocks;
+   }
+   // the caller substitutes uniform weights when no bin has weight
+   EBM_ASSERT(size_t{1} <= cBlocks);
+
+   size_t iBlock = 0;
+   size_t iPrev = cBins;
+   for(size_t iBin = 0; iBin < cBins; ++iBin) {
+      if(!(0.0 < aWeights[iBin])) {
+         continue;
+      }
+      while(aiBlockLast[iBlock] < iBin) {
+         ++iBlock;
+      }
+      const double val = aBlockSums[iBlock] / aBlockWeights[iBlock];
+      aVals[iBin] = val;
+      if(cBins == iPrev) {
+         for(size_t iFill = 0; iFill < iBin; ++iFill) {
+            aVals[iFill] = val;
+         }
+      } else {
+         const double valPrev = aVals[iPrev];
+         const double span = static_cast<double>(iBin - iPrev);
+         for(size_t iFill = iPrev + 1; iFill < iBin; ++iFill) {
+            aVals[iFill] = valPrev + (val - valPrev) * (static_cast<double>(iFill - iPrev) / span);
+         }
+      }
+      iPrev = iBin;
+   }
+   EBM_ASSERT(cBins != iPrev);
+   for(size_t iFill = iPrev + 1; iFill < cBins; ++iFill) {
+      aVals[iFill] = aVals[iPrev];
+   }
+}
+
+static double WeightedSum(const size_t cBins, const double* const aWeights, const double* const aVals) noexcept {
+   double sum = 0.0;
+   for(size_t iBin = 0; iBin < cBins; ++iBin) {
+      sum += aWeights[iBin] * aVals[iBin];
+   }
+   return sum;
+}
+
+// LOG_COUNTED_N decrements this value atomically, so concurrent callers never log more than this many messages
+static int g_cLogEnterMonotonizeBaggedTermCount = 25;
+static int g_cLogExitMonotonizeBaggedTermCount = 25;
+
+EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION MonotonizeBaggedTerm(IntEbm countBags,
+      IntEbm countBins,
+      BoolEbm isIncreasing,
+      double passthrough,
+      const double* binWeights,
+      const double* bagWeights,
+      double* bagInterceptsInOut,
+      double* bagScoresInOut,
+      double* termScoresOut,
+      double* standardDeviationsOut) {
+   LOG_COUNTED_N(&g_cLogEnterMonotonizeBaggedTermCount,
+         Trace_Info,
+         Trace_Verbose,
+         "Entered MonotonizeBaggedTerm: "
+         "countBags=%" IntEbmPrintf ", "
+         "countBins=%" IntEbmPrintf ", "
+         "isIncreasing=%s, "
+         "passthrough=%le, "
+         "binWeights=%p, "
+         "bagWeights=%p, "
+         "bagInterceptsInOut=%p, "
+         "bagScoresInOut=%p, "
+         "termScoresOut=%p, "
+         "standardDeviationsOut=%p",
+         countBags,
+         countBins,
+         ObtainTruth(isIncreasing),
+         passthrough,
+         static_cast<const void*>(binWeights),
+         static_cast<const void*>(bagWeights),
+         static_cast<const void*>(bagInterceptsInOut),
+         static_cast<const void*>(bagScoresInOut),
+         static_cast<const void*>(termScoresOut),
+         static_cast<const void*>(standardDeviationsOut));
+
+   if(countBags <= IntEbm{0}) {
+      if(countBags < IntEbm{0}) {
+         LOG_0(Trace_Error, "ERROR MonotonizeBaggedTerm countBags < IntEbm{0}");
+         return Error_IllegalParamVal;
+      }
+      return Error_None;
+   }
+   if(IsConvertError<size_t>(countBags)) {
+      LOG_0(Trace_Error, "ERROR MonotonizeBaggedTerm IsConvertError<size_t>(countBags)");
+      return Error_IllegalParamVal;
+   }
+   const size_t cBags = static_cast<size_t>(countBags);
+
+   // the first bin holds missing values and the last holds unseen values.  Neither is part of the ordered range
+   if(countBins < IntEbm{2}) {
+      LOG_0(Trace_Error, "ERROR MonotonizeBaggedTerm countBins < IntEbm{2}");
+      return Error_IllegalParamVal;
+   }
+   if(IsConvertError<size_t>(countBins) || IsMultiplyError(sizeof(double), cBags, static_cast<size_t>(countBins))) {
+      LOG_0(Trace_Warning, "WARNING MonotonizeBaggedTerm countBins too large");
+      return Error_OutOfMemory;
+   }
+   const size_t cBins = static_cast<size_t>(countBins);
+
+   if(EBM_FALSE != isIncreasing && EBM_TRUE != isIncreasing) {
+      LOG_0(Trace_Error, "ERROR MonotonizeBaggedTerm isIncreasing must be EBM_FALSE or EBM_TRUE");
+      return Error_IllegalParamVal;
+   }
+
+   if(!(0.0 <= passthrough && passthrough <= 1.0)) {
+      // this also catches NaN
+      LOG_0(Trace_Error, "ERROR MonotonizeBaggedTerm passthrough must be between 0.0 and 1.0 inclusive");
+      return Error_IllegalParamVal;
+   }
+
+   if(nullptr == binWeights) {
+      LOG_0(Trace_Error, "ERROR MonotonizeBaggedTerm nullptr == binWeights");
+      return Error_IllegalParamVal;
+   }
+   if(0.0 < passthrough && nullptr == bagInterceptsInOut) {
+      LOG_0(Trace_Error, "ERROR MonotonizeBaggedTerm bagInterceptsInOut cannot be nullptr if 0.0 < passthrough");
+      return Error_IllegalParamVal;
+   }
+   if(nullptr == bagScoresInOut) {
+      LOG_0(Trace_Error, "ERROR MonotonizeBaggedTerm nullptr == bagScoresInOut");
+      return Error_IllegalParamVal;
+   }
+   if(nullptr == termScoresOut) {
+      LOG_0(Trace_Error, "ERROR MonotonizeBaggedTerm nullptr == termScoresOut");
+      return Error_IllegalParamVal;
+   }
+   if(nullptr == standardDeviationsOut) {
+      LOG_0(Trace_Error, "ERROR MonotonizeBaggedTerm nullptr == standardDeviationsOut");
+      return Error_IllegalParamVal;
+   }
+
+   const size_t cOrdered = cBins - size_t{2};
+   if(size_t{0} != cOrdered) {
+      // the weights, block sums and block weights are doubles and the block ends are size_t
+      static_assert(sizeof(size_t) <= sizeof(double), "the block ends share the double scratch allocation");
+      double* const aScratch = static_cast<double*>(malloc(sizeof(double) * 4 * cOrdered));
+      if(nullptr == aScratch) {
+         LOG_0(Trace_Warning, "WARNING MonotonizeBaggedTerm nullptr == aScratch");
+         return Error_OutOfMemory;
+      }
+      double* const aWeights = aScratch;
+      double* const aBlockSums = aScratch + cOrdered;
+      double* const aBlockWeights = aScratch + cOrdered * 2;
+      size_t* const aiBlockLast = reinterpret_cast<size_t*>(aScratch + cOrdered * 3);
+
+      double weightTotal = 0.0;
+      for(size_t iBin = 0; iBin < cOrdered; ++iBin) {
+         const double weight = binWeights[iBin + 1];
+         // negative, NaN and infinite weights would break the pooling, so they do not participate
+         const double weightClean = 0.0 < weight && weight <= std::numeric_limits<double>::max() ? weight : 0.0;
+         aWeights[iBin] = weightClean;
+         weightTotal += weightClean;
+      }
+      if(!(0.0 < weightTotal && weightTotal <= std::numeric_limits<double>::max())) {
+         // without usable weights every bin counts the same
+         for(size_t iBin = 0; iBin < cOrdered; ++iBin) {
+            aWeights[iBin] = 1.0;
+         }
+         weightTotal = static_cast<double>(cOrdered);
+      }
+
+      double weightAll = 0.0;
+      for(size_t iBin = 0; iBin < cBins; ++iBin) {
+         weightAll += binWeights[iBin];
+      }
+
+      for(size_t iBag = 0; iBag < cBags; ++iBag) {
+         double* const aBagScores = bagScoresInOut + iBag * cBins;
+         double* const aVals = aBagScores + 1;
+
+         const double sumOriginal = WeightedSum(cOrdered, aWeights, aVals);
+
+         if(EBM_FALSE == isIncreasing) {
+            for(size_t iBin = 0; iBin < cOrdered; ++iBin) {
+               aVals[iBin] = -aVals[iBin];
+            }
+         }
+         IsotonicIncreasing(cOrdered, aWeights, aVals, aBlockSums, aBlockWeights, aiBlockLast);
+         if(EBM_FALSE == isIncreasing) {
+            for(size_t iBin = 0; iBin < cOrdered; ++iBin) {
+               aVals[iBin] = -aVals[iBin];
+            }
+         }
+
+         // pooling preserves the weighted mean up to rounding.  Whatever moved is restored unless it is passed through
+         const double sumResult = WeightedSum(cOrdered, aWeights, aVals);
+         const double change = (sumOriginal - sumResult) / weightTotal * (1.0 - passthrough);
+         for(size_t iBin = 0; iBin < cOrdered; ++iBin) {
+            aVals[iBin] += change;
+         }
+
+         if(0.0 < passthrough && 0.0 < weightAll) {
+            const double mean = WeightedSum(cBins, binWeights, aBagScores) / weightAll;
+            for(size_t iBin = 0; iBin < cBins; ++iBin) {
+               aBagScores[iBin] -= mean;
+            }
+            bagInterceptsInOut[iBag] += mean;
+         }
+      }
+
+      free(aScratch);
+   }
+
+   for(size_t iBin = 0; iBin < cBins; ++iBin) {
+      termScoresOut[iBin] = SafeBagMean(cBags, cBins, bagScoresInOut + iBin, bagWeights);
+      standardDeviationsOut[iBin] = SafeBagStddev(cBags, cBins, bagScoresInOut + iBin, bagWeights);
+   }
+
+   LOG_COUNTED_0(&g_cLogExitMonotonizeBaggedTermCount, Trace_Info, Trace_Verbose, "Exited MonotonizeBaggedTerm");
+
+   return Error_None;
+}
+
+// LOG_COUNTED_N decrements this value atomically, so concurrent callers never log more than this many messages
 static int g_cLogEnterGetHistogramCutCount = 25;
 static int g_cLogExitGetHistogramCutCount = 25;
 
@@ -72,7 +72,7 @@ EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION GenerateSeed(void* rng, SeedEbm* se
    }
 }
 
-// we don't care if an extra log message is outputted due to the non-atomic nature of the decrement to this value
+// LOG_COUNTED_N decrements this value atomically, so concurrent callers never log more than this many messages
 static int g_cLogEnterGenerateGaussianRandom = 25;
 static int g_cLogExitGenerateGaussianRandom = 25;
 
@@ -164,7 +164,7 @@ EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION GenerateGaussianRandom(
    return Error_None;
 }
 
-// we don't care if an extra log message is outputted due to the non-atomic nature of the decrement to this value
+// LOG_COUNTED_N decrements this value atomically, so concurrent callers never log more than this many messages
 static int g_cLogEnterShuffle = 25;
 static int g_cLogExitShuffle = 25;
 
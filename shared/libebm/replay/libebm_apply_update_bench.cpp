@@ -0,0 +1,193 @@
+// Copyright (c) 2023 The InterpretML Contributors
+// Licensed under the MIT license.
+// Author: Paul Koch <code@koch.ninja>
+
+// Times SetTermUpdate+ApplyTermUpdate on a single pair term while sweeping the size of the update tensor.  Once the
+// tensor no longer fits into the L1/L2 caches the gathering load in each objective's InjectedApplyUpdate dominates,
+// so this is the benchmark to run when changing how those kernels unpack indexes and gather update scores.
+//
+// Build it against the shared library that build.sh or libebm_test.sh produced, for example on Linux:
+//   g++ -std=c++11 -O2 -I shared/libebm/inc shared/libebm/replay/libebm_apply_update_bench.cpp
+//      -L bld/lib -l:libebm_linux_x64.so -Wl,-rpath,'$ORIGIN/../lib' -o bld/bin/libebm_apply_update_bench
+//
+// Usage: libebm_apply_update_bench [-cpu] [samples] [rounds]
+//   -cpu disables the SIMD compute zones
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <chrono>
+#include <vector>
+
+#include "libebm.h"
+
+static uint64_t g_state = 0x9E3779B97F4A7C15;
+
+static uint64_t NextRandom() {
+   // xorshift64* is plenty for synthetic bin indexes and keeps the benchmark independent of libebm's RNG
+   g_state ^= g_state >> 12;
+   g_state ^= g_state << 25;
+   g_state ^= g_state >> 27;
+   return g_state * 0x2545F4914F6CDD1D;
+}
+
+static std::vector<unsigned char> MakeDataSet(const IntEbm cClasses, const IntEbm cSamples, const IntEbm cBins) {
+   std::vector<IntEbm> binIndexes0(static_cast<size_t>(cSamples));
+   std::vector<IntEbm> binIndexes1(static_cast<size_t>(cSamples));
+   std::vector<IntEbm> classes(static_cast<size_t>(cSamples));
+   std::vector<double> targets(static_cast<size_t>(cSamples));
+   for(size_t iSample = 0; iSample < static_cast<size_t>(cSamples); ++iSample) {
+      binIndexes0[iSample] = static_cast<IntEbm>(NextRandom() % static_cast<uint64_t>(cBins));
+      binIndexes1[iSample] = static_cast<IntEbm>(NextRandom() % static_cast<uint64_t>(cBins));
+      if(Task_GeneralClassification <= cClasses) {
+         classes[iSample] = static_cast<IntEbm>(NextRandom() % static_cast<uint64_t>(cClasses));
+      } else {
+         targets[iSample] = static_cast<double>(NextRandom() % 1000) / 100.0;
+      }
+   }
+
+   IntEbm cBytes = MeasureDataSetHeader(2, 0, 1);
+   cBytes += MeasureFeature(cBins, EBM_TRUE, EBM_TRUE, EBM_FALSE, cSamples, binIndexes0.data());
+   cBytes += MeasureFeature(cBins, EBM_TRUE, EBM_TRUE, EBM_FALSE, cSamples, binIndexes1.data());
+   if(Task_GeneralClassification <= cClasses) {
+      cBytes += MeasureClassificationTarget(cClasses, cSamples, classes.data());
+   } else {
+      cBytes += MeasureRegressionTarget(cSamples, targets.data());
+   }
+
+   std::vector<unsigned char> dataSet(static_cast<size_t>(cBytes));
+   ErrorEbm error = FillDataSetHeader(2, 0, 1, cBytes, dataSet.data());
+   if(Error_None == error) {
+      error = FillFeature(
+            cBins, EBM_TRUE, EBM_TRUE, EBM_FALSE, cSamples, binIndexes0.data(), cBytes, dataSet.data());
+   }
+   if(Error_None == error) {
+      error = FillFeature(
+            cBins, EBM_TRUE, EBM_TRUE, EBM_FALSE, cSamples, binIndexes1.data(), cBytes, dataSet.data());
+   }
+   if(Error_None == error) {
+      if(Task_GeneralClassification <= cClasses) {
+         error = FillClassificationTarget(cClasses, cSamples, classes.data(), cBytes, dataSet.data());
+      } else {
+         error = FillRegressionTarget(cSamples, targets.data(), cBytes, dataSet.data());
+      }
+   }
+   if(Error_None != error) {
+      dataSet.clear();
+   }
+   return dataSet;
+}
+
+static bool RunCase(const AccelerationFlags acceleration,
+      const IntEbm cClasses,
+      const IntEbm cSamples,
+      const IntEbm cBins,
+      const int cRounds) {
+   const std::vector<unsigned char> dataSet = MakeDataSet(cClasses, cSamples, cBins);
+   if(dataSet.empty()) {
+      fprintf(stderr, "could not build the dataset\n");
+      return false;
+   }
+
+   // hold out every 5th sample so that both the training and validation kernels run
+   std::vector<BagEbm> bag(static_cast<size_t>(cSamples));
+   for(size_t iSample = 0; iSample < bag.size(); ++iSample) {
+      bag[iSample] = 0 == iSample % 5 ? BagEbm{-1} : BagEbm{1};
+   }
+
+   std::vector<unsigned char> rng(static_cast<size_t>(MeasureRNG()));
+   InitRNG(42, rng.data());
+
+   const IntEbm dimensionCounts[] = {2};
+   const IntEbm featureIndexes[] = {0, 1};
+   BoosterHandle boosterHandle = nullptr;
+   ErrorEbm error = CreateBooster(rng.data(),
+         dataSet.data(),
+         nullptr,
+         bag.data(),
+         nullptr,
+         1,
+         dimensionCounts,
+         featureIndexes,
+         0,
+         CreateBoosterFlags_Default,
+         acceleration,
+         Task_GeneralClassification <= cClasses ? "log_loss" : "rmse",
+         nullptr,
+         &boosterHandle);
+   if(Error_None != error) {
+      fprintf(stderr, "CreateBooster failed with error %d\n", static_cast<int>(error));
+      return false;
+   }
+
+   const size_t cScores = IntEbm{3} <= cClasses ? static_cast<size_t>(cClasses) : size_t{1};
+   const size_t cCells = static_cast<size_t>(cBins) * static_cast<size_t>(cBins);
+   std::vector<double> update(cCells * cScores);
+   for(double& score : update) {
+      // small updates keep the scores finite over many rounds
+      score = (static_cast<double>(NextRandom() % 2001) - 1000.0) * 1e-7;
+   }
+
+   double validationMetric = 0.0;
+   const auto start = std::chrono::steady_clock::now();
+   for(int iRound = 0; iRound < cRounds; ++iRound) {
+      error = SetTermUpdate(boosterHandle, 0, update.data());
+      if(Error_None == error) {
+         error = ApplyTermUpdate(boosterHandle, &validationMetric);
+      }
+      if(Error_None != error) {
+         fprintf(stderr, "SetTermUpdate/ApplyTermUpdate failed with error %d\n", static_cast<int>(error));
+         FreeBooster(boosterHandle);
+         return false;
+      }
+   }
+   const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+   FreeBooster(boosterHandle);
+
+   printf("%8lld %12llu %14.6f %14.3f %14.6f\n",
+         static_cast<long long>(cClasses),
+         static_cast<unsigned long long>(cCells),
+         elapsed.count() / static_cast<double>(cRounds),
+         elapsed.count() * 1e9 / (static_cast<double>(cRounds) * static_cast<double>(cSamples)),
+         validationMetric);
+   return true;
+}
+
+int main(int argc, char** argv) {
+   AccelerationFlags acceleration = AccelerationFlags_ALL;
+   IntEbm cSamples = 1000000;
+   int cRounds = 20;
+
+   int iArg = 1;
+   if(iArg < argc && 0 == strcmp(argv[iArg], "-cpu")) {
+      acceleration = AccelerationFlags_NONE;
+      ++iArg;
+   }
+   if(iArg < argc) {
+      cSamples = static_cast<IntEbm>(atoll(argv[iArg]));
+      ++iArg;
+   }
+   if(iArg < argc) {
+      cRounds = atoi(argv[iArg]);
+      ++iArg;
+   }
+   if(argc != iArg || cSamples < 5 || cRounds < 1) {
+      fprintf(stderr, "usage: %s [-cpu] [samples] [rounds]\n", argv[0]);
+      return 2;
+   }
+
+   // 16 cells fit in a couple of cache lines while 1M cells (8MB of doubles per score) spill out of most L2 caches
+   static const IntEbm k_bins[] = {4, 16, 64, 256, 1024};
+   static const IntEbm k_classes[] = {Task_Regression, 2, 3};
+
+   printf("%8s %12s %14s %14s %14s\n", "classes", "cells", "s_per_round", "ns_per_sample", "metric");
+   for(const IntEbm cClasses : k_classes) {
+      for(const IntEbm cBins : k_bins) {
+         if(!RunCase(acceleration, cClasses, cSamples, cBins, cRounds)) {
+            return 1;
+         }
+      }
+   }
+   return 0;
+}
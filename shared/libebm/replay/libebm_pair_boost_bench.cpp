@@ -0,0 +1,178 @@
+// Copyright (c) 2023 The InterpretML Contributors
+// Licensed under the MIT license.
+// Author: Paul Koch <code@koch.ninja>
+
+// Times GenerateTermUpdate+ApplyTermUpdate on a single pair term for several tensor shapes.  The tree search in
+// PartitionMultiDimensionalTree visits every cut combination of the pair, so this is the benchmark to run when
+// changing how that search caches region sums or prunes sweeps.
+//
+// Build it against the shared library that build.sh or libebm_test.sh produced, for example on Linux:
+//   g++ -std=c++11 -O2 -I shared/libebm/inc shared/libebm/replay/libebm_pair_boost_bench.cpp
+//      -L bld/lib -l:libebm_linux_x64.so -Wl,-rpath,'$ORIGIN/../lib' -o bld/bin/libebm_pair_boost_bench
+//
+// Usage: libebm_pair_boost_bench [samples] [rounds]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <chrono>
+#include <vector>
+
+#include "libebm.h"
+
+static uint64_t g_state = 0x9E3779B97F4A7C15;
+
+static uint64_t NextRandom() {
+   // xorshift64* is plenty for synthetic bin indexes and keeps the benchmark independent of libebm's RNG
+   g_state ^= g_state >> 12;
+   g_state ^= g_state << 25;
+   g_state ^= g_state >> 27;
+   return g_state * 0x2545F4914F6CDD1D;
+}
+
+static std::vector<unsigned char> MakeDataSet(const IntEbm cSamples, const IntEbm cBins0, const IntEbm cBins1) {
+   std::vector<IntEbm> binIndexes0(static_cast<size_t>(cSamples));
+   std::vector<IntEbm> binIndexes1(static_cast<size_t>(cSamples));
+   std::vector<double> targets(static_cast<size_t>(cSamples));
+   for(size_t iSample = 0; iSample < static_cast<size_t>(cSamples); ++iSample) {
+      const IntEbm iBin0 = static_cast<IntEbm>(NextRandom() % static_cast<uint64_t>(cBins0));
+      const IntEbm iBin1 = static_cast<IntEbm>(NextRandom() % static_cast<uint64_t>(cBins1));
+      binIndexes0[iSample] = iBin0;
+      binIndexes1[iSample] = iBin1;
+      // a product of both features plus noise, so that the best pair tree is not obvious
+      const double x0 = static_cast<double>(iBin0) / static_cast<double>(cBins0) - 0.5;
+      const double x1 = static_cast<double>(iBin1) / static_cast<double>(cBins1) - 0.5;
+      targets[iSample] = 4.0 * x0 * x1 + static_cast<double>(NextRandom() % 1000) / 1000.0;
+   }
+
+   IntEbm cBytes = MeasureDataSetHeader(2, 0, 1);
+   cBytes += MeasureFeature(cBins0, EBM_TRUE, EBM_TRUE, EBM_FALSE, cSamples, binIndexes0.data());
+   cBytes += MeasureFeature(cBins1, EBM_TRUE, EBM_TRUE, EBM_FALSE, cSamples, binIndexes1.data());
+   cBytes += MeasureRegressionTarget(cSamples, targets.data());
+
+   std::vector<unsigned char> dataSet(static_cast<size_t>(cBytes));
+   ErrorEbm error = FillDataSetHeader(2, 0, 1, cBytes, dataSet.data());
+   if(Error_None == error) {
+      error = FillFeature(
+            cBins0, EBM_TRUE, EBM_TRUE, EBM_FALSE, cSamples, binIndexes0.data(), cBytes, dataSet.data());
+   }
+   if(Error_None == error) {
+      error = FillFeature(
+            cBins1, EBM_TRUE, EBM_TRUE, EBM_FALSE, cSamples, binIndexes1.data(), cBytes, dataSet.data());
+   }
+   if(Error_None == error) {
+      error = FillRegressionTarget(cSamples, targets.data(), cBytes, dataSet.data());
+   }
+   if(Error_None != error) {
+      dataSet.clear();
+   }
+   return dataSet;
+}
+
+static bool RunCase(const IntEbm cSamples, const IntEbm cBins0, const IntEbm cBins1, const int cRounds) {
+   const std::vector<unsigned char> dataSet = MakeDataSet(cSamples, cBins0, cBins1);
+   if(dataSet.empty()) {
+      fprintf(stderr, "could not build the dataset\n");
+      return false;
+   }
+
+   std::vector<unsigned char> rng(static_cast<size_t>(MeasureRNG()));
+   InitRNG(42, rng.data());
+
+   const IntEbm dimensionCounts[] = {2};
+   const IntEbm featureIndexes[] = {0, 1};
+   BoosterHandle boosterHandle = nullptr;
+   ErrorEbm error = CreateBooster(rng.data(),
+         dataSet.data(),
+         nullptr,
+         nullptr,
+         nullptr,
+         1,
+         dimensionCounts,
+         featureIndexes,
+         0,
+         CreateBoosterFlags_Default,
+         AccelerationFlags_ALL,
+         "rmse",
+         nullptr,
+         &boosterHandle);
+   if(Error_None != error) {
+      fprintf(stderr, "CreateBooster failed with error %d\n", static_cast<int>(error));
+      return false;
+   }
+
+   // the default pair tree of the python package: 3 leaves
+   const IntEbm leavesMax[] = {3, 3};
+   double gainTotal = 0.0;
+   double validationMetric = 0.0;
+   const auto start = std::chrono::steady_clock::now();
+   for(int iRound = 0; iRound < cRounds; ++iRound) {
+      double gain = 0.0;
+      error = GenerateTermUpdate(rng.data(),
+            boosterHandle,
+            0,
+            TermBoostFlags_Default,
+            0.01,
+            2,
+            1e-4,
+            0.0,
+            0.0,
+            0.0,
+            0,
+            0.0,
+            0,
+            0.0,
+            1,
+            leavesMax,
+            nullptr,
+            &gain);
+      if(Error_None == error) {
+         error = ApplyTermUpdate(boosterHandle, &validationMetric);
+      }
+      if(Error_None != error) {
+         fprintf(stderr, "GenerateTermUpdate/ApplyTermUpdate failed with error %d\n", static_cast<int>(error));
+         FreeBooster(boosterHandle);
+         return false;
+      }
+      gainTotal += gain;
+   }
+   const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+   FreeBooster(boosterHandle);
+
+   printf("%8lld %8lld %14.6f %14.6f\n",
+         static_cast<long long>(cBins0),
+         static_cast<long long>(cBins1),
+         elapsed.count() / static_cast<double>(cRounds),
+         gainTotal);
+   return true;
+}
+
+int main(int argc, char** argv) {
+   IntEbm cSamples = 200000;
+   int cRounds = 20;
+
+   int iArg = 1;
+   if(iArg < argc) {
+      cSamples = static_cast<IntEbm>(atoll(argv[iArg]));
+      ++iArg;
+   }
+   if(iArg < argc) {
+      cRounds = atoi(argv[iArg]);
+      ++iArg;
+   }
+   if(argc != iArg || cSamples < 1 || cRounds < 1) {
+      fprintf(stderr, "usage: %s [samples] [rounds]\n", argv[0]);
+      return 2;
+   }
+
+   // the bins include the missing and unseen bins, so 256x256 is the pair tensor for 254 binned values per feature
+   static const IntEbm k_shapes[][2] = {{16, 16}, {64, 64}, {256, 256}, {1024, 64}, {64, 1024}};
+
+   printf("%8s %8s %14s %14s\n", "bins0", "bins1", "s_per_round", "gain_total");
+   for(const auto& shape : k_shapes) {
+      if(!RunCase(cSamples, shape[0], shape[1], cRounds)) {
+         return 1;
+      }
+   }
+   return 0;
+}
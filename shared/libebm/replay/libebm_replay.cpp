@@ -0,0 +1,73 @@
+// Copyright (c) 2023 The InterpretML Contributors
+// Licensed under the MIT license.
+// Author: Paul Koch <code@koch.ninja>
+
+// Replays a recording made with StartRecording/StopRecording (or Native.start_recording in python) and prints how
+// long each libebm call took.  This lets a fit be profiled natively without the python interpreter in the way.
+//
+// shared/libebm/tests/libebm_test.sh builds it next to libebm_test.  To build it by hand against the shared library that
+// build.sh produced, for example on Linux:
+//   g++ -std=c++11 -O2 -I shared/libebm/inc shared/libebm/replay/libebm_replay.cpp
+//      -L bld/lib -l:libebm_linux_x64.so -Wl,-rpath,'$ORIGIN/../lib' -o bld/bin/libebm_replay
+//
+// Usage: libebm_replay <recording> [-v]
+//   -v prints every call instead of only the per-API totals
+
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include <map>
+
+#include "libebm.h"
+
+struct ApiTotals {
+   long long m_cCalls;
+   long long m_cErrors;
+   double m_seconds;
+};
+
+static std::map<std::string, ApiTotals> g_totals;
+static bool g_bVerbose = false;
+
+static void EBM_CALLING_CONVENTION OnReplayedCall(
+      IntEbm indexCall, const char* apiName, ErrorEbm error, double seconds) {
+   if(g_bVerbose) {
+      printf("%lld %s error=%d %.9f\n", static_cast<long long>(indexCall), apiName, static_cast<int>(error), seconds);
+   }
+   ApiTotals& totals = g_totals[apiName];
+   ++totals.m_cCalls;
+   if(Error_None != error) {
+      ++totals.m_cErrors;
+   }
+   totals.m_seconds += seconds;
+}
+
+int main(int argc, char** argv) {
+   if(argc < 2 || 3 < argc || (3 == argc && 0 != strcmp(argv[2], "-v"))) {
+      fprintf(stderr, "usage: %s <recording> [-v]\n", argv[0]);
+      return 2;
+   }
+   g_bVerbose = 3 == argc;
+
+   const ErrorEbm error = ReplayRecording(argv[1], &OnReplayedCall);
+
+   double secondsTotal = 0.0;
+   printf("%-28s %10s %8s %14s %14s\n", "api", "calls", "errors", "total_s", "mean_s");
+   for(const auto& item : g_totals) {
+      const ApiTotals& totals = item.second;
+      printf("%-28s %10lld %8lld %14.6f %14.9f\n",
+            item.first.c_str(),
+            totals.m_cCalls,
+            totals.m_cErrors,
+            totals.m_seconds,
+            totals.m_seconds / static_cast<double>(totals.m_cCalls));
+      secondsTotal += totals.m_seconds;
+   }
+   printf("%-28s %10s %8s %14.6f\n", "total", "", "", secondsTotal);
+
+   if(Error_None != error) {
+      fprintf(stderr, "ReplayRecording failed with error %d\n", static_cast<int>(error));
+      return 1;
+   }
+   return 0;
+}
@@ -422,6 +422,405 @@ EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION SampleWithoutReplacementStratified(
    return Error_None;
 }
 
+// A bag plan starts with the bag and sample counts and then holds one row per bag.  Each row packs 4 samples per
+// byte at 2 bits per sample, starting from the low bits, and rows start on byte boundaries.
+static constexpr size_t k_cBytesBagPlanHeader = sizeof(uint64_t) * 2;
+static constexpr unsigned int k_bagPlanLeftOut = 0;
+static constexpr unsigned int k_bagPlanTraining = 1;
+static constexpr unsigned int k_bagPlanValidation = 2;
+
+INLINE_ALWAYS static size_t GetBagPlanRowBytes(const size_t cSamples) noexcept {
+   return cSamples / size_t{4} + (size_t{0} != cSamples % size_t{4} ? size_t{1} : size_t{0});
+}
+
+static ErrorEbm GetBagPlanHeader(const void* const bagPlan, size_t* const pcBagsOut, size_t* const pcSamplesOut) {
+   EBM_ASSERT(nullptr != pcBagsOut);
+   EBM_ASSERT(nullptr != pcSamplesOut);
+
+   if(nullptr == bagPlan) {
+      LOG_0(Trace_Error, "ERROR GetBagPlanHeader nullptr == bagPlan");
+      return Error_IllegalParamVal;
+   }
+
+   // the plan is often held in caller memory with byte alignment, so do not cast it to uint64_t
+   uint64_t aHeader[2];
+   memcpy(aHeader, bagPlan, sizeof(aHeader));
+   if(IsConvertError<size_t>(aHeader[0]) || IsConvertError<size_t>(aHeader[1])) {
+      LOG_0(Trace_Error, "ERROR GetBagPlanHeader counts do not fit into size_t");
+      return Error_IllegalParamVal;
+   }
+   *pcBagsOut = static_cast<size_t>(aHeader[0]);
+   *pcSamplesOut = static_cast<size_t>(aHeader[1]);
+   return Error_None;
+}
+
+extern ErrorEbm UnpackBagPlan(
+      const size_t cSamples, const void* const bagPlan, const IntEbm indexBag, BagEbm* const aBagOut) {
+   EBM_ASSERT(nullptr != aBagOut || size_t{0} == cSamples);
+
+   size_t cBags;
+   size_t cSamplesPlan;
+   const ErrorEbm error = GetBagPlanHeader(bagPlan, &cBags, &cSamplesPlan);
+   if(Error_None != error) {
+      // already logged
+      return error;
+   }
+   if(cSamples != cSamplesPlan) {
+      LOG_0(Trace_Error, "ERROR UnpackBagPlan the bag plan has a different number of samples");
+      return Error_IllegalParamVal;
+   }
+   if(indexBag < IntEbm{0} || IsConvertError<size_t>(indexBag) || cBags <= static_cast<size_t>(indexBag)) {
+      LOG_0(Trace_Error, "ERROR UnpackBagPlan indexBag out of range");
+      return Error_IllegalParamVal;
+   }
+
+   const unsigned char* const pRow = static_cast<const unsigned char*>(bagPlan) + k_cBytesBagPlanHeader +
+         GetBagPlanRowBytes(cSamples) * static_cast<size_t>(indexBag);
+   for(size_t iSample = 0; iSample < cSamples; ++iSample) {
+      const unsigned int code = (pRow[iSample >> 2] >> ((iSample & size_t{3}) << 1)) & 3u;
+      if(k_bagPlanValidation < code) {
+         LOG_0(Trace_Error, "ERROR UnpackBagPlan illegal entry in the bag plan");
+         return Error_IllegalParamVal;
+      }
+      aBagOut[iSample] = k_bagPlanTraining == code ? BagEbm{1} : k_bagPlanValidation == code ? BagEbm{-1} : BagEbm{0};
+   }
+   return Error_None;
+}
+
+// the booster and interaction detector take a BagEbm array, so plans are unpacked one bag at a time into a temporary
+// array sized from the dataset.  *paBagOut is nullptr when the dataset has no samples, and the caller frees it
+extern ErrorEbm AllocateBagFromPlan(
+      const void* const dataSet, const void* const bagPlan, const IntEbm indexBag, BagEbm** const paBagOut) {
+   EBM_ASSERT(nullptr != paBagOut);
+   *paBagOut = nullptr;
+
+   if(nullptr == dataSet) {
+      LOG_0(Trace_Error, "ERROR AllocateBagFromPlan nullptr == dataSet");
+      return Error_IllegalParamVal;
+   }
+
+   UIntShared countSamples;
+   size_t cFeatures;
+   size_t cWeights;
+   size_t cTargets;
+   ErrorEbm error = GetDataSetSharedHeader(
+         static_cast<const unsigned char*>(dataSet), &countSamples, &cFeatures, &cWeights, &cTargets);
+   if(Error_None != error) {
+      // already logged
+      return error;
+   }
+   if(IsConvertError<size_t>(countSamples) || IsMultiplyError(sizeof(BagEbm), static_cast<size_t>(countSamples))) {
+      LOG_0(Trace_Error, "ERROR AllocateBagFromPlan countSamples too large");
+      return Error_IllegalParamVal;
+   }
+   const size_t cSamples = static_cast<size_t>(countSamples);
+
+   BagEbm* aBag = nullptr;
+   if(size_t{0} != cSamples) {
+      aBag = static_cast<BagEbm*>(malloc(sizeof(BagEbm) * cSamples));
+      if(nullptr == aBag) {
+         LOG_0(Trace_Warning, "WARNING AllocateBagFromPlan nullptr == aBag");
+         return Error_OutOfMemory;
+      }
+   }
+   error = UnpackBagPlan(cSamples, bagPlan, indexBag, aBag);
+   if(Error_None != error) {
+      // already logged
+      free(aBag);
+      return error;
+   }
+   *paBagOut = aBag;
+   return Error_None;
+}
+
+// every group goes wholly to training or to validation.  The groups are visited in a random order and moved to
+// validation until it holds at least cValidationSamples samples, so validation overshoots by less than one group
+static ErrorEbm SampleGroups(RandomDeterministic* const pCpuRng,
+      const size_t cGroups,
+      const size_t cSamples,
+      const size_t cValidationSamples,
+      const IntEbm* const aGroups,
+      size_t* const aScratch,
+      BagEbm* const aBagOut) {
+   EBM_ASSERT(nullptr != pCpuRng);
+   EBM_ASSERT(1 <= cGroups);
+   EBM_ASSERT(1 <= cSamples);
+   EBM_ASSERT(nullptr != aGroups);
+   EBM_ASSERT(nullptr != aScratch);
+   EBM_ASSERT(nullptr != aBagOut);
+
+   static constexpr size_t k_validationGroup = ~size_t{0};
+
+   size_t* const aGroupCounts = aScratch;
+   size_t* const aiGroupOrder = aScratch + cGroups;
+
+   memset(aGroupCounts, 0, sizeof(*aGroupCounts) * cGroups);
+   for(size_t iSample = 0; iSample < cSamples; ++iSample) {
+      const IntEbm indexGroup = aGroups[iSample];
+      if(indexGroup < IntEbm{0} || IsConvertError<size_t>(indexGroup) || cGroups <= static_cast<size_t>(indexGroup)) {
+         LOG_0(Trace_Error, "ERROR SampleGroups group index out of range");
+         return Error_IllegalParamVal;
+      }
+      ++aGroupCounts[static_cast<size_t>(indexGroup)];
+   }
+
+   // Fisher-Yates shuffle of the group visiting order
+   for(size_t iGroup = 0; iGroup < cGroups; ++iGroup) {
+      aiGroupOrder[iGroup] = iGroup;
+   }
+   for(size_t iGroup = cGroups - size_t{1}; size_t{0} != iGroup; --iGroup) {
+      const size_t iSwap = pCpuRng->NextFast(iGroup + size_t{1});
+      const size_t iTemp = aiGroupOrder[iGroup];
+      aiGroupOrder[iGroup] = aiGroupOrder[iSwap];
+      aiGroupOrder[iSwap] = iTemp;
+   }
+
+   size_t cValidationAssigned = 0;
+   for(size_t iOrder = 0; iOrder < cGroups && cValidationAssigned < cValidationSamples; ++iOrder) {
+      const size_t iGroup = aiGroupOrder[iOrder];
+      cValidationAssigned += aGroupCounts[iGroup];
+      aGroupCounts[iGroup] = k_validationGroup;
+   }
+   if(cSamples == cValidationAssigned) {
+      LOG_0(Trace_Warning, "WARNING SampleGroups every group went to validation");
+   }
+
+   for(size_t iSample = 0; iSample < cSamples; ++iSample) {
+      const size_t iGroup = static_cast<size_t>(aGroups[iSample]);
+      aBagOut[iSample] = k_validationGroup == aGroupCounts[iGroup] ? BagEbm{-1} : BagEbm{1};
+   }
+   return Error_None;
+}
+
+EBM_API_BODY IntEbm EBM_CALLING_CONVENTION MeasureBagPlan(IntEbm countBags, IntEbm countSamples) {
+   LOG_N(Trace_Info,
+         "Entered MeasureBagPlan: "
+         "countBags=%" IntEbmPrintf ", "
+         "countSamples=%" IntEbmPrintf,
+         countBags,
+         countSamples);
+
+   if(countBags < IntEbm{0} || IsConvertError<size_t>(countBags)) {
+      LOG_0(Trace_Error, "ERROR MeasureBagPlan countBags out of range");
+      return Error_IllegalParamVal;
+   }
+   if(countSamples < IntEbm{0} || IsConvertError<size_t>(countSamples)) {
+      LOG_0(Trace_Error, "ERROR MeasureBagPlan countSamples out of range");
+      return Error_IllegalParamVal;
+   }
+   const size_t cRowBytes = GetBagPlanRowBytes(static_cast<size_t>(countSamples));
+   if(IsMultiplyError(cRowBytes, static_cast<size_t>(countBags)) ||
+         IsAddError(k_cBytesBagPlanHeader, cRowBytes * static_cast<size_t>(countBags)) ||
+         IsConvertError<IntEbm>(k_cBytesBagPlanHeader + cRowBytes * static_cast<size_t>(countBags))) {
+      LOG_0(Trace_Warning, "WARNING MeasureBagPlan bag plan too large");
+      return Error_OutOfMemory;
+   }
+   const IntEbm countBytes = static_cast<IntEbm>(k_cBytesBagPlanHeader + cRowBytes * static_cast<size_t>(countBags));
+
+   LOG_N(Trace_Info, "Exited MeasureBagPlan: %" IntEbmPrintf, countBytes);
+   return countBytes;
+}
+
+EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION GenerateBagPlan(void* rngs,
+      IntEbm countBags,
+      IntEbm countTrainingSamples,
+      IntEbm countValidationSamples,
+      IntEbm countClasses,
+      const IntEbm* targets,
+      IntEbm countGroups,
+      const IntEbm* groups,
+      IntEbm countBytesAllocated,
+      void* bagPlanOut) {
+   LOG_N(Trace_Info,
+         "Entered GenerateBagPlan: "
+         "rngs=%p, "
+         "countBags=%" IntEbmPrintf ", "
+         "countTrainingSamples=%" IntEbmPrintf ", "
+         "countValidationSamples=%" IntEbmPrintf ", "
+         "countClasses=%" IntEbmPrintf ", "
+         "targets=%p, "
+         "countGroups=%" IntEbmPrintf ", "
+         "groups=%p, "
+         "countBytesAllocated=%" IntEbmPrintf ", "
+         "bagPlanOut=%p",
+         rngs,
+         countBags,
+         countTrainingSamples,
+         countValidationSamples,
+         countClasses,
+         static_cast<const void*>(targets),
+         countGroups,
+         static_cast<const void*>(groups),
+         countBytesAllocated,
+         bagPlanOut);
+
+   ErrorEbm error;
+
+   if(UNLIKELY(IsConvertError<size_t>(countTrainingSamples))) {
+      LOG_0(Trace_Error, "ERROR GenerateBagPlan IsConvertError<size_t>(countTrainingSamples)");
+      return Error_IllegalParamVal;
+   }
+   const size_t cTrainingSamples = static_cast<size_t>(countTrainingSamples);
+
+   if(UNLIKELY(IsConvertError<size_t>(countValidationSamples))) {
+      LOG_0(Trace_Error, "ERROR GenerateBagPlan IsConvertError<size_t>(countValidationSamples)");
+      return Error_IllegalParamVal;
+   }
+   const size_t cValidationSamples = static_cast<size_t>(countValidationSamples);
+
+   if(UNLIKELY(IsAddError(cTrainingSamples, cValidationSamples))) {
+      LOG_0(Trace_Error, "ERROR GenerateBagPlan IsAddError(cTrainingSamples, cValidationSamples)");
+      return Error_IllegalParamVal;
+   }
+   const size_t cSamples = cTrainingSamples + cValidationSamples;
+   if(IsConvertError<IntEbm>(cSamples)) {
+      LOG_0(Trace_Error, "ERROR GenerateBagPlan IsConvertError<IntEbm>(cSamples)");
+      return Error_IllegalParamVal;
+   }
+
+   const IntEbm countBytesRequired = MeasureBagPlan(countBags, static_cast<IntEbm>(cSamples));
+   if(countBytesRequired < IntEbm{0}) {
+      // already logged
+      return static_cast<ErrorEbm>(countBytesRequired);
+   }
+   const size_t cBags = static_cast<size_t>(countBags);
+
+   if(nullptr != targets && nullptr != groups) {
+      LOG_0(Trace_Error, "ERROR GenerateBagPlan stratified and group sampling cannot be combined");
+      return Error_IllegalParamVal;
+   }
+   size_t cGroups = 0;
+   if(nullptr != groups) {
+      if(countGroups <= IntEbm{0} || IsConvertError<size_t>(countGroups)) {
+         LOG_0(Trace_Error, "ERROR GenerateBagPlan countGroups out of range");
+         return Error_IllegalParamVal;
+      }
+      cGroups = static_cast<size_t>(countGroups);
+      if(IsMultiplyError(sizeof(size_t) * 2, cGroups)) {
+         LOG_0(Trace_Warning, "WARNING GenerateBagPlan IsMultiplyError(sizeof(size_t) * 2, cGroups)");
+         return Error_OutOfMemory;
+      }
+   }
+
+   if(nullptr == bagPlanOut) {
+      LOG_0(Trace_Error, "ERROR GenerateBagPlan nullptr == bagPlanOut");
+      return Error_IllegalParamVal;
+   }
+   if(countBytesAllocated < countBytesRequired) {
+      LOG_0(Trace_Error, "ERROR GenerateBagPlan countBytesAllocated too small for the bag plan");
+      return Error_IllegalParamVal;
+   }
+
+   unsigned char* const pPlan = static_cast<unsigned char*>(bagPlanOut);
+   const uint64_t aHeader[2]{static_cast<uint64_t>(cBags), static_cast<uint64_t>(cSamples)};
+   memcpy(pPlan, aHeader, sizeof(aHeader));
+
+   const size_t cRowBytes = GetBagPlanRowBytes(cSamples);
+   if(size_t{0} == cSamples || size_t{0} == cBags) {
+      LOG_0(Trace_Info, "Exited GenerateBagPlan with zero elements");
+      return Error_None;
+   }
+   memset(pPlan + k_cBytesBagPlanHeader, 0, cRowBytes * cBags);
+
+   // one row of BagEbm is reused for every bag so that the per-bag samplers stay bit-for-bit the same as the
+   // single bag APIs.  The group sampler also needs counts and an order for each group, which go first for alignment
+   if(IsMultiplyError(sizeof(BagEbm), cSamples) ||
+         IsAddError(sizeof(size_t) * 2 * cGroups, sizeof(BagEbm) * cSamples)) {
+      LOG_0(Trace_Warning, "WARNING GenerateBagPlan scratch too large");
+      return Error_OutOfMemory;
+   }
+   void* const pScratch = malloc(sizeof(size_t) * 2 * cGroups + sizeof(BagEbm) * cSamples);
+   if(nullptr == pScratch) {
+      LOG_0(Trace_Warning, "WARNING GenerateBagPlan nullptr == pScratch");
+      return Error_OutOfMemory;
+   }
+   size_t* const aGroupScratch = static_cast<size_t*>(pScratch);
+   BagEbm* const aBag = reinterpret_cast<BagEbm*>(aGroupScratch + cGroups * 2);
+
+   unsigned char* pRow = pPlan + k_cBytesBagPlanHeader;
+   for(size_t iBag = 0; iBag < cBags; ++iBag) {
+      void* const rng = nullptr == rngs ? nullptr : static_cast<unsigned char*>(rngs) + sizeof(RandomDeterministic) * iBag;
+      if(nullptr != targets) {
+         error = SampleWithoutReplacementStratified(
+               rng, countClasses, countTrainingSamples, countValidationSamples, targets, aBag);
+      } else if(nullptr != groups) {
+         RandomDeterministic cpuRng;
+         if(nullptr == rng) {
+            try {
+               RandomNondeterministic<uint64_t> randomGenerator;
+               cpuRng.Initialize(randomGenerator.Next(std::numeric_limits<uint64_t>::max()));
+            } catch(const std::bad_alloc&) {
+               LOG_0(Trace_Warning, "WARNING GenerateBagPlan Out of memory in std::random_device");
+               free(pScratch);
+               return Error_OutOfMemory;
+            } catch(...) {
+               LOG_0(Trace_Warning, "WARNING GenerateBagPlan Unknown error in std::random_device");
+               free(pScratch);
+               return Error_UnexpectedInternal;
+            }
+         } else {
+            cpuRng.Initialize(*reinterpret_cast<RandomDeterministic*>(rng));
+         }
+         error = SampleGroups(&cpuRng, cGroups, cSamples, cValidationSamples, groups, aGroupScratch, aBag);
+         if(nullptr != rng) {
+            reinterpret_cast<RandomDeterministic*>(rng)->Initialize(cpuRng);
+         }
+      } else {
+         error = SampleWithoutReplacement(rng, countTrainingSamples, countValidationSamples, aBag);
+      }
+      if(Error_None != error) {
+         // already logged
+         free(pScratch);
+         return error;
+      }
+
+      for(size_t iSample = 0; iSample < cSamples; ++iSample) {
+         const BagEbm replication = aBag[iSample];
+         const unsigned int code = BagEbm{0} < replication ? k_bagPlanTraining :
+               replication < BagEbm{0}                     ? k_bagPlanValidation :
+                                                             k_bagPlanLeftOut;
+         pRow[iSample >> 2] |= static_cast<unsigned char>(code << ((iSample & size_t{3}) << 1));
+      }
+      pRow += cRowBytes;
+   }
+
+   free(pScratch);
+
+   LOG_0(Trace_Info, "Exited GenerateBagPlan");
+   return Error_None;
+}
+
+EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION ExtractBag(const void* bagPlan, IntEbm indexBag, BagEbm* bagOut) {
+   LOG_N(Trace_Info,
+         "Entered ExtractBag: "
+         "bagPlan=%p, "
+         "indexBag=%" IntEbmPrintf ", "
+         "bagOut=%p",
+         bagPlan,
+         indexBag,
+         static_cast<void*>(bagOut));
+
+   size_t cBags;
+   size_t cSamples;
+   ErrorEbm error = GetBagPlanHeader(bagPlan, &cBags, &cSamples);
+   if(Error_None != error) {
+      // already logged
+      return error;
+   }
+   if(nullptr == bagOut && size_t{0} != cSamples) {
+      LOG_0(Trace_Error, "ERROR ExtractBag nullptr == bagOut");
+      return Error_IllegalParamVal;
+   }
+   error = UnpackBagPlan(cSamples, bagPlan, indexBag, bagOut);
+   if(Error_None != error) {
+      // already logged
+      return error;
+   }
+
+   LOG_0(Trace_Info, "Exited ExtractBag");
+   return Error_None;
+}
+
 extern ErrorEbm Unbag(const size_t cSamples,
       const BagEbm* const aBag,
       size_t* const pcTrainingSamplesOut,
@@ -20,6 +20,10 @@
 // substitute our wrapper function below for other calls throughout our library, which then calls the older function.
 // The wrapper function also needs to be included in the gcc/g++ command line in build.sh using "-Wl,--wrap=memcpy"
 //
+// Pinning exp, log, etc to GLIBC_2.2.5 gives us the old and slow libm implementations, so anything per-sample should
+// use the bundled kernels in compute/math.hpp instead.  After that, the remaining callers of these libm functions are
+// one-time computations like cut point selection and differential privacy noise, plus DEBUG assertions.
+//
 // It is possible to get a list of function versions available to link to with the following command:
 // objdump -T /lib/x86_64-linux-gnu/libc.so.6    OR   objdump -T /lib/x86_64-linux-gnu/libm.so.6
 //
@@ -113,3 +113,85 @@ TEST_CASE("Discretize, increasing lengths") {
       }
    }
 }
+
+TEST_CASE("DiscretizeCached, same bins as Discretize") {
+   static constexpr size_t cCuts = 40;
+   static constexpr size_t cSamples = 1000;
+
+   double cutsLowerBoundInclusive[cCuts];
+   for(size_t iCut = 0; iCut < cCuts; ++iCut) {
+      // half the cuts fall on integers and half between them
+      cutsLowerBoundInclusive[iCut] = -10.0 + 0.5 * static_cast<double>(iCut);
+   }
+
+   double featureVals[cSamples];
+   for(size_t iSample = 0; iSample < cSamples; ++iSample) {
+      const size_t iMod = iSample % 10;
+      if(0 == iMod) {
+         featureVals[iSample] = std::numeric_limits<double>::quiet_NaN();
+      } else if(1 == iMod) {
+         featureVals[iSample] = -1000.0;
+      } else if(2 == iMod) {
+         featureVals[iSample] = std::numeric_limits<double>::infinity();
+      } else if(3 == iMod || 4 == iMod) {
+         // non-integer values that repeat
+         featureVals[iSample] = -10.25 + 0.125 * static_cast<double>(iSample % 97);
+      } else {
+         // integer values inside and just outside the cuts
+         featureVals[iSample] = -12.0 + static_cast<double>(iSample % 37);
+      }
+   }
+
+   IntEbm aiBinsExpected[cSamples];
+   ErrorEbm error = Discretize(IntEbm{cSamples}, featureVals, IntEbm{cCuts}, cutsLowerBoundInclusive, aiBinsExpected);
+   CHECK(Error_None == error);
+
+   IntEbm aiBins[cSamples];
+   IntEbm cHits = -1;
+   error = DiscretizeCached(IntEbm{cSamples}, featureVals, IntEbm{cCuts}, cutsLowerBoundInclusive, aiBins, &cHits);
+   CHECK(Error_None == error);
+   CHECK(0 == memcmp(aiBinsExpected, aiBins, sizeof(aiBins)));
+   CHECK(IntEbm{0} < cHits);
+   CHECK(cHits < IntEbm{cSamples});
+
+   // below the cache threshold we defer to Discretize and report no hits
+   error = DiscretizeCached(IntEbm{cSamples}, featureVals, IntEbm{3}, cutsLowerBoundInclusive, aiBins, &cHits);
+   CHECK(Error_None == error);
+   CHECK(IntEbm{0} == cHits);
+}
+
+TEST_CASE("DiscretizeCached, non-integer that rounds onto an integer offset") {
+   static constexpr size_t cCuts = 8;
+   static constexpr size_t cSamples = 64;
+
+   const double justAboveOne = std::nextafter(1.0, 2.0);
+
+   // cutLow is negative, so val - intLow rounds 1 + 2^-52 onto the integer offset that 1 uses
+   const double cutsLowerBoundInclusive[cCuts] = {-3.5, -2.0, -1.0, 0.0, 1.0, justAboveOne, 2.0, 3.5};
+
+   double featureVals[cSamples];
+   for(size_t iSample = 0; iSample < cSamples; ++iSample) {
+      const size_t iMod = iSample % 4;
+      if(0 == iMod) {
+         featureVals[iSample] = 1.0;
+      } else if(1 == iMod) {
+         featureVals[iSample] = justAboveOne;
+      } else if(2 == iMod) {
+         featureVals[iSample] = std::nextafter(1.0, 0.0);
+      } else {
+         featureVals[iSample] = -3.0 + static_cast<double>(iSample % 7);
+      }
+   }
+
+   IntEbm aiBinsExpected[cSamples];
+   ErrorEbm error = Discretize(IntEbm{cSamples}, featureVals, IntEbm{cCuts}, cutsLowerBoundInclusive, aiBinsExpected);
+   CHECK(Error_None == error);
+   CHECK(aiBinsExpected[0] != aiBinsExpected[1]);
+
+   IntEbm aiBins[cSamples];
+   IntEbm cHits = -1;
+   error = DiscretizeCached(IntEbm{cSamples}, featureVals, IntEbm{cCuts}, cutsLowerBoundInclusive, aiBins, &cHits);
+   CHECK(Error_None == error);
+   CHECK(0 == memcmp(aiBinsExpected, aiBins, sizeof(aiBins)));
+   CHECK(IntEbm{0} < cHits);
+}
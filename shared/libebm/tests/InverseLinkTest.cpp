@@ -0,0 +1,188 @@
+// Copyright (c) 2023 The InterpretML Contributors
+// Licensed under the MIT license.
+// Author: Paul Koch <code@koch.ninja>
+
+#include "pch_test.hpp"
+
+#include "libebm.h"
+#include "libebm_test.hpp"
+
+static constexpr TestPriority k_filePriority = TestPriority::InverseLink;
+
+static constexpr AccelerationFlags k_accelerations[] = {AccelerationFlags_NONE, AccelerationFlags_ALL};
+
+static uint64_t UlpDistance(const double val, const double expected) {
+   // map the doubles onto an integer line where adjacent representable values differ by 1
+   int64_t iVal;
+   int64_t iExpected;
+   memcpy(&iVal, &val, sizeof(iVal));
+   memcpy(&iExpected, &expected, sizeof(iExpected));
+   const uint64_t uVal = iVal < 0 ? uint64_t{0x8000000000000000} - static_cast<uint64_t>(iVal) :
+                                    static_cast<uint64_t>(iVal) + uint64_t{0x8000000000000000};
+   const uint64_t uExpected = iExpected < 0 ?
+         uint64_t{0x8000000000000000} - static_cast<uint64_t>(iExpected) :
+         static_cast<uint64_t>(iExpected) + uint64_t{0x8000000000000000};
+   return uVal < uExpected ? uExpected - uVal : uVal - uExpected;
+}
+
+TEST_CASE("InverseLink, logit") {
+   for(const AccelerationFlags acceleration : k_accelerations) {
+      // more than one SIMD pack and a partial pack at the end
+      std::vector<double> scores;
+      for(int i = 0; i < 37; ++i) {
+         scores.push_back(static_cast<double>(i - 18) * 0.5);
+      }
+      scores.push_back(std::numeric_limits<double>::infinity());
+      scores.push_back(-std::numeric_limits<double>::infinity());
+      scores.push_back(std::numeric_limits<double>::quiet_NaN());
+      std::vector<double> preds = scores;
+
+      const ErrorEbm error = InverseLink(
+            acceleration, Link_logit, 0.0, static_cast<IntEbm>(preds.size()), 1, &preds[0]);
+      CHECK(Error_None == error);
+      for(size_t i = 0; i < 37; ++i) {
+         CHECK_APPROX_TOLERANCE(preds[i], 1.0 / (1.0 + std::exp(-scores[i])), 1e-6);
+      }
+      CHECK(1.0 == preds[37]);
+      CHECK(0.0 == preds[38]);
+      CHECK(std::isnan(preds[39]));
+   }
+}
+
+TEST_CASE("InverseLink, mlogit") {
+   for(const AccelerationFlags acceleration : k_accelerations) {
+      static constexpr size_t cScores = 3;
+      std::vector<double> scores;
+      for(int i = 0; i < 19; ++i) {
+         scores.push_back(static_cast<double>(i % 5) - 2.0);
+         scores.push_back(static_cast<double>(i % 3) * 1.5);
+         scores.push_back(static_cast<double>(i % 7) * -0.25);
+      }
+      std::vector<double> preds = scores;
+
+      const ErrorEbm error = InverseLink(acceleration,
+            Link_mlogit,
+            0.0,
+            static_cast<IntEbm>(preds.size() / cScores),
+            IntEbm{cScores},
+            &preds[0]);
+      CHECK(Error_None == error);
+      for(size_t iSample = 0; iSample < scores.size() / cScores; ++iSample) {
+         double sum = 0.0;
+         for(size_t iScore = 0; iScore < cScores; ++iScore) {
+            sum += std::exp(scores[iSample * cScores + iScore]);
+         }
+         for(size_t iScore = 0; iScore < cScores; ++iScore) {
+            CHECK_APPROX_TOLERANCE(
+                  preds[iSample * cScores + iScore], std::exp(scores[iSample * cScores + iScore]) / sum, 1e-6);
+         }
+      }
+   }
+}
+
+TEST_CASE("InverseLink, mlogit infinities") {
+   for(const AccelerationFlags acceleration : k_accelerations) {
+      const double inf = std::numeric_limits<double>::infinity();
+      double preds[] = {inf, 0.0, inf, -inf, -inf, -inf};
+
+      const ErrorEbm error = InverseLink(acceleration, Link_mlogit, 0.0, 2, 3, preds);
+      CHECK(Error_None == error);
+      CHECK(0.5 == preds[0]);
+      CHECK(0.0 == preds[1]);
+      CHECK(0.5 == preds[2]);
+      CHECK_APPROX(preds[3], 1.0 / 3.0);
+      CHECK_APPROX(preds[4], 1.0 / 3.0);
+      CHECK_APPROX(preds[5], 1.0 / 3.0);
+   }
+}
+
+TEST_CASE("InverseLink, log and probit") {
+   for(const AccelerationFlags acceleration : k_accelerations) {
+      double preds[] = {-3.0, 0.0, 0.25, 4.0, 10.0};
+      const double scores[] = {-3.0, 0.0, 0.25, 4.0, 10.0};
+
+      ErrorEbm error = InverseLink(acceleration, Link_log, 0.0, 5, 1, preds);
+      CHECK(Error_None == error);
+      for(size_t i = 0; i < 5; ++i) {
+         CHECK_APPROX_TOLERANCE(preds[i], std::exp(scores[i]), 1e-6);
+      }
+
+      memcpy(preds, scores, sizeof(preds));
+      error = InverseLink(acceleration, Link_probit, 0.0, 5, 1, preds);
+      CHECK(Error_None == error);
+      CHECK_APPROX(preds[1], 0.5);
+      CHECK_APPROX(preds[3], 0.99996832875816688);
+   }
+}
+
+TEST_CASE("InverseLink, illegal") {
+   double preds[] = {0.0, 0.0};
+   CHECK(Error_IllegalParamVal == InverseLink(AccelerationFlags_NONE, Link_logit, 0.0, 1, 2, preds));
+   CHECK(Error_IllegalParamVal == InverseLink(AccelerationFlags_NONE, Link_custom_binary, 0.0, 2, 1, preds));
+   CHECK(Error_IllegalParamVal == InverseLink(AccelerationFlags_NONE, Link_logit, 0.0, -1, 1, preds));
+   CHECK(Error_None == InverseLink(AccelerationFlags_NONE, Link_logit, 0.0, 0, 1, nullptr));
+}
+
+TEST_CASE("InverseLink, power") {
+   for(const AccelerationFlags acceleration : k_accelerations) {
+      // CPU is double precision through our bundled Exp64/Log64.  The ulp bound is checked in the test below
+      const double tolerance = AccelerationFlags_NONE == acceleration ? 1e-14 : 1e-5;
+      for(const double linkParam : {0.5, -1.0, 1.5}) {
+         double preds[] = {0.0, 0.125, 1.0, 2.0, 3.75, 100.0, 12345.5};
+         const double scores[] = {0.0, 0.125, 1.0, 2.0, 3.75, 100.0, 12345.5};
+
+         const ErrorEbm error = InverseLink(acceleration, Link_power, linkParam, 7, 1, preds);
+         CHECK(Error_None == error);
+         for(size_t i = 0; i < 7; ++i) {
+            CHECK_APPROX_TOLERANCE(preds[i], std::pow(scores[i], 1.0 / linkParam), tolerance);
+         }
+      }
+   }
+}
+
+TEST_CASE("InverseLink, ulp accuracy of the CPU log and logit links") {
+   std::vector<double> scores;
+   for(int i = 0; i <= 20000; ++i) {
+      scores.push_back(-700.0 + static_cast<double>(i) * 0.07);
+   }
+
+   std::vector<double> preds = scores;
+   ErrorEbm error = InverseLink(
+         AccelerationFlags_NONE, Link_log, 0.0, static_cast<IntEbm>(preds.size()), 1, &preds[0]);
+   CHECK(Error_None == error);
+   uint64_t maxUlps = 0;
+   for(size_t i = 0; i < scores.size(); ++i) {
+      maxUlps = std::max(maxUlps, UlpDistance(preds[i], std::exp(scores[i])));
+   }
+   CHECK(maxUlps <= 2);
+
+   preds = scores;
+   error = InverseLink(AccelerationFlags_NONE, Link_logit, 0.0, static_cast<IntEbm>(preds.size()), 1, &preds[0]);
+   CHECK(Error_None == error);
+   maxUlps = 0;
+   for(size_t i = 0; i < scores.size(); ++i) {
+      maxUlps = std::max(maxUlps, UlpDistance(preds[i], 1.0 / (1.0 + std::exp(-scores[i]))));
+   }
+   // the reference rounds twice itself, so allow a little more than for the log link
+   CHECK(maxUlps <= 4);
+}
+
+TEST_CASE("InverseLink, ulp accuracy of the CPU power link") {
+   std::vector<double> scores;
+   for(int i = 0; i <= 20000; ++i) {
+      scores.push_back(static_cast<double>(i) * 0.0625 + static_cast<double>(i) * static_cast<double>(i) * 0.001);
+   }
+   for(const double linkParam : {0.25, 0.5, 1.5, 2.0, 3.0, -0.5, -1.0}) {
+      std::vector<double> preds = scores;
+      const ErrorEbm error = InverseLink(
+            AccelerationFlags_NONE, Link_power, linkParam, static_cast<IntEbm>(preds.size()), 1, &preds[0]);
+      CHECK(Error_None == error);
+      for(size_t i = 0; i < scores.size(); ++i) {
+         const double expected = std::pow(scores[i], 1.0 / linkParam);
+         // pow is Exp64(Log64(x) / linkParam), so the rounding of the intermediate log is magnified by the size of the
+         // exponent.  Allow a couple ulps for each unit of |log(result)| on top of the Exp64 and Log64 errors.
+         const double allowed = 4.0 + 2.0 * std::abs(std::log(expected));
+         CHECK(static_cast<double>(UlpDistance(preds[i], expected)) <= allowed);
+      }
+   }
+}
@@ -894,6 +894,160 @@ TEST_CASE("SafeStandardDeviation, 4 values, zero weights") {
    CHECK_APPROX(stddev, 41.493034053922834);
 }
 
+TEST_CASE("FinalizeBaggedTerms, two bags, two terms") {
+   const IntEbm dimensionCounts[]{1, 1};
+   const IntEbm binCounts[]{3, 2};
+   // the missing bin of the first term has no weight, so it gets zeroed after centering
+   const double binWeights[]{0.0, 1.0, 3.0, 1.0, 1.0};
+   double bagIntercepts[]{1.0, 2.0};
+   double bagScores[]{5.0, 2.0, 6.0, 7.0, 4.0, 0.0, 1.0, 3.0, 0.0, 0.0};
+   double termScores[5];
+   double standardDeviations[5];
+
+   const ErrorEbm error = FinalizeBaggedTerms(2,
+         1,
+         2,
+         dimensionCounts,
+         binCounts,
+         binWeights,
+         nullptr,
+         0,
+         bagIntercepts,
+         bagScores,
+         termScores,
+         standardDeviations);
+   CHECK(Error_None == error);
+
+   CHECK_APPROX(bagIntercepts[0], 8.0);
+   CHECK_APPROX(bagIntercepts[1], 3.0);
+
+   const double expectedBagScores[]{0.0, -3.0, 1.0, 0.0, 3.0, -1.0, -1.0, 1.0, 0.0, 0.0};
+   for(size_t i = 0; i < sizeof(expectedBagScores) / sizeof(expectedBagScores[0]); ++i) {
+      CHECK_APPROX(bagScores[i], expectedBagScores[i]);
+   }
+
+   const double expectedTermScores[]{0.0, 0.0, 0.0, -0.5, 0.5};
+   const double expectedStandardDeviations[]{0.0, 3.0, 1.0, 0.5, 0.5};
+   for(size_t i = 0; i < sizeof(expectedTermScores) / sizeof(expectedTermScores[0]); ++i) {
+      CHECK_APPROX(termScores[i], expectedTermScores[i]);
+      CHECK_APPROX(standardDeviations[i], expectedStandardDeviations[i]);
+   }
+}
+
+TEST_CASE("FinalizeBaggedTerms, multiclass pair with non-finite score") {
+   const IntEbm dimensionCounts[]{2};
+   const IntEbm binCounts[]{2, 2};
+   // the last slice of the first dimension has no weight
+   const double binWeights[]{1.0, 1.0, 0.0, 0.0};
+   double bagIntercepts[]{10.0, 20.0};
+   const double nan = std::numeric_limits<double>::quiet_NaN();
+   double bagScores[]{1.0, 4.0, 3.0, nan, 9.0, 9.0, 9.0, 9.0};
+   double termScores[8];
+   double standardDeviations[8];
+
+   const ErrorEbm error = FinalizeBaggedTerms(1,
+         2,
+         1,
+         dimensionCounts,
+         binCounts,
+         binWeights,
+         nullptr,
+         1,
+         bagIntercepts,
+         bagScores,
+         termScores,
+         standardDeviations);
+   CHECK(Error_None == error);
+
+   // the NaN cell is excluded from the mean of the second score
+   CHECK_APPROX(bagIntercepts[0], 12.0);
+   CHECK_APPROX(bagIntercepts[1], 24.0);
+
+   CHECK_APPROX(bagScores[0], -1.0);
+   CHECK_APPROX(bagScores[1], 0.0);
+   CHECK_APPROX(bagScores[2], 1.0);
+   CHECK(std::isnan(bagScores[3]));
+   for(size_t i = 4; i < 8; ++i) {
+      CHECK(0.0 == bagScores[i]);
+   }
+
+   CHECK(std::isnan(termScores[3]));
+   CHECK(std::isnan(standardDeviations[3]));
+   CHECK_APPROX(termScores[0], -1.0);
+   CHECK(0.0 == standardDeviations[0]);
+}
+
+TEST_CASE("FinalizeBaggedTerms, zero bins") {
+   const IntEbm dimensionCounts[]{1};
+   const IntEbm binCounts[]{0};
+   const double binWeights[]{0.0};
+   double bagIntercepts[]{0.0};
+   double bagScores[]{0.0};
+   double termScores[1];
+   double standardDeviations[1];
+
+   const ErrorEbm error = FinalizeBaggedTerms(1,
+         1,
+         1,
+         dimensionCounts,
+         binCounts,
+         binWeights,
+         nullptr,
+         0,
+         bagIntercepts,
+         bagScores,
+         termScores,
+         standardDeviations);
+   CHECK(Error_IllegalParamVal == error);
+}
+
+TEST_CASE("MonotonizeBaggedTerm, two bags, increasing with passthrough") {
+   // missing, 3 ordered bins, unseen.  The middle ordered bin has no weight so it is interpolated
+   const double binWeights[]{1.0, 1.0, 0.0, 3.0, 0.0};
+   double bagIntercepts[]{0.0, 0.0};
+   double bagScores[]{0.0, 4.0, 9.0, 0.0, 0.0, 0.0, 1.0, 5.0, 3.0, 0.0};
+   double termScores[5];
+   double standardDeviations[5];
+
+   ErrorEbm error = MonotonizeBaggedTerm(
+         2, 5, EBM_TRUE, 0.0, binWeights, nullptr, bagIntercepts, bagScores, termScores, standardDeviations);
+   CHECK(Error_None == error);
+
+   // the first bag pools 4 and 0 into their weighted mean of 1 and the second bag is already increasing
+   const double expectedBagScores[]{0.0, 1.0, 1.0, 1.0, 0.0, 0.0, 1.0, 2.0, 3.0, 0.0};
+   for(size_t i = 0; i < sizeof(expectedBagScores) / sizeof(expectedBagScores[0]); ++i) {
+      CHECK_APPROX(bagScores[i], expectedBagScores[i]);
+   }
+   CHECK(0.0 == bagIntercepts[0]);
+   CHECK(0.0 == bagIntercepts[1]);
+
+   CHECK_APPROX(termScores[1], 1.0);
+   CHECK_APPROX(termScores[2], 1.5);
+   CHECK_APPROX(termScores[3], 2.0);
+   CHECK_APPROX(standardDeviations[1], 0.0);
+   CHECK_APPROX(standardDeviations[2], 0.5);
+   CHECK_APPROX(standardDeviations[3], 1.0);
+
+   // decreasing with full passthrough re-centers each bag over all the bins, including missing
+   double bagScoresDown[]{2.0, 1.0, 0.0, 3.0, 0.0};
+   double bagInterceptDown[]{10.0};
+   error = MonotonizeBaggedTerm(
+         1, 5, EBM_FALSE, 1.0, binWeights, nullptr, bagInterceptDown, bagScoresDown, termScores, standardDeviations);
+   CHECK(Error_None == error);
+   // 1 and 3 pool to 2.5, then the weighted mean of (2, 2.5, 2.5, 2.5, 0) is 2.4
+   CHECK_APPROX(bagInterceptDown[0], 12.4);
+   CHECK_APPROX(bagScoresDown[0], -0.4);
+   CHECK_APPROX(bagScoresDown[1], 0.1);
+   CHECK_APPROX(bagScoresDown[2], 0.1);
+   CHECK_APPROX(bagScoresDown[3], 0.1);
+   CHECK_APPROX(termScores[3], 0.1);
+   CHECK(0.0 == standardDeviations[3]);
+
+   error = MonotonizeBaggedTerm(
+         1, 5, EBM_TRUE, 1.5, binWeights, nullptr, bagInterceptDown, bagScoresDown, termScores, standardDeviations);
+   CHECK(Error_IllegalParamVal == error);
+}
+
 // # this function calculates the weighted standard deviation
 // def _weighted_std(a, axis, weights):
 //     if weights is None:
@@ -597,6 +597,7 @@ TEST_CASE("mono-classification") {
          k_categoricalSmoothingDefault,
          k_maxCategoricalThresholdDefault,
          k_categoricalInclusionPercentDefault,
+         k_randomRetriesDefault,
          &k_leavesMaxDefault[0],
          nullptr,
          &avgGain);
@@ -1635,6 +1636,156 @@ TEST_CASE("Random splitting, no splits, binary, sums") {
    CHECK_APPROX_TOLERANCE(validationMetric, 0.69314718055994529, double{1e-1});
 }
 
+static std::vector<TestSample> MakeRandomSplitStepSamples() {
+   // 3 samples in each of 10 bins with a step between bins 5 and 6, so the best single cut is at 6
+   std::vector<TestSample> samples;
+   for(IntEbm iBin = 0; iBin < 10; ++iBin) {
+      for(int iSample = 0; iSample < 3; ++iSample) {
+         samples.push_back(TestSample({iBin}, iBin < 6 ? 0.0 : 10.0));
+      }
+   }
+   return samples;
+}
+
+static IntEbm GenerateRandomSplitUpdate(TestBoost& test,
+      const TermBoostFlags flags,
+      const IntEbm minSamplesLeaf,
+      const IntEbm randomRetries,
+      IntEbm* const pSplitOut,
+      double* const pGainOut) {
+   static const std::vector<IntEbm> k_leavesMax = {IntEbm{2}};
+
+   ErrorEbm error = GenerateTermUpdate(nullptr,
+         test.GetBoosterHandle(),
+         0,
+         flags,
+         k_learningRateDefault,
+         minSamplesLeaf,
+         k_minHessianDefault,
+         k_regAlphaDefault,
+         k_regLambdaDefault,
+         k_maxDeltaStepDefault,
+         k_minCategorySamplesDefault,
+         k_categoricalSmoothingDefault,
+         k_maxCategoricalThresholdDefault,
+         k_categoricalInclusionPercentDefault,
+         randomRetries,
+         &k_leavesMax[0],
+         nullptr,
+         pGainOut);
+   if(Error_None != error) {
+      return IntEbm{-1};
+   }
+   // the split array needs room for a cut between every pair of the 10 bins
+   IntEbm splits[9];
+   IntEbm countSplits = 9;
+   error = GetTermUpdateSplits(test.GetBoosterHandle(), 0, &countSplits, splits);
+   if(Error_None != error) {
+      return IntEbm{-1};
+   }
+   if(IntEbm{1} == countSplits) {
+      *pSplitOut = splits[0];
+   }
+   return countSplits;
+}
+
+TEST_CASE("Random splitting with retries, finds the greedy cut, regression") {
+   TestBoost testGreedy = TestBoost(
+         Task_Regression, {FeatureTest(10)}, {{0}}, MakeRandomSplitStepSamples(), MakeRandomSplitStepSamples());
+   TestBoost testRandom = TestBoost(
+         Task_Regression, {FeatureTest(10)}, {{0}}, MakeRandomSplitStepSamples(), MakeRandomSplitStepSamples());
+
+   IntEbm splitGreedy = 0;
+   double gainGreedy = 0.0;
+   GenerateRandomSplitUpdate(testGreedy, TermBoostFlags_Default, k_minSamplesLeafDefault, 1, &splitGreedy, &gainGreedy);
+   CHECK(0.0 < gainGreedy);
+
+   // with 1 draw the random cut is not scored, so no gain is reported
+   IntEbm splitRandom = 0;
+   double gainRandom = -1.0;
+   CHECK(1 ==
+         GenerateRandomSplitUpdate(
+               testRandom, TermBoostFlags_RandomSplits, k_minSamplesLeafDefault, 1, &splitRandom, &gainRandom));
+   CHECK(0.0 == gainRandom);
+
+   // 9 possible cuts and 64 draws, so the best draw is the greedy cut
+   CHECK(1 ==
+         GenerateRandomSplitUpdate(
+               testRandom, TermBoostFlags_RandomSplits, k_minSamplesLeafDefault, 64, &splitRandom, &gainRandom));
+   CHECK(6 == splitRandom);
+   CHECK_APPROX(gainRandom, gainGreedy);
+}
+
+TEST_CASE("Random splitting with retries is rejected with differential privacy, regression") {
+   TestBoost test = TestBoost(Task_Regression,
+         {FeatureTest(10)},
+         {{0}},
+         MakeRandomSplitStepSamples(),
+         MakeRandomSplitStepSamples(),
+         k_countInnerBagsDefault,
+         CreateBoosterFlags_DifferentialPrivacy);
+
+   IntEbm split = 0;
+   double gain = 0.0;
+
+   // a single draw never looks at the gain, so it stays private
+   CHECK(1 == GenerateRandomSplitUpdate(test, TermBoostFlags_RandomSplits, k_minSamplesLeafDefault, 1, &split, &gain));
+
+   // picking the best of several draws by gain would spend privacy that nothing accounts for
+   CHECK(-1 == GenerateRandomSplitUpdate(test, TermBoostFlags_RandomSplits, k_minSamplesLeafDefault, 8, &split, &gain));
+}
+
+TEST_CASE("Random splitting with minimum leaf rules, regression") {
+   TestBoost test = TestBoost(
+         Task_Regression, {FeatureTest(10)}, {{0}}, MakeRandomSplitStepSamples(), MakeRandomSplitStepSamples());
+
+   IntEbm split = 0;
+   double gain = 0.0;
+
+   // 30 samples cannot make 2 leaves of 16 samples each, so the hard rule refuses every cut
+   CHECK(0 ==
+         GenerateRandomSplitUpdate(
+               test, TermBoostFlags_RandomSplits | TermBoostFlags_RandomMinLeafHard, 16, 8, &split, &gain));
+   CHECK(0.0 == gain);
+
+   // the soft rule still cuts when every draw is too small
+   CHECK(1 ==
+         GenerateRandomSplitUpdate(
+               test, TermBoostFlags_RandomSplits | TermBoostFlags_RandomMinLeafSoft, 16, 8, &split, &gain));
+
+   for(IntEbm randomRetries = 1; randomRetries <= 16; ++randomRetries) {
+      // only the cuts at 4, 5 and 6 leave at least 12 samples on each side
+      const IntEbm countSplits = GenerateRandomSplitUpdate(
+            test, TermBoostFlags_RandomSplits | TermBoostFlags_RandomMinLeafHard, 12, randomRetries, &split, &gain);
+      CHECK(0 == countSplits || 1 == countSplits);
+      if(1 == countSplits) {
+         CHECK(4 <= split && split <= 6);
+      }
+   }
+
+   // both rules at once is illegal
+   double gainIllegal = 0.0;
+   const ErrorEbm error = GenerateTermUpdate(nullptr,
+         test.GetBoosterHandle(),
+         0,
+         TermBoostFlags_RandomSplits | TermBoostFlags_RandomMinLeafHard | TermBoostFlags_RandomMinLeafSoft,
+         k_learningRateDefault,
+         12,
+         k_minHessianDefault,
+         k_regAlphaDefault,
+         k_regLambdaDefault,
+         k_maxDeltaStepDefault,
+         k_minCategorySamplesDefault,
+         k_categoricalSmoothingDefault,
+         k_maxCategoricalThresholdDefault,
+         k_categoricalInclusionPercentDefault,
+         k_randomRetriesDefault,
+         &k_leavesMaxDefault[0],
+         nullptr,
+         &gainIllegal);
+   CHECK(Error_IllegalParamVal == error);
+}
+
 TEST_CASE("zero gain, boosting, regression") {
    // construct a case where there should be zero gain and test that we get zero.
 
@@ -2254,6 +2405,297 @@ TEST_CASE("missing category nominal, boosting, regression") {
    CHECK_APPROX(termScore, 30.0);
 }
 
+TEST_CASE("monotone pair and multiclass terms, boosting") {
+   // the target falls with feature 0 while feature 0 is constrained to be increasing, so an unconstrained split would
+   // be the wrong way around.  Bin 0 holds missing values, which are not ordered.
+   for(const TaskEbm cClasses : {TaskEbm{Task_Regression}, TaskEbm{3}}) {
+      std::vector<TestSample> train;
+      for(IntEbm iRepeat = 0; iRepeat < 3; ++iRepeat) {
+         for(IntEbm i0 = 1; i0 < 6; ++i0) {
+            for(IntEbm i1 = 0; i1 < 6; ++i1) {
+               const IntEbm target = 10 * i1 - 2 * i0 + (i0 * i1 + iRepeat) % 3;
+               train.push_back(TestSample({i0, i1},
+                     static_cast<double>(Task_Regression == cClasses ? target : (target + 100) % cClasses)));
+            }
+         }
+         train.push_back(TestSample({0, iRepeat}, Task_Regression == cClasses ? 50.0 : 1.0));
+      }
+      const size_t cScores = GetCountScores(cClasses);
+
+      for(const TermBoostFlags flags :
+            {TermBoostFlags_Default, TermBoostFlags_Corners, TermBoostFlags_Straight, TermBoostFlags_DeepTree}) {
+         TestBoost test = TestBoost(cClasses,
+               {FeatureTest(6, true, true, false), FeatureTest(6, true, true, false)},
+               {{0, 1}, {0}},
+               train,
+               {train[0]});
+
+         for(size_t iRound = 0; iRound < 20; ++iRound) {
+            for(IntEbm iTerm = 0; iTerm < 2; ++iTerm) {
+               test.Boost(iTerm,
+                     flags,
+                     0.5,
+                     k_minSamplesLeafDefault,
+                     k_minHessianDefault,
+                     k_regAlphaDefault,
+                     k_regLambdaDefault,
+                     k_maxDeltaStepDefault,
+                     k_minCategorySamplesDefault,
+                     k_categoricalSmoothingDefault,
+                     k_maxCategoricalThresholdDefault,
+                     k_categoricalInclusionPercentDefault,
+                     {4, 4},
+                     {MONOTONE_INCREASING, MONOTONE_NONE});
+            }
+         }
+
+         for(size_t iScore = 0; iScore < cScores; ++iScore) {
+            for(size_t i0 = 2; i0 < 6; ++i0) {
+               CHECK(test.GetCurrentTermScore(1, {i0 - 1}, iScore) <= test.GetCurrentTermScore(1, {i0}, iScore));
+               for(size_t i1 = 0; i1 < 6; ++i1) {
+                  // term scores come back transposed, so the index of feature 1 comes first
+                  CHECK(test.GetCurrentTermScore(0, {i1, i0 - 1}, iScore) <=
+                        test.GetCurrentTermScore(0, {i1, i0}, iScore));
+               }
+            }
+         }
+
+         if(Task_Regression == cClasses) {
+            // the pair is still free to follow feature 1 instead of collapsing into a single update
+            CHECK(test.GetCurrentTermScore(0, {1, 3}, 0) < test.GetCurrentTermScore(0, {5, 3}, 0));
+         }
+      }
+   }
+}
+
+TEST_CASE("straight cuts on a pair, boosting, regression") {
+   // one cut per dimension fits this target exactly, at 3 along feature 0 and at 2 along feature 1
+   std::vector<TestSample> train;
+   for(IntEbm iRepeat = 0; iRepeat < 2; ++iRepeat) {
+      for(IntEbm i0 = 1; i0 < 5; ++i0) {
+         for(IntEbm i1 = 1; i1 < 5; ++i1) {
+            const double target = (3 <= i0 ? 10.0 : 0.0) + (i1 < 2 ? 5.0 : 0.0) + (3 <= i0 && 2 <= i1 ? 7.0 : 0.0);
+            train.push_back(TestSample({i0, i1}, target));
+         }
+      }
+   }
+
+   TestBoost test = TestBoost(Task_Regression, {FeatureTest(6), FeatureTest(6)}, {{0, 1}}, train, {train[0]});
+
+   static const std::vector<IntEbm> k_leavesMax = {IntEbm{3}, IntEbm{3}};
+   double gain = 0.0;
+   ErrorEbm error = GenerateTermUpdate(nullptr,
+         test.GetBoosterHandle(),
+         0,
+         TermBoostFlags_Straight,
+         k_learningRateDefault,
+         k_minSamplesLeafDefault,
+         k_minHessianDefault,
+         k_regAlphaDefault,
+         k_regLambdaDefault,
+         k_maxDeltaStepDefault,
+         k_minCategorySamplesDefault,
+         k_categoricalSmoothingDefault,
+         k_maxCategoricalThresholdDefault,
+         k_categoricalInclusionPercentDefault,
+         k_randomRetriesDefault,
+         &k_leavesMax[0],
+         nullptr,
+         &gain);
+   CHECK(Error_None == error);
+   CHECK(0.0 < gain);
+
+   IntEbm splits[5];
+   IntEbm countSplits = 5;
+   error = GetTermUpdateSplits(test.GetBoosterHandle(), 0, &countSplits, splits);
+   CHECK(Error_None == error);
+   CHECK(1 == countSplits);
+   CHECK(3 == splits[0]);
+   countSplits = 5;
+   error = GetTermUpdateSplits(test.GetBoosterHandle(), 1, &countSplits, splits);
+   CHECK(Error_None == error);
+   CHECK(1 == countSplits);
+   CHECK(2 == splits[0]);
+
+   // each cell of the 2x2 update moves toward the mean target of that cell
+   double updates[6 * 6];
+   error = GetTermUpdate(test.GetBoosterHandle(), updates);
+   CHECK(Error_None == error);
+   CHECK_APPROX(updates[1 + 6 * 1], 5.0 * k_learningRateDefault);
+   CHECK_APPROX(updates[4 + 6 * 4], 17.0 * k_learningRateDefault);
+   CHECK_APPROX(updates[4 + 6 * 1] + updates[1 + 6 * 4], 15.0 * k_learningRateDefault);
+
+   // feature 0 is capped at one leaf, so only feature 1 is cut.  Its best cut still separates i1 = 1, whose mean
+   // target is 10, from the rest, whose mean target is 8.5
+   static const std::vector<IntEbm> k_leavesMaxCapped = {IntEbm{1}, IntEbm{3}};
+   error = GenerateTermUpdate(nullptr,
+         test.GetBoosterHandle(),
+         0,
+         TermBoostFlags_Straight,
+         k_learningRateDefault,
+         k_minSamplesLeafDefault,
+         k_minHessianDefault,
+         k_regAlphaDefault,
+         k_regLambdaDefault,
+         k_maxDeltaStepDefault,
+         k_minCategorySamplesDefault,
+         k_categoricalSmoothingDefault,
+         k_maxCategoricalThresholdDefault,
+         k_categoricalInclusionPercentDefault,
+         k_randomRetriesDefault,
+         &k_leavesMaxCapped[0],
+         nullptr,
+         &gain);
+   CHECK(Error_None == error);
+   CHECK(0.0 < gain);
+
+   countSplits = 5;
+   error = GetTermUpdateSplits(test.GetBoosterHandle(), 0, &countSplits, splits);
+   CHECK(Error_None == error);
+   CHECK(0 == countSplits);
+   countSplits = 5;
+   error = GetTermUpdateSplits(test.GetBoosterHandle(), 1, &countSplits, splits);
+   CHECK(Error_None == error);
+   CHECK(1 == countSplits);
+   CHECK(2 == splits[0]);
+
+   error = GetTermUpdate(test.GetBoosterHandle(), updates);
+   CHECK(Error_None == error);
+   // feature 1 changes fastest in the update, and the update no longer depends on feature 0
+   CHECK_APPROX(updates[1 + 6 * 1], 10.0 * k_learningRateDefault);
+   CHECK_APPROX(updates[1 + 6 * 4], 10.0 * k_learningRateDefault);
+   CHECK_APPROX(updates[4 + 6 * 1], 8.5 * k_learningRateDefault);
+   CHECK_APPROX(updates[4 + 6 * 4], 8.5 * k_learningRateDefault);
+
+   // straight cuts and corners are two different shapes for the same pair
+   error = GenerateTermUpdate(nullptr,
+         test.GetBoosterHandle(),
+         0,
+         TermBoostFlags_Straight | TermBoostFlags_Corners,
+         k_learningRateDefault,
+         k_minSamplesLeafDefault,
+         k_minHessianDefault,
+         k_regAlphaDefault,
+         k_regLambdaDefault,
+         k_maxDeltaStepDefault,
+         k_minCategorySamplesDefault,
+         k_categoricalSmoothingDefault,
+         k_maxCategoricalThresholdDefault,
+         k_categoricalInclusionPercentDefault,
+         k_randomRetriesDefault,
+         &k_leavesMax[0],
+         nullptr,
+         &gain);
+   CHECK(Error_IllegalParamVal == error);
+}
+
+TEST_CASE("deep tree on a pair, boosting, regression") {
+   // every cell of the 4x4 grid has its own target, so a single update wants far more than 3 leaves
+   std::vector<TestSample> train;
+   for(IntEbm iRepeat = 0; iRepeat < 2; ++iRepeat) {
+      for(IntEbm i0 = 1; i0 < 5; ++i0) {
+         for(IntEbm i1 = 1; i1 < 5; ++i1) {
+            const double target = static_cast<double>(i0 * 10 + i1 * i1);
+            train.push_back(TestSample({i0, i1}, target));
+         }
+      }
+   }
+
+   TestBoost test = TestBoost(Task_Regression, {FeatureTest(6), FeatureTest(6)}, {{0, 1}}, train, {train[0]});
+
+   // separating all 16 cells takes 3 splits along feature 0 and 12 along feature 1
+   static const std::vector<IntEbm> k_leavesMax = {IntEbm{16}, IntEbm{16}};
+   double gain = 0.0;
+   ErrorEbm error = GenerateTermUpdate(nullptr,
+         test.GetBoosterHandle(),
+         0,
+         TermBoostFlags_DeepTree,
+         k_learningRateDefault,
+         k_minSamplesLeafDefault,
+         k_minHessianDefault,
+         k_regAlphaDefault,
+         k_regLambdaDefault,
+         k_maxDeltaStepDefault,
+         k_minCategorySamplesDefault,
+         k_categoricalSmoothingDefault,
+         k_maxCategoricalThresholdDefault,
+         k_categoricalInclusionPercentDefault,
+         k_randomRetriesDefault,
+         &k_leavesMax[0],
+         nullptr,
+         &gain);
+   CHECK(Error_None == error);
+   CHECK(0.0 < gain);
+
+   IntEbm splits[5];
+   IntEbm countSplits0 = 5;
+   error = GetTermUpdateSplits(test.GetBoosterHandle(), 0, &countSplits0, splits);
+   CHECK(Error_None == error);
+   CHECK(3 == countSplits0);
+   IntEbm countSplits1 = 5;
+   error = GetTermUpdateSplits(test.GetBoosterHandle(), 1, &countSplits1, splits);
+   CHECK(Error_None == error);
+   CHECK(3 == countSplits1);
+
+   // every cell moves toward its own target
+   double updates[6 * 6];
+   error = GetTermUpdate(test.GetBoosterHandle(), updates);
+   CHECK(Error_None == error);
+   CHECK_APPROX(updates[4 + 6 * 4], 56.0 * k_learningRateDefault);
+   CHECK_APPROX(updates[3 + 6 * 4], 49.0 * k_learningRateDefault);
+   CHECK_APPROX(updates[2 + 6 * 1], 14.0 * k_learningRateDefault);
+
+   // with 2 leaves per dimension the deep tree is limited to one split along each
+   static const std::vector<IntEbm> k_leavesMaxSmall = {IntEbm{2}, IntEbm{2}};
+   error = GenerateTermUpdate(nullptr,
+         test.GetBoosterHandle(),
+         0,
+         TermBoostFlags_DeepTree,
+         k_learningRateDefault,
+         k_minSamplesLeafDefault,
+         k_minHessianDefault,
+         k_regAlphaDefault,
+         k_regLambdaDefault,
+         k_maxDeltaStepDefault,
+         k_minCategorySamplesDefault,
+         k_categoricalSmoothingDefault,
+         k_maxCategoricalThresholdDefault,
+         k_categoricalInclusionPercentDefault,
+         k_randomRetriesDefault,
+         &k_leavesMaxSmall[0],
+         nullptr,
+         &gain);
+   CHECK(Error_None == error);
+   countSplits0 = 5;
+   error = GetTermUpdateSplits(test.GetBoosterHandle(), 0, &countSplits0, splits);
+   CHECK(Error_None == error);
+   countSplits1 = 5;
+   error = GetTermUpdateSplits(test.GetBoosterHandle(), 1, &countSplits1, splits);
+   CHECK(Error_None == error);
+   CHECK(countSplits0 <= 1);
+   CHECK(countSplits1 <= 1);
+
+   error = GenerateTermUpdate(nullptr,
+         test.GetBoosterHandle(),
+         0,
+         TermBoostFlags_DeepTree | TermBoostFlags_Straight,
+         k_learningRateDefault,
+         k_minSamplesLeafDefault,
+         k_minHessianDefault,
+         k_regAlphaDefault,
+         k_regLambdaDefault,
+         k_maxDeltaStepDefault,
+         k_minCategorySamplesDefault,
+         k_categoricalSmoothingDefault,
+         k_maxCategoricalThresholdDefault,
+         k_categoricalInclusionPercentDefault,
+         k_randomRetriesDefault,
+         &k_leavesMax[0],
+         nullptr,
+         &gain);
+   CHECK(Error_IllegalParamVal == error);
+}
+
 static double RandomizedTesting(const AccelerationFlags acceleration) {
    const IntEbm cTrainSamples = 211; // have some non-SIMD residuals
    const IntEbm cValidationSamples = 101; // have some non-SIMD residuals
@@ -2369,7 +2811,7 @@ static double RandomizedTesting(const AccelerationFlags acceleration) {
 }
 
 TEST_CASE("stress test, boosting") {
-   const double expected = 14219338182453.824;
+   const double expected = 14225740716995.242;
 
    double validationMetricExact = RandomizedTesting(AccelerationFlags_NONE);
    CHECK(validationMetricExact == expected);
@@ -2377,3 +2819,116 @@ TEST_CASE("stress test, boosting") {
    double validationMetricSIMD = RandomizedTesting(AccelerationFlags_ALL);
    CHECK_APPROX_TOLERANCE(validationMetricSIMD, expected, 1e-2);
 }
+
+TEST_CASE("pack by feature, boosting, matches per term packing") {
+   auto rng = MakeRng(0);
+   const std::vector<FeatureTest> features = {
+         FeatureTest(10, false, false, false),
+         FeatureTest(3, true, false, false),
+         FeatureTest(300, false, true, false),
+         FeatureTest(2, true, false, true),
+   };
+   auto terms = MakeMains(features);
+   terms.push_back({0, 1});
+   terms.push_back({1, 0});
+   terms.push_back({0, 0});
+   terms.push_back({2, 3, 1});
+   terms.push_back({0, 1, 2});
+
+   for(const AccelerationFlags acceleration : {AccelerationFlags_NONE, AccelerationFlags_ALL}) {
+      for(IntEbm classesCount = Task_Regression; classesCount < 4; ++classesCount) {
+         if(classesCount != Task_Regression && classesCount < 2) {
+            continue;
+         }
+         // have some non-SIMD residuals
+         const auto train = MakeRandomDataset(rng, classesCount, 211, features);
+         const auto validation = MakeRandomDataset(rng, classesCount, 101, features);
+
+         TestBoost testTerm = TestBoost(
+               classesCount, features, terms, train, validation, 2, k_testCreateBoosterFlags_Default, acceleration);
+         TestBoost testFeature = TestBoost(classesCount,
+               features,
+               terms,
+               train,
+               validation,
+               2,
+               k_testCreateBoosterFlags_Default | CreateBoosterFlags_PackByFeature,
+               acceleration);
+
+         for(size_t iRound = 0; iRound < 20; ++iRound) {
+            for(IntEbm iTerm = 0; iTerm < static_cast<IntEbm>(terms.size()); ++iTerm) {
+               const double metricTerm = testTerm.Boost(iTerm).validationMetric;
+               const double metricFeature = testFeature.Boost(iTerm).validationMetric;
+               CHECK(metricTerm == metricFeature);
+            }
+         }
+      }
+   }
+}
+
+static IntEbm g_cReplayedCalls;
+static IntEbm g_cReplayedMismatches;
+static IntEbm g_cReplayedErrors;
+static IntEbm g_cReplayedTermUpdates;
+
+static void EBM_CALLING_CONVENTION CountReplayedCall(
+      IntEbm indexCall, const char* apiName, ErrorEbm error, double seconds) {
+   // CHECK needs the test case, so tally anything unexpected for the test to check afterwards
+   if(g_cReplayedCalls != indexCall || seconds < 0.0) {
+      ++g_cReplayedMismatches;
+   }
+   ++g_cReplayedCalls;
+   if(Error_None != error) {
+      ++g_cReplayedErrors;
+   }
+   if(0 == strcmp(apiName, "GenerateTermUpdate")) {
+      ++g_cReplayedTermUpdates;
+   }
+}
+
+TEST_CASE("record and replay, boosting and interactions") {
+   static constexpr char k_filename[] = "libebm_test_recording.bin";
+
+   CHECK(Error_IllegalParamVal == StopRecording());
+   CHECK(Error_None == StartRecording(k_filename));
+   CHECK(Error_IllegalParamVal == StartRecording(k_filename));
+
+   auto rng = MakeRng(0);
+   const std::vector<FeatureTest> features = {
+         FeatureTest(5, false, false, false),
+         FeatureTest(3, true, false, false),
+   };
+   const auto train = MakeRandomDataset(rng, 3, 53, features);
+   const auto validation = MakeRandomDataset(rng, 3, 17, features);
+   {
+      auto terms = MakeMains(features);
+      terms.push_back({0, 1});
+      TestBoost test = TestBoost(3, features, terms, train, validation);
+      for(size_t iRound = 0; iRound < 4; ++iRound) {
+         for(IntEbm iTerm = 0; iTerm < static_cast<IntEbm>(terms.size()); ++iTerm) {
+            test.Boost(iTerm);
+         }
+      }
+
+      TestInteraction interaction = TestInteraction(3, features, train);
+      interaction.TestCalcInteractionStrength({0, 1});
+   }
+
+   CHECK(Error_None == StopRecording());
+
+   g_cReplayedCalls = 0;
+   g_cReplayedMismatches = 0;
+   g_cReplayedErrors = 0;
+   g_cReplayedTermUpdates = 0;
+   CHECK(Error_None == ReplayRecording(k_filename, &CountReplayedCall));
+   // CreateBooster, 12 rounds of GenerateTermUpdate/SetTermUpdate/ApplyTermUpdate, FreeBooster, and the 3 interaction
+   // calls
+   CHECK(IntEbm{41} == g_cReplayedCalls);
+   CHECK(IntEbm{0} == g_cReplayedMismatches);
+   CHECK(IntEbm{0} == g_cReplayedErrors);
+   CHECK(IntEbm{12} == g_cReplayedTermUpdates);
+
+   remove(k_filename);
+
+   CHECK(Error_IllegalParamVal == ReplayRecording(k_filename, &CountReplayedCall));
+}
@@ -566,3 +566,200 @@ TEST_CASE("dataset_shared, two features, 3 samples, weights, classification") {
 
    CHECK(99 == buffer[static_cast<size_t>(sum)]);
 }
+
+TEST_CASE("dataset_shared, score terms, bagged pair") {
+   IntEbm sum = 0;
+   IntEbm part;
+   ErrorEbm error;
+   static constexpr IntEbm k_cSamples = 5;
+   IntEbm binIndexes0[k_cSamples]{0, 2, 1, 2, 0};
+   IntEbm binIndexes1[k_cSamples]{1, 3, 2, 1, 3};
+   double targets[k_cSamples]{0.5, 0.4, 0.3, 0.2, 0.1};
+
+   part = MeasureDataSetHeader(2, 0, 1);
+   CHECK(0 <= part);
+   sum += part;
+
+   part = MeasureFeature(3, EBM_TRUE, EBM_TRUE, EBM_FALSE, k_cSamples, &binIndexes0[0]);
+   CHECK(0 <= part);
+   sum += part;
+
+   // no missing or unseen bins, so the dataset only stores bins 1 to 3
+   part = MeasureFeature(5, EBM_FALSE, EBM_FALSE, EBM_FALSE, k_cSamples, &binIndexes1[0]);
+   CHECK(0 <= part);
+   sum += part;
+
+   part = MeasureRegressionTarget(k_cSamples, &targets[0]);
+   CHECK(0 <= part);
+   sum += part;
+
+   std::vector<char> buffer(static_cast<size_t>(sum) + 1, 77);
+   buffer[static_cast<size_t>(sum)] = 99;
+
+   error = FillDataSetHeader(2, 0, 1, sum, &buffer[0]);
+   CHECK(Error_None == error);
+   error = FillFeature(3, EBM_TRUE, EBM_TRUE, EBM_FALSE, k_cSamples, &binIndexes0[0], sum, &buffer[0]);
+   CHECK(Error_None == error);
+   error = FillFeature(5, EBM_FALSE, EBM_FALSE, EBM_FALSE, k_cSamples, &binIndexes1[0], sum, &buffer[0]);
+   CHECK(Error_None == error);
+   error = FillRegressionTarget(k_cSamples, &targets[0], sum, &buffer[0]);
+   CHECK(Error_None == error);
+
+   CHECK(99 == buffer[static_cast<size_t>(sum)]);
+
+   const IntEbm dimensionCounts[]{1, 2};
+   const IntEbm featureIndexes[]{0, 0, 1};
+   std::vector<double> termScores{10.0, 20.0, 30.0};
+   for(int iBin0 = 0; iBin0 < 3; ++iBin0) {
+      for(int iBin1 = 0; iBin1 < 5; ++iBin1) {
+         termScores.push_back(static_cast<double>(100 + iBin0 * 5 + iBin1));
+      }
+   }
+
+   double scores[k_cSamples];
+   error = ScoreDataSet(&buffer[0], nullptr, 2, dimensionCounts, featureIndexes, 1, &termScores[0], scores);
+   CHECK(Error_None == error);
+   CHECK(111.0 == scores[0]);
+   CHECK(143.0 == scores[1]);
+   CHECK(127.0 == scores[2]);
+   CHECK(141.0 == scores[3]);
+   CHECK(113.0 == scores[4]);
+
+   // negative bags are validation samples and are kept, but zero bags are dropped from the output
+   const BagEbm bag[k_cSamples]{1, 0, 2, -1, 1};
+   error = ScoreDataSet(&buffer[0], bag, 2, dimensionCounts, featureIndexes, 1, &termScores[0], scores);
+   CHECK(Error_None == error);
+   CHECK(111.0 == scores[0]);
+   CHECK(127.0 == scores[1]);
+   CHECK(141.0 == scores[2]);
+   CHECK(113.0 == scores[3]);
+}
+
+TEST_CASE("dataset_shared, term bin weights, shared feature") {
+   IntEbm sum = 0;
+   IntEbm part;
+   ErrorEbm error;
+   static constexpr IntEbm k_cSamples = 5;
+   IntEbm binIndexes0[k_cSamples]{0, 2, 1, 2, 0};
+   IntEbm binIndexes1[k_cSamples]{1, 3, 2, 1, 3};
+   double targets[k_cSamples]{0.5, 0.4, 0.3, 0.2, 0.1};
+
+   part = MeasureDataSetHeader(2, 0, 1);
+   CHECK(0 <= part);
+   sum += part;
+
+   part = MeasureFeature(3, EBM_TRUE, EBM_TRUE, EBM_FALSE, k_cSamples, &binIndexes0[0]);
+   CHECK(0 <= part);
+   sum += part;
+
+   part = MeasureFeature(5, EBM_FALSE, EBM_FALSE, EBM_FALSE, k_cSamples, &binIndexes1[0]);
+   CHECK(0 <= part);
+   sum += part;
+
+   part = MeasureRegressionTarget(k_cSamples, &targets[0]);
+   CHECK(0 <= part);
+   sum += part;
+
+   std::vector<char> buffer(static_cast<size_t>(sum), 77);
+
+   error = FillDataSetHeader(2, 0, 1, sum, &buffer[0]);
+   CHECK(Error_None == error);
+   error = FillFeature(3, EBM_TRUE, EBM_TRUE, EBM_FALSE, k_cSamples, &binIndexes0[0], sum, &buffer[0]);
+   CHECK(Error_None == error);
+   error = FillFeature(5, EBM_FALSE, EBM_FALSE, EBM_FALSE, k_cSamples, &binIndexes1[0], sum, &buffer[0]);
+   CHECK(Error_None == error);
+   error = FillRegressionTarget(k_cSamples, &targets[0], sum, &buffer[0]);
+   CHECK(Error_None == error);
+
+   // the pair lists feature 1 first, so its tensor is 5 x 3
+   const IntEbm dimensionCounts[]{1, 1, 2};
+   const IntEbm featureIndexes[]{0, 1, 1, 0};
+   static constexpr size_t k_cBinWeights = 3 + 5 + 15;
+   double binWeights[k_cBinWeights + 1];
+   binWeights[k_cBinWeights] = 99.0;
+
+   const double weights[k_cSamples]{1.0, 2.0, 4.0, 8.0, 16.0};
+   error = ExtractTermBinWeights(&buffer[0], weights, 3, dimensionCounts, featureIndexes, binWeights);
+   CHECK(Error_None == error);
+
+   const double expected[k_cBinWeights]{17.0, 4.0, 10.0, 0.0, 9.0, 4.0, 18.0, 0.0, 0.0, 0.0, 0.0, 1.0, 0.0, 8.0,
+         0.0, 4.0, 0.0, 16.0, 0.0, 2.0, 0.0, 0.0, 0.0};
+   for(size_t i = 0; i < k_cBinWeights; ++i) {
+      CHECK(expected[i] == binWeights[i]);
+   }
+   CHECK(99.0 == binWeights[k_cBinWeights]);
+
+   // without weights each sample counts once
+   error = ExtractTermBinWeights(&buffer[0], nullptr, 1, dimensionCounts, featureIndexes, binWeights);
+   CHECK(Error_None == error);
+   CHECK(2.0 == binWeights[0]);
+   CHECK(1.0 == binWeights[1]);
+   CHECK(2.0 == binWeights[2]);
+}
+
+static std::vector<char> MakeSubsetTestDataSet(const std::vector<IntEbm>& iBinsSelected) {
+   static constexpr IntEbm k_cSamples = 5;
+   static const IntEbm k_binIndexes[3][k_cSamples]{{0, 2, 1, 2, 0}, {1, 3, 2, 1, 3}, {0, 1, 1, 1, 0}};
+   static const IntEbm k_cBins[3]{4, 5, 3};
+   static const double k_weights[k_cSamples]{1.0, 2.0, 4.0, 8.0, 16.0};
+   static const IntEbm k_targets[k_cSamples]{2, 1, 0, 2, 1};
+
+   const IntEbm cFeatures = static_cast<IntEbm>(iBinsSelected.size());
+   IntEbm sum = MeasureDataSetHeader(cFeatures, 1, 1);
+   for(const IntEbm iBins : iBinsSelected) {
+      sum += MeasureFeature(k_cBins[iBins], EBM_TRUE, EBM_FALSE, EBM_FALSE, k_cSamples, k_binIndexes[iBins]);
+   }
+   sum += MeasureWeight(k_cSamples, k_weights);
+   sum += MeasureClassificationTarget(3, k_cSamples, k_targets);
+
+   std::vector<char> buffer(static_cast<size_t>(sum), 77);
+   // CHECK needs the test case, so a failure here is reported by returning an empty buffer
+   bool bFailed = Error_None != FillDataSetHeader(cFeatures, 1, 1, sum, &buffer[0]);
+   for(const IntEbm iBins : iBinsSelected) {
+      const IntEbm cBins = k_cBins[iBins];
+      bFailed |= Error_None !=
+            FillFeature(cBins, EBM_TRUE, EBM_FALSE, EBM_FALSE, k_cSamples, k_binIndexes[iBins], sum, &buffer[0]);
+   }
+   bFailed |= Error_None != FillWeight(k_cSamples, k_weights, sum, &buffer[0]);
+   bFailed |= Error_None != FillClassificationTarget(3, k_cSamples, k_targets, sum, &buffer[0]);
+   if(bFailed) {
+      buffer.clear();
+   }
+   return buffer;
+}
+
+TEST_CASE("dataset_shared, subset of resolution columns") {
+   // columns 0 and 1 are the main resolution of two features and column 2 is a coarser binning of feature 0
+   const std::vector<char> cache = MakeSubsetTestDataSet({0, 1, 2});
+   CHECK(!cache.empty());
+
+   const IntEbm featureIndexes[]{2, 1};
+   const IntEbm sum = MeasureDataSetSubset(&cache[0], 2, featureIndexes);
+   CHECK(0 <= sum);
+
+   std::vector<char> subset(static_cast<size_t>(sum) + 1, 77);
+   subset[static_cast<size_t>(sum)] = 99;
+   ErrorEbm error = FillDataSetSubset(&cache[0], 2, featureIndexes, sum, &subset[0]);
+   CHECK(Error_None == error);
+   CHECK(99 == subset[static_cast<size_t>(sum)]);
+   subset.pop_back();
+
+   // copying the packed columns must give the same bytes as binning the raw data directly
+   const std::vector<char> direct = MakeSubsetTestDataSet({2, 1});
+   CHECK(!direct.empty());
+   CHECK(direct == subset);
+
+   // a subset without any features still carries the weights and targets
+   const IntEbm sumEmpty = MeasureDataSetSubset(&cache[0], 0, nullptr);
+   CHECK(0 <= sumEmpty);
+   std::vector<char> empty(static_cast<size_t>(sumEmpty), 77);
+   error = FillDataSetSubset(&cache[0], 0, nullptr, sumEmpty, &empty[0]);
+   CHECK(Error_None == error);
+   CHECK(MakeSubsetTestDataSet({}) == empty);
+
+   const IntEbm featureIndexesBad[]{3};
+   CHECK(Error_IllegalParamVal == MeasureDataSetSubset(&cache[0], 1, featureIndexesBad));
+   error = FillDataSetSubset(&cache[0], 2, featureIndexes, sum - 1, &subset[0]);
+   CHECK(Error_IllegalParamVal == error);
+   CHECK(Error_None != CheckDataSet(sum, &subset[0]));
+}
@@ -558,3 +558,78 @@ TEST_CASE("Full tensor interaction strength, interaction, regression") {
 
    CHECK(7.375 == metricReturn);
 }
+
+TEST_CASE("CalcInteractionStrengths matches CalcInteractionStrength, interaction, regression") {
+   TestInteraction test = TestInteraction(Task_Regression,
+         {FeatureTest(2), FeatureTest(3), FeatureTest(2)},
+         {
+               TestSample({0, 0, 1}, 2.0),
+               TestSample({0, 1, 0}, 3.0),
+               TestSample({1, 2, 1}, 5.0),
+               TestSample({1, 0, 0}, 7.0),
+               TestSample({0, 2, 1}, 11.0),
+               TestSample({1, 1, 0}, 13.0),
+         });
+
+   const std::vector<IntEbm> dimensionCounts = {2, 2, 2, 3};
+   const std::vector<IntEbm> featureIndexes = {0, 1, 0, 2, 1, 2, 0, 1, 2};
+   for(IntEbm cThreads = 0; cThreads <= 3; ++cThreads) {
+      double strengths[4];
+      const ErrorEbm error = CalcInteractionStrengths(test.GetInteractionHandle(),
+            static_cast<IntEbm>(dimensionCounts.size()),
+            &dimensionCounts[0],
+            &featureIndexes[0],
+            CalcInteractionFlags_Default,
+            0,
+            k_minSamplesLeafDefault,
+            k_minHessianDefault,
+            k_regAlphaDefault,
+            k_regLambdaDefault,
+            k_maxDeltaStepDefault,
+            cThreads,
+            strengths);
+      CHECK(Error_None == error);
+      CHECK_APPROX(strengths[0], test.TestCalcInteractionStrength({0, 1}));
+      CHECK_APPROX(strengths[1], test.TestCalcInteractionStrength({0, 2}));
+      CHECK_APPROX(strengths[2], test.TestCalcInteractionStrength({1, 2}));
+      CHECK_APPROX(strengths[3], test.TestCalcInteractionStrength({0, 1, 2}));
+   }
+}
+
+TEST_CASE("bagged detector matches the expanded samples without a bag, interaction") {
+   // the bin counts give every feature a different bit packing in both the shared dataset and the subsets
+   const std::vector<FeatureTest> features = {
+         FeatureTest(2), FeatureTest(3), FeatureTest(6), FeatureTest(40), FeatureTest(300)};
+   const std::vector<std::vector<IntEbm>> pairs = {{0, 1}, {1, 2}, {2, 3}, {3, 4}, {0, 4}, {1, 2, 3}};
+
+   for(const TaskEbm cClasses : {TaskEbm{Task_Regression}, TaskEbm{Task_BinaryClassification}, TaskEbm{3}}) {
+      auto rng = MakeRng(0);
+      const std::vector<TestSample> samples = MakeRandomDataset(rng, cClasses, 1000, features);
+
+      const size_t cInitScores = Task_GeneralClassification <= cClasses ? static_cast<size_t>(cClasses) : size_t{1};
+      std::vector<TestSample> bagged;
+      std::vector<TestSample> expanded;
+      for(const TestSample& sample : samples) {
+         // negative entries are validation samples, which the detector skips along with the zero entries
+         const BagEbm bagCount = static_cast<BagEbm>(TestRand(rng, 5) - 1);
+         const double weight = 0.5 + static_cast<double>(TestRand(rng, 4));
+         std::vector<double> initScores;
+         for(size_t iScore = 0; iScore < cInitScores; ++iScore) {
+            initScores.push_back(0.25 * static_cast<double>(TestRand(rng, 9) - 4));
+         }
+         bagged.push_back(TestSample(bagCount, sample.m_sampleBinIndexes, sample.m_target, weight, initScores));
+         for(BagEbm iReplication = 0; iReplication < bagCount; ++iReplication) {
+            expanded.push_back(TestSample(sample.m_sampleBinIndexes, sample.m_target, weight, initScores));
+         }
+      }
+
+      TestInteraction testBagged = TestInteraction(cClasses, features, bagged);
+      TestInteraction testExpanded = TestInteraction(cClasses, features, expanded);
+      for(const std::vector<IntEbm>& pair : pairs) {
+         const double strengthBagged = testBagged.TestCalcInteractionStrength(pair);
+         const double strengthExpanded = testExpanded.TestCalcInteractionStrength(pair);
+         CHECK_APPROX(strengthBagged, strengthExpanded);
+         CHECK(0.0 <= strengthBagged);
+      }
+   }
+}
@@ -551,7 +551,8 @@ BoostRet TestBoost::Boost(const IntEbm indexTerm,
       const IntEbm maxCategoricalThreshold,
       const double categoricalInclusionPercent,
       const std::vector<IntEbm> leavesMax,
-      const std::vector<MonotoneDirection> monotonicity) {
+      const std::vector<MonotoneDirection> monotonicity,
+      const IntEbm randomRetries) {
    ErrorEbm error;
 
    double gainAvg = std::numeric_limits<double>::quiet_NaN();
@@ -571,6 +572,7 @@ BoostRet TestBoost::Boost(const IntEbm indexTerm,
          categoricalSmoothing,
          maxCategoricalThreshold,
          categoricalInclusionPercent,
+         randomRetries,
          0 == leavesMax.size() ? nullptr : &leavesMax[0],
          0 == monotonicity.size() ? nullptr : &monotonicity[0],
          &gainAvg);
@@ -869,6 +871,9 @@ TestInteraction::TestInteraction(const TaskEbm cClasses,
    if(bInitScores) {
       if(Task_GeneralClassification <= cClasses) {
          for(const TestSample& sample : samples) {
+            if(sample.m_bBag && BagEbm{0} == sample.m_bagCount) {
+               continue; // the init scores only include samples with non-zero bag entries
+            }
             if(sample.m_bScores) {
                if(static_cast<size_t>(cClasses) != sample.m_initScores.size()) {
                   throw TestException(error, "cClasses mismatch with sample.m_initScores");
@@ -910,6 +915,9 @@ TestInteraction::TestInteraction(const TaskEbm cClasses,
          }
       } else {
          for(const TestSample& sample : samples) {
+            if(sample.m_bBag && BagEbm{0} == sample.m_bagCount) {
+               continue; // the init scores only include samples with non-zero bag entries
+            }
             const double score = sample.m_initScores[0];
             initScores.push_back(score);
          }
@@ -29,7 +29,9 @@ enum class TestPriority {
    CutUniform,
    CutWinsorized,
    CutQuantile,
-   Discretize
+   Discretize,
+   InverseLink,
+   Threading
 };
 
 class TestException final : public std::exception {
@@ -298,6 +300,7 @@ static constexpr IntEbm k_minCategorySamplesDefault = 0;
 static constexpr double k_categoricalSmoothingDefault = 10.0;
 static constexpr IntEbm k_maxCategoricalThresholdDefault = IntEbm{32};
 static constexpr double k_categoricalInclusionPercentDefault = 1.0;
+static constexpr IntEbm k_randomRetriesDefault = 1;
 
 #ifdef EXPAND_BINARY_LOGITS
 static constexpr CreateBoosterFlags k_testCreateBoosterFlags_Default = CreateBoosterFlags_BinaryAsMulticlass;
@@ -482,6 +485,8 @@ class TestBoost {
 
    inline BoosterHandle GetBoosterHandle() { return m_boosterHandle; }
 
+   inline void* GetRng() { return &m_rng[0]; }
+
    BoostRet Boost(const IntEbm indexTerm,
          const TermBoostFlags flags = TermBoostFlags_Default,
          const double learningRate = k_learningRateDefault,
@@ -495,7 +500,8 @@ class TestBoost {
          const IntEbm maxCategoricalThreshold = k_maxCategoricalThresholdDefault,
          const double categoricalInclusionPercent = k_categoricalInclusionPercentDefault,
          const std::vector<IntEbm> leavesMax = k_leavesMaxDefault,
-         const std::vector<MonotoneDirection> monotonicity = k_monotonicityDefault);
+         const std::vector<MonotoneDirection> monotonicity = k_monotonicityDefault,
+         const IntEbm randomRetries = k_randomRetriesDefault);
 
    double GetBestTermScore(const size_t iTerm, const std::vector<size_t> indexes, const size_t iScore) const;
 
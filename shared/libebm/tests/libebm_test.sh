@@ -237,6 +237,20 @@ link_file() {
 }
 
 
+build_replay() {
+   l6_compiler="$1"
+   l6_compiler_args_sanitized="$2"
+   l6_linker_args_sanitized="$3"
+   l6_obj_path_unsanitized="$4"
+   l6_bin_path_unsanitized="$5"
+
+   # libebm_replay is not run by the tests, but we build it alongside them against the same shared library so that
+   # it keeps compiling as the public API changes
+   g_all_object_files_sanitized=""
+   compile_file "$l6_compiler" "$l6_compiler_args_sanitized" "$src_path_unsanitized/../replay/libebm_replay.cpp" "$l6_obj_path_unsanitized" 0
+   link_file "$l6_compiler" "$l6_linker_args_sanitized" "$l6_bin_path_unsanitized" "libebm_replay"
+}
+
 g_is_updated=0
 
 release_default=1
@@ -352,6 +366,7 @@ all_args="$all_args -Wformat=2"
 all_args="$all_args -Wno-format-nonliteral"
 all_args="$all_args -Wno-parentheses"
 all_args="$all_args -fvisibility=hidden -fvisibility-inlines-hidden"
+all_args="$all_args -pthread"
 all_args="$all_args -fno-math-errno -fno-trapping-math"
 all_args="$all_args -I$src_path_sanitized/../inc"
 all_args="$all_args -I$src_path_sanitized"
@@ -407,6 +422,7 @@ if [ "$os_type" = "Linux" ]; then
       fi
       compile_directory "$cpp_compiler" "$specific_args" "$src_path_unsanitized" "$obj_path_unsanitized" "$is_asm"
       link_file "$cpp_compiler" "-l$lib_file_body $link_args $specific_args" "$bin_path_unsanitized" "$bin_file"
+      build_replay "$cpp_compiler" "$specific_args" "-l$lib_file_body $link_args $specific_args" "$obj_path_unsanitized" "$bin_path_unsanitized"
       printf "%s\n" "$g_compile_out_full"
       printf "%s\n" "$g_compile_out_full" > "$g_log_file_unsanitized"
 
@@ -454,6 +470,7 @@ if [ "$os_type" = "Linux" ]; then
       fi
       compile_directory "$cpp_compiler" "$specific_args" "$src_path_unsanitized" "$obj_path_unsanitized" "$is_asm"
       link_file "$cpp_compiler" "-l$lib_file_body $link_args $specific_args" "$bin_path_unsanitized" "$bin_file"
+      build_replay "$cpp_compiler" "$specific_args" "-l$lib_file_body $link_args $specific_args" "$obj_path_unsanitized" "$bin_path_unsanitized"
       printf "%s\n" "$g_compile_out_full"
       printf "%s\n" "$g_compile_out_full" > "$g_log_file_unsanitized"
 
@@ -501,6 +518,7 @@ if [ "$os_type" = "Linux" ]; then
       fi
       compile_directory "$cpp_compiler" "$specific_args" "$src_path_unsanitized" "$obj_path_unsanitized" "$is_asm"
       link_file "$cpp_compiler" "-l$lib_file_body $link_args $specific_args" "$bin_path_unsanitized" "$bin_file"
+      build_replay "$cpp_compiler" "$specific_args" "-l$lib_file_body $link_args $specific_args" "$obj_path_unsanitized" "$bin_path_unsanitized"
       printf "%s\n" "$g_compile_out_full"
       printf "%s\n" "$g_compile_out_full" > "$g_log_file_unsanitized"
 
@@ -546,6 +564,7 @@ if [ "$os_type" = "Linux" ]; then
       check_install "$tmp_path_unsanitized" "g++-multilib"
       compile_directory "$cpp_compiler" "$specific_args" "$src_path_unsanitized" "$obj_path_unsanitized" "$is_asm"
       link_file "$cpp_compiler" "-l$lib_file_body $link_args $specific_args" "$bin_path_unsanitized" "$bin_file"
+      build_replay "$cpp_compiler" "$specific_args" "-l$lib_file_body $link_args $specific_args" "$obj_path_unsanitized" "$bin_path_unsanitized"
       printf "%s\n" "$g_compile_out_full"
       printf "%s\n" "$g_compile_out_full" > "$g_log_file_unsanitized"
 
@@ -587,6 +606,7 @@ if [ "$os_type" = "Linux" ]; then
       check_install "$tmp_path_unsanitized" "g++-multilib"
       compile_directory "$cpp_compiler" "$specific_args" "$src_path_unsanitized" "$obj_path_unsanitized" "$is_asm"
       link_file "$cpp_compiler" "-l$lib_file_body $link_args $specific_args" "$bin_path_unsanitized" "$bin_file"
+      build_replay "$cpp_compiler" "$specific_args" "-l$lib_file_body $link_args $specific_args" "$obj_path_unsanitized" "$bin_path_unsanitized"
       printf "%s\n" "$g_compile_out_full"
       printf "%s\n" "$g_compile_out_full" > "$g_log_file_unsanitized"
 
@@ -638,6 +658,7 @@ elif [ "$os_type" = "Darwin" ]; then
       make_paths "$obj_path_unsanitized" "$bin_path_unsanitized"
       compile_directory "$cpp_compiler" "$specific_args" "$src_path_unsanitized" "$obj_path_unsanitized" "$is_asm"
       link_file "$cpp_compiler" "-l$lib_file_body $link_args $specific_args" "$bin_path_unsanitized" "$bin_file"
+      build_replay "$cpp_compiler" "$specific_args" "-l$lib_file_body $link_args $specific_args" "$obj_path_unsanitized" "$bin_path_unsanitized"
       printf "%s\n" "$g_compile_out_full"
       printf "%s\n" "$g_compile_out_full" > "$g_log_file_unsanitized"
 
@@ -678,6 +699,7 @@ elif [ "$os_type" = "Darwin" ]; then
       make_paths "$obj_path_unsanitized" "$bin_path_unsanitized"
       compile_directory "$cpp_compiler" "$specific_args" "$src_path_unsanitized" "$obj_path_unsanitized" "$is_asm"
       link_file "$cpp_compiler" "-l$lib_file_body $link_args $specific_args" "$bin_path_unsanitized" "$bin_file"
+      build_replay "$cpp_compiler" "$specific_args" "-l$lib_file_body $link_args $specific_args" "$obj_path_unsanitized" "$bin_path_unsanitized"
       printf "%s\n" "$g_compile_out_full"
       printf "%s\n" "$g_compile_out_full" > "$g_log_file_unsanitized"
 
@@ -718,6 +740,7 @@ elif [ "$os_type" = "Darwin" ]; then
       make_paths "$obj_path_unsanitized" "$bin_path_unsanitized"
       compile_directory "$cpp_compiler" "$specific_args" "$src_path_unsanitized" "$obj_path_unsanitized" "$is_asm"
       link_file "$cpp_compiler" "-l$lib_file_body $link_args $specific_args" "$bin_path_unsanitized" "$bin_file"
+      build_replay "$cpp_compiler" "$specific_args" "-l$lib_file_body $link_args $specific_args" "$obj_path_unsanitized" "$bin_path_unsanitized"
       printf "%s\n" "$g_compile_out_full"
       printf "%s\n" "$g_compile_out_full" > "$g_log_file_unsanitized"
 
@@ -758,6 +781,7 @@ elif [ "$os_type" = "Darwin" ]; then
       make_paths "$obj_path_unsanitized" "$bin_path_unsanitized"
       compile_directory "$cpp_compiler" "$specific_args" "$src_path_unsanitized" "$obj_path_unsanitized" "$is_asm"
       link_file "$cpp_compiler" "-l$lib_file_body $link_args $specific_args" "$bin_path_unsanitized" "$bin_file"
+      build_replay "$cpp_compiler" "$specific_args" "-l$lib_file_body $link_args $specific_args" "$obj_path_unsanitized" "$bin_path_unsanitized"
       printf "%s\n" "$g_compile_out_full"
       printf "%s\n" "$g_compile_out_full" > "$g_log_file_unsanitized"
 
@@ -798,6 +822,7 @@ elif [ "$os_type" = "Darwin" ]; then
       make_paths "$obj_path_unsanitized" "$bin_path_unsanitized"
       compile_directory "$cpp_compiler" "$specific_args" "$src_path_unsanitized" "$obj_path_unsanitized" "$is_asm"
       link_file "$cpp_compiler" "-l$lib_file_body $link_args $specific_args" "$bin_path_unsanitized" "$bin_file"
+      build_replay "$cpp_compiler" "$specific_args" "-l$lib_file_body $link_args $specific_args" "$obj_path_unsanitized" "$bin_path_unsanitized"
       printf "%s\n" "$g_compile_out_full"
       printf "%s\n" "$g_compile_out_full" > "$g_log_file_unsanitized"
 
@@ -298,6 +298,196 @@ TEST_CASE("SampleWithoutReplacement, stress test") {
    }
 }
 
+TEST_CASE("GenerateBagPlan, matches the single bag samplers") {
+   ErrorEbm error;
+
+   static constexpr IntEbm k_cBags = 3;
+   static constexpr IntEbm k_cTraining = 7;
+   static constexpr IntEbm k_cValidation = 6;
+   static constexpr size_t k_cSamples = static_cast<size_t>(k_cTraining + k_cValidation);
+   const IntEbm targets[k_cSamples]{0, 1, 2, 0, 1, 2, 0, 1, 2, 0, 1, 2, 0};
+
+   const size_t cBytesRng = static_cast<size_t>(MeasureRNG());
+   for(int iStratified = 0; iStratified < 2; ++iStratified) {
+      std::vector<unsigned char> rngsPlan(cBytesRng * static_cast<size_t>(k_cBags));
+      std::vector<unsigned char> rngsSingle(cBytesRng * static_cast<size_t>(k_cBags));
+      for(IntEbm iBag = 0; iBag < k_cBags; ++iBag) {
+         InitRNG(static_cast<SeedEbm>(k_seed + iBag), &rngsPlan[cBytesRng * static_cast<size_t>(iBag)]);
+         InitRNG(static_cast<SeedEbm>(k_seed + iBag), &rngsSingle[cBytesRng * static_cast<size_t>(iBag)]);
+      }
+
+      const IntEbm cBytesPlan = MeasureBagPlan(k_cBags, static_cast<IntEbm>(k_cSamples));
+      CHECK(0 < cBytesPlan);
+      std::vector<unsigned char> plan(static_cast<size_t>(cBytesPlan));
+      error = GenerateBagPlan(&rngsPlan[0],
+            k_cBags,
+            k_cTraining,
+            k_cValidation,
+            3,
+            0 == iStratified ? nullptr : targets,
+            0,
+            nullptr,
+            cBytesPlan,
+            &plan[0]);
+      CHECK(Error_None == error);
+
+      for(IntEbm iBag = 0; iBag < k_cBags; ++iBag) {
+         BagEbm expected[k_cSamples];
+         unsigned char* const pRng = &rngsSingle[cBytesRng * static_cast<size_t>(iBag)];
+         if(0 == iStratified) {
+            error = SampleWithoutReplacement(pRng, k_cTraining, k_cValidation, expected);
+         } else {
+            error = SampleWithoutReplacementStratified(pRng, 3, k_cTraining, k_cValidation, targets, expected);
+         }
+         CHECK(Error_None == error);
+
+         BagEbm bag[k_cSamples];
+         error = ExtractBag(&plan[0], iBag, bag);
+         CHECK(Error_None == error);
+         for(size_t iSample = 0; iSample < k_cSamples; ++iSample) {
+            CHECK(expected[iSample] == bag[iSample]);
+         }
+      }
+      // the plan advances each bag's rng the same way, so boosting continues from the same state
+      CHECK(rngsSingle == rngsPlan);
+   }
+}
+
+TEST_CASE("GenerateBagPlan, groups stay together") {
+   ErrorEbm error;
+
+   static constexpr IntEbm k_cBags = 4;
+   static constexpr size_t k_cSamples = 10;
+   const IntEbm groups[k_cSamples]{0, 0, 1, 1, 1, 2, 3, 3, 4, 4};
+
+   const size_t cBytesRng = static_cast<size_t>(MeasureRNG());
+   std::vector<unsigned char> rngs(cBytesRng * static_cast<size_t>(k_cBags));
+   for(IntEbm iBag = 0; iBag < k_cBags; ++iBag) {
+      InitRNG(static_cast<SeedEbm>(k_seed + iBag), &rngs[cBytesRng * static_cast<size_t>(iBag)]);
+   }
+
+   const IntEbm cBytesPlan = MeasureBagPlan(k_cBags, static_cast<IntEbm>(k_cSamples));
+   std::vector<unsigned char> plan(static_cast<size_t>(cBytesPlan));
+   error = GenerateBagPlan(&rngs[0], k_cBags, 7, 3, 0, nullptr, 5, groups, cBytesPlan, &plan[0]);
+   CHECK(Error_None == error);
+
+   for(IntEbm iBag = 0; iBag < k_cBags; ++iBag) {
+      BagEbm bag[k_cSamples];
+      error = ExtractBag(&plan[0], iBag, bag);
+      CHECK(Error_None == error);
+      size_t cValidation = 0;
+      for(size_t iSample = 0; iSample < k_cSamples; ++iSample) {
+         CHECK(BagEbm{1} == bag[iSample] || BagEbm{-1} == bag[iSample]);
+         if(0 != iSample && groups[iSample - 1] == groups[iSample]) {
+            CHECK(bag[iSample - 1] == bag[iSample]);
+         }
+         cValidation += BagEbm{-1} == bag[iSample] ? size_t{1} : size_t{0};
+      }
+      // whole groups are added until at least 3 are in validation, and no group is larger than 3
+      CHECK(3 <= cValidation);
+      CHECK(cValidation <= 5);
+   }
+
+   BagEbm bag[k_cSamples];
+   error = ExtractBag(&plan[0], k_cBags, bag);
+   CHECK(Error_IllegalParamVal == error);
+
+   const IntEbm targets[k_cSamples]{};
+   error = GenerateBagPlan(&rngs[0], k_cBags, 7, 3, 1, targets, 5, groups, cBytesPlan, &plan[0]);
+   CHECK(Error_IllegalParamVal == error);
+
+   error = GenerateBagPlan(&rngs[0], k_cBags, 7, 3, 0, nullptr, 0, nullptr, cBytesPlan - 1, &plan[0]);
+   CHECK(Error_IllegalParamVal == error);
+}
+
+TEST_CASE("CreateBoosterFromBagPlan and CreateInteractionDetectorFromBagPlan") {
+   ErrorEbm error;
+
+   static constexpr IntEbm k_cSamples = 4;
+   const double targets[k_cSamples]{1.0, 2.0, 3.0, 4.0};
+   const IntEbm cBytesDataSet = MeasureDataSetHeader(0, 0, 1) + MeasureRegressionTarget(k_cSamples, targets);
+   std::vector<unsigned char> dataset(static_cast<size_t>(cBytesDataSet));
+   error = FillDataSetHeader(0, 0, 1, cBytesDataSet, &dataset[0]);
+   CHECK(Error_None == error);
+   error = FillRegressionTarget(k_cSamples, targets, cBytesDataSet, &dataset[0]);
+   CHECK(Error_None == error);
+
+   const IntEbm cBytesPlan = MeasureBagPlan(2, k_cSamples);
+   std::vector<unsigned char> plan(static_cast<size_t>(cBytesPlan));
+   error = GenerateBagPlan(nullptr, 2, 3, 1, 0, nullptr, 0, nullptr, cBytesPlan, &plan[0]);
+   CHECK(Error_None == error);
+
+   BoosterHandle boosterHandle;
+   error = CreateBoosterFromBagPlan(nullptr,
+         &dataset[0],
+         nullptr,
+         &plan[0],
+         1,
+         nullptr,
+         0,
+         nullptr,
+         nullptr,
+         0,
+         CreateBoosterFlags_Default,
+         AccelerationFlags_NONE,
+         "rmse",
+         nullptr,
+         &boosterHandle);
+   CHECK(Error_None == error);
+   CHECK(nullptr != boosterHandle);
+   FreeBooster(boosterHandle);
+
+   error = CreateBoosterFromBagPlan(nullptr,
+         &dataset[0],
+         nullptr,
+         &plan[0],
+         2,
+         nullptr,
+         0,
+         nullptr,
+         nullptr,
+         0,
+         CreateBoosterFlags_Default,
+         AccelerationFlags_NONE,
+         "rmse",
+         nullptr,
+         &boosterHandle);
+   CHECK(Error_IllegalParamVal == error);
+   CHECK(nullptr == boosterHandle);
+
+   InteractionHandle interactionHandle;
+   error = CreateInteractionDetectorFromBagPlan(&dataset[0],
+         nullptr,
+         &plan[0],
+         0,
+         nullptr,
+         CreateInteractionFlags_Default,
+         AccelerationFlags_NONE,
+         "rmse",
+         nullptr,
+         &interactionHandle);
+   CHECK(Error_None == error);
+   CHECK(nullptr != interactionHandle);
+   FreeInteractionDetector(interactionHandle);
+
+   // a plan for a different number of samples does not match the dataset
+   const IntEbm cBytesOther = MeasureBagPlan(1, k_cSamples + 1);
+   std::vector<unsigned char> other(static_cast<size_t>(cBytesOther));
+   error = GenerateBagPlan(nullptr, 1, 4, 1, 0, nullptr, 0, nullptr, cBytesOther, &other[0]);
+   CHECK(Error_None == error);
+   error = CreateInteractionDetectorFromBagPlan(&dataset[0],
+         nullptr,
+         &other[0],
+         0,
+         nullptr,
+         CreateInteractionFlags_Default,
+         AccelerationFlags_NONE,
+         "rmse",
+         nullptr,
+         &interactionHandle);
+   CHECK(Error_IllegalParamVal == error);
+}
+
 TEST_CASE("test random number generator equivalency") {
    std::vector<TestSample> samples;
    for(int i = 0; i < 1000; ++i) {
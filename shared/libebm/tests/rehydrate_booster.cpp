@@ -109,3 +109,78 @@ TEST_CASE("Test Rehydration, boosting, multiclass") {
       CHECK_APPROX(termScoreContinuous, termScore2);
    }
 }
+
+TEST_CASE("Test Rehydration, serialized booster resumes identically, binary") {
+   std::vector<TestSample> train;
+   std::vector<TestSample> validation;
+   for(IntEbm i0 = 0; i0 < 5; ++i0) {
+      for(IntEbm i1 = 0; i1 < 4; ++i1) {
+         train.push_back(TestSample({i0, i1}, static_cast<double>((i0 * 7 + i1 * 3) % 2)));
+         validation.push_back(TestSample({i0, i1}, static_cast<double>((i0 + i1) % 2)));
+      }
+   }
+   const std::vector<FeatureTest> features = {FeatureTest(5), FeatureTest(4)};
+   const std::vector<std::vector<IntEbm>> terms = {{0}, {1}, {0, 1}};
+   static constexpr IntEbm k_innerBags = 2;
+   static constexpr size_t k_roundsBefore = 7;
+   static constexpr size_t k_roundsAfter = 9;
+
+   // random splits consume the rng, so the rng has to be restored along with the booster
+   const auto BoostRound = [](TestBoost& test, const size_t iRound) {
+      const IntEbm iTerm = static_cast<IntEbm>(iRound % 3);
+      return test.Boost(iTerm, 0 == iRound % 2 ? TermBoostFlags_RandomSplits : TermBoostFlags_Default)
+            .validationMetric;
+   };
+
+   TestBoost testContinuous = TestBoost(Task_BinaryClassification, features, terms, train, validation, k_innerBags);
+   for(size_t iRound = 0; iRound < k_roundsBefore; ++iRound) {
+      BoostRound(testContinuous, iRound);
+   }
+
+   const IntEbm cBytes = MeasureSerializedBooster(testContinuous.GetBoosterHandle());
+   CHECK(0 < cBytes);
+   std::vector<unsigned char> state(static_cast<size_t>(cBytes));
+   ErrorEbm error = SerializeBooster(testContinuous.GetBoosterHandle(), testContinuous.GetRng(), cBytes, &state[0]);
+   CHECK(Error_None == error);
+
+   error = SerializeBooster(testContinuous.GetBoosterHandle(), testContinuous.GetRng(), cBytes - 1, &state[0]);
+   CHECK(Error_IllegalParamVal == error);
+
+   std::vector<double> metricsContinuous;
+   for(size_t iRound = k_roundsBefore; iRound < k_roundsBefore + k_roundsAfter; ++iRound) {
+      metricsContinuous.push_back(BoostRound(testContinuous, iRound));
+   }
+
+   TestBoost testResumed = TestBoost(Task_BinaryClassification, features, terms, train, validation, k_innerBags);
+
+   // a state that is cut short or that comes from a differently shaped booster is rejected
+   error = DeserializeBooster(testResumed.GetBoosterHandle(), cBytes - 1, &state[0], testResumed.GetRng());
+   CHECK(Error_IllegalParamVal == error);
+   TestBoost testOther = TestBoost(Task_BinaryClassification, features, {{0}, {1}}, train, validation, k_innerBags);
+   error = DeserializeBooster(testOther.GetBoosterHandle(), cBytes, &state[0], testOther.GetRng());
+   CHECK(Error_IllegalParamVal == error);
+
+   error = DeserializeBooster(testResumed.GetBoosterHandle(), cBytes, &state[0], testResumed.GetRng());
+   CHECK(Error_None == error);
+
+   for(size_t iRound = k_roundsBefore; iRound < k_roundsBefore + k_roundsAfter; ++iRound) {
+      CHECK(metricsContinuous[iRound - k_roundsBefore] == BoostRound(testResumed, iRound));
+   }
+
+   for(size_t iTerm = 0; iTerm < terms.size(); ++iTerm) {
+      double scoresContinuous[5 * 4];
+      double scoresResumed[5 * 4];
+      testContinuous.GetCurrentTermScoresRaw(iTerm, scoresContinuous);
+      testResumed.GetCurrentTermScoresRaw(iTerm, scoresResumed);
+      const size_t cScores = 1 == terms[iTerm].size() ? static_cast<size_t>(features[terms[iTerm][0]].m_countBins) :
+                                                        size_t{5 * 4};
+      for(size_t iScore = 0; iScore < cScores; ++iScore) {
+         CHECK(scoresContinuous[iScore] == scoresResumed[iScore]);
+      }
+      testContinuous.GetBestTermScoresRaw(iTerm, scoresContinuous);
+      testResumed.GetBestTermScoresRaw(iTerm, scoresResumed);
+      for(size_t iScore = 0; iScore < cScores; ++iScore) {
+         CHECK(scoresContinuous[iScore] == scoresResumed[iScore]);
+      }
+   }
+}
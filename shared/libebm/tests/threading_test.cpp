@@ -0,0 +1,236 @@
+// Copyright (c) 2023 The InterpretML Contributors
+// Licensed under the MIT license.
+// Author: Paul Koch <code@koch.ninja>
+
+#include "pch_test.hpp"
+
+#include <thread>
+
+#include "libebm.h"
+#include "libebm_test.hpp"
+
+static constexpr TestPriority k_filePriority = TestPriority::Threading;
+
+struct ThreadingCase {
+   TaskEbm m_cClasses;
+   std::vector<TestSample> m_train;
+   std::vector<TestSample> m_validation;
+};
+
+static const std::vector<FeatureTest> k_threadingFeatures = {
+      FeatureTest(7, false, false, false),
+      FeatureTest(4, true, false, false),
+      FeatureTest(3, false, true, true),
+};
+
+// CHECK can only be used from the test's own thread, so the workers record their results (or a NaN if libebm threw)
+// and the test compares them afterwards
+
+static std::vector<double> BoostThreadingCase(const ThreadingCase& threadingCase) {
+   std::vector<double> metrics;
+   try {
+      auto terms = MakeMains(k_threadingFeatures);
+      terms.push_back({0, 1});
+      terms.push_back({1, 2});
+      TestBoost test = TestBoost(
+            threadingCase.m_cClasses, k_threadingFeatures, terms, threadingCase.m_train, threadingCase.m_validation);
+      for(size_t iRound = 0; iRound < 8; ++iRound) {
+         for(IntEbm iTerm = 0; iTerm < static_cast<IntEbm>(terms.size()); ++iTerm) {
+            metrics.push_back(test.Boost(iTerm).validationMetric);
+         }
+      }
+   } catch(const TestException&) {
+      metrics.push_back(std::numeric_limits<double>::quiet_NaN());
+   }
+   return metrics;
+}
+
+static std::vector<double> InteractThreadingCase(const ThreadingCase& threadingCase) {
+   std::vector<double> strengths;
+   try {
+      TestInteraction test = TestInteraction(threadingCase.m_cClasses, k_threadingFeatures, threadingCase.m_train);
+      strengths.push_back(test.TestCalcInteractionStrength({0, 1}));
+      strengths.push_back(test.TestCalcInteractionStrength({0, 2}));
+      strengths.push_back(test.TestCalcInteractionStrength({1, 2}));
+      strengths.push_back(test.TestCalcInteractionStrength({0, 1, 2}));
+   } catch(const TestException&) {
+      strengths.push_back(std::numeric_limits<double>::quiet_NaN());
+   }
+   return strengths;
+}
+
+TEST_CASE("concurrent boosters and interaction detectors, threading") {
+   static constexpr size_t k_cCases = 12;
+   static constexpr size_t k_cRepeats = 3;
+
+   auto rng = MakeRng(0);
+   std::vector<ThreadingCase> cases;
+   for(size_t iCase = 0; iCase < k_cCases; ++iCase) {
+      static constexpr TaskEbm k_tasks[] = {Task_Regression, 2, 3};
+      ThreadingCase threadingCase;
+      threadingCase.m_cClasses = k_tasks[iCase % (sizeof(k_tasks) / sizeof(k_tasks[0]))];
+      threadingCase.m_train = MakeRandomDataset(rng, threadingCase.m_cClasses, 97 + iCase, k_threadingFeatures);
+      threadingCase.m_validation = MakeRandomDataset(rng, threadingCase.m_cClasses, 31, k_threadingFeatures);
+      cases.push_back(threadingCase);
+   }
+
+   std::vector<std::vector<double>> expectedMetrics;
+   std::vector<std::vector<double>> expectedStrengths;
+   for(const ThreadingCase& threadingCase : cases) {
+      expectedMetrics.push_back(BoostThreadingCase(threadingCase));
+      expectedStrengths.push_back(InteractThreadingCase(threadingCase));
+   }
+
+   // each case runs several times at once so that threads also share the static log counters of each API
+   std::vector<std::vector<double>> metrics(k_cCases * k_cRepeats);
+   std::vector<std::vector<double>> strengths(k_cCases * k_cRepeats);
+   std::vector<std::thread> threads;
+   for(size_t iRun = 0; iRun < k_cCases * k_cRepeats; ++iRun) {
+      const ThreadingCase* const pCase = &cases[iRun % k_cCases];
+      threads.emplace_back([pCase, iRun, &metrics]() { metrics[iRun] = BoostThreadingCase(*pCase); });
+      threads.emplace_back([pCase, iRun, &strengths]() { strengths[iRun] = InteractThreadingCase(*pCase); });
+   }
+   for(std::thread& thread : threads) {
+      thread.join();
+   }
+
+   for(size_t iRun = 0; iRun < k_cCases * k_cRepeats; ++iRun) {
+      // every run is deterministic, so running concurrently must not change any result
+      CHECK(expectedMetrics[iRun % k_cCases] == metrics[iRun]);
+      CHECK(expectedStrengths[iRun % k_cCases] == strengths[iRun]);
+   }
+   for(size_t iCase = 0; iCase < k_cCases; ++iCase) {
+      for(const double metric : expectedMetrics[iCase]) {
+         CHECK(!std::isnan(metric));
+      }
+      for(const double strength : expectedStrengths[iCase]) {
+         CHECK(!std::isnan(strength));
+      }
+   }
+}
+
+static const std::vector<FeatureTest> k_viewFeatures = {
+      FeatureTest(9, false, false, false),
+      FeatureTest(5, true, false, false),
+      FeatureTest(4, false, true, false),
+      FeatureTest(6, true, true, false),
+};
+
+static std::vector<std::vector<IntEbm>> MakeViewTerms() {
+   // with CreateBoosterFlags_PackByFeature, every multi-dimensional term composes its tensor indexes on demand, so
+   // views working on different terms at once would overwrite each other if that scratch were shared
+   auto terms = MakeMains(k_viewFeatures);
+   terms.push_back({0, 1});
+   terms.push_back({2, 3});
+   terms.push_back({1, 3});
+   terms.push_back({0, 2, 3});
+   terms.push_back({0, 1, 2, 3});
+   return terms;
+}
+
+static std::vector<double> GenerateOnView(
+      const BoosterHandle boosterHandle, const TaskEbm cClasses, const std::vector<IntEbm>& termOrder) {
+   const std::vector<std::vector<IntEbm>> terms = MakeViewTerms();
+   const size_t cScores = Task_Regression == cClasses || 2 == cClasses ? size_t{1} : static_cast<size_t>(cClasses);
+
+   std::vector<double> results;
+   for(const IntEbm iTerm : termOrder) {
+      size_t cTensorScores = cScores;
+      for(const IntEbm iFeature : terms[static_cast<size_t>(iTerm)]) {
+         cTensorScores *= static_cast<size_t>(k_viewFeatures[static_cast<size_t>(iFeature)].m_countBins);
+      }
+
+      // each call gets its own identically seeded rng so that the order of the calls cannot change the results
+      std::vector<unsigned char> rng = MakeRng(static_cast<SeedEbm>(iTerm));
+      double gain = std::numeric_limits<double>::quiet_NaN();
+      ErrorEbm error = GenerateTermUpdate(&rng[0],
+            boosterHandle,
+            iTerm,
+            TermBoostFlags_Default,
+            k_learningRateDefault,
+            k_minSamplesLeafDefault,
+            k_minHessianDefault,
+            k_regAlphaDefault,
+            k_regLambdaDefault,
+            k_maxDeltaStepDefault,
+            k_minCategorySamplesDefault,
+            k_categoricalSmoothingDefault,
+            k_maxCategoricalThresholdDefault,
+            k_categoricalInclusionPercentDefault,
+            k_randomRetriesDefault,
+            &k_leavesMaxDefault[0],
+            nullptr,
+            &gain);
+      results.push_back(Error_None == error ? gain : std::numeric_limits<double>::quiet_NaN());
+
+      std::vector<double> update(cTensorScores, std::numeric_limits<double>::quiet_NaN());
+      if(Error_None == error) {
+         error = GetTermUpdate(boosterHandle, &update[0]);
+      }
+      if(Error_None != error) {
+         update.assign(cTensorScores, std::numeric_limits<double>::quiet_NaN());
+      }
+      results.insert(results.end(), update.begin(), update.end());
+   }
+   return results;
+}
+
+TEST_CASE("concurrent GenerateTermUpdate on views of a pack by feature booster, threading") {
+   static constexpr size_t k_cViews = 8;
+   static constexpr size_t k_cRounds = 6;
+
+   const size_t cTerms = MakeViewTerms().size();
+   auto rng = MakeRng(0);
+   for(const TaskEbm cClasses : {Task_Regression, TaskEbm{3}}) {
+      const auto train = MakeRandomDataset(rng, cClasses, 307, k_viewFeatures);
+      const auto validation = MakeRandomDataset(rng, cClasses, 41, k_viewFeatures);
+      TestBoost test = TestBoost(cClasses,
+            k_viewFeatures,
+            MakeViewTerms(),
+            train,
+            validation,
+            2,
+            k_testCreateBoosterFlags_Default | CreateBoosterFlags_PackByFeature,
+            AccelerationFlags_ALL);
+
+      std::vector<BoosterHandle> views(k_cViews, nullptr);
+      for(BoosterHandle& view : views) {
+         CHECK(Error_None == CreateBoosterView(test.GetBoosterHandle(), &view));
+      }
+
+      // every view starts on a different term and then walks through all of them several times
+      std::vector<std::vector<IntEbm>> termOrders(k_cViews);
+      for(size_t iView = 0; iView < k_cViews; ++iView) {
+         for(size_t iStep = 0; iStep < cTerms * k_cRounds; ++iStep) {
+            termOrders[iView].push_back(static_cast<IntEbm>((iView + iStep) % cTerms));
+         }
+      }
+
+      std::vector<std::vector<double>> expected;
+      for(size_t iView = 0; iView < k_cViews; ++iView) {
+         expected.push_back(GenerateOnView(views[iView], cClasses, termOrders[iView]));
+      }
+
+      std::vector<std::vector<double>> results(k_cViews);
+      std::vector<std::thread> threads;
+      for(size_t iView = 0; iView < k_cViews; ++iView) {
+         threads.emplace_back([&views, &termOrders, &results, cClasses, iView]() {
+            results[iView] = GenerateOnView(views[iView], cClasses, termOrders[iView]);
+         });
+      }
+      for(std::thread& thread : threads) {
+         thread.join();
+      }
+
+      for(size_t iView = 0; iView < k_cViews; ++iView) {
+         for(const double val : expected[iView]) {
+            CHECK(!std::isnan(val));
+         }
+         CHECK(expected[iView] == results[iView]);
+      }
+
+      for(const BoosterHandle view : views) {
+         FreeBooster(view);
+      }
+   }
+}
@@ -4,6 +4,11 @@
 
 #include <stdio.h> // vsnprintf
 #include <stdarg.h> // va_start
+#include <mutex> // recursive_mutex
+
+#ifdef _MSC_VER
+#include <intrin.h> // _InterlockedCompareExchange
+#endif // _MSC_VER
 
 #include "logging.h"
 
@@ -18,6 +23,10 @@ TraceEbm g_traceLevel = Trace_Off;
 
 static LogCallbackFunction g_pLogCallbackFunction = NULL;
 
+// Boosters on different threads log concurrently, so we hand the callback one message at a time.  The mutex is
+// recursive in case the callback calls back into us and something logs.
+static std::recursive_mutex g_logCallbackMutex;
+
 #ifndef NDEBUG
 unsigned int g_coverage[TEST_COVERAGE_COUNT] = {0};
 #endif // NDEBUG
@@ -136,9 +145,11 @@ INTERNAL_IMPORT_EXPORT_BODY void InteralLogWithArguments(const TraceEbm traceLev
       // NOLINTNEXTLINE
       if(vsnprintf(messageSpace, sizeof(messageSpace) / sizeof(messageSpace[0]), sMessage, args) < 0) {
          static const char g_sLoggingParamError[] = "Error in vsnprintf parameters for logging.";
+         const std::lock_guard<std::recursive_mutex> lock(g_logCallbackMutex);
          (*g_pLogCallbackFunction)(traceLevel, g_sLoggingParamError);
       } else {
          // if messageSpace overflows, we clip the message, but it's still legal
+         const std::lock_guard<std::recursive_mutex> lock(g_logCallbackMutex);
          (*g_pLogCallbackFunction)(traceLevel, messageSpace);
       }
       va_end(args);
@@ -149,10 +160,38 @@ INTERNAL_IMPORT_EXPORT_BODY void InteralLogWithoutArguments(const TraceEbm trace
    assert(NULL != g_pLogCallbackFunction);
    // it is illegal for g_pLogCallbackFunction to be NULL at this point, but in the interest of not crashing check it
    if(NULL != g_pLogCallbackFunction) {
+      const std::lock_guard<std::recursive_mutex> lock(g_logCallbackMutex);
       (*g_pLogCallbackFunction)(traceLevel, sMessage);
    }
 }
 
+INTERNAL_IMPORT_EXPORT_BODY int InteralLogCountDecrement(int* const pLogCount) {
+   assert(NULL != pLogCount);
+   // a compare-exchange loop instead of an unconditional decrement keeps the count from going negative and eventually
+   // wrapping around.  Relaxed ordering is enough since the count does not guard any other memory.
+#ifdef _MSC_VER
+   static_assert(sizeof(long) == sizeof(int), "_InterlockedCompareExchange operates on long");
+   volatile long* const pCount = reinterpret_cast<volatile long*>(pLogCount);
+   long count = *pCount;
+   while(0 < count) {
+      const long countPrev = _InterlockedCompareExchange(pCount, count - 1, count);
+      if(countPrev == count) {
+         return 1;
+      }
+      count = countPrev;
+   }
+#else // _MSC_VER
+   int count = __atomic_load_n(pLogCount, __ATOMIC_RELAXED);
+   while(0 < count) {
+      // on failure count is updated to the current value
+      if(__atomic_compare_exchange_n(pLogCount, &count, count - 1, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+         return 1;
+      }
+   }
+#endif // _MSC_VER
+   return 0;
+}
+
 INTERNAL_IMPORT_EXPORT_BODY void LogAssertFailure(const unsigned long long lineNumber,
       const char* const sFileName,
       const char* const sFunctionName,
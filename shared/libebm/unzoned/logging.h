@@ -52,6 +52,9 @@ inline static const char* ObtainTruth(const BoolEbm b) { return EBM_FALSE != b ?
 
 INTERNAL_EXPORT_VAR_INCLUDE TraceEbm g_traceLevel;
 
+// InteralLogCountDecrement atomically decrements *pLogCount if it is positive and returns non-zero if it did.  The
+// counters are shared by every thread that calls into the same handle, so a plain decrement would be a data race.
+INTERNAL_IMPORT_EXPORT_INCLUDE int InteralLogCountDecrement(int* const pLogCount);
 INTERNAL_IMPORT_EXPORT_INCLUDE void InteralLogWithArguments(const TraceEbm traceLevel, const char* const sMessage, ...);
 INTERNAL_IMPORT_EXPORT_INCLUDE void InteralLogWithoutArguments(const TraceEbm traceLevel, const char* const sMessage);
 INTERNAL_IMPORT_EXPORT_INCLUDE void LogAssertFailure(const unsigned long long lineNumber,
@@ -140,12 +143,9 @@ INTERNAL_IMPORT_EXPORT_INCLUDE void LogAssertFailure(const unsigned long long li
          do {                                                                                                          \
             TraceEbm LOG__traceLevelLogging;                                                                           \
             if(LOG__traceLevel < LOG__traceLevelAfter) {                                                               \
-               int* const LOG__pLogCountDecrement = (pLogCountDecrement);                                              \
-               const int LOG__logCount = *LOG__pLogCountDecrement - 1;                                                 \
-               if(LOG__logCount < 0) {                                                                                 \
+               if(!InteralLogCountDecrement(pLogCountDecrement)) {                                                     \
                   break;                                                                                               \
                }                                                                                                       \
-               *LOG__pLogCountDecrement = LOG__logCount;                                                               \
                LOG__traceLevelLogging = LOG__traceLevelBefore;                                                         \
             } else {                                                                                                   \
                LOG__traceLevelLogging = LOG__traceLevelAfter;                                                          \
@@ -180,12 +180,9 @@ INTERNAL_IMPORT_EXPORT_INCLUDE void LogAssertFailure(const unsigned long long li
          do {                                                                                                          \
             TraceEbm LOG__traceLevelLogging;                                                                           \
             if(LOG__traceLevel < LOG__traceLevelAfter) {                                                               \
-               int* const LOG__pLogCountDecrement = (pLogCountDecrement);                                              \
-               const int LOG__logCount = *LOG__pLogCountDecrement - 1;                                                 \
-               if(LOG__logCount < 0) {                                                                                 \
+               if(!InteralLogCountDecrement(pLogCountDecrement)) {                                                     \
                   break;                                                                                               \
                }                                                                                                       \
-               *LOG__pLogCountDecrement = LOG__logCount;                                                               \
                LOG__traceLevelLogging = LOG__traceLevelBefore;                                                         \
             } else {                                                                                                   \
                LOG__traceLevelLogging = LOG__traceLevelAfter;                                                          \